@@ -6,9 +6,25 @@
 #include "BussIK/MatrixRmn.h"
 #include "Bullet3Common/b3AlignedObjectArray.h"
 #include "BulletDynamics/Featherstone/btMultiBody.h"
+#include "LinearMath/btThreads.h"
 
 #define RADIAN(X) ((X)*RadiansToDegrees)
 
+//work space for a single IK problem, reused between calls so that solving
+//problems of the same size does not allocate
+struct IKWorkspace
+{
+	Jacobian m_ikJacobian;
+	MatrixRmn m_augMat;
+	btAlignedObjectArray<int> m_lockedJoints;
+	btAlignedObjectArray<double> m_lockedDelta;
+
+	IKWorkspace()
+		: m_ikJacobian(false, 1, 1)
+	{
+	}
+};
+
 //use BussIK and Reflexxes to convert from Cartesian endeffector future target to
 //joint space positions at each real-time (simulation) step
 struct IKTrajectoryHelperInternalData
@@ -16,15 +32,29 @@ struct IKTrajectoryHelperInternalData
 	VectorR3 m_endEffectorTargetPosition;
 	VectorRn m_nullSpaceVelocity;
 	VectorRn m_dampingCoeff;
+	VectorRn m_lowerLimit;
+	VectorRn m_upperLimit;
+	bool m_hasJointLimits;
 
 	b3AlignedObjectArray<Node*> m_ikNodes;
 
+	IKWorkspace m_workspace;
+	b3AlignedObjectArray<IKWorkspace*> m_batchWorkspaces;
+
 	IKTrajectoryHelperInternalData()
+		: m_hasJointLimits(false)
 	{
 		m_endEffectorTargetPosition.SetZero();
 		m_nullSpaceVelocity.SetZero();
 		m_dampingCoeff.SetZero();
 	}
+	~IKTrajectoryHelperInternalData()
+	{
+		for (int i = 0; i < m_batchWorkspaces.size(); i++)
+		{
+			delete m_batchWorkspaces[i];
+		}
+	}
 };
 
 IKTrajectoryHelper::IKTrajectoryHelper()
@@ -37,6 +67,123 @@ IKTrajectoryHelper::~IKTrajectoryHelper()
 	delete m_data;
 }
 
+static void calcDeltaThetas(Jacobian& ikJacobian, MatrixRmn& AugMat, const IKTrajectoryHelperInternalData& data, int numQ, int ikMethod)
+{
+	// Calculate the change in theta values
+	switch (ikMethod)
+	{
+		case IK2_JACOB_TRANS:
+			ikJacobian.CalcDeltaThetasTranspose();  // Jacobian transpose method
+			break;
+		case IK2_DLS:
+		case IK2_VEL_DLS_WITH_ORIENTATION:
+		case IK2_VEL_DLS:
+			//ikJacobian.CalcDeltaThetasDLS();			// Damped least squares method
+			assert(data.m_dampingCoeff.GetLength() == numQ);
+			ikJacobian.CalcDeltaThetasDLS2(data.m_dampingCoeff, AugMat);
+			break;
+		case IK2_VEL_DLS_WITH_NULLSPACE:
+		case IK2_VEL_DLS_WITH_ORIENTATION_NULLSPACE:
+			assert(data.m_nullSpaceVelocity.GetLength() == numQ);
+			ikJacobian.CalcDeltaThetasDLSwithNullspace(data.m_nullSpaceVelocity, AugMat);
+			break;
+		case IK2_DLS_SVD:
+			ikJacobian.CalcDeltaThetasDLSwithSVD();
+			break;
+		case IK2_PURE_PSEUDO:
+			ikJacobian.CalcDeltaThetasPseudoinverse();  // Pure pseudoinverse method
+			break;
+		case IK2_SDLS:
+		case IK2_VEL_SDLS:
+		case IK2_VEL_SDLS_WITH_ORIENTATION:
+			ikJacobian.CalcDeltaThetasSDLS();  // Selectively damped least squares method
+			break;
+		default:
+			ikJacobian.ZeroDeltaThetas();
+			break;
+	}
+}
+
+//solve for the joint update, with the Jacobian and deltaS already set in the workspace.
+//Joint limits are handled as constraints with an active set: a joint that would leave its
+//range is moved to the limit, its column is removed from the Jacobian and the rest is solved again.
+static void solveIKStep(IKWorkspace& ws, const IKTrajectoryHelperInternalData& data, const double* q_current, int numQ, double* q_new, int ikMethod)
+{
+	Jacobian& ikJacobian = ws.m_ikJacobian;
+	const bool hasJointLimits = data.m_hasJointLimits && data.m_lowerLimit.GetLength() == numQ && data.m_upperLimit.GetLength() == numQ;
+	if (hasJointLimits)
+	{
+		ws.m_lockedJoints.resize(numQ);
+		ws.m_lockedDelta.resize(numQ);
+		for (int i = 0; i < numQ; i++)
+		{
+			ws.m_lockedJoints[i] = 0;
+			ws.m_lockedDelta[i] = 0;
+		}
+	}
+
+	for (int pass = 0; pass <= numQ; pass++)
+	{
+		calcDeltaThetas(ikJacobian, ws.m_augMat, data, numQ, ikMethod);
+
+		// Use for velocity IK, update theta dot
+		//ikJacobian.UpdateThetaDot();
+
+		// Use for position IK, incrementally update theta
+		//ikJacobian.UpdateThetas();
+
+		// Apply the change in the theta values
+		//ikJacobian.UpdatedSClampValue(&targets);
+
+		for (int i = 0; i < numQ; i++)
+		{
+			// Use for velocity IK
+			q_new[i] = ikJacobian.dTheta[i] + q_current[i];
+
+			// Use for position IK
+			//q_new[i] = m_data->m_ikNodes[i]->GetTheta();
+		}
+
+		if (!hasJointLimits)
+		{
+			break;
+		}
+
+		bool lockedNewJoint = false;
+		for (int i = 0; i < numQ; i++)
+		{
+			const double lower = data.m_lowerLimit[i];
+			const double upper = data.m_upperLimit[i];
+			if (ws.m_lockedJoints[i])
+			{
+				q_new[i] = q_current[i] + ws.m_lockedDelta[i];
+				continue;
+			}
+			//lower > upper means the joint is not limited
+			if (lower > upper || (q_new[i] >= lower && q_new[i] <= upper))
+			{
+				continue;
+			}
+			const double limit = q_new[i] < lower ? lower : upper;
+			ws.m_lockedJoints[i] = 1;
+			ws.m_lockedDelta[i] = limit - q_current[i];
+			q_new[i] = limit;
+			lockedNewJoint = true;
+
+			// move the locked joint to its limit and take it out of the problem
+			for (int row = 0; row < ikJacobian.nRow; row++)
+			{
+				ikJacobian.dS[row] -= ikJacobian.Jend.Get(row, i) * ws.m_lockedDelta[i];
+				ikJacobian.Jend.Set(row, i, 0);
+			}
+		}
+		if (!lockedNewJoint)
+		{
+			break;
+		}
+	}
+}
+
 bool IKTrajectoryHelper::computeIK(const double endEffectorTargetPosition[3],
 								   const double endEffectorTargetOrientation[4],
 								   const double endEffectorWorldPosition[3],
@@ -44,36 +191,23 @@ bool IKTrajectoryHelper::computeIK(const double endEffectorTargetPosition[3],
 								   const double* q_current, int numQ, int endEffectorIndex,
 								   double* q_new, int ikMethod, const double* linear_jacobian, const double* angular_jacobian, int jacobian_size, const double dampIk[6])
 {
-	MatrixRmn AugMat;
 	bool useAngularPart = (ikMethod == IK2_VEL_DLS_WITH_ORIENTATION || ikMethod == IK2_VEL_DLS_WITH_ORIENTATION_NULLSPACE || ikMethod == IK2_VEL_SDLS_WITH_ORIENTATION) ? true : false;
 
-	Jacobian ikJacobian(useAngularPart, numQ, 1);
-
-	ikJacobian.Reset();
-
-	bool UseJacobianTargets1 = false;
-
-	if (UseJacobianTargets1)
-	{
-		ikJacobian.SetJtargetActive();
-	}
-	else
-	{
-		ikJacobian.SetJendActive();
-	}
-	VectorR3 targets;
-	targets.Set(endEffectorTargetPosition[0], endEffectorTargetPosition[1], endEffectorTargetPosition[2]);
-	ikJacobian.ComputeJacobian(&targets);  // Set up Jacobian and deltaS vectors
+	IKWorkspace& ws = m_data->m_workspace;
+	Jacobian& ikJacobian = ws.m_ikJacobian;
+	ikJacobian.SetDimensions(useAngularPart, numQ, 1);
 
 	// Set one end effector world position from Bullet
-	VectorRn deltaS(3);
 	for (int i = 0; i < 3; ++i)
 	{
-		deltaS.Set(i, dampIk[i] * (endEffectorTargetPosition[i] - endEffectorWorldPosition[i]));
+		ikJacobian.dS[i] = dampIk[i] * (endEffectorTargetPosition[i] - endEffectorWorldPosition[i]);
+		for (int j = 0; j < numQ; ++j)
+		{
+			ikJacobian.Jend.Set(i, j, linear_jacobian[i * numQ + j]);
+		}
 	}
 
 	// Set one end effector world orientation from Bullet
-	VectorRn deltaR(3);
 	if (useAngularPart)
 	{
 		btQuaternion startQ(endEffectorWorldOrientation[0], endEffectorWorldOrientation[1], endEffectorWorldOrientation[2], endEffectorWorldOrientation[3]);
@@ -93,100 +227,42 @@ bool IKTrajectoryHelper::computeIK(const double endEffectorTargetPosition[3],
 		btVector3 angularVel = angleDot * axis.normalize();
 		for (int i = 0; i < 3; ++i)
 		{
-			deltaR.Set(i, dampIk[i + 3] * angularVel[i]);
-		}
-	}
-
-	{
-		if (useAngularPart)
-		{
-			VectorRn deltaC(6);
-			MatrixRmn completeJacobian(6, numQ);
-			for (int i = 0; i < 3; ++i)
+			ikJacobian.dS[i + 3] = dampIk[i + 3] * angularVel[i];
+			for (int j = 0; j < numQ; ++j)
 			{
-				deltaC.Set(i, deltaS[i]);
-				deltaC.Set(i + 3, deltaR[i]);
-				for (int j = 0; j < numQ; ++j)
-				{
-					completeJacobian.Set(i, j, linear_jacobian[i * numQ + j]);
-					completeJacobian.Set(i + 3, j, angular_jacobian[i * numQ + j]);
-				}
+				ikJacobian.Jend.Set(i + 3, j, angular_jacobian[i * numQ + j]);
 			}
-			ikJacobian.SetDeltaS(deltaC);
-			ikJacobian.SetJendTrans(completeJacobian);
-		}
-		else
-		{
-			VectorRn deltaC(3);
-			MatrixRmn completeJacobian(3, numQ);
-			for (int i = 0; i < 3; ++i)
-			{
-				deltaC.Set(i, deltaS[i]);
-				for (int j = 0; j < numQ; ++j)
-				{
-					completeJacobian.Set(i, j, linear_jacobian[i * numQ + j]);
-				}
-			}
-			ikJacobian.SetDeltaS(deltaC);
-			ikJacobian.SetJendTrans(completeJacobian);
 		}
 	}
 
-	// Calculate the change in theta values
-	switch (ikMethod)
-	{
-		case IK2_JACOB_TRANS:
-			ikJacobian.CalcDeltaThetasTranspose();  // Jacobian transpose method
-			break;
-		case IK2_DLS:
-		case IK2_VEL_DLS_WITH_ORIENTATION:
-		case IK2_VEL_DLS:
-			//ikJacobian.CalcDeltaThetasDLS();			// Damped least squares method
-			assert(m_data->m_dampingCoeff.GetLength() == numQ);
-			ikJacobian.CalcDeltaThetasDLS2(m_data->m_dampingCoeff, AugMat);
-			break;
-		case IK2_VEL_DLS_WITH_NULLSPACE:
-		case IK2_VEL_DLS_WITH_ORIENTATION_NULLSPACE:
-			assert(m_data->m_nullSpaceVelocity.GetLength() == numQ);
-			ikJacobian.CalcDeltaThetasDLSwithNullspace(m_data->m_nullSpaceVelocity, AugMat);
-			break;
-		case IK2_DLS_SVD:
-			ikJacobian.CalcDeltaThetasDLSwithSVD();
-			break;
-		case IK2_PURE_PSEUDO:
-			ikJacobian.CalcDeltaThetasPseudoinverse();  // Pure pseudoinverse method
-			break;
-		case IK2_SDLS:
-		case IK2_VEL_SDLS:
-		case IK2_VEL_SDLS_WITH_ORIENTATION:
-			ikJacobian.CalcDeltaThetasSDLS();  // Selectively damped least squares method
-			break;
-		default:
-			ikJacobian.ZeroDeltaThetas();
-			break;
-	}
-
-	// Use for velocity IK, update theta dot
-	//ikJacobian.UpdateThetaDot();
+	solveIKStep(ws, *m_data, q_current, numQ, q_new, ikMethod);
+	return true;
+}
 
-	// Use for position IK, incrementally update theta
-	//ikJacobian.UpdateThetas();
+static void setupIK2(IKWorkspace& ws,
+					 const double* endEffectorTargetPositions,
+					 const double* endEffectorCurrentPositions,
+					 int numEndEffectors, int numQ, const double* linear_jacobians, const double dampIk[6])
+{
+	bool useAngularPart = false;  //for now (ikMethod == IK2_VEL_DLS_WITH_ORIENTATION || ikMethod == IK2_VEL_DLS_WITH_ORIENTATION_NULLSPACE || ikMethod == IK2_VEL_SDLS_WITH_ORIENTATION) ? true : false;
 
-	// Apply the change in the theta values
-	//ikJacobian.UpdatedSClampValue(&targets);
+	Jacobian& ikJacobian = ws.m_ikJacobian;
+	ikJacobian.SetDimensions(useAngularPart, numQ, numEndEffectors);
 
-	for (int i = 0; i < numQ; i++)
+	for (int ne = 0; ne < numEndEffectors; ne++)
 	{
-		// Use for velocity IK
-		q_new[i] = ikJacobian.dTheta[i] + q_current[i];
-
-		// Use for position IK
-		//q_new[i] = m_data->m_ikNodes[i]->GetTheta();
+		// Set one end effector world position from Bullet
+		for (int i = 0; i < 3; ++i)
+		{
+			ikJacobian.dS[ne * 3 + i] = dampIk[i] * (endEffectorTargetPositions[ne * 3 + i] - endEffectorCurrentPositions[ne * 3 + i]);
+			for (int j = 0; j < numQ; ++j)
+			{
+				ikJacobian.Jend.Set(ne * 3 + i, j, linear_jacobians[((ne * 3 + i) * numQ) + j]);
+			}
+		}
 	}
-	return true;
 }
 
-
 bool IKTrajectoryHelper::computeIK2(
 	const double* endEffectorTargetPositions,
 	const double* endEffectorCurrentPositions,
@@ -194,108 +270,88 @@ bool IKTrajectoryHelper::computeIK2(
 	const double* q_current, int numQ,
 	double* q_new, int ikMethod, const double* linear_jacobians, const double dampIk[6])
 {
-	MatrixRmn AugMat;
-	bool useAngularPart = false;//for now (ikMethod == IK2_VEL_DLS_WITH_ORIENTATION || ikMethod == IK2_VEL_DLS_WITH_ORIENTATION_NULLSPACE || ikMethod == IK2_VEL_SDLS_WITH_ORIENTATION) ? true : false;
-
-	Jacobian ikJacobian(useAngularPart, numQ, numEndEffectors);
-
-	ikJacobian.Reset();
+	IKWorkspace& ws = m_data->m_workspace;
+	setupIK2(ws, endEffectorTargetPositions, endEffectorCurrentPositions, numEndEffectors, numQ, linear_jacobians, dampIk);
+	solveIKStep(ws, *m_data, q_current, numQ, q_new, ikMethod);
+	return true;
+}
 
-	bool UseJacobianTargets1 = false;
+static bool useParallelBatch(int numProblems)
+{
+#if BT_THREADSAFE
+	btITaskScheduler* scheduler = btGetTaskScheduler();
+	return numProblems > 1 && scheduler && scheduler->getNumThreads() > 1 && !btThreadsAreRunning();
+#else
+	(void)numProblems;
+	return false;
+#endif
+}
 
-	if (UseJacobianTargets1)
+struct IKBatchSolver : public btIParallelForBody
+{
+	IKTrajectoryHelperInternalData* m_data;
+	const double* m_endEffectorTargetPositions;
+	const double* m_endEffectorCurrentPositions;
+	int m_numEndEffectors;
+	const double* m_q_current;
+	int m_numQ;
+	double* m_q_new;
+	int m_ikMethod;
+	const double* m_linear_jacobians;
+	const double* m_dampIk;
+
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
 	{
-		ikJacobian.SetJtargetActive();
+		const int numRows = m_numEndEffectors * 3;
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			IKWorkspace& ws = *m_data->m_batchWorkspaces[i];
+			setupIK2(ws, &m_endEffectorTargetPositions[i * numRows], &m_endEffectorCurrentPositions[i * numRows],
+					 m_numEndEffectors, m_numQ, &m_linear_jacobians[i * numRows * m_numQ], m_dampIk);
+			solveIKStep(ws, *m_data, &m_q_current[i * m_numQ], m_numQ, &m_q_new[i * m_numQ], m_ikMethod);
+		}
 	}
-	else
+};
+
+bool IKTrajectoryHelper::computeIK2Batch(
+	int numProblems,
+	const double* endEffectorTargetPositions,
+	const double* endEffectorCurrentPositions,
+	int numEndEffectors,
+	const double* q_current, int numQ,
+	double* q_new, int ikMethod, const double* linear_jacobians, const double dampIk[6])
+{
+	if (numProblems <= 0)
 	{
-		ikJacobian.SetJendActive();
+		return false;
 	}
-
-	VectorRn deltaC(numEndEffectors *3);
-	MatrixRmn completeJacobian(numEndEffectors*3, numQ);
-
-	for (int ne = 0; ne < numEndEffectors; ne++)
+	while (m_data->m_batchWorkspaces.size() < numProblems)
 	{
-		VectorR3 targets;
-		targets.Set(endEffectorTargetPositions[ne*3+0], endEffectorTargetPositions[ne * 3 + 1], endEffectorTargetPositions[ne * 3 + 2]);
-
-		// Set one end effector world position from Bullet
-		VectorRn deltaS(3);
-		for (int i = 0; i < 3; ++i)
-		{
-			deltaS.Set(i, dampIk[i] * (endEffectorTargetPositions[ne*3+i] - endEffectorCurrentPositions[ne*3+i]));
-		}
-		{
-			
-			for (int i = 0; i < 3; ++i)
-			{
-				deltaC.Set(ne*3+i, deltaS[i]);
-				for (int j = 0; j < numQ; ++j)
-				{
-					completeJacobian.Set(ne * 3 + i, j, linear_jacobians[((ne*3+i) * numQ) + j]);
-				}
-			}
-		}
+		m_data->m_batchWorkspaces.push_back(new IKWorkspace);
 	}
-	ikJacobian.SetDeltaS(deltaC);
-	ikJacobian.SetJendTrans(completeJacobian);
 
-	// Calculate the change in theta values
-	switch (ikMethod)
+	IKBatchSolver solver;
+	solver.m_data = m_data;
+	solver.m_endEffectorTargetPositions = endEffectorTargetPositions;
+	solver.m_endEffectorCurrentPositions = endEffectorCurrentPositions;
+	solver.m_numEndEffectors = numEndEffectors;
+	solver.m_q_current = q_current;
+	solver.m_numQ = numQ;
+	solver.m_q_new = q_new;
+	solver.m_ikMethod = ikMethod;
+	solver.m_linear_jacobians = linear_jacobians;
+	solver.m_dampIk = dampIk;
+	if (useParallelBatch(numProblems))
 	{
-	case IK2_JACOB_TRANS:
-		ikJacobian.CalcDeltaThetasTranspose();  // Jacobian transpose method
-		break;
-	case IK2_DLS:
-	case IK2_VEL_DLS_WITH_ORIENTATION:
-	case IK2_VEL_DLS:
-		//ikJacobian.CalcDeltaThetasDLS();			// Damped least squares method
-		assert(m_data->m_dampingCoeff.GetLength() == numQ);
-		ikJacobian.CalcDeltaThetasDLS2(m_data->m_dampingCoeff, AugMat);
-		break;
-	case IK2_VEL_DLS_WITH_NULLSPACE:
-	case IK2_VEL_DLS_WITH_ORIENTATION_NULLSPACE:
-		assert(m_data->m_nullSpaceVelocity.GetLength() == numQ);
-		ikJacobian.CalcDeltaThetasDLSwithNullspace(m_data->m_nullSpaceVelocity, AugMat);
-		break;
-	case IK2_DLS_SVD:
-		ikJacobian.CalcDeltaThetasDLSwithSVD();
-		break;
-	case IK2_PURE_PSEUDO:
-		ikJacobian.CalcDeltaThetasPseudoinverse();  // Pure pseudoinverse method
-		break;
-	case IK2_SDLS:
-	case IK2_VEL_SDLS:
-	case IK2_VEL_SDLS_WITH_ORIENTATION:
-		ikJacobian.CalcDeltaThetasSDLS();  // Selectively damped least squares method
-		break;
-	default:
-		ikJacobian.ZeroDeltaThetas();
-		break;
+		btParallelFor(0, numProblems, 1, solver);
 	}
-
-	// Use for velocity IK, update theta dot
-	//ikJacobian.UpdateThetaDot();
-
-	// Use for position IK, incrementally update theta
-	//ikJacobian.UpdateThetas();
-
-	// Apply the change in the theta values
-	//ikJacobian.UpdatedSClampValue(&targets);
-
-	for (int i = 0; i < numQ; i++)
+	else
 	{
-		// Use for velocity IK
-		q_new[i] = ikJacobian.dTheta[i] + q_current[i];
-
-		// Use for position IK
-		//q_new[i] = m_data->m_ikNodes[i]->GetTheta();
+		solver.forLoop(0, numProblems);
 	}
 	return true;
 }
 
-
 bool IKTrajectoryHelper::computeNullspaceVel(int numQ, const double* q_current, const double* lower_limit, const double* upper_limit, const double* joint_range, const double* rest_pose)
 {
 	m_data->m_nullSpaceVelocity.SetLength(numQ);
@@ -336,3 +392,21 @@ bool IKTrajectoryHelper::setDampingCoeff(int numQ, const double* coeff)
 	}
 	return true;
 }
+
+bool IKTrajectoryHelper::setJointLimits(int numQ, const double* lower_limit, const double* upper_limit)
+{
+	m_data->m_lowerLimit.SetLength(numQ);
+	m_data->m_upperLimit.SetLength(numQ);
+	for (int i = 0; i < numQ; ++i)
+	{
+		m_data->m_lowerLimit[i] = lower_limit[i];
+		m_data->m_upperLimit[i] = upper_limit[i];
+	}
+	m_data->m_hasJointLimits = true;
+	return true;
+}
+
+void IKTrajectoryHelper::clearJointLimits()
+{
+	m_data->m_hasJointLimits = false;
+}
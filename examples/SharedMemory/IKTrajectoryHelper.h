@@ -38,7 +38,20 @@ public:
 		const double* q_current, int numQ,
 		double* q_new, int ikMethod, const double* linear_jacobians, const double dampIk[6]);
 
+	///solve numProblems independent computeIK2 problems of the same size, in parallel with btParallelFor when a task scheduler with several threads is set.
+	///All arrays hold the data of each problem one after the other, damping, null space and joint limits are shared.
+	bool computeIK2Batch(
+		int numProblems,
+		const double* endEffectorTargetPositions,
+		const double* endEffectorCurrentPositions,
+		int numEndEffectors,
+		const double* q_current, int numQ,
+		double* q_new, int ikMethod, const double* linear_jacobians, const double dampIk[6]);
+
 	bool computeNullspaceVel(int numQ, const double* q_current, const double* lower_limit, const double* upper_limit, const double* joint_range, const double* rest_pose);
 	bool setDampingCoeff(int numQ, const double* coeff);
+	///keep the solution inside [lower_limit, upper_limit], joints with lower_limit > upper_limit are not limited
+	bool setJointLimits(int numQ, const double* lower_limit, const double* upper_limit);
+	void clearJointLimits();
 };
 #endif  //IK_TRAJECTORY_HELPER_H
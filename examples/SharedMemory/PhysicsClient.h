@@ -79,6 +79,10 @@ public:
 
 	virtual void getCachedMassMatrix(int dofCountCheck, double* massMatrix) = 0;
 
+	virtual void getCachedDynamicsDerivatives(int dofCountCheck, int matrixIndex, double* derivatives) = 0;
+
+	virtual void getCachedInverseKinematicsBatch(int dofCountCheck, int solutionIndex, double* jointPositions) = 0;
+
 	virtual bool getCachedReturnData(struct b3UserDataValue* returnData) = 0;
 
 	virtual void setTimeOut(double timeOutInSeconds) = 0;
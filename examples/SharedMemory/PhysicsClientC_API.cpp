@@ -5518,6 +5518,83 @@ B3_SHARED_API int b3GetStatusMassMatrix(b3PhysicsClientHandle physClient, b3Shar
 	return true;
 }
 
+B3_SHARED_API b3SharedMemoryCommandHandle b3CalculateDynamicsDerivativesCommandInit(b3PhysicsClientHandle physClient, int bodyUniqueId,
+																					const double* jointPositionsQ, const double* jointVelocitiesQdot, const double* jointInputs, int dofCount)
+{
+	PhysicsClient* cl = (PhysicsClient*)physClient;
+	b3Assert(cl);
+	b3Assert(cl->canSubmitCommand());
+	struct SharedMemoryCommand* command = cl->getAvailableSharedMemoryCommand();
+	b3Assert(command);
+
+	command->m_type = CMD_CALCULATE_DYNAMICS_DERIVATIVES;
+	command->m_updateFlags = 0;
+	command->m_calculateDynamicsDerivativesArguments.m_bodyUniqueId = bodyUniqueId;
+	command->m_calculateDynamicsDerivativesArguments.m_flags = 0;
+
+	if (dofCount > MAX_DEGREE_OF_FREEDOM)
+	{
+		dofCount = MAX_DEGREE_OF_FREEDOM;
+	}
+	command->m_calculateDynamicsDerivativesArguments.m_dofCount = dofCount;
+	for (int i = 0; i < dofCount; i++)
+	{
+		command->m_calculateDynamicsDerivativesArguments.m_jointPositionsQ[i] = jointPositionsQ[i];
+		command->m_calculateDynamicsDerivativesArguments.m_jointVelocitiesQdot[i] = jointVelocitiesQdot[i];
+		command->m_calculateDynamicsDerivativesArguments.m_jointInputs[i] = jointInputs[i];
+	}
+
+	return (b3SharedMemoryCommandHandle)command;
+}
+
+B3_SHARED_API void b3CalculateDynamicsDerivativesSetFlags(b3SharedMemoryCommandHandle commandHandle, int flags)
+{
+	struct SharedMemoryCommand* command = (struct SharedMemoryCommand*)commandHandle;
+	command->m_calculateDynamicsDerivativesArguments.m_flags = flags;
+}
+
+B3_SHARED_API int b3GetStatusDynamicsDerivatives(b3PhysicsClientHandle physClient, b3SharedMemoryStatusHandle statusHandle, int* dofCount,
+												 double* jointOutputs, double* derivativesWrtQ, double* derivativesWrtQdot, double* derivativesWrtJointForces)
+{
+	PhysicsClient* cl = (PhysicsClient*)physClient;
+	b3Assert(cl);
+
+	const SharedMemoryStatus* status = (const SharedMemoryStatus*)statusHandle;
+	if (status == 0)
+		return false;
+
+	btAssert(status->m_type == CMD_CALCULATED_DYNAMICS_DERIVATIVES_COMPLETED);
+	if (status->m_type != CMD_CALCULATED_DYNAMICS_DERIVATIVES_COMPLETED)
+		return false;
+
+	const int numDofs = status->m_dynamicsDerivativesResultArgs.m_dofCount;
+	if (dofCount)
+	{
+		*dofCount = numDofs;
+	}
+	if (jointOutputs)
+	{
+		for (int i = 0; i < numDofs; i++)
+		{
+			jointOutputs[i] = status->m_dynamicsDerivativesResultArgs.m_jointOutputs[i];
+		}
+	}
+	if (derivativesWrtQ)
+	{
+		cl->getCachedDynamicsDerivatives(numDofs, 0, derivativesWrtQ);
+	}
+	if (derivativesWrtQdot)
+	{
+		cl->getCachedDynamicsDerivatives(numDofs, 1, derivativesWrtQdot);
+	}
+	if (derivativesWrtJointForces && status->m_dynamicsDerivativesResultArgs.m_numMatrices > 2)
+	{
+		cl->getCachedDynamicsDerivatives(numDofs, 2, derivativesWrtJointForces);
+	}
+
+	return true;
+}
+
 B3_SHARED_API b3SharedMemoryCommandHandle b3CollisionFilterCommandInit(b3PhysicsClientHandle physClient)
 {
 	PhysicsClient* cl = (PhysicsClient*)physClient;
@@ -5689,7 +5766,7 @@ B3_SHARED_API void b3CalculateInverseKinematicsSetCurrentPositions(b3SharedMemor
 {
 	struct SharedMemoryCommand* command = (struct SharedMemoryCommand*)commandHandle;
 	b3Assert(command);
-	b3Assert(command->m_type == CMD_CALCULATE_INVERSE_KINEMATICS);
+	b3Assert(command->m_type == CMD_CALCULATE_INVERSE_KINEMATICS || command->m_type == CMD_CALCULATE_INVERSE_KINEMATICS_BATCH);
 	command->m_updateFlags |= IK_HAS_CURRENT_JOINT_POSITIONS;
 	for (int i = 0; i < numDof; ++i)
 	{
@@ -5701,7 +5778,7 @@ B3_SHARED_API void b3CalculateInverseKinematicsSetMaxNumIterations(b3SharedMemor
 {
 	struct SharedMemoryCommand* command = (struct SharedMemoryCommand*)commandHandle;
 	b3Assert(command);
-	b3Assert(command->m_type == CMD_CALCULATE_INVERSE_KINEMATICS);
+	b3Assert(command->m_type == CMD_CALCULATE_INVERSE_KINEMATICS || command->m_type == CMD_CALCULATE_INVERSE_KINEMATICS_BATCH);
 	command->m_updateFlags |= IK_HAS_MAX_ITERATIONS;
 	command->m_calculateInverseKinematicsArguments.m_maxNumIterations = maxNumIterations;
 }
@@ -5710,7 +5787,7 @@ B3_SHARED_API void b3CalculateInverseKinematicsSetResidualThreshold(b3SharedMemo
 {
 	struct SharedMemoryCommand* command = (struct SharedMemoryCommand*)commandHandle;
 	b3Assert(command);
-	b3Assert(command->m_type == CMD_CALCULATE_INVERSE_KINEMATICS);
+	b3Assert(command->m_type == CMD_CALCULATE_INVERSE_KINEMATICS || command->m_type == CMD_CALCULATE_INVERSE_KINEMATICS_BATCH);
 	command->m_updateFlags |= IK_HAS_RESIDUAL_THRESHOLD;
 	command->m_calculateInverseKinematicsArguments.m_residualThreshold = residualThreshold;
 }
@@ -5719,7 +5796,7 @@ B3_SHARED_API void b3CalculateInverseKinematicsSetJointDamping(b3SharedMemoryCom
 {
 	struct SharedMemoryCommand* command = (struct SharedMemoryCommand*)commandHandle;
 	b3Assert(command);
-	b3Assert(command->m_type == CMD_CALCULATE_INVERSE_KINEMATICS);
+	b3Assert(command->m_type == CMD_CALCULATE_INVERSE_KINEMATICS || command->m_type == CMD_CALCULATE_INVERSE_KINEMATICS_BATCH);
 	command->m_updateFlags |= IK_HAS_JOINT_DAMPING;
 
 	for (int i = 0; i < numDof; ++i)
@@ -5728,11 +5805,33 @@ B3_SHARED_API void b3CalculateInverseKinematicsSetJointDamping(b3SharedMemoryCom
 	}
 }
 
+B3_SHARED_API void b3CalculateInverseKinematicsSetJointLimits(b3SharedMemoryCommandHandle commandHandle, int numDof, const double* lowerLimit, const double* upperLimit)
+{
+	struct SharedMemoryCommand* command = (struct SharedMemoryCommand*)commandHandle;
+	b3Assert(command);
+	b3Assert(command->m_type == CMD_CALCULATE_INVERSE_KINEMATICS || command->m_type == CMD_CALCULATE_INVERSE_KINEMATICS_BATCH);
+	command->m_updateFlags |= IK_HAS_JOINT_LIMITS;
+
+	b3Assert(numDof <= MAX_DEGREE_OF_FREEDOM);
+	numDof = btMin(numDof, MAX_DEGREE_OF_FREEDOM);
+	for (int i = 0; i < numDof; ++i)
+	{
+		command->m_calculateInverseKinematicsArguments.m_lowerLimit[i] = lowerLimit[i];
+		command->m_calculateInverseKinematicsArguments.m_upperLimit[i] = upperLimit[i];
+	}
+	//the remaining joints are not limited
+	for (int i = numDof; i < MAX_DEGREE_OF_FREEDOM; ++i)
+	{
+		command->m_calculateInverseKinematicsArguments.m_lowerLimit[i] = 0;
+		command->m_calculateInverseKinematicsArguments.m_upperLimit[i] = -1;
+	}
+}
+
 B3_SHARED_API void b3CalculateInverseKinematicsSelectSolver(b3SharedMemoryCommandHandle commandHandle, int solver)
 {
 	struct SharedMemoryCommand* command = (struct SharedMemoryCommand*)commandHandle;
 	b3Assert(command);
-	b3Assert(command->m_type == CMD_CALCULATE_INVERSE_KINEMATICS);
+	b3Assert(command->m_type == CMD_CALCULATE_INVERSE_KINEMATICS || command->m_type == CMD_CALCULATE_INVERSE_KINEMATICS_BATCH);
 	command->m_updateFlags |= solver;
 }
 
@@ -5768,6 +5867,74 @@ B3_SHARED_API int b3GetStatusInverseKinematicsJointPositions(b3SharedMemoryStatu
 	return 1;
 }
 
+B3_SHARED_API b3SharedMemoryCommandHandle b3CalculateInverseKinematicsBatchCommandInit(b3PhysicsClientHandle physClient, int bodyUniqueId, int endEffectorLinkIndex, int numTargets, const double* targetPositions)
+{
+	PhysicsClient* cl = (PhysicsClient*)physClient;
+	b3Assert(cl);
+	b3Assert(cl->canSubmitCommand());
+	struct SharedMemoryCommand* command = cl->getAvailableSharedMemoryCommand();
+	b3Assert(command);
+
+	command->m_type = CMD_CALCULATE_INVERSE_KINEMATICS_BATCH;
+	command->m_updateFlags = IK_HAS_TARGET_POSITION;
+	command->m_calculateInverseKinematicsArguments.m_bodyUniqueId = bodyUniqueId;
+	command->m_calculateInverseKinematicsArguments.m_endEffectorLinkIndices[0] = endEffectorLinkIndex;
+	command->m_calculateInverseKinematicsArguments.m_numEndEffectorLinkIndices = 1;
+
+	if (numTargets > MAX_DEGREE_OF_FREEDOM)
+	{
+		numTargets = MAX_DEGREE_OF_FREEDOM;
+	}
+	command->m_calculateInverseKinematicsArguments.m_numTargets = numTargets;
+	for (int i = 0; i < numTargets * 3; i++)
+	{
+		command->m_calculateInverseKinematicsArguments.m_targetPositions[i] = targetPositions[i];
+	}
+	return (b3SharedMemoryCommandHandle)command;
+}
+
+B3_SHARED_API int b3GetStatusInverseKinematicsBatchJointPositions(b3PhysicsClientHandle physClient,
+																  b3SharedMemoryStatusHandle statusHandle,
+																  int* bodyUniqueId,
+																  int* dofCount,
+																  int* numSolutions,
+																  double* jointPositions)
+{
+	PhysicsClient* cl = (PhysicsClient*)physClient;
+	b3Assert(cl);
+
+	const SharedMemoryStatus* status = (const SharedMemoryStatus*)statusHandle;
+	btAssert(status);
+	if (status == 0)
+		return 0;
+	btAssert(status->m_type == CMD_CALCULATE_INVERSE_KINEMATICS_BATCH_COMPLETED);
+	if (status->m_type != CMD_CALCULATE_INVERSE_KINEMATICS_BATCH_COMPLETED)
+		return 0;
+
+	const int numDofs = status->m_inverseKinematicsBatchResultArgs.m_dofCount;
+	if (bodyUniqueId)
+	{
+		*bodyUniqueId = status->m_inverseKinematicsBatchResultArgs.m_bodyUniqueId;
+	}
+	if (dofCount)
+	{
+		*dofCount = numDofs;
+	}
+	if (numSolutions)
+	{
+		*numSolutions = status->m_inverseKinematicsBatchResultArgs.m_numSolutions;
+	}
+	if (jointPositions)
+	{
+		for (int i = 0; i < status->m_inverseKinematicsBatchResultArgs.m_numSolutions; i++)
+		{
+			cl->getCachedInverseKinematicsBatch(numDofs, i, &jointPositions[i * numDofs]);
+		}
+	}
+
+	return 1;
+}
+
 B3_SHARED_API b3SharedMemoryCommandHandle b3RequestVREventsCommandInit(b3PhysicsClientHandle physClient)
 {
 	PhysicsClient* cl = (PhysicsClient*)physClient;
@@ -448,6 +448,17 @@ extern "C"
 	///the mass matrix is stored in column-major layout of size dofCount*dofCount
 	B3_SHARED_API int b3GetStatusMassMatrix(b3PhysicsClientHandle physClient, b3SharedMemoryStatusHandle statusHandle, int* dofCount, double* massMatrix);
 
+	///compute analytical derivatives of inverse dynamics (jointInputs are joint accelerations) or, with
+	///DYNAMICS_DERIVATIVES_FORWARD, of forward dynamics (jointInputs are joint forces) for a fixed base multibody
+	B3_SHARED_API b3SharedMemoryCommandHandle b3CalculateDynamicsDerivativesCommandInit(b3PhysicsClientHandle physClient, int bodyUniqueId,
+																						const double* jointPositionsQ, const double* jointVelocitiesQdot, const double* jointInputs, int dofCount);
+	B3_SHARED_API void b3CalculateDynamicsDerivativesSetFlags(b3SharedMemoryCommandHandle commandHandle, int flags);
+	///jointOutputs are joint forces (inverse) or joint accelerations (forward). The derivatives are stored
+	///column-major, each of size dofCount*dofCount: the derivative of output i w.r.t. input j is at j*dofCount+i.
+	///derivativesWrtJointForces is only filled in for forward dynamics.
+	B3_SHARED_API int b3GetStatusDynamicsDerivatives(b3PhysicsClientHandle physClient, b3SharedMemoryStatusHandle statusHandle, int* dofCount,
+													 double* jointOutputs, double* derivativesWrtQ, double* derivativesWrtQdot, double* derivativesWrtJointForces);
+
 	///compute the joint positions to move the end effector to a desired target using inverse kinematics
 	B3_SHARED_API b3SharedMemoryCommandHandle b3CalculateInverseKinematicsCommandInit(b3PhysicsClientHandle physClient, int bodyUniqueId);
 	B3_SHARED_API void b3CalculateInverseKinematicsAddTargetPurePosition(b3SharedMemoryCommandHandle commandHandle, int endEffectorLinkIndex, const double targetPosition[/*3*/]);
@@ -456,12 +467,27 @@ extern "C"
 	B3_SHARED_API void b3CalculateInverseKinematicsPosWithNullSpaceVel(b3SharedMemoryCommandHandle commandHandle, int numDof, int endEffectorLinkIndex, const double targetPosition[/*3*/], const double* lowerLimit, const double* upperLimit, const double* jointRange, const double* restPose);
 	B3_SHARED_API void b3CalculateInverseKinematicsPosOrnWithNullSpaceVel(b3SharedMemoryCommandHandle commandHandle, int numDof, int endEffectorLinkIndex, const double targetPosition[/*3*/], const double targetOrientation[/*4*/], const double* lowerLimit, const double* upperLimit, const double* jointRange, const double* restPose);
 	B3_SHARED_API void b3CalculateInverseKinematicsSetJointDamping(b3SharedMemoryCommandHandle commandHandle, int numDof, const double* jointDampingCoeff);
+	///keep the IK solution within the joint limits, joints with lowerLimit > upperLimit or beyond numDof are not limited.
+	///numDof is clamped to MAX_DEGREE_OF_FREEDOM
+	B3_SHARED_API void b3CalculateInverseKinematicsSetJointLimits(b3SharedMemoryCommandHandle commandHandle, int numDof, const double* lowerLimit, const double* upperLimit);
 	B3_SHARED_API void b3CalculateInverseKinematicsSelectSolver(b3SharedMemoryCommandHandle commandHandle, int solver);
 	B3_SHARED_API int b3GetStatusInverseKinematicsJointPositions(b3SharedMemoryStatusHandle statusHandle,
 																 int* bodyUniqueId,
 																 int* dofCount,
 																 double* jointPositions);
 
+	///solve the position IK of one end effector for numTargets independent targets, all starting from the current
+	///joint positions. targetPositions holds numTargets positions of 3 doubles, numTargets is clamped to MAX_DEGREE_OF_FREEDOM.
+	///The IK setters for current positions, iterations, residual threshold, damping, joint limits and solver apply as well.
+	B3_SHARED_API b3SharedMemoryCommandHandle b3CalculateInverseKinematicsBatchCommandInit(b3PhysicsClientHandle physClient, int bodyUniqueId, int endEffectorLinkIndex, int numTargets, const double* targetPositions);
+	///jointPositions holds numSolutions solutions of dofCount joint positions, in the order of the targets
+	B3_SHARED_API int b3GetStatusInverseKinematicsBatchJointPositions(b3PhysicsClientHandle physClient,
+																	  b3SharedMemoryStatusHandle statusHandle,
+																	  int* bodyUniqueId,
+																	  int* dofCount,
+																	  int* numSolutions,
+																	  double* jointPositions);
+
 	B3_SHARED_API void b3CalculateInverseKinematicsSetCurrentPositions(b3SharedMemoryCommandHandle commandHandle, int numDof, const double* currentJointPositions);
 	B3_SHARED_API void b3CalculateInverseKinematicsSetMaxNumIterations(b3SharedMemoryCommandHandle commandHandle, int maxNumIterations);
 	B3_SHARED_API void b3CalculateInverseKinematicsSetResidualThreshold(b3SharedMemoryCommandHandle commandHandle, double residualThreshold);
@@ -61,6 +61,8 @@ struct PhysicsClientSharedMemoryInternalData
 	btAlignedObjectArray<b3KeyboardEvent> m_cachedKeyboardEvents;
 	btAlignedObjectArray<b3MouseEvent> m_cachedMouseEvents;
 	btAlignedObjectArray<double> m_cachedMassMatrix;
+	btAlignedObjectArray<double> m_cachedDynamicsDerivatives;
+	btAlignedObjectArray<double> m_cachedInverseKinematicsBatch;
 	btAlignedObjectArray<b3RayHitInfo> m_raycastHits;
 
 	btAlignedObjectArray<int> m_bodyIdsRequestInfo;
@@ -1430,6 +1432,38 @@ const SharedMemoryStatus* PhysicsClientSharedMemory::processServerStatus()
 				}
 				break;
 			}
+			case CMD_CALCULATED_DYNAMICS_DERIVATIVES_FAILED:
+			{
+				b3Warning("calculate dynamics derivatives failed");
+				break;
+			}
+			case CMD_CALCULATED_DYNAMICS_DERIVATIVES_COMPLETED:
+			{
+				double* matrixData = (double*)&this->m_data->m_testBlock1->m_bulletStreamDataServerToClientRefactor[0];
+				int numElements = serverCmd.m_dynamicsDerivativesResultArgs.m_numMatrices * serverCmd.m_dynamicsDerivativesResultArgs.m_dofCount * serverCmd.m_dynamicsDerivativesResultArgs.m_dofCount;
+				m_data->m_cachedDynamicsDerivatives.resize(numElements);
+				for (int i = 0; i < numElements; i++)
+				{
+					m_data->m_cachedDynamicsDerivatives[i] = matrixData[i];
+				}
+				break;
+			}
+			case CMD_CALCULATE_INVERSE_KINEMATICS_BATCH_FAILED:
+			{
+				b3Warning("calculate inverse kinematics batch failed");
+				break;
+			}
+			case CMD_CALCULATE_INVERSE_KINEMATICS_BATCH_COMPLETED:
+			{
+				double* jointPositions = (double*)&this->m_data->m_testBlock1->m_bulletStreamDataServerToClientRefactor[0];
+				int numElements = serverCmd.m_inverseKinematicsBatchResultArgs.m_numSolutions * serverCmd.m_inverseKinematicsBatchResultArgs.m_dofCount;
+				m_data->m_cachedInverseKinematicsBatch.resize(numElements);
+				for (int i = 0; i < numElements; i++)
+				{
+					m_data->m_cachedInverseKinematicsBatch[i] = jointPositions[i];
+				}
+				break;
+			}
 			case CMD_REQUEST_PHYSICS_SIMULATION_PARAMETERS_COMPLETED:
 			{
 				break;
@@ -2076,6 +2110,29 @@ void PhysicsClientSharedMemory::getCachedMassMatrix(int dofCountCheck, double* m
 	}
 }
 
+void PhysicsClientSharedMemory::getCachedDynamicsDerivatives(int dofCountCheck, int matrixIndex, double* derivatives)
+{
+	int sz = dofCountCheck * dofCountCheck;
+	if ((matrixIndex + 1) * sz <= m_data->m_cachedDynamicsDerivatives.size())
+	{
+		for (int i = 0; i < sz; i++)
+		{
+			derivatives[i] = m_data->m_cachedDynamicsDerivatives[matrixIndex * sz + i];
+		}
+	}
+}
+
+void PhysicsClientSharedMemory::getCachedInverseKinematicsBatch(int dofCountCheck, int solutionIndex, double* jointPositions)
+{
+	if ((solutionIndex + 1) * dofCountCheck <= m_data->m_cachedInverseKinematicsBatch.size())
+	{
+		for (int i = 0; i < dofCountCheck; i++)
+		{
+			jointPositions[i] = m_data->m_cachedInverseKinematicsBatch[solutionIndex * dofCountCheck + i];
+		}
+	}
+}
+
 bool PhysicsClientSharedMemory::getCachedReturnData(b3UserDataValue* returnData)
 {
 	if (m_data->m_cachedReturnDataValue.m_length)
@@ -92,6 +92,10 @@ public:
 
 	virtual void getCachedMassMatrix(int dofCountCheck, double* massMatrix);
 
+	virtual void getCachedDynamicsDerivatives(int dofCountCheck, int matrixIndex, double* derivatives);
+
+	virtual void getCachedInverseKinematicsBatch(int dofCountCheck, int solutionIndex, double* jointPositions);
+
 	virtual bool getCachedReturnData(b3UserDataValue* returnData);
 
 	virtual void setTimeOut(double timeOutInSeconds);
@@ -54,6 +54,8 @@ struct PhysicsDirectInternalData
 
 	char m_bulletStreamDataServerToClient[SHARED_MEMORY_MAX_STREAM_CHUNK_SIZE];
 	btAlignedObjectArray<double> m_cachedMassMatrix;
+	btAlignedObjectArray<double> m_cachedDynamicsDerivatives;
+	btAlignedObjectArray<double> m_cachedInverseKinematicsBatch;
 	int m_cachedCameraPixelsWidth;
 	int m_cachedCameraPixelsHeight;
 	btAlignedObjectArray<unsigned char> m_cachedCameraPixelsRGBA;
@@ -1139,6 +1141,38 @@ void PhysicsDirect::postProcessStatus(const struct SharedMemoryStatus& serverCmd
 			}
 			break;
 		}
+		case CMD_CALCULATED_DYNAMICS_DERIVATIVES_FAILED:
+		{
+			b3Warning("calculate dynamics derivatives failed");
+			break;
+		}
+		case CMD_CALCULATED_DYNAMICS_DERIVATIVES_COMPLETED:
+		{
+			double* matrixData = (double*)&m_data->m_bulletStreamDataServerToClient[0];
+			int numElements = serverCmd.m_dynamicsDerivativesResultArgs.m_numMatrices * serverCmd.m_dynamicsDerivativesResultArgs.m_dofCount * serverCmd.m_dynamicsDerivativesResultArgs.m_dofCount;
+			m_data->m_cachedDynamicsDerivatives.resize(numElements);
+			for (int i = 0; i < numElements; i++)
+			{
+				m_data->m_cachedDynamicsDerivatives[i] = matrixData[i];
+			}
+			break;
+		}
+		case CMD_CALCULATE_INVERSE_KINEMATICS_BATCH_FAILED:
+		{
+			b3Warning("calculate inverse kinematics batch failed");
+			break;
+		}
+		case CMD_CALCULATE_INVERSE_KINEMATICS_BATCH_COMPLETED:
+		{
+			double* jointPositions = (double*)&m_data->m_bulletStreamDataServerToClient[0];
+			int numElements = serverCmd.m_inverseKinematicsBatchResultArgs.m_numSolutions * serverCmd.m_inverseKinematicsBatchResultArgs.m_dofCount;
+			m_data->m_cachedInverseKinematicsBatch.resize(numElements);
+			for (int i = 0; i < numElements; i++)
+			{
+				m_data->m_cachedInverseKinematicsBatch[i] = jointPositions[i];
+			}
+			break;
+		}
 		case CMD_ACTUAL_STATE_UPDATE_COMPLETED:
 		{
 			SendActualStateSharedMemoryStorage* serverState = (SendActualStateSharedMemoryStorage*)&m_data->m_bulletStreamDataServerToClient[0];
@@ -1763,6 +1797,29 @@ void PhysicsDirect::getCachedMassMatrix(int dofCountCheck, double* massMatrix)
 	}
 }
 
+void PhysicsDirect::getCachedDynamicsDerivatives(int dofCountCheck, int matrixIndex, double* derivatives)
+{
+	int sz = dofCountCheck * dofCountCheck;
+	if ((matrixIndex + 1) * sz <= m_data->m_cachedDynamicsDerivatives.size())
+	{
+		for (int i = 0; i < sz; i++)
+		{
+			derivatives[i] = m_data->m_cachedDynamicsDerivatives[matrixIndex * sz + i];
+		}
+	}
+}
+
+void PhysicsDirect::getCachedInverseKinematicsBatch(int dofCountCheck, int solutionIndex, double* jointPositions)
+{
+	if ((solutionIndex + 1) * dofCountCheck <= m_data->m_cachedInverseKinematicsBatch.size())
+	{
+		for (int i = 0; i < dofCountCheck; i++)
+		{
+			jointPositions[i] = m_data->m_cachedInverseKinematicsBatch[solutionIndex * dofCountCheck + i];
+		}
+	}
+}
+
 bool PhysicsDirect::getCachedReturnData(b3UserDataValue* returnData)
 {
 	if (m_data->m_cachedReturnDataValue.m_length)
@@ -232,6 +232,16 @@ void PhysicsLoopBack::getCachedMassMatrix(int dofCountCheck, double* massMatrix)
 {
 	m_data->m_physicsClient->getCachedMassMatrix(dofCountCheck, massMatrix);
 }
+
+void PhysicsLoopBack::getCachedDynamicsDerivatives(int dofCountCheck, int matrixIndex, double* derivatives)
+{
+	m_data->m_physicsClient->getCachedDynamicsDerivatives(dofCountCheck, matrixIndex, derivatives);
+}
+
+void PhysicsLoopBack::getCachedInverseKinematicsBatch(int dofCountCheck, int solutionIndex, double* jointPositions)
+{
+	m_data->m_physicsClient->getCachedInverseKinematicsBatch(dofCountCheck, solutionIndex, jointPositions);
+}
 bool PhysicsLoopBack::getCachedReturnData(struct b3UserDataValue* returnData)
 {
 	return m_data->m_physicsClient->getCachedReturnData(returnData);
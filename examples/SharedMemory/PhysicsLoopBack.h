@@ -90,6 +90,10 @@ public:
 
 	virtual void getCachedMassMatrix(int dofCountCheck, double* massMatrix);
 
+	virtual void getCachedDynamicsDerivatives(int dofCountCheck, int matrixIndex, double* derivatives);
+
+	virtual void getCachedInverseKinematicsBatch(int dofCountCheck, int solutionIndex, double* jointPositions);
+
 	virtual bool getCachedReturnData(struct b3UserDataValue* returnData);
 
 	virtual void setTimeOut(double timeOutInSeconds);
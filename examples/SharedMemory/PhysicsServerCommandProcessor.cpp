@@ -51,6 +51,7 @@
 #include "../Importers/ImportSTLDemo/LoadMeshFromSTL.h"
 #include "../Extras/Serialize/BulletWorldImporter/btMultiBodyWorldImporter.h"
 #include "BulletDynamics/Featherstone/btMultiBodyJointMotor.h"
+#include "BulletDynamics/Featherstone/btMultiBodyWorldSnapshot.h"
 #include "LinearMath/btSerializer.h"
 #include "Bullet3Common/b3Logging.h"
 #include "../CommonInterfaces/CommonGUIHelperInterface.h"
@@ -1607,6 +1608,8 @@ struct SaveStateData
 {
 	bParse::btBulletFile* m_bulletFile;
 	btSerializer* m_serializer;
+	//in-memory copy of the simulation state, restored without going through the importer
+	btMultiBodyWorldSnapshot* m_snapshot;
 };
 
 struct PhysicsServerCommandProcessorInternalData
@@ -1641,6 +1644,8 @@ struct PhysicsServerCommandProcessorInternalData
 	btScalar m_simulationTimestamp;
 	btAlignedObjectArray<btMultiBodyJointFeedback*> m_multiBodyJointFeedbacks;
 	b3HashMap<btHashPtr, btInverseDynamics::MultiBodyTree*> m_inverseDynamicsBodies;
+	//additional trees per multibody, so the batched inverse kinematics can evaluate targets in parallel
+	b3HashMap<btHashPtr, btAlignedObjectArray<btInverseDynamics::MultiBodyTree*> > m_inverseKinematicsBatchTrees;
 	b3HashMap<btHashPtr, IKTrajectoryHelper*> m_inverseKinematicsHelpers;
 
 	int m_userConstraintUIDGenerator;
@@ -2029,6 +2034,43 @@ struct PhysicsServerCommandProcessorInternalData
 
 		return tree;
 	}
+
+	//fills trees with numTrees independent trees of the multibody, the first one is the tree of findOrCreateTree
+	bool findOrCreateBatchTrees(btMultiBody* multiBody, int numTrees, btAlignedObjectArray<btInverseDynamics::MultiBodyTree*>& trees)
+	{
+		trees.resize(0);
+		btInverseDynamics::MultiBodyTree* tree = findOrCreateTree(multiBody);
+		if (tree == 0)
+		{
+			return false;
+		}
+		trees.push_back(tree);
+
+		if (m_inverseKinematicsBatchTrees.find(multiBody) == 0)
+		{
+			m_inverseKinematicsBatchTrees.insert(multiBody, btAlignedObjectArray<btInverseDynamics::MultiBodyTree*>());
+		}
+		btAlignedObjectArray<btInverseDynamics::MultiBodyTree*>& extraTrees = *m_inverseKinematicsBatchTrees.find(multiBody);
+		while (extraTrees.size() < numTrees - 1)
+		{
+			btInverseDynamics::btMultiBodyTreeCreator id_creator;
+			if (-1 == id_creator.createFromBtMultiBody(multiBody, false))
+			{
+				return false;
+			}
+			btInverseDynamics::MultiBodyTree* extraTree = btInverseDynamics::CreateMultiBodyTree(id_creator);
+			if (extraTree == 0)
+			{
+				return false;
+			}
+			extraTrees.push_back(extraTree);
+		}
+		for (int i = 0; i < numTrees - 1; i++)
+		{
+			trees.push_back(extraTrees[i]);
+		}
+		return true;
+	}
 };
 
 void PhysicsServerCommandProcessor::setGuiHelper(struct GUIHelperInterface* guiHelper)
@@ -2077,6 +2119,7 @@ PhysicsServerCommandProcessor::~PhysicsServerCommandProcessor()
 	{
 		delete m_data->m_savedStates[i].m_bulletFile;
 		delete m_data->m_savedStates[i].m_serializer;
+		delete m_data->m_savedStates[i].m_snapshot;
 	}
 	
 	delete m_data;
@@ -2906,6 +2949,19 @@ void PhysicsServerCommandProcessor::deleteCachedInverseDynamicsBodies()
 		}
 	}
 	m_data->m_inverseDynamicsBodies.clear();
+
+	for (int i = 0; i < m_data->m_inverseKinematicsBatchTrees.size(); i++)
+	{
+		btAlignedObjectArray<btInverseDynamics::MultiBodyTree*>* treesPtr = m_data->m_inverseKinematicsBatchTrees.getAtIndex(i);
+		if (treesPtr)
+		{
+			for (int j = 0; j < treesPtr->size(); j++)
+			{
+				delete (*treesPtr)[j];
+			}
+		}
+	}
+	m_data->m_inverseKinematicsBatchTrees.clear();
 }
 
 void PhysicsServerCommandProcessor::deleteDynamicsWorld()
@@ -12640,6 +12696,83 @@ bool PhysicsServerCommandProcessor::processCalculateMassMatrixCommand(const stru
 	return hasStatus;
 }
 
+bool PhysicsServerCommandProcessor::processCalculateDynamicsDerivativesCommand(const struct SharedMemoryCommand& clientCmd, struct SharedMemoryStatus& serverStatusOut, char* bufferServerToClient, int bufferSizeInBytes)
+{
+	bool hasStatus = true;
+	BT_PROFILE("CMD_CALCULATE_DYNAMICS_DERIVATIVES");
+
+	SharedMemoryStatus& serverCmd = serverStatusOut;
+	serverCmd.m_type = CMD_CALCULATED_DYNAMICS_DERIVATIVES_FAILED;
+	const CalculateDynamicsDerivativesArgs& args = clientCmd.m_calculateDynamicsDerivativesArguments;
+	InternalBodyHandle* bodyHandle = m_data->m_bodyHandles.getHandle(args.m_bodyUniqueId);
+
+	//only fixed base multibodies for now: the floating base uses a different (Euler angle) parametrization
+	//in inverse dynamics, so the derivatives would not match the PyBullet state layout
+	if (bodyHandle && bodyHandle->m_multiBody && bodyHandle->m_multiBody->hasFixedBase())
+	{
+		btInverseDynamics::MultiBodyTree* tree = m_data->findOrCreateTree(bodyHandle->m_multiBody);
+		const int numDofs = bodyHandle->m_multiBody->getNumDofs();
+		const bool forward = (args.m_flags & DYNAMICS_DERIVATIVES_FORWARD) != 0;
+		const int numMatrices = forward ? 3 : 2;
+		const int sizeInBytes = numMatrices * numDofs * numDofs * sizeof(double);
+
+		if (tree && numDofs > 0 && args.m_dofCount == numDofs && sizeInBytes < bufferSizeInBytes)
+		{
+			btInverseDynamics::vecx q(numDofs), qdot(numDofs), input(numDofs), output(numDofs);
+			btInverseDynamics::matxx d_dq(numDofs, numDofs), d_dqdot(numDofs, numDofs), d_dtau(numDofs, numDofs);
+			for (int i = 0; i < numDofs; i++)
+			{
+				q[i] = args.m_jointPositionsQ[i];
+				qdot[i] = args.m_jointVelocitiesQdot[i];
+				input[i] = args.m_jointInputs[i];
+			}
+
+			btInverseDynamics::vec3 id_grav(m_data->m_dynamicsWorld->getGravity());
+			int result = tree->setGravityInWorldFrame(id_grav);
+			if (-1 != result)
+			{
+				if (forward)
+				{
+					result = tree->calculateForwardDynamicsDerivatives(q, qdot, input, &output, &d_dq, &d_dqdot, &d_dtau);
+				}
+				else
+				{
+					result = tree->calculateInverseDynamicsDerivatives(q, qdot, input, &output, &d_dq, &d_dqdot);
+				}
+			}
+
+			if (-1 != result)
+			{
+				serverCmd.m_dynamicsDerivativesResultArgs.m_bodyUniqueId = args.m_bodyUniqueId;
+				serverCmd.m_dynamicsDerivativesResultArgs.m_dofCount = numDofs;
+				serverCmd.m_dynamicsDerivativesResultArgs.m_flags = args.m_flags;
+				serverCmd.m_dynamicsDerivativesResultArgs.m_numMatrices = numMatrices;
+				for (int i = 0; i < numDofs; i++)
+				{
+					serverCmd.m_dynamicsDerivativesResultArgs.m_jointOutputs[i] = output[i];
+				}
+				// Fill in the derivatives, column-major, one matrix after the other.
+				double* sharedBuf = (double*)bufferServerToClient;
+				const btInverseDynamics::matxx* matrices[3] = {&d_dq, &d_dqdot, &d_dtau};
+				for (int m = 0; m < numMatrices; m++)
+				{
+					for (int i = 0; i < numDofs; ++i)
+					{
+						for (int j = 0; j < numDofs; ++j)
+						{
+							sharedBuf[(m * numDofs + j) * numDofs + i] = (*matrices[m])(i, j);
+						}
+					}
+				}
+				serverCmd.m_numDataStreamBytes = sizeInBytes;
+				serverCmd.m_type = CMD_CALCULATED_DYNAMICS_DERIVATIVES_COMPLETED;
+			}
+		}
+	}
+
+	return hasStatus;
+}
+
 bool PhysicsServerCommandProcessor::processApplyExternalForceCommand(const struct SharedMemoryCommand& clientCmd, struct SharedMemoryStatus& serverStatusOut, char* bufferServerToClient, int bufferSizeInBytes)
 {
 	bool hasStatus = true;
@@ -13830,6 +13963,15 @@ bool PhysicsServerCommandProcessor::processCalculateInverseKinematicsCommand(con
 						}
 					}
 					ikHelperPtr->setDampingCoeff(numDofs, &joint_damping[0]);
+					if (clientCmd.m_updateFlags & IK_HAS_JOINT_LIMITS)
+					{
+						ikHelperPtr->setJointLimits(numDofs, clientCmd.m_calculateInverseKinematicsArguments.m_lowerLimit,
+													clientCmd.m_calculateInverseKinematicsArguments.m_upperLimit);
+					}
+					else
+					{
+						ikHelperPtr->clearJointLimits();
+					}
 
 					double targetDampCoeff[6] = {1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
 
@@ -14171,6 +14313,15 @@ bool PhysicsServerCommandProcessor::processCalculateInverseKinematicsCommand2(co
 						}
 					}
 					ikHelperPtr->setDampingCoeff(numDofs, &joint_damping[0]);
+					if (clientCmd.m_updateFlags & IK_HAS_JOINT_LIMITS)
+					{
+						ikHelperPtr->setJointLimits(numDofs, clientCmd.m_calculateInverseKinematicsArguments.m_lowerLimit,
+													clientCmd.m_calculateInverseKinematicsArguments.m_upperLimit);
+					}
+					else
+					{
+						ikHelperPtr->clearJointLimits();
+					}
 
 					double targetDampCoeff[6] = {1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
 					bool performedIK = false;
@@ -14221,6 +14372,333 @@ bool PhysicsServerCommandProcessor::processCalculateInverseKinematicsCommand2(co
 	return hasStatus;
 }
 
+//number of chunks the kinematics of the batched inverse kinematics are split into, one tree per chunk
+static int btInverseKinematicsBatchNumChunks(int numTargets)
+{
+#if BT_THREADSAFE
+	btITaskScheduler* scheduler = btGetTaskScheduler();
+	if (scheduler && scheduler->getNumThreads() > 1 && !btThreadsAreRunning())
+	{
+		return btMin(numTargets, scheduler->getNumThreads());
+	}
+#endif
+	(void)numTargets;
+	return 1;
+}
+
+//evaluates the end effector position and Jacobian of the active targets. Targets within the residual
+//threshold are marked converged, the others fill their slot of the linearized problems for computeIK2Batch
+struct InverseKinematicsBatchKinematics : public btIParallelForBody
+{
+	btInverseDynamics::MultiBodyTree* const* m_trees;
+	int m_numChunks;
+	int m_numActive;
+	const int* m_activeTargets;
+	const double* m_solutions;
+	const double* m_targetPositions;
+	int m_numDofs;
+	int m_baseDofs;
+	int m_endEffectorLinkIndex;
+	double m_residualThreshold;
+	double* m_batchTargets;
+	double* m_batchCurrent;
+	double* m_batchJacobians;
+	double* m_batchQ;
+	//per active target: 0 unconverged, 1 converged, -1 the kinematics failed
+	int* m_status;
+
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+	{
+		btInverseDynamics::vecx q(m_numDofs + m_baseDofs);
+		btInverseDynamics::mat3x jac_t(3, m_numDofs + m_baseDofs);
+		btInverseDynamics::vec3 world_origin;
+		for (int chunk = iBegin; chunk < iEnd; chunk++)
+		{
+			btInverseDynamics::MultiBodyTree* tree = m_trees[chunk];
+			const int aBegin = (chunk * m_numActive) / m_numChunks;
+			const int aEnd = ((chunk + 1) * m_numActive) / m_numChunks;
+			for (int a = aBegin; a < aEnd; a++)
+			{
+				const int k = m_activeTargets[a];
+				for (int i = 0; i < m_baseDofs; i++)
+				{
+					q[i] = 0;
+				}
+				for (int i = 0; i < m_numDofs; i++)
+				{
+					q[m_baseDofs + i] = m_solutions[k * m_numDofs + i];
+				}
+				if (-1 == tree->calculatePositionKinematics(q) || -1 == tree->calculateJacobians(q))
+				{
+					m_status[a] = -1;
+					continue;
+				}
+				// Note that inverse dynamics uses zero-based indexing of bodies, not starting from -1 for the base link.
+				tree->getBodyJacobianTrans(m_endEffectorLinkIndex + 1, &jac_t);
+				tree->getBodyOrigin(m_endEffectorLinkIndex + 1, &world_origin);
+				btVector3 targetPos(m_targetPositions[k * 3 + 0], m_targetPositions[k * 3 + 1], m_targetPositions[k * 3 + 2]);
+				if ((world_origin - targetPos).length() <= m_residualThreshold)
+				{
+					m_status[a] = 1;
+					continue;
+				}
+				m_status[a] = 0;
+				for (int i = 0; i < 3; i++)
+				{
+					m_batchTargets[a * 3 + i] = targetPos[i];
+					m_batchCurrent[a * 3 + i] = world_origin[i];
+					for (int j = 0; j < m_numDofs; j++)
+					{
+						m_batchJacobians[(a * 3 + i) * m_numDofs + j] = jac_t(i, m_baseDofs + j);
+					}
+				}
+				for (int i = 0; i < m_numDofs; i++)
+				{
+					m_batchQ[a * m_numDofs + i] = m_solutions[k * m_numDofs + i];
+				}
+			}
+		}
+	}
+};
+
+bool PhysicsServerCommandProcessor::processCalculateInverseKinematicsBatchCommand(const struct SharedMemoryCommand& clientCmd, struct SharedMemoryStatus& serverStatusOut, char* bufferServerToClient, int bufferSizeInBytes)
+{
+	bool hasStatus = true;
+
+	BT_PROFILE("CMD_CALCULATE_INVERSE_KINEMATICS_BATCH");
+	SharedMemoryStatus& serverCmd = serverStatusOut;
+	serverCmd.m_type = CMD_CALCULATE_INVERSE_KINEMATICS_BATCH_FAILED;
+
+	const CalculateInverseKinematicsArgs& ikArgs = clientCmd.m_calculateInverseKinematicsArguments;
+	InternalBodyHandle* bodyHandle = m_data->m_bodyHandles.getHandle(ikArgs.m_bodyUniqueId);
+	if (bodyHandle == 0 || bodyHandle->m_multiBody == 0)
+	{
+		return hasStatus;
+	}
+	btMultiBody* mb = bodyHandle->m_multiBody;
+	const int numTargets = ikArgs.m_numTargets;
+	const int endEffectorLinkIndex = ikArgs.m_endEffectorLinkIndices[0];
+	const int numDofs = mb->getNumDofs();
+	const int baseDofs = mb->hasFixedBase() ? 0 : 6;
+	btInverseDynamics::MultiBodyTree* tree = m_data->findOrCreateTree(mb);
+	if (numTargets <= 0 || numTargets > MAX_DEGREE_OF_FREEDOM ||
+		endEffectorLinkIndex < 0 || endEffectorLinkIndex >= mb->getNumLinks() ||
+		tree == 0 || (numDofs + baseDofs) != tree->numDoFs() ||
+		numTargets * numDofs * (int)sizeof(double) > bufferSizeInBytes)
+	{
+		return hasStatus;
+	}
+
+	IKTrajectoryHelper** ikHelperPtrPtr = m_data->m_inverseKinematicsHelpers.find(mb);
+	IKTrajectoryHelper* ikHelperPtr = 0;
+	if (ikHelperPtrPtr)
+	{
+		ikHelperPtr = *ikHelperPtrPtr;
+	}
+	else
+	{
+		ikHelperPtr = new IKTrajectoryHelper;
+		m_data->m_inverseKinematicsHelpers.insert(mb, ikHelperPtr);
+	}
+
+	btAlignedObjectArray<double> startingPositions;
+	{
+		int DofIndex = 0;
+		for (int i = 0; i < mb->getNumLinks(); ++i)
+		{
+			if (mb->getLink(i).m_jointType >= 0 && mb->getLink(i).m_jointType <= 2)
+			{
+				// 0, 1, 2 represent revolute, prismatic, and spherical joint types respectively. Skip the fixed joints.
+				if (clientCmd.m_updateFlags & IK_HAS_CURRENT_JOINT_POSITIONS)
+				{
+					startingPositions.push_back(ikArgs.m_currentPositions[DofIndex]);
+				}
+				else
+				{
+					startingPositions.push_back(mb->getJointPos(i));
+				}
+				DofIndex++;
+			}
+		}
+	}
+	if (startingPositions.size() != numDofs)
+	{
+		return hasStatus;
+	}
+
+	int numIterations = 20;
+	if (clientCmd.m_updateFlags & IK_HAS_MAX_ITERATIONS)
+	{
+		numIterations = ikArgs.m_maxNumIterations;
+	}
+	double residualThreshold = 1e-4;
+	if (clientCmd.m_updateFlags & IK_HAS_RESIDUAL_THRESHOLD)
+	{
+		residualThreshold = ikArgs.m_residualThreshold;
+	}
+
+	//the targets in base coordinates, like processCalculateInverseKinematicsCommand2
+	btAlignedObjectArray<double> targetPositions;
+	targetPositions.resize(numTargets * 3);
+	btTransform baseInv = mb->getBaseWorldTransform().inverse();
+	for (int k = 0; k < numTargets; k++)
+	{
+		btVector3 targetPos(ikArgs.m_targetPositions[k * 3 + 0], ikArgs.m_targetPositions[k * 3 + 1], ikArgs.m_targetPositions[k * 3 + 2]);
+		if ((clientCmd.m_updateFlags & IK_HAS_CURRENT_JOINT_POSITIONS) == 0)
+		{
+			targetPos = baseInv * targetPos;
+		}
+		for (int i = 0; i < 3; i++)
+		{
+			targetPositions[k * 3 + i] = targetPos[i];
+		}
+	}
+
+	btAlignedObjectArray<double> joint_damping;
+	joint_damping.resize(numDofs, 0.5);
+	if (clientCmd.m_updateFlags & IK_HAS_JOINT_DAMPING)
+	{
+		for (int i = 0; i < numDofs; ++i)
+		{
+			joint_damping[i] = ikArgs.m_jointDamping[i];
+		}
+	}
+	ikHelperPtr->setDampingCoeff(numDofs, &joint_damping[0]);
+	if (clientCmd.m_updateFlags & IK_HAS_JOINT_LIMITS)
+	{
+		ikHelperPtr->setJointLimits(numDofs, ikArgs.m_lowerLimit, ikArgs.m_upperLimit);
+	}
+	else
+	{
+		ikHelperPtr->clearJointLimits();
+	}
+	const int ikMethod = (clientCmd.m_updateFlags & IK_SDLS) ? IK2_VEL_SDLS : IK2_VEL_DLS;
+	double targetDampCoeff[6] = {1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+
+	btAlignedObjectArray<double> solutions;
+	solutions.resize(numTargets * numDofs);
+	btAlignedObjectArray<int> activeTargets;
+	for (int k = 0; k < numTargets; k++)
+	{
+		for (int i = 0; i < numDofs; i++)
+		{
+			solutions[k * numDofs + i] = startingPositions[i];
+		}
+		activeTargets.push_back(k);
+	}
+
+	btAlignedObjectArray<btInverseDynamics::MultiBodyTree*> trees;
+	const int numChunks = btInverseKinematicsBatchNumChunks(numTargets);
+	if (!m_data->findOrCreateBatchTrees(mb, numChunks, trees))
+	{
+		return hasStatus;
+	}
+
+	btAlignedObjectArray<double> batchTargets, batchCurrent, batchJacobians, batchQ, batchQNew;
+	btAlignedObjectArray<int> status;
+	batchTargets.resize(numTargets * 3);
+	batchCurrent.resize(numTargets * 3);
+	batchJacobians.resize(numTargets * 3 * numDofs);
+	batchQ.resize(numTargets * numDofs);
+	status.resize(numTargets);
+	for (int iter = 0; iter < numIterations && activeTargets.size(); iter++)
+	{
+		BT_PROFILE("InverseKinematicsBatchStep");
+
+		//evaluate the kinematics of the unconverged targets, each chunk of targets with its own tree,
+		//then solve their linearized problems in parallel
+		InverseKinematicsBatchKinematics kinematics;
+		kinematics.m_trees = &trees[0];
+		kinematics.m_numChunks = btMin(numChunks, activeTargets.size());
+		kinematics.m_numActive = activeTargets.size();
+		kinematics.m_activeTargets = &activeTargets[0];
+		kinematics.m_solutions = &solutions[0];
+		kinematics.m_targetPositions = &targetPositions[0];
+		kinematics.m_numDofs = numDofs;
+		kinematics.m_baseDofs = baseDofs;
+		kinematics.m_endEffectorLinkIndex = endEffectorLinkIndex;
+		kinematics.m_residualThreshold = residualThreshold;
+		kinematics.m_batchTargets = &batchTargets[0];
+		kinematics.m_batchCurrent = &batchCurrent[0];
+		kinematics.m_batchJacobians = &batchJacobians[0];
+		kinematics.m_batchQ = &batchQ[0];
+		kinematics.m_status = &status[0];
+		{
+			BT_PROFILE("InverseKinematicsBatchKinematics");
+			if (kinematics.m_numChunks > 1)
+			{
+				btParallelFor(0, kinematics.m_numChunks, 1, kinematics);
+			}
+			else
+			{
+				kinematics.forLoop(0, 1);
+			}
+		}
+
+		//drop the converged targets, moving the problems of the others to the front
+		int numActive = 0;
+		for (int a = 0; a < activeTargets.size(); a++)
+		{
+			if (status[a] < 0)
+			{
+				return hasStatus;
+			}
+			if (status[a] > 0)
+			{
+				continue;
+			}
+			if (numActive != a)
+			{
+				for (int i = 0; i < 3; i++)
+				{
+					batchTargets[numActive * 3 + i] = batchTargets[a * 3 + i];
+					batchCurrent[numActive * 3 + i] = batchCurrent[a * 3 + i];
+				}
+				for (int i = 0; i < 3 * numDofs; i++)
+				{
+					batchJacobians[numActive * 3 * numDofs + i] = batchJacobians[a * 3 * numDofs + i];
+				}
+				for (int i = 0; i < numDofs; i++)
+				{
+					batchQ[numActive * numDofs + i] = batchQ[a * numDofs + i];
+				}
+			}
+			activeTargets[numActive++] = activeTargets[a];
+		}
+		activeTargets.resize(numActive);
+		if (numActive == 0)
+		{
+			break;
+		}
+
+		batchQNew.resize(numActive * numDofs);
+		{
+			BT_PROFILE("computeIK2Batch");
+			ikHelperPtr->computeIK2Batch(numActive, &batchTargets[0], &batchCurrent[0], 1, &batchQ[0], numDofs,
+										 &batchQNew[0], ikMethod, &batchJacobians[0], targetDampCoeff);
+		}
+		for (int a = 0; a < numActive; a++)
+		{
+			for (int i = 0; i < numDofs; i++)
+			{
+				solutions[activeTargets[a] * numDofs + i] = batchQNew[a * numDofs + i];
+			}
+		}
+	}
+
+	double* jointPositionsOut = (double*)bufferServerToClient;
+	for (int i = 0; i < numTargets * numDofs; i++)
+	{
+		jointPositionsOut[i] = solutions[i];
+	}
+	serverCmd.m_inverseKinematicsBatchResultArgs.m_bodyUniqueId = ikArgs.m_bodyUniqueId;
+	serverCmd.m_inverseKinematicsBatchResultArgs.m_dofCount = numDofs;
+	serverCmd.m_inverseKinematicsBatchResultArgs.m_numSolutions = numTargets;
+	serverCmd.m_numDataStreamBytes = numTargets * numDofs * sizeof(double);
+	serverCmd.m_type = CMD_CALCULATE_INVERSE_KINEMATICS_BATCH_COMPLETED;
+	return hasStatus;
+}
+
 //		PyModule_AddIntConstant(m, "GEOM_SPHERE", GEOM_SPHERE);
 //		PyModule_AddIntConstant(m, "GEOM_BOX", GEOM_BOX);
 //		PyModule_AddIntConstant(m, "GEOM_CYLINDER", GEOM_CYLINDER);
@@ -14832,6 +15310,11 @@ bool PhysicsServerCommandProcessor::processSaveStateCommand(const struct SharedM
 		SaveStateData sd;
 		sd.m_bulletFile = bulletFile;
 		sd.m_serializer = ser;
+		sd.m_snapshot = 0;
+#ifndef USE_DISCRETE_DYNAMICS_WORLD
+		sd.m_snapshot = new btMultiBodyWorldSnapshot();
+		sd.m_snapshot->save(m_data->m_dynamicsWorld);
+#endif
 		if (reuseStateId >= 0)
 		{
 			serverCmd.m_saveStateResultArgs.m_stateId = reuseStateId;
@@ -14860,8 +15343,10 @@ bool PhysicsServerCommandProcessor::processRemoveStateCommand(const struct Share
 			SaveStateData& sd = m_data->m_savedStates[clientCmd.m_loadStateArguments.m_stateId];
 			delete sd.m_bulletFile;
 			delete sd.m_serializer;
+			delete sd.m_snapshot;
 			sd.m_bulletFile = 0;
 			sd.m_serializer = 0;
+			sd.m_snapshot = 0;
 			serverCmd.m_type = CMD_REMOVE_STATE_COMPLETED;
 		}
 	}
@@ -14886,10 +15371,16 @@ bool PhysicsServerCommandProcessor::processRestoreStateCommand(const struct Shar
 	{
 		if (clientCmd.m_loadStateArguments.m_stateId < m_data->m_savedStates.size())
 		{
-			bParse::btBulletFile* bulletFile = m_data->m_savedStates[clientCmd.m_loadStateArguments.m_stateId].m_bulletFile;
-			if (bulletFile)
+			SaveStateData& sd = m_data->m_savedStates[clientCmd.m_loadStateArguments.m_stateId];
+			//the snapshot only applies if no bodies or constraints were added or removed since the save,
+			//otherwise fall back to the importer that matches bodies by their unique id
+			if (sd.m_snapshot && sd.m_snapshot->restore(m_data->m_dynamicsWorld))
+			{
+				ok = true;
+			}
+			else if (sd.m_bulletFile)
 			{
-				ok = importer->convertAllObjects(bulletFile);
+				ok = importer->convertAllObjects(sd.m_bulletFile);
 			}
 		}
 	}
@@ -15369,6 +15860,11 @@ bool PhysicsServerCommandProcessor::processCommand(const struct SharedMemoryComm
 			hasStatus = processCalculateMassMatrixCommand(clientCmd, serverStatusOut, bufferServerToClient, bufferSizeInBytes);
 			break;
 		}
+		case CMD_CALCULATE_DYNAMICS_DERIVATIVES:
+		{
+			hasStatus = processCalculateDynamicsDerivativesCommand(clientCmd, serverStatusOut, bufferServerToClient, bufferSizeInBytes);
+			break;
+		}
 		case CMD_APPLY_EXTERNAL_FORCE:
 		{
 			hasStatus = processApplyExternalForceCommand(clientCmd, serverStatusOut, bufferServerToClient, bufferSizeInBytes);
@@ -15396,6 +15892,11 @@ bool PhysicsServerCommandProcessor::processCommand(const struct SharedMemoryComm
 			}
 			break;
 		}
+		case CMD_CALCULATE_INVERSE_KINEMATICS_BATCH:
+		{
+			hasStatus = processCalculateInverseKinematicsBatchCommand(clientCmd, serverStatusOut, bufferServerToClient, bufferSizeInBytes);
+			break;
+		}
 		case CMD_REQUEST_VISUAL_SHAPE_INFO:
 		{
 			hasStatus = processRequestVisualShapeInfoCommand(clientCmd, serverStatusOut, bufferServerToClient, bufferSizeInBytes);
@@ -16088,6 +16589,7 @@ void PhysicsServerCommandProcessor::resetSimulation(int flags)
 		{
 			delete m_data->m_savedStates[i].m_bulletFile;
 			delete m_data->m_savedStates[i].m_serializer;
+			delete m_data->m_savedStates[i].m_snapshot;
 		}
 		m_data->m_savedStates.clear();
 	}
@@ -754,6 +754,28 @@ struct CalculateInverseDynamicsResultArgs
 	double m_jointForces[MAX_DEGREE_OF_FREEDOM];
 };
 
+struct CalculateDynamicsDerivativesArgs
+{
+	int m_bodyUniqueId;
+	int m_dofCount;
+	double m_jointPositionsQ[MAX_DEGREE_OF_FREEDOM];
+	double m_jointVelocitiesQdot[MAX_DEGREE_OF_FREEDOM];
+	//joint accelerations for inverse dynamics, joint forces for forward dynamics
+	double m_jointInputs[MAX_DEGREE_OF_FREEDOM];
+	int m_flags;
+};
+
+struct CalculateDynamicsDerivativesResultArgs
+{
+	int m_bodyUniqueId;
+	int m_dofCount;
+	int m_flags;
+	//joint forces for inverse dynamics, joint accelerations for forward dynamics
+	double m_jointOutputs[MAX_DEGREE_OF_FREEDOM];
+	//number of dofCount*dofCount matrices streamed to the client
+	int m_numMatrices;
+};
+
 struct CalculateJacobianArgs
 {
 	int m_bodyUniqueId;
@@ -817,6 +839,8 @@ struct CalculateInverseKinematicsArgs
 	double m_currentPositions[MAX_DEGREE_OF_FREEDOM];
 	int m_maxNumIterations;
 	double m_residualThreshold;
+	//CMD_CALCULATE_INVERSE_KINEMATICS_BATCH: number of position targets in m_targetPositions
+	int m_numTargets;
 };
 
 struct CalculateInverseKinematicsResultArgs
@@ -826,6 +850,14 @@ struct CalculateInverseKinematicsResultArgs
 	double m_jointPositions[MAX_DEGREE_OF_FREEDOM];
 };
 
+struct CalculateInverseKinematicsBatchResultArgs
+{
+	int m_bodyUniqueId;
+	int m_dofCount;
+	//number of solutions of m_dofCount joint positions streamed to the client
+	int m_numSolutions;
+};
+
 
 enum EnumBodyChangeFlags
 {
@@ -1197,6 +1229,7 @@ struct SharedMemoryCommand
 		struct CalculateInverseDynamicsArgs m_calculateInverseDynamicsArguments;
 		struct CalculateJacobianArgs m_calculateJacobianArguments;
 		struct CalculateMassMatrixArgs m_calculateMassMatrixArguments;
+		struct CalculateDynamicsDerivativesArgs m_calculateDynamicsDerivativesArguments;
 		struct b3UserConstraint m_userConstraintArguments;
 		struct RequestContactDataArgs m_requestContactPointArguments;
 		struct RequestOverlappingObjectsArgs m_requestOverlappingObjectsArgs;
@@ -1276,9 +1309,11 @@ struct SharedMemoryStatus
 		struct CalculateInverseDynamicsResultArgs m_inverseDynamicsResultArgs;
 		struct CalculateJacobianResultArgs m_jacobianResultArgs;
 		struct CalculateMassMatrixResultArgs m_massMatrixResultArgs;
+		struct CalculateDynamicsDerivativesResultArgs m_dynamicsDerivativesResultArgs;
 		struct SendContactDataArgs m_sendContactPointArgs;
 		struct SendOverlappingObjectsArgs m_sendOverlappingObjectsArgs;
 		struct CalculateInverseKinematicsResultArgs m_inverseKinematicsResultArgs;
+		struct CalculateInverseKinematicsBatchResultArgs m_inverseKinematicsBatchResultArgs;
 		struct SendVisualShapeDataArgs m_sendVisualShapeArgs;
 		struct UserDebugDrawResultArgs m_userDebugDrawArgs;
 		struct b3UserConstraint m_userConstraintResultArgs;
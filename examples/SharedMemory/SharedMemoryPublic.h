@@ -9,7 +9,8 @@
 
 
 
-#define SHARED_MEMORY_MAGIC_NUMBER 202010061
+#define SHARED_MEMORY_MAGIC_NUMBER 202610190
+//#define SHARED_MEMORY_MAGIC_NUMBER 202010061
 //#define SHARED_MEMORY_MAGIC_NUMBER 202007060
 //#define SHARED_MEMORY_MAGIC_NUMBER 202005070
 //#define SHARED_MEMORY_MAGIC_NUMBER 202002030
@@ -120,6 +121,10 @@ enum EnumSharedMemoryClientCommand
 	CMD_RESET_MESH_DATA,
 
 	CMD_REQUEST_TETRA_MESH_DATA,
+
+	CMD_CALCULATE_DYNAMICS_DERIVATIVES,
+
+	CMD_CALCULATE_INVERSE_KINEMATICS_BATCH,
 	//don't go beyond this command!
 	CMD_MAX_CLIENT_COMMANDS,
 };
@@ -249,6 +254,12 @@ enum EnumSharedMemoryServerStatus
 
 	CMD_REQUEST_TETRA_MESH_DATA_COMPLETED,
 	CMD_REQUEST_TETRA_MESH_DATA_FAILED,
+
+	CMD_CALCULATED_DYNAMICS_DERIVATIVES_COMPLETED,
+	CMD_CALCULATED_DYNAMICS_DERIVATIVES_FAILED,
+
+	CMD_CALCULATE_INVERSE_KINEMATICS_BATCH_COMPLETED,
+	CMD_CALCULATE_INVERSE_KINEMATICS_BATCH_FAILED,
 	//don't go beyond 'CMD_MAX_SERVER_COMMANDS!
 	CMD_MAX_SERVER_COMMANDS
 };
@@ -893,6 +904,14 @@ enum EnumCalculateInverseKinematicsFlags
 	IK_HAS_CURRENT_JOINT_POSITIONS = 256,
 	IK_HAS_MAX_ITERATIONS = 512,
 	IK_HAS_RESIDUAL_THRESHOLD = 1024,
+	IK_HAS_JOINT_LIMITS = 2048,
+};
+
+///flags for CMD_CALCULATE_DYNAMICS_DERIVATIVES
+enum EnumCalculateDynamicsDerivativesFlags
+{
+	//by default, derivatives of the inverse dynamics joint forces with respect to q and qdot are computed
+	DYNAMICS_DERIVATIVES_FORWARD = 1,  //derivatives of the joint accelerations with respect to q, qdot and joint forces
 };
 
 enum b3ConfigureDebugVisualizerEnum
@@ -101,6 +101,10 @@ public:
 
 	virtual void getCachedMassMatrix(int dofCountCheck, double* massMatrix);
 
+	virtual void getCachedDynamicsDerivatives(int dofCountCheck, int matrixIndex, double* derivatives);
+
+	virtual void getCachedInverseKinematicsBatch(int dofCountCheck, int solutionIndex, double* jointPositions);
+
 	//the following APIs are for internal use for visualization:
 	virtual bool connect(struct GUIHelperInterface* guiHelper);
 	virtual void renderScene();
@@ -66,6 +66,8 @@ struct MuJoCoPhysicsDirectInternalData
 
 	char m_bulletStreamDataServerToClient[SHARED_MEMORY_MAX_STREAM_CHUNK_SIZE];
 	btAlignedObjectArray<double> m_cachedMassMatrix;
+	btAlignedObjectArray<double> m_cachedDynamicsDerivatives;
+	btAlignedObjectArray<double> m_cachedInverseKinematicsBatch;
 	int m_cachedCameraPixelsWidth;
 	int m_cachedCameraPixelsHeight;
 	btAlignedObjectArray<unsigned char> m_cachedCameraPixelsRGBA;
@@ -1032,6 +1034,38 @@ void MuJoCoPhysicsClient::postProcessStatus(const struct SharedMemoryStatus& ser
 			}
 			break;
 		}
+		case CMD_CALCULATED_DYNAMICS_DERIVATIVES_FAILED:
+		{
+			b3Warning("calculate dynamics derivatives failed");
+			break;
+		}
+		case CMD_CALCULATED_DYNAMICS_DERIVATIVES_COMPLETED:
+		{
+			double* matrixData = (double*)&m_data->m_bulletStreamDataServerToClient[0];
+			int numElements = serverCmd.m_dynamicsDerivativesResultArgs.m_numMatrices * serverCmd.m_dynamicsDerivativesResultArgs.m_dofCount * serverCmd.m_dynamicsDerivativesResultArgs.m_dofCount;
+			m_data->m_cachedDynamicsDerivatives.resize(numElements);
+			for (int i = 0; i < numElements; i++)
+			{
+				m_data->m_cachedDynamicsDerivatives[i] = matrixData[i];
+			}
+			break;
+		}
+		case CMD_CALCULATE_INVERSE_KINEMATICS_BATCH_FAILED:
+		{
+			b3Warning("calculate inverse kinematics batch failed");
+			break;
+		}
+		case CMD_CALCULATE_INVERSE_KINEMATICS_BATCH_COMPLETED:
+		{
+			double* jointPositions = (double*)&m_data->m_bulletStreamDataServerToClient[0];
+			int numElements = serverCmd.m_inverseKinematicsBatchResultArgs.m_numSolutions * serverCmd.m_inverseKinematicsBatchResultArgs.m_dofCount;
+			m_data->m_cachedInverseKinematicsBatch.resize(numElements);
+			for (int i = 0; i < numElements; i++)
+			{
+				m_data->m_cachedInverseKinematicsBatch[i] = jointPositions[i];
+			}
+			break;
+		}
 		case CMD_ACTUAL_STATE_UPDATE_COMPLETED:
 		{
 			break;
@@ -1447,6 +1481,29 @@ void MuJoCoPhysicsClient::getCachedMassMatrix(int dofCountCheck, double* massMat
 	}
 }
 
+void MuJoCoPhysicsClient::getCachedDynamicsDerivatives(int dofCountCheck, int matrixIndex, double* derivatives)
+{
+	int sz = dofCountCheck * dofCountCheck;
+	if ((matrixIndex + 1) * sz <= m_data->m_cachedDynamicsDerivatives.size())
+	{
+		for (int i = 0; i < sz; i++)
+		{
+			derivatives[i] = m_data->m_cachedDynamicsDerivatives[matrixIndex * sz + i];
+		}
+	}
+}
+
+void MuJoCoPhysicsClient::getCachedInverseKinematicsBatch(int dofCountCheck, int solutionIndex, double* jointPositions)
+{
+	if ((solutionIndex + 1) * dofCountCheck <= m_data->m_cachedInverseKinematicsBatch.size())
+	{
+		for (int i = 0; i < dofCountCheck; i++)
+		{
+			jointPositions[i] = m_data->m_cachedInverseKinematicsBatch[solutionIndex * dofCountCheck + i];
+		}
+	}
+}
+
 void MuJoCoPhysicsClient::setTimeOut(double timeOutInSeconds)
 {
 	m_data->m_timeOutInSeconds = timeOutInSeconds;
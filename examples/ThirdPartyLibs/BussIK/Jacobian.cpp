@@ -87,6 +87,13 @@ Jacobian::Jacobian(Tree* tree)
 Jacobian::Jacobian(bool useAngularJacobian, int nDof, int numEndEffectors)
 {
 	m_tree = 0;
+	SetDimensions(useAngularJacobian, nDof, numEndEffectors);
+}
+
+// Resize all work space for a Jacobian without tree.
+// Storage only grows, so reusing a Jacobian for problems of the same (or smaller) size does not allocate.
+void Jacobian::SetDimensions(bool useAngularJacobian, int nDof, int numEndEffectors)
+{
 	m_nEffector = numEndEffectors;
 
 	if (useAngularJacobian)
@@ -99,6 +106,7 @@ Jacobian::Jacobian(bool useAngularJacobian, int nDof, int numEndEffectors)
 	}
 
 	nCol = nDof;
+	nJoint = nDof;
 
 	Jend.SetSize(nRow, nCol);  // The Jocobian matrix
 	Jend.SetZero();
@@ -109,6 +117,7 @@ Jacobian::Jacobian(bool useAngularJacobian, int nDof, int numEndEffectors)
 	U.SetSize(nRow, nRow);  // The U matrix for SVD calculations
 	w.SetLength(Min(nRow, nCol));
 	V.SetSize(nCol, nCol);  // The V matrix for SVD calculations
+	superDiag.SetLength(Max(Min(nRow, nCol) - 1, 1));
 
 	dS.SetLength(nRow);      // (Target positions) - (End effector positions)
 	dTheta.SetLength(nCol);  // Changes in joint angles
@@ -118,10 +127,11 @@ Jacobian::Jacobian(bool useAngularJacobian, int nDof, int numEndEffectors)
 	dT1.SetLength(nRow);  // Linearized change in end effector positions based on dTheta
 
 	// Used by the Selectively Damped Least Squares Method
+	// The angular rows are treated as additional 3-vectors
 	//dT.SetLength(nRow);
-	dSclamp.SetLength(m_nEffector);
+	dSclamp.SetLength(nRow / 3);
 	errorArray.SetLength(m_nEffector);
-	Jnorms.SetSize(m_nEffector, nCol);  // Holds the norms of the active J matrix
+	Jnorms.SetSize(nRow / 3, nCol);  // Holds the norms of the active J matrix
 
 	Reset();
 }
@@ -295,7 +305,7 @@ void Jacobian::CalcDeltaThetasPseudoinverse()
 	// Compute Singular Value Decomposition
 	//	This an inefficient way to do Pseudoinverse, but it is convenient since we need SVD anyway
 
-	J.ComputeSVD(U, w, V);
+	J.ComputeSVD(U, w, V, superDiag);
 
 	// Next line for debugging only
 	assert(J.DebugCheckSVD(U, w, V));
@@ -345,25 +355,25 @@ void Jacobian::CalcDeltaThetasDLSwithNullspace(const VectorRn& desiredV, MatrixR
 	J.MultiplyTranspose(dT1, dTheta);
 
 	// Compute JInv in damped least square form
-	MatrixRmn UInv(U.GetNumRows(), U.GetNumColumns());
+	UInv.SetSize(U.GetNumRows(), U.GetNumColumns());
 	U.ComputeInverse(UInv);
 	assert(U.DebugCheckInverse(UInv));
-	MatrixRmn JInv(J.GetNumColumns(), J.GetNumRows());
+	JInv.SetSize(J.GetNumColumns(), J.GetNumRows());
 	MatrixRmn::TransposeMultiply(J, UInv, JInv);
 
 	// Compute null space projection
-	MatrixRmn JInvJ(J.GetNumColumns(), J.GetNumColumns());
+	JInvJ.SetSize(J.GetNumColumns(), J.GetNumColumns());
 	MatrixRmn::Multiply(JInv, J, JInvJ);
-	MatrixRmn P(J.GetNumColumns(), J.GetNumColumns());
+	P.SetSize(J.GetNumColumns(), J.GetNumColumns());
 	P.SetIdentity();
 	P -= JInvJ;
 
 	// Compute null space velocity
-	VectorRn nullV(J.GetNumColumns());
+	nullV.SetLength(J.GetNumColumns());
 	P.Multiply(desiredV, nullV);
 
 	// Compute residual
-	VectorRn residual(J.GetNumRows());
+	residual.SetLength(J.GetNumRows());
 	J.Multiply(nullV, residual);
 	// TODO: Use residual to set the null space term coefficient adaptively.
 	//printf("residual: %f\n", residual.Norm());
@@ -431,7 +441,7 @@ void Jacobian::CalcDeltaThetasDLSwithSVD()
 	// Compute Singular Value Decomposition
 	//	This an inefficient way to do DLS, but it is convenient since we need SVD anyway
 
-	J.ComputeSVD(U, w, V);
+	J.ComputeSVD(U, w, V, superDiag);
 
 	// Next line for debugging only
 	assert(J.DebugCheckSVD(U, w, V));
@@ -464,7 +474,7 @@ void Jacobian::CalcDeltaThetasSDLS()
 
 	// Compute Singular Value Decomposition
 
-	J.ComputeSVD(U, w, V);
+	J.ComputeSVD(U, w, V, superDiag);
 
 	// Next line for debugging only
 	assert(J.DebugCheckSVD(U, w, V));
@@ -473,7 +483,7 @@ void Jacobian::CalcDeltaThetasSDLS()
 	//	Delta target values are the dS values
 	int nRows = J.GetNumRows();
 	
-	int numEndEffectors = m_tree->GetNumEffector();
+	int numEndEffectors = nRows / 3;  // number of 3-vectors in each column
 	int nCols = J.GetNumColumns();
 	dTheta.SetZero();
 
@@ -492,8 +502,8 @@ void Jacobian::CalcDeltaThetasSDLS()
 	// Clamp the dS values
 	CalcdTClampedFromdS();
 
-	// Loop over each singular vector
-	for (i = 0; i < nRows; i++)
+	// Loop over each singular vector (there are min(nRows, nCols) of them)
+	for (i = 0; i < w.GetLength(); i++)
 	{
 		double wiInv = w[i];
 		if (NearZero(wiInv, 1.0e-10))
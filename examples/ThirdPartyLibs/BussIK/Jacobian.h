@@ -58,6 +58,7 @@ class Jacobian
 public:
 	Jacobian(Tree*);
 	Jacobian(bool useAngularJacobian, int nDof, int numEndEffectors);
+	void SetDimensions(bool useAngularJacobian, int nDof, int numEndEffectors);
 
 	void ComputeJacobian(VectorR3* targets);
 	const MatrixRmn& ActiveJacobian() const { return *Jactive; }
@@ -112,6 +113,15 @@ public:
 	MatrixRmn U;  // J = U * Diag(w) * V^T	(Singular Value Decomposition)
 	VectorRn w;
 	MatrixRmn V;
+	VectorRn superDiag;  // SVD work space, kept per Jacobian so solvers can run concurrently
+
+	// Work space of the DLS method with null space
+	MatrixRmn UInv;
+	MatrixRmn JInv;
+	MatrixRmn JInvJ;
+	MatrixRmn P;
+	VectorRn nullV;
+	VectorRn residual;
 
 	UpdateMode CurrentUpdateMode;
 
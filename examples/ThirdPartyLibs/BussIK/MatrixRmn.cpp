@@ -531,10 +531,13 @@ void MatrixRmn::PostApplyGivens(double c, double s, long idx1, long idx2)
 // ********************************************************************************************
 void MatrixRmn::ComputeSVD(MatrixRmn& U, VectorRn& w, MatrixRmn& V) const
 {
-	assert(U.NumRows == NumRows && V.NumCols == NumCols && U.NumRows == U.NumCols && V.NumRows == V.NumCols && w.GetLength() == Min(NumRows, NumCols));
+	ComputeSVD(U, w, V, VectorRn::GetWorkVector(w.GetLength() - 1));  // Some extra work space.  Will get passed around.
+}
 
-	//	double temp=0.0;
-	VectorRn& superDiag = VectorRn::GetWorkVector(w.GetLength() - 1);  // Some extra work space.  Will get passed around.
+void MatrixRmn::ComputeSVD(MatrixRmn& U, VectorRn& w, MatrixRmn& V, VectorRn& superDiag) const
+{
+	assert(U.NumRows == NumRows && V.NumCols == NumCols && U.NumRows == U.NumCols && V.NumRows == V.NumCols && w.GetLength() == Min(NumRows, NumCols));
+	assert(superDiag.GetLength() >= w.GetLength() - 1);
 
 	// Choose larger of U, V to hold intermediate results
 	// If U is larger than V, use U to store intermediate results
@@ -132,6 +132,7 @@ public:
 
 	// Singular value decomposition
 	void ComputeSVD(MatrixRmn& U, VectorRn& w, MatrixRmn& V) const;
+	void ComputeSVD(MatrixRmn& U, VectorRn& w, MatrixRmn& V, VectorRn& superDiag) const;  // Uses superDiag as work space
 	// Good for debugging SVD computations (I recommend this be used for any new application to check for bugs/instability).
 	bool DebugCheckSVD(const MatrixRmn& U, const VectorRn& w, const MatrixRmn& V) const;
 	// Compute inverse of a matrix, the result is written in R
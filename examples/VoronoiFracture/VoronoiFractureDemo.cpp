@@ -37,7 +37,7 @@ static int useMpr = 0;
 
 static bool useGenericConstraint = false;
 
-#include "btConvexConvexMprAlgorithm.h"
+#include "BulletCollision/CollisionDispatch/btConvexConvexMprAlgorithm.h"
 
 #include "LinearMath/btAlignedObjectArray.h"
 #include "LinearMath/btConvexHullComputer.h"
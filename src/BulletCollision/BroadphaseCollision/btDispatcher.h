@@ -47,7 +47,10 @@ struct btDispatcherInfo
 		  m_allowedCcdPenetration(btScalar(0.04)),
 		  m_useConvexConservativeDistanceUtil(false),
 		  m_convexConservativeDistanceThreshold(0.0f),
-		  m_deterministicOverlappingPairs(false)
+		  m_deterministicOverlappingPairs(false),
+		  m_useConvexFeatureCache(false),
+		  m_reduceMeshContacts(false),
+		  m_useSpeculativeContacts(false)
 	{
 	}
 	btScalar m_timeStep;
@@ -63,6 +66,15 @@ struct btDispatcherInfo
 	bool m_useConvexConservativeDistanceUtil;
 	btScalar m_convexConservativeDistanceThreshold;
 	bool m_deterministicOverlappingPairs;
+	///convex-convex pairs keep their separating feature and GJK separating axis between frames, see btSeparatingAxisCache.
+	///Off by default: the cached feature of minimum penetration is reused within a tolerance, which changes the contacts
+	bool m_useConvexFeatureCache;
+	///convex-triangle mesh pairs reduce the contacts of all overlapping triangles to MANIFOLD_CACHE_SIZE points before they
+	///reach the manifold, see btConvexConcaveCollisionAlgorithm
+	bool m_reduceMeshContacts;
+	///with m_useContinuous, objects moving faster than their ccd motion threshold get contacts up to the distance they can
+	///close in the step (speculative contacts), instead of a swept sphere test that clamps their motion
+	bool m_useSpeculativeContacts;
 };
 
 enum ebtDispatcherQueryType
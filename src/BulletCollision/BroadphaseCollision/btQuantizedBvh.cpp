@@ -18,6 +18,7 @@ subject to the following restrictions:
 #include "LinearMath/btAabbUtil2.h"
 #include "LinearMath/btIDebugDraw.h"
 #include "LinearMath/btSerializer.h"
+#include "LinearMath/btThreads.h"
 
 #define RAYAABB2
 
@@ -33,7 +34,7 @@ btQuantizedBvh::btQuantizedBvh() : m_bulletVersion(BT_BULLET_VERSION),
 	m_bvhAabbMax.setValue(SIMD_INFINITY, SIMD_INFINITY, SIMD_INFINITY);
 }
 
-void btQuantizedBvh::buildInternal()
+void btQuantizedBvh::buildInternal(btBuildMode buildMode)
 {
 	///assumes that caller filled in the m_quantizedLeafNodes
 	m_useQuantization = true;
@@ -49,7 +50,14 @@ void btQuantizedBvh::buildInternal()
 
 	m_curNodeIndex = 0;
 
-	buildTree(0, numLeafNodes);
+	if (buildMode == BUILD_BINNED_SAH)
+	{
+		buildTreeBinnedSah(numLeafNodes);
+	}
+	else
+	{
+		buildTree(0, numLeafNodes);
+	}
 
 	///if the entire tree is small then subtree size, we need to create a header info for the tree
 	if (m_useQuantization && !m_SubtreeHeaders.size())
@@ -229,6 +237,478 @@ void btQuantizedBvh::updateSubtreeHeaders(int leftChildNodexIndex, int rightChil
 	m_subtreeHeaderCount = m_SubtreeHeaders.size();
 }
 
+#define BT_BVH_SAH_NUM_BINS 32
+///below this depth the binned SAH falls back to balanced splits, to bound the recursion depth
+#define BT_BVH_SAH_MAX_DEPTH 64
+///subtrees with fewer leaves than this are not split into more parallel tasks
+#define BT_BVH_SAH_MIN_TASK_SIZE 1024
+
+ATTRIBUTE_ALIGNED16(struct)
+btBvhBuildPrimitive
+{
+	btVector3 m_aabbMin;
+	btVector3 m_aabbMax;
+	int m_leafIndex;
+
+	btVector3 getCenter() const
+	{
+		return btScalar(0.5) * (m_aabbMin + m_aabbMax);
+	}
+};
+
+///a range of primitives that becomes the subtree at m_nodeIndex, with the bounds of the primitive centers
+ATTRIBUTE_ALIGNED16(struct)
+btBvhBuildTask
+{
+	btVector3 m_centerMin;
+	btVector3 m_centerMax;
+	int m_startIndex;
+	int m_endIndex;
+	int m_nodeIndex;
+	int m_depth;
+};
+
+struct btBvhBuildInternalNode
+{
+	int m_nodeIndex;
+	int m_leftChildNodeIndex;
+	int m_rightChildNodeIndex;
+};
+
+struct btBvhBuildSubtreesLoop : public btIParallelForBody
+{
+	btQuantizedBvh* m_bvh;
+	btBvhBuildPrimitive* m_primitives;
+	const btBvhBuildTask* m_tasks;
+
+	btBvhBuildSubtreesLoop(btQuantizedBvh* bvh, btBvhBuildPrimitive* primitives, const btBvhBuildTask* tasks)
+		: m_bvh(bvh),
+		  m_primitives(primitives),
+		  m_tasks(tasks)
+	{
+	}
+
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+	{
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			m_bvh->buildSubtreeBinnedSah(m_primitives, m_tasks[i]);
+		}
+	}
+};
+
+static bool btUseParallelBvhBuild(int numTasks)
+{
+#if BT_THREADSAFE
+	btITaskScheduler* scheduler = btGetTaskScheduler();
+	return numTasks > 1 && scheduler && scheduler->getNumThreads() > 1 && !btThreadsAreRunning();
+#else
+	(void)numTasks;
+	return false;
+#endif
+}
+
+static SIMD_FORCE_INLINE btScalar btBvhHalfArea(const btVector3& aabbMin, const btVector3& aabbMax)
+{
+	const btVector3 extent = aabbMax - aabbMin;
+	return extent[0] * extent[1] + extent[1] * extent[2] + extent[2] * extent[0];
+}
+
+static SIMD_FORCE_INLINE int btBvhSahBin(btScalar binCoord)
+{
+	const int bin = int(binCoord);
+	return bin < BT_BVH_SAH_NUM_BINS - 1 ? bin : BT_BVH_SAH_NUM_BINS - 1;
+}
+
+static void btBvhCalcCenterBounds(const btBvhBuildPrimitive* primitives, btBvhBuildTask& task)
+{
+	task.m_centerMin = primitives[task.m_startIndex].getCenter();
+	task.m_centerMax = task.m_centerMin;
+	for (int i = task.m_startIndex + 1; i < task.m_endIndex; i++)
+	{
+		const btVector3 center = primitives[i].getCenter();
+		task.m_centerMin.setMin(center);
+		task.m_centerMax.setMax(center);
+	}
+}
+
+void btQuantizedBvh::buildTreeBinnedSah(int numLeafNodes)
+{
+	m_curNodeIndex = 0;
+	if (numLeafNodes <= 0)
+		return;
+
+	btAlignedObjectArray<btBvhBuildPrimitive> primitives;
+	primitives.resize(numLeafNodes);
+	for (int i = 0; i < numLeafNodes; i++)
+	{
+		btBvhBuildPrimitive& primitive = primitives[i];
+		primitive.m_aabbMin = getAabbMin(i);
+		primitive.m_aabbMax = getAabbMax(i);
+		primitive.m_leafIndex = i;
+	}
+
+	//a subtree of n leaves always takes 2n-1 nodes, so the node index of each subtree is known
+	//before it is built. Split the top of the tree into independent subtrees, then build those in parallel.
+	//The splits don't depend on the number of threads, so neither does the tree.
+	int numThreads = 1;
+#if BT_THREADSAFE
+	btITaskScheduler* scheduler = btGetTaskScheduler();
+	if (scheduler && !btThreadsAreRunning())
+	{
+		numThreads = scheduler->getNumThreads();
+	}
+#endif
+	const int taskSize = btMax(BT_BVH_SAH_MIN_TASK_SIZE, numLeafNodes / (4 * numThreads));
+
+	btAlignedObjectArray<btBvhBuildTask> tasks;
+	btAlignedObjectArray<btBvhBuildTask> stack;
+	btAlignedObjectArray<btBvhBuildInternalNode> topNodes;
+	btBvhBuildTask root;
+	root.m_startIndex = 0;
+	root.m_endIndex = numLeafNodes;
+	root.m_nodeIndex = 0;
+	root.m_depth = 0;
+	btBvhCalcCenterBounds(&primitives[0], root);
+	stack.push_back(root);
+	while (stack.size())
+	{
+		const btBvhBuildTask task = stack[stack.size() - 1];
+		stack.pop_back();
+		const int numIndices = task.m_endIndex - task.m_startIndex;
+		if (numIndices <= taskSize || numThreads == 1)
+		{
+			tasks.push_back(task);
+			continue;
+		}
+
+		btBvhBuildTask leftTask;
+		btBvhBuildTask rightTask;
+		splitBinnedSah(&primitives[0], task, leftTask, rightTask);
+
+		btBvhBuildInternalNode node;
+		node.m_nodeIndex = task.m_nodeIndex;
+		node.m_leftChildNodeIndex = leftTask.m_nodeIndex;
+		node.m_rightChildNodeIndex = rightTask.m_nodeIndex;
+		topNodes.push_back(node);
+		setInternalNodeEscapeIndex(task.m_nodeIndex, 2 * numIndices - 1);
+
+		stack.push_back(rightTask);
+		stack.push_back(leftTask);
+	}
+
+	btBvhBuildSubtreesLoop loop(this, &primitives[0], &tasks[0]);
+	if (btUseParallelBvhBuild(tasks.size()))
+	{
+		btParallelFor(0, tasks.size(), 1, loop);
+	}
+	else
+	{
+		loop.forLoop(0, tasks.size());
+	}
+
+	//the top nodes were recorded parents first, merge the child bounds in reverse order
+	for (int i = topNodes.size() - 1; i >= 0; i--)
+	{
+		const btBvhBuildInternalNode& node = topNodes[i];
+		mergeChildNodeAabbs(node.m_nodeIndex, node.m_leftChildNodeIndex, node.m_rightChildNodeIndex);
+	}
+
+	m_curNodeIndex = 2 * numLeafNodes - 1;
+
+	if (m_useQuantization)
+	{
+		buildSubtreeHeaders(0);
+	}
+}
+
+void btQuantizedBvh::buildSubtreeBinnedSah(btBvhBuildPrimitive* primitives, const btBvhBuildTask& task)
+{
+	const int numIndices = task.m_endIndex - task.m_startIndex;
+	btAssert(numIndices > 0);
+
+	if (numIndices == 1)
+	{
+		assignInternalNodeFromLeafNode(task.m_nodeIndex, primitives[task.m_startIndex].m_leafIndex);
+		return;
+	}
+
+	btBvhBuildTask leftTask;
+	btBvhBuildTask rightTask;
+	splitBinnedSah(primitives, task, leftTask, rightTask);
+
+	buildSubtreeBinnedSah(primitives, leftTask);
+	buildSubtreeBinnedSah(primitives, rightTask);
+
+	mergeChildNodeAabbs(task.m_nodeIndex, leftTask.m_nodeIndex, rightTask.m_nodeIndex);
+	setInternalNodeEscapeIndex(task.m_nodeIndex, 2 * numIndices - 1);
+}
+
+static SIMD_FORCE_INLINE btScalar btQuantizedHalfArea(const btQuantizedBvhNode& node)
+{
+	const btScalar x = btScalar(node.m_quantizedAabbMax[0] - node.m_quantizedAabbMin[0]);
+	const btScalar y = btScalar(node.m_quantizedAabbMax[1] - node.m_quantizedAabbMin[1]);
+	const btScalar z = btScalar(node.m_quantizedAabbMax[2] - node.m_quantizedAabbMin[2]);
+	return x * y + y * z + z * x;
+}
+
+btScalar btQuantizedBvh::calcSubtreeCost(int subtreeIndex) const
+{
+	btAssert(m_useQuantization);
+	const btBvhSubtreeInfo& subtree = m_SubtreeHeaders[subtreeIndex];
+	const btScalar rootArea = btQuantizedHalfArea(m_quantizedContiguousNodes[subtree.m_rootNodeIndex]);
+	if (rootArea <= btScalar(0))
+		return btScalar(0);
+
+	btScalar cost = btScalar(0);
+	const int endNodeIndex = subtree.m_rootNodeIndex + subtree.m_subtreeSize;
+	for (int i = subtree.m_rootNodeIndex; i < endNodeIndex; i++)
+	{
+		const btQuantizedBvhNode& node = m_quantizedContiguousNodes[i];
+		if (!node.isLeafNode())
+		{
+			cost += btQuantizedHalfArea(node);
+		}
+	}
+	return cost / rootArea;
+}
+
+void btQuantizedBvh::rebuildSubtree(int subtreeIndex)
+{
+	btAssert(m_useQuantization);
+	const btBvhSubtreeInfo& subtree = m_SubtreeHeaders[subtreeIndex];
+	const int endNodeIndex = subtree.m_rootNodeIndex + subtree.m_subtreeSize;
+
+	//the leaves of the subtree become the leaf nodes of a small build, like buildInternal
+	btAlignedObjectArray<btBvhBuildPrimitive> primitives;
+	primitives.reserve((subtree.m_subtreeSize + 1) / 2);
+	m_quantizedLeafNodes.resize(0);
+	for (int i = subtree.m_rootNodeIndex; i < endNodeIndex; i++)
+	{
+		const btQuantizedBvhNode& node = m_quantizedContiguousNodes[i];
+		if (node.isLeafNode())
+		{
+			btBvhBuildPrimitive& primitive = primitives.expandNonInitializing();
+			primitive.m_aabbMin = unQuantize(node.m_quantizedAabbMin);
+			primitive.m_aabbMax = unQuantize(node.m_quantizedAabbMax);
+			primitive.m_leafIndex = m_quantizedLeafNodes.size();
+			m_quantizedLeafNodes.push_back(node);
+		}
+	}
+	btAssert(2 * primitives.size() - 1 == subtree.m_subtreeSize);
+
+	btBvhBuildTask task;
+	task.m_startIndex = 0;
+	task.m_endIndex = primitives.size();
+	task.m_nodeIndex = subtree.m_rootNodeIndex;
+	task.m_depth = 0;
+	btBvhCalcCenterBounds(&primitives[0], task);
+	buildSubtreeBinnedSah(&primitives[0], task);
+
+	m_quantizedLeafNodes.clear();
+}
+
+void btQuantizedBvh::splitBinnedSah(btBvhBuildPrimitive* primitives, const btBvhBuildTask& task, btBvhBuildTask& leftTask, btBvhBuildTask& rightTask) const
+{
+	const int startIndex = task.m_startIndex;
+	const int endIndex = task.m_endIndex;
+	const int numIndices = endIndex - startIndex;
+	const btVector3 centerExtent = task.m_centerMax - task.m_centerMin;
+
+	int bestAxis = -1;
+	int bestBin = 0;
+	btVector3 binScale(0, 0, 0);
+
+	if (numIndices > 2 && task.m_depth < BT_BVH_SAH_MAX_DEPTH)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (centerExtent[axis] > btScalar(0))
+				binScale[axis] = btScalar(BT_BVH_SAH_NUM_BINS) / centerExtent[axis];
+		}
+
+		const btVector3 emptyMin(btScalar(BT_LARGE_FLOAT), btScalar(BT_LARGE_FLOAT), btScalar(BT_LARGE_FLOAT));
+		const btVector3 emptyMax = -emptyMin;
+		int binCount[3][BT_BVH_SAH_NUM_BINS];
+		btVector3 binMin[3][BT_BVH_SAH_NUM_BINS];
+		btVector3 binMax[3][BT_BVH_SAH_NUM_BINS];
+		for (int axis = 0; axis < 3; axis++)
+		{
+			for (int b = 0; b < BT_BVH_SAH_NUM_BINS; b++)
+			{
+				binCount[axis][b] = 0;
+				binMin[axis][b] = emptyMin;
+				binMax[axis][b] = emptyMax;
+			}
+		}
+
+		//bin the primitives along all three axes in one pass
+		for (int i = startIndex; i < endIndex; i++)
+		{
+			const btBvhBuildPrimitive& primitive = primitives[i];
+			const btVector3 binCoord = (primitive.getCenter() - task.m_centerMin) * binScale;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				const int b = btBvhSahBin(binCoord[axis]);
+				binCount[axis][b]++;
+				binMin[axis][b].setMin(primitive.m_aabbMin);
+				binMax[axis][b].setMax(primitive.m_aabbMax);
+			}
+		}
+
+		btScalar bestCost = btScalar(BT_LARGE_FLOAT);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (binScale[axis] == btScalar(0))
+				continue;
+
+			//sweep from the right to get the cost of the right side of each split plane
+			btScalar rightCost[BT_BVH_SAH_NUM_BINS];
+			btVector3 accumMin = emptyMin;
+			btVector3 accumMax = emptyMax;
+			int accumCount = 0;
+			for (int b = BT_BVH_SAH_NUM_BINS - 1; b > 0; b--)
+			{
+				accumMin.setMin(binMin[axis][b]);
+				accumMax.setMax(binMax[axis][b]);
+				accumCount += binCount[axis][b];
+				rightCost[b] = accumCount ? btBvhHalfArea(accumMin, accumMax) * btScalar(accumCount) : btScalar(0);
+			}
+
+			accumMin = emptyMin;
+			accumMax = emptyMax;
+			accumCount = 0;
+			for (int b = 0; b < BT_BVH_SAH_NUM_BINS - 1; b++)
+			{
+				accumMin.setMin(binMin[axis][b]);
+				accumMax.setMax(binMax[axis][b]);
+				accumCount += binCount[axis][b];
+				if (accumCount == 0 || accumCount == numIndices)
+					continue;
+				const btScalar cost = btBvhHalfArea(accumMin, accumMax) * btScalar(accumCount) + rightCost[b + 1];
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestBin = b + 1;
+				}
+			}
+		}
+	}
+
+	int splitIndex = startIndex;
+	bool hasCenterBounds = false;
+	if (bestAxis >= 0)
+	{
+		//partition, and gather the center bounds of both sides for the next split
+		leftTask.m_centerMin = task.m_centerMax;
+		leftTask.m_centerMax = task.m_centerMin;
+		rightTask.m_centerMin = task.m_centerMax;
+		rightTask.m_centerMax = task.m_centerMin;
+		for (int i = startIndex; i < endIndex; i++)
+		{
+			const btVector3 center = primitives[i].getCenter();
+			if (btBvhSahBin((center[bestAxis] - task.m_centerMin[bestAxis]) * binScale[bestAxis]) < bestBin)
+			{
+				btSwap(primitives[i], primitives[splitIndex]);
+				splitIndex++;
+				leftTask.m_centerMin.setMin(center);
+				leftTask.m_centerMax.setMax(center);
+			}
+			else
+			{
+				rightTask.m_centerMin.setMin(center);
+				rightTask.m_centerMax.setMax(center);
+			}
+		}
+		hasCenterBounds = true;
+	}
+	else if (numIndices == 2)
+	{
+		splitIndex = startIndex + 1;
+	}
+	else
+	{
+		//all centers coincide, or the tree got too deep: split at the middle of the center bounds,
+		//and keep the split balanced like sortAndCalcSplittingIndex so the depth stays logarithmic
+		const int axis = centerExtent.maxAxis();
+		const btScalar splitValue = btScalar(0.5) * (task.m_centerMin[axis] + task.m_centerMax[axis]);
+		for (int i = startIndex; i < endIndex; i++)
+		{
+			if (primitives[i].getCenter()[axis] < splitValue)
+			{
+				btSwap(primitives[i], primitives[splitIndex]);
+				splitIndex++;
+			}
+		}
+		const int rangeBalancedIndices = numIndices / 3;
+		if ((splitIndex <= (startIndex + rangeBalancedIndices)) || (splitIndex >= (endIndex - 1 - rangeBalancedIndices)))
+		{
+			splitIndex = startIndex + (numIndices >> 1);
+		}
+	}
+
+	leftTask.m_startIndex = startIndex;
+	leftTask.m_endIndex = splitIndex;
+	leftTask.m_nodeIndex = task.m_nodeIndex + 1;
+	leftTask.m_depth = task.m_depth + 1;
+
+	rightTask.m_startIndex = splitIndex;
+	rightTask.m_endIndex = endIndex;
+	rightTask.m_nodeIndex = leftTask.m_nodeIndex + 2 * (splitIndex - startIndex) - 1;
+	rightTask.m_depth = task.m_depth + 1;
+
+	if (!hasCenterBounds)
+	{
+		btBvhCalcCenterBounds(primitives, leftTask);
+		btBvhCalcCenterBounds(primitives, rightTask);
+	}
+}
+
+void btQuantizedBvh::mergeChildNodeAabbs(int nodeIndex, int leftChildNodeIndex, int rightChildNodeIndex)
+{
+	if (m_useQuantization)
+	{
+		btQuantizedBvhNode& node = m_quantizedContiguousNodes[nodeIndex];
+		const btQuantizedBvhNode& leftChild = m_quantizedContiguousNodes[leftChildNodeIndex];
+		const btQuantizedBvhNode& rightChild = m_quantizedContiguousNodes[rightChildNodeIndex];
+		for (int i = 0; i < 3; i++)
+		{
+			node.m_quantizedAabbMin[i] = btMin(leftChild.m_quantizedAabbMin[i], rightChild.m_quantizedAabbMin[i]);
+			node.m_quantizedAabbMax[i] = btMax(leftChild.m_quantizedAabbMax[i], rightChild.m_quantizedAabbMax[i]);
+		}
+	}
+	else
+	{
+		btOptimizedBvhNode& node = m_contiguousNodes[nodeIndex];
+		node.m_aabbMinOrg = m_contiguousNodes[leftChildNodeIndex].m_aabbMinOrg;
+		node.m_aabbMinOrg.setMin(m_contiguousNodes[rightChildNodeIndex].m_aabbMinOrg);
+		node.m_aabbMaxOrg = m_contiguousNodes[leftChildNodeIndex].m_aabbMaxOrg;
+		node.m_aabbMaxOrg.setMax(m_contiguousNodes[rightChildNodeIndex].m_aabbMaxOrg);
+	}
+}
+
+///add the subtree headers in the same (post) order as buildTree
+void btQuantizedBvh::buildSubtreeHeaders(int nodeIndex)
+{
+	const btQuantizedBvhNode& node = m_quantizedContiguousNodes[nodeIndex];
+	if (node.isLeafNode())
+		return;
+
+	const int leftChildNodeIndex = nodeIndex + 1;
+	const btQuantizedBvhNode& leftChild = m_quantizedContiguousNodes[leftChildNodeIndex];
+	const int rightChildNodeIndex = leftChildNodeIndex + (leftChild.isLeafNode() ? 1 : leftChild.getEscapeIndex());
+
+	buildSubtreeHeaders(leftChildNodeIndex);
+	buildSubtreeHeaders(rightChildNodeIndex);
+
+	const int treeSizeInBytes = node.getEscapeIndex() * static_cast<int>(sizeof(btQuantizedBvhNode));
+	if (treeSizeInBytes > MAX_SUBTREE_SIZE_IN_BYTES)
+	{
+		updateSubtreeHeaders(leftChildNodeIndex, rightChildNodeIndex);
+	}
+}
+
 int btQuantizedBvh::sortAndCalcSplittingIndex(int startIndex, int endIndex, int splitAxis)
 {
 	int i;
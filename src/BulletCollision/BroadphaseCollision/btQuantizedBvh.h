@@ -17,6 +17,8 @@ subject to the following restrictions:
 #define BT_QUANTIZED_BVH_H
 
 class btSerializer;
+struct btBvhBuildPrimitive;
+struct btBvhBuildTask;
 
 //#define DEBUG_CHECK_DEQUANTIZATION 1
 #ifdef DEBUG_CHECK_DEQUANTIZATION
@@ -176,6 +178,12 @@ public:
 		TRAVERSAL_RECURSIVE
 	};
 
+	enum btBuildMode
+	{
+		BUILD_MEAN_SPLIT = 0,  //split at the mean of the centers, along the axis of largest variance
+		BUILD_BINNED_SAH       //binned surface area heuristic, the subtrees are built in parallel with btParallelFor
+	};
+
 protected:
 	btVector3 m_bvhAabbMin;
 	btVector3 m_bvhAabbMax;
@@ -307,6 +315,19 @@ protected:
 
 	void updateSubtreeHeaders(int leftChildNodexIndex, int rightChildNodexIndex);
 
+	///binned SAH build, produces the same node layout as buildTree so traversal and serialization are unchanged
+	void buildTreeBinnedSah(int numLeafNodes);
+
+	void buildSubtreeBinnedSah(btBvhBuildPrimitive * primitives, const btBvhBuildTask& task);
+
+	void splitBinnedSah(btBvhBuildPrimitive * primitives, const btBvhBuildTask& task, btBvhBuildTask& leftTask, btBvhBuildTask& rightTask) const;
+
+	void mergeChildNodeAabbs(int nodeIndex, int leftChildNodeIndex, int rightChildNodeIndex);
+
+	void buildSubtreeHeaders(int nodeIndex);
+
+	friend struct btBvhBuildSubtreesLoop;
+
 public:
 	BT_DECLARE_ALIGNED_ALLOCATOR();
 
@@ -318,7 +339,7 @@ public:
 	void setQuantizationValues(const btVector3& bvhAabbMin, const btVector3& bvhAabbMax, btScalar quantizationMargin = btScalar(1.0));
 	QuantizedNodeArray& getLeafNodeArray() { return m_quantizedLeafNodes; }
 	///buildInternal is expert use only: assumes that setQuantizationValues and LeafNodeArray are initialized
-	void buildInternal();
+	void buildInternal(btBuildMode buildMode = BUILD_MEAN_SPLIT);
 	///***************************************** expert/internal use only *************************
 
 	void reportAabbOverlappingNodex(btNodeOverlapCallback * nodeCallback, const btVector3& aabbMin, const btVector3& aabbMax) const;
@@ -411,6 +432,21 @@ public:
 		return vecOut;
 	}
 
+	const btVector3& getBvhAabbMin() const
+	{
+		return m_bvhAabbMin;
+	}
+
+	const btVector3& getBvhAabbMax() const
+	{
+		return m_bvhAabbMax;
+	}
+
+	const btVector3& getBvhQuantization() const
+	{
+		return m_bvhQuantization;
+	}
+
 	///setTraversalMode let's you choose between stackless, recursive or stackless cache friendly tree traversal. Note this is only implemented for quantized trees.
 	void setTraversalMode(btTraversalMode traversalMode)
 	{
@@ -427,6 +463,14 @@ public:
 		return m_SubtreeHeaders;
 	}
 
+	///surface area heuristic cost of a quantized subtree: the summed half areas of its internal nodes, relative to its root.
+	///It grows when refitting moves the leaves of a subtree apart, see rebuildSubtree
+	btScalar calcSubtreeCost(int subtreeIndex) const;
+
+	///rebuilds the nodes of a quantized subtree from the current bounds of its leaves with binned SAH, in place.
+	///The subtree keeps its node range and bounds, so the rest of the tree, the subtree headers and serialization are unaffected
+	void rebuildSubtree(int subtreeIndex);
+
 	////////////////////////////////////////////////////////////////////
 
 	/////Calculate space needed to store BVH for serialization
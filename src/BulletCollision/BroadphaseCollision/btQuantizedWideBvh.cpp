@@ -0,0 +1,563 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btQuantizedWideBvh.h"
+#include "LinearMath/btThreads.h"
+
+#include <string.h>  //memcpy
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BT_WIDE_BVH_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#define BT_WIDE_BVH_NODE_ALIGNMENT 64
+
+///wide nodes per task of the parallel refit
+#define BT_WIDE_BVH_REFIT_GRAIN_SIZE 256
+
+static SIMD_FORCE_INLINE int btWideBvhPartId(int leafData)
+{
+	return leafData >> (31 - MAX_NUM_PARTS_IN_BITS);
+}
+
+static SIMD_FORCE_INLINE int btWideBvhTriangleIndex(int leafData)
+{
+	unsigned int x = 0;
+	unsigned int y = (~(x & 0)) << (31 - MAX_NUM_PARTS_IN_BITS);
+	return leafData & ~(y);
+}
+
+static SIMD_FORCE_INLINE btScalar btWideBvhHalfArea(const btQuantizedBvhNode& node, const btVector3& invQuantization)
+{
+	btVector3 extent(
+		btScalar(node.m_quantizedAabbMax[0] - node.m_quantizedAabbMin[0]),
+		btScalar(node.m_quantizedAabbMax[1] - node.m_quantizedAabbMin[1]),
+		btScalar(node.m_quantizedAabbMax[2] - node.m_quantizedAabbMin[2]));
+	extent *= invQuantization;
+	return extent.x() * extent.y() + extent.y() * extent.z() + extent.z() * extent.x();
+}
+
+static SIMD_FORCE_INLINE int btWideBvhRightChild(const btQuantizedBvhNode* binaryNodes, int binaryIndex)
+{
+	int leftIndex = binaryIndex + 1;
+	return binaryNodes[leftIndex].isLeafNode() ? leftIndex + 1 : leftIndex + binaryNodes[leftIndex].getEscapeIndex();
+}
+
+///copies the bounds of the binary nodes behind the child slots of a wide node
+template <int WIDTH>
+static SIMD_FORCE_INLINE void btWideBvhRefitNode(btQuantizedWideBvhNode<WIDTH>& node, const int* binaryNodeIndices, const btQuantizedBvhNode* binaryNodes)
+{
+	for (int i = 0; i < WIDTH; i++)
+	{
+		if (binaryNodeIndices[i] < 0)
+			continue;
+		const btQuantizedBvhNode& child = binaryNodes[binaryNodeIndices[i]];
+		for (int axis = 0; axis < 3; axis++)
+		{
+			node.m_quantizedAabbMin[axis][i] = child.m_quantizedAabbMin[axis];
+			node.m_quantizedAabbMax[axis][i] = child.m_quantizedAabbMax[axis];
+		}
+	}
+}
+
+template <int WIDTH>
+struct btWideBvhRefitLoop : public btIParallelForBody
+{
+	btQuantizedWideBvhNode<WIDTH>* m_nodes;
+	const int* m_binaryNodeIndices;
+	const btQuantizedBvhNode* m_binaryNodes;
+
+	btWideBvhRefitLoop(btQuantizedWideBvhNode<WIDTH>* nodes, const int* binaryNodeIndices, const btQuantizedBvhNode* binaryNodes)
+		: m_nodes(nodes),
+		  m_binaryNodeIndices(binaryNodeIndices),
+		  m_binaryNodes(binaryNodes)
+	{
+	}
+
+	void forLoop(int iBegin, int iEnd) const
+	{
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			btWideBvhRefitNode<WIDTH>(m_nodes[i], &m_binaryNodeIndices[i * WIDTH], m_binaryNodes);
+		}
+	}
+};
+
+#ifdef BT_WIDE_BVH_USE_SSE2
+static SIMD_FORCE_INLINE __m128i btWideBvhLoad(const unsigned short (&lanes)[4])
+{
+	return _mm_loadl_epi64((const __m128i*)lanes);
+}
+
+static SIMD_FORCE_INLINE __m128i btWideBvhLoad(const unsigned short (&lanes)[8])
+{
+	return _mm_loadu_si128((const __m128i*)lanes);
+}
+#endif  //BT_WIDE_BVH_USE_SSE2
+
+btQuantizedWideBvh::btQuantizedWideBvh()
+	: m_bvhAabbMin(0, 0, 0),
+	  m_bvhAabbMax(0, 0, 0),
+	  m_bvhQuantization(0, 0, 0),
+	  m_numNodes(0)
+{
+}
+
+btQuantizedWideBvh::~btQuantizedWideBvh()
+{
+}
+
+void btQuantizedWideBvh::quantizeWithClamp(unsigned short* out, const btVector3& point2, int isMax) const
+{
+	btVector3 clampedPoint(point2);
+	clampedPoint.setMax(m_bvhAabbMin);
+	clampedPoint.setMin(m_bvhAabbMax);
+
+	//same rounding as btQuantizedBvh::quantize, so queries report the same nodes as the binary tree
+	btVector3 v = (clampedPoint - m_bvhAabbMin) * m_bvhQuantization;
+	if (isMax)
+	{
+		out[0] = (unsigned short)(((unsigned short)(v.getX() + btScalar(1.)) | 1));
+		out[1] = (unsigned short)(((unsigned short)(v.getY() + btScalar(1.)) | 1));
+		out[2] = (unsigned short)(((unsigned short)(v.getZ() + btScalar(1.)) | 1));
+	}
+	else
+	{
+		out[0] = (unsigned short)(((unsigned short)(v.getX()) & 0xfffe));
+		out[1] = (unsigned short)(((unsigned short)(v.getY()) & 0xfffe));
+		out[2] = (unsigned short)(((unsigned short)(v.getZ()) & 0xfffe));
+	}
+}
+
+btQuantizedWideBvh* btQuantizedWideBvh::create(int width)
+{
+	switch (width)
+	{
+		case 4:
+			return new btQuantizedBvh4();
+		case 8:
+			return new btQuantizedBvh8();
+		default:
+			return 0;
+	}
+}
+
+template <int WIDTH>
+btQuantizedWideBvhT<WIDTH>::btQuantizedWideBvhT()
+	: m_nodes(0),
+	  m_numBinaryNodes(0)
+{
+}
+
+template <int WIDTH>
+btQuantizedWideBvhT<WIDTH>::~btQuantizedWideBvhT()
+{
+	clear();
+}
+
+template <int WIDTH>
+void btQuantizedWideBvhT<WIDTH>::clear()
+{
+	if (m_nodes)
+	{
+		btAlignedFree(m_nodes);
+		m_nodes = 0;
+	}
+	m_numNodes = 0;
+	m_binaryNodeIndices.clear();
+	m_numBinaryNodes = 0;
+}
+
+///collapse the binary subtree below binaryIndex into a wide node: keep opening the child with the largest
+///surface area until the node is full or all children are leaves. Returns the index of the node, or -1 if the tree is too deep
+template <int WIDTH>
+int btQuantizedWideBvhT<WIDTH>::collapseNode(const btQuantizedBvhNode* binaryNodes, int binaryIndex, int depth, btAlignedObjectArray<Node>& nodes)
+{
+	if (depth > BT_WIDE_BVH_MAX_DEPTH)
+		return -1;
+
+	btVector3 invQuantization(btScalar(1.) / m_bvhQuantization.getX(), btScalar(1.) / m_bvhQuantization.getY(), btScalar(1.) / m_bvhQuantization.getZ());
+
+	int children[WIDTH];
+	int numChildren = 0;
+	if (binaryNodes[binaryIndex].isLeafNode())
+	{
+		//single triangle mesh
+		children[numChildren++] = binaryIndex;
+	}
+	else
+	{
+		children[numChildren++] = binaryIndex + 1;
+		children[numChildren++] = btWideBvhRightChild(binaryNodes, binaryIndex);
+	}
+
+	while (numChildren < WIDTH)
+	{
+		int best = -1;
+		btScalar bestArea = btScalar(-1.);
+		for (int i = 0; i < numChildren; i++)
+		{
+			const btQuantizedBvhNode& child = binaryNodes[children[i]];
+			if (!child.isLeafNode())
+			{
+				btScalar area = btWideBvhHalfArea(child, invQuantization);
+				if (area > bestArea)
+				{
+					bestArea = area;
+					best = i;
+				}
+			}
+		}
+		if (best < 0)
+			break;
+		int openIndex = children[best];
+		children[best] = openIndex + 1;
+		children[numChildren++] = btWideBvhRightChild(binaryNodes, openIndex);
+	}
+
+	int nodeIndex = nodes.size();
+	nodes.expand();
+	m_binaryNodeIndices.resize(nodes.size() * WIDTH);
+	{
+		Node& node = nodes[nodeIndex];
+		for (int i = 0; i < WIDTH; i++)
+		{
+			m_binaryNodeIndices[nodeIndex * WIDTH + i] = i < numChildren ? children[i] : -1;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				//empty slots get an inverted aabb, they are also skipped by their child index
+				node.m_quantizedAabbMin[axis][i] = i < numChildren ? binaryNodes[children[i]].m_quantizedAabbMin[axis] : 0xffff;
+				node.m_quantizedAabbMax[axis][i] = i < numChildren ? binaryNodes[children[i]].m_quantizedAabbMax[axis] : 0;
+			}
+			node.m_children[i] = BT_WIDE_BVH_EMPTY_CHILD;
+		}
+	}
+
+	for (int i = 0; i < numChildren; i++)
+	{
+		const btQuantizedBvhNode& child = binaryNodes[children[i]];
+		int childData;
+		if (child.isLeafNode())
+		{
+			childData = ~child.m_escapeIndexOrTriangleIndex;
+		}
+		else
+		{
+			childData = collapseNode(binaryNodes, children[i], depth + 1, nodes);
+			if (childData < 0)
+				return -1;
+		}
+		//the array may have grown, don't keep a reference across the recursion
+		nodes[nodeIndex].m_children[i] = childData;
+	}
+	return nodeIndex;
+}
+
+template <int WIDTH>
+bool btQuantizedWideBvhT<WIDTH>::build(btQuantizedBvh* bvh)
+{
+	clear();
+	if (!bvh->isQuantized())
+		return false;
+
+	m_bvhAabbMin = bvh->getBvhAabbMin();
+	m_bvhAabbMax = bvh->getBvhAabbMax();
+	m_bvhQuantization = bvh->getBvhQuantization();
+
+	const QuantizedNodeArray& binaryNodes = bvh->getQuantizedNodeArray();
+	if (binaryNodes.size() == 0)
+		return true;
+
+	btAlignedObjectArray<Node> nodes;
+	nodes.reserve(binaryNodes.size() / (WIDTH - 1) + 1);
+	m_binaryNodeIndices.reserve(nodes.capacity() * WIDTH);
+	if (collapseNode(&binaryNodes[0], 0, 1, nodes) < 0)
+	{
+		m_binaryNodeIndices.clear();
+		return false;
+	}
+
+	m_numNodes = nodes.size();
+	m_numBinaryNodes = binaryNodes.size();
+	m_nodes = (Node*)btAlignedAlloc(sizeof(Node) * m_numNodes, BT_WIDE_BVH_NODE_ALIGNMENT);
+	memcpy(m_nodes, &nodes[0], sizeof(Node) * m_numNodes);
+	return true;
+}
+
+template <int WIDTH>
+bool btQuantizedWideBvhT<WIDTH>::refit(btQuantizedBvh* bvh)
+{
+	const QuantizedNodeArray& binaryNodes = bvh->getQuantizedNodeArray();
+	if (!bvh->isQuantized() || binaryNodes.size() != m_numBinaryNodes)
+		return false;
+
+	//a full refit of the binary tree may change the quantization
+	m_bvhAabbMin = bvh->getBvhAabbMin();
+	m_bvhAabbMax = bvh->getBvhAabbMax();
+	m_bvhQuantization = bvh->getBvhQuantization();
+	if (!m_numNodes)
+		return true;
+
+	btWideBvhRefitLoop<WIDTH> loop(m_nodes, &m_binaryNodeIndices[0], &binaryNodes[0]);
+#if BT_THREADSAFE
+	btITaskScheduler* scheduler = btGetTaskScheduler();
+	if (m_numNodes > BT_WIDE_BVH_REFIT_GRAIN_SIZE && scheduler && scheduler->getNumThreads() > 1 && !btThreadsAreRunning())
+	{
+		btParallelFor(0, m_numNodes, BT_WIDE_BVH_REFIT_GRAIN_SIZE, loop);
+	}
+	else
+#endif
+	{
+		loop.forLoop(0, m_numNodes);
+	}
+	return true;
+}
+
+///copies the bounds of the children that cover one of the refit subtrees, and descends into them
+template <int WIDTH>
+void btQuantizedWideBvhT<WIDTH>::refitNodeSubtrees(const btQuantizedBvhNode* binaryNodes, int nodeIndex, const btBvhSubtreeInfo* subtrees, const int* subtreeIndices, int numSubtreeIndices)
+{
+	Node& node = m_nodes[nodeIndex];
+	for (int i = 0; i < WIDTH; i++)
+	{
+		const int binaryIndex = m_binaryNodeIndices[nodeIndex * WIDTH + i];
+		if (binaryIndex < 0)
+			continue;
+
+		//the binary nodes below a node are stored right after it
+		const btQuantizedBvhNode& child = binaryNodes[binaryIndex];
+		const int binaryEnd = binaryIndex + (child.isLeafNode() ? 1 : child.getEscapeIndex());
+		bool overlap = false;
+		for (int j = 0; j < numSubtreeIndices && !overlap; j++)
+		{
+			const btBvhSubtreeInfo& subtree = subtrees[subtreeIndices[j]];
+			overlap = binaryIndex < subtree.m_rootNodeIndex + subtree.m_subtreeSize && subtree.m_rootNodeIndex < binaryEnd;
+		}
+		if (!overlap)
+			continue;
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			node.m_quantizedAabbMin[axis][i] = child.m_quantizedAabbMin[axis];
+			node.m_quantizedAabbMax[axis][i] = child.m_quantizedAabbMax[axis];
+		}
+		if (node.m_children[i] >= 0)
+		{
+			refitNodeSubtrees(binaryNodes, node.m_children[i], subtrees, subtreeIndices, numSubtreeIndices);
+		}
+	}
+}
+
+template <int WIDTH>
+bool btQuantizedWideBvhT<WIDTH>::refitSubtrees(btQuantizedBvh* bvh, const btAlignedObjectArray<int>& subtreeIndices)
+{
+	const QuantizedNodeArray& binaryNodes = bvh->getQuantizedNodeArray();
+	if (!bvh->isQuantized() || binaryNodes.size() != m_numBinaryNodes)
+		return false;
+	if (!m_numNodes || !subtreeIndices.size())
+		return true;
+
+	refitNodeSubtrees(&binaryNodes[0], 0, &bvh->getSubtreeInfoArray()[0], &subtreeIndices[0], subtreeIndices.size());
+	return true;
+}
+
+///returns a bit per child whose quantized aabb overlaps the query
+template <int WIDTH>
+SIMD_FORCE_INLINE unsigned int btQuantizedWideBvhT<WIDTH>::testQuantizedAabb(const Node& node, const unsigned short* quantizedQueryAabbMin, const unsigned short* quantizedQueryAabbMax) const
+{
+#ifdef BT_WIDE_BVH_USE_SSE2
+	//saturating unsigned subtraction is zero exactly when a <= b
+	__m128i separated = _mm_setzero_si128();
+	for (int axis = 0; axis < 3; axis++)
+	{
+		__m128i queryMin = _mm_set1_epi16((short)quantizedQueryAabbMin[axis]);
+		__m128i queryMax = _mm_set1_epi16((short)quantizedQueryAabbMax[axis]);
+		separated = _mm_or_si128(separated, _mm_subs_epu16(queryMin, btWideBvhLoad(node.m_quantizedAabbMax[axis])));
+		separated = _mm_or_si128(separated, _mm_subs_epu16(btWideBvhLoad(node.m_quantizedAabbMin[axis]), queryMax));
+	}
+	__m128i overlap = _mm_cmpeq_epi16(separated, _mm_setzero_si128());
+	return (unsigned int)_mm_movemask_epi8(_mm_packs_epi16(overlap, overlap)) & ((1u << WIDTH) - 1);
+#else
+	unsigned int mask = 0;
+	for (int i = 0; i < WIDTH; i++)
+	{
+		bool overlap = true;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			overlap = overlap && quantizedQueryAabbMin[axis] <= node.m_quantizedAabbMax[axis][i] && quantizedQueryAabbMax[axis] >= node.m_quantizedAabbMin[axis][i];
+		}
+		mask |= overlap ? (1u << i) : 0u;
+	}
+	return mask;
+#endif
+}
+
+///slab test of the ray segment (parameter 0..1) against the dequantized children, grown by the box cast extents
+template <int WIDTH>
+SIMD_FORCE_INLINE unsigned int btQuantizedWideBvhT<WIDTH>::testRay(const Node& node, const btVector3& raySource, const btVector3& rayInvDirection, const btVector3& aabbMin, const btVector3& aabbMax) const
+{
+#if defined(BT_WIDE_BVH_USE_SSE2) && !defined(BT_USE_DOUBLE_PRECISION)
+	unsigned int mask = 0;
+	for (int group = 0; group < WIDTH; group += 4)
+	{
+		__m128 tNear = _mm_setzero_ps();
+		__m128 tFar = _mm_set1_ps(1.f);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			__m128i quantizedMin = btWideBvhLoad(node.m_quantizedAabbMin[axis]);
+			__m128i quantizedMax = btWideBvhLoad(node.m_quantizedAabbMax[axis]);
+			quantizedMin = group ? _mm_unpackhi_epi16(quantizedMin, _mm_setzero_si128()) : _mm_unpacklo_epi16(quantizedMin, _mm_setzero_si128());
+			quantizedMax = group ? _mm_unpackhi_epi16(quantizedMax, _mm_setzero_si128()) : _mm_unpacklo_epi16(quantizedMax, _mm_setzero_si128());
+
+			__m128 scale = _mm_set1_ps(1.f / m_bvhQuantization[axis]);
+			__m128 origin = _mm_set1_ps(raySource[axis]);
+			__m128 invDirection = _mm_set1_ps(rayInvDirection[axis]);
+			__m128 lower = _mm_add_ps(_mm_set1_ps(m_bvhAabbMin[axis] - aabbMax[axis]), _mm_mul_ps(_mm_cvtepi32_ps(quantizedMin), scale));
+			__m128 upper = _mm_add_ps(_mm_set1_ps(m_bvhAabbMin[axis] - aabbMin[axis]), _mm_mul_ps(_mm_cvtepi32_ps(quantizedMax), scale));
+			__m128 t0 = _mm_mul_ps(_mm_sub_ps(lower, origin), invDirection);
+			__m128 t1 = _mm_mul_ps(_mm_sub_ps(upper, origin), invDirection);
+			tNear = _mm_max_ps(tNear, _mm_min_ps(t0, t1));
+			tFar = _mm_min_ps(tFar, _mm_max_ps(t0, t1));
+		}
+		mask |= (unsigned int)_mm_movemask_ps(_mm_cmple_ps(tNear, tFar)) << group;
+	}
+	return mask;
+#else
+	unsigned int mask = 0;
+	for (int i = 0; i < WIDTH; i++)
+	{
+		btScalar tNear = btScalar(0.);
+		btScalar tFar = btScalar(1.);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			btScalar scale = btScalar(1.) / m_bvhQuantization[axis];
+			btScalar lower = m_bvhAabbMin[axis] - aabbMax[axis] + btScalar(node.m_quantizedAabbMin[axis][i]) * scale;
+			btScalar upper = m_bvhAabbMin[axis] - aabbMin[axis] + btScalar(node.m_quantizedAabbMax[axis][i]) * scale;
+			btScalar t0 = (lower - raySource[axis]) * rayInvDirection[axis];
+			btScalar t1 = (upper - raySource[axis]) * rayInvDirection[axis];
+			tNear = btMax(tNear, btMin(t0, t1));
+			tFar = btMin(tFar, btMax(t0, t1));
+		}
+		mask |= tNear <= tFar ? (1u << i) : 0u;
+	}
+	return mask;
+#endif
+}
+
+template <int WIDTH>
+void btQuantizedWideBvhT<WIDTH>::reportAabbOverlappingNodex(btNodeOverlapCallback* nodeCallback, const btVector3& aabbMin, const btVector3& aabbMax) const
+{
+	if (!m_numNodes)
+		return;
+
+	unsigned short int quantizedQueryAabbMin[3];
+	unsigned short int quantizedQueryAabbMax[3];
+	quantizeWithClamp(quantizedQueryAabbMin, aabbMin, 0);
+	quantizeWithClamp(quantizedQueryAabbMax, aabbMax, 1);
+
+	int stack[BT_WIDE_BVH_MAX_DEPTH * (WIDTH - 1) + 1];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize)
+	{
+		const Node& node = m_nodes[stack[--stackSize]];
+		unsigned int mask = testQuantizedAabb(node, quantizedQueryAabbMin, quantizedQueryAabbMax);
+		for (int i = 0; mask; i++, mask >>= 1)
+		{
+			if (!(mask & 1))
+				continue;
+			int child = node.m_children[i];
+			if (child >= 0)
+			{
+				stack[stackSize++] = child;
+			}
+			else if (child != BT_WIDE_BVH_EMPTY_CHILD)
+			{
+				nodeCallback->processNode(btWideBvhPartId(~child), btWideBvhTriangleIndex(~child));
+			}
+		}
+	}
+}
+
+template <int WIDTH>
+void btQuantizedWideBvhT<WIDTH>::walkTreeAgainstRay(btNodeOverlapCallback* nodeCallback, const btVector3& raySource, const btVector3& rayTarget, const btVector3& aabbMin, const btVector3& aabbMax) const
+{
+	if (!m_numNodes)
+		return;
+
+	btVector3 rayInvDirection = rayTarget - raySource;
+	///what about division by zero? --> just set rayInvDirection[i] to a large number, like btQuantizedBvh
+	for (int axis = 0; axis < 3; axis++)
+	{
+		rayInvDirection[axis] = rayInvDirection[axis] == btScalar(0.0) ? btScalar(BT_LARGE_FLOAT) : btScalar(1.0) / rayInvDirection[axis];
+	}
+
+	/* Quick pruning by quantized box */
+	btVector3 rayAabbMin = raySource;
+	btVector3 rayAabbMax = raySource;
+	rayAabbMin.setMin(rayTarget);
+	rayAabbMax.setMax(rayTarget);
+
+	/* Add box cast extents to bounding box */
+	rayAabbMin += aabbMin;
+	rayAabbMax += aabbMax;
+
+	unsigned short int quantizedQueryAabbMin[3];
+	unsigned short int quantizedQueryAabbMax[3];
+	quantizeWithClamp(quantizedQueryAabbMin, rayAabbMin, 0);
+	quantizeWithClamp(quantizedQueryAabbMax, rayAabbMax, 1);
+
+	int stack[BT_WIDE_BVH_MAX_DEPTH * (WIDTH - 1) + 1];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize)
+	{
+		const Node& node = m_nodes[stack[--stackSize]];
+		unsigned int mask = testQuantizedAabb(node, quantizedQueryAabbMin, quantizedQueryAabbMax);
+		if (!mask)
+			continue;
+		mask &= testRay(node, raySource, rayInvDirection, aabbMin, aabbMax);
+		for (int i = 0; mask; i++, mask >>= 1)
+		{
+			if (!(mask & 1))
+				continue;
+			int child = node.m_children[i];
+			if (child >= 0)
+			{
+				stack[stackSize++] = child;
+			}
+			else if (child != BT_WIDE_BVH_EMPTY_CHILD)
+			{
+				nodeCallback->processNode(btWideBvhPartId(~child), btWideBvhTriangleIndex(~child));
+			}
+		}
+	}
+}
+
+template <int WIDTH>
+void btQuantizedWideBvhT<WIDTH>::reportRayOverlappingNodex(btNodeOverlapCallback* nodeCallback, const btVector3& raySource, const btVector3& rayTarget) const
+{
+	walkTreeAgainstRay(nodeCallback, raySource, rayTarget, btVector3(0, 0, 0), btVector3(0, 0, 0));
+}
+
+template <int WIDTH>
+void btQuantizedWideBvhT<WIDTH>::reportBoxCastOverlappingNodex(btNodeOverlapCallback* nodeCallback, const btVector3& raySource, const btVector3& rayTarget, const btVector3& aabbMin, const btVector3& aabbMax) const
+{
+	walkTreeAgainstRay(nodeCallback, raySource, rayTarget, aabbMin, aabbMax);
+}
+
+template class btQuantizedWideBvhT<4>;
+template class btQuantizedWideBvhT<8>;
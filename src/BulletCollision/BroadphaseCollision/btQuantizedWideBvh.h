@@ -0,0 +1,140 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_QUANTIZED_WIDE_BVH_H
+#define BT_QUANTIZED_WIDE_BVH_H
+
+#include "btQuantizedBvh.h"
+
+///the collapsed tree is at most as deep as the binary tree it is built from. Deeper trees are rejected by build,
+///so that traversal can use a fixed size stack of BT_WIDE_BVH_MAX_DEPTH * (width - 1) + 1 entries
+#define BT_WIDE_BVH_MAX_DEPTH 128
+#define BT_WIDE_BVH_EMPTY_CHILD (-0x7fffffff - 1)
+
+///btQuantizedWideBvhNode stores the quantized aabbs of up to WIDTH children in structure-of-arrays layout,
+///so a query is tested against all children of a node at once with a few SIMD instructions.
+///A 4-wide node takes 64 bytes (one cache line), an 8-wide node takes 128 bytes.
+template <int WIDTH>
+struct btQuantizedWideBvhNode
+{
+	unsigned short int m_quantizedAabbMin[3][WIDTH];
+	unsigned short int m_quantizedAabbMax[3][WIDTH];
+	//index of the child node (>= 0), ~(partId/triangleIndex) for a leaf, encoded like btQuantizedBvhNode, or BT_WIDE_BVH_EMPTY_CHILD
+	int m_children[WIDTH];
+};
+
+///btQuantizedWideBvh is a read-only 4-ary or 8-ary layout of a quantized btQuantizedBvh, for large static triangle meshes.
+///It is built by collapsing the binary tree, so it uses the same quantization and reports the same triangles,
+///but it has about a third (4-ary) or a seventh (8-ary) of the nodes and fewer cache misses per query.
+///After a refit of the binary tree, refit or refitSubtrees copies the new bounds into the wide nodes. After a change of
+///the topology, such as btQuantizedBvh::rebuildSubtree, call build again.
+ATTRIBUTE_ALIGNED16(class)
+btQuantizedWideBvh
+{
+protected:
+	btVector3 m_bvhAabbMin;
+	btVector3 m_bvhAabbMax;
+	btVector3 m_bvhQuantization;
+
+	int m_numNodes;
+
+	void quantizeWithClamp(unsigned short* out, const btVector3& point, int isMax) const;
+
+public:
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	btQuantizedWideBvh();
+
+	virtual ~btQuantizedWideBvh();
+
+	///collapse the binary tree. Returns false and leaves the wide tree empty if bvh isn't quantized or too deep
+	virtual bool build(btQuantizedBvh * bvh) = 0;
+
+	///copy the bounds of the refit binary tree into the wide nodes, in parallel with btParallelFor when a task scheduler
+	///with several threads is set. Returns false if bvh doesn't have the nodes the wide tree was built from, then call build
+	virtual bool refit(btQuantizedBvh * bvh) = 0;
+
+	///like refit, but only for the wide nodes that cover the given subtrees of bvh, see btOptimizedBvh::refitPartial
+	virtual bool refitSubtrees(btQuantizedBvh * bvh, const btAlignedObjectArray<int>& subtreeIndices) = 0;
+
+	virtual int getWidth() const = 0;
+
+	int getNumNodes() const
+	{
+		return m_numNodes;
+	}
+
+	virtual void reportAabbOverlappingNodex(btNodeOverlapCallback * nodeCallback, const btVector3& aabbMin, const btVector3& aabbMax) const = 0;
+	virtual void reportRayOverlappingNodex(btNodeOverlapCallback * nodeCallback, const btVector3& raySource, const btVector3& rayTarget) const = 0;
+	virtual void reportBoxCastOverlappingNodex(btNodeOverlapCallback * nodeCallback, const btVector3& raySource, const btVector3& rayTarget, const btVector3& aabbMin, const btVector3& aabbMax) const = 0;
+
+	///create an empty 4-ary or 8-ary tree, release it with delete. Returns 0 for other widths
+	static btQuantizedWideBvh* create(int width);
+};
+
+template <int WIDTH>
+class btQuantizedWideBvhT : public btQuantizedWideBvh
+{
+	typedef btQuantizedWideBvhNode<WIDTH> Node;
+
+	//cache line aligned
+	Node* m_nodes;
+
+	//the binary node of each child slot, WIDTH per node and -1 for empty slots. Kept apart from the nodes for refit
+	btAlignedObjectArray<int> m_binaryNodeIndices;
+	int m_numBinaryNodes;
+
+	int collapseNode(const btQuantizedBvhNode* binaryNodes, int binaryIndex, int depth, btAlignedObjectArray<Node>& nodes);
+
+	void refitNodeSubtrees(const btQuantizedBvhNode* binaryNodes, int nodeIndex, const btBvhSubtreeInfo* subtrees, const int* subtreeIndices, int numSubtreeIndices);
+
+	unsigned int testQuantizedAabb(const Node& node, const unsigned short* quantizedQueryAabbMin, const unsigned short* quantizedQueryAabbMax) const;
+
+	unsigned int testRay(const Node& node, const btVector3& raySource, const btVector3& rayInvDirection, const btVector3& aabbMin, const btVector3& aabbMax) const;
+
+	void walkTreeAgainstRay(btNodeOverlapCallback * nodeCallback, const btVector3& raySource, const btVector3& rayTarget, const btVector3& aabbMin, const btVector3& aabbMax) const;
+
+	void clear();
+
+public:
+	btQuantizedWideBvhT();
+
+	virtual ~btQuantizedWideBvhT();
+
+	virtual bool build(btQuantizedBvh * bvh);
+
+	virtual bool refit(btQuantizedBvh * bvh);
+
+	virtual bool refitSubtrees(btQuantizedBvh * bvh, const btAlignedObjectArray<int>& subtreeIndices);
+
+	virtual int getWidth() const
+	{
+		return WIDTH;
+	}
+
+	const Node* getNodes() const
+	{
+		return m_nodes;
+	}
+
+	virtual void reportAabbOverlappingNodex(btNodeOverlapCallback * nodeCallback, const btVector3& aabbMin, const btVector3& aabbMax) const;
+	virtual void reportRayOverlappingNodex(btNodeOverlapCallback * nodeCallback, const btVector3& raySource, const btVector3& rayTarget) const;
+	virtual void reportBoxCastOverlappingNodex(btNodeOverlapCallback * nodeCallback, const btVector3& raySource, const btVector3& rayTarget, const btVector3& aabbMin, const btVector3& aabbMax) const;
+};
+
+typedef btQuantizedWideBvhT<4> btQuantizedBvh4;
+typedef btQuantizedWideBvhT<8> btQuantizedBvh8;
+
+#endif  //BT_QUANTIZED_WIDE_BVH_H
@@ -18,6 +18,9 @@ subject to the following restrictions:
 #include "BulletCollision/CollisionShapes/btBoxShape.h"
 #include "BulletCollision/CollisionDispatch/btCollisionObject.h"
 #include "btBoxBoxDetector.h"
+#include "BulletCollision/NarrowPhaseCollision/btGjkPairDetector.h"
+#include "BulletCollision/NarrowPhaseCollision/btPointCollector.h"
+#include "BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h"
 #include "BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h"
 #define USE_PERSISTENT_CONTACTS 1
 
@@ -42,6 +45,77 @@ btBoxBoxCollisionAlgorithm::~btBoxBoxCollisionAlgorithm()
 	}
 }
 
+///the corners of the facing box faces that lie over the other face, against the support plane of the other box. A single
+///closest point would make the box turn around it
+static void addSpeculativeContacts(const btBoxShape* box0, const btBoxShape* box1, const btTransform& trans0, const btTransform& trans1,
+								   const btVector3& normalOnB, const btVector3& pointOnB, btScalar distance, btManifoldResult* resultOut)
+{
+	const btBoxShape* boxes[2] = {box0, box1};
+	const btTransform* transforms[2] = {&trans0, &trans1};
+	int faceAxis[2];
+	for (int b = 0; b < 2; b++)
+	{
+		const btMatrix3x3& basis = transforms[b]->getBasis();
+		faceAxis[b] = 0;
+		btScalar faceAlignment = btScalar(0.);
+		for (int k = 0; k < 3; k++)
+		{
+			const btScalar alignment = btFabs(basis.getColumn(k).dot(normalOnB));
+			if (alignment > faceAlignment)
+			{
+				faceAxis[b] = k;
+				faceAlignment = alignment;
+			}
+		}
+	}
+
+	const btVector3 pointOnA = pointOnB + normalOnB * distance;
+	int numContacts = 0;
+	for (int b = 0; b < 2; b++)
+	{
+		const int other = 1 - b;
+		const btTransform& trans = *transforms[b];
+		const btVector3 halfExtents = boxes[b]->getHalfExtentsWithMargin();
+		const btVector3 otherHalfExtents = boxes[other]->getHalfExtentsWithMargin();
+		//box0 faces along -normal, box1 along normal
+		const btVector3 towardOther = b ? normalOnB : -normalOnB;
+		const int axis = faceAxis[b];
+		const int axis1 = (axis + 1) % 3;
+		const int axis2 = (axis + 2) % 3;
+		const int otherAxis1 = (faceAxis[other] + 1) % 3;
+		const int otherAxis2 = (faceAxis[other] + 2) % 3;
+
+		btVector3 corner;
+		corner[axis] = trans.getBasis().getColumn(axis).dot(towardOther) > btScalar(0.) ? halfExtents[axis] : -halfExtents[axis];
+		for (int i = 0; i < 4; i++)
+		{
+			corner[axis1] = (i & 1) ? halfExtents[axis1] : -halfExtents[axis1];
+			corner[axis2] = (i & 2) ? halfExtents[axis2] : -halfExtents[axis2];
+			const btVector3 vertex = trans * corner;
+			const btVector3 onOther = transforms[other]->invXform(vertex);
+			if (btFabs(onOther[otherAxis1]) > otherHalfExtents[otherAxis1] || btFabs(onOther[otherAxis2]) > otherHalfExtents[otherAxis2])
+			{
+				continue;
+			}
+			if (b)
+			{
+				resultOut->addContactPoint(normalOnB, vertex, normalOnB.dot(pointOnA - vertex));
+			}
+			else
+			{
+				const btScalar vertexDistance = normalOnB.dot(vertex - pointOnB);
+				resultOut->addContactPoint(normalOnB, vertex - normalOnB * vertexDistance, vertexDistance);
+			}
+			numContacts++;
+		}
+	}
+	if (!numContacts)
+	{
+		//edge against edge
+		resultOut->addContactPoint(normalOnB, pointOnB, distance);
+	}
+}
+
 void btBoxBoxCollisionAlgorithm::processCollision(const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut)
 {
 	if (!m_manifoldPtr)
@@ -61,6 +135,27 @@ void btBoxBoxCollisionAlgorithm::processCollision(const btCollisionObjectWrapper
 	input.m_transformA = body0Wrap->getWorldTransform();
 	input.m_transformB = body1Wrap->getWorldTransform();
 
+	if (m_manifoldPtr->getSpeculativeDistance() > btScalar(0.))
+	{
+		//the detector only reports overlapping boxes, separated boxes get speculative contacts along the GJK normal
+		btVoronoiSimplexSolver simplexSolver;
+		btGjkPairDetector gjkPairDetector(box0, box1, &simplexSolver, 0);
+		btPointCollector gjkOutput;
+		btDiscreteCollisionDetectorInterface::ClosestPointInput gjkInput = input;
+		const btScalar maximumDistance = m_manifoldPtr->getContactBreakingThreshold() + box0->getMargin() + box1->getMargin();
+		gjkInput.m_maximumDistanceSquared = maximumDistance * maximumDistance;
+		gjkPairDetector.getClosestPoints(gjkInput, gjkOutput, dispatchInfo.m_debugDraw);
+		if (gjkOutput.m_hasResult && gjkOutput.m_distance > btScalar(0.))
+		{
+			addSpeculativeContacts(box0, box1, input.m_transformA, input.m_transformB, gjkOutput.m_normalOnBInWorld, gjkOutput.m_pointInWorld, gjkOutput.m_distance, resultOut);
+			if (m_ownManifold)
+			{
+				resultOut->refreshContactPoints();
+			}
+			return;
+		}
+	}
+
 	btBoxBoxDetector detector(box0, box1);
 	detector.getClosestPoints(input, *resultOut, dispatchInfo.m_debugDraw);
 
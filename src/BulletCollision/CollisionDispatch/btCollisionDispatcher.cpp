@@ -24,13 +24,15 @@ subject to the following restrictions:
 #include "LinearMath/btPoolAllocator.h"
 #include "BulletCollision/CollisionDispatch/btCollisionConfiguration.h"
 #include "BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h"
+#include "LinearMath/btTransformUtil.h"
 
 #ifdef BT_DEBUG
 #include <stdio.h>
 #endif
 
 btCollisionDispatcher::btCollisionDispatcher(btCollisionConfiguration* collisionConfiguration) : m_dispatcherFlags(btCollisionDispatcher::CD_USE_RELATIVE_CONTACT_BREAKING_THRESHOLD),
-																								 m_collisionConfiguration(collisionConfiguration)
+																								 m_collisionConfiguration(collisionConfiguration),
+																								 m_speculativeContacts(false)
 {
 	int i;
 
@@ -213,10 +215,26 @@ public:
 	}
 };
 
+void btCollisionDispatcher::updateSpeculativeContacts(const btDispatcherInfo& dispatchInfo)
+{
+	const bool speculativeContacts = dispatchInfo.m_useContinuous && dispatchInfo.m_useSpeculativeContacts;
+	if (m_speculativeContacts && !speculativeContacts)
+	{
+		//the near callback doesn't update the manifolds anymore
+		for (int i = 0; i < m_manifoldsPtr.size(); i++)
+		{
+			m_manifoldsPtr[i]->setSpeculativeDistance(btScalar(0.));
+		}
+	}
+	m_speculativeContacts = speculativeContacts;
+}
+
 void btCollisionDispatcher::dispatchAllCollisionPairs(btOverlappingPairCache* pairCache, const btDispatcherInfo& dispatchInfo, btDispatcher* dispatcher)
 {
 	//m_blockedForChanges = true;
 
+	updateSpeculativeContacts(dispatchInfo);
+
 	btCollisionPairCallback collisionCallback(dispatchInfo, this);
 
 	{
@@ -227,6 +245,39 @@ void btCollisionDispatcher::dispatchAllCollisionPairs(btOverlappingPairCache* pa
 	//m_blockedForChanges = false;
 }
 
+///the distance the objects can close in this step: the motion from the world transform to the interpolation (predicted)
+///transform, for objects moving faster than their ccd motion threshold
+static btScalar btSpeculativeContactDistance(const btCollisionObject* colObj0, const btCollisionObject* colObj1)
+{
+	const btCollisionObject* objects[2] = {colObj0, colObj1};
+	btVector3 linearMotion[2];
+	btScalar angularMotion = btScalar(0.);
+	bool isFast = false;
+	for (int i = 0; i < 2; i++)
+	{
+		const btCollisionObject* colObj = objects[i];
+		linearMotion[i].setValue(0, 0, 0);
+		if (colObj->isStaticOrKinematicObject() || !colObj->getCcdSquareMotionThreshold())
+		{
+			continue;
+		}
+		const btVector3 motion = colObj->getInterpolationWorldTransform().getOrigin() - colObj->getWorldTransform().getOrigin();
+		if (motion.length2() <= colObj->getCcdSquareMotionThreshold())
+		{
+			continue;
+		}
+		isFast = true;
+		linearMotion[i] = motion;
+
+		btVector3 axis, center;
+		btScalar angle, radius;
+		btTransformUtil::calculateDiffAxisAngle(colObj->getWorldTransform(), colObj->getInterpolationWorldTransform(), axis, angle);
+		colObj->getCollisionShape()->getBoundingSphere(center, radius);
+		angularMotion += btFabs(angle) * (radius + center.length());
+	}
+	return isFast ? (linearMotion[0] - linearMotion[1]).length() + angularMotion : btScalar(0.);
+}
+
 //by default, Bullet will use this near callback
 void btCollisionDispatcher::defaultNearCallback(btBroadphasePair& collisionPair, btCollisionDispatcher& dispatcher, const btDispatcherInfo& dispatchInfo)
 {
@@ -246,6 +297,26 @@ void btCollisionDispatcher::defaultNearCallback(btBroadphasePair& collisionPair,
 
 		if (collisionPair.m_algorithm)
 		{
+			if (dispatchInfo.m_useContinuous && dispatchInfo.m_useSpeculativeContacts && (colObj0->getCcdSquareMotionThreshold() || colObj1->getCcdSquareMotionThreshold()))
+			{
+				//speculative contacts: report contacts up to the distance the objects can close in this step, the solver
+				//only removes the approaching velocity that would make them penetrate
+				const btScalar distance = btSpeculativeContactDistance(colObj0, colObj1);
+				btManifoldArray manifolds;
+				collisionPair.m_algorithm->getAllContactManifolds(manifolds);
+				if (!manifolds.size() && distance > btScalar(0.) && dispatchInfo.m_dispatchFunc == btDispatcherInfo::DISPATCH_DISCRETE)
+				{
+					//most algorithms create their manifold in the first query
+					btManifoldResult firstResult(&obj0Wrap, &obj1Wrap);
+					collisionPair.m_algorithm->processCollision(&obj0Wrap, &obj1Wrap, dispatchInfo, &firstResult);
+					collisionPair.m_algorithm->getAllContactManifolds(manifolds);
+				}
+				for (int i = 0; i < manifolds.size(); i++)
+				{
+					manifolds[i]->setSpeculativeDistance(distance);
+				}
+			}
+
 			btManifoldResult contactPointResult(&obj0Wrap, &obj1Wrap);
 
 			if (dispatchInfo.m_dispatchFunc == btDispatcherInfo::DISPATCH_DISCRETE)
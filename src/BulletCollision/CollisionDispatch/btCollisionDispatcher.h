@@ -58,6 +58,11 @@ protected:
 
 	btCollisionConfiguration* m_collisionConfiguration;
 
+	bool m_speculativeContacts;  //the last dispatch used speculative contacts
+
+	///clears the speculative distance of the manifolds once speculative contacts are switched off
+	void updateSpeculativeContacts(const btDispatcherInfo& dispatchInfo);
+
 public:
 	enum DispatcherFlags
 	{
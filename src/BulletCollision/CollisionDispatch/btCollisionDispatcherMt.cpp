@@ -132,6 +132,7 @@ struct CollisionDispatcherUpdater : public btIParallelForBody
 
 void btCollisionDispatcherMt::dispatchAllCollisionPairs(btOverlappingPairCache* pairCache, const btDispatcherInfo& info, btDispatcher* dispatcher)
 {
+	updateSpeculativeContacts(info);
 	const int pairCount = pairCache->getNumOverlappingPairs();
 	if (pairCount == 0)
 	{
@@ -22,9 +22,15 @@ subject to the following restrictions:
 #include "LinearMath/btAabbUtil2.h"
 #include "btManifoldResult.h"
 #include "BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h"
+#include "LinearMath/btQuickprof.h"
+#include "LinearMath/btThreads.h"
 
 btShapePairCallback gCompoundChildShapePairCallback = 0;
 
+bool btCompoundCollisionAlgorithm::s_allowNestedParallelForLoops = false;  // some task schedulers don't like nested loops
+int btCompoundCollisionAlgorithm::s_minimumChildrenForParallel = 64;
+int btCompoundCollisionAlgorithm::s_childrenPerTask = 8;
+
 btCompoundCollisionAlgorithm::btCompoundCollisionAlgorithm(const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, bool isSwapped)
 	: btActivatingCollisionAlgorithm(ci, body0Wrap, body1Wrap),
 	  m_isSwapped(isSwapped),
@@ -101,9 +107,10 @@ public:
 	btManifoldResult* m_resultOut;
 	btCollisionAlgorithm** m_childCollisionAlgorithms;
 	btPersistentManifold* m_sharedManifold;
+	btAlignedObjectArray<int>* m_parallelChildren;  //when set, the overlapping convex children are collected here instead of processed
 
-	btCompoundLeafCallback(const btCollisionObjectWrapper* compoundObjWrap, const btCollisionObjectWrapper* otherObjWrap, btDispatcher* dispatcher, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut, btCollisionAlgorithm** childCollisionAlgorithms, btPersistentManifold* sharedManifold)
-		: m_compoundColObjWrap(compoundObjWrap), m_otherObjWrap(otherObjWrap), m_dispatcher(dispatcher), m_dispatchInfo(dispatchInfo), m_resultOut(resultOut), m_childCollisionAlgorithms(childCollisionAlgorithms), m_sharedManifold(sharedManifold)
+	btCompoundLeafCallback(const btCollisionObjectWrapper* compoundObjWrap, const btCollisionObjectWrapper* otherObjWrap, btDispatcher* dispatcher, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut, btCollisionAlgorithm** childCollisionAlgorithms, btPersistentManifold* sharedManifold, btAlignedObjectArray<int>* parallelChildren = 0)
+		: m_compoundColObjWrap(compoundObjWrap), m_otherObjWrap(otherObjWrap), m_dispatcher(dispatcher), m_dispatchInfo(dispatchInfo), m_resultOut(resultOut), m_childCollisionAlgorithms(childCollisionAlgorithms), m_sharedManifold(sharedManifold), m_parallelChildren(parallelChildren)
 	{
 	}
 
@@ -139,48 +146,13 @@ public:
 
 		if (TestAabbAgainstAabb2(aabbMin0, aabbMax0, aabbMin1, aabbMax1))
 		{
-			btTransform preTransform = childTrans;
-			if (this->m_compoundColObjWrap->m_preTransform)
-			{
-				preTransform = preTransform *(*(this->m_compoundColObjWrap->m_preTransform));
-			}
-			btCollisionObjectWrapper compoundWrap(this->m_compoundColObjWrap, childShape, m_compoundColObjWrap->getCollisionObject(), newChildWorldTrans, preTransform, -1, index);
-
-			btCollisionAlgorithm* algo = 0;
-			bool allocatedAlgorithm = false;
-
-			if (m_resultOut->m_closestPointDistanceThreshold > 0)
-			{
-				algo = m_dispatcher->findAlgorithm(&compoundWrap, m_otherObjWrap, 0, BT_CLOSEST_POINT_ALGORITHMS);
-				allocatedAlgorithm = true;
-			}
-			else
+			if (m_parallelChildren && childShape->isConvex() && m_otherObjWrap->getCollisionShape()->isConvex())
 			{
-				//the contactpoint is still projected back using the original inverted worldtrans
-				if (!m_childCollisionAlgorithms[index])
-				{
-					m_childCollisionAlgorithms[index] = m_dispatcher->findAlgorithm(&compoundWrap, m_otherObjWrap, m_sharedManifold, BT_CONTACT_POINT_ALGORITHMS);
-				}
-				algo = m_childCollisionAlgorithms[index];
-			}
-
-			const btCollisionObjectWrapper* tmpWrap = 0;
-
-			///detect swapping case
-			if (m_resultOut->getBody0Internal() == m_compoundColObjWrap->getCollisionObject())
-			{
-				tmpWrap = m_resultOut->getBody0Wrap();
-				m_resultOut->setBody0Wrap(&compoundWrap);
-				m_resultOut->setShapeIdentifiersA(-1, index);
-			}
-			else
-			{
-				tmpWrap = m_resultOut->getBody1Wrap();
-				m_resultOut->setBody1Wrap(&compoundWrap);
-				m_resultOut->setShapeIdentifiersB(-1, index);
+				m_parallelChildren->push_back(index);
+				return;
 			}
 
-			algo->processCollision(&compoundWrap, m_otherObjWrap, m_dispatchInfo, m_resultOut);
+			ProcessOverlappingChild(index, m_resultOut);
 
 #if 0
 			if (m_dispatchInfo.m_debugDraw && (m_dispatchInfo.m_debugDraw->getDebugMode() & btIDebugDraw::DBG_DrawAabb))
@@ -190,20 +162,73 @@ public:
 				m_dispatchInfo.m_debugDraw->drawAabb(aabbMin1,aabbMax1,btVector3(1,1,1));
 			}
 #endif
+		}
+	}
 
-			if (m_resultOut->getBody0Internal() == m_compoundColObjWrap->getCollisionObject())
-			{
-				m_resultOut->setBody0Wrap(tmpWrap);
-			}
-			else
-			{
-				m_resultOut->setBody1Wrap(tmpWrap);
-			}
-			if (allocatedAlgorithm)
+	///collides a child that passed the AABB check, resultOut is m_resultOut or a copy of it for a parallel child
+	void ProcessOverlappingChild(int index, btManifoldResult* resultOut)
+	{
+		const btCompoundShape* compoundShape = static_cast<const btCompoundShape*>(m_compoundColObjWrap->getCollisionShape());
+		const btCollisionShape* childShape = compoundShape->getChildShape(index);
+
+		const btTransform& childTrans = compoundShape->getChildTransform(index);
+		btTransform newChildWorldTrans = m_compoundColObjWrap->getWorldTransform() * childTrans;
+
+		btTransform preTransform = childTrans;
+		if (this->m_compoundColObjWrap->m_preTransform)
+		{
+			preTransform = preTransform *(*(this->m_compoundColObjWrap->m_preTransform));
+		}
+		btCollisionObjectWrapper compoundWrap(this->m_compoundColObjWrap, childShape, m_compoundColObjWrap->getCollisionObject(), newChildWorldTrans, preTransform, -1, index);
+
+		btCollisionAlgorithm* algo = 0;
+		bool allocatedAlgorithm = false;
+
+		if (resultOut->m_closestPointDistanceThreshold > 0)
+		{
+			algo = m_dispatcher->findAlgorithm(&compoundWrap, m_otherObjWrap, 0, BT_CLOSEST_POINT_ALGORITHMS);
+			allocatedAlgorithm = true;
+		}
+		else
+		{
+			//the contactpoint is still projected back using the original inverted worldtrans
+			if (!m_childCollisionAlgorithms[index])
 			{
-				algo->~btCollisionAlgorithm();
-				m_dispatcher->freeCollisionAlgorithm(algo);
+				m_childCollisionAlgorithms[index] = m_dispatcher->findAlgorithm(&compoundWrap, m_otherObjWrap, m_sharedManifold, BT_CONTACT_POINT_ALGORITHMS);
 			}
+			algo = m_childCollisionAlgorithms[index];
+		}
+
+		const btCollisionObjectWrapper* tmpWrap = 0;
+
+		///detect swapping case
+		if (resultOut->getBody0Internal() == m_compoundColObjWrap->getCollisionObject())
+		{
+			tmpWrap = resultOut->getBody0Wrap();
+			resultOut->setBody0Wrap(&compoundWrap);
+			resultOut->setShapeIdentifiersA(-1, index);
+		}
+		else
+		{
+			tmpWrap = resultOut->getBody1Wrap();
+			resultOut->setBody1Wrap(&compoundWrap);
+			resultOut->setShapeIdentifiersB(-1, index);
+		}
+
+		algo->processCollision(&compoundWrap, m_otherObjWrap, m_dispatchInfo, resultOut);
+
+		if (resultOut->getBody0Internal() == m_compoundColObjWrap->getCollisionObject())
+		{
+			resultOut->setBody0Wrap(tmpWrap);
+		}
+		else
+		{
+			resultOut->setBody1Wrap(tmpWrap);
+		}
+		if (allocatedAlgorithm)
+		{
+			algo->~btCollisionAlgorithm();
+			m_dispatcher->freeCollisionAlgorithm(algo);
 		}
 	}
 	void Process(const btDbvtNode* leaf)
@@ -227,6 +252,54 @@ public:
 	}
 };
 
+struct btCompoundChildrenLoop : public btIParallelForBody
+{
+	btCompoundLeafCallback* m_callback;
+	const int* m_children;
+
+	btCompoundChildrenLoop(btCompoundLeafCallback* callback, const int* children)
+		: m_callback(callback),
+		  m_children(children)
+	{
+	}
+
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+	{
+		BT_PROFILE("btCompoundChildrenLoop");
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			//the child algorithm only writes to its own manifold, the result just carries the wrappers and identifiers
+			btManifoldResult childResult(*m_callback->m_resultOut);
+			m_callback->ProcessOverlappingChild(m_children[i], &childResult);
+		}
+	}
+};
+
+bool btCompoundCollisionAlgorithm::useParallelChildren(const btManifoldResult* resultOut) const
+{
+#if BT_THREADSAFE
+	btITaskScheduler* scheduler = btGetTaskScheduler();
+	return m_sharedManifold == 0 && resultOut->m_closestPointDistanceThreshold == 0 &&
+		   scheduler && scheduler->getNumThreads() > 1 &&
+		   (s_allowNestedParallelForLoops || !btThreadsAreRunning());
+#else
+	(void)resultOut;
+	return false;
+#endif
+}
+
+bool btCompoundCollisionAlgorithm::ownsContactManifold(btCollisionAlgorithm* algo)
+{
+	//convex algorithms create their manifold in the first processCollision and keep it until they are deleted
+	if (!algo)
+		return false;
+	manifoldArray.resize(0);
+	algo->getAllContactManifolds(manifoldArray);
+	bool ownsManifold = manifoldArray.size() == 1;
+	manifoldArray.resize(0);
+	return ownsManifold;
+}
+
 void btCompoundCollisionAlgorithm::processCollision(const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut)
 {
 	const btCollisionObjectWrapper* colObjWrap = m_isSwapped ? body1Wrap : body0Wrap;
@@ -251,7 +324,9 @@ void btCompoundCollisionAlgorithm::processCollision(const btCollisionObjectWrapp
 
 	const btDbvt* tree = compoundShape->getDynamicAabbTree();
 	//use a dynamic aabb tree to cull potential child-overlaps
-	btCompoundLeafCallback callback(colObjWrap, otherObjWrap, m_dispatcher, dispatchInfo, resultOut, &m_childCollisionAlgorithms[0], m_sharedManifold);
+	const bool parallel = useParallelChildren(resultOut);
+	m_parallelChildren.resize(0);
+	btCompoundLeafCallback callback(colObjWrap, otherObjWrap, m_dispatcher, dispatchInfo, resultOut, &m_childCollisionAlgorithms[0], m_sharedManifold, parallel ? &m_parallelChildren : 0);
 
 	///we need to refresh all contact manifolds
 	///note that we should actually recursively traverse all children, btCompoundShape can nested more then 1 level deep
@@ -303,6 +378,40 @@ void btCompoundCollisionAlgorithm::processCollision(const btCollisionObjectWrapp
 		}
 	}
 
+	if (m_parallelChildren.size())
+	{
+		//children that still need an algorithm or manifold are processed on this thread, in traversal order
+		int numParallelChildren = 0;
+		for (int i = 0; i < m_parallelChildren.size(); i++)
+		{
+			const int index = m_parallelChildren[i];
+			if (ownsContactManifold(m_childCollisionAlgorithms[index]))
+			{
+				m_parallelChildren[numParallelChildren++] = index;
+			}
+			else
+			{
+				callback.ProcessOverlappingChild(index, resultOut);
+			}
+		}
+		m_parallelChildren.resize(numParallelChildren);
+#if BT_THREADSAFE
+		if (numParallelChildren >= s_minimumChildrenForParallel)
+		{
+			btCompoundChildrenLoop loop(&callback, &m_parallelChildren[0]);
+			btParallelFor(0, numParallelChildren, btMax(1, s_childrenPerTask), loop);
+		}
+		else
+#endif
+		{
+			for (int i = 0; i < numParallelChildren; i++)
+			{
+				callback.ProcessOverlappingChild(m_parallelChildren[i], resultOut);
+			}
+		}
+		m_parallelChildren.resize(0);
+	}
+
 	{
 		//iterate over all children, perform an AABB check inside ProcessChildShape
 		int numChildren = m_childCollisionAlgorithms.size();
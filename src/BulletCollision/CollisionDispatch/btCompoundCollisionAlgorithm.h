@@ -35,6 +35,12 @@ typedef bool (*btShapePairCallback)(const btCollisionShape* pShape0, const btCol
 extern btShapePairCallback gCompoundChildShapePairCallback;
 
 /// btCompoundCollisionAlgorithm  supports collision between CompoundCollisionShapes and other collision shapes
+/// When a task scheduler with several threads is set, the overlapping convex children of a compound against a convex shape are
+/// processed in parallel with btParallelFor once at least s_minimumChildrenForParallel of them already have a contact manifold.
+/// Each of those child algorithms only writes to its own manifold, so the contacts don't depend on the number of threads.
+/// Child algorithms and manifolds are still created and removed on the calling thread. The parallel children get a plain copy
+/// of the btManifoldResult, so this is skipped for a shared manifold or a closest point query, and like with btCollisionDispatcherMt
+/// the contact added callback can be called from several threads.
 class btCompoundCollisionAlgorithm : public btActivatingCollisionAlgorithm
 {
 	btNodeStack stack2;
@@ -49,11 +55,21 @@ protected:
 
 	int m_compoundShapeRevision;  //to keep track of changes, so that childAlgorithm array can be updated
 
+	btAlignedObjectArray<int> m_parallelChildren;
+
 	void removeChildAlgorithms();
 
+	bool useParallelChildren(const btManifoldResult* resultOut) const;
+
+	bool ownsContactManifold(btCollisionAlgorithm* algo);
+
 	void preallocateChildAlgorithms(const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap);
 
 public:
+	static bool s_allowNestedParallelForLoops;  // whether to process children in parallel inside a parallel loop, like btCollisionDispatcherMt
+	static int s_minimumChildrenForParallel;    // fewer overlapping children are processed on the calling thread
+	static int s_childrenPerTask;               // grain size of the parallel loop
+
 	btCompoundCollisionAlgorithm(const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, bool isSwapped);
 
 	virtual ~btCompoundCollisionAlgorithm();
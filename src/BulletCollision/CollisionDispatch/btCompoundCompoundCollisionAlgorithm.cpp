@@ -23,6 +23,7 @@ subject to the following restrictions:
 #include "LinearMath/btAabbUtil2.h"
 #include "BulletCollision/CollisionDispatch/btManifoldResult.h"
 #include "BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h"
+#include "LinearMath/btThreads.h"
 
 //USE_LOCAL_STACK will avoid most (often all) dynamic memory allocations due to resizing in processCollision and MycollideTT
 #define USE_LOCAL_STACK 1
@@ -100,14 +101,17 @@ struct btCompoundCompoundLeafCallback : btDbvt::ICollide
 
 	btPersistentManifold* m_sharedManifold;
 
+	btSimplePairArray* m_parallelPairs;  //when set, the overlapping convex child pairs are collected here instead of processed
+
 	btCompoundCompoundLeafCallback(const btCollisionObjectWrapper* compound1ObjWrap,
 								   const btCollisionObjectWrapper* compound0ObjWrap,
 								   btDispatcher* dispatcher,
 								   const btDispatcherInfo& dispatchInfo,
 								   btManifoldResult* resultOut,
 								   btHashedSimplePairCache* childAlgorithmsCache,
-								   btPersistentManifold* sharedManifold)
-		: m_numOverlapPairs(0), m_compound0ColObjWrap(compound1ObjWrap), m_compound1ColObjWrap(compound0ObjWrap), m_dispatcher(dispatcher), m_dispatchInfo(dispatchInfo), m_resultOut(resultOut), m_childCollisionAlgorithmCache(childAlgorithmsCache), m_sharedManifold(sharedManifold)
+								   btPersistentManifold* sharedManifold,
+								   btSimplePairArray* parallelPairs = 0)
+		: m_numOverlapPairs(0), m_compound0ColObjWrap(compound1ObjWrap), m_compound1ColObjWrap(compound0ObjWrap), m_dispatcher(dispatcher), m_dispatchInfo(dispatchInfo), m_resultOut(resultOut), m_childCollisionAlgorithmCache(childAlgorithmsCache), m_sharedManifold(sharedManifold), m_parallelPairs(parallelPairs)
 	{
 	}
 
@@ -158,13 +162,36 @@ struct btCompoundCompoundLeafCallback : btDbvt::ICollide
 
 		if (TestAabbAgainstAabb2(aabbMin0, aabbMax0, aabbMin1, aabbMax1))
 		{
-			btCollisionObjectWrapper compoundWrap0(this->m_compound0ColObjWrap, childShape0, m_compound0ColObjWrap->getCollisionObject(), newChildWorldTrans0, -1, childIndex0);
-			btCollisionObjectWrapper compoundWrap1(this->m_compound1ColObjWrap, childShape1, m_compound1ColObjWrap->getCollisionObject(), newChildWorldTrans1, -1, childIndex1);
+			if (m_parallelPairs && childShape0->isConvex() && childShape1->isConvex())
+			{
+				m_parallelPairs->push_back(btSimplePair(childIndex0, childIndex1));
+				return;
+			}
+
+			ProcessOverlappingPair(childIndex0, childIndex1, 0, m_resultOut);
+		}
+	}
+
+	///collides a child pair that passed the AABB check, with the cached algorithm of the pair (or a new one when colAlgo is 0).
+	///resultOut is m_resultOut or a copy of it for a parallel pair
+	void ProcessOverlappingPair(int childIndex0, int childIndex1, btCollisionAlgorithm* colAlgo, btManifoldResult* resultOut)
+	{
+		const btCompoundShape* compoundShape0 = static_cast<const btCompoundShape*>(m_compound0ColObjWrap->getCollisionShape());
+		const btCompoundShape* compoundShape1 = static_cast<const btCompoundShape*>(m_compound1ColObjWrap->getCollisionShape());
+		const btCollisionShape* childShape0 = compoundShape0->getChildShape(childIndex0);
+		const btCollisionShape* childShape1 = compoundShape1->getChildShape(childIndex1);
+
+		btTransform newChildWorldTrans0 = m_compound0ColObjWrap->getWorldTransform() * compoundShape0->getChildTransform(childIndex0);
+		btTransform newChildWorldTrans1 = m_compound1ColObjWrap->getWorldTransform() * compoundShape1->getChildTransform(childIndex1);
+
+		btCollisionObjectWrapper compoundWrap0(this->m_compound0ColObjWrap, childShape0, m_compound0ColObjWrap->getCollisionObject(), newChildWorldTrans0, -1, childIndex0);
+		btCollisionObjectWrapper compoundWrap1(this->m_compound1ColObjWrap, childShape1, m_compound1ColObjWrap->getCollisionObject(), newChildWorldTrans1, -1, childIndex1);
 
+		bool removePair = false;
+		if (!colAlgo)
+		{
 			btSimplePair* pair = m_childCollisionAlgorithmCache->findPair(childIndex0, childIndex1);
-			bool removePair = false;
-			btCollisionAlgorithm* colAlgo = 0;
-			if (m_resultOut->m_closestPointDistanceThreshold > 0)
+			if (resultOut->m_closestPointDistanceThreshold > 0)
 			{
 				colAlgo = m_dispatcher->findAlgorithm(&compoundWrap0, &compoundWrap1, 0, BT_CLOSEST_POINT_ALGORITHMS);
 				removePair = true;
@@ -183,31 +210,55 @@ struct btCompoundCompoundLeafCallback : btDbvt::ICollide
 					pair->m_userPointer = colAlgo;
 				}
 			}
+		}
 
-			btAssert(colAlgo);
+		btAssert(colAlgo);
 
-			const btCollisionObjectWrapper* tmpWrap0 = 0;
-			const btCollisionObjectWrapper* tmpWrap1 = 0;
+		const btCollisionObjectWrapper* tmpWrap0 = 0;
+		const btCollisionObjectWrapper* tmpWrap1 = 0;
 
-			tmpWrap0 = m_resultOut->getBody0Wrap();
-			tmpWrap1 = m_resultOut->getBody1Wrap();
+		tmpWrap0 = resultOut->getBody0Wrap();
+		tmpWrap1 = resultOut->getBody1Wrap();
 
-			m_resultOut->setBody0Wrap(&compoundWrap0);
-			m_resultOut->setBody1Wrap(&compoundWrap1);
+		resultOut->setBody0Wrap(&compoundWrap0);
+		resultOut->setBody1Wrap(&compoundWrap1);
 
-			m_resultOut->setShapeIdentifiersA(-1, childIndex0);
-			m_resultOut->setShapeIdentifiersB(-1, childIndex1);
+		resultOut->setShapeIdentifiersA(-1, childIndex0);
+		resultOut->setShapeIdentifiersB(-1, childIndex1);
 
-			colAlgo->processCollision(&compoundWrap0, &compoundWrap1, m_dispatchInfo, m_resultOut);
+		colAlgo->processCollision(&compoundWrap0, &compoundWrap1, m_dispatchInfo, resultOut);
 
-			m_resultOut->setBody0Wrap(tmpWrap0);
-			m_resultOut->setBody1Wrap(tmpWrap1);
+		resultOut->setBody0Wrap(tmpWrap0);
+		resultOut->setBody1Wrap(tmpWrap1);
 
-			if (removePair)
-			{
-				colAlgo->~btCollisionAlgorithm();
-				m_dispatcher->freeCollisionAlgorithm(colAlgo);
-			}
+		if (removePair)
+		{
+			colAlgo->~btCollisionAlgorithm();
+			m_dispatcher->freeCollisionAlgorithm(colAlgo);
+		}
+	}
+};
+
+struct btCompoundCompoundPairsLoop : public btIParallelForBody
+{
+	btCompoundCompoundLeafCallback* m_callback;
+	const btSimplePair* m_pairs;
+
+	btCompoundCompoundPairsLoop(btCompoundCompoundLeafCallback* callback, const btSimplePair* pairs)
+		: m_callback(callback),
+		  m_pairs(pairs)
+	{
+	}
+
+	void forLoop(int iBegin, int iEnd) const
+	{
+		BT_PROFILE("btCompoundCompoundPairsLoop");
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			//the child algorithm only writes to its own manifold, the result just carries the wrappers and identifiers
+			btManifoldResult childResult(*m_callback->m_resultOut);
+			const btSimplePair& pair = m_pairs[i];
+			m_callback->ProcessOverlappingPair(pair.m_indexA, pair.m_indexB, (btCollisionAlgorithm*)pair.m_userPointer, &childResult);
 		}
 	}
 };
@@ -339,11 +390,51 @@ void btCompoundCompoundCollisionAlgorithm::processCollision(const btCollisionObj
 		}
 	}
 
-	btCompoundCompoundLeafCallback callback(col0ObjWrap, col1ObjWrap, this->m_dispatcher, dispatchInfo, resultOut, this->m_childCollisionAlgorithmCache, m_sharedManifold);
+	const bool parallel = useParallelChildren(resultOut);
+	m_parallelPairs.resizeNoInitialize(0);
+	btCompoundCompoundLeafCallback callback(col0ObjWrap, col1ObjWrap, this->m_dispatcher, dispatchInfo, resultOut, this->m_childCollisionAlgorithmCache, m_sharedManifold, parallel ? &m_parallelPairs : 0);
 
 	const btTransform xform = col0ObjWrap->getWorldTransform().inverse() * col1ObjWrap->getWorldTransform();
 	MycollideTT(tree0->m_root, tree1->m_root, xform, &callback, resultOut->m_closestPointDistanceThreshold);
 
+	if (m_parallelPairs.size())
+	{
+		//pairs that still need an algorithm or manifold are processed on this thread, in traversal order
+		int numParallelPairs = 0;
+		for (int i = 0; i < m_parallelPairs.size(); i++)
+		{
+			btSimplePair pair = m_parallelPairs[i];
+			btSimplePair* cachedPair = m_childCollisionAlgorithmCache->findPair(pair.m_indexA, pair.m_indexB);
+			btCollisionAlgorithm* algo = cachedPair ? (btCollisionAlgorithm*)cachedPair->m_userPointer : 0;
+			if (ownsContactManifold(algo))
+			{
+				pair.m_userPointer = algo;
+				m_parallelPairs[numParallelPairs++] = pair;
+			}
+			else
+			{
+				callback.ProcessOverlappingPair(pair.m_indexA, pair.m_indexB, 0, resultOut);
+			}
+		}
+		m_parallelPairs.resizeNoInitialize(numParallelPairs);
+#if BT_THREADSAFE
+		if (numParallelPairs >= s_minimumChildrenForParallel)
+		{
+			btCompoundCompoundPairsLoop loop(&callback, &m_parallelPairs[0]);
+			btParallelFor(0, numParallelPairs, btMax(1, s_childrenPerTask), loop);
+		}
+		else
+#endif
+		{
+			for (int i = 0; i < numParallelPairs; i++)
+			{
+				const btSimplePair& pair = m_parallelPairs[i];
+				callback.ProcessOverlappingPair(pair.m_indexA, pair.m_indexB, (btCollisionAlgorithm*)pair.m_userPointer, resultOut);
+			}
+		}
+		m_parallelPairs.resizeNoInitialize(0);
+	}
+
 	//printf("#compound-compound child/leaf overlap =%d                      \r",callback.m_numOverlapPairs);
 
 	//remove non-overlapping child pairs
@@ -37,10 +37,12 @@ class btCollisionShape;
 extern btShapePairCallback gCompoundCompoundChildShapePairCallback;
 
 /// btCompoundCompoundCollisionAlgorithm  supports collision between two btCompoundCollisionShape shapes
+/// The overlapping pairs of convex children are processed in parallel like the children of btCompoundCollisionAlgorithm.
 class btCompoundCompoundCollisionAlgorithm : public btCompoundCollisionAlgorithm
 {
 	class btHashedSimplePairCache* m_childCollisionAlgorithmCache;
 	btSimplePairArray m_removePairs;
+	btSimplePairArray m_parallelPairs;
 
 	int m_compoundShapeRevision0;  //to keep track of changes, so that childAlgorithm array can be updated
 	int m_compoundShapeRevision1;
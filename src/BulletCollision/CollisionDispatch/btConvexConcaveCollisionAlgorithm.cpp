@@ -27,6 +27,12 @@ subject to the following restrictions:
 #include "BulletCollision/NarrowPhaseCollision/btSubSimplexConvexCast.h"
 #include "BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h"
 #include "BulletCollision/CollisionShapes/btSdfCollisionShape.h"
+#include "LinearMath/btThreads.h"
+
+bool btConvexConcaveCollisionAlgorithm::s_allowNestedParallelForLoops = false;  // some task schedulers don't like nested loops
+int btConvexConcaveCollisionAlgorithm::s_minimumTrianglesForParallel = 64;
+int btConvexConcaveCollisionAlgorithm::s_trianglesPerTask = 16;
+btScalar btConvexConcaveCollisionAlgorithm::s_reductionNormalCosine = btScalar(0.7);
 
 btConvexConcaveCollisionAlgorithm::btConvexConcaveCollisionAlgorithm(const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, bool isSwapped)
 	: btActivatingCollisionAlgorithm(ci, body0Wrap, body1Wrap),
@@ -84,6 +90,11 @@ void btConvexTriangleCallback::processTriangle(btVector3* triangle, int partId,
 	//just for debugging purposes
 	//printf("triangle %d",m_triangleCount++);
 
+	processTriangleContacts(triangle, partId, triangleIndex, m_resultOut);
+}
+
+void btConvexTriangleCallback::processTriangleContacts(btVector3* triangle, int partId, int triangleIndex, btManifoldResult* resultOut) const
+{
 	btCollisionAlgorithmConstructionInfo ci;
 	ci.m_dispatcher1 = m_dispatcher;
 
@@ -122,7 +133,7 @@ void btConvexTriangleCallback::processTriangle(btVector3* triangle, int partId,
 			//now check if this is fully on one side of the triangle
 			btScalar proj_distPt = triangle_normal_world.dot(worldPt);
 			btScalar proj_distTr = triangle_normal_world.dot(v0);
-			btScalar contact_threshold = m_manifoldPtr->getContactBreakingThreshold()+ m_resultOut->m_closestPointDistanceThreshold;
+			btScalar contact_threshold = m_manifoldPtr->getContactBreakingThreshold()+ resultOut->m_closestPointDistanceThreshold;
 			btScalar dist = proj_distTr - proj_distPt;
 			if (dist > contact_threshold)
 				return;
@@ -148,7 +159,7 @@ void btConvexTriangleCallback::processTriangle(btVector3* triangle, int partId,
 		btCollisionObjectWrapper triObWrap(m_triBodyWrap, &tm, m_triBodyWrap->getCollisionObject(), m_triBodyWrap->getWorldTransform(), partId, triangleIndex);  //correct transform?
 		btCollisionAlgorithm* colAlgo = 0;
 
-		if (m_resultOut->m_closestPointDistanceThreshold > 0)
+		if (resultOut->m_closestPointDistanceThreshold > 0)
 		{
 			colAlgo = ci.m_dispatcher1->findAlgorithm(m_convexBodyWrap, &triObWrap, 0, BT_CLOSEST_POINT_ALGORITHMS);
 		}
@@ -158,31 +169,31 @@ void btConvexTriangleCallback::processTriangle(btVector3* triangle, int partId,
 		}
 		const btCollisionObjectWrapper* tmpWrap = 0;
 
-		if (m_resultOut->getBody0Internal() == m_triBodyWrap->getCollisionObject())
+		if (resultOut->getBody0Internal() == m_triBodyWrap->getCollisionObject())
 		{
-			tmpWrap = m_resultOut->getBody0Wrap();
-			m_resultOut->setBody0Wrap(&triObWrap);
-			m_resultOut->setShapeIdentifiersA(partId, triangleIndex);
+			tmpWrap = resultOut->getBody0Wrap();
+			resultOut->setBody0Wrap(&triObWrap);
+			resultOut->setShapeIdentifiersA(partId, triangleIndex);
 		}
 		else
 		{
-			tmpWrap = m_resultOut->getBody1Wrap();
-			m_resultOut->setBody1Wrap(&triObWrap);
-			m_resultOut->setShapeIdentifiersB(partId, triangleIndex);
+			tmpWrap = resultOut->getBody1Wrap();
+			resultOut->setBody1Wrap(&triObWrap);
+			resultOut->setShapeIdentifiersB(partId, triangleIndex);
 		}
 
 		{
 			BT_PROFILE("processCollision (GJK?)");
-			colAlgo->processCollision(m_convexBodyWrap, &triObWrap, *m_dispatchInfoPtr, m_resultOut);
+			colAlgo->processCollision(m_convexBodyWrap, &triObWrap, *m_dispatchInfoPtr, resultOut);
 		}
 
-		if (m_resultOut->getBody0Internal() == m_triBodyWrap->getCollisionObject())
+		if (resultOut->getBody0Internal() == m_triBodyWrap->getCollisionObject())
 		{
-			m_resultOut->setBody0Wrap(tmpWrap);
+			resultOut->setBody0Wrap(tmpWrap);
 		}
 		else
 		{
-			m_resultOut->setBody1Wrap(tmpWrap);
+			resultOut->setBody1Wrap(tmpWrap);
 		}
 
 		colAlgo->~btCollisionAlgorithm();
@@ -205,7 +216,8 @@ void btConvexTriangleCallback::setTimeStepAndCounters(btScalar collisionMarginTr
 	const btCollisionShape* convexShape = static_cast<const btCollisionShape*>(m_convexBodyWrap->getCollisionShape());
 	//CollisionShape* triangleShape = static_cast<btCollisionShape*>(triBody->m_collisionShape);
 	convexShape->getAabb(convexInTriangleSpace, m_aabbMin, m_aabbMax);
-	btScalar extraMargin = collisionMarginTriangle + resultOut->m_closestPointDistanceThreshold;
+	//with speculative contacts, include the triangles the convex can reach in this step
+	btScalar extraMargin = collisionMarginTriangle + m_manifoldPtr->getSpeculativeDistance() + resultOut->m_closestPointDistanceThreshold;
 
 	btVector3 extra(extraMargin, extraMargin, extraMargin);
 
@@ -213,6 +225,338 @@ void btConvexTriangleCallback::setTimeStepAndCounters(btScalar collisionMarginTr
 	m_aabbMin -= extra;
 }
 
+///collects the triangles that overlap the AABB of the convex, so they can be split between threads
+struct btConvexTriangleGatherCallback : public btTriangleCallback
+{
+	btVector3 m_aabbMin;
+	btVector3 m_aabbMax;
+	btAlignedObjectArray<btConvexConcaveTriangle>* m_triangles;
+
+	btConvexTriangleGatherCallback(const btVector3& aabbMin, const btVector3& aabbMax, btAlignedObjectArray<btConvexConcaveTriangle>* triangles)
+		: m_aabbMin(aabbMin),
+		  m_aabbMax(aabbMax),
+		  m_triangles(triangles)
+	{
+	}
+
+	virtual void processTriangle(btVector3* triangle, int partId, int triangleIndex)
+	{
+		if (TestTriangleAgainstAabb2(triangle, m_aabbMin, m_aabbMax))
+		{
+			btConvexConcaveTriangle& tri = m_triangles->expandNonInitializing();
+			tri.m_vertices[0] = triangle[0];
+			tri.m_vertices[1] = triangle[1];
+			tri.m_vertices[2] = triangle[2];
+			tri.m_partId = partId;
+			tri.m_triangleIndex = triangleIndex;
+		}
+	}
+};
+
+///buffers the contacts of a worker thread instead of adding them to the shared manifold
+class btConvexTriangleContactBuffer : public btManifoldResult
+{
+	btAlignedObjectArray<btConvexConcaveContact>* m_contacts;
+
+public:
+	int m_triangle;
+	int m_numTriangleContacts;
+
+	btConvexTriangleContactBuffer(const btManifoldResult* resultOut, btAlignedObjectArray<btConvexConcaveContact>* contacts)
+		: btManifoldResult(resultOut->getBody0Wrap(), resultOut->getBody1Wrap()),
+		  m_contacts(contacts),
+		  m_triangle(-1),
+		  m_numTriangleContacts(0)
+	{
+		m_manifoldPtr = (btPersistentManifold*)resultOut->getPersistentManifold();
+		m_closestPointDistanceThreshold = resultOut->m_closestPointDistanceThreshold;
+	}
+
+	virtual void addContactPoint(const btVector3& normalOnBInWorld, const btVector3& pointInWorld, btScalar depth)
+	{
+		if (depth > m_manifoldPtr->getContactBreakingThreshold())
+			return;
+
+		btConvexConcaveContact& contact = m_contacts->expandNonInitializing();
+		contact.m_normalOnBInWorld = normalOnBInWorld;
+		contact.m_pointInWorld = pointInWorld;
+		contact.m_depth = depth;
+		contact.m_triangle = m_triangle;
+		contact.m_order = m_numTriangleContacts++;
+	}
+};
+
+struct btConvexTrianglesLoop : public btIParallelForBody
+{
+	const btConvexTriangleCallback* m_callback;
+	const btManifoldResult* m_resultOut;
+	btConvexConcaveTriangle* m_triangles;
+	btAlignedObjectArray<btConvexConcaveContact>* m_threadContacts;
+	bool m_parallel;
+
+	btConvexTrianglesLoop(const btConvexTriangleCallback* callback, const btManifoldResult* resultOut, btConvexConcaveTriangle* triangles, btAlignedObjectArray<btConvexConcaveContact>* threadContacts, bool parallel)
+		: m_callback(callback),
+		  m_resultOut(resultOut),
+		  m_triangles(triangles),
+		  m_threadContacts(threadContacts),
+		  m_parallel(parallel)
+	{
+	}
+
+	void forLoop(int iBegin, int iEnd) const
+	{
+		BT_PROFILE("btConvexTrianglesLoop");
+		//on the calling thread, which may be a worker of btCollisionDispatcherMt, there is only the first buffer
+		btConvexTriangleContactBuffer buffer(m_resultOut, &m_threadContacts[m_parallel ? btGetCurrentThreadIndex() : 0]);
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			btConvexConcaveTriangle& tri = m_triangles[i];
+			buffer.m_triangle = i;
+			buffer.m_numTriangleContacts = 0;
+			m_callback->processTriangleContacts(tri.m_vertices, tri.m_partId, tri.m_triangleIndex, &buffer);
+		}
+	}
+};
+
+struct btConvexConcaveContactSortPredicate
+{
+	bool operator()(const btConvexConcaveContact& a, const btConvexConcaveContact& b) const
+	{
+		return a.m_triangle < b.m_triangle || (a.m_triangle == b.m_triangle && a.m_order < b.m_order);
+	}
+};
+
+struct btConvexConcaveContactDepthPredicate
+{
+	bool operator()(const btConvexConcaveContact& a, const btConvexConcaveContact& b) const
+	{
+		return a.m_depth < b.m_depth || (a.m_depth == b.m_depth && btConvexConcaveContactSortPredicate()(a, b));
+	}
+};
+
+static bool btUseParallelTriangles()
+{
+#if BT_THREADSAFE
+	btITaskScheduler* scheduler = btGetTaskScheduler();
+	return scheduler && scheduler->getNumThreads() > 1 &&
+		   (btConvexConcaveCollisionAlgorithm::s_allowNestedParallelForLoops || !btThreadsAreRunning());
+#else
+	return false;
+#endif
+}
+
+void btConvexConcaveCollisionAlgorithm::processTrianglesBuffered(const btCollisionObjectWrapper* triBodyWrap, btScalar collisionMarginTriangle, bool parallel, bool reduceContacts, btManifoldResult* resultOut)
+{
+	BT_PROFILE("btConvexConcaveCollisionAlgorithm::processTrianglesBuffered");
+
+	//indexed by btGetCurrentThreadIndex in the parallel loop
+	m_threadContacts.resize(parallel ? BT_MAX_THREAD_COUNT : 1);
+	btConvexTrianglesLoop loop(&m_btConvexTriangleCallback, resultOut, &m_triangles[0], &m_threadContacts[0], parallel);
+#if BT_THREADSAFE
+	if (parallel)
+	{
+		btParallelFor(0, m_triangles.size(), btMax(1, s_trianglesPerTask), loop);
+	}
+	else
+#endif
+	{
+		loop.forLoop(0, m_triangles.size());
+	}
+
+	//merge the buffers in triangle order, like the contacts would be added by processAllTriangles
+	btAlignedObjectArray<btConvexConcaveContact>& contacts = m_threadContacts[0];
+	for (int i = 1; i < m_threadContacts.size(); i++)
+	{
+		btAlignedObjectArray<btConvexConcaveContact>& threadContacts = m_threadContacts[i];
+		for (int j = 0; j < threadContacts.size(); j++)
+		{
+			contacts.push_back(threadContacts[j]);
+		}
+		threadContacts.resizeNoInitialize(0);
+	}
+	contacts.quickSort(btConvexConcaveContactSortPredicate());
+
+	if (reduceContacts)
+	{
+		reduceTriangleContacts(triBodyWrap, contacts);
+	}
+
+	const bool triangleIsBody0 = resultOut->getBody0Internal() == triBodyWrap->getCollisionObject();
+	const btCollisionObjectWrapper* tmpWrap = triangleIsBody0 ? resultOut->getBody0Wrap() : resultOut->getBody1Wrap();
+
+	int i = 0;
+	while (i < contacts.size())
+	{
+		const btConvexConcaveTriangle& tri = m_triangles[contacts[i].m_triangle];
+		btTriangleShape tm(tri.m_vertices[0], tri.m_vertices[1], tri.m_vertices[2]);
+		tm.setMargin(collisionMarginTriangle);
+		btCollisionObjectWrapper triObWrap(triBodyWrap, &tm, triBodyWrap->getCollisionObject(), triBodyWrap->getWorldTransform(), tri.m_partId, tri.m_triangleIndex);
+		if (triangleIsBody0)
+		{
+			resultOut->setBody0Wrap(&triObWrap);
+			resultOut->setShapeIdentifiersA(tri.m_partId, tri.m_triangleIndex);
+		}
+		else
+		{
+			resultOut->setBody1Wrap(&triObWrap);
+			resultOut->setShapeIdentifiersB(tri.m_partId, tri.m_triangleIndex);
+		}
+
+		const int triangle = contacts[i].m_triangle;
+		for (; i < contacts.size() && contacts[i].m_triangle == triangle; i++)
+		{
+			const btConvexConcaveContact& contact = contacts[i];
+			resultOut->addContactPoint(contact.m_normalOnBInWorld, contact.m_pointInWorld, contact.m_depth);
+		}
+
+		if (triangleIsBody0)
+		{
+			resultOut->setBody0Wrap(tmpWrap);
+		}
+		else
+		{
+			resultOut->setBody1Wrap(tmpWrap);
+		}
+	}
+	contacts.resizeNoInitialize(0);
+}
+
+///keeps at most MANIFOLD_CACHE_SIZE of the contacts, in triangle order.
+///The manifold points are identified by the triangle they were found on (m_partId1, m_index1, the triangle mesh is body1 of
+///the manifold). A contact on the same triangle near such a point continues it: getCacheEntry will match it and keep the
+///warmstarting impulse, so these contacts are preferred over equally good ones
+void btConvexConcaveCollisionAlgorithm::reduceTriangleContacts(const btCollisionObjectWrapper* triBodyWrap, btAlignedObjectArray<btConvexConcaveContact>& contacts)
+{
+	BT_PROFILE("btConvexConcaveCollisionAlgorithm::reduceTriangleContacts");
+
+	const int numContacts = contacts.size();
+	if (numContacts <= MANIFOLD_CACHE_SIZE)
+	{
+		return;
+	}
+
+	const btPersistentManifold* manifold = m_btConvexTriangleCallback.m_manifoldPtr;
+	const btScalar tolerance = manifold->getContactBreakingThreshold();
+	const btTransform& triTrans = triBodyWrap->getCollisionObject()->getWorldTransform();
+
+	//deepest first, ties in triangle order so the result doesn't depend on the number of threads
+	contacts.quickSort(btConvexConcaveContactDepthPredicate());
+
+	m_contactBonus.resizeNoInitialize(numContacts);
+	m_contactDistances.resizeNoInitialize(numContacts);
+	for (int i = 0; i < numContacts; i++)
+	{
+		const btConvexConcaveContact& contact = contacts[i];
+		const btConvexConcaveTriangle& tri = m_triangles[contact.m_triangle];
+		m_contactBonus[i] = btScalar(0.);
+		for (int j = 0; j < manifold->getNumContacts(); j++)
+		{
+			const btManifoldPoint& pt = manifold->getContactPoint(j);
+			if (pt.m_partId1 == tri.m_partId && pt.m_index1 == tri.m_triangleIndex &&
+				(triTrans(pt.m_localPointB) - contact.m_pointInWorld).length2() < tolerance * tolerance)
+			{
+				m_contactBonus[i] = tolerance;
+				break;
+			}
+		}
+		m_contactDistances[i] = SIMD_INFINITY;
+	}
+
+	//cluster the normals. The seed of a cluster is its deepest contact, or a persistent one that is nearly as deep
+	btVector3 clusterNormals[MANIFOLD_CACHE_SIZE];
+	int clusterSeeds[MANIFOLD_CACHE_SIZE];
+	int clusterSizes[MANIFOLD_CACHE_SIZE];
+	int numClusters = 0;
+	for (int i = 0; i < numContacts; i++)
+	{
+		const btConvexConcaveContact& contact = contacts[i];
+		int cluster = -1;
+		btScalar maxDot = -SIMD_INFINITY;
+		for (int c = 0; c < numClusters; c++)
+		{
+			btScalar dot = contact.m_normalOnBInWorld.dot(clusterNormals[c]);
+			if (dot > maxDot)
+			{
+				maxDot = dot;
+				cluster = c;
+			}
+		}
+		if ((cluster < 0 || maxDot < s_reductionNormalCosine) && numClusters < MANIFOLD_CACHE_SIZE)
+		{
+			clusterNormals[numClusters] = contact.m_normalOnBInWorld;
+			clusterSeeds[numClusters] = i;
+			clusterSizes[numClusters] = 1;
+			numClusters++;
+			continue;
+		}
+		clusterSizes[cluster]++;
+		if (m_contactBonus[i] > btScalar(0.) && m_contactBonus[clusterSeeds[cluster]] == btScalar(0.) &&
+			contact.m_depth - contacts[clusterSeeds[cluster]].m_depth < tolerance)
+		{
+			clusterSeeds[cluster] = i;
+		}
+	}
+
+	//the cluster of the deepest contact comes first, then the other clusters by size. Only the first half of the budget goes
+	//to clusters: edge contacts inside the mesh have odd normals but few contacts, and shouldn't crowd out the spread
+	for (int c = 1; c < numClusters; c++)
+	{
+		for (int d = c; d > 1 && clusterSizes[d] > clusterSizes[d - 1]; d--)
+		{
+			btSwap(clusterSizes[d], clusterSizes[d - 1]);
+			btSwap(clusterSeeds[d], clusterSeeds[d - 1]);
+		}
+	}
+	numClusters = btMin(numClusters, MANIFOLD_CACHE_SIZE / 2);
+
+	//one contact per cluster, then spread the remaining ones: each is the contact farthest from those chosen before.
+	//Contacts closer than the breaking threshold would be merged by the manifold anyway
+	btConvexConcaveContact reducedContacts[MANIFOLD_CACHE_SIZE];
+	int numReduced = 0;
+	while (numReduced < MANIFOLD_CACHE_SIZE)
+	{
+		int selected = -1;
+		if (numReduced < numClusters)
+		{
+			selected = clusterSeeds[numReduced];
+		}
+		else
+		{
+			btScalar maxScore = -SIMD_INFINITY;
+			for (int i = 0; i < numContacts; i++)
+			{
+				if (m_contactDistances[i] > tolerance && m_contactDistances[i] + m_contactBonus[i] > maxScore)
+				{
+					maxScore = m_contactDistances[i] + m_contactBonus[i];
+					selected = i;
+				}
+			}
+			if (selected < 0)
+			{
+				break;
+			}
+		}
+
+		reducedContacts[numReduced++] = contacts[selected];
+		m_contactDistances[selected] = btScalar(-1.);
+		const btVector3& selectedPoint = contacts[selected].m_pointInWorld;
+		for (int i = 0; i < numContacts; i++)
+		{
+			if (m_contactDistances[i] >= btScalar(0.))
+			{
+				m_contactDistances[i] = btMin(m_contactDistances[i], (contacts[i].m_pointInWorld - selectedPoint).length());
+			}
+		}
+	}
+
+	contacts.resizeNoInitialize(numReduced);
+	for (int i = 0; i < numReduced; i++)
+	{
+		contacts[i] = reducedContacts[i];
+	}
+	contacts.quickSort(btConvexConcaveContactSortPredicate());
+}
+
 void btConvexConcaveCollisionAlgorithm::clearCache()
 {
 	m_btConvexTriangleCallback.clearCache();
@@ -301,7 +645,30 @@ void btConvexConcaveCollisionAlgorithm::processCollision(const btCollisionObject
 
 				m_btConvexTriangleCallback.m_manifoldPtr->setBodies(convexBodyWrap->getCollisionObject(), triBodyWrap->getCollisionObject());
 
-				concaveShape->processAllTriangles(&m_btConvexTriangleCallback, m_btConvexTriangleCallback.getAabbMin(), m_btConvexTriangleCallback.getAabbMax());
+				const bool parallel = btUseParallelTriangles();
+				if (parallel || dispatchInfo.m_reduceMeshContacts)
+				{
+					m_triangles.resizeNoInitialize(0);
+					btConvexTriangleGatherCallback gatherCallback(m_btConvexTriangleCallback.getAabbMin(), m_btConvexTriangleCallback.getAabbMax(), &m_triangles);
+					concaveShape->processAllTriangles(&gatherCallback, m_btConvexTriangleCallback.getAabbMin(), m_btConvexTriangleCallback.getAabbMax());
+					const bool parallelTriangles = parallel && m_triangles.size() >= s_minimumTrianglesForParallel;
+					if (parallelTriangles || (dispatchInfo.m_reduceMeshContacts && m_triangles.size()))
+					{
+						processTrianglesBuffered(triBodyWrap, collisionMarginTriangle, parallelTriangles, dispatchInfo.m_reduceMeshContacts, resultOut);
+					}
+					else
+					{
+						for (int i = 0; i < m_triangles.size(); i++)
+						{
+							btConvexConcaveTriangle& tri = m_triangles[i];
+							m_btConvexTriangleCallback.processTriangleContacts(tri.m_vertices, tri.m_partId, tri.m_triangleIndex, resultOut);
+						}
+					}
+				}
+				else
+				{
+					concaveShape->processAllTriangles(&m_btConvexTriangleCallback, m_btConvexTriangleCallback.getAabbMin(), m_btConvexTriangleCallback.getAabbMax());
+				}
 
 				resultOut->refreshContactPoints();
 
@@ -24,6 +24,7 @@ subject to the following restrictions:
 class btDispatcher;
 #include "BulletCollision/BroadphaseCollision/btBroadphaseProxy.h"
 #include "btCollisionCreateFunc.h"
+#include "LinearMath/btAlignedObjectArray.h"
 
 ///For each triangle in the concave mesh that overlaps with the AABB of a convex (m_convexProxy), processTriangle is called.
 ATTRIBUTE_ALIGNED16(class)
@@ -60,6 +61,10 @@ public:
 
 	virtual void processTriangle(btVector3 * triangle, int partId, int triangleIndex);
 
+	///collides the convex with a triangle that overlaps its AABB and adds the contacts to resultOut.
+	///Only reads the callback state, so it can run concurrently for different triangles, each with its own resultOut
+	void processTriangleContacts(btVector3 * triangle, int partId, int triangleIndex, btManifoldResult* resultOut) const;
+
 	void clearCache();
 
 	SIMD_FORCE_INLINE const btVector3& getAabbMin() const
@@ -72,7 +77,38 @@ public:
 	}
 };
 
+///a triangle of the concave shape that overlaps the AABB of the convex, in the local space of the concave shape
+ATTRIBUTE_ALIGNED16(struct)
+btConvexConcaveTriangle
+{
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	btVector3 m_vertices[3];
+	int m_partId;
+	int m_triangleIndex;
+};
+
+///a contact between the convex and a triangle, buffered until it is reduced and merged into the manifold
+ATTRIBUTE_ALIGNED16(struct)
+btConvexConcaveContact
+{
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	btVector3 m_normalOnBInWorld;
+	btVector3 m_pointInWorld;
+	btScalar m_depth;
+	int m_triangle;  //index in the gathered triangles
+	int m_order;     //order in which the contacts of the triangle were found
+};
+
 /// btConvexConcaveCollisionAlgorithm  supports collision between convex shapes and (concave) trianges meshes.
+/// When a task scheduler with several threads is set and the convex overlaps at least s_minimumTrianglesForParallel triangles,
+/// the triangles are processed in parallel with btParallelFor. The contacts go to per-thread buffers and are merged into the
+/// manifold in triangle order, on the calling thread, so the contact added callback (btAdjustInternalEdgeContacts) still sees
+/// each triangle and the manifold doesn't depend on the number of threads.
+/// With btDispatcherInfo::m_reduceMeshContacts, the buffered contacts of all triangles are reduced to MANIFOLD_CACHE_SIZE points
+/// before the merge: the deepest contact of each cluster of similar normals, then the contacts farthest from the chosen ones.
+/// Contacts that continue a manifold point of the same triangle are preferred, so resting contact doesn't flicker between triangles.
 ATTRIBUTE_ALIGNED16(class)
 btConvexConcaveCollisionAlgorithm : public btActivatingCollisionAlgorithm
 {
@@ -80,9 +116,23 @@ btConvexConcaveCollisionAlgorithm : public btActivatingCollisionAlgorithm
 
 	bool m_isSwapped;
 
+	btAlignedObjectArray<btConvexConcaveTriangle> m_triangles;
+	btAlignedObjectArray<btAlignedObjectArray<btConvexConcaveContact> > m_threadContacts;
+
+	btAlignedObjectArray<btScalar> m_contactBonus;
+	btAlignedObjectArray<btScalar> m_contactDistances;
+
+	void processTrianglesBuffered(const btCollisionObjectWrapper* triBodyWrap, btScalar collisionMarginTriangle, bool parallel, bool reduceContacts, btManifoldResult* resultOut);
+	void reduceTriangleContacts(const btCollisionObjectWrapper* triBodyWrap, btAlignedObjectArray<btConvexConcaveContact>& contacts);
+
 public:
 	BT_DECLARE_ALIGNED_ALLOCATOR();
 
+	static bool s_allowNestedParallelForLoops;  // whether to process triangles in parallel inside a parallel loop, like btCollisionDispatcherMt
+	static int s_minimumTrianglesForParallel;   // fewer overlapping triangles are processed on the calling thread
+	static int s_trianglesPerTask;              // grain size of the parallel loop
+	static btScalar s_reductionNormalCosine;    // contacts whose normals are closer than this share a cluster in the contact reduction
+
 	btConvexConcaveCollisionAlgorithm(const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, bool isSwapped);
 
 	virtual ~btConvexConcaveCollisionAlgorithm();
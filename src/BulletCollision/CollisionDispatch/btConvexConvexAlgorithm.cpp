@@ -192,7 +192,8 @@ btConvexConvexAlgorithm::btConvexConvexAlgorithm(btPersistentManifold* mf, const
 					(static_cast<btConvexShape*>(body1->getCollisionShape()))->getAngularMotionDisc()),
 #endif
 	  m_numPerturbationIterations(numPerturbationIterations),
-	  m_minimumPointsPerturbationThreshold(minimumPointsPerturbationThreshold)
+	  m_minimumPointsPerturbationThreshold(minimumPointsPerturbationThreshold),
+	  m_cachedSeparatingAxis(btScalar(0.), btScalar(1.), btScalar(0.))
 {
 	(void)body0Wrap;
 	(void)body1Wrap;
@@ -372,6 +373,11 @@ void btConvexConvexAlgorithm ::processCollision(const btCollisionObjectWrapper*
 		//TODO: if (dispatchInfo.m_useContinuous)
 		gjkPairDetector.setMinkowskiA(min0);
 		gjkPairDetector.setMinkowskiB(min1);
+		if (dispatchInfo.m_useConvexFeatureCache)
+		{
+			gjkPairDetector.setCachedSeparatingAxis(m_cachedSeparatingAxis);
+			gjkPairDetector.setWarmStart(true);
+		}
 
 #ifdef USE_SEPDISTANCE_UTIL2
 		if (dispatchInfo.m_useConvexConservativeDistanceUtil)
@@ -492,7 +498,7 @@ void btConvexConvexAlgorithm ::processCollision(const btCollisionObjectWrapper*
 						*polyhedronA->getConvexPolyhedron(), *polyhedronB->getConvexPolyhedron(),
 						body0Wrap->getWorldTransform(),
 						body1Wrap->getWorldTransform(),
-						sepNormalWorldSpace, *resultOut);
+						sepNormalWorldSpace, *resultOut, dispatchInfo.m_useConvexFeatureCache ? &m_separatingAxisCache : 0);
 				}
 				else
 				{
@@ -504,6 +510,7 @@ void btConvexConvexAlgorithm ::processCollision(const btCollisionObjectWrapper*
 					gjkPairDetector.getClosestPoints(input, withoutMargin, dispatchInfo.m_debugDraw);
 					//gjkPairDetector.getClosestPoints(input,dummy,dispatchInfo.m_debugDraw);
 #endif  //ZERO_MARGIN
+					m_cachedSeparatingAxis = gjkPairDetector.getCachedSeparatingAxis();
 					//btScalar l2 = gjkPairDetector.getCachedSeparatingAxis().length2();
 					//if (l2>SIMD_EPSILON)
 					{
@@ -697,6 +704,7 @@ void btConvexConvexAlgorithm ::processCollision(const btCollisionObjectWrapper*
 		}
 
 		gjkPairDetector.getClosestPoints(input, *resultOut, dispatchInfo.m_debugDraw);
+		m_cachedSeparatingAxis = gjkPairDetector.getCachedSeparatingAxis();
 
 		//now perform 'm_numPerturbationIterations' collision queries with the perturbated collision objects
 
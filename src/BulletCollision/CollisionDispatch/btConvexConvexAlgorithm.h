@@ -56,6 +56,9 @@ class btConvexConvexAlgorithm : public btActivatingCollisionAlgorithm
 	int m_minimumPointsPerturbationThreshold;
 
 	///cache separating vector to speedup collision detection
+	btVector3 m_cachedSeparatingAxis;
+	///cache of the separating feature of polyhedral pairs
+	btSeparatingAxisCache m_separatingAxisCache;
 
 public:
 	btConvexConvexAlgorithm(btPersistentManifold* mf, const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, btConvexPenetrationDepthSolver* pdSolver, int numPerturbationIterations, int minimumPointsPerturbationThreshold);
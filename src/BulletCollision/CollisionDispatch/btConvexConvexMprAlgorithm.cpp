@@ -0,0 +1,204 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2014 Erwin Coumans  https://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btConvexConvexMprAlgorithm.h"
+
+#include "BulletCollision/CollisionDispatch/btCollisionObject.h"
+#include "BulletCollision/CollisionDispatch/btManifoldResult.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h"
+#include "BulletCollision/CollisionShapes/btSphereShape.h"
+
+#include "BulletCollision/NarrowPhaseCollision/btGjkConvexCast.h"
+#include "BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h"
+
+#include "BulletCollision/NarrowPhaseCollision/btGjkEpa3.h"
+#include "BulletCollision/NarrowPhaseCollision/btMprPenetration.h"
+
+///below this distance between the core shapes, the GJK normal is not reliable and the penetration of the full shapes is computed instead
+#define BT_MPR_CORE_DISTANCE_EPSILON btScalar(1e-4)
+
+btConvexShapeSupportWrap::btConvexShapeSupportWrap(const btConvexShape* convex, const btTransform& worldTrans, bool includeMargin)
+	: m_convex(convex),
+	  m_worldTrans(worldTrans),
+	  m_localCenter(0, 0, 0),
+	  m_margin(includeMargin ? convex->getMarginNonVirtual() : btScalar(0.))
+{
+	switch (convex->getShapeType())
+	{
+		case SPHERE_SHAPE_PROXYTYPE:
+		case BOX_SHAPE_PROXYTYPE:
+		case CAPSULE_SHAPE_PROXYTYPE:
+		case CYLINDER_SHAPE_PROXYTYPE:
+		case CONE_SHAPE_PROXYTYPE:
+			//centered at the origin
+			break;
+		default:
+		{
+			//the average of the support points along the axes is inside any convex shape, unlike its origin (triangles, offset hulls)
+			for (int i = 0; i < 3; i++)
+			{
+				btVector3 dir(0, 0, 0);
+				dir[i] = btScalar(1.);
+				m_localCenter += convex->localGetSupportVertexWithoutMarginNonVirtual(dir);
+				m_localCenter += convex->localGetSupportVertexWithoutMarginNonVirtual(-dir);
+			}
+			m_localCenter *= btScalar(1. / 6.);
+		}
+	}
+}
+
+btConvexConvexMprAlgorithm::CreateFunc::CreateFunc(btPenetrationMethod penetrationMethod)
+	: m_penetrationMethod(penetrationMethod)
+{
+}
+
+btConvexConvexMprAlgorithm::CreateFunc::~CreateFunc()
+{
+}
+
+btConvexConvexMprAlgorithm::btConvexConvexMprAlgorithm(btPersistentManifold* mf, const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, btPenetrationMethod penetrationMethod)
+	: btActivatingCollisionAlgorithm(ci, body0Wrap, body1Wrap),
+	  m_ownManifold(false),
+	  m_manifoldPtr(mf),
+	  m_penetrationMethod(penetrationMethod),
+	  m_cachedSeparatingAxis(btScalar(0.), btScalar(1.), btScalar(0.))
+{
+	(void)body0Wrap;
+	(void)body1Wrap;
+}
+
+btConvexConvexMprAlgorithm::~btConvexConvexMprAlgorithm()
+{
+	if (m_ownManifold)
+	{
+		if (m_manifoldPtr)
+			m_dispatcher->releaseManifold(m_manifoldPtr);
+	}
+}
+
+//
+// Convex-Convex collision algorithm
+//
+void btConvexConvexMprAlgorithm ::processCollision(const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut)
+{
+	(void)dispatchInfo;
+	if (!m_manifoldPtr)
+	{
+		//swapped?
+		m_manifoldPtr = m_dispatcher->getNewManifold(body0Wrap->getCollisionObject(), body1Wrap->getCollisionObject());
+		m_ownManifold = true;
+	}
+	resultOut->setPersistentManifold(m_manifoldPtr);
+
+	const btConvexShape* min0 = static_cast<const btConvexShape*>(body0Wrap->getCollisionShape());
+	const btConvexShape* min1 = static_cast<const btConvexShape*>(body1Wrap->getCollisionShape());
+
+	btScalar threshold = m_manifoldPtr->getContactBreakingThreshold() + resultOut->m_closestPointDistanceThreshold;
+
+	//distance between the core shapes, the margins are added afterwards
+	btConvexShapeSupportWrap coreA(min0, body0Wrap->getWorldTransform(), false);
+	btConvexShapeSupportWrap coreB(min1, body1Wrap->getWorldTransform(), false);
+	btGjkCollisionDescription gjkDesc;
+	gjkDesc.m_firstDir = m_cachedSeparatingAxis;
+	btMprDistanceInfo distInfo;
+
+	if (btComputeGjkDistance(coreA, coreB, gjkDesc, &distInfo) == 0 && distInfo.m_distance > BT_MPR_CORE_DISTANCE_EPSILON)
+	{
+		btScalar marginA = min0->getMarginNonVirtual();
+		btScalar marginB = min1->getMarginNonVirtual();
+		btScalar distance = distInfo.m_distance - marginA - marginB;
+		m_cachedSeparatingAxis = distInfo.m_normalBtoA;
+		if (distance < threshold)
+		{
+			resultOut->addContactPoint(distInfo.m_normalBtoA, distInfo.m_pointOnB + distInfo.m_normalBtoA * marginB, distance);
+		}
+	}
+	else
+	{
+		//the cores overlap: penetration of the full shapes
+		btConvexShapeSupportWrap a(min0, body0Wrap->getWorldTransform(), true);
+		btConvexShapeSupportWrap b(min1, body1Wrap->getWorldTransform(), true);
+		int res = -1;
+		if (m_penetrationMethod == EPA_PENETRATION)
+		{
+			btGjkEpaSolver3::sResults results;
+			if (btGjkEpaSolver3_Penetration(a, b, -m_cachedSeparatingAxis, results))
+			{
+				distInfo.m_distance = results.distance;
+				distInfo.m_normalBtoA = results.normal;
+				distInfo.m_pointOnB = results.witnesses[1];
+				res = 0;
+			}
+		}
+		else
+		{
+			btMprCollisionDescription mprDesc;
+			res = btComputeMprPenetration(a, b, mprDesc, &distInfo);
+		}
+
+		if (res == 0 && distInfo.m_normalBtoA.length2() > SIMD_EPSILON * SIMD_EPSILON)
+		{
+			m_cachedSeparatingAxis = distInfo.m_normalBtoA;
+			resultOut->addContactPoint(distInfo.m_normalBtoA, distInfo.m_pointOnB, distInfo.m_distance);
+		}
+	}
+
+	if (m_ownManifold)
+	{
+		resultOut->refreshContactPoints();
+	}
+}
+
+btScalar btConvexConvexMprAlgorithm::calculateTimeOfImpact(btCollisionObject* col0, btCollisionObject* col1, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut)
+{
+	(void)resultOut;
+	(void)dispatchInfo;
+	///Rather then checking ALL pairs, only calculate TOI when motion exceeds threshold, like btConvexConvexAlgorithm
+	btScalar resultFraction = btScalar(1.);
+
+	btScalar squareMot0 = (col0->getInterpolationWorldTransform().getOrigin() - col0->getWorldTransform().getOrigin()).length2();
+	btScalar squareMot1 = (col1->getInterpolationWorldTransform().getOrigin() - col1->getWorldTransform().getOrigin()).length2();
+
+	if (squareMot0 < col0->getCcdSquareMotionThreshold() &&
+		squareMot1 < col1->getCcdSquareMotionThreshold())
+		return resultFraction;
+
+	//each object is cast against the swept sphere of the other one
+	for (int i = 0; i < 2; i++)
+	{
+		btCollisionObject* convexObject = i ? col1 : col0;
+		btCollisionObject* sphereObject = i ? col0 : col1;
+		btConvexShape* convex = static_cast<btConvexShape*>(convexObject->getCollisionShape());
+		btSphereShape sphere(sphereObject->getCcdSweptSphereRadius());
+		btConvexCast::CastResult result;
+		btVoronoiSimplexSolver voronoiSimplex;
+		btGjkConvexCast ccd(convex, &sphere, &voronoiSimplex);
+		if (ccd.calcTimeOfImpact(convexObject->getWorldTransform(), convexObject->getInterpolationWorldTransform(),
+								 sphereObject->getWorldTransform(), sphereObject->getInterpolationWorldTransform(), result))
+		{
+			//store result.m_fraction in both bodies
+			if (col0->getHitFraction() > result.m_fraction)
+				col0->setHitFraction(result.m_fraction);
+
+			if (col1->getHitFraction() > result.m_fraction)
+				col1->setHitFraction(result.m_fraction);
+
+			if (resultFraction > result.m_fraction)
+				resultFraction = result.m_fraction;
+		}
+	}
+
+	return resultFraction;
+}
@@ -4,8 +4,8 @@ Copyright (c) 2003-2006 Erwin Coumans  https://bulletphysics.org
 
 This software is provided 'as-is', without any express or implied warranty.
 In no event will the authors be held liable for any damages arising from the use of this software.
-Permission is granted to anyone to use this software for any purpose, 
-including commercial applications, and to alter it and redistribute it freely, 
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
 subject to the following restrictions:
 
 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
@@ -17,32 +17,74 @@ subject to the following restrictions:
 #define BT_CONVEX_CONVEX_MPR_ALGORITHM_H
 
 #include "BulletCollision/CollisionDispatch/btActivatingCollisionAlgorithm.h"
-#include "BulletCollision/NarrowPhaseCollision/btGjkPairDetector.h"
 #include "BulletCollision/NarrowPhaseCollision/btPersistentManifold.h"
 #include "BulletCollision/BroadphaseCollision/btBroadphaseProxy.h"
-#include "BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h"
 #include "BulletCollision/CollisionDispatch/btCollisionCreateFunc.h"
 #include "BulletCollision/CollisionDispatch/btCollisionDispatcher.h"
-#include "LinearMath/btTransformUtil.h"  //for btConvexSeparatingDistanceUtil
+#include "BulletCollision/CollisionShapes/btConvexShape.h"
+
+///btConvexShapeSupportWrap adapts a btConvexShape to the btConvexTemplate interface of the header-only
+///GJK/EPA (btGjkEpa3.h) and MPR (btMprPenetration.h) routines. The support functions go through the
+///switch-based btConvexShape::localGetSupportVertex...NonVirtual methods, so the common primitives
+///(sphere, box, capsule, cylinder, cone, triangle, convex hull and point cloud) avoid the virtual calls.
+///Without margin, the wrapper describes the core shape: that is what the GJK distance query uses.
+struct btConvexShapeSupportWrap
+{
+	const btConvexShape* m_convex;
+	btTransform m_worldTrans;
+	//a point inside the shape, in local space, used by MPR to start the portal discovery
+	btVector3 m_localCenter;
+	btScalar m_margin;
 
-class btConvexPenetrationDepthSolver;
+	btConvexShapeSupportWrap(const btConvexShape* convex, const btTransform& worldTrans, bool includeMargin);
 
-///Enabling USE_SEPDISTANCE_UTIL2 requires 100% reliable distance computation. However, when using large size ratios GJK can be imprecise
-///so the distance is not conservative. In that case, enabling this USE_SEPDISTANCE_UTIL2 would result in failing/missing collisions.
-///Either improve GJK for large size ratios (testing a 100 units versus a 0.1 unit object) or only enable the util
-///for certain pairs that have a small size ratio
+	inline btScalar getMargin() const
+	{
+		return m_margin;
+	}
+	inline btVector3 getObjectCenterInWorld() const
+	{
+		return m_worldTrans(m_localCenter);
+	}
+	inline const btTransform& getWorldTransform() const
+	{
+		return m_worldTrans;
+	}
+	inline btVector3 getLocalSupportWithMargin(const btVector3& dir) const
+	{
+		if (m_margin == btScalar(0.))
+			return m_convex->localGetSupportVertexWithoutMarginNonVirtual(dir);
+		return m_convex->localGetSupportVertexNonVirtual(dir);
+	}
+	inline btVector3 getLocalSupportWithoutMargin(const btVector3& dir) const
+	{
+		return m_convex->localGetSupportVertexWithoutMarginNonVirtual(dir);
+	}
+};
 
-///The convexConvexAlgorithm collision algorithm implements time of impact, convex closest points and penetration depth calculations between two convex objects.
-///Multiple contact points are calculated by perturbing the orientation of the smallest object orthogonal to the separating normal.
-///This idea was described by Gino van den Bergen in this forum topic http://www.bulletphysics.com/Bullet/phpBB3/viewtopic.php?f=4&t=288&p=888#p888
+///btConvexConvexMprAlgorithm is an alternative to btConvexConvexAlgorithm, built on the templated GJK, EPA and MPR routines.
+///Separated shapes are handled by a GJK distance query between the core shapes (without margin). When the cores overlap,
+///the penetration of the full shapes is computed with MPR (btMprPenetration.h) or EPA (btGjkEpa3.h).
+///One contact point is added per call, the persistent manifold gathers the others over time.
+///Enable it with btDefaultCollisionConstructionInfo::m_convexConvexAlgorithm, or register the CreateFunc for selected shape pairs.
 class btConvexConvexMprAlgorithm : public btActivatingCollisionAlgorithm
 {
+public:
+	enum btPenetrationMethod
+	{
+		MPR_PENETRATION = 0,
+		EPA_PENETRATION
+	};
+
+private:
 	bool m_ownManifold;
 	btPersistentManifold* m_manifoldPtr;
+	btPenetrationMethod m_penetrationMethod;
 	///cache separating vector to speedup collision detection
+	btVector3 m_cachedSeparatingAxis;
 
 public:
-	btConvexConvexMprAlgorithm(btPersistentManifold* mf, const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap);
+	btConvexConvexMprAlgorithm(btPersistentManifold* mf, const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, btPenetrationMethod penetrationMethod = MPR_PENETRATION);
 
 	virtual ~btConvexConvexMprAlgorithm();
 
@@ -64,14 +106,16 @@ public:
 
 	struct CreateFunc : public btCollisionAlgorithmCreateFunc
 	{
-		CreateFunc();
+		btPenetrationMethod m_penetrationMethod;
+
+		CreateFunc(btPenetrationMethod penetrationMethod = MPR_PENETRATION);
 
 		virtual ~CreateFunc();
 
 		virtual btCollisionAlgorithm* CreateCollisionAlgorithm(btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap)
 		{
 			void* mem = ci.m_dispatcher1->allocateCollisionAlgorithm(sizeof(btConvexConvexMprAlgorithm));
-			return new (mem) btConvexConvexMprAlgorithm(ci.m_manifold, ci, body0Wrap, body1Wrap);
+			return new (mem) btConvexConvexMprAlgorithm(ci.m_manifold, ci, body0Wrap, body1Wrap, m_penetrationMethod);
 		}
 	};
 };
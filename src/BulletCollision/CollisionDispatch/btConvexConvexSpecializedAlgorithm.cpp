@@ -0,0 +1,238 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2014 Erwin Coumans  https://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btConvexConvexSpecializedAlgorithm.h"
+
+#include "BulletCollision/CollisionDispatch/btCollisionObject.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h"
+#include "BulletCollision/CollisionDispatch/btManifoldResult.h"
+
+#include "BulletCollision/NarrowPhaseCollision/btGjkConvexCast.h"
+#include "BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h"
+
+#include "BulletCollision/NarrowPhaseCollision/btGjkEpa3.h"
+#include "BulletCollision/NarrowPhaseCollision/btMprPenetration.h"
+
+///below this distance between the core shapes, the GJK normal is not reliable and the penetration of the full shapes is computed instead
+#define BT_SPECIALIZED_CORE_DISTANCE_EPSILON btScalar(1e-4)
+
+btConvexConvexSpecializedAlgorithmBase::btConvexConvexSpecializedAlgorithmBase(btPersistentManifold* mf, const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap)
+	: btActivatingCollisionAlgorithm(ci, body0Wrap, body1Wrap),
+	  m_ownManifold(false),
+	  m_manifoldPtr(mf),
+	  m_cachedSeparatingAxis(btScalar(0.), btScalar(1.), btScalar(0.)),
+	  m_supportVertexA(-1),
+	  m_supportVertexB(-1)
+{
+}
+
+btConvexConvexSpecializedAlgorithmBase::~btConvexConvexSpecializedAlgorithmBase()
+{
+	if (m_ownManifold)
+	{
+		if (m_manifoldPtr)
+			m_dispatcher->releaseManifold(m_manifoldPtr);
+	}
+}
+
+void btConvexConvexSpecializedAlgorithmBase::addContactPoints(const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap,
+															  const btConvexPolyhedron* polyhedronA, const btConvexPolyhedron* polyhedronB, btScalar polyhedronMarginA, btScalar polyhedronMarginB,
+															  const btVector3& normalOnB, const btVector3& pointOnB, btScalar distance, btManifoldResult* resultOut)
+{
+	btScalar threshold = m_manifoldPtr->getContactBreakingThreshold() + resultOut->m_closestPointDistanceThreshold;
+
+	if (polyhedronA && polyhedronB)
+	{
+		//like btConvexConvexAlgorithm, the contacts of polyhedra are measured without the margins that are not part of the
+		//polyhedral features (btBoxShape vertices include the margin)
+		btScalar polyhedronDistance = distance + polyhedronMarginA + polyhedronMarginB;
+		if (polyhedronDistance < threshold)
+		{
+			resultOut->addContactPoint(normalOnB, pointOnB - normalOnB * polyhedronMarginB, polyhedronDistance);
+		}
+		if (polyhedronDistance < btScalar(0.))
+		{
+			m_worldVertsB1.resize(0);
+			btPolyhedralContactClipping::clipHullAgainstHull(normalOnB, *polyhedronA, *polyhedronB,
+															 body0Wrap->getWorldTransform(), body1Wrap->getWorldTransform(),
+															 polyhedronDistance - threshold, threshold, m_worldVertsB1, m_worldVertsB2, *resultOut);
+		}
+	}
+	else if (distance < threshold)
+	{
+		resultOut->addContactPoint(normalOnB, pointOnB, distance);
+	}
+
+	if (m_ownManifold)
+	{
+		resultOut->refreshContactPoints();
+	}
+}
+
+btScalar btConvexConvexSpecializedAlgorithmBase::calculateTimeOfImpact(btCollisionObject* col0, btCollisionObject* col1, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut)
+{
+	(void)resultOut;
+	(void)dispatchInfo;
+	///Rather then checking ALL pairs, only calculate TOI when motion exceeds threshold, like btConvexConvexAlgorithm
+	btScalar resultFraction = btScalar(1.);
+
+	btScalar squareMot0 = (col0->getInterpolationWorldTransform().getOrigin() - col0->getWorldTransform().getOrigin()).length2();
+	btScalar squareMot1 = (col1->getInterpolationWorldTransform().getOrigin() - col1->getWorldTransform().getOrigin()).length2();
+
+	if (squareMot0 < col0->getCcdSquareMotionThreshold() &&
+		squareMot1 < col1->getCcdSquareMotionThreshold())
+		return resultFraction;
+
+	//each object is cast against the swept sphere of the other one
+	for (int i = 0; i < 2; i++)
+	{
+		btCollisionObject* convexObject = i ? col1 : col0;
+		btCollisionObject* sphereObject = i ? col0 : col1;
+		btConvexShape* convex = static_cast<btConvexShape*>(convexObject->getCollisionShape());
+		btSphereShape sphere(sphereObject->getCcdSweptSphereRadius());
+		btConvexCast::CastResult result;
+		btVoronoiSimplexSolver voronoiSimplex;
+		btGjkConvexCast ccd(convex, &sphere, &voronoiSimplex);
+		if (ccd.calcTimeOfImpact(convexObject->getWorldTransform(), convexObject->getInterpolationWorldTransform(),
+								 sphereObject->getWorldTransform(), sphereObject->getInterpolationWorldTransform(), result))
+		{
+			//store result.m_fraction in both bodies
+			if (col0->getHitFraction() > result.m_fraction)
+				col0->setHitFraction(result.m_fraction);
+
+			if (col1->getHitFraction() > result.m_fraction)
+				col1->setHitFraction(result.m_fraction);
+
+			if (resultFraction > result.m_fraction)
+				resultFraction = result.m_fraction;
+		}
+	}
+
+	return resultFraction;
+}
+
+template <typename btShapeA, typename btShapeB>
+void btConvexConvexSpecializedAlgorithm<btShapeA, btShapeB>::processCollision(const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut)
+{
+	(void)dispatchInfo;
+	if (!m_manifoldPtr)
+	{
+		//swapped?
+		m_manifoldPtr = m_dispatcher->getNewManifold(body0Wrap->getCollisionObject(), body1Wrap->getCollisionObject());
+		m_ownManifold = true;
+	}
+	resultOut->setPersistentManifold(m_manifoldPtr);
+
+	const btShapeA* shapeA = static_cast<const btShapeA*>(body0Wrap->getCollisionShape());
+	const btShapeB* shapeB = static_cast<const btShapeB*>(body1Wrap->getCollisionShape());
+
+	btVector3 normalOnB;
+	btVector3 pointOnB;
+	btScalar distance;
+
+	//distance between the core shapes, the margins are added afterwards
+	btConvexShapeTemplate<btShapeA> coreA(shapeA, body0Wrap->getWorldTransform(), false, m_supportVertexA);
+	btConvexShapeTemplate<btShapeB> coreB(shapeB, body1Wrap->getWorldTransform(), false, m_supportVertexB);
+	btGjkCollisionDescription gjkDesc;
+	gjkDesc.m_firstDir = m_cachedSeparatingAxis;
+	btMprDistanceInfo distInfo;
+	const btScalar marginA = btConvexShapeTraits<btShapeA>::getMargin(*shapeA);
+	const btScalar marginB = btConvexShapeTraits<btShapeB>::getMargin(*shapeB);
+
+	int gjkResult = btComputeGjkDistance(coreA, coreB, gjkDesc, &distInfo);
+	m_supportVertexA = coreA.m_supportVertex;
+	m_supportVertexB = coreB.m_supportVertex;
+	if (gjkResult == 0 && distInfo.m_distance > BT_SPECIALIZED_CORE_DISTANCE_EPSILON)
+	{
+		normalOnB = distInfo.m_normalBtoA;
+		pointOnB = distInfo.m_pointOnB + normalOnB * marginB;
+		distance = distInfo.m_distance - marginA - marginB;
+	}
+	else
+	{
+		//the cores overlap: penetration of the full shapes
+		btConvexShapeTemplate<btShapeA> a(shapeA, body0Wrap->getWorldTransform(), true, m_supportVertexA);
+		btConvexShapeTemplate<btShapeB> b(shapeB, body1Wrap->getWorldTransform(), true, m_supportVertexB);
+		btGjkEpaSolver3::sResults results;
+		if (!btGjkEpaSolver3_Penetration(a, b, -m_cachedSeparatingAxis, results) || results.normal.length2() < SIMD_EPSILON * SIMD_EPSILON)
+		{
+			if (m_ownManifold)
+			{
+				resultOut->refreshContactPoints();
+			}
+			return;
+		}
+		normalOnB = results.normal;
+		pointOnB = results.witnesses[1];
+		distance = results.distance;
+	}
+	m_cachedSeparatingAxis = normalOnB;
+
+	const btConvexPolyhedron* polyhedronA = btConvexShapeTraits<btShapeA>::getConvexPolyhedron(*shapeA);
+	const btConvexPolyhedron* polyhedronB = btConvexShapeTraits<btShapeB>::getConvexPolyhedron(*shapeB);
+	///btBoxShape is an exception: its vertices are created WITH margin so don't subtract it
+	btScalar polyhedronMarginA = shapeA->getShapeType() == BOX_SHAPE_PROXYTYPE ? btScalar(0.) : marginA;
+	btScalar polyhedronMarginB = shapeB->getShapeType() == BOX_SHAPE_PROXYTYPE ? btScalar(0.) : marginB;
+	addContactPoints(body0Wrap, body1Wrap, polyhedronA, polyhedronB, polyhedronMarginA, polyhedronMarginB, normalOnB, pointOnB, distance, resultOut);
+}
+
+template class btConvexConvexSpecializedAlgorithm<btSphereShape, btCylinderShape>;
+template class btConvexConvexSpecializedAlgorithm<btSphereShape, btConvexHullShape>;
+template class btConvexConvexSpecializedAlgorithm<btBoxShape, btCapsuleShape>;
+template class btConvexConvexSpecializedAlgorithm<btBoxShape, btCylinderShape>;
+template class btConvexConvexSpecializedAlgorithm<btBoxShape, btConvexHullShape>;
+template class btConvexConvexSpecializedAlgorithm<btCapsuleShape, btBoxShape>;
+template class btConvexConvexSpecializedAlgorithm<btCapsuleShape, btCylinderShape>;
+template class btConvexConvexSpecializedAlgorithm<btCapsuleShape, btConvexHullShape>;
+template class btConvexConvexSpecializedAlgorithm<btCylinderShape, btSphereShape>;
+template class btConvexConvexSpecializedAlgorithm<btCylinderShape, btBoxShape>;
+template class btConvexConvexSpecializedAlgorithm<btCylinderShape, btCapsuleShape>;
+template class btConvexConvexSpecializedAlgorithm<btCylinderShape, btCylinderShape>;
+template class btConvexConvexSpecializedAlgorithm<btCylinderShape, btConvexHullShape>;
+template class btConvexConvexSpecializedAlgorithm<btConvexHullShape, btSphereShape>;
+template class btConvexConvexSpecializedAlgorithm<btConvexHullShape, btBoxShape>;
+template class btConvexConvexSpecializedAlgorithm<btConvexHullShape, btCapsuleShape>;
+template class btConvexConvexSpecializedAlgorithm<btConvexHullShape, btCylinderShape>;
+template class btConvexConvexSpecializedAlgorithm<btConvexHullShape, btConvexHullShape>;
+
+template <typename btShapeA, typename btShapeB>
+static void btRegisterSpecializedAlgorithm(btCollisionDispatcher* dispatcher, int proxyTypeA, int proxyTypeB)
+{
+	static typename btConvexConvexSpecializedAlgorithm<btShapeA, btShapeB>::CreateFunc s_createFunc;
+	dispatcher->registerCollisionCreateFunc(proxyTypeA, proxyTypeB, &s_createFunc);
+	dispatcher->registerClosestPointsCreateFunc(proxyTypeA, proxyTypeB, &s_createFunc);
+}
+
+void btConvexConvexSpecializedAlgorithmBase::registerAlgorithms(btCollisionDispatcher* dispatcher)
+{
+	btRegisterSpecializedAlgorithm<btSphereShape, btCylinderShape>(dispatcher, SPHERE_SHAPE_PROXYTYPE, CYLINDER_SHAPE_PROXYTYPE);
+	btRegisterSpecializedAlgorithm<btSphereShape, btConvexHullShape>(dispatcher, SPHERE_SHAPE_PROXYTYPE, CONVEX_HULL_SHAPE_PROXYTYPE);
+	btRegisterSpecializedAlgorithm<btBoxShape, btCapsuleShape>(dispatcher, BOX_SHAPE_PROXYTYPE, CAPSULE_SHAPE_PROXYTYPE);
+	btRegisterSpecializedAlgorithm<btBoxShape, btCylinderShape>(dispatcher, BOX_SHAPE_PROXYTYPE, CYLINDER_SHAPE_PROXYTYPE);
+	btRegisterSpecializedAlgorithm<btBoxShape, btConvexHullShape>(dispatcher, BOX_SHAPE_PROXYTYPE, CONVEX_HULL_SHAPE_PROXYTYPE);
+	btRegisterSpecializedAlgorithm<btCapsuleShape, btBoxShape>(dispatcher, CAPSULE_SHAPE_PROXYTYPE, BOX_SHAPE_PROXYTYPE);
+	btRegisterSpecializedAlgorithm<btCapsuleShape, btCylinderShape>(dispatcher, CAPSULE_SHAPE_PROXYTYPE, CYLINDER_SHAPE_PROXYTYPE);
+	btRegisterSpecializedAlgorithm<btCapsuleShape, btConvexHullShape>(dispatcher, CAPSULE_SHAPE_PROXYTYPE, CONVEX_HULL_SHAPE_PROXYTYPE);
+	btRegisterSpecializedAlgorithm<btCylinderShape, btSphereShape>(dispatcher, CYLINDER_SHAPE_PROXYTYPE, SPHERE_SHAPE_PROXYTYPE);
+	btRegisterSpecializedAlgorithm<btCylinderShape, btBoxShape>(dispatcher, CYLINDER_SHAPE_PROXYTYPE, BOX_SHAPE_PROXYTYPE);
+	btRegisterSpecializedAlgorithm<btCylinderShape, btCapsuleShape>(dispatcher, CYLINDER_SHAPE_PROXYTYPE, CAPSULE_SHAPE_PROXYTYPE);
+	btRegisterSpecializedAlgorithm<btCylinderShape, btCylinderShape>(dispatcher, CYLINDER_SHAPE_PROXYTYPE, CYLINDER_SHAPE_PROXYTYPE);
+	btRegisterSpecializedAlgorithm<btCylinderShape, btConvexHullShape>(dispatcher, CYLINDER_SHAPE_PROXYTYPE, CONVEX_HULL_SHAPE_PROXYTYPE);
+	btRegisterSpecializedAlgorithm<btConvexHullShape, btSphereShape>(dispatcher, CONVEX_HULL_SHAPE_PROXYTYPE, SPHERE_SHAPE_PROXYTYPE);
+	btRegisterSpecializedAlgorithm<btConvexHullShape, btBoxShape>(dispatcher, CONVEX_HULL_SHAPE_PROXYTYPE, BOX_SHAPE_PROXYTYPE);
+	btRegisterSpecializedAlgorithm<btConvexHullShape, btCapsuleShape>(dispatcher, CONVEX_HULL_SHAPE_PROXYTYPE, CAPSULE_SHAPE_PROXYTYPE);
+	btRegisterSpecializedAlgorithm<btConvexHullShape, btCylinderShape>(dispatcher, CONVEX_HULL_SHAPE_PROXYTYPE, CYLINDER_SHAPE_PROXYTYPE);
+	btRegisterSpecializedAlgorithm<btConvexHullShape, btConvexHullShape>(dispatcher, CONVEX_HULL_SHAPE_PROXYTYPE, CONVEX_HULL_SHAPE_PROXYTYPE);
+}
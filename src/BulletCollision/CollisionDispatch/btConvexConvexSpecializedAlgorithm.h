@@ -0,0 +1,277 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2014 Erwin Coumans  https://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_CONVEX_CONVEX_SPECIALIZED_ALGORITHM_H
+#define BT_CONVEX_CONVEX_SPECIALIZED_ALGORITHM_H
+
+#include "BulletCollision/CollisionDispatch/btActivatingCollisionAlgorithm.h"
+#include "BulletCollision/CollisionDispatch/btCollisionCreateFunc.h"
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcher.h"
+#include "BulletCollision/NarrowPhaseCollision/btPersistentManifold.h"
+#include "BulletCollision/NarrowPhaseCollision/btPolyhedralContactClipping.h"
+#include "BulletCollision/CollisionShapes/btBoxShape.h"
+#include "BulletCollision/CollisionShapes/btCapsuleShape.h"
+#include "BulletCollision/CollisionShapes/btConvexHullShape.h"
+#include "BulletCollision/CollisionShapes/btCylinderShape.h"
+#include "BulletCollision/CollisionShapes/btSphereShape.h"
+
+///btConvexShapeTraits gives the support mapping of a concrete convex shape type, without virtual calls
+///and without the switch on the shape type of btConvexShape::localGetSupportVertexWithoutMarginNonVirtual.
+///getConvexPolyhedron returns the polyhedral features used for contact clipping, or 0 for the curved shapes.
+///supportVertex is a per pair hint of the shapes with a hill climbing support mapping, the others ignore it.
+template <typename btShape>
+struct btConvexShapeTraits;
+
+template <>
+struct btConvexShapeTraits<btSphereShape>
+{
+	static SIMD_FORCE_INLINE btVector3 localGetSupportVertexWithoutMargin(const btSphereShape&, const btVector3&, int&)
+	{
+		return btVector3(0, 0, 0);
+	}
+	static SIMD_FORCE_INLINE btScalar getMargin(const btSphereShape& shape)
+	{
+		return shape.getRadius();
+	}
+	static SIMD_FORCE_INLINE const btConvexPolyhedron* getConvexPolyhedron(const btSphereShape&)
+	{
+		return 0;
+	}
+};
+
+template <>
+struct btConvexShapeTraits<btBoxShape>
+{
+	static SIMD_FORCE_INLINE btVector3 localGetSupportVertexWithoutMargin(const btBoxShape& shape, const btVector3& dir, int&)
+	{
+		const btVector3& halfExtents = shape.getImplicitShapeDimensions();
+		return btVector3(btFsels(dir.x(), halfExtents.x(), -halfExtents.x()),
+						 btFsels(dir.y(), halfExtents.y(), -halfExtents.y()),
+						 btFsels(dir.z(), halfExtents.z(), -halfExtents.z()));
+	}
+	static SIMD_FORCE_INLINE btScalar getMargin(const btBoxShape& shape)
+	{
+		return shape.getMarginNV();
+	}
+	static SIMD_FORCE_INLINE const btConvexPolyhedron* getConvexPolyhedron(const btBoxShape& shape)
+	{
+		return shape.getConvexPolyhedron();
+	}
+};
+
+template <>
+struct btConvexShapeTraits<btCapsuleShape>
+{
+	static SIMD_FORCE_INLINE btVector3 localGetSupportVertexWithoutMargin(const btCapsuleShape& shape, const btVector3& dir, int&)
+	{
+		//the end of the segment along dir, the radius is the margin
+		btVector3 supVec(0, 0, 0);
+		const int upAxis = shape.getUpAxis();
+		supVec[upAxis] = dir[upAxis] < btScalar(0.) ? -shape.getHalfHeight() : shape.getHalfHeight();
+		return supVec;
+	}
+	static SIMD_FORCE_INLINE btScalar getMargin(const btCapsuleShape& shape)
+	{
+		return shape.getMarginNV();
+	}
+	static SIMD_FORCE_INLINE const btConvexPolyhedron* getConvexPolyhedron(const btCapsuleShape&)
+	{
+		return 0;
+	}
+};
+
+template <>
+struct btConvexShapeTraits<btCylinderShape>
+{
+	static SIMD_FORCE_INLINE btVector3 localGetSupportVertexWithoutMargin(const btCylinderShape& shape, const btVector3& dir, int&)
+	{
+		//the radial axes of btCylinderShapeX, btCylinderShape and btCylinderShapeZ
+		const int upAxis = shape.getUpAxis();
+		const int radialAxis0 = upAxis == 0 ? 1 : 0;
+		const int radialAxis1 = upAxis == 2 ? 1 : 2;
+		const btVector3& halfExtents = shape.getImplicitShapeDimensions();
+		const btScalar radius = halfExtents[radialAxis0];
+
+		btVector3 supVec;
+		supVec[upAxis] = dir[upAxis] < btScalar(0.) ? -halfExtents[upAxis] : halfExtents[upAxis];
+		btScalar s = btSqrt(dir[radialAxis0] * dir[radialAxis0] + dir[radialAxis1] * dir[radialAxis1]);
+		if (s != btScalar(0.))
+		{
+			btScalar d = radius / s;
+			supVec[radialAxis0] = dir[radialAxis0] * d;
+			supVec[radialAxis1] = dir[radialAxis1] * d;
+		}
+		else
+		{
+			supVec[radialAxis0] = radius;
+			supVec[radialAxis1] = btScalar(0.);
+		}
+		return supVec;
+	}
+	static SIMD_FORCE_INLINE btScalar getMargin(const btCylinderShape& shape)
+	{
+		return shape.getMarginNV();
+	}
+	static SIMD_FORCE_INLINE const btConvexPolyhedron* getConvexPolyhedron(const btCylinderShape&)
+	{
+		return 0;
+	}
+};
+
+template <>
+struct btConvexShapeTraits<btConvexHullShape>
+{
+	static SIMD_FORCE_INLINE btVector3 localGetSupportVertexWithoutMargin(const btConvexHullShape& shape, const btVector3& dir, int& supportVertex)
+	{
+		if (shape.hasSupportAdjacency())
+		{
+			return shape.localGetSupportVertexHillClimbing(dir, supportVertex);
+		}
+		const btVector3& scaling = shape.getLocalScalingNV();
+		btScalar maxDot;
+		long ptIndex = (dir * scaling).maxDot(shape.getUnscaledPoints(), shape.getNumPoints(), maxDot);
+		btAssert(ptIndex >= 0);
+		if (ptIndex < 0)
+		{
+			ptIndex = 0;
+		}
+		return shape.getUnscaledPoints()[ptIndex] * scaling;
+	}
+	static SIMD_FORCE_INLINE btScalar getMargin(const btConvexHullShape& shape)
+	{
+		return shape.getMarginNV();
+	}
+	static SIMD_FORCE_INLINE const btConvexPolyhedron* getConvexPolyhedron(const btConvexHullShape& shape)
+	{
+		return shape.getConvexPolyhedron();
+	}
+};
+
+///btConvexShapeTemplate adapts a concrete convex shape to the btConvexTemplate interface of the header-only GJK/EPA (btGjkEpa3.h).
+///Without margin, it describes the core shape. m_supportVertex is the last support vertex of a hill climbing support mapping.
+template <typename btShape>
+struct btConvexShapeTemplate
+{
+	const btShape* m_shape;
+	btTransform m_worldTrans;
+	btScalar m_margin;
+	mutable int m_supportVertex;
+
+	btConvexShapeTemplate(const btShape* shape, const btTransform& worldTrans, bool includeMargin, int supportVertex = -1)
+		: m_shape(shape),
+		  m_worldTrans(worldTrans),
+		  m_margin(includeMargin ? btConvexShapeTraits<btShape>::getMargin(*shape) : btScalar(0.)),
+		  m_supportVertex(supportVertex)
+	{
+	}
+
+	SIMD_FORCE_INLINE btScalar getMargin() const
+	{
+		return m_margin;
+	}
+	SIMD_FORCE_INLINE const btTransform& getWorldTransform() const
+	{
+		return m_worldTrans;
+	}
+	SIMD_FORCE_INLINE btVector3 getLocalSupportWithoutMargin(const btVector3& dir) const
+	{
+		return btConvexShapeTraits<btShape>::localGetSupportVertexWithoutMargin(*m_shape, dir, m_supportVertex);
+	}
+	SIMD_FORCE_INLINE btVector3 getLocalSupportWithMargin(const btVector3& dir) const
+	{
+		if (m_margin == btScalar(0.))
+			return getLocalSupportWithoutMargin(dir);
+		btVector3 dirNorm = dir;
+		if (dirNorm.length2() < (SIMD_EPSILON * SIMD_EPSILON))
+		{
+			dirNorm.setValue(btScalar(-1.), btScalar(-1.), btScalar(-1.));
+		}
+		dirNorm.normalize();
+		return getLocalSupportWithoutMargin(dirNorm) + m_margin * dirNorm;
+	}
+};
+
+///btConvexConvexSpecializedAlgorithmBase holds the parts of btConvexConvexSpecializedAlgorithm that don't depend on the shape types
+class btConvexConvexSpecializedAlgorithmBase : public btActivatingCollisionAlgorithm
+{
+protected:
+	btVertexArray m_worldVertsB1;
+	btVertexArray m_worldVertsB2;
+
+	bool m_ownManifold;
+	btPersistentManifold* m_manifoldPtr;
+	///cache separating vector to speedup collision detection
+	btVector3 m_cachedSeparatingAxis;
+	///support vertices of the last query, warm start for hill climbing hulls
+	int m_supportVertexA;
+	int m_supportVertexB;
+
+	///add the closest points of the pair, or clip the polyhedra against each other if they penetrate
+	void addContactPoints(const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap,
+						  const btConvexPolyhedron* polyhedronA, const btConvexPolyhedron* polyhedronB, btScalar polyhedronMarginA, btScalar polyhedronMarginB,
+						  const btVector3& normalOnB, const btVector3& pointOnB, btScalar distance, btManifoldResult* resultOut);
+
+public:
+	btConvexConvexSpecializedAlgorithmBase(btPersistentManifold* mf, const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap);
+
+	virtual ~btConvexConvexSpecializedAlgorithmBase();
+
+	virtual btScalar calculateTimeOfImpact(btCollisionObject* body0, btCollisionObject* body1, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut);
+
+	virtual void getAllContactManifolds(btManifoldArray& manifoldArray)
+	{
+		///should we use m_ownManifold to avoid adding duplicates?
+		if (m_manifoldPtr && m_ownManifold)
+			manifoldArray.push_back(m_manifoldPtr);
+	}
+
+	const btPersistentManifold* getManifold()
+	{
+		return m_manifoldPtr;
+	}
+
+	///register the specialized algorithms for the pairs of spheres, boxes, capsules, cylinders and convex hulls,
+	///for contact points and closest points. Sphere-sphere, sphere-box, box-box, sphere-capsule and capsule-capsule keep
+	///their closed form algorithms. The create functions are static, they stay valid for the lifetime of the program
+	static void registerAlgorithms(btCollisionDispatcher* dispatcher);
+};
+
+///btConvexConvexSpecializedAlgorithm instantiates the GJK distance, the EPA penetration depth (btGjkEpa3.h) and the
+///polyhedral contact clipping for one pair of concrete shape types, so the support mappings are inlined into the solvers.
+///It is instantiated for btSphereShape, btBoxShape, btCapsuleShape, btCylinderShape and btConvexHullShape in btConvexConvexSpecializedAlgorithm.cpp,
+///see btConvexConvexSpecializedAlgorithmBase::registerAlgorithms. Pairs of boxes and convex hulls with initialized polyhedral
+///features get a full contact manifold from clipping, like btConvexConvexAlgorithm, other pairs add one contact point per call.
+template <typename btShapeA, typename btShapeB>
+class btConvexConvexSpecializedAlgorithm : public btConvexConvexSpecializedAlgorithmBase
+{
+public:
+	btConvexConvexSpecializedAlgorithm(btPersistentManifold* mf, const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap)
+		: btConvexConvexSpecializedAlgorithmBase(mf, ci, body0Wrap, body1Wrap)
+	{
+	}
+
+	virtual void processCollision(const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut);
+
+	struct CreateFunc : public btCollisionAlgorithmCreateFunc
+	{
+		virtual btCollisionAlgorithm* CreateCollisionAlgorithm(btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap)
+		{
+			void* mem = ci.m_dispatcher1->allocateCollisionAlgorithm(sizeof(btConvexConvexSpecializedAlgorithm));
+			return new (mem) btConvexConvexSpecializedAlgorithm(ci.m_manifold, ci, body0Wrap, body1Wrap);
+		}
+	};
+};
+
+#endif  //BT_CONVEX_CONVEX_SPECIALIZED_ALGORITHM_H
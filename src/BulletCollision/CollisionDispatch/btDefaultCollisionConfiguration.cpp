@@ -16,6 +16,7 @@ subject to the following restrictions:
 #include "btDefaultCollisionConfiguration.h"
 
 #include "BulletCollision/CollisionDispatch/btConvexConvexAlgorithm.h"
+#include "BulletCollision/CollisionDispatch/btConvexConvexMprAlgorithm.h"
 #include "BulletCollision/CollisionDispatch/btEmptyCollisionAlgorithm.h"
 #include "BulletCollision/CollisionDispatch/btConvexConcaveCollisionAlgorithm.h"
 #include "BulletCollision/CollisionDispatch/btCompoundCollisionAlgorithm.h"
@@ -28,6 +29,7 @@ subject to the following restrictions:
 #include "BulletCollision/CollisionDispatch/btSphereBoxCollisionAlgorithm.h"
 #endif  //USE_BUGGY_SPHERE_BOX_ALGORITHM
 #include "BulletCollision/CollisionDispatch/btSphereTriangleCollisionAlgorithm.h"
+#include "BulletCollision/CollisionDispatch/btHeightfieldPrimitiveCollisionAlgorithm.h"
 #include "BulletCollision/NarrowPhaseCollision/btGjkEpaPenetrationDepthSolver.h"
 #include "BulletCollision/NarrowPhaseCollision/btMinkowskiPenetrationDepthSolver.h"
 #include "BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h"
@@ -50,8 +52,17 @@ btDefaultCollisionConfiguration::btDefaultCollisionConfiguration(const btDefault
 	}
 
 	//default CreationFunctions, filling the m_doubleDispatch table
-	mem = btAlignedAlloc(sizeof(btConvexConvexAlgorithm::CreateFunc), 16);
-	m_convexConvexCreateFunc = new (mem) btConvexConvexAlgorithm::CreateFunc(m_pdSolver);
+	m_convexConvexAlgorithm = constructionInfo.m_convexConvexAlgorithm;
+	if (constructionInfo.m_convexConvexAlgorithm == BT_CONVEX_CONVEX_GJK_PAIR_DETECTOR)
+	{
+		mem = btAlignedAlloc(sizeof(btConvexConvexAlgorithm::CreateFunc), 16);
+		m_convexConvexCreateFunc = new (mem) btConvexConvexAlgorithm::CreateFunc(m_pdSolver);
+	}
+	else
+	{
+		mem = btAlignedAlloc(sizeof(btConvexConvexMprAlgorithm::CreateFunc), 16);
+		m_convexConvexCreateFunc = new (mem) btConvexConvexMprAlgorithm::CreateFunc(constructionInfo.m_convexConvexAlgorithm == BT_CONVEX_CONVEX_GJK_EPA3 ? btConvexConvexMprAlgorithm::EPA_PENETRATION : btConvexConvexMprAlgorithm::MPR_PENETRATION);
+	}
 	mem = btAlignedAlloc(sizeof(btConvexConcaveCollisionAlgorithm::CreateFunc), 16);
 	m_convexConcaveCreateFunc = new (mem) btConvexConcaveCollisionAlgorithm::CreateFunc;
 	mem = btAlignedAlloc(sizeof(btConvexConcaveCollisionAlgorithm::CreateFunc), 16);
@@ -93,16 +104,26 @@ btDefaultCollisionConfiguration::btDefaultCollisionConfiguration(const btDefault
 	m_planeConvexCF = new (mem) btConvexPlaneCollisionAlgorithm::CreateFunc;
 	m_planeConvexCF->m_swapped = true;
 
+	//sphere, capsule and box versus heightfield
+	m_useHeightfieldPrimitiveAlgorithm = constructionInfo.m_useHeightfieldPrimitiveAlgorithm != 0;
+	mem = btAlignedAlloc(sizeof(btHeightfieldPrimitiveCollisionAlgorithm::CreateFunc), 16);
+	m_primitiveHeightfieldCF = new (mem) btHeightfieldPrimitiveCollisionAlgorithm::CreateFunc;
+	mem = btAlignedAlloc(sizeof(btHeightfieldPrimitiveCollisionAlgorithm::CreateFunc), 16);
+	m_heightfieldPrimitiveCF = new (mem) btHeightfieldPrimitiveCollisionAlgorithm::CreateFunc;
+	m_heightfieldPrimitiveCF->m_swapped = true;
+
 	///calculate maximum element size, big enough to fit any collision algorithm in the memory pool
-	int maxSize = sizeof(btConvexConvexAlgorithm);
+	int maxSize = btMax(sizeof(btConvexConvexAlgorithm), sizeof(btConvexConvexMprAlgorithm));
 	int maxSize2 = sizeof(btConvexConcaveCollisionAlgorithm);
 	int maxSize3 = sizeof(btCompoundCollisionAlgorithm);
 	int maxSize4 = sizeof(btCompoundCompoundCollisionAlgorithm);
+	int maxSize5 = sizeof(btHeightfieldPrimitiveCollisionAlgorithm);
 
 	int collisionAlgorithmMaxElementSize = btMax(maxSize, constructionInfo.m_customCollisionAlgorithmMaxElementSize);
 	collisionAlgorithmMaxElementSize = btMax(collisionAlgorithmMaxElementSize, maxSize2);
 	collisionAlgorithmMaxElementSize = btMax(collisionAlgorithmMaxElementSize, maxSize3);
 	collisionAlgorithmMaxElementSize = btMax(collisionAlgorithmMaxElementSize, maxSize4);
+	collisionAlgorithmMaxElementSize = btMax(collisionAlgorithmMaxElementSize, maxSize5);
 
 	if (constructionInfo.m_persistentManifoldPool)
 	{
@@ -184,6 +205,10 @@ btDefaultCollisionConfiguration::~btDefaultCollisionConfiguration()
 	btAlignedFree(m_convexPlaneCF);
 	m_planeConvexCF->~btCollisionAlgorithmCreateFunc();
 	btAlignedFree(m_planeConvexCF);
+	m_primitiveHeightfieldCF->~btCollisionAlgorithmCreateFunc();
+	btAlignedFree(m_primitiveHeightfieldCF);
+	m_heightfieldPrimitiveCF->~btCollisionAlgorithmCreateFunc();
+	btAlignedFree(m_heightfieldPrimitiveCF);
 
 	m_pdSolver->~btConvexPenetrationDepthSolver();
 
@@ -312,6 +337,19 @@ btCollisionAlgorithmCreateFunc* btDefaultCollisionConfiguration::getCollisionAlg
 		return m_convexConvexCreateFunc;
 	}
 
+	if (m_useHeightfieldPrimitiveAlgorithm)
+	{
+		if (btHeightfieldPrimitiveCollisionAlgorithm::isSupportedPrimitive(proxyType0) && (proxyType1 == TERRAIN_SHAPE_PROXYTYPE))
+		{
+			return m_primitiveHeightfieldCF;
+		}
+
+		if ((proxyType0 == TERRAIN_SHAPE_PROXYTYPE) && btHeightfieldPrimitiveCollisionAlgorithm::isSupportedPrimitive(proxyType1))
+		{
+			return m_heightfieldPrimitiveCF;
+		}
+	}
+
 	if (btBroadphaseProxy::isConvex(proxyType0) && btBroadphaseProxy::isConcave(proxyType1))
 	{
 		return m_convexConcaveCreateFunc;
@@ -345,6 +383,8 @@ btCollisionAlgorithmCreateFunc* btDefaultCollisionConfiguration::getCollisionAlg
 
 void btDefaultCollisionConfiguration::setConvexConvexMultipointIterations(int numPerturbationIterations, int minimumPointsPerturbationThreshold)
 {
+	if (m_convexConvexAlgorithm != BT_CONVEX_CONVEX_GJK_PAIR_DETECTOR)
+		return;
 	btConvexConvexAlgorithm::CreateFunc* convexConvex = (btConvexConvexAlgorithm::CreateFunc*)m_convexConvexCreateFunc;
 	convexConvex->m_numPerturbationIterations = numPerturbationIterations;
 	convexConvex->m_minimumPointsPerturbationThreshold = minimumPointsPerturbationThreshold;
@@ -20,6 +20,13 @@ subject to the following restrictions:
 class btVoronoiSimplexSolver;
 class btConvexPenetrationDepthSolver;
 
+enum btDefaultConvexConvexAlgorithm
+{
+	BT_CONVEX_CONVEX_GJK_PAIR_DETECTOR = 0,  //btConvexConvexAlgorithm: btGjkPairDetector and the penetration depth solver selected by m_useEpaPenetrationAlgorithm
+	BT_CONVEX_CONVEX_GJK_MPR,                //btConvexConvexMprAlgorithm: templated GJK, MPR for penetrating shapes
+	BT_CONVEX_CONVEX_GJK_EPA3                //btConvexConvexMprAlgorithm: templated GJK, templated EPA for penetrating shapes
+};
+
 struct btDefaultCollisionConstructionInfo
 {
 	btPoolAllocator* m_persistentManifoldPool;
@@ -28,6 +35,10 @@ struct btDefaultCollisionConstructionInfo
 	int m_defaultMaxCollisionAlgorithmPoolSize;
 	int m_customCollisionAlgorithmMaxElementSize;
 	int m_useEpaPenetrationAlgorithm;
+	int m_convexConvexAlgorithm;  //btDefaultConvexConvexAlgorithm
+	///spheres, capsules and boxes against heightfields use btHeightfieldPrimitiveCollisionAlgorithm. Off by default, its contacts
+	///don't go through the triangle wrappers, so btAdjustInternalEdgeContacts doesn't apply to them
+	int m_useHeightfieldPrimitiveAlgorithm;
 
 	btDefaultCollisionConstructionInfo()
 		: m_persistentManifoldPool(0),
@@ -35,7 +46,9 @@ struct btDefaultCollisionConstructionInfo
 		  m_defaultMaxPersistentManifoldPoolSize(4096),
 		  m_defaultMaxCollisionAlgorithmPoolSize(4096),
 		  m_customCollisionAlgorithmMaxElementSize(0),
-		  m_useEpaPenetrationAlgorithm(true)
+		  m_useEpaPenetrationAlgorithm(true),
+		  m_convexConvexAlgorithm(BT_CONVEX_CONVEX_GJK_PAIR_DETECTOR),
+		  m_useHeightfieldPrimitiveAlgorithm(false)
 	{
 	}
 };
@@ -57,6 +70,11 @@ protected:
 	//default penetration depth solver
 	btConvexPenetrationDepthSolver* m_pdSolver;
 
+	//btDefaultConvexConvexAlgorithm, the algorithm m_convexConvexCreateFunc creates
+	int m_convexConvexAlgorithm;
+
+	bool m_useHeightfieldPrimitiveAlgorithm;
+
 	//default CreationFunctions, filling the m_doubleDispatch table
 	btCollisionAlgorithmCreateFunc* m_convexConvexCreateFunc;
 	btCollisionAlgorithmCreateFunc* m_convexConcaveCreateFunc;
@@ -75,6 +93,8 @@ protected:
 	btCollisionAlgorithmCreateFunc* m_triangleSphereCF;
 	btCollisionAlgorithmCreateFunc* m_planeConvexCF;
 	btCollisionAlgorithmCreateFunc* m_convexPlaneCF;
+	btCollisionAlgorithmCreateFunc* m_primitiveHeightfieldCF;
+	btCollisionAlgorithmCreateFunc* m_heightfieldPrimitiveCF;
 
 public:
 	btDefaultCollisionConfiguration(const btDefaultCollisionConstructionInfo& constructionInfo = btDefaultCollisionConstructionInfo());
@@ -97,7 +117,7 @@ public:
 	virtual btCollisionAlgorithmCreateFunc* getClosestPointsAlgorithmCreateFunc(int proxyType0, int proxyType1);
 
 	///Use this method to allow to generate multiple contact points between at once, between two objects using the generic convex-convex algorithm.
-	///By default, this feature is disabled for best performance.
+	///By default, this feature is disabled for best performance. It only applies to BT_CONVEX_CONVEX_GJK_PAIR_DETECTOR.
 	///@param numPerturbationIterations controls the number of collision queries. Set it to zero to disable the feature.
 	///@param minimumPointsPerturbationThreshold is the minimum number of points in the contact cache, above which the feature is disabled
 	///3 is a good value for both params, if you want to enable the feature. This is because the default contact cache contains a maximum of 4 points, and one collision query at the unperturbed orientation is performed first.
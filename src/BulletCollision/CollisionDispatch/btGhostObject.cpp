@@ -164,3 +164,115 @@ void btGhostObject::rayTest(const btVector3& rayFromWorld, const btVector3& rayT
 		}
 	}
 }
+
+btBroadphasePair* btGhostOverlapEventCallback::addOverlappingPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1)
+{
+	btCollisionObject* colObj0 = (btCollisionObject*)proxy0->m_clientObject;
+	btCollisionObject* colObj1 = (btCollisionObject*)proxy1->m_clientObject;
+	btGhostObject* ghost0 = btGhostObject::upcast(colObj0);
+	btGhostObject* ghost1 = btGhostObject::upcast(colObj1);
+	if (ghost0)
+	{
+		int numOverlappingObjects = ghost0->getNumOverlappingObjects();
+		ghost0->addOverlappingObjectInternal(proxy1, proxy0);
+		if (ghost0->getNumOverlappingObjects() != numOverlappingObjects)
+			addEvent(ghost0, colObj1, BT_GHOST_OVERLAP_BEGIN);
+	}
+	if (ghost1)
+	{
+		int numOverlappingObjects = ghost1->getNumOverlappingObjects();
+		ghost1->addOverlappingObjectInternal(proxy0, proxy1);
+		if (ghost1->getNumOverlappingObjects() != numOverlappingObjects)
+			addEvent(ghost1, colObj0, BT_GHOST_OVERLAP_BEGIN);
+	}
+	return 0;
+}
+
+void* btGhostOverlapEventCallback::removeOverlappingPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1, btDispatcher* dispatcher)
+{
+	btCollisionObject* colObj0 = (btCollisionObject*)proxy0->m_clientObject;
+	btCollisionObject* colObj1 = (btCollisionObject*)proxy1->m_clientObject;
+	btGhostObject* ghost0 = btGhostObject::upcast(colObj0);
+	btGhostObject* ghost1 = btGhostObject::upcast(colObj1);
+	if (ghost0)
+	{
+		int numOverlappingObjects = ghost0->getNumOverlappingObjects();
+		ghost0->removeOverlappingObjectInternal(proxy1, dispatcher, proxy0);
+		if (ghost0->getNumOverlappingObjects() != numOverlappingObjects)
+			addEvent(ghost0, colObj1, BT_GHOST_OVERLAP_END);
+	}
+	if (ghost1)
+	{
+		int numOverlappingObjects = ghost1->getNumOverlappingObjects();
+		ghost1->removeOverlappingObjectInternal(proxy0, dispatcher, proxy1);
+		if (ghost1->getNumOverlappingObjects() != numOverlappingObjects)
+			addEvent(ghost1, colObj0, BT_GHOST_OVERLAP_END);
+	}
+	return 0;
+}
+
+struct btGhostTouchCallback : public btCollisionWorld::ContactResultCallback
+{
+	bool m_touching;
+
+	btGhostTouchCallback()
+		: m_touching(false)
+	{
+	}
+
+	virtual btScalar addSingleResult(btManifoldPoint& cp, const btCollisionObjectWrapper* colObj0Wrap, int partId0, int index0, const btCollisionObjectWrapper* colObj1Wrap, int partId1, int index1)
+	{
+		if (cp.getDistance() <= btScalar(0.))
+			m_touching = true;
+		return 0;
+	}
+};
+
+void btGhostOverlapEventCallback::processOverlapEvents(btCollisionWorld* collisionWorld)
+{
+	for (int i = 0; i < m_broadphaseEvents.size(); i++)
+	{
+		const btGhostOverlapEvent& event = m_broadphaseEvents[i];
+		btGhostOverlapPairKey key(event.m_ghostObject, event.m_otherObject);
+		if (event.m_eventType == BT_GHOST_OVERLAP_BEGIN)
+		{
+			btAssert(!m_pairStates.find(key));
+			m_pairStates.insert(key, m_pendingPairs.size());
+			m_pendingPairs.push_back(event);
+		}
+		else
+		{
+			//pending pairs are left in m_pendingPairs, they no longer match their state below
+			int* state = m_pairStates.find(key);
+			if (state && *state < 0)
+			{
+				m_events.push_back(event);
+			}
+			m_pairStates.remove(key);
+		}
+	}
+	m_broadphaseEvents.resize(0);
+
+	int numPendingPairs = 0;
+	for (int i = 0; i < m_pendingPairs.size(); i++)
+	{
+		btGhostOverlapEvent event = m_pendingPairs[i];
+		int* state = m_pairStates.find(btGhostOverlapPairKey(event.m_ghostObject, event.m_otherObject));
+		if (!state || *state != i)
+			continue;
+
+		btGhostTouchCallback touchCallback;
+		collisionWorld->contactPairTest(event.m_ghostObject, event.m_otherObject, touchCallback);
+		if (touchCallback.m_touching)
+		{
+			*state = -1;
+			m_events.push_back(event);
+		}
+		else
+		{
+			*state = numPendingPairs;
+			m_pendingPairs[numPendingPairs++] = event;
+		}
+	}
+	m_pendingPairs.resize(numPendingPairs);
+}
@@ -21,6 +21,7 @@ subject to the following restrictions:
 #include "LinearMath/btAlignedAllocator.h"
 #include "BulletCollision/BroadphaseCollision/btOverlappingPairCache.h"
 #include "btCollisionWorld.h"
+#include "LinearMath/btHashMap.h"
 
 class btConvexShape;
 
@@ -159,4 +160,113 @@ public:
 	}
 };
 
+enum btGhostOverlapEventType
+{
+	BT_GHOST_OVERLAP_BEGIN,
+	BT_GHOST_OVERLAP_END
+};
+
+struct btGhostOverlapEvent
+{
+	btGhostObject* m_ghostObject;
+	btCollisionObject* m_otherObject;
+	int m_eventType;  //btGhostOverlapEventType
+};
+
+///btGhostOverlapEventCallback is a btGhostPairCallback that also queues an event when an object starts or stops overlapping
+///a ghost object, so that trigger volumes don't have to scan their overlapping objects every frame.
+///Without narrowphase confirmation the events follow the broadphase (AABB) overlaps and are queued as the pairs change.
+///With narrowphase confirmation the AABB changes are kept aside, and processOverlapEvents only tests the pairs that overlap
+///in the broadphase but did not touch yet, a begin event is queued once the shapes touch. The end event is queued when the AABBs separate.
+///The events of objects removed from the world are queued too, don't access their other object after it was deleted.
+class btGhostOverlapEventCallback : public btGhostPairCallback
+{
+	struct btGhostOverlapPairKey
+	{
+		const btGhostObject* m_ghostObject;
+		const btCollisionObject* m_otherObject;
+
+		btGhostOverlapPairKey(const btGhostObject* ghostObject, const btCollisionObject* otherObject)
+			: m_ghostObject(ghostObject),
+			  m_otherObject(otherObject)
+		{
+		}
+
+		bool equals(const btGhostOverlapPairKey& other) const
+		{
+			return m_ghostObject == other.m_ghostObject && m_otherObject == other.m_otherObject;
+		}
+
+		SIMD_FORCE_INLINE unsigned int getHash() const
+		{
+			return btHashPtr(m_ghostObject).getHash() ^ (btHashPtr(m_otherObject).getHash() * 31);
+		}
+	};
+
+	btAlignedObjectArray<btGhostOverlapEvent> m_events;
+
+	bool m_narrowphaseConfirmation;
+	///AABB overlap changes that are not processed yet
+	btAlignedObjectArray<btGhostOverlapEvent> m_broadphaseEvents;
+	///AABB overlapping pairs that don't touch yet
+	btAlignedObjectArray<btGhostOverlapEvent> m_pendingPairs;
+	///index into m_pendingPairs, or -1 once the pair touched
+	btHashMap<btGhostOverlapPairKey, int> m_pairStates;
+
+	void addEvent(btGhostObject* ghostObject, btCollisionObject* otherObject, int eventType)
+	{
+		btGhostOverlapEvent event;
+		event.m_ghostObject = ghostObject;
+		event.m_otherObject = otherObject;
+		event.m_eventType = eventType;
+		if (m_narrowphaseConfirmation)
+			m_broadphaseEvents.push_back(event);
+		else
+			m_events.push_back(event);
+	}
+
+public:
+	btGhostOverlapEventCallback()
+		: m_narrowphaseConfirmation(false)
+	{
+	}
+
+	virtual ~btGhostOverlapEventCallback()
+	{
+	}
+
+	virtual btBroadphasePair* addOverlappingPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1);
+
+	virtual void* removeOverlappingPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1, btDispatcher* dispatcher);
+
+	///only report overlaps once the shapes touch, call processOverlapEvents after each simulation step
+	void setNarrowphaseConfirmation(bool narrowphaseConfirmation)
+	{
+		m_narrowphaseConfirmation = narrowphaseConfirmation;
+	}
+
+	bool getNarrowphaseConfirmation() const
+	{
+		return m_narrowphaseConfirmation;
+	}
+
+	///applies the broadphase changes and tests the pending pairs with btCollisionWorld::contactPairTest
+	void processOverlapEvents(btCollisionWorld* collisionWorld);
+
+	int getNumEvents() const
+	{
+		return m_events.size();
+	}
+
+	const btGhostOverlapEvent& getEvent(int index) const
+	{
+		return m_events[index];
+	}
+
+	void clearEvents()
+	{
+		m_events.resize(0);
+	}
+};
+
 #endif
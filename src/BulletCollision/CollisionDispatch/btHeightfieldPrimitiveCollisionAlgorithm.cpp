@@ -0,0 +1,597 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2006 Erwin Coumans  https://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btHeightfieldPrimitiveCollisionAlgorithm.h"
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcher.h"
+#include "BulletCollision/CollisionShapes/btSphereShape.h"
+#include "BulletCollision/CollisionShapes/btCapsuleShape.h"
+#include "BulletCollision/CollisionShapes/btBoxShape.h"
+#include "BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h"
+#include "BulletCollision/CollisionShapes/btTriangleCallback.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObject.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h"
+
+btHeightfieldPrimitiveCollisionAlgorithm::btHeightfieldPrimitiveCollisionAlgorithm(btPersistentManifold* mf, const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* col0Wrap, const btCollisionObjectWrapper* col1Wrap, bool isSwapped)
+	: btActivatingCollisionAlgorithm(ci, col0Wrap, col1Wrap),
+	  m_ownManifold(false),
+	  m_manifoldPtr(mf),
+	  m_isSwapped(isSwapped)
+{
+	const btCollisionObjectWrapper* primitiveObjWrap = m_isSwapped ? col1Wrap : col0Wrap;
+	const btCollisionObjectWrapper* heightfieldObjWrap = m_isSwapped ? col0Wrap : col1Wrap;
+
+	if (!m_manifoldPtr && m_dispatcher->needsCollision(primitiveObjWrap->getCollisionObject(), heightfieldObjWrap->getCollisionObject()))
+	{
+		m_manifoldPtr = m_dispatcher->getNewManifold(primitiveObjWrap->getCollisionObject(), heightfieldObjWrap->getCollisionObject());
+		m_ownManifold = true;
+	}
+}
+
+btHeightfieldPrimitiveCollisionAlgorithm::~btHeightfieldPrimitiveCollisionAlgorithm()
+{
+	if (m_ownManifold)
+	{
+		if (m_manifoldPtr)
+			m_dispatcher->releaseManifold(m_manifoldPtr);
+	}
+}
+
+///closest point on the triangle abc to p, see Ericson, Real-Time Collision Detection 5.1.5.
+///inFace is true when the closest point lies inside the triangle, not on an edge or vertex
+static btVector3 btClosestPointOnTriangle(const btVector3& p, const btVector3& a, const btVector3& b, const btVector3& c, bool& inFace)
+{
+	inFace = false;
+	const btVector3 ab = b - a;
+	const btVector3 ac = c - a;
+	const btVector3 ap = p - a;
+	const btScalar d1 = ab.dot(ap);
+	const btScalar d2 = ac.dot(ap);
+	if (d1 <= btScalar(0.) && d2 <= btScalar(0.))
+		return a;
+
+	const btVector3 bp = p - b;
+	const btScalar d3 = ab.dot(bp);
+	const btScalar d4 = ac.dot(bp);
+	if (d3 >= btScalar(0.) && d4 <= d3)
+		return b;
+
+	const btScalar vc = d1 * d4 - d3 * d2;
+	if (vc <= btScalar(0.) && d1 >= btScalar(0.) && d3 <= btScalar(0.))
+		return a + ab * (d1 / (d1 - d3));
+
+	const btVector3 cp = p - c;
+	const btScalar d5 = ab.dot(cp);
+	const btScalar d6 = ac.dot(cp);
+	if (d6 >= btScalar(0.) && d5 <= d6)
+		return c;
+
+	const btScalar vb = d5 * d2 - d1 * d6;
+	if (vb <= btScalar(0.) && d2 >= btScalar(0.) && d6 <= btScalar(0.))
+		return a + ac * (d2 / (d2 - d6));
+
+	const btScalar va = d3 * d6 - d5 * d4;
+	if (va <= btScalar(0.) && (d4 - d3) >= btScalar(0.) && (d5 - d6) >= btScalar(0.))
+		return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+	inFace = true;
+	const btScalar denom = btScalar(1.) / (va + vb + vc);
+	return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+///closest point on the segment p0 p1 to the segment q0 q1, see Ericson, Real-Time Collision Detection 5.1.9
+static btVector3 btClosestPointOnSegmentToSegment(const btVector3& p0, const btVector3& p1, const btVector3& q0, const btVector3& q1)
+{
+	const btVector3 d1 = p1 - p0;
+	const btVector3 d2 = q1 - q0;
+	const btVector3 r = p0 - q0;
+	const btScalar a = d1.length2();
+	const btScalar e = d2.length2();
+	const btScalar f = d2.dot(r);
+	if (a <= SIMD_EPSILON)
+		return p0;
+
+	const btScalar c = d1.dot(r);
+	btScalar s;
+	if (e <= SIMD_EPSILON)
+	{
+		s = btClamped(-c / a, btScalar(0.), btScalar(1.));
+	}
+	else
+	{
+		const btScalar b = d1.dot(d2);
+		const btScalar denom = a * e - b * b;
+		s = denom > SIMD_EPSILON ? btClamped((b * f - c * e) / denom, btScalar(0.), btScalar(1.)) : btScalar(0.);
+		const btScalar t = (b * s + f) / e;
+		if (t < btScalar(0.))
+		{
+			s = btClamped(-c / a, btScalar(0.), btScalar(1.));
+		}
+		else if (t > btScalar(1.))
+		{
+			s = btClamped((b - c) / a, btScalar(0.), btScalar(1.));
+		}
+	}
+	return p0 + d1 * s;
+}
+
+///gathers the contact candidates of a primitive against the heightfield triangles, in heightfield local space
+struct btHeightfieldPrimitiveTriangleCallback : public btTriangleCallback
+{
+	btAlignedObjectArray<btHeightfieldContact>& m_candidates;
+	int m_primitiveType;
+	int m_upAxis;
+	btScalar m_threshold;
+	btScalar m_heightfieldMargin;
+
+	//sphere and capsule
+	btVector3 m_segment[2];
+	btScalar m_radius;
+
+	//box
+	btTransform m_boxTransform;
+	btVector3 m_boxHalfExtents;
+	btVector3 m_boxVertices[8];
+
+	btHeightfieldPrimitiveTriangleCallback(btAlignedObjectArray<btHeightfieldContact>& candidates)
+		: m_candidates(candidates)
+	{
+	}
+
+	void addCandidate(const btVector3& pointOnHeightfield, const btVector3& normal, btScalar distance, int partId, int triangleIndex)
+	{
+		distance -= m_heightfieldMargin;
+		if (distance >= m_threshold)
+		{
+			return;
+		}
+		btHeightfieldContact& contact = m_candidates.expandNonInitializing();
+		contact.m_pointOnHeightfield = pointOnHeightfield + normal * m_heightfieldMargin;
+		contact.m_normalOnHeightfield = normal;
+		contact.m_distance = distance;
+		contact.m_partId = partId;
+		contact.m_triangleIndex = triangleIndex;
+	}
+
+	void processSphere(const btVector3& center, const btVector3* triangle, const btVector3& normal, int partId, int triangleIndex)
+	{
+		bool inFace;
+		const btVector3 closest = btClosestPointOnTriangle(center, triangle[0], triangle[1], triangle[2], inFace);
+		if (inFace)
+		{
+			// also when the center went below the surface
+			addCandidate(closest, normal, normal.dot(center - triangle[0]) - m_radius, partId, triangleIndex);
+			return;
+		}
+		if (normal.dot(center - triangle[0]) < btScalar(0.))
+		{
+			// below the plane, outside the face: the triangle whose face is above the center reports it
+			return;
+		}
+		const btVector3 diff = center - closest;
+		const btScalar distance = diff.length();
+		if (distance > SIMD_EPSILON)
+		{
+			addCandidate(closest, diff / distance, distance - m_radius, partId, triangleIndex);
+		}
+	}
+
+	void processBox(const btVector3* triangle, const btVector3& normal, int partId, int triangleIndex)
+	{
+		// box corners above or below the triangle, against its plane
+		const int axis0 = m_upAxis == 0 ? 1 : 0;
+		const int axis1 = m_upAxis == 2 ? 1 : 2;
+		const btScalar e0x = triangle[1][axis0] - triangle[0][axis0];
+		const btScalar e0y = triangle[1][axis1] - triangle[0][axis1];
+		const btScalar e1x = triangle[2][axis0] - triangle[0][axis0];
+		const btScalar e1y = triangle[2][axis1] - triangle[0][axis1];
+		const btScalar det = e0x * e1y - e0y * e1x;
+		if (btFabs(det) > SIMD_EPSILON)
+		{
+			const btScalar invDet = btScalar(1.) / det;
+			for (int i = 0; i < 8; i++)
+			{
+				const btVector3& vertex = m_boxVertices[i];
+				const btScalar px = vertex[axis0] - triangle[0][axis0];
+				const btScalar py = vertex[axis1] - triangle[0][axis1];
+				const btScalar u = (px * e1y - py * e1x) * invDet;
+				const btScalar v = (e0x * py - e0y * px) * invDet;
+				if (u < btScalar(0.) || v < btScalar(0.) || u + v > btScalar(1.))
+				{
+					continue;
+				}
+				const btScalar distance = normal.dot(vertex - triangle[0]);
+				addCandidate(vertex - normal * distance, normal, distance, partId, triangleIndex);
+			}
+		}
+
+		// terrain vertices inside the box, pushed out through the nearest face that doesn't face up
+		for (int i = 0; i < 3; i++)
+		{
+			const btVector3 local = m_boxTransform.invXform(triangle[i]);
+			int faceAxis = -1;
+			btScalar faceDistance = -SIMD_INFINITY;
+			for (int k = 0; k < 3; k++)
+			{
+				const btScalar distance = btFabs(local[k]) - m_boxHalfExtents[k];
+				if (distance >= m_threshold)
+				{
+					faceAxis = -1;
+					break;
+				}
+				if (distance > faceDistance)
+				{
+					faceDistance = distance;
+					faceAxis = k;
+				}
+			}
+			if (faceAxis < 0)
+			{
+				continue;
+			}
+			btVector3 faceNormal(0, 0, 0);
+			faceNormal[faceAxis] = local[faceAxis] < btScalar(0.) ? btScalar(1.) : btScalar(-1.);
+			const btVector3 contactNormal = m_boxTransform.getBasis() * faceNormal;
+			if (contactNormal[m_upAxis] > btScalar(0.))
+			{
+				addCandidate(triangle[i], contactNormal, faceDistance, partId, triangleIndex);
+			}
+		}
+
+		processBoxEdges(triangle, normal, partId, triangleIndex);
+	}
+
+	///separating axis test of the box against the triangle, in the local space of the box. When a box face or a pair of edges
+	///separates them best, adds the terrain edges inside the box or the closest point of the edges. The corners and vertices
+	///above miss those when the box lies across a ridge
+	void processBoxEdges(const btVector3* triangle, const btVector3& normal, int partId, int triangleIndex)
+	{
+		//edge axes have to be better by this much than the face axes, which give more stable contacts
+		const btScalar edgeAxisTolerance = btScalar(0.001);
+		const btVector3& halfExtents = m_boxHalfExtents;
+		const btVector3 vertices[3] = {m_boxTransform.invXform(triangle[0]), m_boxTransform.invXform(triangle[1]), m_boxTransform.invXform(triangle[2])};
+		const btVector3 localNormal = normal * m_boxTransform.getBasis();
+
+		// the box face axes, the triangle normal and the 9 edge pairs
+		int bestAxis = -1;
+		btVector3 bestDirection;
+		btScalar bestDistance = -SIMD_INFINITY;
+		for (int i = 0; i < 13; i++)
+		{
+			btVector3 axis(0, 0, 0);
+			if (i < 3)
+			{
+				axis[i] = btScalar(1.);
+			}
+			else if (i == 3)
+			{
+				axis = localNormal;
+			}
+			else
+			{
+				axis[(i - 4) / 3] = btScalar(1.);
+				axis = axis.cross(vertices[((i - 4) % 3 + 1) % 3] - vertices[(i - 4) % 3]);
+				const btScalar length = axis.length();
+				if (length <= SIMD_EPSILON)
+				{
+					continue;
+				}
+				axis /= length;
+			}
+
+			const btScalar radius = halfExtents.dot(axis.absolute());
+			btScalar minProjection = axis.dot(vertices[0]);
+			btScalar maxProjection = minProjection;
+			for (int j = 1; j < 3; j++)
+			{
+				const btScalar projection = axis.dot(vertices[j]);
+				minProjection = btMin(minProjection, projection);
+				maxProjection = btMax(maxProjection, projection);
+			}
+			if (minProjection - radius > m_threshold + m_heightfieldMargin || -radius - maxProjection > m_threshold + m_heightfieldMargin)
+			{
+				return;
+			}
+
+			// the box is pushed out to the side of the triangle normal
+			const btScalar alignment = axis.dot(localNormal);
+			btScalar distance = -SIMD_INFINITY;
+			btVector3 direction = axis;
+			if (alignment > -SIMD_EPSILON)
+			{
+				distance = -radius - maxProjection;
+			}
+			if (alignment < SIMD_EPSILON && minProjection - radius > distance)
+			{
+				distance = minProjection - radius;
+				direction = -axis;
+			}
+			if (distance > bestDistance + (i > 3 ? edgeAxisTolerance : btScalar(0.)))
+			{
+				bestAxis = i;
+				bestDirection = direction;
+				bestDistance = distance;
+			}
+		}
+
+		if (bestAxis < 3)
+		{
+			if (bestAxis < 0)
+			{
+				return;
+			}
+			// the part of the triangle over the box face, clipped by the side faces
+			btVector3 polygon[2][8];
+			int numVertices = 3;
+			polygon[0][0] = vertices[0];
+			polygon[0][1] = vertices[1];
+			polygon[0][2] = vertices[2];
+			int current = 0;
+			for (int k = 0; k < 3; k++)
+			{
+				if (k == bestAxis)
+				{
+					continue;
+				}
+				for (int side = -1; side <= 1; side += 2)
+				{
+					const btVector3* in = polygon[current];
+					btVector3* out = polygon[1 - current];
+					int numOut = 0;
+					for (int j = 0; j < numVertices; j++)
+					{
+						const btVector3& a = in[j];
+						const btVector3& b = in[(j + 1) % numVertices];
+						const btScalar da = halfExtents[k] - side * a[k];
+						const btScalar db = halfExtents[k] - side * b[k];
+						if (da >= btScalar(0.))
+						{
+							out[numOut++] = a;
+						}
+						if ((da < btScalar(0.)) != (db < btScalar(0.)))
+						{
+							out[numOut++] = a + (b - a) * (da / (da - db));
+						}
+					}
+					numVertices = numOut;
+					current = 1 - current;
+					if (!numVertices)
+					{
+						return;
+					}
+				}
+			}
+			const btVector3 contactNormal = m_boxTransform.getBasis() * bestDirection;
+			for (int j = 0; j < numVertices; j++)
+			{
+				const btVector3& vertex = polygon[current][j];
+				addCandidate(m_boxTransform * vertex, contactNormal, -halfExtents[bestAxis] - bestDirection.dot(vertex), partId, triangleIndex);
+			}
+		}
+		else if (bestAxis > 3)
+		{
+			// the box edge that is deepest along the axis, against the triangle edge
+			const int k = (bestAxis - 4) / 3;
+			const int j = (bestAxis - 4) % 3;
+			btVector3 edgeCenter;
+			for (int a = 0; a < 3; a++)
+			{
+				edgeCenter[a] = a == k ? btScalar(0.) : (bestDirection[a] > btScalar(0.) ? -halfExtents[a] : halfExtents[a]);
+			}
+			btVector3 edgeExtent(0, 0, 0);
+			edgeExtent[k] = halfExtents[k];
+			const btVector3 pointOnTriangle = btClosestPointOnSegmentToSegment(vertices[j], vertices[(j + 1) % 3], edgeCenter - edgeExtent, edgeCenter + edgeExtent);
+			addCandidate(m_boxTransform * pointOnTriangle, m_boxTransform.getBasis() * bestDirection, bestDistance, partId, triangleIndex);
+		}
+	}
+
+	virtual void processTriangle(btVector3* triangle, int partId, int triangleIndex)
+	{
+		btVector3 normal = (triangle[1] - triangle[0]).cross(triangle[2] - triangle[0]);
+		const btScalar length = normal.length();
+		if (length <= SIMD_EPSILON)
+		{
+			return;
+		}
+		normal /= length;
+		if (normal[m_upAxis] < btScalar(0.))
+		{
+			// the outside of the terrain is above it, whatever the winding
+			normal = -normal;
+		}
+
+		switch (m_primitiveType)
+		{
+			case SPHERE_SHAPE_PROXYTYPE:
+			{
+				processSphere(m_segment[0], triangle, normal, partId, triangleIndex);
+				break;
+			}
+			case CAPSULE_SHAPE_PROXYTYPE:
+			{
+				processSphere(m_segment[0], triangle, normal, partId, triangleIndex);
+				processSphere(m_segment[1], triangle, normal, partId, triangleIndex);
+				// the points of the axis closest to the edges, for capsules lying across the cells
+				for (int i = 0; i < 3; i++)
+				{
+					const btVector3 center = btClosestPointOnSegmentToSegment(m_segment[0], m_segment[1], triangle[i], triangle[(i + 1) % 3]);
+					processSphere(center, triangle, normal, partId, triangleIndex);
+				}
+				break;
+			}
+			case BOX_SHAPE_PROXYTYPE:
+			{
+				processBox(triangle, normal, partId, triangleIndex);
+				break;
+			}
+			default:
+			{
+				btAssert(0);
+			}
+		}
+	}
+};
+
+/// Keeps the deepest candidate, then repeatedly the candidate farthest from the kept ones, counting a normal
+/// difference as a distance along the primitive. Candidates closer than tolerance to a kept one are dropped
+void btHeightfieldPrimitiveCollisionAlgorithm::reduceContacts(btScalar tolerance, btScalar extent)
+{
+	m_selected.resize(0);
+	int deepest = -1;
+	for (int i = 0; i < m_candidates.size(); i++)
+	{
+		if (deepest < 0 || m_candidates[i].m_distance < m_candidates[deepest].m_distance)
+		{
+			deepest = i;
+		}
+	}
+	if (deepest < 0)
+	{
+		return;
+	}
+	m_selected.push_back(deepest);
+
+	while (m_selected.size() < MANIFOLD_CACHE_SIZE)
+	{
+		int best = -1;
+		btScalar bestSpread = tolerance;
+		for (int i = 0; i < m_candidates.size(); i++)
+		{
+			const btHeightfieldContact& candidate = m_candidates[i];
+			btScalar spread = SIMD_INFINITY;
+			for (int j = 0; j < m_selected.size() && spread > bestSpread; j++)
+			{
+				const btHeightfieldContact& selected = m_candidates[m_selected[j]];
+				spread = btMin(spread, (candidate.m_pointOnHeightfield - selected.m_pointOnHeightfield).length() +
+										   extent * (btScalar(1.) - candidate.m_normalOnHeightfield.dot(selected.m_normalOnHeightfield)));
+			}
+			if (spread > bestSpread)
+			{
+				best = i;
+				bestSpread = spread;
+			}
+		}
+		if (best < 0)
+		{
+			break;
+		}
+		m_selected.push_back(best);
+	}
+}
+
+void btHeightfieldPrimitiveCollisionAlgorithm::processCollision(const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut)
+{
+	(void)dispatchInfo;
+	if (!m_manifoldPtr)
+		return;
+
+	const btCollisionObjectWrapper* primitiveObjWrap = m_isSwapped ? body1Wrap : body0Wrap;
+	const btCollisionObjectWrapper* heightfieldObjWrap = m_isSwapped ? body0Wrap : body1Wrap;
+	const btHeightfieldTerrainShape* heightfield = (const btHeightfieldTerrainShape*)heightfieldObjWrap->getCollisionShape();
+	const btCollisionShape* primitive = primitiveObjWrap->getCollisionShape();
+
+	resultOut->setPersistentManifold(m_manifoldPtr);
+
+	// work in the local space of the heightfield
+	const btTransform& heightfieldTrans = heightfieldObjWrap->getWorldTransform();
+	const btTransform primitiveTrans = heightfieldTrans.inverseTimes(primitiveObjWrap->getWorldTransform());
+	const btScalar threshold = m_manifoldPtr->getContactBreakingThreshold();
+
+	btHeightfieldPrimitiveTriangleCallback callback(m_candidates);
+	callback.m_primitiveType = primitive->getShapeType();
+	callback.m_upAxis = heightfield->getUpAxis();
+	callback.m_threshold = threshold;
+	callback.m_heightfieldMargin = heightfield->getMargin();
+
+	btScalar extent;
+	switch (callback.m_primitiveType)
+	{
+		case SPHERE_SHAPE_PROXYTYPE:
+		{
+			callback.m_radius = ((const btSphereShape*)primitive)->getRadius();
+			callback.m_segment[0] = primitiveTrans.getOrigin();
+			extent = callback.m_radius;
+			break;
+		}
+		case CAPSULE_SHAPE_PROXYTYPE:
+		{
+			const btCapsuleShape* capsule = (const btCapsuleShape*)primitive;
+			const btVector3 halfAxis = primitiveTrans.getBasis().getColumn(capsule->getUpAxis()) * capsule->getHalfHeight();
+			callback.m_radius = capsule->getRadius();
+			callback.m_segment[0] = primitiveTrans.getOrigin() + halfAxis;
+			callback.m_segment[1] = primitiveTrans.getOrigin() - halfAxis;
+			extent = capsule->getHalfHeight() + callback.m_radius;
+			break;
+		}
+		case BOX_SHAPE_PROXYTYPE:
+		{
+			const btVector3 halfExtents = ((const btBoxShape*)primitive)->getHalfExtentsWithMargin();
+			callback.m_boxTransform = primitiveTrans;
+			callback.m_boxHalfExtents = halfExtents;
+			for (int i = 0; i < 8; i++)
+			{
+				const btVector3 corner((i & 1) ? halfExtents.x() : -halfExtents.x(), (i & 2) ? halfExtents.y() : -halfExtents.y(), (i & 4) ? halfExtents.z() : -halfExtents.z());
+				callback.m_boxVertices[i] = primitiveTrans * corner;
+			}
+			extent = halfExtents.length();
+			break;
+		}
+		default:
+		{
+			btAssert(0);
+			return;
+		}
+	}
+
+	btVector3 aabbMin, aabbMax;
+	primitive->getAabb(primitiveTrans, aabbMin, aabbMax);
+	const btVector3 expand(threshold + callback.m_heightfieldMargin, threshold + callback.m_heightfieldMargin, threshold + callback.m_heightfieldMargin);
+	m_candidates.resize(0);
+	heightfield->processAllTriangles(&callback, aabbMin - expand, aabbMax + expand);
+
+	reduceContacts(threshold, extent);
+	for (int i = 0; i < m_selected.size(); i++)
+	{
+		const btHeightfieldContact& contact = m_candidates[m_selected[i]];
+		if (m_isSwapped)
+		{
+			resultOut->setShapeIdentifiersA(contact.m_partId, contact.m_triangleIndex);
+		}
+		else
+		{
+			resultOut->setShapeIdentifiersB(contact.m_partId, contact.m_triangleIndex);
+		}
+		/// report a contact. internally this will be kept persistent
+		resultOut->addContactPoint(heightfieldTrans.getBasis() * contact.m_normalOnHeightfield, heightfieldTrans * contact.m_pointOnHeightfield, contact.m_distance);
+	}
+
+	if (m_ownManifold)
+	{
+		if (m_manifoldPtr->getNumContacts())
+		{
+			resultOut->refreshContactPoints();
+		}
+	}
+}
+
+btScalar btHeightfieldPrimitiveCollisionAlgorithm::calculateTimeOfImpact(btCollisionObject* col0, btCollisionObject* col1, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut)
+{
+	(void)resultOut;
+	(void)dispatchInfo;
+	(void)col0;
+	(void)col1;
+
+	//not yet
+	return btScalar(1.);
+}
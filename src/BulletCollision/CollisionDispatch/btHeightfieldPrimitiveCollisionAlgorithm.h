@@ -0,0 +1,94 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2006 Erwin Coumans  https://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_HEIGHTFIELD_PRIMITIVE_COLLISION_ALGORITHM_H
+#define BT_HEIGHTFIELD_PRIMITIVE_COLLISION_ALGORITHM_H
+
+#include "btActivatingCollisionAlgorithm.h"
+#include "BulletCollision/BroadphaseCollision/btBroadphaseProxy.h"
+#include "BulletCollision/CollisionDispatch/btCollisionCreateFunc.h"
+class btPersistentManifold;
+#include "btCollisionDispatcher.h"
+
+#include "LinearMath/btVector3.h"
+#include "LinearMath/btAlignedObjectArray.h"
+
+///a contact candidate between a primitive and a heightfield triangle, in the local space of the heightfield
+struct btHeightfieldContact
+{
+	btVector3 m_pointOnHeightfield;
+	btVector3 m_normalOnHeightfield;
+	btScalar m_distance;
+	int m_partId;
+	int m_triangleIndex;
+};
+
+/// btHeightfieldPrimitiveCollisionAlgorithm provides sphere, capsule and box collision detection against a btHeightfieldTerrainShape.
+/// It tests the primitive against the triangles of the cells below it analytically, without GJK: closest points to the sphere
+/// center or the capsule segment, and for boxes the box corners against the surface below them, the terrain vertices inside
+/// the box and a separating axis test against each triangle for the terrain edges. The candidates are reduced to the deepest
+/// contact and a spread of distinct points before they reach the manifold.
+class btHeightfieldPrimitiveCollisionAlgorithm : public btActivatingCollisionAlgorithm
+{
+	bool m_ownManifold;
+	btPersistentManifold* m_manifoldPtr;
+	bool m_isSwapped;
+
+	btAlignedObjectArray<btHeightfieldContact> m_candidates;
+	btAlignedObjectArray<int> m_selected;
+
+	void reduceContacts(btScalar tolerance, btScalar extent);
+
+public:
+	btHeightfieldPrimitiveCollisionAlgorithm(btPersistentManifold* mf, const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, bool isSwapped);
+
+	virtual ~btHeightfieldPrimitiveCollisionAlgorithm();
+
+	virtual void processCollision(const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut);
+
+	virtual btScalar calculateTimeOfImpact(btCollisionObject* body0, btCollisionObject* body1, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut);
+
+	virtual void getAllContactManifolds(btManifoldArray& manifoldArray)
+	{
+		if (m_manifoldPtr && m_ownManifold)
+		{
+			manifoldArray.push_back(m_manifoldPtr);
+		}
+	}
+
+	///true for the primitives this algorithm handles against TERRAIN_SHAPE_PROXYTYPE
+	static bool isSupportedPrimitive(int proxyType)
+	{
+		return proxyType == SPHERE_SHAPE_PROXYTYPE || proxyType == CAPSULE_SHAPE_PROXYTYPE || proxyType == BOX_SHAPE_PROXYTYPE;
+	}
+
+	struct CreateFunc : public btCollisionAlgorithmCreateFunc
+	{
+		virtual btCollisionAlgorithm* CreateCollisionAlgorithm(btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap)
+		{
+			void* mem = ci.m_dispatcher1->allocateCollisionAlgorithm(sizeof(btHeightfieldPrimitiveCollisionAlgorithm));
+			if (!m_swapped)
+			{
+				return new (mem) btHeightfieldPrimitiveCollisionAlgorithm(0, ci, body0Wrap, body1Wrap, false);
+			}
+			else
+			{
+				return new (mem) btHeightfieldPrimitiveCollisionAlgorithm(0, ci, body0Wrap, body1Wrap, true);
+			}
+		}
+	};
+};
+
+#endif  //BT_HEIGHTFIELD_PRIMITIVE_COLLISION_ALGORITHM_H
@@ -24,7 +24,9 @@ subject to the following restrictions:
 btBvhTriangleMeshShape::btBvhTriangleMeshShape(btStridingMeshInterface* meshInterface, bool useQuantizedAabbCompression, bool buildBvh)
 	: btTriangleMeshShape(meshInterface),
 	  m_bvh(0),
+	  m_wideBvh(0),
 	  m_triangleInfoMap(0),
+	  m_buildMode(btQuantizedBvh::BUILD_MEAN_SPLIT),
 	  m_useQuantizedAabbCompression(useQuantizedAabbCompression),
 	  m_ownsBvh(false)
 {
@@ -43,7 +45,9 @@ btBvhTriangleMeshShape::btBvhTriangleMeshShape(btStridingMeshInterface* meshInte
 btBvhTriangleMeshShape::btBvhTriangleMeshShape(btStridingMeshInterface* meshInterface, bool useQuantizedAabbCompression, const btVector3& bvhAabbMin, const btVector3& bvhAabbMax, bool buildBvh)
 	: btTriangleMeshShape(meshInterface),
 	  m_bvh(0),
+	  m_wideBvh(0),
 	  m_triangleInfoMap(0),
+	  m_buildMode(btQuantizedBvh::BUILD_MEAN_SPLIT),
 	  m_useQuantizedAabbCompression(useQuantizedAabbCompression),
 	  m_ownsBvh(false)
 {
@@ -63,9 +67,28 @@ btBvhTriangleMeshShape::btBvhTriangleMeshShape(btStridingMeshInterface* meshInte
 #endif  //DISABLE_BVH
 }
 
+static void btRecordSubtreeCosts(btOptimizedBvh* bvh, btAlignedObjectArray<btScalar>& subtreeCosts)
+{
+	const int numSubtrees = bvh->isQuantized() ? bvh->getSubtreeInfoArray().size() : 0;
+	if (subtreeCosts.size() == numSubtrees)
+		return;
+
+	subtreeCosts.resize(numSubtrees);
+	for (int i = 0; i < numSubtrees; i++)
+	{
+		subtreeCosts[i] = bvh->calcSubtreeCost(i);
+	}
+}
+
 void btBvhTriangleMeshShape::partialRefitTree(const btVector3& aabbMin, const btVector3& aabbMax)
 {
-	m_bvh->refitPartial(m_meshInterface, aabbMin, aabbMax);
+	btRecordSubtreeCosts(m_bvh, m_subtreeCosts);
+	btAlignedObjectArray<int> refitSubtreeIndices;
+	m_bvh->refitPartial(m_meshInterface, aabbMin, aabbMax, m_wideBvh ? &refitSubtreeIndices : 0);
+	if (m_wideBvh && !m_wideBvh->refitSubtrees(m_bvh, refitSubtreeIndices) && !m_wideBvh->build(m_bvh))
+	{
+		clearWideBvh();
+	}
 
 	m_localAabbMin.setMin(aabbMin);
 	m_localAabbMax.setMax(aabbMax);
@@ -73,13 +96,42 @@ void btBvhTriangleMeshShape::partialRefitTree(const btVector3& aabbMin, const bt
 
 void btBvhTriangleMeshShape::refitTree(const btVector3& aabbMin, const btVector3& aabbMax)
 {
+	btRecordSubtreeCosts(m_bvh, m_subtreeCosts);
 	m_bvh->refit(m_meshInterface, aabbMin, aabbMax);
+	if (m_wideBvh && !m_wideBvh->refit(m_bvh) && !m_wideBvh->build(m_bvh))
+	{
+		clearWideBvh();
+	}
 
 	recalcLocalAabb();
 }
 
+int btBvhTriangleMeshShape::rebuildDegradedSubtrees(btScalar maxCostRatio, int maxRebuilds)
+{
+	if (!m_bvh || !m_bvh->isQuantized() || m_subtreeCosts.size() != m_bvh->getSubtreeInfoArray().size())
+		return 0;
+
+	int numRebuilt = 0;
+	for (int i = 0; i < m_subtreeCosts.size() && numRebuilt < maxRebuilds; i++)
+	{
+		if (m_bvh->calcSubtreeCost(i) > maxCostRatio * m_subtreeCosts[i])
+		{
+			m_bvh->rebuildSubtree(i);
+			m_subtreeCosts[i] = m_bvh->calcSubtreeCost(i);
+			numRebuilt++;
+		}
+	}
+
+	if (numRebuilt && m_wideBvh && !m_wideBvh->build(m_bvh))
+	{
+		clearWideBvh();
+	}
+	return numRebuilt;
+}
+
 btBvhTriangleMeshShape::~btBvhTriangleMeshShape()
 {
+	clearWideBvh();
 	if (m_ownsBvh)
 	{
 		m_bvh->~btOptimizedBvh();
@@ -158,7 +210,14 @@ void btBvhTriangleMeshShape::performRaycast(btTriangleCallback* callback, const
 
 	MyNodeOverlapCallback myNodeCallback(callback, m_meshInterface);
 
-	m_bvh->reportRayOverlappingNodex(&myNodeCallback, raySource, rayTarget);
+	if (m_wideBvh)
+	{
+		m_wideBvh->reportRayOverlappingNodex(&myNodeCallback, raySource, rayTarget);
+	}
+	else
+	{
+		m_bvh->reportRayOverlappingNodex(&myNodeCallback, raySource, rayTarget);
+	}
 }
 
 void btBvhTriangleMeshShape::performConvexcast(btTriangleCallback* callback, const btVector3& raySource, const btVector3& rayTarget, const btVector3& aabbMin, const btVector3& aabbMax)
@@ -232,7 +291,14 @@ void btBvhTriangleMeshShape::performConvexcast(btTriangleCallback* callback, con
 
 	MyNodeOverlapCallback myNodeCallback(callback, m_meshInterface);
 
-	m_bvh->reportBoxCastOverlappingNodex(&myNodeCallback, raySource, rayTarget, aabbMin, aabbMax);
+	if (m_wideBvh)
+	{
+		m_wideBvh->reportBoxCastOverlappingNodex(&myNodeCallback, raySource, rayTarget, aabbMin, aabbMax);
+	}
+	else
+	{
+		m_bvh->reportBoxCastOverlappingNodex(&myNodeCallback, raySource, rayTarget, aabbMin, aabbMax);
+	}
 }
 
 //perform bvh tree traversal and report overlapping triangles to 'callback'
@@ -323,7 +389,14 @@ void btBvhTriangleMeshShape::processAllTriangles(btTriangleCallback* callback, c
 
 	MyNodeOverlapCallback myNodeCallback(callback, m_meshInterface);
 
-	m_bvh->reportAabbOverlappingNodex(&myNodeCallback, aabbMin, aabbMax);
+	if (m_wideBvh)
+	{
+		m_wideBvh->reportAabbOverlappingNodex(&myNodeCallback, aabbMin, aabbMax);
+	}
+	else
+	{
+		m_bvh->reportAabbOverlappingNodex(&myNodeCallback, aabbMin, aabbMax);
+	}
 
 #endif  //DISABLE_BVH
 }
@@ -333,11 +406,11 @@ void btBvhTriangleMeshShape::setLocalScaling(const btVector3& scaling)
 	if ((getLocalScaling() - scaling).length2() > SIMD_EPSILON)
 	{
 		btTriangleMeshShape::setLocalScaling(scaling);
-		buildOptimizedBvh();
+		buildOptimizedBvh(m_buildMode);
 	}
 }
 
-void btBvhTriangleMeshShape::buildOptimizedBvh()
+void btBvhTriangleMeshShape::buildOptimizedBvh(btQuantizedBvh::btBuildMode buildMode)
 {
 	if (m_ownsBvh)
 	{
@@ -348,8 +421,35 @@ void btBvhTriangleMeshShape::buildOptimizedBvh()
 	void* mem = btAlignedAlloc(sizeof(btOptimizedBvh), 16);
 	m_bvh = new (mem) btOptimizedBvh();
 	//rebuild the bvh...
-	m_bvh->build(m_meshInterface, m_useQuantizedAabbCompression, m_localAabbMin, m_localAabbMax);
+	m_bvh->build(m_meshInterface, m_useQuantizedAabbCompression, m_localAabbMin, m_localAabbMax, buildMode);
 	m_ownsBvh = true;
+	m_buildMode = buildMode;
+	m_subtreeCosts.clear();
+	if (m_wideBvh && !m_wideBvh->build(m_bvh))
+	{
+		clearWideBvh();
+	}
+}
+
+bool btBvhTriangleMeshShape::buildWideBvh(int width)
+{
+	clearWideBvh();
+	if (!m_bvh || !m_bvh->isQuantized())
+		return false;
+
+	m_wideBvh = btQuantizedWideBvh::create(width);
+	if (!m_wideBvh || !m_wideBvh->build(m_bvh))
+	{
+		clearWideBvh();
+		return false;
+	}
+	return true;
+}
+
+void btBvhTriangleMeshShape::clearWideBvh()
+{
+	delete m_wideBvh;
+	m_wideBvh = 0;
 }
 
 void btBvhTriangleMeshShape::setOptimizedBvh(btOptimizedBvh* bvh, const btVector3& scaling)
@@ -359,6 +459,7 @@ void btBvhTriangleMeshShape::setOptimizedBvh(btOptimizedBvh* bvh, const btVector
 
 	m_bvh = bvh;
 	m_ownsBvh = false;
+	m_subtreeCosts.clear();
 	// update the scaling without rebuilding the bvh
 	if ((getLocalScaling() - scaling).length2() > SIMD_EPSILON)
 	{
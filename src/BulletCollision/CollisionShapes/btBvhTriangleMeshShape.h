@@ -18,6 +18,7 @@ subject to the following restrictions:
 
 #include "btTriangleMeshShape.h"
 #include "btOptimizedBvh.h"
+#include "BulletCollision/BroadphaseCollision/btQuantizedWideBvh.h"
 #include "LinearMath/btAlignedAllocator.h"
 #include "btTriangleInfoMap.h"
 
@@ -35,7 +36,10 @@ ATTRIBUTE_ALIGNED16(class)
 btBvhTriangleMeshShape : public btTriangleMeshShape
 {
 	btOptimizedBvh* m_bvh;
+	btQuantizedWideBvh* m_wideBvh;
 	btTriangleInfoMap* m_triangleInfoMap;
+	btAlignedObjectArray<btScalar> m_subtreeCosts;  //SAH cost of each subtree before it was first refit, see rebuildDegradedSubtrees
+	btQuantizedBvh::btBuildMode m_buildMode;        //used again when the bvh is rebuilt for a new scaling
 
 	bool m_useQuantizedAabbCompression;
 	bool m_ownsBvh;
@@ -70,6 +74,11 @@ public:
 	///for a fast incremental refit of parts of the tree. Note: the entire AABB of the tree will become more conservative, it never shrinks
 	void partialRefitTree(const btVector3& aabbMin, const btVector3& aabbMax);
 
+	///rebuilds, with binned SAH, the subtrees of a quantized bvh whose cost grew by more than maxCostRatio since they were
+	///first refit, for meshes that deform a lot, like skinned characters. At most maxRebuilds subtrees are rebuilt per call,
+	///so the work can be spread over frames. Returns the number of rebuilt subtrees
+	int rebuildDegradedSubtrees(btScalar maxCostRatio = btScalar(1.5), int maxRebuilds = 16);
+
 	//debugging
 	virtual const char* getName() const { return "BVHTRIANGLEMESH"; }
 
@@ -82,7 +91,26 @@ public:
 
 	void setOptimizedBvh(btOptimizedBvh * bvh, const btVector3& localScaling = btVector3(1, 1, 1));
 
-	void buildOptimizedBvh();
+	///rebuild the bvh, for example with btQuantizedBvh::BUILD_BINNED_SAH after constructing the shape with buildBvh = false.
+	///The build mode is kept for later rebuilds, such as in setLocalScaling
+	void buildOptimizedBvh(btQuantizedBvh::btBuildMode buildMode = btQuantizedBvh::BUILD_MEAN_SPLIT);
+
+	btQuantizedBvh::btBuildMode getBuildMode() const
+	{
+		return m_buildMode;
+	}
+
+	///collapse the quantized bvh into a 4-ary or 8-ary btQuantizedWideBvh, which is then used for all queries.
+	///It is refit together with the bvh, and rebuilt when the bvh is rebuilt (scaling, rebuildDegradedSubtrees). Returns false and keeps using the binary tree if
+	///the bvh isn't quantized or the width is not 4 or 8. A btScaledBvhTriangleMeshShape uses the wide bvh of its child shape.
+	bool buildWideBvh(int width = 4);
+
+	void clearWideBvh();
+
+	const btQuantizedWideBvh* getWideBvh() const
+	{
+		return m_wideBvh;
+	}
 
 	bool usesQuantizedAabbCompression() const
 	{
@@ -17,6 +17,7 @@ subject to the following restrictions:
 #include "btCollisionShape.h"
 #include "BulletCollision/BroadphaseCollision/btDbvt.h"
 #include "LinearMath/btSerializer.h"
+#include "LinearMath/btThreads.h"
 
 btCompoundShape::btCompoundShape(bool enableDynamicAabbTree, const int initialChildCapacity)
 	: m_localAabbMin(btScalar(BT_LARGE_FLOAT), btScalar(BT_LARGE_FLOAT), btScalar(BT_LARGE_FLOAT)),
@@ -104,6 +105,85 @@ void btCompoundShape::updateChildTransform(int childIndex, const btTransform& ne
 	}
 }
 
+///children per task of the parallel leaf update
+#define BT_COMPOUND_LEAF_GRAIN_SIZE 64
+
+static bool btUseParallelLeafUpdate(int numChildren)
+{
+#if BT_THREADSAFE
+	btITaskScheduler* scheduler = btGetTaskScheduler();
+	return numChildren > BT_COMPOUND_LEAF_GRAIN_SIZE && scheduler && scheduler->getNumThreads() > 1 && !btThreadsAreRunning();
+#else
+	(void)numChildren;
+	return false;
+#endif
+}
+
+struct btCompoundLeafUpdateLoop : public btIParallelForBody
+{
+	btCompoundShapeChild* m_children;
+	const int* m_childIndices;
+
+	btCompoundLeafUpdateLoop(btCompoundShapeChild* children, const int* childIndices)
+		: m_children(children),
+		  m_childIndices(childIndices)
+	{
+	}
+
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+	{
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			btCompoundShapeChild& child = m_children[m_childIndices[i]];
+			btVector3 localAabbMin, localAabbMax;
+			child.m_childShape->getAabb(child.m_transform, localAabbMin, localAabbMax);
+			child.m_node->volume = btDbvtVolume::FromMM(localAabbMin, localAabbMax);
+		}
+	}
+};
+
+///merges the volumes of the children of all internal nodes, bottom up
+static void btRefitDbvtNode(btDbvtNode* node)
+{
+	if (node->isinternal())
+	{
+		btRefitDbvtNode(node->childs[0]);
+		btRefitDbvtNode(node->childs[1]);
+		Merge(node->childs[0]->volume, node->childs[1]->volume, node->volume);
+	}
+}
+
+void btCompoundShape::updateChildTransforms(const int* childIndices, const btTransform* newChildTransforms, int numChildren, bool shouldRecalculateLocalAabb)
+{
+	for (int i = 0; i < numChildren; i++)
+	{
+		btAssert(childIndices[i] >= 0 && childIndices[i] < m_children.size());
+		m_children[childIndices[i]].m_transform = newChildTransforms[i];
+	}
+
+	if (m_dynamicAabbTree && numChildren > 0)
+	{
+		btCompoundLeafUpdateLoop loop(&m_children[0], childIndices);
+		if (btUseParallelLeafUpdate(numChildren))
+		{
+			btParallelFor(0, numChildren, BT_COMPOUND_LEAF_GRAIN_SIZE, loop);
+		}
+		else
+		{
+			loop.forLoop(0, numChildren);
+		}
+		if (m_dynamicAabbTree->m_root)
+		{
+			btRefitDbvtNode(m_dynamicAabbTree->m_root);
+		}
+	}
+
+	if (shouldRecalculateLocalAabb)
+	{
+		recalculateLocalAabb();
+	}
+}
+
 void btCompoundShape::removeChildShapeByIndex(int childShapeIndex)
 {
 	m_updateRevision++;
@@ -109,6 +109,11 @@ public:
 	///set a new transform for a child, and update internal data structures (local aabb and dynamic tree)
 	void updateChildTransform(int childIndex, const btTransform& newChildTransform, bool shouldRecalculateLocalAabb = true);
 
+	///set new transforms for several children (each index at most once), the leaves of the dynamic tree get their new bounds
+	///(in parallel with btParallelFor for many children) and the tree is refit and the local aabb recalculated once for all of them.
+	///The refit keeps the tree structure, call getDynamicAabbTree()->optimizeIncremental() when children moved far.
+	void updateChildTransforms(const int* childIndices, const btTransform* newChildTransforms, int numChildren, bool shouldRecalculateLocalAabb = true);
+
 	btCompoundShapeChild* getChildList()
 	{
 		return &m_children[0];
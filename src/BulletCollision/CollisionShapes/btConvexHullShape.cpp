@@ -51,6 +51,7 @@ void btConvexHullShape::setLocalScaling(const btVector3& scaling)
 void btConvexHullShape::addPoint(const btVector3& point, bool recalculateLocalAabb)
 {
 	m_unscaledPoints.push_back(point);
+	clearSupportAdjacency();
 	if (recalculateLocalAabb)
 		recalcLocalAabb();
 }
@@ -60,6 +61,12 @@ btVector3 btConvexHullShape::localGetSupportingVertexWithoutMargin(const btVecto
 	btVector3 supVec(btScalar(0.), btScalar(0.), btScalar(0.));
 	btScalar maxDot = btScalar(-BT_LARGE_FLOAT);
 
+	if (hasSupportAdjacency())
+	{
+		int supportVertex = -1;
+		return localGetSupportVertexHillClimbing(vec, supportVertex);
+	}
+
 	// Here we take advantage of dot(a, b*c) = dot(a*b, c).  Note: This is true mathematically, but not numerically.
 	if (0 < m_unscaledPoints.size())
 	{
@@ -82,6 +89,18 @@ void btConvexHullShape::batchedUnitVectorGetSupportingVertexWithoutMargin(const
 		}
 	}
 
+	if (hasSupportAdjacency())
+	{
+		//consecutive directions are often close, so each query starts from the previous support vertex
+		int supportVertex = -1;
+		for (int j = 0; j < numVectors; j++)
+		{
+			supportVerticesOut[j] = localGetSupportVertexHillClimbing(vectors[j], supportVertex);
+			supportVerticesOut[j][3] = (vectors[j] * m_localScaling).dot(m_adjacencyVertices[supportVertex]);
+		}
+		return;
+	}
+
 	for (int j = 0; j < numVectors; j++)
 	{
 		btVector3 vec = vectors[j] * m_localScaling;  // dot(a*b,c) = dot(a,b*c)
@@ -123,6 +142,138 @@ void btConvexHullShape::optimizeConvexHull()
 	{
 		m_unscaledPoints.push_back(conv.vertices[i]);
 	}
+	clearSupportAdjacency();
+}
+
+bool btConvexHullShape::initializeSupportAdjacency()
+{
+	clearSupportAdjacency();
+	if (m_unscaledPoints.size() == 0)
+		return false;
+
+	btConvexHullComputer conv;
+	conv.compute(&m_unscaledPoints[0].getX(), sizeof(btVector3), m_unscaledPoints.size(), 0.f, 0.f);
+	int numVerts = conv.vertices.size();
+	if (numVerts == 0)
+		return false;
+
+	//the hull computer rounds the vertices, so store the nearest input points to keep the
+	//support vertices identical to the ones of the linear scan
+	m_adjacencyVertices.resize(numVerts);
+	for (int i = 0; i < numVerts; i++)
+	{
+		btScalar minDist2 = BT_LARGE_FLOAT;
+		for (int j = 0; j < m_unscaledPoints.size(); j++)
+		{
+			btScalar dist2 = m_unscaledPoints[j].distance2(conv.vertices[i]);
+			if (dist2 < minDist2)
+			{
+				minDist2 = dist2;
+				m_adjacencyVertices[i] = m_unscaledPoints[j];
+			}
+		}
+	}
+
+	//each edge of the hull is stored in both directions, so the outgoing edges give all neighbors
+	m_adjacencyOffsets.resize(numVerts + 1);
+	for (int i = 0; i <= numVerts; i++)
+	{
+		m_adjacencyOffsets[i] = 0;
+	}
+	for (int i = 0; i < conv.edges.size(); i++)
+	{
+		m_adjacencyOffsets[conv.edges[i].getSourceVertex() + 1]++;
+	}
+	for (int i = 0; i < numVerts; i++)
+	{
+		m_adjacencyOffsets[i + 1] += m_adjacencyOffsets[i];
+	}
+	btAlignedObjectArray<int> fill;
+	fill.resize(numVerts);
+	for (int i = 0; i < numVerts; i++)
+	{
+		fill[i] = m_adjacencyOffsets[i];
+	}
+	m_adjacencyNeighbors.resize(conv.edges.size());
+	for (int i = 0; i < conv.edges.size(); i++)
+	{
+		const btConvexHullComputer::Edge& edge = conv.edges[i];
+		m_adjacencyNeighbors[fill[edge.getSourceVertex()]++] = edge.getTargetVertex();
+	}
+
+	//start vertices at the extremes along the axes, a cold query starts at the best of them
+	for (int axis = 0; axis < 3; axis++)
+	{
+		int minIndex = 0;
+		int maxIndex = 0;
+		for (int i = 1; i < numVerts; i++)
+		{
+			if (m_adjacencyVertices[i][axis] < m_adjacencyVertices[minIndex][axis])
+				minIndex = i;
+			if (m_adjacencyVertices[i][axis] > m_adjacencyVertices[maxIndex][axis])
+				maxIndex = i;
+		}
+		m_adjacencyStartVertices[axis * 2] = minIndex;
+		m_adjacencyStartVertices[axis * 2 + 1] = maxIndex;
+	}
+	return true;
+}
+
+void btConvexHullShape::clearSupportAdjacency()
+{
+	m_adjacencyVertices.clear();
+	m_adjacencyOffsets.clear();
+	m_adjacencyNeighbors.clear();
+}
+
+btVector3 btConvexHullShape::localGetSupportVertexHillClimbing(const btVector3& vec, int& supportVertex) const
+{
+	btAssert(hasSupportAdjacency());
+	// dot(a, b*c) = dot(a*b, c), like the linear scan
+	btVector3 scaled = vec * m_localScaling;
+
+	int current = supportVertex;
+	btScalar maxDot;
+	if (current < 0 || current >= m_adjacencyVertices.size())
+	{
+		current = m_adjacencyStartVertices[0];
+		maxDot = scaled.dot(m_adjacencyVertices[current]);
+		for (int i = 1; i < 6; i++)
+		{
+			btScalar dot = scaled.dot(m_adjacencyVertices[m_adjacencyStartVertices[i]]);
+			if (dot > maxDot)
+			{
+				maxDot = dot;
+				current = m_adjacencyStartVertices[i];
+			}
+		}
+	}
+	else
+	{
+		maxDot = scaled.dot(m_adjacencyVertices[current]);
+	}
+
+	//a vertex of a convex polytope without a better neighbor is the global maximum of a linear function
+	for (;;)
+	{
+		int best = current;
+		for (int i = m_adjacencyOffsets[current]; i < m_adjacencyOffsets[current + 1]; i++)
+		{
+			int neighbor = m_adjacencyNeighbors[i];
+			btScalar dot = scaled.dot(m_adjacencyVertices[neighbor]);
+			if (dot > maxDot)
+			{
+				maxDot = dot;
+				best = neighbor;
+			}
+		}
+		if (best == current)
+			break;
+		current = best;
+	}
+
+	supportVertex = current;
+	return m_adjacencyVertices[current] * m_localScaling;
 }
 
 //currently just for debugging (drawing), perhaps future support for algebraic continuous collision detection
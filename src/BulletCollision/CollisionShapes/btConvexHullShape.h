@@ -28,6 +28,13 @@ btConvexHullShape : public btPolyhedralConvexAabbCachingShape
 protected:
 	btAlignedObjectArray<btVector3> m_unscaledPoints;
 
+	//optional vertex adjacency of the hull, see initializeSupportAdjacency. The neighbors of hull vertex i
+	//are m_adjacencyNeighbors[m_adjacencyOffsets[i]] up to m_adjacencyNeighbors[m_adjacencyOffsets[i+1]]
+	btAlignedObjectArray<btVector3> m_adjacencyVertices;
+	btAlignedObjectArray<int> m_adjacencyOffsets;
+	btAlignedObjectArray<int> m_adjacencyNeighbors;
+	int m_adjacencyStartVertices[6];
+
 public:
 	BT_DECLARE_ALIGNED_ALLOCATOR();
 
@@ -56,6 +63,21 @@ public:
 
 	void optimizeConvexHull();
 
+	///initializeSupportAdjacency computes the convex hull of the points and keeps its vertex adjacency graph.
+	///The support mapping then climbs the graph from a start vertex instead of scanning all points, which is
+	///much faster for hulls with more than a few dozen points. addPoint and optimizeConvexHull drop the graph.
+	bool initializeSupportAdjacency();
+	void clearSupportAdjacency();
+
+	bool hasSupportAdjacency() const
+	{
+		return m_adjacencyVertices.size() > 0;
+	}
+
+	///support vertex without margin, by steepest ascent over the adjacency graph. supportVertex is the hull vertex
+	///to start from (or -1) and returns the support vertex, so the next query of the same pair can warm start from it
+	btVector3 localGetSupportVertexHillClimbing(const btVector3& vec, int& supportVertex) const;
+
 	SIMD_FORCE_INLINE btVector3 getScaledPoint(int i) const
 	{
 		return m_unscaledPoints[i] * m_localScaling;
@@ -105,6 +105,8 @@ bool btConvexPolyhedron::testContainment() const
 void btConvexPolyhedron::initialize()
 {
 	btHashMap<btInternalVertexPair, btInternalEdge> edges;
+	m_edges.resize(0);
+	bool manifold = true;
 
 	for (int i = 0; i < m_faces.size(); i++)
 	{
@@ -139,6 +141,8 @@ void btConvexPolyhedron::initialize()
 			{
 				btAssert(edptr->m_face0 >= 0);
 				btAssert(edptr->m_face1 < 0);
+				if (edptr->m_face1 >= 0)
+					manifold = false;
 				edptr->m_face1 = i;
 			}
 			else
@@ -150,6 +154,27 @@ void btConvexPolyhedron::initialize()
 		}
 	}
 
+	for (int i = 0; i < edges.size() && manifold; i++)
+	{
+		const btInternalVertexPair vp = edges.getKeyAtIndex(i);
+		const btInternalEdge& ed = *edges.getAtIndex(i);
+		if (ed.m_face1 < 0)
+		{
+			manifold = false;
+			break;
+		}
+		btPolyhedronEdge edge;
+		edge.m_vertex0 = vp.m_v0;
+		edge.m_vertex1 = vp.m_v1;
+		edge.m_face0 = ed.m_face0;
+		edge.m_face1 = ed.m_face1;
+		m_edges.push_back(edge);
+	}
+	if (!manifold)
+	{
+		m_edges.resize(0);
+	}
+
 #ifdef USE_CONNECTED_FACES
 	for (int i = 0; i < m_faces.size(); i++)
 	{
@@ -279,20 +304,19 @@ void btConvexPolyhedron::project(const btTransform& trans, const btVector3& dir,
 	minProj = FLT_MAX;
 	maxProj = -FLT_MAX;
 	int numVerts = m_vertices.size();
-	for (int i = 0; i < numVerts; i++)
+	if (numVerts)
 	{
-		btVector3 pt = trans * m_vertices[i];
-		btScalar dp = pt.dot(dir);
-		if (dp < minProj)
-		{
-			minProj = dp;
-			witnesPtMin = pt;
-		}
-		if (dp > maxProj)
-		{
-			maxProj = dp;
-			witnesPtMax = pt;
-		}
+		//project the local vertices on the local direction, so minDot/maxDot can use SIMD,
+		//and only transform the two witness points
+		const btVector3 localDir = dir * trans.getBasis();
+		const btScalar offset = dir.dot(trans.getOrigin());
+		btScalar minDot, maxDot;
+		long minIndex = localDir.minDot(&m_vertices[0], numVerts, minDot);
+		long maxIndex = localDir.maxDot(&m_vertices[0], numVerts, maxDot);
+		minProj = minDot + offset;
+		maxProj = maxDot + offset;
+		witnesPtMin = trans * m_vertices[minIndex];
+		witnesPtMax = trans * m_vertices[maxIndex];
 	}
 	if (minProj > maxProj)
 	{
@@ -30,6 +30,15 @@ struct btFace
 	btScalar m_plane[4];
 };
 
+///btPolyhedronEdge is an edge of the polyhedron with the two faces it separates, its Gauss map arc
+struct btPolyhedronEdge
+{
+	int m_vertex0;
+	int m_vertex1;
+	int m_face0;
+	int m_face1;
+};
+
 ATTRIBUTE_ALIGNED16(class)
 btConvexPolyhedron
 {
@@ -42,6 +51,9 @@ public:
 	btAlignedObjectArray<btVector3> m_vertices;
 	btAlignedObjectArray<btFace> m_faces;
 	btAlignedObjectArray<btVector3> m_uniqueEdges;
+	///edges with their adjacent faces, for the Gauss map edge pruning of btPolyhedralContactClipping.
+	///initialize leaves it empty if an edge doesn't have exactly two faces
+	btAlignedObjectArray<btPolyhedronEdge> m_edges;
 
 	btVector3 m_localCenter;
 	btVector3 m_extents;
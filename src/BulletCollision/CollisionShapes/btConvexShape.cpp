@@ -287,6 +287,11 @@ btVector3 btConvexShape::localGetSupportVertexWithoutMarginNonVirtual(const btVe
 		case CONVEX_HULL_SHAPE_PROXYTYPE:
 		{
 			btConvexHullShape* convexHullShape = (btConvexHullShape*)this;
+			if (convexHullShape->hasSupportAdjacency())
+			{
+				int supportVertex = -1;
+				return convexHullShape->localGetSupportVertexHillClimbing(localDir, supportVertex);
+			}
 			btVector3* points = convexHullShape->getUnscaledPoints();
 			int numPoints = convexHullShape->getNumPoints();
 			return convexHullSupport(localDir, points, numPoints, convexHullShape->getLocalScalingNV());
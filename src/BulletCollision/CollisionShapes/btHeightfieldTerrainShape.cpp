@@ -95,6 +95,15 @@ btHeightfieldTerrainShape::btHeightfieldTerrainShape(int heightStickWidth, int h
 			   flipQuadEdges);
 }
 
+btHeightfieldTerrainShape::btHeightfieldTerrainShape(int heightStickWidth, int heightStickLength, btScalar minHeight, btScalar maxHeight, int upAxis, bool flipQuadEdges)
+	: m_userValue3(0),
+	  m_triangleInfoMap(0)
+{
+	initialize(heightStickWidth, heightStickLength, 0,
+			   /*heightScale=*/1, minHeight, maxHeight, upAxis, PHY_FLOAT,
+			   flipQuadEdges);
+}
+
 void btHeightfieldTerrainShape::initialize(
 	int heightStickWidth, int heightStickLength, const void* heightfieldData,
 	btScalar heightScale, btScalar minHeight, btScalar maxHeight, int upAxis,
@@ -103,7 +112,7 @@ void btHeightfieldTerrainShape::initialize(
 	// validation
 	btAssert(heightStickWidth > 1);   // && "bad width");
 	btAssert(heightStickLength > 1);  // && "bad length");
-	btAssert(heightfieldData);        // && "null heightfield data");
+	// heightfieldData is null for subclasses that override getRawHeightFieldValue
 	// btAssert(heightScale) -- do we care?  Trust caller here
 	btAssert(minHeight <= maxHeight);                                    // && "bad min/max height");
 	btAssert(upAxis >= 0 && upAxis < 3);                                 // && "bad upAxis--should be in range [0,2]");
@@ -237,8 +246,11 @@ void btHeightfieldTerrainShape::getVertex(int x, int y, btVector3& vertex) const
 	btAssert(x < m_heightStickWidth);
 	btAssert(y < m_heightStickLength);
 
-	btScalar height = getRawHeightFieldValue(x, y);
+	getVertexAtRawHeight(x, y, getRawHeightFieldValue(x, y), vertex);
+}
 
+void btHeightfieldTerrainShape::getVertexAtRawHeight(int x, int y, btScalar height, btVector3& vertex) const
+{
 	switch (m_upAxis)
 	{
 		case 0:
@@ -411,70 +423,126 @@ void btHeightfieldTerrainShape::processAllTriangles(btTriangleCallback* callback
 		}
 	}
 
-	// TODO If m_vboundsGrid is available, use it to determine if we really need to process this area
-	
 	const Range aabbUpRange(aabbMin[m_upAxis], aabbMax[m_upAxis]);
+	if (m_vboundsLevelOffsets.size() && startX < endX && startJ < endJ)
+	{
+		// the pyramid holds raw heights, widened a little so it never culls a triangle the exact test would keep
+		const btScalar slack = (btFabs(localAabbMin[m_upAxis]) + btFabs(localAabbMax[m_upAxis]) + btScalar(1.)) * btScalar(1e-5);
+		const Range rawUpRange(btMin(localAabbMin[m_upAxis], localAabbMax[m_upAxis]) - slack, btMax(localAabbMin[m_upAxis], localAabbMax[m_upAxis]) + slack);
+		const int cellMin[2] = {startX, startJ};
+		const int cellMax[2] = {endX - 1, endJ - 1};
+		processVBoundsNode(callback, m_vboundsLevelOffsets.size() - 1, 0, 0, cellMin, cellMax, rawUpRange, aabbUpRange);
+		return;
+	}
+
 	for (int j = startJ; j < endJ; j++)
 	{
 		for (int x = startX; x < endX; x++)
 		{
-			btVector3 vertices[3];
-			int indices[3] = { 0, 1, 2 };
-			if (m_flipTriangleWinding)
-			{
-				indices[0] = 2;
-				indices[2] = 0;
-			}
+			processQuad(callback, x, j, aabbUpRange);
+		}
+	}
+}
 
-			if (m_flipQuadEdges || (m_useDiamondSubdivision && !((j + x) & 1)) || (m_useZigzagSubdivision && !(j & 1)))
-			{
-				getVertex(x, j, vertices[indices[0]]);
-				getVertex(x, j + 1, vertices[indices[1]]);
-				getVertex(x + 1, j + 1, vertices[indices[2]]);
+void btHeightfieldTerrainShape::processQuad(btTriangleCallback* callback, int x, int j, const Range& aabbUpRange) const
+{
+	btVector3 vertices[3];
+	int indices[3] = { 0, 1, 2 };
+	if (m_flipTriangleWinding)
+	{
+		indices[0] = 2;
+		indices[2] = 0;
+	}
 
-				// Skip triangle processing if the triangle is out-of-AABB.
-				Range upRange = minmaxRange(vertices[0][m_upAxis], vertices[1][m_upAxis], vertices[2][m_upAxis]);
+	if (m_flipQuadEdges || (m_useDiamondSubdivision && !((j + x) & 1)) || (m_useZigzagSubdivision && !(j & 1)))
+	{
+		getVertex(x, j, vertices[indices[0]]);
+		getVertex(x, j + 1, vertices[indices[1]]);
+		getVertex(x + 1, j + 1, vertices[indices[2]]);
 
-				if (upRange.overlaps(aabbUpRange))
-					callback->processTriangle(vertices, 2 * x, j);
-			
-				// already set: getVertex(x, j, vertices[indices[0]])
+		// Skip triangle processing if the triangle is out-of-AABB.
+		Range upRange = minmaxRange(vertices[0][m_upAxis], vertices[1][m_upAxis], vertices[2][m_upAxis]);
 
-				// equivalent to: getVertex(x + 1, j + 1, vertices[indices[1]]);
-				vertices[indices[1]] = vertices[indices[2]];
+		if (upRange.overlaps(aabbUpRange))
+			callback->processTriangle(vertices, 2 * x, j);
 
-				getVertex(x + 1, j, vertices[indices[2]]);
-				upRange.min = btMin(upRange.min, vertices[indices[2]][m_upAxis]);
-				upRange.max = btMax(upRange.max, vertices[indices[2]][m_upAxis]);
+		// already set: getVertex(x, j, vertices[indices[0]])
 
-				if (upRange.overlaps(aabbUpRange))
-					callback->processTriangle(vertices, 2 * x + 1, j);
-			}
-			else
-			{
-				getVertex(x, j, vertices[indices[0]]);
-				getVertex(x, j + 1, vertices[indices[1]]);
-				getVertex(x + 1, j, vertices[indices[2]]);
+		// equivalent to: getVertex(x + 1, j + 1, vertices[indices[1]]);
+		vertices[indices[1]] = vertices[indices[2]];
+
+		getVertex(x + 1, j, vertices[indices[2]]);
+		upRange.min = btMin(upRange.min, vertices[indices[2]][m_upAxis]);
+		upRange.max = btMax(upRange.max, vertices[indices[2]][m_upAxis]);
+
+		if (upRange.overlaps(aabbUpRange))
+			callback->processTriangle(vertices, 2 * x + 1, j);
+	}
+	else
+	{
+		getVertex(x, j, vertices[indices[0]]);
+		getVertex(x, j + 1, vertices[indices[1]]);
+		getVertex(x + 1, j, vertices[indices[2]]);
 
-				// Skip triangle processing if the triangle is out-of-AABB.
-				Range upRange = minmaxRange(vertices[0][m_upAxis], vertices[1][m_upAxis], vertices[2][m_upAxis]);
+		// Skip triangle processing if the triangle is out-of-AABB.
+		Range upRange = minmaxRange(vertices[0][m_upAxis], vertices[1][m_upAxis], vertices[2][m_upAxis]);
 
-				if (upRange.overlaps(aabbUpRange))
-					callback->processTriangle(vertices, 2 * x, j);
+		if (upRange.overlaps(aabbUpRange))
+			callback->processTriangle(vertices, 2 * x, j);
 
-				// already set: getVertex(x, j + 1, vertices[indices[1]]);
+		// already set: getVertex(x, j + 1, vertices[indices[1]]);
 
-				// equivalent to: getVertex(x + 1, j, vertices[indices[0]]);
-				vertices[indices[0]] = vertices[indices[2]];
+		// equivalent to: getVertex(x + 1, j, vertices[indices[0]]);
+		vertices[indices[0]] = vertices[indices[2]];
 
-				getVertex(x + 1, j + 1, vertices[indices[2]]);
-				upRange.min = btMin(upRange.min, vertices[indices[2]][m_upAxis]);
-				upRange.max = btMax(upRange.max, vertices[indices[2]][m_upAxis]);
+		getVertex(x + 1, j + 1, vertices[indices[2]]);
+		upRange.min = btMin(upRange.min, vertices[indices[2]][m_upAxis]);
+		upRange.max = btMax(upRange.max, vertices[indices[2]][m_upAxis]);
 
-				if (upRange.overlaps(aabbUpRange))
-					callback->processTriangle(vertices, 2 * x + 1, j);
+		if (upRange.overlaps(aabbUpRange))
+			callback->processTriangle(vertices, 2 * x + 1, j);
+	}
+}
+
+/// Descends the accelerator pyramid, skipping the nodes outside the cell range or the raw height range of the query
+void btHeightfieldTerrainShape::processVBoundsNode(btTriangleCallback* callback, int level, int nodeX, int nodeZ, const int* cellMin, const int* cellMax,
+												   const Range& rawUpRange, const Range& aabbUpRange) const
+{
+	const int size = m_vboundsChunkSize << level;
+	const int x0 = nodeX * size;
+	const int z0 = nodeZ * size;
+	if (x0 > cellMax[0] || x0 + size <= cellMin[0] || z0 > cellMax[1] || z0 + size <= cellMin[1])
+	{
+		return;
+	}
+	const int levelWidth = (m_vboundsGridWidth + (1 << level) - 1) >> level;
+	if (!m_vboundsGrid[m_vboundsLevelOffsets[level] + nodeZ * levelWidth + nodeX].overlaps(rawUpRange))
+	{
+		return;
+	}
+	if (level == 0)
+	{
+		const int startX = btMax(x0, cellMin[0]);
+		const int endX = btMin(x0 + size - 1, cellMax[0]);
+		const int startJ = btMax(z0, cellMin[1]);
+		const int endJ = btMin(z0 + size - 1, cellMax[1]);
+		for (int j = startJ; j <= endJ; j++)
+		{
+			for (int x = startX; x <= endX; x++)
+			{
+				processQuad(callback, x, j, aabbUpRange);
 			}
 		}
+		return;
+	}
+	const int childWidth = (m_vboundsGridWidth + (1 << (level - 1)) - 1) >> (level - 1);
+	const int childLength = (m_vboundsGridLength + (1 << (level - 1)) - 1) >> (level - 1);
+	for (int childZ = 2 * nodeZ; childZ < btMin(2 * nodeZ + 2, childLength); childZ++)
+	{
+		for (int childX = 2 * nodeX; childX < btMin(2 * nodeX + 2, childWidth); childX++)
+		{
+			processVBoundsNode(callback, level - 1, childX, childZ, cellMin, cellMax, rawUpRange, aabbUpRange);
+		}
 	}
 }
 
@@ -706,70 +774,89 @@ struct ProcessTrianglesAction
 	}
 };
 
-struct ProcessVBoundsAction
+static inline bool clipRayToSlab(btScalar from, btScalar delta, btScalar slabMin, btScalar slabMax, btScalar& lambdaMin, btScalar& lambdaMax)
+{
+	if (delta == btScalar(0.))
+	{
+		return from >= slabMin && from <= slabMax;
+	}
+	btScalar lambda0 = (slabMin - from) / delta;
+	btScalar lambda1 = (slabMax - from) / delta;
+	if (lambda0 > lambda1)
+	{
+		btSwap(lambda0, lambda1);
+	}
+	lambdaMin = btMax(lambdaMin, lambda0);
+	lambdaMax = btMin(lambdaMax, lambda1);
+	return lambdaMin <= lambdaMax;
+}
+
+// node bounds are widened by this many cells, or raw height units, so rounding never drops a cell the ray touches
+#define BT_HEIGHTFIELD_VBOUNDS_EPSILON btScalar(1e-3)
+
+/// Descends the min/max pyramid along the ray, and marches the cells of the chunks whose bounds the ray crosses
+struct ProcessVBoundsPyramidAction
 {
 	const btAlignedObjectArray<btHeightfieldTerrainShape::Range>& vbounds;
-	int width;
-	int length;
+	const btAlignedObjectArray<int>& levelOffsets;
+	int gridWidth;
+	int gridLength;
 	int chunkSize;
 
 	btVector3 rayBegin;
-	btVector3 rayEnd;
-	btVector3 rayDir;
+	btVector3 rayDelta;
 
 	int* m_indices;
 	ProcessTrianglesAction processTriangles;
 
-	ProcessVBoundsAction(const btAlignedObjectArray<btHeightfieldTerrainShape::Range>& bnd, int* indices)
+	ProcessVBoundsPyramidAction(const btAlignedObjectArray<btHeightfieldTerrainShape::Range>& bnd, const btAlignedObjectArray<int>& offsets, int* indices)
 		: vbounds(bnd),
-		m_indices(indices)
+		  levelOffsets(offsets),
+		  m_indices(indices)
 	{
 	}
-	void operator()(const GridRaycastState& rs) const
-	{
-		int x = rs.prev_x;
-		int z = rs.prev_z;
 
-		if (x < 0 || z < 0 || x >= width || z >= length)
+	void descend(int level, int nodeX, int nodeZ, btScalar lambdaMin, btScalar lambdaMax) const
+	{
+		const int levelWidth = (gridWidth + (1 << level) - 1) >> level;
+		const btHeightfieldTerrainShape::Range& range = vbounds[levelOffsets[level] + nodeZ * levelWidth + nodeX];
+		const int size = chunkSize << level;
+		const btScalar x0 = btScalar(nodeX * size) - BT_HEIGHTFIELD_VBOUNDS_EPSILON;
+		const btScalar z0 = btScalar(nodeZ * size) - BT_HEIGHTFIELD_VBOUNDS_EPSILON;
+		const btScalar x1 = btScalar(btMin((nodeX + 1) * size, processTriangles.width)) + BT_HEIGHTFIELD_VBOUNDS_EPSILON;
+		const btScalar z1 = btScalar(btMin((nodeZ + 1) * size, processTriangles.length)) + BT_HEIGHTFIELD_VBOUNDS_EPSILON;
+		if (!clipRayToSlab(rayBegin[m_indices[0]], rayDelta[m_indices[0]], x0, x1, lambdaMin, lambdaMax) ||
+			!clipRayToSlab(rayBegin[m_indices[2]], rayDelta[m_indices[2]], z0, z1, lambdaMin, lambdaMax) ||
+			!clipRayToSlab(rayBegin[m_indices[1]], rayDelta[m_indices[1]], range.min - BT_HEIGHTFIELD_VBOUNDS_EPSILON, range.max + BT_HEIGHTFIELD_VBOUNDS_EPSILON, lambdaMin, lambdaMax))
 		{
 			return;
 		}
 
-		const btHeightfieldTerrainShape::Range chunk = vbounds[x + z * width];
-
-		btVector3 enterPos;
-		btVector3 exitPos;
-
-		if (rs.maxDistanceFlat > 0.0001)
+		if (level == 0)
 		{
-			btScalar flatTo3d = chunkSize * rs.maxDistance3d / rs.maxDistanceFlat;
-			btScalar enterParam3d = rs.prevParam * flatTo3d;
-			btScalar exitParam3d = rs.param * flatTo3d;
-			enterPos = rayBegin + rayDir * enterParam3d;
-			exitPos = rayBegin + rayDir * exitParam3d;
-
-			// We did enter the flat projection of the AABB,
-			// but we have to check if we intersect it on the vertical axis
-			if (enterPos[1] > chunk.max && exitPos[m_indices[1]] > chunk.max)
+			const btVector3 enterPos = rayBegin + rayDelta * lambdaMin;
+			const btVector3 exitPos = rayBegin + rayDelta * lambdaMax;
+			if (enterPos.distance2(exitPos) < btScalar(0.0001 * 0.0001))
 			{
-				return;
+				// gridRaycast ignores tiny segments, but this one may be the end of a longer ray
+				processTriangles.exec(static_cast<int>(floor(enterPos[m_indices[0]])), static_cast<int>(floor(enterPos[m_indices[2]])));
 			}
-			if (enterPos[1] < chunk.min && exitPos[m_indices[1]] < chunk.min)
+			else
 			{
-				return;
+				gridRaycast(processTriangles, enterPos, exitPos, m_indices);
 			}
+			return;
 		}
-		else
+
+		const int childWidth = (gridWidth + (1 << (level - 1)) - 1) >> (level - 1);
+		const int childLength = (gridLength + (1 << (level - 1)) - 1) >> (level - 1);
+		for (int childZ = 2 * nodeZ; childZ < btMin(2 * nodeZ + 2, childLength); childZ++)
 		{
-			// Consider the ray vertical
-			// (though we shouldn't reach this often because there is an early check up-front)
-			enterPos = rayBegin;
-			exitPos = rayEnd;
+			for (int childX = 2 * nodeX; childX < btMin(2 * nodeX + 2, childWidth); childX++)
+			{
+				descend(level - 1, childX, childZ, lambdaMin, lambdaMax);
+			}
 		}
-
-		gridRaycast(processTriangles, enterPos, exitPos, m_indices);
-		// Note: it could be possible to have more than one grid at different levels,
-		// to do this there would be a branch using a pointer to another ProcessVBoundsAction
 	}
 };
 
@@ -792,9 +879,14 @@ void btHeightfieldTerrainShape::performRaycast(btTriangleCallback* callback, con
 	processTriangles.width = m_heightStickWidth - 1;
 	processTriangles.length = m_heightStickLength - 1;
 
-	// TODO Transform vectors to account for m_upAxis
+	// indices of the grid x axis, the up axis and the grid z axis
 	int indices[3] = { 0, 1, 2 };
-	if (m_upAxis == 2)
+	if (m_upAxis == 0)
+	{
+		indices[0] = 1;
+		indices[1] = 0;
+	}
+	else if (m_upAxis == 2)
 	{
 		indices[1] = 2;
 		indices[2] = 1;
@@ -815,7 +907,7 @@ void btHeightfieldTerrainShape::performRaycast(btTriangleCallback* callback, con
 
 	
 
-	if (m_vboundsGrid.size()==0)
+	if (m_vboundsLevelOffsets.size() == 0)
 	{
 		// Process all quads intersecting the flat projection of the ray
 		gridRaycast(processTriangles, beginPos, endPos, &indices[0]);
@@ -831,22 +923,22 @@ void btHeightfieldTerrainShape::performRaycast(btTriangleCallback* callback, con
 			return;
 		}
 
-		ProcessVBoundsAction processVBounds(m_vboundsGrid, &indices[0]);
-		processVBounds.width = m_vboundsGridWidth;
-		processVBounds.length = m_vboundsGridLength;
+		ProcessVBoundsPyramidAction processVBounds(m_vboundsGrid, m_vboundsLevelOffsets, &indices[0]);
+		processVBounds.gridWidth = m_vboundsGridWidth;
+		processVBounds.gridLength = m_vboundsGridLength;
+		processVBounds.chunkSize = m_vboundsChunkSize;
 		processVBounds.rayBegin = beginPos;
-		processVBounds.rayEnd = endPos;
-		processVBounds.rayDir = rayDiff.normalized();
+		processVBounds.rayDelta = rayDiff;
 		processVBounds.processTriangles = processTriangles;
-		processVBounds.chunkSize = m_vboundsChunkSize;
-		// The ray is long, run raycast on a higher-level grid
-		gridRaycast(processVBounds, beginPos / m_vboundsChunkSize, endPos / m_vboundsChunkSize, indices);
+		// The ray is long, descend the pyramid from the node covering the whole terrain
+		processVBounds.descend(m_vboundsLevelOffsets.size() - 1, 0, 0, btScalar(0.), btScalar(1.));
 	}
 }
 
-/// Builds a grid data structure storing the min and max heights of the terrain in chunks.
+/// Builds a grid data structure storing the min and max heights of the terrain in chunks,
+/// and a pyramid merging 2x2 chunks level by level up to a single node.
 /// if chunkSize is zero, that accelerator is removed.
-/// If you modify the heights, you need to rebuild this accelerator.
+/// If you modify the heights, you need to rebuild this accelerator, or update the modified area with updateAccelerator.
 void btHeightfieldTerrainShape::buildAccelerator(int chunkSize)
 {
 	if (chunkSize <= 0)
@@ -880,72 +972,150 @@ void btHeightfieldTerrainShape::buildAccelerator(int chunkSize)
 		return;
 	}
 
+	// The chunks are followed by the levels of the pyramid, the last one is a single node
+	m_vboundsLevelOffsets.resize(0);
+	m_vboundsLevelOffsets.push_back(0);
+	int numNodes = nChunksX * nChunksZ;
+	for (int levelWidth = nChunksX, levelLength = nChunksZ; levelWidth > 1 || levelLength > 1;)
+	{
+		levelWidth = (levelWidth + 1) / 2;
+		levelLength = (levelLength + 1) / 2;
+		m_vboundsLevelOffsets.push_back(numNodes);
+		numNodes += levelWidth * levelLength;
+	}
+
 	// This data structure is only reallocated if the required size changed
-	m_vboundsGrid.resize(nChunksX * nChunksZ);
-	
-	// Compute min and max height for all chunks
+	m_vboundsGrid.resize(numNodes);
+
 	for (int cz = 0; cz < nChunksZ; ++cz)
 	{
-		int z0 = cz * chunkSize;
-
 		for (int cx = 0; cx < nChunksX; ++cx)
 		{
-			int x0 = cx * chunkSize;
-
-			Range r;
-
-			r.min = getRawHeightFieldValue(x0, z0);
-			r.max = r.min;
-
-			// Compute min and max height for this chunk.
-			// We have to include one extra cell to account for neighbors.
-			// Here is why:
-			// Say we have a flat terrain, and a plateau that fits a chunk perfectly.
-			//
-			//   Left        Right
-			// 0---0---0---1---1---1
-			// |   |   |   |   |   |
-			// 0---0---0---1---1---1
-			// |   |   |   |   |   |
-			// 0---0---0---1---1---1
-			//           x
-			//
-			// If the AABB for the Left chunk did not share vertices with the Right,
-			// then we would fail collision tests at x due to a gap.
-			//
-			for (int z = z0; z < z0 + chunkSize + 1; ++z)
+			updateVBoundsChunk(cx, cz);
+		}
+	}
+	updateVBoundsPyramid(0, 0, nChunksX - 1, nChunksZ - 1);
+}
+
+void btHeightfieldTerrainShape::updateAccelerator(int startX, int startY, int endX, int endY)
+{
+	if (m_vboundsLevelOffsets.size() == 0)
+	{
+		return;
+	}
+
+	// a sample on a chunk border belongs to the chunks on both sides
+	const int cxMin = btMax(startX - 1, 0) / m_vboundsChunkSize;
+	const int czMin = btMax(startY - 1, 0) / m_vboundsChunkSize;
+	const int cxMax = btMin(endX / m_vboundsChunkSize, m_vboundsGridWidth - 1);
+	const int czMax = btMin(endY / m_vboundsChunkSize, m_vboundsGridLength - 1);
+	for (int cz = czMin; cz <= czMax; ++cz)
+	{
+		for (int cx = cxMin; cx <= cxMax; ++cx)
+		{
+			updateVBoundsChunk(cx, cz);
+		}
+	}
+	updateVBoundsPyramid(cxMin, czMin, cxMax, czMax);
+}
+
+/// Computes the min and max height of a chunk
+void btHeightfieldTerrainShape::updateVBoundsChunk(int cx, int cz)
+{
+	const int chunkSize = m_vboundsChunkSize;
+	const int x0 = cx * chunkSize;
+	const int z0 = cz * chunkSize;
+
+	Range r;
+
+	r.min = getRawHeightFieldValue(btMin(x0, m_heightStickWidth - 1), btMin(z0, m_heightStickLength - 1));
+	r.max = r.min;
+
+	// Compute min and max height for this chunk.
+	// We have to include one extra cell to account for neighbors.
+	// Here is why:
+	// Say we have a flat terrain, and a plateau that fits a chunk perfectly.
+	//
+	//   Left        Right
+	// 0---0---0---1---1---1
+	// |   |   |   |   |   |
+	// 0---0---0---1---1---1
+	// |   |   |   |   |   |
+	// 0---0---0---1---1---1
+	//           x
+	//
+	// If the AABB for the Left chunk did not share vertices with the Right,
+	// then we would fail collision tests at x due to a gap.
+	//
+	for (int z = z0; z < z0 + chunkSize + 1; ++z)
+	{
+		if (z >= m_heightStickLength)
+		{
+			continue;
+		}
+
+		for (int x = x0; x < x0 + chunkSize + 1; ++x)
+		{
+			if (x >= m_heightStickWidth)
 			{
-				if (z >= m_heightStickLength)
-				{
-					continue;
-				}
+				continue;
+			}
 
-				for (int x = x0; x < x0 + chunkSize + 1; ++x)
-				{
-					if (x >= m_heightStickWidth)
-					{
-						continue;
-					}
+			btScalar height = getRawHeightFieldValue(x, z);
 
-					btScalar height = getRawHeightFieldValue(x, z);
+			if (height < r.min)
+			{
+				r.min = height;
+			}
+			else if (height > r.max)
+			{
+				r.max = height;
+			}
+		}
+	}
 
-					if (height < r.min)
-					{
-						r.min = height;
-					}
-					else if (height > r.max)
+	m_vboundsGrid[cx + cz * m_vboundsGridWidth] = r;
+}
+
+/// Merges the 2x2 child nodes of the pyramid levels above the given chunks
+void btHeightfieldTerrainShape::updateVBoundsPyramid(int cxMin, int czMin, int cxMax, int czMax)
+{
+	int childWidth = m_vboundsGridWidth;
+	int childLength = m_vboundsGridLength;
+	for (int level = 1; level < m_vboundsLevelOffsets.size(); level++)
+	{
+		const int levelWidth = (childWidth + 1) / 2;
+		const int levelLength = (childLength + 1) / 2;
+		const Range* children = &m_vboundsGrid[m_vboundsLevelOffsets[level - 1]];
+		Range* nodes = &m_vboundsGrid[m_vboundsLevelOffsets[level]];
+		cxMin >>= 1;
+		czMin >>= 1;
+		cxMax >>= 1;
+		czMax >>= 1;
+		for (int nz = czMin; nz <= czMax; nz++)
+		{
+			for (int nx = cxMin; nx <= cxMax; nx++)
+			{
+				Range r = children[2 * nz * childWidth + 2 * nx];
+				for (int z = 2 * nz; z < btMin(2 * nz + 2, childLength); z++)
+				{
+					for (int x = 2 * nx; x < btMin(2 * nx + 2, childWidth); x++)
 					{
-						r.max = height;
+						const Range& child = children[z * childWidth + x];
+						r.min = btMin(r.min, child.min);
+						r.max = btMax(r.max, child.max);
 					}
 				}
+				nodes[nz * levelWidth + nx] = r;
 			}
-
-			m_vboundsGrid[cx + cz * nChunksX] = r;
 		}
+		childWidth = levelWidth;
+		childLength = levelLength;
 	}
 }
 
 void btHeightfieldTerrainShape::clearAccelerator()
 {
 	m_vboundsGrid.clear();
+	m_vboundsLevelOffsets.clear();
 }
@@ -115,8 +115,10 @@ protected:
 
 	btVector3 m_localScaling;
 
-	// Accelerator
+	// Accelerator: min/max raw height of chunks of m_vboundsChunkSize cells, followed by the levels of the pyramid
+	// merging 2x2 nodes up to a single node over the whole terrain
 	btAlignedObjectArray<Range> m_vboundsGrid;
+	btAlignedObjectArray<int> m_vboundsLevelOffsets;
 	int m_vboundsGridWidth;
 	int m_vboundsGridLength;
 	int m_vboundsChunkSize;
@@ -129,6 +131,17 @@ protected:
 	virtual btScalar getRawHeightFieldValue(int x, int y) const;
 	void quantizeWithClamp(int* out, const btVector3& point, int isMax) const;
 
+	///reports the two triangles of the cell at x, j that overlap aabbUpRange
+	void processQuad(btTriangleCallback * callback, int x, int j, const Range& aabbUpRange) const;
+
+	void updateVBoundsChunk(int cx, int cz);
+	void updateVBoundsPyramid(int cxMin, int czMin, int cxMax, int czMax);
+	void processVBoundsNode(btTriangleCallback * callback, int level, int nodeX, int nodeZ, const int* cellMin, const int* cellMax,
+							const Range& rawUpRange, const Range& aabbUpRange) const;
+
+	///the vertex of grid point x, y with the given raw height, in bullet-local coordinates
+	void getVertexAtRawHeight(int x, int y, btScalar height, btVector3& vertex) const;
+
 	/// protected initialization
 	/**
 	  Handles the work of constructors so that public constructors can be
@@ -139,6 +152,11 @@ protected:
 					btScalar minHeight, btScalar maxHeight, int upAxis,
 					PHY_ScalarType heightDataType, bool flipQuadEdges);
 
+	/// constructor for subclasses that provide the heights by overriding getRawHeightFieldValue
+	btHeightfieldTerrainShape(int heightStickWidth, int heightStickLength,
+							  btScalar minHeight, btScalar maxHeight,
+							  int upAxis, bool flipQuadEdges);
+
 public:
 	BT_DECLARE_ALIGNED_ALLOCATOR();
 
@@ -208,11 +226,21 @@ public:
 
 	void getVertex(int x, int y, btVector3& vertex) const;
 
-	void performRaycast(btTriangleCallback * callback, const btVector3& raySource, const btVector3& rayTarget) const;
+	virtual void performRaycast(btTriangleCallback * callback, const btVector3& raySource, const btVector3& rayTarget) const;
 
+	///builds the min/max height pyramid used by performRaycast and processAllTriangles to skip the parts of the terrain
+	///a query can't touch. The leaves are chunks of chunkSize x chunkSize cells
 	void buildAccelerator(int chunkSize = 16);
 	void clearAccelerator();
 
+	///updates the accelerator after the heights of the samples from startX, startY to endX, endY (inclusive) changed
+	void updateAccelerator(int startX, int startY, int endX, int endY);
+
+	int getAcceleratorNumLevels() const
+	{
+		return m_vboundsLevelOffsets.size();
+	}
+
 	int getUpAxis() const
 	{
 		return m_upAxis;
@@ -17,6 +17,7 @@ subject to the following restrictions:
 #include "btStridingMeshInterface.h"
 #include "LinearMath/btAabbUtil2.h"
 #include "LinearMath/btIDebugDraw.h"
+#include "LinearMath/btThreads.h"
 
 btOptimizedBvh::btOptimizedBvh()
 {
@@ -26,7 +27,7 @@ btOptimizedBvh::~btOptimizedBvh()
 {
 }
 
-void btOptimizedBvh::build(btStridingMeshInterface* triangles, bool useQuantizedAabbCompression, const btVector3& bvhAabbMin, const btVector3& bvhAabbMax)
+void btOptimizedBvh::build(btStridingMeshInterface* triangles, bool useQuantizedAabbCompression, const btVector3& bvhAabbMin, const btVector3& bvhAabbMax, btBuildMode buildMode)
 {
 	m_useQuantization = useQuantizedAabbCompression;
 
@@ -169,7 +170,14 @@ void btOptimizedBvh::build(btStridingMeshInterface* triangles, bool useQuantized
 
 	m_curNodeIndex = 0;
 
-	buildTree(0, numLeafNodes);
+	if (buildMode == BUILD_BINNED_SAH)
+	{
+		buildTreeBinnedSah(numLeafNodes);
+	}
+	else
+	{
+		buildTree(0, numLeafNodes);
+	}
 
 	///if the entire tree is small then subtree size, we need to create a header info for the tree
 	if (m_useQuantization && !m_SubtreeHeaders.size())
@@ -188,12 +196,101 @@ void btOptimizedBvh::build(btStridingMeshInterface* triangles, bool useQuantized
 	m_leafNodes.clear();
 }
 
+///subtrees per task of the parallel refit
+#define BT_BVH_REFIT_GRAIN_SIZE 8
+
+static bool btUseParallelRefit(int numSubtrees)
+{
+#if BT_THREADSAFE
+	btITaskScheduler* scheduler = btGetTaskScheduler();
+	return numSubtrees > 1 && scheduler && scheduler->getNumThreads() > 1 && !btThreadsAreRunning();
+#else
+	(void)numSubtrees;
+	return false;
+#endif
+}
+
+struct btBvhRefitSubtreesLoop : public btIParallelForBody
+{
+	btOptimizedBvh* m_bvh;
+	btStridingMeshInterface* m_meshInterface;
+	const int* m_subtreeIndices;
+
+	btBvhRefitSubtreesLoop(btOptimizedBvh* bvh, btStridingMeshInterface* meshInterface, const int* subtreeIndices)
+		: m_bvh(bvh),
+		  m_meshInterface(meshInterface),
+		  m_subtreeIndices(subtreeIndices)
+	{
+	}
+
+	void forLoop(int iBegin, int iEnd) const
+	{
+		BvhSubtreeInfoArray& subtrees = m_bvh->getSubtreeInfoArray();
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			const int subtreeIndex = m_subtreeIndices[i];
+			btBvhSubtreeInfo& subtree = subtrees[subtreeIndex];
+			m_bvh->updateBvhNodes(m_meshInterface, subtree.m_rootNodeIndex, subtree.m_rootNodeIndex + subtree.m_subtreeSize, subtreeIndex);
+			subtree.setAabbFromQuantizeNode(m_bvh->getQuantizedNodeArray()[subtree.m_rootNodeIndex]);
+		}
+	}
+};
+
+void btOptimizedBvh::refitSubtrees(btStridingMeshInterface* meshInterface, const btAlignedObjectArray<int>& subtreeIndices)
+{
+	btAssert(m_useQuantization);
+	if (!subtreeIndices.size())
+		return;
+
+	btBvhRefitSubtreesLoop loop(this, meshInterface, &subtreeIndices[0]);
+#if BT_THREADSAFE
+	if (btUseParallelRefit(subtreeIndices.size()))
+	{
+		btParallelFor(0, subtreeIndices.size(), BT_BVH_REFIT_GRAIN_SIZE, loop);
+	}
+	else
+#endif
+	{
+		loop.forLoop(0, subtreeIndices.size());
+	}
+}
+
+void btOptimizedBvh::refitTopNodes(int nodeIndex)
+{
+	//the subtree headers start at the largest nodes that fit MAX_SUBTREE_SIZE_IN_BYTES, see buildSubtreeHeaders
+	const btQuantizedBvhNode& node = m_quantizedContiguousNodes[nodeIndex];
+	if (node.isLeafNode() || node.getEscapeIndex() * static_cast<int>(sizeof(btQuantizedBvhNode)) <= MAX_SUBTREE_SIZE_IN_BYTES)
+		return;
+
+	const int leftChildNodeIndex = nodeIndex + 1;
+	const btQuantizedBvhNode& leftChild = m_quantizedContiguousNodes[leftChildNodeIndex];
+	const int rightChildNodeIndex = leftChildNodeIndex + (leftChild.isLeafNode() ? 1 : leftChild.getEscapeIndex());
+
+	refitTopNodes(leftChildNodeIndex);
+	refitTopNodes(rightChildNodeIndex);
+	mergeChildNodeAabbs(nodeIndex, leftChildNodeIndex, rightChildNodeIndex);
+}
+
 void btOptimizedBvh::refit(btStridingMeshInterface* meshInterface, const btVector3& aabbMin, const btVector3& aabbMax)
 {
 	if (m_useQuantization)
 	{
 		setQuantizationValues(aabbMin, aabbMax);
 
+		if (btUseParallelRefit(m_SubtreeHeaders.size()))
+		{
+			//the subtrees don't share nodes, refit them in parallel and then the few nodes above them
+			btAlignedObjectArray<int> subtreeIndices;
+			subtreeIndices.resize(m_SubtreeHeaders.size());
+			for (int i = 0; i < m_SubtreeHeaders.size(); i++)
+			{
+				subtreeIndices[i] = i;
+			}
+			refitSubtrees(meshInterface, subtreeIndices);
+			refitTopNodes(0);
+			return;
+		}
+
 		updateBvhNodes(meshInterface, 0, m_curNodeIndex, 0);
 
 		///now update all subtree headers
@@ -210,7 +307,7 @@ void btOptimizedBvh::refit(btStridingMeshInterface* meshInterface, const btVecto
 	}
 }
 
-void btOptimizedBvh::refitPartial(btStridingMeshInterface* meshInterface, const btVector3& aabbMin, const btVector3& aabbMax)
+void btOptimizedBvh::refitPartial(btStridingMeshInterface* meshInterface, const btVector3& aabbMin, const btVector3& aabbMax, btAlignedObjectArray<int>* refitSubtreeIndices)
 {
 	//incrementally initialize quantization values
 	btAssert(m_useQuantization);
@@ -232,6 +329,7 @@ void btOptimizedBvh::refitPartial(btStridingMeshInterface* meshInterface, const
 	quantize(&quantizedQueryAabbMin[0], aabbMin, 0);
 	quantize(&quantizedQueryAabbMax[0], aabbMax, 1);
 
+	btAlignedObjectArray<int> subtreeIndices;
 	int i;
 	for (i = 0; i < this->m_SubtreeHeaders.size(); i++)
 	{
@@ -241,11 +339,14 @@ void btOptimizedBvh::refitPartial(btStridingMeshInterface* meshInterface, const
 		unsigned overlap = testQuantizedAabbAgainstQuantizedAabb(quantizedQueryAabbMin, quantizedQueryAabbMax, subtree.m_quantizedAabbMin, subtree.m_quantizedAabbMax);
 		if (overlap != 0)
 		{
-			updateBvhNodes(meshInterface, subtree.m_rootNodeIndex, subtree.m_rootNodeIndex + subtree.m_subtreeSize, i);
-
-			subtree.setAabbFromQuantizeNode(m_quantizedContiguousNodes[subtree.m_rootNodeIndex]);
+			subtreeIndices.push_back(i);
 		}
 	}
+	refitSubtrees(meshInterface, subtreeIndices);
+	if (refitSubtreeIndices)
+	{
+		*refitSubtreeIndices = subtreeIndices;
+	}
 }
 
 void btOptimizedBvh::updateBvhNodes(btStridingMeshInterface* meshInterface, int firstNode, int endNode, int index)
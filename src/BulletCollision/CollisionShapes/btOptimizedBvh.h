@@ -35,14 +35,22 @@ public:
 
 	virtual ~btOptimizedBvh();
 
-	void build(btStridingMeshInterface * triangles, bool useQuantizedAabbCompression, const btVector3& bvhAabbMin, const btVector3& bvhAabbMax);
+	void build(btStridingMeshInterface * triangles, bool useQuantizedAabbCompression, const btVector3& bvhAabbMin, const btVector3& bvhAabbMax, btBuildMode buildMode = BUILD_MEAN_SPLIT);
 
 	void refit(btStridingMeshInterface * triangles, const btVector3& aabbMin, const btVector3& aabbMax);
 
-	void refitPartial(btStridingMeshInterface * triangles, const btVector3& aabbMin, const btVector3& aabbMax);
+	///refits the subtrees that overlap the aabb. Their indices are stored in refitSubtreeIndices, if given
+	void refitPartial(btStridingMeshInterface * triangles, const btVector3& aabbMin, const btVector3& aabbMax, btAlignedObjectArray<int>* refitSubtreeIndices = 0);
 
 	void updateBvhNodes(btStridingMeshInterface * meshInterface, int firstNode, int endNode, int index);
 
+	///refits the given subtrees, in parallel with btParallelFor when a task scheduler with several threads is set.
+	///Each subtree only reads its own triangles, so the mesh interface must allow concurrent read-only locks, like btTriangleIndexVertexArray
+	void refitSubtrees(btStridingMeshInterface * meshInterface, const btAlignedObjectArray<int>& subtreeIndices);
+
+	///merges the bounds of the nodes above the subtrees, bottom-up
+	void refitTopNodes(int nodeIndex);
+
 	/// Data buffer MUST be 16 byte aligned
 	virtual bool serializeInPlace(void* o_alignedDataBuffer, unsigned i_dataBufferSize, bool i_swapEndian) const
 	{
@@ -20,6 +20,7 @@ subject to the following restrictions:
 
 ///The btScaledBvhTriangleMeshShape allows to instance a scaled version of an existing btBvhTriangleMeshShape.
 ///Note that each btBvhTriangleMeshShape still can have its own local scaling, independent from this btScaledBvhTriangleMeshShape 'localScaling'
+///Queries use the btQuantizedWideBvh of the child shape when it has one, see btBvhTriangleMeshShape::buildWideBvh.
 ATTRIBUTE_ALIGNED16(class)
 btScaledBvhTriangleMeshShape : public btConcaveShape
 {
@@ -0,0 +1,533 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btTiledHeightfieldTerrainShape.h"
+
+#include <new>
+
+void btHeightfieldArrayTileSource::loadTile(int tileX, int tileY, int tileSize, float* heights)
+{
+	const int x0 = tileX * tileSize;
+	const int y0 = tileY * tileSize;
+	for (int j = 0; j <= tileSize; j++)
+	{
+		//samples past the end of the terrain repeat the last row or column
+		const int y = btMin(y0 + j, m_length - 1);
+		for (int i = 0; i <= tileSize; i++)
+		{
+			const int x = btMin(x0 + i, m_width - 1);
+			heights[j * (tileSize + 1) + i] = m_heights[y * m_width + x];
+		}
+	}
+}
+
+bool btHeightfieldArrayTileSource::storeTile(int tileX, int tileY, int tileSize, const float* heights)
+{
+	if (!m_writableHeights)
+	{
+		return false;
+	}
+	const int x0 = tileX * tileSize;
+	const int y0 = tileY * tileSize;
+	for (int j = 0; j <= tileSize && y0 + j < m_length; j++)
+	{
+		for (int i = 0; i <= tileSize && x0 + i < m_width; i++)
+		{
+			m_writableHeights[(y0 + j) * m_width + x0 + i] = heights[j * (tileSize + 1) + i];
+		}
+	}
+	return true;
+}
+
+btTiledHeightfieldTerrainShape::btTiledHeightfieldTerrainShape(int heightStickWidth, int heightStickLength, int tileSize, btHeightfieldTileSource* source,
+															   int maxCachedTiles, btScalar minHeight, btScalar maxHeight, int upAxis, bool flipQuadEdges)
+	: btHeightfieldTerrainShape(heightStickWidth, heightStickLength, minHeight, maxHeight, upAxis, flipQuadEdges),
+	  m_source(source),
+	  m_tileSize(tileSize),
+	  m_maxCachedTiles(btMax(1, maxCachedTiles)),
+	  m_useCounter(0),
+	  m_numTileLoads(0)
+{
+	btAssert(source);
+	btAssert(tileSize > 0 && (tileSize & (tileSize - 1)) == 0);  // && "tileSize must be a power of two");
+
+	m_numTilesX = (heightStickWidth - 2) / tileSize + 1;
+	m_numTilesY = (heightStickLength - 2) / tileSize + 1;
+
+	int offset = 0;
+	for (int size = tileSize; size > 0; size >>= 1)
+	{
+		m_levelOffsets.push_back(offset);
+		offset += size * size;
+	}
+	m_numLevels = m_levelOffsets.size();
+}
+
+btTiledHeightfieldTerrainShape::~btTiledHeightfieldTerrainShape()
+{
+	for (int i = 0; i < m_cachedTiles.size(); i++)
+	{
+		btAssert(m_cachedTiles[i]->m_pinCount == 0);
+		m_cachedTiles[i]->~btHeightfieldTile();
+		btAlignedFree(m_cachedTiles[i]);
+	}
+}
+
+const btHeightfieldTile* btTiledHeightfieldTerrainShape::acquireTile(int tileX, int tileY) const
+{
+	btAssert(tileX >= 0 && tileX < m_numTilesX);
+	btAssert(tileY >= 0 && tileY < m_numTilesY);
+
+	btMutexLock(&m_cacheMutex);
+	const int key = tileY * m_numTilesX + tileX;
+	const int* slot = m_tileSlots.find(key);
+	btHeightfieldTile* tile = 0;
+	if (slot)
+	{
+		tile = m_cachedTiles[*slot];
+	}
+	else
+	{
+		//reuse the least recently used tile that is not in use, once the cache is full
+		int victim = -1;
+		while (m_cachedTiles.size() >= m_maxCachedTiles)
+		{
+			victim = -1;
+			for (int i = 0; i < m_cachedTiles.size(); i++)
+			{
+				const btHeightfieldTile* candidate = m_cachedTiles[i];
+				if (candidate->m_pinCount == 0 && !candidate->m_unsaved &&
+					(victim < 0 || int(candidate->m_lastUsed - m_cachedTiles[victim]->m_lastUsed) < 0))
+				{
+					victim = i;
+				}
+			}
+			if (victim < 0)
+			{
+				break;
+			}
+			btHeightfieldTile* evicted = m_cachedTiles[victim];
+			if (!evicted->m_dirty || m_source->storeTile(evicted->m_tileX, evicted->m_tileY, m_tileSize, &evicted->m_heights[0]))
+			{
+				m_tileSlots.remove(evicted->m_tileY * m_numTilesX + evicted->m_tileX);
+				break;
+			}
+			evicted->m_unsaved = true;
+		}
+
+		if (victim >= 0)
+		{
+			tile = m_cachedTiles[victim];
+		}
+		else
+		{
+			victim = m_cachedTiles.size();
+			tile = new (btAlignedAlloc(sizeof(btHeightfieldTile), 16)) btHeightfieldTile;
+			tile->m_heights.resize((m_tileSize + 1) * (m_tileSize + 1));
+			tile->m_pyramid.resize(m_levelOffsets[m_numLevels - 1] + 1);
+			m_cachedTiles.push_back(tile);
+		}
+
+		tile->m_tileX = tileX;
+		tile->m_tileY = tileY;
+		tile->m_pinCount = 0;
+		tile->m_dirty = false;
+		tile->m_unsaved = false;
+		m_source->loadTile(tileX, tileY, m_tileSize, &tile->m_heights[0]);
+		updatePyramid(tile, 0, 0, m_tileSize - 1, m_tileSize - 1);
+		m_tileSlots.insert(key, victim);
+		m_numTileLoads++;
+	}
+	tile->m_pinCount++;
+	tile->m_lastUsed = m_useCounter++;
+	btMutexUnlock(&m_cacheMutex);
+	return tile;
+}
+
+void btTiledHeightfieldTerrainShape::releaseTile(const btHeightfieldTile* tile) const
+{
+	btMutexLock(&m_cacheMutex);
+	btAssert(tile->m_pinCount > 0);
+	const_cast<btHeightfieldTile*>(tile)->m_pinCount--;
+	btMutexUnlock(&m_cacheMutex);
+}
+
+int btTiledHeightfieldTerrainShape::flushTiles()
+{
+	int numUnsaved = 0;
+	for (int i = 0; i < m_cachedTiles.size(); i++)
+	{
+		btHeightfieldTile* tile = m_cachedTiles[i];
+		if (tile->m_dirty)
+		{
+			tile->m_dirty = !m_source->storeTile(tile->m_tileX, tile->m_tileY, m_tileSize, &tile->m_heights[0]);
+			tile->m_unsaved = tile->m_dirty;
+			numUnsaved += tile->m_dirty;
+		}
+	}
+	return numUnsaved;
+}
+
+void btTiledHeightfieldTerrainShape::clearCache()
+{
+	flushTiles();
+	int numCached = 0;
+	for (int i = 0; i < m_cachedTiles.size(); i++)
+	{
+		btHeightfieldTile* tile = m_cachedTiles[i];
+		if (tile->m_pinCount == 0 && !tile->m_unsaved)
+		{
+			tile->~btHeightfieldTile();
+			btAlignedFree(tile);
+		}
+		else
+		{
+			m_cachedTiles[numCached++] = tile;
+		}
+	}
+	m_cachedTiles.resize(numCached);
+	m_tileSlots.clear();
+	for (int i = 0; i < numCached; i++)
+	{
+		m_tileSlots.insert(m_cachedTiles[i]->m_tileY * m_numTilesX + m_cachedTiles[i]->m_tileX, i);
+	}
+}
+
+///recomputes the ranges of the cells in [cellMin, cellMax], in tile coordinates, and of the nodes above them
+void btTiledHeightfieldTerrainShape::updatePyramid(btHeightfieldTile* tile, int cellMinX, int cellMinY, int cellMaxX, int cellMaxY) const
+{
+	const int stride = m_tileSize + 1;
+	const float* heights = &tile->m_heights[0];
+	for (int y = cellMinY; y <= cellMaxY; y++)
+	{
+		for (int x = cellMinX; x <= cellMaxX; x++)
+		{
+			const float* h = &heights[y * stride + x];
+			Range& range = tile->m_pyramid[y * m_tileSize + x];
+			range.min = btMin(btMin(h[0], h[1]), btMin(h[stride], h[stride + 1]));
+			range.max = btMax(btMax(h[0], h[1]), btMax(h[stride], h[stride + 1]));
+		}
+	}
+
+	for (int level = 1; level < m_numLevels; level++)
+	{
+		cellMinX >>= 1;
+		cellMinY >>= 1;
+		cellMaxX >>= 1;
+		cellMaxY >>= 1;
+		const int size = m_tileSize >> level;
+		const Range* children = &tile->m_pyramid[m_levelOffsets[level - 1]];
+		Range* nodes = &tile->m_pyramid[m_levelOffsets[level]];
+		for (int y = cellMinY; y <= cellMaxY; y++)
+		{
+			for (int x = cellMinX; x <= cellMaxX; x++)
+			{
+				const Range* c = &children[2 * y * 2 * size + 2 * x];
+				Range& range = nodes[y * size + x];
+				range.min = btMin(btMin(c[0].min, c[1].min), btMin(c[2 * size].min, c[2 * size + 1].min));
+				range.max = btMax(btMax(c[0].max, c[1].max), btMax(c[2 * size].max, c[2 * size + 1].max));
+			}
+		}
+	}
+}
+
+btScalar btTiledHeightfieldTerrainShape::getRawHeightFieldValue(int x, int y) const
+{
+	const int tileX = btMin(x / m_tileSize, m_numTilesX - 1);
+	const int tileY = btMin(y / m_tileSize, m_numTilesY - 1);
+	const btHeightfieldTile* tile = acquireTile(tileX, tileY);
+	btScalar height = tile->m_heights[(y - tileY * m_tileSize) * (m_tileSize + 1) + x - tileX * m_tileSize];
+	releaseTile(tile);
+	return height;
+}
+
+void btTiledHeightfieldTerrainShape::setHeights(int startX, int startY, int numX, int numY, const float* heights)
+{
+	//the samples on the border of a tile are shared with the next tile
+	const int tileMinX = startX > 0 ? (startX - 1) / m_tileSize : 0;
+	const int tileMinY = startY > 0 ? (startY - 1) / m_tileSize : 0;
+	const int tileMaxX = btMin((startX + numX - 1) / m_tileSize, m_numTilesX - 1);
+	const int tileMaxY = btMin((startY + numY - 1) / m_tileSize, m_numTilesY - 1);
+	for (int tileY = tileMinY; tileY <= tileMaxY; tileY++)
+	{
+		for (int tileX = tileMinX; tileX <= tileMaxX; tileX++)
+		{
+			btHeightfieldTile* tile = const_cast<btHeightfieldTile*>(acquireTile(tileX, tileY));
+			const int x0 = tileX * m_tileSize;
+			const int y0 = tileY * m_tileSize;
+			const int minX = btMax(startX, x0) - x0;
+			const int minY = btMax(startY, y0) - y0;
+			const int maxX = btMin(startX + numX - 1, x0 + m_tileSize) - x0;
+			const int maxY = btMin(startY + numY - 1, y0 + m_tileSize) - y0;
+			if (minX <= maxX && minY <= maxY)
+			{
+				for (int y = minY; y <= maxY; y++)
+				{
+					for (int x = minX; x <= maxX; x++)
+					{
+						tile->m_heights[y * (m_tileSize + 1) + x] = heights[(y0 + y - startY) * numX + x0 + x - startX];
+					}
+				}
+				tile->m_dirty = true;
+				//a sample changes the cells on both of its sides
+				updatePyramid(tile, btMax(minX - 1, 0), btMax(minY - 1, 0), btMin(maxX, m_tileSize - 1), btMin(maxY, m_tileSize - 1));
+			}
+			releaseTile(tile);
+		}
+	}
+}
+
+///the two triangles of cell x, y, like btHeightfieldTerrainShape::processAllTriangles
+void btTiledHeightfieldTerrainShape::processCell(btTriangleCallback* callback, int x, int y, const btHeightfieldTile* tile, const Range& aabbUpRange) const
+{
+	const int stride = m_tileSize + 1;
+	const float* h = &tile->m_heights[(y - tile->m_tileY * m_tileSize) * stride + x - tile->m_tileX * m_tileSize];
+
+	btVector3 vertices[3];
+	int indices[3] = {0, 1, 2};
+	if (m_flipTriangleWinding)
+	{
+		indices[0] = 2;
+		indices[2] = 0;
+	}
+
+	if (m_flipQuadEdges || (m_useDiamondSubdivision && !((y + x) & 1)) || (m_useZigzagSubdivision && !(y & 1)))
+	{
+		getVertexAtRawHeight(x, y, h[0], vertices[indices[0]]);
+		getVertexAtRawHeight(x, y + 1, h[stride], vertices[indices[1]]);
+		getVertexAtRawHeight(x + 1, y + 1, h[stride + 1], vertices[indices[2]]);
+
+		Range upRange(btMin(btMin(vertices[0][m_upAxis], vertices[1][m_upAxis]), vertices[2][m_upAxis]),
+					  btMax(btMax(vertices[0][m_upAxis], vertices[1][m_upAxis]), vertices[2][m_upAxis]));
+		if (upRange.overlaps(aabbUpRange))
+			callback->processTriangle(vertices, 2 * x, y);
+
+		vertices[indices[1]] = vertices[indices[2]];
+		getVertexAtRawHeight(x + 1, y, h[1], vertices[indices[2]]);
+		upRange.min = btMin(upRange.min, vertices[indices[2]][m_upAxis]);
+		upRange.max = btMax(upRange.max, vertices[indices[2]][m_upAxis]);
+		if (upRange.overlaps(aabbUpRange))
+			callback->processTriangle(vertices, 2 * x + 1, y);
+	}
+	else
+	{
+		getVertexAtRawHeight(x, y, h[0], vertices[indices[0]]);
+		getVertexAtRawHeight(x, y + 1, h[stride], vertices[indices[1]]);
+		getVertexAtRawHeight(x + 1, y, h[1], vertices[indices[2]]);
+
+		Range upRange(btMin(btMin(vertices[0][m_upAxis], vertices[1][m_upAxis]), vertices[2][m_upAxis]),
+					  btMax(btMax(vertices[0][m_upAxis], vertices[1][m_upAxis]), vertices[2][m_upAxis]));
+		if (upRange.overlaps(aabbUpRange))
+			callback->processTriangle(vertices, 2 * x, y);
+
+		vertices[indices[0]] = vertices[indices[2]];
+		getVertexAtRawHeight(x + 1, y + 1, h[stride + 1], vertices[indices[2]]);
+		upRange.min = btMin(upRange.min, vertices[indices[2]][m_upAxis]);
+		upRange.max = btMax(upRange.max, vertices[indices[2]][m_upAxis]);
+		if (upRange.overlaps(aabbUpRange))
+			callback->processTriangle(vertices, 2 * x + 1, y);
+	}
+}
+
+void btTiledHeightfieldTerrainShape::processNodeTriangles(btTriangleCallback* callback, const btHeightfieldTile* tile, int level, int nodeX, int nodeY,
+														  const int* cellMin, const int* cellMax, const Range& rawUpRange, const Range& aabbUpRange) const
+{
+	const int size = 1 << level;
+	const int x0 = tile->m_tileX * m_tileSize + nodeX * size;
+	const int y0 = tile->m_tileY * m_tileSize + nodeY * size;
+	if (x0 > cellMax[0] || x0 + size <= cellMin[0] || y0 > cellMax[1] || y0 + size <= cellMin[1])
+	{
+		return;
+	}
+	if (!tile->m_pyramid[m_levelOffsets[level] + nodeY * (m_tileSize >> level) + nodeX].overlaps(rawUpRange))
+	{
+		return;
+	}
+	if (level == 0)
+	{
+		processCell(callback, x0, y0, tile, aabbUpRange);
+		return;
+	}
+	for (int j = 0; j < 2; j++)
+	{
+		for (int i = 0; i < 2; i++)
+		{
+			processNodeTriangles(callback, tile, level - 1, 2 * nodeX + i, 2 * nodeY + j, cellMin, cellMax, rawUpRange, aabbUpRange);
+		}
+	}
+}
+
+void btTiledHeightfieldTerrainShape::processAllTriangles(btTriangleCallback* callback, const btVector3& aabbMin, const btVector3& aabbMax) const
+{
+	// same grid range as btHeightfieldTerrainShape::processAllTriangles
+	btVector3 localAabbMin = aabbMin * btVector3(1.f / m_localScaling[0], 1.f / m_localScaling[1], 1.f / m_localScaling[2]) + m_localOrigin;
+	btVector3 localAabbMax = aabbMax * btVector3(1.f / m_localScaling[0], 1.f / m_localScaling[1], 1.f / m_localScaling[2]) + m_localOrigin;
+
+	int quantizedAabbMin[3];
+	int quantizedAabbMax[3];
+	quantizeWithClamp(quantizedAabbMin, localAabbMin, 0);
+	quantizeWithClamp(quantizedAabbMax, localAabbMax, 1);
+
+	const int xAxis = m_upAxis == 0 ? 1 : 0;
+	const int yAxis = m_upAxis == 2 ? 1 : 2;
+	int cellMin[2];
+	int cellMax[2];
+	cellMin[0] = btMax(quantizedAabbMin[xAxis] - 1, 0);
+	cellMin[1] = btMax(quantizedAabbMin[yAxis] - 1, 0);
+	cellMax[0] = btMin(quantizedAabbMax[xAxis] + 1, m_heightStickWidth - 1) - 1;
+	cellMax[1] = btMin(quantizedAabbMax[yAxis] + 1, m_heightStickLength - 1) - 1;
+	if (cellMin[0] > cellMax[0] || cellMin[1] > cellMax[1])
+	{
+		return;
+	}
+
+	// the pyramid holds raw heights, widened a little so it never culls a triangle the exact test would keep
+	const Range aabbUpRange(aabbMin[m_upAxis], aabbMax[m_upAxis]);
+	const btScalar slack = (btFabs(localAabbMin[m_upAxis]) + btFabs(localAabbMax[m_upAxis]) + btScalar(1.)) * btScalar(1e-5);
+	const Range rawUpRange(btMin(localAabbMin[m_upAxis], localAabbMax[m_upAxis]) - slack, btMax(localAabbMin[m_upAxis], localAabbMax[m_upAxis]) + slack);
+
+	for (int tileY = cellMin[1] / m_tileSize; tileY <= cellMax[1] / m_tileSize; tileY++)
+	{
+		for (int tileX = cellMin[0] / m_tileSize; tileX <= cellMax[0] / m_tileSize; tileX++)
+		{
+			const btHeightfieldTile* tile = acquireTile(tileX, tileY);
+			processNodeTriangles(callback, tile, m_numLevels - 1, 0, 0, cellMin, cellMax, rawUpRange, aabbUpRange);
+			releaseTile(tile);
+		}
+	}
+}
+
+///clips the segment from + lambda * delta to the box, in grid coordinates (x, y, raw height)
+static bool btClipSegmentToBox(const btVector3& from, const btVector3& delta, const btVector3& boxMin, const btVector3& boxMax, btScalar& lambdaMin, btScalar& lambdaMax)
+{
+	for (int i = 0; i < 3; i++)
+	{
+		if (delta[i] == btScalar(0.))
+		{
+			if (from[i] < boxMin[i] || from[i] > boxMax[i])
+			{
+				return false;
+			}
+			continue;
+		}
+		const btScalar invDelta = btScalar(1.) / delta[i];
+		btScalar lambda0 = (boxMin[i] - from[i]) * invDelta;
+		btScalar lambda1 = (boxMax[i] - from[i]) * invDelta;
+		if (lambda0 > lambda1)
+		{
+			btSwap(lambda0, lambda1);
+		}
+		lambdaMin = btMax(lambdaMin, lambda0);
+		lambdaMax = btMin(lambdaMax, lambda1);
+		if (lambdaMin > lambdaMax)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+#define BT_TILED_HEIGHTFIELD_RAY_EPSILON btScalar(1e-3)
+
+void btTiledHeightfieldTerrainShape::raycastNode(btTriangleCallback* callback, const btHeightfieldTile* tile, int level, int nodeX, int nodeY,
+												 const btVector3& rayFrom, const btVector3& rayDelta, btScalar lambdaMin, btScalar lambdaMax) const
+{
+	const int size = 1 << level;
+	const int x0 = tile->m_tileX * m_tileSize + nodeX * size;
+	const int y0 = tile->m_tileY * m_tileSize + nodeY * size;
+	if (x0 >= m_heightStickWidth - 1 || y0 >= m_heightStickLength - 1)
+	{
+		return;
+	}
+	const Range& range = tile->m_pyramid[m_levelOffsets[level] + nodeY * (m_tileSize >> level) + nodeX];
+	const btVector3 epsilon(BT_TILED_HEIGHTFIELD_RAY_EPSILON, BT_TILED_HEIGHTFIELD_RAY_EPSILON, BT_TILED_HEIGHTFIELD_RAY_EPSILON);
+	if (!btClipSegmentToBox(rayFrom, rayDelta, btVector3(x0, y0, range.min) - epsilon, btVector3(x0 + size, y0 + size, range.max) + epsilon, lambdaMin, lambdaMax))
+	{
+		return;
+	}
+	if (level == 0)
+	{
+		processCell(callback, x0, y0, tile, Range(-SIMD_INFINITY, SIMD_INFINITY));
+		return;
+	}
+	for (int j = 0; j < 2; j++)
+	{
+		for (int i = 0; i < 2; i++)
+		{
+			raycastNode(callback, tile, level - 1, 2 * nodeX + i, 2 * nodeY + j, rayFrom, rayDelta, lambdaMin, lambdaMax);
+		}
+	}
+}
+
+/// Walks the tiles along the ray with a 2D DDA, and descends the pyramid of each tile.
+/// Reports the triangles of the cells whose bounds the ray crosses, in no particular order.
+void btTiledHeightfieldTerrainShape::performRaycast(btTriangleCallback* callback, const btVector3& raySource, const btVector3& rayTarget) const
+{
+	const btVector3 beginPos = raySource / m_localScaling + m_localOrigin;
+	const btVector3 endPos = rayTarget / m_localScaling + m_localOrigin;
+
+	// grid coordinates: x, y and raw height
+	const int xAxis = m_upAxis == 0 ? 1 : 0;
+	const int yAxis = m_upAxis == 2 ? 1 : 2;
+	const btVector3 rayFrom(beginPos[xAxis], beginPos[yAxis], beginPos[m_upAxis]);
+	const btVector3 rayDelta = btVector3(endPos[xAxis], endPos[yAxis], endPos[m_upAxis]) - rayFrom;
+
+	btScalar lambdaMin = btScalar(0.);
+	btScalar lambdaMax = btScalar(1.);
+	const btVector3 epsilon(BT_TILED_HEIGHTFIELD_RAY_EPSILON, BT_TILED_HEIGHTFIELD_RAY_EPSILON, BT_TILED_HEIGHTFIELD_RAY_EPSILON);
+	if (!btClipSegmentToBox(rayFrom, rayDelta, btVector3(0, 0, m_minHeight) - epsilon, btVector3(m_width, m_length, m_maxHeight) + epsilon, lambdaMin, lambdaMax))
+	{
+		return;
+	}
+
+	const btVector3 entry = rayFrom + rayDelta * lambdaMin;
+	int tileX = btMax(0, btMin(int(floor(entry.x() / m_tileSize)), m_numTilesX - 1));
+	int tileY = btMax(0, btMin(int(floor(entry.y() / m_tileSize)), m_numTilesY - 1));
+	const int stepX = rayDelta.x() > 0 ? 1 : -1;
+	const int stepY = rayDelta.y() > 0 ? 1 : -1;
+	const btScalar deltaLambdaX = rayDelta.x() != btScalar(0.) ? btFabs(m_tileSize / rayDelta.x()) : SIMD_INFINITY;
+	const btScalar deltaLambdaY = rayDelta.y() != btScalar(0.) ? btFabs(m_tileSize / rayDelta.y()) : SIMD_INFINITY;
+	btScalar nextLambdaX = rayDelta.x() != btScalar(0.) ? ((tileX + (stepX > 0)) * m_tileSize - rayFrom.x()) / rayDelta.x() : SIMD_INFINITY;
+	btScalar nextLambdaY = rayDelta.y() != btScalar(0.) ? ((tileY + (stepY > 0)) * m_tileSize - rayFrom.y()) / rayDelta.y() : SIMD_INFINITY;
+
+	btScalar lambda = lambdaMin;
+	while (true)
+	{
+		const btScalar exitLambda = btMin(btMin(nextLambdaX, nextLambdaY), lambdaMax);
+		const btHeightfieldTile* tile = acquireTile(tileX, tileY);
+		raycastNode(callback, tile, m_numLevels - 1, 0, 0, rayFrom, rayDelta, lambda - BT_TILED_HEIGHTFIELD_RAY_EPSILON, exitLambda + BT_TILED_HEIGHTFIELD_RAY_EPSILON);
+		releaseTile(tile);
+		if (exitLambda >= lambdaMax)
+		{
+			break;
+		}
+		if (nextLambdaX < nextLambdaY)
+		{
+			tileX += stepX;
+			lambda = nextLambdaX;
+			nextLambdaX += deltaLambdaX;
+		}
+		else
+		{
+			tileY += stepY;
+			lambda = nextLambdaY;
+			nextLambdaY += deltaLambdaY;
+		}
+		if (tileX < 0 || tileX >= m_numTilesX || tileY < 0 || tileY >= m_numTilesY)
+		{
+			break;
+		}
+	}
+}
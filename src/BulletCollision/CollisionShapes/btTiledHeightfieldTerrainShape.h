@@ -0,0 +1,197 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_TILED_HEIGHTFIELD_TERRAIN_SHAPE_H
+#define BT_TILED_HEIGHTFIELD_TERRAIN_SHAPE_H
+
+#include "btHeightfieldTerrainShape.h"
+#include "LinearMath/btHashMap.h"
+#include "LinearMath/btThreads.h"
+
+///provides the heights of a btTiledHeightfieldTerrainShape, one tile at a time
+class btHeightfieldTileSource
+{
+public:
+	virtual ~btHeightfieldTileSource() {}
+
+	///fills heights with the (tileSize + 1) x (tileSize + 1) samples starting at sample (tileX * tileSize, tileY * tileSize),
+	///x first. The last row and column are shared with the next tiles. Samples past the end of the terrain are not used,
+	///but must lie between the min and max height
+	virtual void loadTile(int tileX, int tileY, int tileSize, float* heights) = 0;
+
+	///stores an edited tile before it leaves the cache. Returns false without storage: the edited tile stays in the cache
+	virtual bool storeTile(int tileX, int tileY, int tileSize, const float* heights)
+	{
+		(void)tileX;
+		(void)tileY;
+		(void)tileSize;
+		(void)heights;
+		return false;
+	}
+};
+
+///reads the tiles from a width x length array of heights, x first. The array can be a memory mapped file,
+///then only the pages of the tiles in use are read from disk. Edits are stored back if the array is writable
+class btHeightfieldArrayTileSource : public btHeightfieldTileSource
+{
+	const float* m_heights;
+	float* m_writableHeights;
+	int m_width;
+	int m_length;
+
+public:
+	btHeightfieldArrayTileSource(const float* heights, int width, int length)
+		: m_heights(heights),
+		  m_writableHeights(0),
+		  m_width(width),
+		  m_length(length)
+	{
+	}
+
+	btHeightfieldArrayTileSource(float* heights, int width, int length)
+		: m_heights(heights),
+		  m_writableHeights(heights),
+		  m_width(width),
+		  m_length(length)
+	{
+	}
+
+	virtual void loadTile(int tileX, int tileY, int tileSize, float* heights);
+
+	virtual bool storeTile(int tileX, int tileY, int tileSize, const float* heights);
+};
+
+///a tile of a btTiledHeightfieldTerrainShape in the cache
+struct btHeightfieldTile
+{
+	int m_tileX;
+	int m_tileY;
+	unsigned int m_lastUsed;
+	int m_pinCount;  //queries using the tile, it can't be evicted
+	bool m_dirty;    //edited since it was loaded
+	bool m_unsaved;  //edited, and the source couldn't store it, so it stays in the cache
+
+	///(tileSize + 1) x (tileSize + 1) heights, x first
+	btAlignedObjectArray<float> m_heights;
+
+	///min/max raw height of the cells, level by level: tileSize x tileSize cells, then blocks of 2x2, 4x4 ... up to the whole tile
+	btAlignedObjectArray<btHeightfieldTerrainShape::Range> m_pyramid;
+};
+
+///btTiledHeightfieldTerrainShape is a heightfield terrain too large to keep in memory.
+/**
+  The terrain is split in square tiles of tileSize x tileSize cells (a power of two). Tiles are loaded on demand from a
+  btHeightfieldTileSource into a cache of at most maxCachedTiles tiles, and the least recently used tile is evicted
+  when the cache is full. Tiles in use by a query, and edited tiles the source can't store, stay in the cache, so it can
+  exceed the bound temporarily.
+
+  Each cached tile keeps a min/max pyramid of its cells. processAllTriangles and performRaycast descend it and only
+  triangulate the cells that can overlap the query. setHeights updates the cached tiles and only the pyramid nodes above
+  the changed cells.
+
+  The shape is a btHeightfieldTerrainShape (TERRAIN_SHAPE_PROXYTYPE), with the same grid, triangulation and triangle
+  ids, so btCollisionWorld::rayTest and the contact algorithms handle it like any heightfield. Don't build the
+  btHeightfieldTerrainShape accelerator, it would load every tile.
+
+  The cache is protected by a mutex, so queries can run from several threads. setHeights must not run concurrently
+  with queries.
+ */
+ATTRIBUTE_ALIGNED16(class)
+btTiledHeightfieldTerrainShape : public btHeightfieldTerrainShape
+{
+	btHeightfieldTileSource* m_source;
+	int m_tileSize;
+	int m_numTilesX;
+	int m_numTilesY;
+	int m_maxCachedTiles;
+	int m_numLevels;
+	btAlignedObjectArray<int> m_levelOffsets;
+
+	mutable btAlignedObjectArray<btHeightfieldTile*> m_cachedTiles;
+	mutable btHashMap<btHashInt, int> m_tileSlots;
+	mutable btSpinMutex m_cacheMutex;
+	mutable unsigned int m_useCounter;
+	mutable int m_numTileLoads;
+
+	void updatePyramid(btHeightfieldTile * tile, int cellMinX, int cellMinY, int cellMaxX, int cellMaxY) const;
+
+	void processCell(btTriangleCallback * callback, int x, int y, const btHeightfieldTile* tile, const Range& aabbUpRange) const;
+
+	void processNodeTriangles(btTriangleCallback * callback, const btHeightfieldTile* tile, int level, int nodeX, int nodeY,
+							  const int* cellMin, const int* cellMax, const Range& rawUpRange, const Range& aabbUpRange) const;
+
+	void raycastNode(btTriangleCallback * callback, const btHeightfieldTile* tile, int level, int nodeX, int nodeY,
+					 const btVector3& rayFrom, const btVector3& rayDelta, btScalar lambdaMin, btScalar lambdaMax) const;
+
+protected:
+	virtual btScalar getRawHeightFieldValue(int x, int y) const;
+
+public:
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	///heightStickWidth x heightStickLength samples, the heights must lie between minHeight and maxHeight.
+	///tileSize is the number of cells along a tile, a power of two
+	btTiledHeightfieldTerrainShape(int heightStickWidth, int heightStickLength, int tileSize, btHeightfieldTileSource* source,
+								   int maxCachedTiles, btScalar minHeight, btScalar maxHeight, int upAxis, bool flipQuadEdges);
+
+	virtual ~btTiledHeightfieldTerrainShape();
+
+	virtual void processAllTriangles(btTriangleCallback * callback, const btVector3& aabbMin, const btVector3& aabbMax) const;
+
+	virtual void performRaycast(btTriangleCallback * callback, const btVector3& raySource, const btVector3& rayTarget) const;
+
+	///returns the tile, loaded if needed, and keeps it in the cache until releaseTile
+	const btHeightfieldTile* acquireTile(int tileX, int tileY) const;
+	void releaseTile(const btHeightfieldTile* tile) const;
+
+	///sets the raw heights of numX x numY samples starting at sample (startX, startY), x first.
+	///The heights must lie between the min and max height
+	void setHeights(int startX, int startY, int numX, int numY, const float* heights);
+
+	///stores the edited tiles in the source, returns the number of tiles that couldn't be stored
+	int flushTiles();
+
+	///evicts all tiles that are not in use, storing the edited ones
+	void clearCache();
+
+	int getTileSize() const
+	{
+		return m_tileSize;
+	}
+	int getNumTilesX() const
+	{
+		return m_numTilesX;
+	}
+	int getNumTilesY() const
+	{
+		return m_numTilesY;
+	}
+	int getMaxCachedTiles() const
+	{
+		return m_maxCachedTiles;
+	}
+	int getNumCachedTiles() const
+	{
+		return m_tileSlots.size();
+	}
+	int getNumTileLoads() const
+	{
+		return m_numTileLoads;
+	}
+
+	virtual const char* getName() const { return "TILEDHEIGHTFIELD"; }
+};
+
+#endif  //BT_TILED_HEIGHTFIELD_TERRAIN_SHAPE_H
@@ -117,6 +117,14 @@ public:
 		return m_indexedMeshes;
 	}
 
+	///points a subpart at a new vertex buffer with the same layout, without copying it. For deforming meshes
+	///that write their vertices to a different buffer each frame: refit the btBvhTriangleMeshShape afterwards
+	void setVertexBase(const unsigned char* vertexBase, int subpart = 0)
+	{
+		m_indexedMeshes[subpart].m_vertexBase = vertexBase;
+		m_hasAabb = 0;
+	}
+
 	virtual void preallocateVertices(int numverts) { (void)numverts; }
 	virtual void preallocateIndices(int numindices) { (void)numindices; }
 
@@ -25,6 +25,7 @@ subject to the following restrictions:
 */
 
 #include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btThreads.h"
 
 #include "btBoxCollision.h"
 #include "btTriangleShapeEx.h"
@@ -53,6 +54,34 @@ class GIM_BVH_DATA_ARRAY : public btAlignedObjectArray<GIM_BVH_DATA>
 {
 };
 
+//! Trees with at least this many primitives are built, refit and collided with btParallelFor
+#define GIM_BVH_PARALLEL_MIN_PRIMITIVES 1024
+
+//! Tells if the trees of primitive_count primitives should use btParallelFor
+/*!
+Only when a task scheduler with several threads is set and no parallel loop is running already. The subtrees and the
+node pairs are split off the same way as the serial recursion visits them, so the trees and the collision pairs don't
+depend on the number of threads.
+*/
+SIMD_FORCE_INLINE bool gim_bvh_use_parallel(int primitive_count)
+{
+#if BT_THREADSAFE
+	if (primitive_count < GIM_BVH_PARALLEL_MIN_PRIMITIVES || btThreadsAreRunning())
+		return false;
+	btITaskScheduler* scheduler = btGetTaskScheduler();
+	return scheduler && scheduler->getNumThreads() > 1;
+#else
+	(void)primitive_count;
+	return false;
+#endif
+}
+
+//! Number of primitives per subtree task
+SIMD_FORCE_INLINE int gim_bvh_parallel_task_size(int primitive_count)
+{
+	return btMax(GIM_BVH_PARALLEL_MIN_PRIMITIVES / 4, primitive_count / (4 * btGetTaskScheduler()->getNumThreads()));
+}
+
 class GIM_BVH_TREE_NODE_ARRAY : public btAlignedObjectArray<GIM_BVH_TREE_NODE>
 {
 };
@@ -71,7 +100,11 @@ protected:
 
 	int _calc_splitting_axis(GIM_BVH_DATA_ARRAY& primitive_boxes, int startIndex, int endIndex);
 
-	void _build_sub_tree(GIM_BVH_DATA_ARRAY& primitive_boxes, int startIndex, int endIndex);
+	//! calcs the bound and the escape index of node curIndex, sorts its primitives and returns the split index
+	int _split_node(GIM_BVH_DATA_ARRAY& primitive_boxes, int startIndex, int endIndex, int curIndex);
+
+	//! a subtree of n primitives takes 2n-1 nodes, so subtrees can be built at their node index independently
+	void _build_sub_tree(GIM_BVH_DATA_ARRAY& primitive_boxes, int startIndex, int endIndex, int curIndex);
 
 public:
 	btBvhTree()
@@ -83,6 +116,9 @@ public:
 	//!@{
 	void build_tree(GIM_BVH_DATA_ARRAY& primitive_boxes);
 
+	//! builds the subtrees of the tasks, can be called in parallel
+	void build_sub_trees(GIM_BVH_DATA_ARRAY& primitive_boxes, const GIM_BVH_BUILD_TASK* tasks, int taskBegin, int taskEnd);
+
 	SIMD_FORCE_INLINE void clearNodes()
 	{
 		m_node_array.clear();
@@ -175,6 +211,12 @@ protected:
 	void refit();
 
 public:
+	//! refits the nodes in [nodeBegin, nodeEnd) from the last to the first, can be called in parallel for separate subtrees
+	void refitNodes(int nodeBegin, int nodeEnd);
+
+	//! gets the primitive boxes in [primitiveBegin, primitiveEnd), can be called in parallel
+	void getPrimitiveBoxes(GIM_BVH_DATA_ARRAY& primitive_boxes, int primitiveBegin, int primitiveEnd) const;
+
 	//! this constructor doesn't build the tree. you must call	buildSet
 	btGImpactBvh()
 	{
@@ -82,4 +82,20 @@ public:
 	}
 };
 
+//! A range of primitive boxes and the node of their subtree, for building the subtrees in parallel
+struct GIM_BVH_BUILD_TASK
+{
+	int m_startIndex;
+	int m_endIndex;
+	int m_nodeIndex;
+};
+
+//! A pair of nodes of two trees, for colliding the trees in parallel
+struct GIM_BVH_NODE_PAIR
+{
+	int m_node0;
+	int m_node1;
+	bool m_complete_primitive_tests;
+};
+
 #endif  // GIM_BOXPRUNING_H_INCLUDED
@@ -30,6 +30,7 @@ Concave-Concave Collision
 #include "btGImpactCollisionAlgorithm.h"
 #include "btContactProcessing.h"
 #include "LinearMath/btQuickprof.h"
+#include "LinearMath/btThreads.h"
 
 //! Class for accessing the plane equation
 class btPlaneShape : public btStaticPlaneShape
@@ -344,6 +345,80 @@ void btGImpactCollisionAlgorithm::collide_gjk_triangles(const btCollisionObjectW
 	shape1->unlockChildShapes();
 }
 
+//! clips the triangles of a pair, returns false if they don't collide
+static bool _collide_sat_triangle_pair(const btGImpactMeshShapePart* shape0,
+									   const btGImpactMeshShapePart* shape1,
+									   const btTransform& orgtrans0, const btTransform& orgtrans1,
+									   int triface0, int triface1,
+									   GIM_TRIANGLE_CONTACT& contact_data)
+{
+	btPrimitiveTriangle ptri0;
+	btPrimitiveTriangle ptri1;
+
+	shape0->getPrimitiveTriangle(triface0, ptri0);
+	shape1->getPrimitiveTriangle(triface1, ptri1);
+
+	ptri0.applyTransform(orgtrans0);
+	ptri1.applyTransform(orgtrans1);
+
+	//build planes
+	ptri0.buildTriPlane();
+	ptri1.buildTriPlane();
+	// test conservative
+
+	if (ptri0.overlap_test_conservative(ptri1))
+	{
+		return ptri0.find_triangle_collision_clip_method(ptri1, contact_data);
+	}
+	return false;
+}
+
+struct btGImpactTriangleContact
+{
+	btVector3 m_point;
+	btVector3 m_normal;
+	btScalar m_distance;
+};
+
+struct btGImpactSatTrianglesLoop : public btIParallelForBody
+{
+	const btGImpactMeshShapePart* m_shape0;
+	const btGImpactMeshShapePart* m_shape1;
+	btTransform m_orgtrans0;
+	btTransform m_orgtrans1;
+	const int* m_pairs;
+	//the contacts of each pair go to the buffer of its thread, in [m_pair_begin, m_pair_end)
+	btAlignedObjectArray<btGImpactTriangleContact>* m_thread_contacts;
+	int* m_pair_thread;
+	int* m_pair_begin;
+	int* m_pair_end;
+
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+	{
+		const int threadIndex = btGetCurrentThreadIndex();
+		btAlignedObjectArray<btGImpactTriangleContact>& contacts = m_thread_contacts[threadIndex];
+		GIM_TRIANGLE_CONTACT contact_data;
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			m_pair_thread[i] = threadIndex;
+			m_pair_begin[i] = contacts.size();
+			if (_collide_sat_triangle_pair(m_shape0, m_shape1, m_orgtrans0, m_orgtrans1,
+										   m_pairs[2 * i], m_pairs[2 * i + 1], contact_data))
+			{
+				int j = contact_data.m_point_count;
+				while (j--)
+				{
+					btGImpactTriangleContact& contact = contacts.expandNonInitializing();
+					contact.m_point = contact_data.m_points[j];
+					contact.m_normal = contact_data.m_separating_normal;
+					contact.m_distance = -contact_data.m_penetration_depth;
+				}
+			}
+			m_pair_end[i] = contacts.size();
+		}
+	}
+};
+
 void btGImpactCollisionAlgorithm::collide_sat_triangles(const btCollisionObjectWrapper* body0Wrap,
 														const btCollisionObjectWrapper* body1Wrap,
 														const btGImpactMeshShapePart* shape0,
@@ -353,13 +428,54 @@ void btGImpactCollisionAlgorithm::collide_sat_triangles(const btCollisionObjectW
 	btTransform orgtrans0 = body0Wrap->getWorldTransform();
 	btTransform orgtrans1 = body1Wrap->getWorldTransform();
 
-	btPrimitiveTriangle ptri0;
-	btPrimitiveTriangle ptri1;
 	GIM_TRIANGLE_CONTACT contact_data;
 
 	shape0->lockChildShapes();
 	shape1->lockChildShapes();
 
+	if (gim_bvh_use_parallel(pair_count))
+	{
+		//clip the pairs in parallel, then add the contacts in the order of the pairs
+		btAlignedObjectArray<btAlignedObjectArray<btGImpactTriangleContact> > threadContacts;
+		threadContacts.resize(BT_MAX_THREAD_COUNT);
+		btAlignedObjectArray<int> pairThread;
+		btAlignedObjectArray<int> pairBegin;
+		btAlignedObjectArray<int> pairEnd;
+		pairThread.resize(pair_count);
+		pairBegin.resize(pair_count);
+		pairEnd.resize(pair_count);
+
+		btGImpactSatTrianglesLoop loop;
+		loop.m_shape0 = shape0;
+		loop.m_shape1 = shape1;
+		loop.m_orgtrans0 = orgtrans0;
+		loop.m_orgtrans1 = orgtrans1;
+		loop.m_pairs = pairs;
+		loop.m_thread_contacts = &threadContacts[0];
+		loop.m_pair_thread = &pairThread[0];
+		loop.m_pair_begin = &pairBegin[0];
+		loop.m_pair_end = &pairEnd[0];
+		btParallelFor(0, pair_count, GIM_BVH_PARALLEL_MIN_PRIMITIVES / 16, loop);
+
+		for (int i = 0; i < pair_count; i++)
+		{
+			m_triface0 = pairs[2 * i];
+			m_triface1 = pairs[2 * i + 1];
+			const btAlignedObjectArray<btGImpactTriangleContact>& contacts = threadContacts[pairThread[i]];
+			for (int j = pairBegin[i]; j < pairEnd[i]; j++)
+			{
+				addContactPoint(body0Wrap, body1Wrap,
+								contacts[j].m_point,
+								contacts[j].m_normal,
+								contacts[j].m_distance);
+			}
+		}
+
+		shape0->unlockChildShapes();
+		shape1->unlockChildShapes();
+		return;
+	}
+
 	const int* pair_pointer = pairs;
 
 	while (pair_count--)
@@ -368,33 +484,19 @@ void btGImpactCollisionAlgorithm::collide_sat_triangles(const btCollisionObjectW
 		m_triface1 = *(pair_pointer + 1);
 		pair_pointer += 2;
 
-		shape0->getPrimitiveTriangle(m_triface0, ptri0);
-		shape1->getPrimitiveTriangle(m_triface1, ptri1);
-
 #ifdef TRI_COLLISION_PROFILING
 		bt_begin_gim02_tri_time();
 #endif
 
-		ptri0.applyTransform(orgtrans0);
-		ptri1.applyTransform(orgtrans1);
-
-		//build planes
-		ptri0.buildTriPlane();
-		ptri1.buildTriPlane();
-		// test conservative
-
-		if (ptri0.overlap_test_conservative(ptri1))
+		if (_collide_sat_triangle_pair(shape0, shape1, orgtrans0, orgtrans1, m_triface0, m_triface1, contact_data))
 		{
-			if (ptri0.find_triangle_collision_clip_method(ptri1, contact_data))
+			int j = contact_data.m_point_count;
+			while (j--)
 			{
-				int j = contact_data.m_point_count;
-				while (j--)
-				{
-					addContactPoint(body0Wrap, body1Wrap,
-									contact_data.m_points[j],
-									contact_data.m_separating_normal,
-									-contact_data.m_penetration_depth);
-				}
+				addContactPoint(body0Wrap, body1Wrap,
+								contact_data.m_points[j],
+								contact_data.m_separating_normal,
+								-contact_data.m_penetration_depth);
 			}
 		}
 
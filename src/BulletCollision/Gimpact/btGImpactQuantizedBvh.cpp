@@ -166,21 +166,8 @@ int btQuantizedBvhTree::_sort_and_calc_splitting_index(
 	return splitIndex;
 }
 
-void btQuantizedBvhTree::_build_sub_tree(GIM_BVH_DATA_ARRAY& primitive_boxes, int startIndex, int endIndex)
+int btQuantizedBvhTree::_split_node(GIM_BVH_DATA_ARRAY& primitive_boxes, int startIndex, int endIndex, int curIndex)
 {
-	int curIndex = m_num_nodes;
-	m_num_nodes++;
-
-	btAssert((endIndex - startIndex) > 0);
-
-	if ((endIndex - startIndex) == 1)
-	{
-		//We have a leaf node
-		setNodeBound(curIndex, primitive_boxes[startIndex].m_bound);
-		m_node_array[curIndex].setDataIndex(primitive_boxes[startIndex].m_data);
-
-		return;
-	}
 	//calculate Best Splitting Axis and where to split it. Sort the incoming 'leafNodes' array within range 'startIndex/endIndex'.
 
 	//split axis
@@ -203,34 +190,119 @@ void btQuantizedBvhTree::_build_sub_tree(GIM_BVH_DATA_ARRAY& primitive_boxes, in
 
 	setNodeBound(curIndex, node_bound);
 
+	m_node_array[curIndex].setEscapeIndex(2 * (endIndex - startIndex) - 1);
+
+	return splitIndex;
+}
+
+void btQuantizedBvhTree::_build_sub_tree(GIM_BVH_DATA_ARRAY& primitive_boxes, int startIndex, int endIndex, int curIndex)
+{
+	btAssert((endIndex - startIndex) > 0);
+
+	if ((endIndex - startIndex) == 1)
+	{
+		//We have a leaf node
+		setNodeBound(curIndex, primitive_boxes[startIndex].m_bound);
+		m_node_array[curIndex].setDataIndex(primitive_boxes[startIndex].m_data);
+
+		return;
+	}
+
+	int splitIndex = _split_node(primitive_boxes, startIndex, endIndex, curIndex);
+
 	//build left branch
-	_build_sub_tree(primitive_boxes, startIndex, splitIndex);
+	_build_sub_tree(primitive_boxes, startIndex, splitIndex, curIndex + 1);
 
 	//build right branch
-	_build_sub_tree(primitive_boxes, splitIndex, endIndex);
+	_build_sub_tree(primitive_boxes, splitIndex, endIndex, curIndex + 2 * (splitIndex - startIndex));
+}
 
-	m_node_array[curIndex].setEscapeIndex(m_num_nodes - curIndex);
+void btQuantizedBvhTree::build_sub_trees(GIM_BVH_DATA_ARRAY& primitive_boxes, const GIM_BVH_BUILD_TASK* tasks, int taskBegin, int taskEnd)
+{
+	for (int i = taskBegin; i < taskEnd; i++)
+	{
+		_build_sub_tree(primitive_boxes, tasks[i].m_startIndex, tasks[i].m_endIndex, tasks[i].m_nodeIndex);
+	}
 }
 
+struct btQuantizedBvhTreeBuildLoop : public btIParallelForBody
+{
+	btQuantizedBvhTree* m_tree;
+	GIM_BVH_DATA_ARRAY* m_primitive_boxes;
+	const GIM_BVH_BUILD_TASK* m_tasks;
+
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+	{
+		m_tree->build_sub_trees(*m_primitive_boxes, m_tasks, iBegin, iEnd);
+	}
+};
+
 //! stackless build tree
 void btQuantizedBvhTree::build_tree(
 	GIM_BVH_DATA_ARRAY& primitive_boxes)
 {
 	calc_quantization(primitive_boxes);
-	// initialize node count to 0
+	const int numPrimitives = primitive_boxes.size();
 	m_num_nodes = 0;
+	if (numPrimitives == 0) return;
+
 	// allocate nodes
-	m_node_array.resize(primitive_boxes.size() * 2);
+	m_node_array.resize(numPrimitives * 2);
+	m_num_nodes = 2 * numPrimitives - 1;
+
+	if (!gim_bvh_use_parallel(numPrimitives))
+	{
+		_build_sub_tree(primitive_boxes, 0, numPrimitives, 0);
+		return;
+	}
+
+	//split the top nodes, then build the subtrees below them in parallel
+	const int taskSize = gim_bvh_parallel_task_size(numPrimitives);
+	btAlignedObjectArray<GIM_BVH_BUILD_TASK> tasks;
+	btAlignedObjectArray<GIM_BVH_BUILD_TASK> stack;
+	GIM_BVH_BUILD_TASK root;
+	root.m_startIndex = 0;
+	root.m_endIndex = numPrimitives;
+	root.m_nodeIndex = 0;
+	stack.push_back(root);
+	while (stack.size())
+	{
+		const GIM_BVH_BUILD_TASK task = stack[stack.size() - 1];
+		stack.pop_back();
+		if (task.m_endIndex - task.m_startIndex <= taskSize)
+		{
+			tasks.push_back(task);
+			continue;
+		}
+
+		int splitIndex = _split_node(primitive_boxes, task.m_startIndex, task.m_endIndex, task.m_nodeIndex);
+
+		GIM_BVH_BUILD_TASK right;
+		right.m_startIndex = splitIndex;
+		right.m_endIndex = task.m_endIndex;
+		right.m_nodeIndex = task.m_nodeIndex + 2 * (splitIndex - task.m_startIndex);
+		stack.push_back(right);
 
-	_build_sub_tree(primitive_boxes, 0, primitive_boxes.size());
+		GIM_BVH_BUILD_TASK left;
+		left.m_startIndex = task.m_startIndex;
+		left.m_endIndex = splitIndex;
+		left.m_nodeIndex = task.m_nodeIndex + 1;
+		stack.push_back(left);
+	}
+
+	btQuantizedBvhTreeBuildLoop loop;
+	loop.m_tree = this;
+	loop.m_primitive_boxes = &primitive_boxes;
+	loop.m_tasks = &tasks[0];
+	btParallelFor(0, tasks.size(), 1, loop);
 }
 
 ////////////////////////////////////class btGImpactQuantizedBvh
 
-void btGImpactQuantizedBvh::refit()
+void btGImpactQuantizedBvh::refitNodes(int nodeBegin, int nodeEnd)
 {
-	int nodecount = getNodeCount();
-	while (nodecount--)
+	int nodecount = nodeEnd;
+	while (nodecount-- > nodeBegin)
 	{
 		if (isLeafNode(nodecount))
 		{
@@ -266,6 +338,83 @@ void btGImpactQuantizedBvh::refit()
 	}
 }
 
+struct btGImpactQuantizedBvhRefitLoop : public btIParallelForBody
+{
+	btGImpactQuantizedBvh* m_boxset;
+	const int* m_subtrees;
+
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+	{
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			const int node = m_subtrees[i];
+			const int numNodes = m_boxset->isLeafNode(node) ? 1 : m_boxset->getEscapeNodeIndex(node);
+			m_boxset->refitNodes(node, node + numNodes);
+		}
+	}
+};
+
+void btGImpactQuantizedBvh::refit()
+{
+	int nodecount = getNodeCount();
+	if (!nodecount || !gim_bvh_use_parallel(m_primitive_manager->get_primitive_count()))
+	{
+		refitNodes(0, nodecount);
+		return;
+	}
+
+	//refit the subtrees in parallel, then the top nodes above them, children before parents
+	const int taskNodes = 2 * gim_bvh_parallel_task_size(m_primitive_manager->get_primitive_count()) - 1;
+	btAlignedObjectArray<int> subtrees;
+	btAlignedObjectArray<int> topNodes;
+	btAlignedObjectArray<int> stack;
+	stack.push_back(0);
+	while (stack.size())
+	{
+		const int node = stack[stack.size() - 1];
+		stack.pop_back();
+		if (isLeafNode(node) || getEscapeNodeIndex(node) <= taskNodes)
+		{
+			subtrees.push_back(node);
+			continue;
+		}
+		topNodes.push_back(node);
+		stack.push_back(getRightNode(node));
+		stack.push_back(getLeftNode(node));
+	}
+
+	btGImpactQuantizedBvhRefitLoop loop;
+	loop.m_boxset = this;
+	loop.m_subtrees = &subtrees[0];
+	btParallelFor(0, subtrees.size(), 1, loop);
+
+	int i = topNodes.size();
+	while (i--)
+	{
+		refitNodes(topNodes[i], topNodes[i] + 1);
+	}
+}
+
+void btGImpactQuantizedBvh::getPrimitiveBoxes(GIM_BVH_DATA_ARRAY& primitive_boxes, int primitiveBegin, int primitiveEnd) const
+{
+	for (int i = primitiveBegin; i < primitiveEnd; i++)
+	{
+		m_primitive_manager->get_primitive_box(i, primitive_boxes[i].m_bound);
+		primitive_boxes[i].m_data = i;
+	}
+}
+
+struct btGImpactQuantizedBvhPrimitiveBoxesLoop : public btIParallelForBody
+{
+	const btGImpactQuantizedBvh* m_boxset;
+	GIM_BVH_DATA_ARRAY* m_primitive_boxes;
+
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+	{
+		m_boxset->getPrimitiveBoxes(*m_primitive_boxes, iBegin, iEnd);
+	}
+};
+
 //! this rebuild the entire set
 void btGImpactQuantizedBvh::buildSet()
 {
@@ -273,10 +422,16 @@ void btGImpactQuantizedBvh::buildSet()
 	GIM_BVH_DATA_ARRAY primitive_boxes;
 	primitive_boxes.resize(m_primitive_manager->get_primitive_count());
 
-	for (int i = 0; i < primitive_boxes.size(); i++)
+	if (gim_bvh_use_parallel(primitive_boxes.size()))
 	{
-		m_primitive_manager->get_primitive_box(i, primitive_boxes[i].m_bound);
-		primitive_boxes[i].m_data = i;
+		btGImpactQuantizedBvhPrimitiveBoxesLoop loop;
+		loop.m_boxset = this;
+		loop.m_primitive_boxes = &primitive_boxes;
+		btParallelFor(0, primitive_boxes.size(), GIM_BVH_PARALLEL_MIN_PRIMITIVES / 4, loop);
+	}
+	else
+	{
+		getPrimitiveBoxes(primitive_boxes, 0, primitive_boxes.size());
 	}
 
 	m_box_tree.build_tree(primitive_boxes);
@@ -463,6 +618,131 @@ static void _find_quantized_collision_pairs_recursive(
 	}      // else if node0 is not a leaf
 }
 
+struct btGImpactQuantizedBvhCollisionLoop : public btIParallelForBody
+{
+	const btGImpactQuantizedBvh* m_boxset0;
+	const btGImpactQuantizedBvh* m_boxset1;
+	const BT_BOX_BOX_TRANSFORM_CACHE* m_trans_cache_1to0;
+	const GIM_BVH_NODE_PAIR* m_node_pairs;
+	//the pairs of each task go to the buffer of its thread, in [m_task_begin, m_task_end)
+	btPairSet* m_thread_pairs;
+	int* m_task_thread;
+	int* m_task_begin;
+	int* m_task_end;
+
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+	{
+		const int threadIndex = btGetCurrentThreadIndex();
+		btPairSet& pairs = m_thread_pairs[threadIndex];
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			m_task_thread[i] = threadIndex;
+			m_task_begin[i] = pairs.size();
+			_find_quantized_collision_pairs_recursive(
+				m_boxset0, m_boxset1,
+				&pairs, *m_trans_cache_1to0,
+				m_node_pairs[i].m_node0, m_node_pairs[i].m_node1, m_node_pairs[i].m_complete_primitive_tests);
+			m_task_end[i] = pairs.size();
+		}
+	}
+};
+
+//! collides the trees with btParallelFor, the pairs come out in the order of the serial recursion
+static void _find_quantized_collision_pairs_parallel(
+	const btGImpactQuantizedBvh* boxset0, const btGImpactQuantizedBvh* boxset1,
+	btPairSet* collision_pairs,
+	const BT_BOX_BOX_TRANSFORM_CACHE& trans_cache_1to0)
+{
+	//expand the node pairs level by level, in the order the recursion visits them
+	const int minTasks = 16 * btGetTaskScheduler()->getNumThreads();
+	btAlignedObjectArray<GIM_BVH_NODE_PAIR> nodePairs;
+	btAlignedObjectArray<GIM_BVH_NODE_PAIR> nextNodePairs;
+	GIM_BVH_NODE_PAIR root;
+	root.m_node0 = 0;
+	root.m_node1 = 0;
+	root.m_complete_primitive_tests = true;
+	nodePairs.push_back(root);
+	bool expanded = true;
+	while (expanded && nodePairs.size() < minTasks)
+	{
+		expanded = false;
+		nextNodePairs.resize(0);
+		for (int i = 0; i < nodePairs.size(); i++)
+		{
+			const GIM_BVH_NODE_PAIR& nodePair = nodePairs[i];
+			const bool leaf0 = boxset0->isLeafNode(nodePair.m_node0);
+			const bool leaf1 = boxset1->isLeafNode(nodePair.m_node1);
+			if (leaf0 && leaf1)
+			{
+				nextNodePairs.push_back(nodePair);
+				continue;
+			}
+			if (_quantized_node_collision(
+					boxset0, boxset1, trans_cache_1to0,
+					nodePair.m_node0, nodePair.m_node1, nodePair.m_complete_primitive_tests) == false) continue;
+
+			expanded = true;
+			GIM_BVH_NODE_PAIR child;
+			child.m_complete_primitive_tests = false;
+			const int left0 = leaf0 ? nodePair.m_node0 : boxset0->getLeftNode(nodePair.m_node0);
+			const int right0 = leaf0 ? -1 : boxset0->getRightNode(nodePair.m_node0);
+			const int left1 = leaf1 ? nodePair.m_node1 : boxset1->getLeftNode(nodePair.m_node1);
+			const int right1 = leaf1 ? -1 : boxset1->getRightNode(nodePair.m_node1);
+
+			child.m_node0 = left0;
+			child.m_node1 = left1;
+			nextNodePairs.push_back(child);
+			if (right1 >= 0)
+			{
+				child.m_node1 = right1;
+				nextNodePairs.push_back(child);
+			}
+			if (right0 >= 0)
+			{
+				child.m_node0 = right0;
+				child.m_node1 = left1;
+				nextNodePairs.push_back(child);
+				if (right1 >= 0)
+				{
+					child.m_node1 = right1;
+					nextNodePairs.push_back(child);
+				}
+			}
+		}
+		nodePairs.copyFromArray(nextNodePairs);
+	}
+	if (nodePairs.size() == 0) return;
+
+	btAlignedObjectArray<btPairSet> threadPairs;
+	threadPairs.resize(BT_MAX_THREAD_COUNT);
+	btAlignedObjectArray<int> taskThread;
+	btAlignedObjectArray<int> taskBegin;
+	btAlignedObjectArray<int> taskEnd;
+	taskThread.resize(nodePairs.size());
+	taskBegin.resize(nodePairs.size());
+	taskEnd.resize(nodePairs.size());
+
+	btGImpactQuantizedBvhCollisionLoop loop;
+	loop.m_boxset0 = boxset0;
+	loop.m_boxset1 = boxset1;
+	loop.m_trans_cache_1to0 = &trans_cache_1to0;
+	loop.m_node_pairs = &nodePairs[0];
+	loop.m_thread_pairs = &threadPairs[0];
+	loop.m_task_thread = &taskThread[0];
+	loop.m_task_begin = &taskBegin[0];
+	loop.m_task_end = &taskEnd[0];
+	btParallelFor(0, nodePairs.size(), 1, loop);
+
+	for (int i = 0; i < nodePairs.size(); i++)
+	{
+		const btPairSet& pairs = threadPairs[taskThread[i]];
+		for (int j = taskBegin[i]; j < taskEnd[i]; j++)
+		{
+			collision_pairs->push_back(pairs[j]);
+		}
+	}
+}
+
 void btGImpactQuantizedBvh::find_collision(const btGImpactQuantizedBvh* boxset0, const btTransform& trans0,
 										   const btGImpactQuantizedBvh* boxset1, const btTransform& trans1,
 										   btPairSet& collision_pairs)
@@ -477,9 +757,18 @@ void btGImpactQuantizedBvh::find_collision(const btGImpactQuantizedBvh* boxset0,
 	bt_begin_gim02_q_tree_time();
 #endif  //TRI_COLLISION_PROFILING
 
-	_find_quantized_collision_pairs_recursive(
-		boxset0, boxset1,
-		&collision_pairs, trans_cache_1to0, 0, 0, true);
+	if (gim_bvh_use_parallel(btMin(boxset0->getPrimitiveManager()->get_primitive_count(), boxset1->getPrimitiveManager()->get_primitive_count())))
+	{
+		_find_quantized_collision_pairs_parallel(
+			boxset0, boxset1,
+			&collision_pairs, trans_cache_1to0);
+	}
+	else
+	{
+		_find_quantized_collision_pairs_recursive(
+			boxset0, boxset1,
+			&collision_pairs, trans_cache_1to0, 0, 0, true);
+	}
 #ifdef TRI_COLLISION_PROFILING
 	bt_end_gim02_q_tree_time();
 #endif  //TRI_COLLISION_PROFILING
@@ -50,7 +50,11 @@ protected:
 
 	int _calc_splitting_axis(GIM_BVH_DATA_ARRAY& primitive_boxes, int startIndex, int endIndex);
 
-	void _build_sub_tree(GIM_BVH_DATA_ARRAY& primitive_boxes, int startIndex, int endIndex);
+	//! calcs the bound and the escape index of node curIndex, sorts its primitives and returns the split index
+	int _split_node(GIM_BVH_DATA_ARRAY& primitive_boxes, int startIndex, int endIndex, int curIndex);
+
+	//! a subtree of n primitives takes 2n-1 nodes, so subtrees can be built at their node index independently
+	void _build_sub_tree(GIM_BVH_DATA_ARRAY& primitive_boxes, int startIndex, int endIndex, int curIndex);
 
 public:
 	btQuantizedBvhTree()
@@ -62,6 +66,9 @@ public:
 	//!@{
 	void build_tree(GIM_BVH_DATA_ARRAY& primitive_boxes);
 
+	//! builds the subtrees of the tasks, can be called in parallel
+	void build_sub_trees(GIM_BVH_DATA_ARRAY& primitive_boxes, const GIM_BVH_BUILD_TASK* tasks, int taskBegin, int taskEnd);
+
 	SIMD_FORCE_INLINE void quantizePoint(
 		unsigned short* quantizedpoint, const btVector3& point) const
 	{
@@ -164,6 +171,12 @@ protected:
 	void refit();
 
 public:
+	//! refits the nodes in [nodeBegin, nodeEnd) from the last to the first, can be called in parallel for separate subtrees
+	void refitNodes(int nodeBegin, int nodeEnd);
+
+	//! gets the primitive boxes in [primitiveBegin, primitiveEnd), can be called in parallel
+	void getPrimitiveBoxes(GIM_BVH_DATA_ARRAY& primitive_boxes, int primitiveBegin, int primitiveEnd) const;
+
 	//! this constructor doesn't build the tree. you must call	buildSet
 	btGImpactQuantizedBvh()
 	{
@@ -21,8 +21,8 @@ subject to the following restrictions:
 #include "btGjkCollisionDescription.h"
 #include "BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h"
 
-template <typename btConvexTemplate>
-bool btGjkEpaCalcPenDepth(const btConvexTemplate& a, const btConvexTemplate& b,
+template <typename btConvexTemplateA, typename btConvexTemplateB>
+bool btGjkEpaCalcPenDepth(const btConvexTemplateA& a, const btConvexTemplateB& b,
 						  const btGjkCollisionDescription& colDesc,
 						  btVector3& v, btVector3& wWitnessOnA, btVector3& wWitnessOnB)
 {
@@ -57,8 +57,8 @@ bool btGjkEpaCalcPenDepth(const btConvexTemplate& a, const btConvexTemplate& b,
 	return false;
 }
 
-template <typename btConvexTemplate, typename btGjkDistanceTemplate>
-int btComputeGjkEpaPenetration(const btConvexTemplate& a, const btConvexTemplate& b, const btGjkCollisionDescription& colDesc, btVoronoiSimplexSolver& simplexSolver, btGjkDistanceTemplate* distInfo)
+template <typename btConvexTemplateA, typename btConvexTemplateB, typename btGjkDistanceTemplate>
+int btComputeGjkEpaPenetration(const btConvexTemplateA& a, const btConvexTemplateB& b, const btGjkCollisionDescription& colDesc, btVoronoiSimplexSolver& simplexSolver, btGjkDistanceTemplate* distInfo)
 {
 	bool m_catchDegeneracies = true;
 	btScalar m_cachedSeparatingDistance = 0.f;
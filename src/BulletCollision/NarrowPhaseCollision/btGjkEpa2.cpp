@@ -930,7 +930,7 @@ using namespace gjkepa2_impl;
 //
 int btGjkEpaSolver2::StackSizeRequirement()
 {
-	return (sizeof(GJK) + sizeof(EPA));
+	return (sizeof(gjkepa2_impl::GJK) + sizeof(gjkepa2_impl::EPA));
 }
 
 //
@@ -943,9 +943,9 @@ bool btGjkEpaSolver2::Distance(const btConvexShape* shape0,
 {
 	tShape shape;
 	Initialize(shape0, wtrs0, shape1, wtrs1, results, shape, false);
-	GJK gjk;
-	GJK::eStatus::_ gjk_status = gjk.Evaluate(shape, guess);
-	if (gjk_status == GJK::eStatus::Valid)
+	gjkepa2_impl::GJK gjk;
+	gjkepa2_impl::GJK::eStatus::_ gjk_status = gjk.Evaluate(shape, guess);
+	if (gjk_status == gjkepa2_impl::GJK::eStatus::Valid)
 	{
 		btVector3 w0 = btVector3(0, 0, 0);
 		btVector3 w1 = btVector3(0, 0, 0);
@@ -964,7 +964,7 @@ bool btGjkEpaSolver2::Distance(const btConvexShape* shape0,
 	}
 	else
 	{
-		results.status = gjk_status == GJK::eStatus::Inside ? sResults::Penetrating : sResults::GJK_Failed;
+		results.status = gjk_status == gjkepa2_impl::GJK::eStatus::Inside ? sResults::Penetrating : sResults::GJK_Failed;
 		return (false);
 	}
 }
@@ -980,15 +980,15 @@ bool btGjkEpaSolver2::Penetration(const btConvexShape* shape0,
 {
 	tShape shape;
 	Initialize(shape0, wtrs0, shape1, wtrs1, results, shape, usemargins);
-	GJK gjk;
-	GJK::eStatus::_ gjk_status = gjk.Evaluate(shape, -guess);
+	gjkepa2_impl::GJK gjk;
+	gjkepa2_impl::GJK::eStatus::_ gjk_status = gjk.Evaluate(shape, -guess);
 	switch (gjk_status)
 	{
-		case GJK::eStatus::Inside:
+		case gjkepa2_impl::GJK::eStatus::Inside:
 		{
-			EPA epa;
-			EPA::eStatus::_ epa_status = epa.Evaluate(gjk, -guess);
-			if (epa_status != EPA::eStatus::Failed)
+			gjkepa2_impl::EPA epa;
+			gjkepa2_impl::EPA::eStatus::_ epa_status = epa.Evaluate(gjk, -guess);
+			if (epa_status != gjkepa2_impl::EPA::eStatus::Failed)
 			{
 				btVector3 w0 = btVector3(0, 0, 0);
 				for (U i = 0; i < epa.m_result.rank; ++i)
@@ -1006,7 +1006,7 @@ bool btGjkEpaSolver2::Penetration(const btConvexShape* shape0,
 				results.status = sResults::EPA_Failed;
 		}
 		break;
-		case GJK::eStatus::Failed:
+		case gjkepa2_impl::GJK::eStatus::Failed:
 			results.status = sResults::GJK_Failed;
 			break;
 		default:
@@ -1028,9 +1028,9 @@ btScalar btGjkEpaSolver2::SignedDistance(const btVector3& position,
 	btSphereShape shape1(margin);
 	btTransform wtrs1(btQuaternion(0, 0, 0, 1), position);
 	Initialize(shape0, wtrs0, &shape1, wtrs1, results, shape, false);
-	GJK gjk;
-	GJK::eStatus::_ gjk_status = gjk.Evaluate(shape, btVector3(1, 1, 1));
-	if (gjk_status == GJK::eStatus::Valid)
+	gjkepa2_impl::GJK gjk;
+	gjkepa2_impl::GJK::eStatus::_ gjk_status = gjk.Evaluate(shape, btVector3(1, 1, 1));
+	if (gjk_status == gjkepa2_impl::GJK::eStatus::Valid)
 	{
 		btVector3 w0 = btVector3(0, 0, 0);
 		btVector3 w1 = btVector3(0, 0, 0);
@@ -1054,7 +1054,7 @@ btScalar btGjkEpaSolver2::SignedDistance(const btVector3& position,
 	}
 	else
 	{
-		if (gjk_status == GJK::eStatus::Inside)
+		if (gjk_status == gjkepa2_impl::GJK::eStatus::Inside)
 		{
 			if (Penetration(shape0, wtrs0, &shape1, wtrs1, gjk.m_ray, results))
 			{
@@ -79,18 +79,18 @@ typedef unsigned int U;
 typedef unsigned char U1;
 
 // MinkowskiDiff
-template <typename btConvexTemplate>
+template <typename btConvexTemplateA, typename btConvexTemplateB = btConvexTemplateA>
 struct MinkowskiDiff
 {
-	const btConvexTemplate* m_convexAPtr;
-	const btConvexTemplate* m_convexBPtr;
+	const btConvexTemplateA* m_convexAPtr;
+	const btConvexTemplateB* m_convexBPtr;
 
 	btMatrix3x3 m_toshape1;
 	btTransform m_toshape0;
 
 	bool m_enableMargin;
 
-	MinkowskiDiff(const btConvexTemplate& a, const btConvexTemplate& b)
+	MinkowskiDiff(const btConvexTemplateA& a, const btConvexTemplateB& b)
 		: m_convexAPtr(&a),
 		  m_convexBPtr(&b)
 	{
@@ -130,7 +130,7 @@ enum eGjkStatus
 };
 
 // GJK
-template <typename btConvexTemplate>
+template <typename btConvexTemplateA, typename btConvexTemplateB = btConvexTemplateA>
 struct GJK
 {
 	/* Types		*/
@@ -147,7 +147,7 @@ struct GJK
 
 	/* Fields		*/
 
-	MinkowskiDiff<btConvexTemplate> m_shape;
+	MinkowskiDiff<btConvexTemplateA, btConvexTemplateB> m_shape;
 	btVector3 m_ray;
 	btScalar m_distance;
 	sSimplex m_simplices[2];
@@ -159,7 +159,7 @@ struct GJK
 	eGjkStatus m_status;
 	/* Methods		*/
 
-	GJK(const btConvexTemplate& a, const btConvexTemplate& b)
+	GJK(const btConvexTemplateA& a, const btConvexTemplateB& b)
 		: m_shape(a, b)
 	{
 		Initialize();
@@ -172,7 +172,7 @@ struct GJK
 		m_current = 0;
 		m_distance = 0;
 	}
-	eGjkStatus Evaluate(const MinkowskiDiff<btConvexTemplate>& shapearg, const btVector3& guess)
+	eGjkStatus Evaluate(const MinkowskiDiff<btConvexTemplateA, btConvexTemplateB>& shapearg, const btVector3& guess)
 	{
 		U iterations = 0;
 		btScalar sqdist = 0;
@@ -540,7 +540,7 @@ enum eEpaStatus
 };
 
 // EPA
-template <typename btConvexTemplate>
+template <typename btConvexTemplateA, typename btConvexTemplateB = btConvexTemplateA>
 struct EPA
 {
 	/* Types		*/
@@ -549,7 +549,7 @@ struct EPA
 	{
 		btVector3 n;
 		btScalar d;
-		typename GJK<btConvexTemplate>::sSV* c[3];
+		typename GJK<btConvexTemplateA, btConvexTemplateB>::sSV* c[3];
 		sFace* f[3];
 		sFace* l[2];
 		U1 e[3];
@@ -571,10 +571,10 @@ struct EPA
 
 	/* Fields		*/
 	eEpaStatus m_status;
-	typename GJK<btConvexTemplate>::sSimplex m_result;
+	typename GJK<btConvexTemplateA, btConvexTemplateB>::sSimplex m_result;
 	btVector3 m_normal;
 	btScalar m_depth;
-	typename GJK<btConvexTemplate>::sSV m_sv_store[EPA_MAX_VERTICES];
+	typename GJK<btConvexTemplateA, btConvexTemplateB>::sSV m_sv_store[EPA_MAX_VERTICES];
 	sFace m_fc_store[EPA_MAX_FACES];
 	U m_nextsv;
 	sList m_hull;
@@ -619,9 +619,9 @@ struct EPA
 			append(m_stock, &m_fc_store[EPA_MAX_FACES - i - 1]);
 		}
 	}
-	eEpaStatus Evaluate(GJK<btConvexTemplate>& gjk, const btVector3& guess)
+	eEpaStatus Evaluate(GJK<btConvexTemplateA, btConvexTemplateB>& gjk, const btVector3& guess)
 	{
-		typename GJK<btConvexTemplate>::sSimplex& simplex = *gjk.m_simplex;
+		typename GJK<btConvexTemplateA, btConvexTemplateB>::sSimplex& simplex = *gjk.m_simplex;
 		if ((simplex.rank > 1) && gjk.EncloseOrigin())
 		{
 			/* Clean up				*/
@@ -664,7 +664,7 @@ struct EPA
 					if (m_nextsv < EPA_MAX_VERTICES)
 					{
 						sHorizon horizon;
-						typename GJK<btConvexTemplate>::sSV* w = &m_sv_store[m_nextsv++];
+						typename GJK<btConvexTemplateA, btConvexTemplateB>::sSV* w = &m_sv_store[m_nextsv++];
 						bool valid = true;
 						best->pass = (U1)(++pass);
 						gjk.getsupport(best->n, *w);
@@ -740,7 +740,7 @@ struct EPA
 		m_result.p[0] = 1;
 		return (m_status);
 	}
-	bool getedgedist(sFace* face, typename GJK<btConvexTemplate>::sSV* a, typename GJK<btConvexTemplate>::sSV* b, btScalar& dist)
+	bool getedgedist(sFace* face, typename GJK<btConvexTemplateA, btConvexTemplateB>::sSV* a, typename GJK<btConvexTemplateA, btConvexTemplateB>::sSV* b, btScalar& dist)
 	{
 		const btVector3 ba = b->w - a->w;
 		const btVector3 n_ab = btCross(ba, face->n);   // Outward facing edge normal direction, on triangle plane
@@ -776,7 +776,7 @@ struct EPA
 
 		return false;
 	}
-	sFace* newface(typename GJK<btConvexTemplate>::sSV* a, typename GJK<btConvexTemplate>::sSV* b, typename GJK<btConvexTemplate>::sSV* c, bool forced)
+	sFace* newface(typename GJK<btConvexTemplateA, btConvexTemplateB>::sSV* a, typename GJK<btConvexTemplateA, btConvexTemplateB>::sSV* b, typename GJK<btConvexTemplateA, btConvexTemplateB>::sSV* c, bool forced)
 	{
 		if (m_stock.root)
 		{
@@ -835,7 +835,7 @@ struct EPA
 		}
 		return (minf);
 	}
-	bool expand(U pass, typename GJK<btConvexTemplate>::sSV* w, sFace* f, U e, sHorizon& horizon)
+	bool expand(U pass, typename GJK<btConvexTemplateA, btConvexTemplateB>::sSV* w, sFace* f, U e, sHorizon& horizon)
 	{
 		static const U i1m3[] = {1, 2, 0};
 		static const U i2m3[] = {2, 0, 1};
@@ -874,10 +874,10 @@ struct EPA
 	}
 };
 
-template <typename btConvexTemplate>
-static void Initialize(const btConvexTemplate& a, const btConvexTemplate& b,
+template <typename btConvexTemplateA, typename btConvexTemplateB>
+static void Initialize(const btConvexTemplateA& a, const btConvexTemplateB& b,
 					   btGjkEpaSolver3::sResults& results,
-					   MinkowskiDiff<btConvexTemplate>& shape)
+					   MinkowskiDiff<btConvexTemplateA, btConvexTemplateB>& shape)
 {
 	/* Results		*/
 	results.witnesses[0] =
@@ -894,15 +894,16 @@ static void Initialize(const btConvexTemplate& a, const btConvexTemplate& b,
 //
 
 //
-template <typename btConvexTemplate>
-bool btGjkEpaSolver3_Distance(const btConvexTemplate& a, const btConvexTemplate& b,
+template <typename btConvexTemplateA, typename btConvexTemplateB>
+bool btGjkEpaSolver3_Distance(const btConvexTemplateA& a, const btConvexTemplateB& b,
 							  const btVector3& guess,
 							  btGjkEpaSolver3::sResults& results)
 {
-	MinkowskiDiff<btConvexTemplate> shape(a, b);
+	MinkowskiDiff<btConvexTemplateA, btConvexTemplateB> shape(a, b);
 	Initialize(a, b, results, shape);
-	GJK<btConvexTemplate> gjk(a, b);
-	eGjkStatus gjk_status = gjk.Evaluate(shape, guess);
+	GJK<btConvexTemplateA, btConvexTemplateB> gjk(a, b);
+	//the Minkowski difference lives in the local space of a
+	eGjkStatus gjk_status = gjk.Evaluate(shape, guess * a.getWorldTransform().getBasis());
 	if (gjk_status == eGjkValid)
 	{
 		btVector3 w0 = btVector3(0, 0, 0);
@@ -915,7 +916,7 @@ bool btGjkEpaSolver3_Distance(const btConvexTemplate& a, const btConvexTemplate&
 		}
 		results.witnesses[0] = a.getWorldTransform() * w0;
 		results.witnesses[1] = a.getWorldTransform() * w1;
-		results.normal = w0 - w1;
+		results.normal = a.getWorldTransform().getBasis() * (w0 - w1);
 		results.distance = results.normal.length();
 		results.normal /= results.distance > GJK_MIN_DISTANCE ? results.distance : 1;
 		return (true);
@@ -927,22 +928,24 @@ bool btGjkEpaSolver3_Distance(const btConvexTemplate& a, const btConvexTemplate&
 	}
 }
 
-template <typename btConvexTemplate>
-bool btGjkEpaSolver3_Penetration(const btConvexTemplate& a,
-								 const btConvexTemplate& b,
+template <typename btConvexTemplateA, typename btConvexTemplateB>
+bool btGjkEpaSolver3_Penetration(const btConvexTemplateA& a,
+								 const btConvexTemplateB& b,
 								 const btVector3& guess,
 								 btGjkEpaSolver3::sResults& results)
 {
-	MinkowskiDiff<btConvexTemplate> shape(a, b);
+	MinkowskiDiff<btConvexTemplateA, btConvexTemplateB> shape(a, b);
 	Initialize(a, b, results, shape);
-	GJK<btConvexTemplate> gjk(a, b);
-	eGjkStatus gjk_status = gjk.Evaluate(shape, -guess);
+	GJK<btConvexTemplateA, btConvexTemplateB> gjk(a, b);
+	//the Minkowski difference lives in the local space of a
+	const btVector3 localGuess = guess * a.getWorldTransform().getBasis();
+	eGjkStatus gjk_status = gjk.Evaluate(shape, -localGuess);
 	switch (gjk_status)
 	{
 		case eGjkInside:
 		{
-			EPA<btConvexTemplate> epa;
-			eEpaStatus epa_status = epa.Evaluate(gjk, -guess);
+			EPA<btConvexTemplateA, btConvexTemplateB> epa;
+			eEpaStatus epa_status = epa.Evaluate(gjk, -localGuess);
 			if (epa_status != eEpaFailed)
 			{
 				btVector3 w0 = btVector3(0, 0, 0);
@@ -953,7 +956,7 @@ bool btGjkEpaSolver3_Penetration(const btConvexTemplate& a,
 				results.status = btGjkEpaSolver3::sResults::Penetrating;
 				results.witnesses[0] = a.getWorldTransform() * w0;
 				results.witnesses[1] = a.getWorldTransform() * (w0 - epa.m_normal * epa.m_depth);
-				results.normal = -epa.m_normal;
+				results.normal = -(a.getWorldTransform().getBasis() * epa.m_normal);
 				results.distance = -epa.m_depth;
 				return (true);
 			}
@@ -1020,8 +1023,8 @@ int	btComputeGjkEpaPenetration2(const btCollisionDescription& colDesc, btDistanc
 }
 #endif
 
-template <typename btConvexTemplate, typename btDistanceInfoTemplate>
-int btComputeGjkDistance(const btConvexTemplate& a, const btConvexTemplate& b,
+template <typename btConvexTemplateA, typename btConvexTemplateB, typename btDistanceInfoTemplate>
+int btComputeGjkDistance(const btConvexTemplateA& a, const btConvexTemplateB& b,
 						 const btGjkCollisionDescription& colDesc, btDistanceInfoTemplate* distInfo)
 {
 	btGjkEpaSolver3::sResults results;
@@ -48,6 +48,7 @@ btGjkPairDetector::btGjkPairDetector(const btConvexShape *objectA, const btConve
 	  m_marginA(objectA->getMargin()),
 	  m_marginB(objectB->getMargin()),
 	  m_ignoreMargin(false),
+	  m_warmStart(false),
 	  m_lastUsedMethod(-1),
 	  m_catchDegeneracies(1),
 	  m_fixContactNormalDirection(1)
@@ -64,6 +65,7 @@ btGjkPairDetector::btGjkPairDetector(const btConvexShape *objectA, const btConve
 	  m_marginA(marginA),
 	  m_marginB(marginB),
 	  m_ignoreMargin(false),
+	  m_warmStart(false),
 	  m_lastUsedMethod(-1),
 	  m_catchDegeneracies(1),
 	  m_fixContactNormalDirection(1)
@@ -715,7 +717,10 @@ void btGjkPairDetector::getClosestPointsNonVirtual(const ClosestPointInput &inpu
 
 	m_curIter = 0;
 	int gGjkMaxIter = 1000;  //this is to catch invalid input, perhaps check for #NaN?
-	m_cachedSeparatingAxis.setValue(0, 1, 0);
+	if (!m_warmStart || m_cachedSeparatingAxis.length2() < SIMD_EPSILON)
+	{
+		m_cachedSeparatingAxis.setValue(0, 1, 0);
+	}
 
 	bool isValid = false;
 	bool checkSimplex = false;
@@ -37,6 +37,7 @@ class btGjkPairDetector : public btDiscreteCollisionDetectorInterface
 	btScalar m_marginB;
 
 	bool m_ignoreMargin;
+	bool m_warmStart;
 	btScalar m_cachedSeparatingDistance;
 
 public:
@@ -69,6 +70,13 @@ public:
 		m_cachedSeparatingAxis = separatingAxis;
 	}
 
+	///start getClosestPoints from the cached separating axis, for example the one of the previous frame,
+	///instead of a fixed direction
+	void setWarmStart(bool warmStart)
+	{
+		m_warmStart = warmStart;
+	}
+
 	const btVector3& getCachedSeparatingAxis() const
 	{
 		return m_cachedSeparatingAxis;
@@ -161,8 +161,8 @@ inline int btMprVec3Eq(const btVector3 *a, const btVector3 *b)
 	return btMprEq((*a).x(), (*b).x()) && btMprEq((*a).y(), (*b).y()) && btMprEq((*a).z(), (*b).z());
 }
 
-template <typename btConvexTemplate>
-inline void btFindOrigin(const btConvexTemplate &a, const btConvexTemplate &b, const btMprCollisionDescription &colDesc, btMprSupport_t *center)
+template <typename btConvexTemplateA, typename btConvexTemplateB>
+inline void btFindOrigin(const btConvexTemplateA &a, const btConvexTemplateB &b, const btMprCollisionDescription &colDesc, btMprSupport_t *center)
 {
 	center->v1 = a.getObjectCenterInWorld();
 	center->v2 = b.getObjectCenterInWorld();
@@ -304,8 +304,8 @@ inline void btExpandPortal(btMprSimplex_t *portal,
 		}
 	}
 }
-template <typename btConvexTemplate>
-inline void btMprSupport(const btConvexTemplate &a, const btConvexTemplate &b,
+template <typename btConvexTemplateA, typename btConvexTemplateB>
+inline void btMprSupport(const btConvexTemplateA &a, const btConvexTemplateB &b,
 						 const btMprCollisionDescription &colDesc,
 						 const btVector3 &dir, btMprSupport_t *supp)
 {
@@ -320,8 +320,8 @@ inline void btMprSupport(const btConvexTemplate &a, const btConvexTemplate &b,
 	supp->v = supp->v1 - supp->v2;
 }
 
-template <typename btConvexTemplate>
-static int btDiscoverPortal(const btConvexTemplate &a, const btConvexTemplate &b,
+template <typename btConvexTemplateA, typename btConvexTemplateB>
+static int btDiscoverPortal(const btConvexTemplateA &a, const btConvexTemplateB &b,
 							const btMprCollisionDescription &colDesc,
 							btMprSimplex_t *portal)
 {
@@ -457,8 +457,8 @@ static int btDiscoverPortal(const btConvexTemplate &a, const btConvexTemplate &b
 	return 0;
 }
 
-template <typename btConvexTemplate>
-static int btRefinePortal(const btConvexTemplate &a, const btConvexTemplate &b, const btMprCollisionDescription &colDesc,
+template <typename btConvexTemplateA, typename btConvexTemplateB>
+static int btRefinePortal(const btConvexTemplateA &a, const btConvexTemplateB &b, const btMprCollisionDescription &colDesc,
 						  btMprSimplex_t *portal)
 {
 	btVector3 dir;
@@ -726,8 +726,8 @@ inline float btMprVec3PointTriDist2(const btVector3 *P,
 	return dist;
 }
 
-template <typename btConvexTemplate>
-static void btFindPenetr(const btConvexTemplate &a, const btConvexTemplate &b,
+template <typename btConvexTemplateA, typename btConvexTemplateB>
+static void btFindPenetr(const btConvexTemplateA &a, const btConvexTemplateB &b,
 						 const btMprCollisionDescription &colDesc,
 						 btMprSimplex_t *portal,
 						 float *depth, btVector3 *pdir, btVector3 *pos)
@@ -809,8 +809,8 @@ static void btFindPenetrSegment(btMprSimplex_t *portal,
 	btMprVec3Normalize(dir);
 }
 
-template <typename btConvexTemplate>
-inline int btMprPenetration(const btConvexTemplate &a, const btConvexTemplate &b,
+template <typename btConvexTemplateA, typename btConvexTemplateB>
+inline int btMprPenetration(const btConvexTemplateA &a, const btConvexTemplateB &b,
 							const btMprCollisionDescription &colDesc,
 							float *depthOut, btVector3 *dirOut, btVector3 *posOut)
 {
@@ -862,8 +862,8 @@ inline int btMprPenetration(const btConvexTemplate &a, const btConvexTemplate &b
 	return result;
 };
 
-template <typename btConvexTemplate, typename btMprDistanceTemplate>
-inline int btComputeMprPenetration(const btConvexTemplate &a, const btConvexTemplate &b, const btMprCollisionDescription &colDesc, btMprDistanceTemplate *distInfo)
+template <typename btConvexTemplateA, typename btConvexTemplateB, typename btMprDistanceTemplate>
+inline int btComputeMprPenetration(const btConvexTemplateA &a, const btConvexTemplateB &b, const btMprCollisionDescription &colDesc, btMprDistanceTemplate *distInfo)
 {
 	btVector3 dir, pos;
 	float depth;
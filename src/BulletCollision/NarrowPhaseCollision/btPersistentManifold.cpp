@@ -37,6 +37,7 @@ btPersistentManifold::btPersistentManifold()
 	  m_body0(0),
 	  m_body1(0),
 	  m_cachedPoints(0),
+	  m_speculativeDistance(0),
 	  m_companionIdA(0),
 	  m_companionIdB(0),
 	  m_index1a(0)
@@ -191,7 +192,7 @@ int btPersistentManifold::sortCachedPoints(const btManifoldPoint& pt)
 
 int btPersistentManifold::getCacheEntry(const btManifoldPoint& newPoint) const
 {
-	btScalar shortestDist = getContactBreakingThreshold() * getContactBreakingThreshold();
+	btScalar shortestDist = m_contactBreakingThreshold * m_contactBreakingThreshold;
 	int size = getNumContacts();
 	int nearestPoint = -1;
 	for (int i = 0; i < size; i++)
@@ -241,7 +242,7 @@ int btPersistentManifold::addManifoldPoint(const btManifoldPoint& newPoint, bool
 
 btScalar btPersistentManifold::getContactBreakingThreshold() const
 {
-	return m_contactBreakingThreshold;
+	return m_contactBreakingThreshold + m_speculativeDistance;
 }
 
 void btPersistentManifold::refreshContactPoints(const btTransform& trA, const btTransform& trB)
@@ -284,7 +285,7 @@ void btPersistentManifold::refreshContactPoints(const btTransform& trA, const bt
 			projectedPoint = manifoldPoint.m_positionWorldOnA - manifoldPoint.m_normalWorldOnB * manifoldPoint.m_distance1;
 			projectedDifference = manifoldPoint.m_positionWorldOnB - projectedPoint;
 			distance2d = projectedDifference.dot(projectedDifference);
-			if (distance2d > getContactBreakingThreshold() * getContactBreakingThreshold())
+			if (distance2d > m_contactBreakingThreshold * m_contactBreakingThreshold)
 			{
 				removeContactPoint(i);
 			}
@@ -313,7 +314,7 @@ const char* btPersistentManifold::serialize(const class btPersistentManifold* ma
 
 	dataOut->m_body0 = (btCollisionObjectData*)serializer->getUniquePointer((void*)manifold->getBody0());
 	dataOut->m_body1 = (btCollisionObjectData*)serializer->getUniquePointer((void*)manifold->getBody1());
-	dataOut->m_contactBreakingThreshold = manifold->getContactBreakingThreshold();
+	dataOut->m_contactBreakingThreshold = manifold->m_contactBreakingThreshold;
 	dataOut->m_contactProcessingThreshold = manifold->getContactProcessingThreshold();
 	dataOut->m_numCachedPoints = manifold->getNumContacts();
 	dataOut->m_companionIdA = manifold->m_companionIdA;
@@ -361,6 +362,7 @@ void btPersistentManifold::deSerialize(const struct btPersistentManifoldDoubleDa
 {
 	m_contactBreakingThreshold = manifoldDataPtr->m_contactBreakingThreshold;
 	m_contactProcessingThreshold = manifoldDataPtr->m_contactProcessingThreshold;
+	m_speculativeDistance = 0;
 	m_cachedPoints = manifoldDataPtr->m_numCachedPoints;
 	m_companionIdA = manifoldDataPtr->m_companionIdA;
 	m_companionIdB = manifoldDataPtr->m_companionIdB;
@@ -407,6 +409,7 @@ void btPersistentManifold::deSerialize(const struct btPersistentManifoldFloatDat
 {
 	m_contactBreakingThreshold = manifoldDataPtr->m_contactBreakingThreshold;
 	m_contactProcessingThreshold = manifoldDataPtr->m_contactProcessingThreshold;
+	m_speculativeDistance = 0;
 	m_cachedPoints = manifoldDataPtr->m_numCachedPoints;
 	m_companionIdA = manifoldDataPtr->m_companionIdA;
 	m_companionIdB = manifoldDataPtr->m_companionIdB;
@@ -73,6 +73,7 @@ btPersistentManifold : public btTypedObject
 
 	btScalar m_contactBreakingThreshold;
 	btScalar m_contactProcessingThreshold;
+	btScalar m_speculativeDistance;
 
 	/// sort cached points so most isolated points come first
 	int sortCachedPoints(const btManifoldPoint& pt);
@@ -96,6 +97,7 @@ public:
 		  m_cachedPoints(0),
 		  m_contactBreakingThreshold(contactBreakingThreshold),
 		  m_contactProcessingThreshold(contactProcessingThreshold),
+		  m_speculativeDistance(0),
 		  m_companionIdA(0),
 		  m_companionIdB(0),
 		  m_index1a(0)
@@ -140,6 +142,7 @@ public:
 	}
 
 	///@todo: get this margin from the current physics / collision environment
+	///includes the speculative distance
 	btScalar getContactBreakingThreshold() const;
 
 	btScalar getContactProcessingThreshold() const
@@ -157,6 +160,18 @@ public:
 		m_contactProcessingThreshold = contactProcessingThreshold;
 	}
 
+	///extra distance of the contacts, the distance the bodies can close in the step with speculative contacts (see
+	///btDispatcherInfo::m_useSpeculativeContacts). Contact points are still merged within the contact breaking threshold alone
+	btScalar getSpeculativeDistance() const
+	{
+		return m_speculativeDistance;
+	}
+
+	void setSpeculativeDistance(btScalar speculativeDistance)
+	{
+		m_speculativeDistance = speculativeDistance;
+	}
+
 	int getCacheEntry(const btManifoldPoint& newPoint) const;
 
 	int addManifoldPoint(const btManifoldPoint& newPoint, bool isPredictive = false);
@@ -233,7 +233,193 @@ SIMD_FORCE_INLINE void btSegmentsClosestPoints(
 	ptsVector = translation - offsetA + offsetB;
 }
 
-bool btPolyhedralContactClipping::findSeparatingAxis(const btConvexPolyhedron& hullA, const btConvexPolyhedron& hullB, const btTransform& transA, const btTransform& transB, btVector3& sep, btDiscreteCollisionDetectorInterface::Result& resultOut)
+//the edges a and b, with the normals of their adjacent faces, form a face of the Minkowski difference if their
+//arcs on the Gauss map intersect. c and d are the negated normals of the faces of edge b, bxa = b_x_a and dxc = d_x_c
+SIMD_FORCE_INLINE bool btIsMinkowskiFace(const btVector3& a, const btVector3& b, const btVector3& bxa, const btVector3& c, const btVector3& d, const btVector3& dxc)
+{
+	const btScalar cba = c.dot(bxa);
+	const btScalar dba = d.dot(bxa);
+	const btScalar adc = a.dot(dxc);
+	const btScalar bdc = b.dot(dxc);
+	return cba * dba < btScalar(0.) && adc * bdc < btScalar(0.) && cba * bdc > btScalar(0.);
+}
+
+//the edge pair of minimum penetration depth over the pairs that form a face of the Minkowski difference, in the space
+//of hullA. Returns false if one of the pairs separates the hulls
+static bool btFindSeparatingEdgePair(const btConvexPolyhedron& hullA, const btConvexPolyhedron& hullB, const btTransform& transA, const btTransform& transB,
+									 btScalar& dmin, int& edgeA, int& edgeB, btVector3& sep)
+{
+	const btTransform relB = transA.inverseTimes(transB);
+	const btScalar parallelTolerance = btScalar(0.005);
+
+	for (int e1 = 0; e1 < hullB.m_edges.size(); e1++)
+	{
+		const btPolyhedronEdge& edge1 = hullB.m_edges[e1];
+		const btVector3 pointB = relB * hullB.m_vertices[edge1.m_vertex0];
+		const btVector3 dirB = relB.getBasis() * (hullB.m_vertices[edge1.m_vertex1] - hullB.m_vertices[edge1.m_vertex0]);
+		const btFace& faceC = hullB.m_faces[edge1.m_face0];
+		const btFace& faceD = hullB.m_faces[edge1.m_face1];
+		const btVector3 c = -(relB.getBasis() * btVector3(faceC.m_plane[0], faceC.m_plane[1], faceC.m_plane[2]));
+		const btVector3 d = -(relB.getBasis() * btVector3(faceD.m_plane[0], faceD.m_plane[1], faceD.m_plane[2]));
+		const btVector3 dxc = d.cross(c);
+
+		for (int e0 = 0; e0 < hullA.m_edges.size(); e0++)
+		{
+			const btPolyhedronEdge& edge0 = hullA.m_edges[e0];
+			const btFace& faceA = hullA.m_faces[edge0.m_face0];
+			const btFace& faceB = hullA.m_faces[edge0.m_face1];
+			const btVector3 a(faceA.m_plane[0], faceA.m_plane[1], faceA.m_plane[2]);
+			const btVector3 b(faceB.m_plane[0], faceB.m_plane[1], faceB.m_plane[2]);
+			const btVector3 bxa = b.cross(a);
+			if (!btIsMinkowskiFace(a, b, bxa, c, d, dxc))
+				continue;
+
+			const btVector3& pointA = hullA.m_vertices[edge0.m_vertex0];
+			const btVector3 dirA = hullA.m_vertices[edge0.m_vertex1] - pointA;
+			btVector3 axis = dirA.cross(dirB);
+			const btScalar length2 = axis.length2();
+			if (length2 < parallelTolerance * parallelTolerance * dirA.length2() * dirB.length2())
+				continue;
+			axis /= btSqrt(length2);
+			//outward from hullA
+			if (axis.dot(pointA - hullA.m_localCenter) < btScalar(0.))
+				axis = -axis;
+
+			const btScalar separation = axis.dot(pointB - pointA);
+			if (separation > btScalar(0.))
+			{
+				edgeA = e0;
+				edgeB = e1;
+				return false;
+			}
+			if (-separation < dmin)
+			{
+				dmin = -separation;
+				edgeA = e0;
+				edgeB = e1;
+				sep = -axis;
+			}
+		}
+	}
+	return true;
+}
+
+//add an edge-edge contact at the closest points of the lines through the witness points
+static void btAddEdgeEdgeContact(const btVector3& witnessPointA, const btVector3& witnessPointB, const btVector3& worldEdgeA, const btVector3& worldEdgeB, const btVector3& DeltaC2, btDiscreteCollisionDetectorInterface::Result& resultOut)
+{
+	btVector3 ptsVector;
+	btVector3 offsetA;
+	btVector3 offsetB;
+	btScalar tA;
+	btScalar tB;
+
+	btVector3 translation = witnessPointB - witnessPointA;
+
+	btVector3 dirA = worldEdgeA;
+	btVector3 dirB = worldEdgeB;
+
+	btScalar hlenB = 1e30f;
+	btScalar hlenA = 1e30f;
+
+	btSegmentsClosestPoints(ptsVector, offsetA, offsetB, tA, tB,
+							translation,
+							dirA, hlenA,
+							dirB, hlenB);
+
+	btScalar nlSqrt = ptsVector.length2();
+	if (nlSqrt > SIMD_EPSILON)
+	{
+		btScalar nl = btSqrt(nlSqrt);
+		ptsVector *= 1.f / nl;
+		if (ptsVector.dot(DeltaC2) < 0.f)
+		{
+			ptsVector *= -1.f;
+		}
+		btVector3 ptOnB = witnessPointB + offsetB;
+		btScalar distance = nl;
+		resultOut.addContactPoint(ptsVector, ptOnB, -distance);
+	}
+}
+
+//the world axis of a cached feature, oriented like the axes of the full search. For an edge pair, also the unit world
+//edge directions and a point on each edge. Returns false if the feature doesn't exist or the edges are parallel
+static bool btGetFeatureAxis(const btConvexPolyhedron& hullA, const btConvexPolyhedron& hullB, const btTransform& transA, const btTransform& transB, const btVector3& DeltaC2,
+							 const btSeparatingAxisCache& cache, btVector3& axis, btVector3& worldEdgeA, btVector3& worldEdgeB, btVector3& pointA, btVector3& pointB)
+{
+	switch (cache.m_featureType)
+	{
+		case btSeparatingAxisCache::FACE_A:
+		{
+			if (cache.m_featureA >= hullA.m_faces.size())
+				return false;
+			const btFace& face = hullA.m_faces[cache.m_featureA];
+			axis = transA.getBasis() * btVector3(face.m_plane[0], face.m_plane[1], face.m_plane[2]);
+			break;
+		}
+		case btSeparatingAxisCache::FACE_B:
+		{
+			if (cache.m_featureB >= hullB.m_faces.size())
+				return false;
+			const btFace& face = hullB.m_faces[cache.m_featureB];
+			axis = transB.getBasis() * btVector3(face.m_plane[0], face.m_plane[1], face.m_plane[2]);
+			break;
+		}
+		case btSeparatingAxisCache::EDGE_PAIR:
+		{
+			if (cache.m_featureA >= hullA.m_edges.size() || cache.m_featureB >= hullB.m_edges.size())
+				return false;
+			const btPolyhedronEdge& edge0 = hullA.m_edges[cache.m_featureA];
+			const btPolyhedronEdge& edge1 = hullB.m_edges[cache.m_featureB];
+			pointA = transA * hullA.m_vertices[edge0.m_vertex0];
+			pointB = transB * hullB.m_vertices[edge1.m_vertex0];
+			worldEdgeA = (transA.getBasis() * (hullA.m_vertices[edge0.m_vertex1] - hullA.m_vertices[edge0.m_vertex0])).normalized();
+			worldEdgeB = (transB.getBasis() * (hullB.m_vertices[edge1.m_vertex1] - hullB.m_vertices[edge1.m_vertex0])).normalized();
+			axis = worldEdgeA.cross(worldEdgeB);
+			break;
+		}
+		case btSeparatingAxisCache::UNIQUE_EDGE_PAIR:
+		{
+			if (cache.m_featureA >= hullA.m_uniqueEdges.size() || cache.m_featureB >= hullB.m_uniqueEdges.size())
+				return false;
+			worldEdgeA = transA.getBasis() * hullA.m_uniqueEdges[cache.m_featureA];
+			worldEdgeB = transB.getBasis() * hullB.m_uniqueEdges[cache.m_featureB];
+			axis = worldEdgeA.cross(worldEdgeB);
+			break;
+		}
+		default:
+			return false;
+	}
+	if (IsAlmostZero(axis))
+		return false;
+	axis.normalize();
+	if (DeltaC2.dot(axis) < 0)
+		axis *= -1.f;
+	return true;
+}
+
+SIMD_FORCE_INLINE void btStoreFeature(btSeparatingAxisCache* cache, int featureType, int featureA, int featureB, bool separating, const btTransform& relB)
+{
+	if (cache)
+	{
+		cache->m_featureType = featureType;
+		cache->m_featureA = featureA;
+		cache->m_featureB = featureB;
+		cache->m_separating = separating;
+		cache->m_relativeOrigin = relB.getOrigin();
+		cache->m_relativeRotation = relB.getRotation();
+	}
+}
+
+//the hulls moved less than the tolerances relative to each other since the full search
+static bool btIsCachedPoseValid(const btSeparatingAxisCache& cache, const btTransform& relB)
+{
+	if ((relB.getOrigin() - cache.m_relativeOrigin).length2() > cache.m_linearTolerance * cache.m_linearTolerance)
+		return false;
+	//the dot product of the rotations is the cosine of half the angle between them
+	return btFabs(relB.getRotation().dot(cache.m_relativeRotation)) > btCos(cache.m_angularTolerance * btScalar(0.5));
+}
+
+bool btPolyhedralContactClipping::findSeparatingAxis(const btConvexPolyhedron& hullA, const btConvexPolyhedron& hullB, const btTransform& transA, const btTransform& transB, btVector3& sep, btDiscreteCollisionDetectorInterface::Result& resultOut, btSeparatingAxisCache* cache)
 {
 	gActualSATPairTests++;
 
@@ -243,8 +429,37 @@ bool btPolyhedralContactClipping::findSeparatingAxis(const btConvexPolyhedron& h
 	const btVector3 DeltaC2 = c0 - c1;
 	//#endif
 
+	btTransform relB;
+	if (cache)
+	{
+		relB = transA.inverseTimes(transB);
+		btVector3 axis, worldEdgeA, worldEdgeB, pointA, pointB;
+		if (btGetFeatureAxis(hullA, hullB, transA, transB, DeltaC2, *cache, axis, worldEdgeA, worldEdgeB, pointA, pointB))
+		{
+			btScalar d;
+			btVector3 wA, wB;
+			//a feature that still separates the hulls is an early out, however much they moved
+			if (!TestSepAxis(hullA, hullB, transA, transB, axis, d, wA, wB))
+				return false;
+
+			//the feature of minimum penetration stays valid while the hulls move little
+			if (!cache->m_separating && btIsCachedPoseValid(*cache, relB))
+			{
+				if (cache->m_featureType == btSeparatingAxisCache::EDGE_PAIR)
+					btAddEdgeEdgeContact(pointA, pointB, worldEdgeA, worldEdgeB, DeltaC2, resultOut);
+				else if (cache->m_featureType == btSeparatingAxisCache::UNIQUE_EDGE_PAIR)
+					btAddEdgeEdgeContact(wA, wB, worldEdgeA, worldEdgeB, DeltaC2, resultOut);
+				sep = axis;
+				return true;
+			}
+		}
+	}
+
 	btScalar dmin = FLT_MAX;
 	int curPlaneTests = 0;
+	int featureType = btSeparatingAxisCache::NO_FEATURE;
+	int featureA = -1;
+	int featureB = -1;
 
 	int numFacesA = hullA.m_faces.size();
 	// Test normals from hullA
@@ -266,12 +481,17 @@ bool btPolyhedralContactClipping::findSeparatingAxis(const btConvexPolyhedron& h
 		btScalar d;
 		btVector3 wA, wB;
 		if (!TestSepAxis(hullA, hullB, transA, transB, faceANormalWS, d, wA, wB))
+		{
+			btStoreFeature(cache, btSeparatingAxisCache::FACE_A, i, -1, true, relB);
 			return false;
+		}
 
 		if (d < dmin)
 		{
 			dmin = d;
 			sep = faceANormalWS;
+			featureType = btSeparatingAxisCache::FACE_A;
+			featureA = i;
 		}
 	}
 
@@ -295,12 +515,18 @@ bool btPolyhedralContactClipping::findSeparatingAxis(const btConvexPolyhedron& h
 		btScalar d;
 		btVector3 wA, wB;
 		if (!TestSepAxis(hullA, hullB, transA, transB, WorldNormal, d, wA, wB))
+		{
+			btStoreFeature(cache, btSeparatingAxisCache::FACE_B, -1, i, true, relB);
 			return false;
+		}
 
 		if (d < dmin)
 		{
 			dmin = d;
 			sep = WorldNormal;
+			featureType = btSeparatingAxisCache::FACE_B;
+			featureA = -1;
+			featureB = i;
 		}
 	}
 
@@ -312,88 +538,87 @@ bool btPolyhedralContactClipping::findSeparatingAxis(const btConvexPolyhedron& h
 	btVector3 witnessPointA(0, 0, 0), witnessPointB(0, 0, 0);
 
 	int curEdgeEdge = 0;
-	// Test edges
-	for (int e0 = 0; e0 < hullA.m_uniqueEdges.size(); e0++)
+	if (hullA.m_edges.size() && hullB.m_edges.size())
 	{
-		const btVector3 edge0 = hullA.m_uniqueEdges[e0];
-		const btVector3 WorldEdge0 = transA.getBasis() * edge0;
-		for (int e1 = 0; e1 < hullB.m_uniqueEdges.size(); e1++)
+		btVector3 localSep;
+		if (!btFindSeparatingEdgePair(hullA, hullB, transA, transB, dmin, edgeA, edgeB, localSep))
 		{
-			const btVector3 edge1 = hullB.m_uniqueEdges[e1];
-			const btVector3 WorldEdge1 = transB.getBasis() * edge1;
-
-			btVector3 Cross = WorldEdge0.cross(WorldEdge1);
-			curEdgeEdge++;
-			if (!IsAlmostZero(Cross))
+			btStoreFeature(cache, btSeparatingAxisCache::EDGE_PAIR, edgeA, edgeB, true, relB);
+			return false;
+		}
+		if (edgeA >= 0 && edgeB >= 0)
+		{
+			featureType = btSeparatingAxisCache::EDGE_PAIR;
+			featureA = edgeA;
+			featureB = edgeB;
+			const btPolyhedronEdge& edge0 = hullA.m_edges[edgeA];
+			const btPolyhedronEdge& edge1 = hullB.m_edges[edgeB];
+			sep = transA.getBasis() * localSep;
+			witnessPointA = transA * hullA.m_vertices[edge0.m_vertex0];
+			witnessPointB = transB * hullB.m_vertices[edge1.m_vertex0];
+			worldEdgeA = (transA.getBasis() * (hullA.m_vertices[edge0.m_vertex1] - hullA.m_vertices[edge0.m_vertex0])).normalized();
+			worldEdgeB = (transB.getBasis() * (hullB.m_vertices[edge1.m_vertex1] - hullB.m_vertices[edge1.m_vertex0])).normalized();
+		}
+	}
+	else
+	{
+		// Test edges
+		for (int e0 = 0; e0 < hullA.m_uniqueEdges.size(); e0++)
+		{
+			const btVector3 edge0 = hullA.m_uniqueEdges[e0];
+			const btVector3 WorldEdge0 = transA.getBasis() * edge0;
+			for (int e1 = 0; e1 < hullB.m_uniqueEdges.size(); e1++)
 			{
-				Cross = Cross.normalize();
-				if (DeltaC2.dot(Cross) < 0)
-					Cross *= -1.f;
+				const btVector3 edge1 = hullB.m_uniqueEdges[e1];
+				const btVector3 WorldEdge1 = transB.getBasis() * edge1;
+
+				btVector3 Cross = WorldEdge0.cross(WorldEdge1);
+				curEdgeEdge++;
+				if (!IsAlmostZero(Cross))
+				{
+					Cross = Cross.normalize();
+					if (DeltaC2.dot(Cross) < 0)
+						Cross *= -1.f;
 
 #ifdef TEST_INTERNAL_OBJECTS
-				gExpectedNbTests++;
-				if (gUseInternalObject && !TestInternalObjects(transA, transB, DeltaC2, Cross, hullA, hullB, dmin))
-					continue;
-				gActualNbTests++;
+					gExpectedNbTests++;
+					if (gUseInternalObject && !TestInternalObjects(transA, transB, DeltaC2, Cross, hullA, hullB, dmin))
+						continue;
+					gActualNbTests++;
 #endif
 
-				btScalar dist;
-				btVector3 wA, wB;
-				if (!TestSepAxis(hullA, hullB, transA, transB, Cross, dist, wA, wB))
-					return false;
-
-				if (dist < dmin)
-				{
-					dmin = dist;
-					sep = Cross;
-					edgeA = e0;
-					edgeB = e1;
-					worldEdgeA = WorldEdge0;
-					worldEdgeB = WorldEdge1;
-					witnessPointA = wA;
-					witnessPointB = wB;
+					btScalar dist;
+					btVector3 wA, wB;
+					if (!TestSepAxis(hullA, hullB, transA, transB, Cross, dist, wA, wB))
+					{
+						btStoreFeature(cache, btSeparatingAxisCache::UNIQUE_EDGE_PAIR, e0, e1, true, relB);
+						return false;
+					}
+
+					if (dist < dmin)
+					{
+						dmin = dist;
+						sep = Cross;
+						edgeA = e0;
+						edgeB = e1;
+						worldEdgeA = WorldEdge0;
+						worldEdgeB = WorldEdge1;
+						witnessPointA = wA;
+						witnessPointB = wB;
+						featureType = btSeparatingAxisCache::UNIQUE_EDGE_PAIR;
+						featureA = e0;
+						featureB = e1;
+					}
 				}
 			}
 		}
 	}
 
+	btStoreFeature(cache, featureType, featureA, featureB, false, relB);
+
 	if (edgeA >= 0 && edgeB >= 0)
 	{
-		//		printf("edge-edge\n");
-		//add an edge-edge contact
-
-		btVector3 ptsVector;
-		btVector3 offsetA;
-		btVector3 offsetB;
-		btScalar tA;
-		btScalar tB;
-
-		btVector3 translation = witnessPointB - witnessPointA;
-
-		btVector3 dirA = worldEdgeA;
-		btVector3 dirB = worldEdgeB;
-
-		btScalar hlenB = 1e30f;
-		btScalar hlenA = 1e30f;
-
-		btSegmentsClosestPoints(ptsVector, offsetA, offsetB, tA, tB,
-								translation,
-								dirA, hlenA,
-								dirB, hlenB);
-
-		btScalar nlSqrt = ptsVector.length2();
-		if (nlSqrt > SIMD_EPSILON)
-		{
-			btScalar nl = btSqrt(nlSqrt);
-			ptsVector *= 1.f / nl;
-			if (ptsVector.dot(DeltaC2) < 0.f)
-			{
-				ptsVector *= -1.f;
-			}
-			btVector3 ptOnB = witnessPointB + offsetB;
-			btScalar distance = nl;
-			resultOut.addContactPoint(ptsVector, ptOnB, -distance);
-		}
+		btAddEdgeEdgeContact(witnessPointA, witnessPointB, worldEdgeA, worldEdgeB, DeltaC2, resultOut);
 	}
 
 	if ((DeltaC2.dot(sep)) < 0.0f)
@@ -407,17 +632,17 @@ void btPolyhedralContactClipping::clipFaceAgainstHull(const btVector3& separatin
 	worldVertsB2.resize(0);
 	btVertexArray* pVtxIn = &worldVertsB1;
 	btVertexArray* pVtxOut = &worldVertsB2;
-	pVtxOut->reserve(pVtxIn->size());
 
+	//the face normals are compared in the space of hullA, instead of rotating each of them
 	int closestFaceA = -1;
 	{
+		const btVector3 localSeparatingNormal = separatingNormal * transA.getBasis();
 		btScalar dmin = FLT_MAX;
 		for (int face = 0; face < hullA.m_faces.size(); face++)
 		{
 			const btVector3 Normal(hullA.m_faces[face].m_plane[0], hullA.m_faces[face].m_plane[1], hullA.m_faces[face].m_plane[2]);
-			const btVector3 faceANormalWS = transA.getBasis() * Normal;
 
-			btScalar d = faceANormalWS.dot(separatingNormal);
+			btScalar d = Normal.dot(localSeparatingNormal);
 			if (d < dmin)
 			{
 				dmin = d;
@@ -430,15 +655,20 @@ void btPolyhedralContactClipping::clipFaceAgainstHull(const btVector3& separatin
 
 	const btFace& polyA = hullA.m_faces[closestFaceA];
 
-	// clip polygon to back of planes of all faces of hull A that are adjacent to witness face
+	//each clipping plane adds at most one vertex, so the buffers keep their capacity during the clipping
 	int numVerticesA = polyA.m_indices.size();
+	const int maxClippedVertices = pVtxIn->size() + numVerticesA;
+	pVtxIn->reserve(maxClippedVertices);
+	pVtxOut->reserve(maxClippedVertices);
+
+	// clip polygon to back of planes of all faces of hull A that are adjacent to witness face
+	const btVector3 worldPlaneAnormal1 = transA.getBasis() * btVector3(polyA.m_plane[0], polyA.m_plane[1], polyA.m_plane[2]);
 	for (int e0 = 0; e0 < numVerticesA; e0++)
 	{
 		const btVector3& a = hullA.m_vertices[polyA.m_indices[e0]];
 		const btVector3& b = hullA.m_vertices[polyA.m_indices[(e0 + 1) % numVerticesA]];
 		const btVector3 edge0 = a - b;
 		const btVector3 WorldEdge0 = transA.getBasis() * edge0;
-		btVector3 worldPlaneAnormal1 = transA.getBasis() * btVector3(polyA.m_plane[0], polyA.m_plane[1], polyA.m_plane[2]);
 
 		btVector3 planeNormalWS1 = -WorldEdge0.cross(worldPlaneAnormal1);  //.cross(WorldEdge0);
 		btVector3 worldA1 = transA * a;
@@ -520,11 +750,11 @@ void btPolyhedralContactClipping::clipHullAgainstHull(const btVector3& separatin
 	int closestFaceB = -1;
 	btScalar dmax = -FLT_MAX;
 	{
+		const btVector3 localSeparatingNormal = separatingNormal * transB.getBasis();
 		for (int face = 0; face < hullB.m_faces.size(); face++)
 		{
 			const btVector3 Normal(hullB.m_faces[face].m_plane[0], hullB.m_faces[face].m_plane[1], hullB.m_faces[face].m_plane[2]);
-			const btVector3 WorldNormal = transB.getBasis() * Normal;
-			btScalar d = WorldNormal.dot(separatingNormal);
+			btScalar d = Normal.dot(localSeparatingNormal);
 			if (d > dmax)
 			{
 				dmax = d;
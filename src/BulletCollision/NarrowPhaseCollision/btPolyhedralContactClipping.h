@@ -26,6 +26,48 @@ class btConvexPolyhedron;
 
 typedef btAlignedObjectArray<btVector3> btVertexArray;
 
+///btSeparatingAxisCache keeps the feature pair of the last separating axis test of a pair of hulls, between frames.
+///If the cached feature still separates the hulls, findSeparatingAxis returns without the full search. A cached feature
+///of minimum penetration is reused as long as the relative transform of the hulls stays within the tolerances.
+struct btSeparatingAxisCache
+{
+	enum btFeatureType
+	{
+		NO_FEATURE,
+		FACE_A,
+		FACE_B,
+		EDGE_PAIR,         //indices in btConvexPolyhedron::m_edges
+		UNIQUE_EDGE_PAIR   //indices in btConvexPolyhedron::m_uniqueEdges
+	};
+
+	int m_featureType;
+	int m_featureA;
+	int m_featureB;
+	///the feature separated the hulls, rather than being the one of minimum penetration
+	bool m_separating;
+	///transform of hull B relative to hull A when the feature was found by the full search
+	btVector3 m_relativeOrigin;
+	btQuaternion m_relativeRotation;
+
+	btScalar m_linearTolerance;
+	btScalar m_angularTolerance;
+
+	btSeparatingAxisCache()
+		: m_featureType(NO_FEATURE),
+		  m_featureA(-1),
+		  m_featureB(-1),
+		  m_separating(false),
+		  m_linearTolerance(btScalar(0.01)),
+		  m_angularTolerance(btScalar(0.01))
+	{
+	}
+
+	void reset()
+	{
+		m_featureType = NO_FEATURE;
+	}
+};
+
 // Clips a face to the back of a plane
 struct btPolyhedralContactClipping
 {
@@ -33,7 +75,7 @@ struct btPolyhedralContactClipping
 
 	static void clipFaceAgainstHull(const btVector3& separatingNormal, const btConvexPolyhedron& hullA, const btTransform& transA, btVertexArray& worldVertsB1, btVertexArray& worldVertsB2, const btScalar minDist, btScalar maxDist, btDiscreteCollisionDetectorInterface::Result& resultOut);
 
-	static bool findSeparatingAxis(const btConvexPolyhedron& hullA, const btConvexPolyhedron& hullB, const btTransform& transA, const btTransform& transB, btVector3& sep, btDiscreteCollisionDetectorInterface::Result& resultOut);
+	static bool findSeparatingAxis(const btConvexPolyhedron& hullA, const btConvexPolyhedron& hullB, const btTransform& transA, const btTransform& transB, btVector3& sep, btDiscreteCollisionDetectorInterface::Result& resultOut, btSeparatingAxisCache* cache = 0);
 
 	///the clipFace method is used internally
 	static void clipFace(const btVertexArray& pVtxIn, btVertexArray& ppVtxOut, const btVector3& planeNormalWS, btScalar planeEqWS);
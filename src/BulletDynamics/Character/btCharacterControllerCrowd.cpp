@@ -0,0 +1,182 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2008 Erwin Coumans  http://bulletphysics.com
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btCharacterControllerCrowd.h"
+#include "btKinematicCharacterController.h"
+#include "BulletCollision/CollisionDispatch/btGhostObject.h"
+#include "BulletCollision/CollisionShapes/btCollisionShape.h"
+#include "LinearMath/btThreads.h"
+#include "LinearMath/btQuickprof.h"
+
+struct btBeginPlayerStepsLoop : public btIParallelForBody
+{
+	btCharacterControllerCrowd* m_crowd;
+	btCollisionWorld* m_collisionWorld;
+	btScalar m_deltaTime;
+
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+	{
+		m_crowd->beginPlayerSteps(m_collisionWorld, iBegin, iEnd, m_deltaTime);
+	}
+};
+
+struct btEndPlayerStepsLoop : public btIParallelForBody
+{
+	btCharacterControllerCrowd* m_crowd;
+	btCollisionWorld* m_collisionWorld;
+	btScalar m_deltaTime;
+
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+	{
+		m_crowd->endPlayerSteps(m_collisionWorld, iBegin, iEnd, m_deltaTime);
+	}
+};
+
+static bool btUseParallelCrowdUpdate(int numControllers, int grainSize)
+{
+#if BT_THREADSAFE
+	btITaskScheduler* scheduler = btGetTaskScheduler();
+	return numControllers > grainSize && scheduler && scheduler->getNumThreads() > 1 && !btThreadsAreRunning();
+#else
+	(void)numControllers;
+	(void)grainSize;
+	return false;
+#endif
+}
+
+btCharacterControllerCrowd::btCharacterControllerCrowd()
+	: m_grainSize(16)
+{
+}
+
+btCharacterControllerCrowd::~btCharacterControllerCrowd()
+{
+}
+
+void btCharacterControllerCrowd::addController(btKinematicCharacterController* controller)
+{
+	btAssert(m_controllers.findLinearSearch(controller) == m_controllers.size());
+	//stepForwardAndStrafe adds a margin to the convex shape during its sweep, so the controllers updated in parallel need
+	//their own shapes. Capsules keep their margin
+	for (int i = 0; i < m_controllers.size(); i++)
+	{
+		btAssert(m_controllers[i]->getGhostObject()->getCollisionShape() != controller->getGhostObject()->getCollisionShape() ||
+				 controller->getGhostObject()->getCollisionShape()->getShapeType() == CAPSULE_SHAPE_PROXYTYPE);
+	}
+	m_controllers.push_back(controller);
+}
+
+void btCharacterControllerCrowd::removeController(btKinematicCharacterController* controller)
+{
+	m_controllers.remove(controller);
+}
+
+void btCharacterControllerCrowd::beginPlayerSteps(btCollisionWorld* collisionWorld, int controllerBegin, int controllerEnd, btScalar deltaTime)
+{
+	for (int i = controllerBegin; i < controllerEnd; i++)
+	{
+		btKinematicCharacterController* controller = m_controllers[i];
+		controller->preStep(collisionWorld);
+		m_moving[i] = controller->beginPlayerStep(collisionWorld, deltaTime, m_ghostTransforms[i]);
+	}
+}
+
+void btCharacterControllerCrowd::endPlayerSteps(btCollisionWorld* collisionWorld, int controllerBegin, int controllerEnd, btScalar deltaTime)
+{
+	for (int i = controllerBegin; i < controllerEnd; i++)
+	{
+		if (m_moving[i])
+		{
+			m_controllers[i]->endPlayerStep(collisionWorld, deltaTime, m_ghostTransforms[i]);
+		}
+	}
+}
+
+void btCharacterControllerCrowd::updateAction(btCollisionWorld* collisionWorld, btScalar deltaTime)
+{
+	BT_PROFILE("btCharacterControllerCrowd::updateAction");
+
+	const int numControllers = m_controllers.size();
+	if (!numControllers)
+		return;
+
+	m_ghostTransforms.resize(numControllers);
+	m_moving.resize(numControllers);
+	const bool parallel = btUseParallelCrowdUpdate(numControllers, m_grainSize);
+
+	{
+		BT_PROFILE("beginPlayerSteps");
+		btBeginPlayerStepsLoop beginLoop;
+		beginLoop.m_crowd = this;
+		beginLoop.m_collisionWorld = collisionWorld;
+		beginLoop.m_deltaTime = deltaTime;
+		if (parallel)
+		{
+			btParallelFor(0, numControllers, m_grainSize, beginLoop);
+		}
+		else
+		{
+			beginLoop.forLoop(0, numControllers);
+		}
+	}
+
+	{
+		BT_PROFILE("recoverFromStepUpPenetration");
+		for (int i = 0; i < numControllers; i++)
+		{
+			if (m_moving[i] && m_controllers[i]->hasStepUpPenetration())
+			{
+				m_controllers[i]->recoverFromStepUpPenetration(collisionWorld, m_ghostTransforms[i]);
+			}
+		}
+	}
+
+	{
+		BT_PROFILE("endPlayerSteps");
+		btEndPlayerStepsLoop endLoop;
+		endLoop.m_crowd = this;
+		endLoop.m_collisionWorld = collisionWorld;
+		endLoop.m_deltaTime = deltaTime;
+		if (parallel)
+		{
+			btParallelFor(0, numControllers, m_grainSize, endLoop);
+		}
+		else
+		{
+			endLoop.forLoop(0, numControllers);
+		}
+	}
+
+	{
+		BT_PROFILE("resolvePenetration");
+		for (int i = 0; i < numControllers; i++)
+		{
+			btKinematicCharacterController* controller = m_controllers[i];
+			controller->getGhostObject()->setWorldTransform(m_ghostTransforms[i]);
+			if (m_moving[i])
+			{
+				controller->resolvePenetration(collisionWorld);
+			}
+		}
+	}
+}
+
+void btCharacterControllerCrowd::debugDraw(btIDebugDraw* debugDrawer)
+{
+	for (int i = 0; i < m_controllers.size(); i++)
+	{
+		m_controllers[i]->debugDraw(debugDrawer);
+	}
+}
@@ -0,0 +1,84 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2008 Erwin Coumans  http://bulletphysics.com
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_CHARACTER_CONTROLLER_CROWD_H
+#define BT_CHARACTER_CONTROLLER_CROWD_H
+
+#include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btTransform.h"
+#include "BulletDynamics/Dynamics/btActionInterface.h"
+
+class btKinematicCharacterController;
+
+///btCharacterControllerCrowd updates many btKinematicCharacterController as a single action, add it to the world instead of the controllers.
+///The sweep tests of all characters run in parallel with btParallelFor, while the ghost objects stay where they were. The penetration
+///recovery, which updates the broadphase and the ghost pair caches, runs serially in the order the controllers were added, after the
+///step up and at the end of the step. The characters see each other where they were at the start of the step (or after the step up
+///recovery), so the results do not depend on the number of threads. Characters that do not meet move exactly as with btKinematicCharacterController::updateAction.
+///The controllers can only share a capsule shape, the sweeps change the margin of the other shapes for a moment.
+class btCharacterControllerCrowd : public btActionInterface
+{
+	btAlignedObjectArray<btKinematicCharacterController*> m_controllers;
+
+	///the result of the parallel motion phase for each controller
+	btAlignedObjectArray<btTransform> m_ghostTransforms;
+	btAlignedObjectArray<bool> m_moving;
+
+	int m_grainSize;
+
+public:
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	btCharacterControllerCrowd();
+
+	virtual ~btCharacterControllerCrowd();
+
+	void addController(btKinematicCharacterController* controller);
+
+	void removeController(btKinematicCharacterController* controller);
+
+	int getNumControllers() const
+	{
+		return m_controllers.size();
+	}
+
+	btKinematicCharacterController* getController(int index)
+	{
+		return m_controllers[index];
+	}
+
+	///number of controllers per task
+	void setGrainSize(int grainSize)
+	{
+		m_grainSize = grainSize;
+	}
+
+	int getGrainSize() const
+	{
+		return m_grainSize;
+	}
+
+	void beginPlayerSteps(btCollisionWorld* collisionWorld, int controllerBegin, int controllerEnd, btScalar deltaTime);  // can be called in parallel
+
+	void endPlayerSteps(btCollisionWorld* collisionWorld, int controllerBegin, int controllerEnd, btScalar deltaTime);  // can be called in parallel
+
+	///btActionInterface interface
+	virtual void updateAction(btCollisionWorld* collisionWorld, btScalar deltaTime);
+
+	///btActionInterface interface
+	virtual void debugDraw(btIDebugDraw* debugDrawer);
+};
+
+#endif  //BT_CHARACTER_CONTROLLER_CROWD_H
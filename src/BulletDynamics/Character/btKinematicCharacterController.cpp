@@ -157,6 +157,7 @@ btKinematicCharacterController::btKinematicCharacterController(btPairCachingGhos
 	m_maxPenetrationDepth = 0.2;
 	full_drop = false;
 	bounce_fix = false;
+	m_stepUpPenetration = false;
 	m_linearDamping = btScalar(0.0);
 	m_angularDamping = btScalar(0.0);
 
@@ -256,6 +257,8 @@ bool btKinematicCharacterController::recoverFromPenetration(btCollisionWorld* co
 
 void btKinematicCharacterController::stepUp(btCollisionWorld* world)
 {
+	m_stepUpPenetration = false;
+
 	btScalar stepHeight = 0.0f;
 	if (m_verticalVelocity < 0.0)
 		stepHeight = m_stepHeight;
@@ -303,25 +306,9 @@ void btKinematicCharacterController::stepUp(btCollisionWorld* world)
 				m_currentPosition = m_targetPosition;
 		}
 
-		btTransform& xform = m_ghostObject->getWorldTransform();
-		xform.setOrigin(m_currentPosition);
-		m_ghostObject->setWorldTransform(xform);
-
-		// fix penetration if we hit a ceiling for example
-		int numPenetrationLoops = 0;
-		m_touchingContact = false;
-		while (recoverFromPenetration(world))
-		{
-			numPenetrationLoops++;
-			m_touchingContact = true;
-			if (numPenetrationLoops > 4)
-			{
-				//printf("character could not recover from penetration = %d\n", numPenetrationLoops);
-				break;
-			}
-		}
-		m_targetPosition = m_ghostObject->getWorldTransform().getOrigin();
-		m_currentPosition = m_targetPosition;
+		// fix penetration if we hit a ceiling for example, see recoverFromStepUpPenetration
+		m_stepUpPenetration = true;
+		m_targetPosition = m_currentPosition;
 
 		if (m_verticalOffset > 0)
 		{
@@ -709,6 +696,56 @@ void btKinematicCharacterController::preStep(btCollisionWorld* collisionWorld)
 
 void btKinematicCharacterController::playerStep(btCollisionWorld* collisionWorld, btScalar dt)
 {
+	btTransform xform;
+	if (!beginPlayerStep(collisionWorld, dt, xform))
+	{
+		if (m_AngVel.length2() > 0.0f)
+		{
+			m_ghostObject->setWorldTransform(xform);
+		}
+		return;  // no motion
+	}
+	if (m_stepUpPenetration)
+	{
+		recoverFromStepUpPenetration(collisionWorld, xform);
+	}
+	endPlayerStep(collisionWorld, dt, xform);
+
+	m_ghostObject->setWorldTransform(xform);
+	resolvePenetration(collisionWorld);
+}
+
+void btKinematicCharacterController::resolvePenetration(btCollisionWorld* collisionWorld)
+{
+	int numPenetrationLoops = 0;
+	m_touchingContact = false;
+	while (recoverFromPenetration(collisionWorld))
+	{
+		numPenetrationLoops++;
+		m_touchingContact = true;
+		if (numPenetrationLoops > 4)
+		{
+			//printf("character could not recover from penetration = %d\n", numPenetrationLoops);
+			break;
+		}
+	}
+}
+
+void btKinematicCharacterController::recoverFromStepUpPenetration(btCollisionWorld* collisionWorld, btTransform& xform)
+{
+	xform.setOrigin(m_currentPosition);
+	m_ghostObject->setWorldTransform(xform);
+
+	resolvePenetration(collisionWorld);
+	m_targetPosition = m_ghostObject->getWorldTransform().getOrigin();
+	m_currentPosition = m_targetPosition;
+	m_stepUpPenetration = false;
+}
+
+bool btKinematicCharacterController::beginPlayerStep(btCollisionWorld* collisionWorld, btScalar dt, btTransform& xform)
+{
+	xform = m_ghostObject->getWorldTransform();
+
 	//	printf("playerStep(): ");
 	//	printf("  dt = %f", dt);
 
@@ -720,19 +757,15 @@ void btKinematicCharacterController::playerStep(btCollisionWorld* collisionWorld
 	// integrate for angular velocity
 	if (m_AngVel.length2() > 0.0f)
 	{
-		btTransform xform;
-		xform = m_ghostObject->getWorldTransform();
-
 		btQuaternion rot(m_AngVel.normalized(), m_AngVel.length() * dt);
 
 		btQuaternion orn = rot * xform.getRotation();
 
 		xform.setRotation(orn);
-		m_ghostObject->setWorldTransform(xform);
 
-		m_currentPosition = m_ghostObject->getWorldTransform().getOrigin();
+		m_currentPosition = xform.getOrigin();
 		m_targetPosition = m_currentPosition;
-		m_currentOrientation = m_ghostObject->getWorldTransform().getRotation();
+		m_currentOrientation = xform.getRotation();
 		m_targetOrientation = m_currentOrientation;
 	}
 
@@ -740,7 +773,7 @@ void btKinematicCharacterController::playerStep(btCollisionWorld* collisionWorld
 	if (!m_useWalkDirection && (m_velocityTimeInterval <= 0.0 || m_walkDirection.fuzzyZero())) 
 	{
 		//		printf("\n");
-		return;  // no motion
+		return false;  // no motion
 	}
 
 	m_wasOnGround = onGround();
@@ -768,9 +801,6 @@ void btKinematicCharacterController::playerStep(btCollisionWorld* collisionWorld
 	}
 	m_verticalOffset = m_verticalVelocity * dt;
 
-	btTransform xform;
-	xform = m_ghostObject->getWorldTransform();
-
 	//	printf("walkDirection(%f,%f,%f)\n",walkDirection[0],walkDirection[1],walkDirection[2]);
 	//	printf("walkSpeed=%f\n",walkSpeed);
 
@@ -792,7 +822,11 @@ void btKinematicCharacterController::playerStep(btCollisionWorld* collisionWorld
 
 	//	xform = m_ghostObject->getWorldTransform();
 	//}
+	return true;
+}
 
+void btKinematicCharacterController::endPlayerStep(btCollisionWorld* collisionWorld, btScalar dt, btTransform& xform)
+{
 	if (m_useWalkDirection)
 	{
 		stepForwardAndStrafe(collisionWorld, m_walkDirection);
@@ -833,20 +867,6 @@ void btKinematicCharacterController::playerStep(btCollisionWorld* collisionWorld
 	// printf("\n");
 
 	xform.setOrigin(m_currentPosition);
-	m_ghostObject->setWorldTransform(xform);
-
-	int numPenetrationLoops = 0;
-	m_touchingContact = false;
-	while (recoverFromPenetration(collisionWorld))
-	{
-		numPenetrationLoops++;
-		m_touchingContact = true;
-		if (numPenetrationLoops > 4)
-		{
-			//printf("character could not recover from penetration = %d\n", numPenetrationLoops);
-			break;
-		}
-	}
 }
 
 void btKinematicCharacterController::setFallSpeed(btScalar fallSpeed)
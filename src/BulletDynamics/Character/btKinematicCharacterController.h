@@ -94,6 +94,7 @@ protected:
 	bool m_interpolateUp;
 	bool full_drop;
 	bool bounce_fix;
+	bool m_stepUpPenetration;
 
 	btVector3 computeReflectionDirection(const btVector3& direction, const btVector3& normal);
 	btVector3 parallelComponent(const btVector3& direction, const btVector3& normal);
@@ -163,6 +164,18 @@ public:
 	void preStep(btCollisionWorld * collisionWorld);
 	void playerStep(btCollisionWorld * collisionWorld, btScalar dt);
 
+	///playerStep in phases, so that the sweeps of many characters can run in parallel (see btCharacterControllerCrowd).
+	///beginPlayerStep and endPlayerStep only do sweep tests and leave the ghost object and the pair caches untouched, the new
+	///ghost object transform is returned in xform. beginPlayerStep returns false if the character does not move. If the step up
+	///hit something, recoverFromStepUpPenetration has to be called before endPlayerStep. The caller then sets the ghost object
+	///transform and calls resolvePenetration. The forward sweep adds m_addedMargin to the margin of the convex shape while it
+	///runs, so characters stepped in parallel can't share a shape unless it is a capsule, which keeps its margin.
+	bool beginPlayerStep(btCollisionWorld * collisionWorld, btScalar dt, btTransform & xform);
+	bool hasStepUpPenetration() const { return m_stepUpPenetration; }
+	void recoverFromStepUpPenetration(btCollisionWorld * collisionWorld, btTransform & xform);
+	void endPlayerStep(btCollisionWorld * collisionWorld, btScalar dt, btTransform & xform);
+	void resolvePenetration(btCollisionWorld * collisionWorld);
+
 	void setStepHeight(btScalar h);
 	btScalar getStepHeight() const { return m_stepHeight; }
 	void setFallSpeed(btScalar fallSpeed);
@@ -32,6 +32,7 @@ enum btSolverMode
 	SOLVER_ALLOW_ZERO_LENGTH_FRICTION_DIRECTIONS = 1024,
 	SOLVER_DISABLE_IMPLICIT_CONE_FRICTION = 2048,
 	SOLVER_USE_ARTICULATED_WARMSTARTING = 4096,
+	SOLVER_USE_DIRECT_LOOP_CLOSURES = 8192,  //solve the bilateral btMultiBodyConstraint rows with a sparse LDL^T, see btMultiBodyLoopClosureSolver
 };
 
 struct btContactSolverInfoData
@@ -846,6 +846,81 @@ public:
 ///internal debugging variable. this value shouldn't be too high
 int gNumClampedCcdMotions = 0;
 
+bool btDiscreteDynamicsWorld::needsCcdMotionClamping(const btRigidBody* body, const btTransform& predictedTrans) const
+{
+	btScalar squareMotion = (predictedTrans.getOrigin() - body->getWorldTransform().getOrigin()).length2();
+
+	//with speculative contacts, the narrowphase already reported the contacts of the whole motion
+	return getDispatchInfo().m_useContinuous && !getDispatchInfo().m_useSpeculativeContacts && body->getCcdSquareMotionThreshold() && body->getCcdSquareMotionThreshold() < squareMotion && body->getCollisionShape()->isConvex();
+}
+
+bool btDiscreteDynamicsWorld::sweepCcdMotion(btRigidBody* body, const btTransform& predictedTrans, bool staticOnly, CcdMotionHit& hit) const
+{
+	class StaticOnlyCallback : public btClosestNotMeConvexResultCallback
+	{
+	public:
+		bool m_staticOnly;
+
+		StaticOnlyCallback(btCollisionObject* me, const btVector3& fromA, const btVector3& toA, btOverlappingPairCache* pairCache, btDispatcher* dispatcher, bool staticOnly) : btClosestNotMeConvexResultCallback(me, fromA, toA, pairCache, dispatcher),
+																																												 m_staticOnly(staticOnly)
+		{
+		}
+
+		virtual bool needsCollision(btBroadphaseProxy* proxy0) const
+		{
+			btCollisionObject* otherObj = (btCollisionObject*)proxy0->m_clientObject;
+			if (m_staticOnly && !otherObj->isStaticOrKinematicObject())
+				return false;
+			return btClosestNotMeConvexResultCallback::needsCollision(proxy0);
+		}
+	};
+
+	StaticOnlyCallback sweepResults(body, body->getWorldTransform().getOrigin(), predictedTrans.getOrigin(), const_cast<btBroadphaseInterface*>(getBroadphase())->getOverlappingPairCache(), m_dispatcher1, staticOnly);
+	//btConvexShape* convexShape = static_cast<btConvexShape*>(body->getCollisionShape());
+	btSphereShape tmpSphere(body->getCcdSweptSphereRadius());  //btConvexShape* convexShape = static_cast<btConvexShape*>(body->getCollisionShape());
+	sweepResults.m_allowedPenetration = getDispatchInfo().m_allowedCcdPenetration;
+
+	sweepResults.m_collisionFilterGroup = body->getBroadphaseProxy()->m_collisionFilterGroup;
+	sweepResults.m_collisionFilterMask = body->getBroadphaseProxy()->m_collisionFilterMask;
+	btTransform modifiedPredictedTrans = predictedTrans;
+	modifiedPredictedTrans.setBasis(body->getWorldTransform().getBasis());
+
+	convexSweepTest(&tmpSphere, body->getWorldTransform(), modifiedPredictedTrans, sweepResults);
+	if (sweepResults.hasHit() && (sweepResults.m_closestHitFraction < 1.f))
+	{
+		hit.m_hitObject = sweepResults.m_hitCollisionObject;
+		hit.m_hitNormalWorld = sweepResults.m_hitNormalWorld;
+		hit.m_hitFraction = sweepResults.m_closestHitFraction;
+		return true;
+	}
+	return false;
+}
+
+btPersistentManifold* btDiscreteDynamicsWorld::addPredictiveContact(btRigidBody* body, const btTransform& predictedTrans, const CcdMotionHit& hit)
+{
+	btVector3 distVec = (predictedTrans.getOrigin() - body->getWorldTransform().getOrigin()) * hit.m_hitFraction;
+	btScalar distance = distVec.dot(-hit.m_hitNormalWorld);
+
+	btMutexLock(&m_predictiveManifoldsMutex);
+	btPersistentManifold* manifold = m_dispatcher1->getNewManifold(body, hit.m_hitObject);
+	m_predictiveManifolds.push_back(manifold);
+	btMutexUnlock(&m_predictiveManifoldsMutex);
+
+	btVector3 worldPointB = body->getWorldTransform().getOrigin() + distVec;
+	btVector3 localPointB = hit.m_hitObject->getWorldTransform().inverse() * worldPointB;
+
+	btManifoldPoint newPoint(btVector3(0, 0, 0), localPointB, hit.m_hitNormalWorld, distance);
+
+	bool isPredictive = true;
+	int index = manifold->addManifoldPoint(newPoint, isPredictive);
+	btManifoldPoint& pt = manifold->getContactPoint(index);
+	pt.m_combinedRestitution = 0;
+	pt.m_combinedFriction = gCalculateCombinedFrictionCallback(body, hit.m_hitObject);
+	pt.m_positionWorldOnA = body->getWorldTransform().getOrigin();
+	pt.m_positionWorldOnB = worldPointB;
+	return manifold;
+}
+
 void btDiscreteDynamicsWorld::createPredictiveContactsInternal(btRigidBody** bodies, int numBodies, btScalar timeStep)
 {
 	btTransform predictedTrans;
@@ -858,68 +933,19 @@ void btDiscreteDynamicsWorld::createPredictiveContactsInternal(btRigidBody** bod
 		{
 			body->predictIntegratedTransform(timeStep, predictedTrans);
 
-			btScalar squareMotion = (predictedTrans.getOrigin() - body->getWorldTransform().getOrigin()).length2();
-
-			if (getDispatchInfo().m_useContinuous && body->getCcdSquareMotionThreshold() && body->getCcdSquareMotionThreshold() < squareMotion)
+			if (needsCcdMotionClamping(body, predictedTrans))
 			{
 				BT_PROFILE("predictive convexSweepTest");
-				if (body->getCollisionShape()->isConvex())
-				{
-					gNumClampedCcdMotions++;
+				gNumClampedCcdMotions++;
 #ifdef PREDICTIVE_CONTACT_USE_STATIC_ONLY
-					class StaticOnlyCallback : public btClosestNotMeConvexResultCallback
-					{
-					public:
-						StaticOnlyCallback(btCollisionObject* me, const btVector3& fromA, const btVector3& toA, btOverlappingPairCache* pairCache, btDispatcher* dispatcher) : btClosestNotMeConvexResultCallback(me, fromA, toA, pairCache, dispatcher)
-						{
-						}
-
-						virtual bool needsCollision(btBroadphaseProxy* proxy0) const
-						{
-							btCollisionObject* otherObj = (btCollisionObject*)proxy0->m_clientObject;
-							if (!otherObj->isStaticOrKinematicObject())
-								return false;
-							return btClosestNotMeConvexResultCallback::needsCollision(proxy0);
-						}
-					};
-
-					StaticOnlyCallback sweepResults(body, body->getWorldTransform().getOrigin(), predictedTrans.getOrigin(), getBroadphase()->getOverlappingPairCache(), getDispatcher());
+				const bool staticOnly = true;
 #else
-					btClosestNotMeConvexResultCallback sweepResults(body, body->getWorldTransform().getOrigin(), predictedTrans.getOrigin(), getBroadphase()->getOverlappingPairCache(), getDispatcher());
+				const bool staticOnly = false;
 #endif
-					//btConvexShape* convexShape = static_cast<btConvexShape*>(body->getCollisionShape());
-					btSphereShape tmpSphere(body->getCcdSweptSphereRadius());  //btConvexShape* convexShape = static_cast<btConvexShape*>(body->getCollisionShape());
-					sweepResults.m_allowedPenetration = getDispatchInfo().m_allowedCcdPenetration;
-
-					sweepResults.m_collisionFilterGroup = body->getBroadphaseProxy()->m_collisionFilterGroup;
-					sweepResults.m_collisionFilterMask = body->getBroadphaseProxy()->m_collisionFilterMask;
-					btTransform modifiedPredictedTrans = predictedTrans;
-					modifiedPredictedTrans.setBasis(body->getWorldTransform().getBasis());
-
-					convexSweepTest(&tmpSphere, body->getWorldTransform(), modifiedPredictedTrans, sweepResults);
-					if (sweepResults.hasHit() && (sweepResults.m_closestHitFraction < 1.f))
-					{
-						btVector3 distVec = (predictedTrans.getOrigin() - body->getWorldTransform().getOrigin()) * sweepResults.m_closestHitFraction;
-						btScalar distance = distVec.dot(-sweepResults.m_hitNormalWorld);
-
-						btMutexLock(&m_predictiveManifoldsMutex);
-						btPersistentManifold* manifold = m_dispatcher1->getNewManifold(body, sweepResults.m_hitCollisionObject);
-						m_predictiveManifolds.push_back(manifold);
-						btMutexUnlock(&m_predictiveManifoldsMutex);
-
-						btVector3 worldPointB = body->getWorldTransform().getOrigin() + distVec;
-						btVector3 localPointB = sweepResults.m_hitCollisionObject->getWorldTransform().inverse() * worldPointB;
-
-						btManifoldPoint newPoint(btVector3(0, 0, 0), localPointB, sweepResults.m_hitNormalWorld, distance);
-
-						bool isPredictive = true;
-						int index = manifold->addManifoldPoint(newPoint, isPredictive);
-						btManifoldPoint& pt = manifold->getContactPoint(index);
-						pt.m_combinedRestitution = 0;
-						pt.m_combinedFriction = gCalculateCombinedFrictionCallback(body, sweepResults.m_hitCollisionObject);
-						pt.m_positionWorldOnA = body->getWorldTransform().getOrigin();
-						pt.m_positionWorldOnB = worldPointB;
-					}
+				CcdMotionHit hit;
+				if (sweepCcdMotion(body, predictedTrans, staticOnly, hit))
+				{
+					addPredictiveContact(body, predictedTrans, hit);
 				}
 			}
 		}
@@ -960,82 +986,51 @@ void btDiscreteDynamicsWorld::integrateTransformsInternal(btRigidBody** bodies,
 		{
 			body->predictIntegratedTransform(timeStep, predictedTrans);
 
-			btScalar squareMotion = (predictedTrans.getOrigin() - body->getWorldTransform().getOrigin()).length2();
-
-			if (getDispatchInfo().m_useContinuous && body->getCcdSquareMotionThreshold() && body->getCcdSquareMotionThreshold() < squareMotion)
+			if (needsCcdMotionClamping(body, predictedTrans))
 			{
 				BT_PROFILE("CCD motion clamping");
-				if (body->getCollisionShape()->isConvex())
-				{
-					gNumClampedCcdMotions++;
+				gNumClampedCcdMotions++;
 #ifdef USE_STATIC_ONLY
-					class StaticOnlyCallback : public btClosestNotMeConvexResultCallback
-					{
-					public:
-						StaticOnlyCallback(btCollisionObject* me, const btVector3& fromA, const btVector3& toA, btOverlappingPairCache* pairCache, btDispatcher* dispatcher) : btClosestNotMeConvexResultCallback(me, fromA, toA, pairCache, dispatcher)
-						{
-						}
-
-						virtual bool needsCollision(btBroadphaseProxy* proxy0) const
-						{
-							btCollisionObject* otherObj = (btCollisionObject*)proxy0->m_clientObject;
-							if (!otherObj->isStaticOrKinematicObject())
-								return false;
-							return btClosestNotMeConvexResultCallback::needsCollision(proxy0);
-						}
-					};
-
-					StaticOnlyCallback sweepResults(body, body->getWorldTransform().getOrigin(), predictedTrans.getOrigin(), getBroadphase()->getOverlappingPairCache(), getDispatcher());
+				const bool staticOnly = true;
 #else
-					btClosestNotMeConvexResultCallback sweepResults(body, body->getWorldTransform().getOrigin(), predictedTrans.getOrigin(), getBroadphase()->getOverlappingPairCache(), getDispatcher());
+				const bool staticOnly = false;
 #endif
-					//btConvexShape* convexShape = static_cast<btConvexShape*>(body->getCollisionShape());
-					btSphereShape tmpSphere(body->getCcdSweptSphereRadius());  //btConvexShape* convexShape = static_cast<btConvexShape*>(body->getCollisionShape());
-					sweepResults.m_allowedPenetration = getDispatchInfo().m_allowedCcdPenetration;
+				CcdMotionHit hit;
+				if (sweepCcdMotion(body, predictedTrans, staticOnly, hit))
+				{
+					body->setHitFraction(hit.m_hitFraction);
+					body->predictIntegratedTransform(timeStep * body->getHitFraction(), predictedTrans);
+					body->setHitFraction(0.f);
+					body->proceedToTransform(predictedTrans);
 
-					sweepResults.m_collisionFilterGroup = body->getBroadphaseProxy()->m_collisionFilterGroup;
-					sweepResults.m_collisionFilterMask = body->getBroadphaseProxy()->m_collisionFilterMask;
-					btTransform modifiedPredictedTrans = predictedTrans;
-					modifiedPredictedTrans.setBasis(body->getWorldTransform().getBasis());
+#if 0
+					btVector3 linVel = body->getLinearVelocity();
 
-					convexSweepTest(&tmpSphere, body->getWorldTransform(), modifiedPredictedTrans, sweepResults);
-					if (sweepResults.hasHit() && (sweepResults.m_closestHitFraction < 1.f))
+					btScalar maxSpeed = body->getCcdMotionThreshold()/getSolverInfo().m_timeStep;
+					btScalar maxSpeedSqr = maxSpeed*maxSpeed;
+					if (linVel.length2()>maxSpeedSqr)
 					{
-						//printf("clamped integration to hit fraction = %f\n",fraction);
-						body->setHitFraction(sweepResults.m_closestHitFraction);
-						body->predictIntegratedTransform(timeStep * body->getHitFraction(), predictedTrans);
-						body->setHitFraction(0.f);
-						body->proceedToTransform(predictedTrans);
-
-#if 0
-						btVector3 linVel = body->getLinearVelocity();
-
-						btScalar maxSpeed = body->getCcdMotionThreshold()/getSolverInfo().m_timeStep;
-						btScalar maxSpeedSqr = maxSpeed*maxSpeed;
-						if (linVel.length2()>maxSpeedSqr)
-						{
-							linVel.normalize();
-							linVel*= maxSpeed;
-							body->setLinearVelocity(linVel);
-							btScalar ms2 = body->getLinearVelocity().length2();
-							body->predictIntegratedTransform(timeStep, predictedTrans);
-
-							btScalar sm2 = (predictedTrans.getOrigin()-body->getWorldTransform().getOrigin()).length2();
-							btScalar smt = body->getCcdSquareMotionThreshold();
-							printf("sm2=%f\n",sm2);
-						}
+						linVel.normalize();
+						linVel*= maxSpeed;
+						body->setLinearVelocity(linVel);
+						btScalar ms2 = body->getLinearVelocity().length2();
+						body->predictIntegratedTransform(timeStep, predictedTrans);
+
+						btScalar sm2 = (predictedTrans.getOrigin()-body->getWorldTransform().getOrigin()).length2();
+						btScalar smt = body->getCcdSquareMotionThreshold();
+						printf("sm2=%f\n",sm2);
+					}
 #else
 
-						//don't apply the collision response right now, it will happen next frame
-						//if you really need to, you can uncomment next 3 lines. Note that is uses zero restitution.
-						//btScalar appliedImpulse = 0.f;
-						//btScalar depth = 0.f;
-						//appliedImpulse = resolveSingleCollision(body,(btCollisionObject*)sweepResults.m_hitCollisionObject,sweepResults.m_hitPointWorld,sweepResults.m_hitNormalWorld,getSolverInfo(), depth);
+					//don't apply the collision response right now, it will happen next frame
+					//if you really need to, you can uncomment next 3 lines. Note that is uses zero restitution.
+					//btScalar appliedImpulse = 0.f;
+					//btScalar depth = 0.f;
+					//appliedImpulse = resolveSingleCollision(body,(btCollisionObject*)sweepResults.m_hitCollisionObject,sweepResults.m_hitPointWorld,sweepResults.m_hitNormalWorld,getSolverInfo(), depth);
 
 #endif
 
-						continue;
-					}
+					continue;
 				}
 			}
 
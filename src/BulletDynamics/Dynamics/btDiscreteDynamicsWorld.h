@@ -86,6 +86,18 @@ protected:
 
 	virtual void internalSingleStepSimulation(btScalar timeStep);
 
+	///the first hit of the ccd swept sphere of a body along its predicted motion
+	struct CcdMotionHit
+	{
+		const btCollisionObject* m_hitObject;
+		btVector3 m_hitNormalWorld;
+		btScalar m_hitFraction;
+	};
+
+	bool needsCcdMotionClamping(const btRigidBody* body, const btTransform& predictedTrans) const;
+	bool sweepCcdMotion(btRigidBody * body, const btTransform& predictedTrans, bool staticOnly, CcdMotionHit& hit) const;  // only reads the world, can be called in parallel
+	btPersistentManifold* addPredictiveContact(btRigidBody * body, const btTransform& predictedTrans, const CcdMotionHit& hit);
+
 	void releasePredictiveContacts();
 	void createPredictiveContactsInternal(btRigidBody * *bodies, int numBodies, btScalar timeStep);  // can be called in parallel
 	virtual void createPredictiveContacts(btScalar timeStep);
@@ -46,6 +46,8 @@ subject to the following restrictions:
 
 #include "LinearMath/btSerializer.h"
 
+extern int gNumClampedCcdMotions;
+
 ///
 /// btConstraintSolverPoolMt
 ///
@@ -222,18 +224,76 @@ void btDiscreteDynamicsWorldMt::predictUnconstraintMotion(btScalar timeStep)
 	}
 }
 
+btScalar btDiscreteDynamicsWorldMt::predictCcdMotionsInternal(int iBegin, int iEnd, btScalar timeStep)
+{
+	int numSweeps = 0;
+	for (int i = iBegin; i < iEnd; ++i)
+	{
+		btRigidBody* body = m_nonStaticRigidBodies[i];
+		CcdMotion& motion = m_ccdMotions[i];
+		motion.m_hasHit = false;
+		body->setHitFraction(1.f);
+
+		if (body->isActive() && (!body->isStaticOrKinematicObject()))
+		{
+			body->predictIntegratedTransform(timeStep, motion.m_predictedTrans);
+			if (needsCcdMotionClamping(body, motion.m_predictedTrans))
+			{
+				BT_PROFILE("CCD convexSweepTest");
+				numSweeps++;
+				motion.m_hasHit = sweepCcdMotion(body, motion.m_predictedTrans, false, motion.m_hit);
+			}
+		}
+	}
+	return btScalar(numSweeps);
+}
+
+void btDiscreteDynamicsWorldMt::applyCcdMotionsInternal(int iBegin, int iEnd, btScalar timeStep)
+{
+	for (int i = iBegin; i < iEnd; ++i)
+	{
+		btRigidBody* body = m_nonStaticRigidBodies[i];
+		CcdMotion& motion = m_ccdMotions[i];
+		if (body->isActive() && (!body->isStaticOrKinematicObject()))
+		{
+			if (motion.m_hasHit)
+			{
+				//clamp the motion to the time of impact, the collision response happens next frame
+				body->setHitFraction(motion.m_hit.m_hitFraction);
+				body->predictIntegratedTransform(timeStep * body->getHitFraction(), motion.m_predictedTrans);
+				body->setHitFraction(0.f);
+			}
+			body->proceedToTransform(motion.m_predictedTrans);
+		}
+	}
+}
+
+void btDiscreteDynamicsWorldMt::predictCcdMotions(btScalar timeStep)
+{
+	m_ccdMotions.resize(m_nonStaticRigidBodies.size());
+	UpdaterPredictCcdMotions update;
+	update.world = this;
+	update.timeStep = timeStep;
+	int grainSize = 50;  // num of iterations per task for task scheduler
+	gNumClampedCcdMotions += int(btParallelSum(0, m_nonStaticRigidBodies.size(), grainSize, update));
+}
+
 void btDiscreteDynamicsWorldMt::createPredictiveContacts(btScalar timeStep)
 {
 	BT_PROFILE("createPredictiveContacts");
 	releasePredictiveContacts();
 	if (m_nonStaticRigidBodies.size() > 0)
 	{
-		UpdaterCreatePredictiveContacts update;
-		update.world = this;
-		update.timeStep = timeStep;
-		update.rigidBodies = &m_nonStaticRigidBodies[0];
-		int grainSize = 50;  // num of iterations per task for task scheduler
-		btParallelFor(0, m_nonStaticRigidBodies.size(), grainSize, update);
+		predictCcdMotions(timeStep);
+
+		//the manifolds are created in body order, so the solver sees the same contacts in the same order for any number of threads
+		for (int i = 0; i < m_nonStaticRigidBodies.size(); i++)
+		{
+			if (m_ccdMotions[i].m_hasHit)
+			{
+				addPredictiveContact(m_nonStaticRigidBodies[i], m_ccdMotions[i].m_predictedTrans, m_ccdMotions[i].m_hit);
+			}
+		}
 	}
 }
 
@@ -242,10 +302,12 @@ void btDiscreteDynamicsWorldMt::integrateTransforms(btScalar timeStep)
 	BT_PROFILE("integrateTransforms");
 	if (m_nonStaticRigidBodies.size() > 0)
 	{
-		UpdaterIntegrateTransforms update;
+		//sweep every body before moving any, the sweeps only read the world
+		predictCcdMotions(timeStep);
+
+		UpdaterApplyCcdMotions update;
 		update.world = this;
 		update.timeStep = timeStep;
-		update.rigidBodies = &m_nonStaticRigidBodies[0];
 		int grainSize = 50;  // num of iterations per task for task scheduler
 		btParallelFor(0, m_nonStaticRigidBodies.size(), grainSize, update);
 	}
@@ -78,6 +78,8 @@ private:
 ///     - predictUnconstraintMotion
 ///     - integrateTransforms
 ///     - createPredictiveContacts
+///  The ccd sweeps of the last two are done for all bodies before any body moves, and the predictive
+///  contacts are added in body order, so the results don't depend on the number of threads.
 ///
 ATTRIBUTE_ALIGNED16(class)
 btDiscreteDynamicsWorldMt : public btDiscreteDynamicsWorld
@@ -89,28 +91,40 @@ protected:
 
 	virtual void predictUnconstraintMotion(btScalar timeStep) BT_OVERRIDE;
 
-	struct UpdaterCreatePredictiveContacts : public btIParallelForBody
+	///the predicted transform of a body and the first hit of its ccd sweep. The sweeps of all bodies run in parallel
+	///against the world before any body moves, so the results don't depend on the number of threads
+	struct CcdMotion
+	{
+		btTransform m_predictedTrans;
+		CcdMotionHit m_hit;
+		bool m_hasHit;
+	};
+	btAlignedObjectArray<CcdMotion> m_ccdMotions;
+
+	btScalar predictCcdMotionsInternal(int iBegin, int iEnd, btScalar timeStep);  // can be called in parallel, returns the number of sweeps
+	void applyCcdMotionsInternal(int iBegin, int iEnd, btScalar timeStep);        // can be called in parallel
+	void predictCcdMotions(btScalar timeStep);
+
+	struct UpdaterPredictCcdMotions : public btIParallelSumBody
 	{
 		btScalar timeStep;
-		btRigidBody** rigidBodies;
 		btDiscreteDynamicsWorldMt* world;
 
-		void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+		btScalar sumLoop(int iBegin, int iEnd) const BT_OVERRIDE
 		{
-			world->createPredictiveContactsInternal(&rigidBodies[iBegin], iEnd - iBegin, timeStep);
+			return world->predictCcdMotionsInternal(iBegin, iEnd, timeStep);
 		}
 	};
 	virtual void createPredictiveContacts(btScalar timeStep) BT_OVERRIDE;
 
-	struct UpdaterIntegrateTransforms : public btIParallelForBody
+	struct UpdaterApplyCcdMotions : public btIParallelForBody
 	{
 		btScalar timeStep;
-		btRigidBody** rigidBodies;
 		btDiscreteDynamicsWorldMt* world;
 
 		void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
 		{
-			world->integrateTransformsInternal(&rigidBodies[iBegin], iEnd - iBegin, timeStep);
+			world->applyCcdMotionsInternal(iBegin, iEnd, timeStep);
 		}
 	};
 	virtual void integrateTransforms(btScalar timeStep) BT_OVERRIDE;
@@ -112,6 +112,7 @@ btMultiBody::btMultiBody(int n_links,
 	  m_sleepTimer(0),
       m_sleepEpsilon(INITIAL_SLEEP_EPSILON),
 	  m_sleepTimeout(INITIAL_SLEEP_TIMEOUT),
+	  m_canSleepLinks(false),
 
 	  m_userObjectPointer(0),
 	  m_userIndex2(-1),
@@ -978,6 +979,16 @@ void btMultiBody::computeAccelerationsArticulatedBodyAlgorithmMultiDof(btScalar
 		fromParent.m_rotMat = rot_from_parent[i + 1];
 		fromParent.m_trnVec = m_links[i].m_cachedRVector;
 
+		if (m_links[i].m_isSleeping)
+		{
+			// locked joint: the parent carries the full inertia and bias force of the link
+			fromParent.transformInverse(spatInertia[i + 1], spatInertia[parent + 1], btSpatialTransformationMatrix::Add);
+			spatForceVecTemps[0] = zeroAccSpatFrc[i + 1] + spatInertia[i + 1] * spatCoriolisAcc[i];
+			fromParent.transformInverse(spatForceVecTemps[0], spatForceVecTemps[1]);
+			zeroAccSpatFrc[parent + 1] += spatForceVecTemps[1];
+			continue;
+		}
+
 		for (int dof = 0; dof < m_links[i].m_dofCount; ++dof)
 		{
 			btSpatialForceVector &hDof = h[m_links[i].m_dofOffset + dof];
@@ -1124,7 +1135,14 @@ void btMultiBody::computeAccelerationsArticulatedBodyAlgorithmMultiDof(btScalar
 
 		fromParent.transform(spatAcc[parent + 1], spatAcc[i + 1]);
 
-		if(!isLinkAndAllAncestorsKinematic(i))
+		if (m_links[i].m_isSleeping && !isLinkAndAllAncestorsKinematic(i))
+		{
+			for (int dof = 0; dof < m_links[i].m_dofCount; ++dof)
+				joint_accel[m_links[i].m_dofOffset + dof] = 0;
+
+			spatAcc[i + 1] += spatCoriolisAcc[i];
+		}
+		else if(!isLinkAndAllAncestorsKinematic(i))
 		{
 			for (int dof = 0; dof < m_links[i].m_dofCount; ++dof)
 			{
@@ -1502,6 +1520,14 @@ void btMultiBody::calcAccelerationDeltasMultiDof(const btScalar *force, btScalar
 		fromParent.m_rotMat = rot_from_parent[i + 1];
 		fromParent.m_trnVec = m_links[i].m_cachedRVector;
 
+		if (m_links[i].m_isSleeping)
+		{
+			// locked joint: the force is transmitted to the parent unchanged
+			fromParent.transformInverse(zeroAccSpatFrc[i + 1], spatForceVecTemps[1]);
+			zeroAccSpatFrc[parent + 1] += spatForceVecTemps[1];
+			continue;
+		}
+
 		for (int dof = 0; dof < m_links[i].m_dofCount; ++dof)
 		{
 			Y[m_links[i].m_dofOffset + dof] = force[6 + m_links[i].m_dofOffset + dof] - m_links[i].m_axes[dof].dot(zeroAccSpatFrc[i + 1]);
@@ -1562,6 +1588,13 @@ void btMultiBody::calcAccelerationDeltasMultiDof(const btScalar *force, btScalar
 
 		fromParent.transform(spatAcc[parent + 1], spatAcc[i + 1]);
 
+		if (m_links[i].m_isSleeping)
+		{
+			for (int dof = 0; dof < m_links[i].m_dofCount; ++dof)
+				joint_accel[m_links[i].m_dofOffset + dof] = 0;
+			continue;
+		}
+
 		for (int dof = 0; dof < m_links[i].m_dofCount; ++dof)
 		{
 			const btSpatialForceVector &hDof = h[m_links[i].m_dofOffset + dof];
@@ -2086,6 +2119,11 @@ void btMultiBody::wakeUp()
 {
 	m_sleepTimer = 0;
 	m_awake = true;
+	for (int i = 0; i < m_links.size(); ++i)
+	{
+		m_links[i].m_isSleeping = false;
+		m_links[i].m_sleepTimer = 0;
+	}
 }
 
 void btMultiBody::goToSleep()
@@ -2093,9 +2131,107 @@ void btMultiBody::goToSleep()
 	m_awake = false;
 }
 
+void btMultiBody::setCanSleepLinks(bool canSleepLinks)
+{
+	m_canSleepLinks = canSleepLinks;
+	if (!canSleepLinks)
+	{
+		for (int i = 0; i < m_links.size(); ++i)
+		{
+			m_links[i].m_isSleeping = false;
+			m_links[i].m_sleepTimer = 0;
+		}
+	}
+}
+
+void btMultiBody::wakeUpLink(int i)
+{
+	// only the timers are reset here, so the cached h/invD stay valid during constraint solving.
+	// Ancestors are reset too, otherwise one of them falls asleep and locks this link again.
+	int link = i;
+	while (link != -1)
+	{
+		m_links[link].m_sleepTimer = 0;
+		link = m_links[link].m_parent;
+	}
+}
+
+void btMultiBody::putLinkToSleep(int i)
+{
+	m_links[i].m_isSleeping = true;
+	btScalar *qd = getJointVelMultiDof(i);
+	for (int dof = 0; dof < m_links[i].m_dofCount; ++dof)
+	{
+		qd[dof] = 0;
+	}
+}
+
+void btMultiBody::checkLinkMotionAndSleepIfRequired(btScalar timestep)
+{
+	const int num_links = getNumLinks();
+	if (!m_awake || num_links == 0)
+		return;
+
+	// joint space motion of each subtree: sum of squares of the joint velocities of the link and
+	// all its descendants. Children always have a larger index than their parent.
+	m_subtreeMotion.resize(num_links);
+	for (int i = 0; i < num_links; ++i)
+	{
+		const btScalar *qd = getJointVelMultiDof(i);
+		btScalar motion = 0;
+		for (int dof = 0; dof < m_links[i].m_dofCount; ++dof)
+			motion += qd[dof] * qd[dof];
+		m_subtreeMotion[i] = motion;
+	}
+	for (int i = num_links - 1; i >= 0; --i)
+	{
+		const int parent = m_links[i].m_parent;
+		if (parent >= 0)
+			m_subtreeMotion[parent] += m_subtreeMotion[i];
+	}
+
+	for (int i = 0; i < num_links; ++i)
+	{
+		btMultibodyLink &link = m_links[i];
+		const int parent = link.m_parent;
+		if (parent >= 0 && m_links[parent].m_isSleeping)
+		{
+			// the subtree of a locked joint is locked too
+			if (!link.m_isSleeping)
+				putLinkToSleep(i);
+			link.m_sleepTimer = m_links[parent].m_sleepTimer;
+			continue;
+		}
+
+		if (m_subtreeMotion[i] < m_sleepEpsilon)
+		{
+			link.m_sleepTimer += timestep;
+		}
+		else
+		{
+			link.m_sleepTimer = 0;
+		}
+
+		if (link.m_sleepTimer > m_sleepTimeout)
+		{
+			if (!link.m_isSleeping)
+				putLinkToSleep(i);
+		}
+		else
+		{
+			link.m_isSleeping = false;
+		}
+	}
+}
+
 void btMultiBody::checkMotionAndSleepIfRequired(btScalar timestep)
 {
 	extern bool gDisableDeactivation;
+	if (m_canSleepLinks && !gDisableDeactivation)
+	{
+		checkLinkMotionAndSleepIfRequired(timestep);
+	}
+
 	if (!m_canSleep || gDisableDeactivation)
 	{
 		m_awake = true;
@@ -553,6 +553,36 @@ public:
 	void goToSleep();
 	void checkMotionAndSleepIfRequired(btScalar timestep);
 
+	btScalar getSleepTimer() const
+	{
+		return m_sleepTimer;
+	}
+	void setSleepTimer(btScalar sleepTimer)
+	{
+		m_sleepTimer = sleepTimer;
+	}
+
+	//
+	// per-link sleeping: a link whose subtree joint velocities stay below the sleep threshold
+	// for longer than the sleep timeout gets its joint locked, while the rest of the body keeps moving.
+	// Locked joints are skipped in the articulated body algorithm, and joint motor/limit rows are not created.
+	//
+	void setCanSleepLinks(bool canSleepLinks);
+
+	bool getCanSleepLinks() const
+	{
+		return m_canSleepLinks;
+	}
+
+	bool isLinkSleeping(int i) const
+	{
+		return m_links[i].m_isSleeping;
+	}
+
+	///wake up the link and all its ancestors, so the joint can move again. The joint gets unlocked
+	///at the next checkMotionAndSleepIfRequired, so it is safe to call this during constraint solving.
+	void wakeUpLink(int i);
+
 	bool hasFixedBase() const;
 
 	bool isBaseKinematic() const;
@@ -739,6 +769,16 @@ public:
 		this->m_sleepTimeout = sleepTimeout;
 	}
 
+	btScalar getSleepThreshold() const
+	{
+		return m_sleepEpsilon;
+	}
+
+	btScalar getSleepTimeout() const
+	{
+		return m_sleepTimeout;
+	}
+
 
 private:
 	btMultiBody(const btMultiBody &);     // not implemented
@@ -761,6 +801,9 @@ private:
 
 	void mulMatrix(const btScalar *pA, const btScalar *pB, int rowsA, int colsA, int rowsB, int colsB, btScalar *pC) const;
 
+	void checkLinkMotionAndSleepIfRequired(btScalar timestep);
+	void putLinkToSleep(int i);
+
 private:
 	btMultiBodyLinkCollider *m_baseCollider;  //can be NULL
 	const char *m_baseName;                   //memory needs to be manager by user!
@@ -817,6 +860,8 @@ private:
 	btScalar m_sleepTimer;
 	btScalar m_sleepEpsilon;
 	btScalar m_sleepTimeout;
+	bool m_canSleepLinks;
+	btAlignedObjectArray<btScalar> m_subtreeMotion;
 
 	void *m_userObjectPointer;
 	int m_userIndex2;
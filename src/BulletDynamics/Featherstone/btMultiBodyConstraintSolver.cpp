@@ -29,6 +29,13 @@ btScalar btMultiBodyConstraintSolver::solveSingleIteration(int iteration, btColl
 {
 	btScalar leastSquaredResidual = btSequentialImpulseConstraintSolver::solveSingleIteration(iteration, bodies, numBodies, manifoldPtr, numManifolds, constraints, numConstraints, infoGlobal, debugDrawer);
 
+	//solve featherstone loop closures directly, the iterations below only need to deal with their clamping
+	if ((infoGlobal.m_solverMode & SOLVER_USE_DIRECT_LOOP_CLOSURES) && m_loopClosureSolver.getNumRows())
+	{
+		btScalar residual = resolveLoopClosureRows();
+		leastSquaredResidual = btMax(leastSquaredResidual, residual);
+	}
+
 	//solve featherstone non-contact constraints
 	btScalar nonContactResidual = 0;
 	//printf("m_multiBodyNonContactConstraints = %d\n",m_multiBodyNonContactConstraints.size());
@@ -223,6 +230,11 @@ btScalar btMultiBodyConstraintSolver::solveGroupCacheFriendlySetup(btCollisionOb
 
 	btScalar val = btSequentialImpulseConstraintSolver::solveGroupCacheFriendlySetup(bodies, numBodies, manifoldPtr, numManifolds, constraints, numConstraints, infoGlobal, debugDrawer);
 
+	if (infoGlobal.m_solverMode & SOLVER_USE_DIRECT_LOOP_CLOSURES)
+	{
+		m_loopClosureSolver.setup(m_multiBodyNonContactConstraints, m_tmpSolverBodyPool, m_data);
+	}
+
 	return val;
 }
 
@@ -315,6 +327,111 @@ btScalar btMultiBodyConstraintSolver::resolveSingleConstraintRowGeneric(const bt
 	return deltaVel;
 }
 
+btScalar btMultiBodyConstraintSolver::getRowDeltaVelocity(const btMultiBodySolverConstraint& c)
+{
+	btScalar deltaVelDotn = 0;
+	if (c.m_multiBodyA)
+	{
+		const int ndofA = c.m_multiBodyA->getNumDofs() + 6;
+		for (int i = 0; i < ndofA; ++i)
+			deltaVelDotn += m_data.m_jacobians[c.m_jacAindex + i] * m_data.m_deltaVelocities[c.m_deltaVelAindex + i];
+	}
+	else if (c.m_solverBodyIdA >= 0)
+	{
+		btSolverBody* bodyA = &m_tmpSolverBodyPool[c.m_solverBodyIdA];
+		deltaVelDotn += c.m_contactNormal1.dot(bodyA->internalGetDeltaLinearVelocity()) + c.m_relpos1CrossNormal.dot(bodyA->internalGetDeltaAngularVelocity());
+	}
+
+	if (c.m_multiBodyB)
+	{
+		const int ndofB = c.m_multiBodyB->getNumDofs() + 6;
+		for (int i = 0; i < ndofB; ++i)
+			deltaVelDotn += m_data.m_jacobians[c.m_jacBindex + i] * m_data.m_deltaVelocities[c.m_deltaVelBindex + i];
+	}
+	else if (c.m_solverBodyIdB >= 0)
+	{
+		btSolverBody* bodyB = &m_tmpSolverBodyPool[c.m_solverBodyIdB];
+		deltaVelDotn += c.m_contactNormal2.dot(bodyB->internalGetDeltaLinearVelocity()) + c.m_relpos2CrossNormal.dot(bodyB->internalGetDeltaAngularVelocity());
+	}
+	return deltaVelDotn;
+}
+
+void btMultiBodyConstraintSolver::applyRowDeltaImpulse(const btMultiBodySolverConstraint& c, btScalar deltaImpulse)
+{
+	if (c.m_multiBodyA)
+	{
+		applyDeltaVee(&m_data.m_deltaVelocitiesUnitImpulse[c.m_jacAindex], deltaImpulse, c.m_deltaVelAindex, c.m_multiBodyA->getNumDofs() + 6);
+#ifdef DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
+		c.m_multiBodyA->applyDeltaVeeMultiDof2(&m_data.m_deltaVelocitiesUnitImpulse[c.m_jacAindex], deltaImpulse);
+#endif  //DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
+	}
+	else if (c.m_solverBodyIdA >= 0)
+	{
+		btSolverBody* bodyA = &m_tmpSolverBodyPool[c.m_solverBodyIdA];
+		bodyA->internalApplyImpulse(c.m_contactNormal1 * bodyA->internalGetInvMass(), c.m_angularComponentA, deltaImpulse);
+	}
+	if (c.m_multiBodyB)
+	{
+		applyDeltaVee(&m_data.m_deltaVelocitiesUnitImpulse[c.m_jacBindex], deltaImpulse, c.m_deltaVelBindex, c.m_multiBodyB->getNumDofs() + 6);
+#ifdef DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
+		c.m_multiBodyB->applyDeltaVeeMultiDof2(&m_data.m_deltaVelocitiesUnitImpulse[c.m_jacBindex], deltaImpulse);
+#endif  //DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
+	}
+	else if (c.m_solverBodyIdB >= 0)
+	{
+		btSolverBody* bodyB = &m_tmpSolverBodyPool[c.m_solverBodyIdB];
+		bodyB->internalApplyImpulse(c.m_contactNormal2 * bodyB->internalGetInvMass(), c.m_angularComponentB, deltaImpulse);
+	}
+}
+
+btScalar btMultiBodyConstraintSolver::resolveLoopClosureRows()
+{
+	BT_PROFILE("resolveLoopClosureRows");
+	const int numRows = m_loopClosureSolver.getNumRows();
+	m_loopClosureImpulses.resize(numRows);
+
+	// right hand side in velocity units: the remaining constraint space velocity error of each row
+	btScalar leastSquaredResidual = 0;
+	for (int r = 0; r < numRows; ++r)
+	{
+		const btMultiBodySolverConstraint& c = m_multiBodyNonContactConstraints[m_loopClosureSolver.getRowIndex(r)];
+		const btScalar deltaImpulse = c.m_rhs - btScalar(c.m_appliedImpulse) * c.m_cfm - getRowDeltaVelocity(c) * c.m_jacDiagABInv;
+		const btScalar deltaVel = deltaImpulse / c.m_jacDiagABInv;
+		m_loopClosureImpulses[r] = deltaVel;
+		leastSquaredResidual = btMax(leastSquaredResidual, deltaVel * deltaVel);
+	}
+
+	m_loopClosureSolver.solve(&m_loopClosureImpulses[0]);
+
+	for (int r = 0; r < numRows; ++r)
+	{
+		btMultiBodySolverConstraint& c = m_multiBodyNonContactConstraints[m_loopClosureSolver.getRowIndex(r)];
+		btScalar deltaImpulse = m_loopClosureImpulses[r];
+		const btScalar sum = btScalar(c.m_appliedImpulse) + deltaImpulse;
+		if (sum < c.m_lowerLimit)
+		{
+			deltaImpulse = c.m_lowerLimit - c.m_appliedImpulse;
+			c.m_appliedImpulse = c.m_lowerLimit;
+		}
+		else if (sum > c.m_upperLimit)
+		{
+			deltaImpulse = c.m_upperLimit - c.m_appliedImpulse;
+			c.m_appliedImpulse = c.m_upperLimit;
+		}
+		else
+		{
+			c.m_appliedImpulse = sum;
+		}
+		applyRowDeltaImpulse(c, deltaImpulse);
+
+		if (c.m_multiBodyA)
+			c.m_multiBodyA->setPosUpdated(false);
+		if (c.m_multiBodyB)
+			c.m_multiBodyB->setPosUpdated(false);
+	}
+	return leastSquaredResidual;
+}
+
 btScalar btMultiBodyConstraintSolver::resolveConeFrictionConstraintRows(const btMultiBodySolverConstraint& cA1, const btMultiBodySolverConstraint& cB)
 {
 	int ndofA = 0;
@@ -1529,6 +1646,14 @@ void btMultiBodyConstraintSolver::writeBackSolverBodyToMultiBody(btMultiBodySolv
 	{
 		c.m_orgConstraint->internalSetAppliedImpulse(c.m_orgDofIndex, c.m_appliedImpulse);
 	}
+	else if (c.m_appliedImpulse != 0.f)
+	{
+		//contacts keep the touched links (and their ancestors) from locking their joints
+		if (c.m_multiBodyA && c.m_linkA >= 0 && c.m_multiBodyA->getCanSleepLinks())
+			c.m_multiBodyA->wakeUpLink(c.m_linkA);
+		if (c.m_multiBodyB && c.m_linkB >= 0 && c.m_multiBodyB->getCanSleepLinks())
+			c.m_multiBodyB->wakeUpLink(c.m_linkB);
+	}
 
 	if (c.m_multiBodyA)
 	{
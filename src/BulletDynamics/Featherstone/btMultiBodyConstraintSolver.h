@@ -24,6 +24,7 @@ subject to the following restrictions:
 class btMultiBody;
 
 #include "btMultiBodyConstraint.h"
+#include "btMultiBodyLoopClosureSolver.h"
 
 ATTRIBUTE_ALIGNED16(class)
 btMultiBodyConstraintSolver : public btSequentialImpulseConstraintSolver
@@ -38,12 +39,22 @@ protected:
 
 	btMultiBodyJacobianData m_data;
 
+	//direct solver for the bilateral rows in m_multiBodyNonContactConstraints, see SOLVER_USE_DIRECT_LOOP_CLOSURES
+	btMultiBodyLoopClosureSolver m_loopClosureSolver;
+	btAlignedObjectArray<btScalar> m_loopClosureImpulses;
+
 	//temp storage for multi body constraints for a specific island/group called by 'solveGroup'
 	btMultiBodyConstraint** m_tmpMultiBodyConstraints;
 	int m_tmpNumMultiBodyConstraints;
 
 	btScalar resolveSingleConstraintRowGeneric(const btMultiBodySolverConstraint& c);
 
+	btScalar getRowDeltaVelocity(const btMultiBodySolverConstraint& c);
+	void applyRowDeltaImpulse(const btMultiBodySolverConstraint& c, btScalar deltaImpulse);
+
+	//solve all loop closure rows at once, keeping the impulses of the other rows fixed
+	btScalar resolveLoopClosureRows();
+
 	//solve 2 friction directions and clamp against the implicit friction cone
 	btScalar resolveConeFrictionConstraintRows(const btMultiBodySolverConstraint& cA1, const btMultiBodySolverConstraint& cB);
 
@@ -95,6 +106,11 @@ public:
 	virtual btScalar solveGroup(btCollisionObject * *bodies, int numBodies, btPersistentManifold** manifold, int numManifolds, btTypedConstraint** constraints, int numConstraints, const btContactSolverInfo& info, btIDebugDraw* debugDrawer, btDispatcher* dispatcher);
 	virtual btScalar solveGroupCacheFriendlyFinish(btCollisionObject * *bodies, int numBodies, const btContactSolverInfo& infoGlobal);
 
+	const btMultiBodyLoopClosureSolver& getLoopClosureSolver() const
+	{
+		return m_loopClosureSolver;
+	}
+
 	virtual void solveMultiBodyGroup(btCollisionObject * *bodies, int numBodies, btPersistentManifold** manifold, int numManifolds, btTypedConstraint** constraints, int numConstraints, btMultiBodyConstraint** multiBodyConstraints, int numMultiBodyConstraints, const btContactSolverInfo& info, btIDebugDraw* debugDrawer, btDispatcher* dispatcher);
 };
 
@@ -100,6 +100,10 @@ void btMultiBodyJointLimitConstraint::createConstraintRows(btMultiBodyConstraint
 		finalizeMultiDof();
 	}
 
+	// a locked joint cannot move into its limits
+	if (m_bodyA->isLinkSleeping(m_linkA))
+		return;
+
 	// row 0: the lower bound
 	setPosition(0, m_bodyA->getJointPos(m_linkA) - m_lowerBound);  //multidof: this is joint-type dependent
 
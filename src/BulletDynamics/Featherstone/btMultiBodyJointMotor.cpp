@@ -122,6 +122,16 @@ void btMultiBodyJointMotor::createConstraintRows(btMultiBodyConstraintArray& con
 	if (m_maxAppliedImpulse == 0.f)
 		return;
 
+	if (m_bodyA->isLinkSleeping(m_linkA))
+	{
+		// the locked joint holds its position; only wake it up if the motor wants to move it
+		btScalar currentPosition = m_bodyA->getJointPosMultiDof(m_linkA)[0];
+		btScalar drive = m_kp * m_erp * (m_desiredPosition - currentPosition) / infoGlobal.m_timeStep + m_kd * m_desiredVelocity;
+		if (drive * drive >= m_bodyA->getSleepThreshold())
+			m_bodyA->wakeUpLink(m_linkA);
+		return;
+	}
+
 	const btScalar posError = 0;
 	const btVector3 dummy(0, 0, 0);
 
@@ -132,6 +132,11 @@ struct btMultibodyLink
 	class btMultiBodyLinkCollider *m_collider;
 	int m_flags;
 
+	//a sleeping link has its joint locked: the link and its subtree move rigidly with the parent.
+	//see btMultiBody::setCanSleepLinks
+	bool m_isSleeping;
+	btScalar m_sleepTimer;
+
 	int m_dofCount, m_posVarCount;  //redundant but handy
 
 	eFeatherstoneJointType m_jointType;
@@ -160,6 +165,8 @@ struct btMultibodyLink
           m_cachedRotParentToThis_interpolate(0, 0, 0, 1),
 		  m_collider(0),
 		  m_flags(0),
+		  m_isSleeping(false),
+		  m_sleepTimer(0),
 		  m_dofCount(0),
 		  m_posVarCount(0),
 		  m_jointType(btMultibodyLink::eInvalid),
@@ -0,0 +1,364 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2013 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btMultiBodyLoopClosureSolver.h"
+#include "btMultiBody.h"
+#include "LinearMath/btQuickprof.h"
+
+//pivots below this fraction of the diagonal belong to redundant rows (for example a closed loop
+//that is constrained twice). Those rows are left to the iterative solver.
+static const btScalar gLoopClosurePivotTolerance = SIMD_EPSILON * btScalar(1000);
+
+static bool isLoopClosureRow(const btMultiBodySolverConstraint& c)
+{
+	return c.m_orgConstraint && !c.m_orgConstraint->isUnilateral() && !btFuzzyZero(c.m_jacDiagABInv);
+}
+
+// Rows acting on different sub-trees of a fixed base multibody don't couple, because the
+// joint space inverse mass matrix is block diagonal over the children of the fixed base.
+static int getCouplingBranch(const btMultiBody* multiBody, int link)
+{
+	if (!multiBody->hasFixedBase())
+		return -1;
+	if (link < 0)
+		return -2;
+	while (multiBody->getParent(link) >= 0)
+		link = multiBody->getParent(link);
+	return link;
+}
+
+// joint space or rigid body response of one side of row c to a unit impulse of one side of row offDiag
+static btScalar computeSideCoupling(
+	const btAlignedObjectArray<btSolverBody>& solverBodyPool,
+	const btMultiBodyJacobianData& data,
+	const btMultiBodySolverConstraint& c, bool sideB,
+	const btMultiBodySolverConstraint& offDiag, bool offDiagSideB)
+{
+	const btMultiBody* multiBody = sideB ? c.m_multiBodyB : c.m_multiBodyA;
+	const btMultiBody* offDiagMultiBody = offDiagSideB ? offDiag.m_multiBodyB : offDiag.m_multiBodyA;
+
+	if (multiBody || offDiagMultiBody)
+	{
+		if (multiBody != offDiagMultiBody)
+			return 0;
+
+		const int ndof = multiBody->getNumDofs() + 6;
+		const btScalar* jac = &data.m_jacobians[sideB ? c.m_jacBindex : c.m_jacAindex];
+		const btScalar* delta = &data.m_deltaVelocitiesUnitImpulse[offDiagSideB ? offDiag.m_jacBindex : offDiag.m_jacAindex];
+		btScalar result = 0;
+		for (int i = 0; i < ndof; ++i)
+			result += jac[i] * delta[i];
+		return result;
+	}
+
+	const int solverBodyId = sideB ? c.m_solverBodyIdB : c.m_solverBodyIdA;
+	const int offDiagSolverBodyId = offDiagSideB ? offDiag.m_solverBodyIdB : offDiag.m_solverBodyIdA;
+	if (solverBodyId < 0 || solverBodyId != offDiagSolverBodyId)
+		return 0;
+
+	const btSolverBody& solverBody = solverBodyPool[solverBodyId];
+	const btVector3& normal = sideB ? c.m_contactNormal2 : c.m_contactNormal1;
+	const btVector3& relposCrossNormal = sideB ? c.m_relpos2CrossNormal : c.m_relpos1CrossNormal;
+	const btVector3& offDiagNormal = offDiagSideB ? offDiag.m_contactNormal2 : offDiag.m_contactNormal1;
+	const btVector3& offDiagAngularComponent = offDiagSideB ? offDiag.m_angularComponentB : offDiag.m_angularComponentA;
+	return normal.dot(offDiagNormal * solverBody.internalGetInvMass()) + relposCrossNormal.dot(offDiagAngularComponent);
+}
+
+static btScalar computeRowCoupling(
+	const btAlignedObjectArray<btSolverBody>& solverBodyPool,
+	const btMultiBodyJacobianData& data,
+	const btMultiBodySolverConstraint& c,
+	const btMultiBodySolverConstraint& offDiag)
+{
+	btScalar result = 0;
+	for (int side = 0; side < 2; ++side)
+	{
+		for (int offDiagSide = 0; offDiagSide < 2; ++offDiagSide)
+		{
+			result += computeSideCoupling(solverBodyPool, data, c, side != 0, offDiag, offDiagSide != 0);
+		}
+	}
+	return result;
+}
+
+struct btLoopClosureKeySortPredicate
+{
+	bool operator()(const btLoopClosureCouplingKey& a, const btLoopClosureCouplingKey& b) const
+	{
+		if (a.m_body != b.m_body)
+			return a.m_body < b.m_body;
+		if (a.m_branch != b.m_branch)
+			return a.m_branch < b.m_branch;
+		return a.m_row < b.m_row;
+	}
+};
+
+btMultiBodyLoopClosureSolver::btMultiBodyLoopClosureSolver()
+	: m_numSymbolicAnalyses(0)
+{
+}
+
+void btMultiBodyLoopClosureSolver::buildSparsityPattern(const btMultiBodyConstraintArray& rows, const btAlignedObjectArray<btSolverBody>& solverBodyPool)
+{
+	const int n = m_rows.size();
+
+	// collect the bodies (or sub-trees) each row acts on
+	m_keys.resize(0);
+	for (int r = 0; r < n; ++r)
+	{
+		const btMultiBodySolverConstraint& c = rows[m_rows[r]];
+		for (int side = 0; side < 2; ++side)
+		{
+			const btMultiBody* multiBody = side ? c.m_multiBodyB : c.m_multiBodyA;
+			btLoopClosureCouplingKey key;
+			key.m_row = r;
+			if (multiBody)
+			{
+				key.m_body = multiBody;
+				key.m_branch = getCouplingBranch(multiBody, side ? c.m_linkB : c.m_linkA);
+				if (key.m_branch == -2)
+					continue;
+			}
+			else
+			{
+				const int solverBodyId = side ? c.m_solverBodyIdB : c.m_solverBodyIdA;
+				if (solverBodyId < 0 || solverBodyPool[solverBodyId].m_originalBody == 0)
+					continue;
+				key.m_body = &solverBodyPool[solverBodyId];
+				key.m_branch = -1;
+			}
+			m_keys.push_back(key);
+		}
+	}
+	m_keys.quickSort(btLoopClosureKeySortPredicate());
+
+	// group the rows by key, so each group is a list of mutually coupled rows
+	m_keyRowStart.resize(0);
+	m_rowKeys.resize(2 * n);
+	for (int i = 0; i < 2 * n; ++i)
+		m_rowKeys[i] = -1;
+	for (int k = 0; k < m_keys.size(); ++k)
+	{
+		if (k == 0 || m_keys[k].m_body != m_keys[k - 1].m_body || m_keys[k].m_branch != m_keys[k - 1].m_branch)
+			m_keyRowStart.push_back(k);
+		const int group = m_keyRowStart.size() - 1;
+		const int r = m_keys[k].m_row;
+		m_rowKeys[2 * r + (m_rowKeys[2 * r] < 0 ? 0 : 1)] = group;
+	}
+	m_keyRowStart.push_back(m_keys.size());
+
+	// column j of the upper triangle holds the rows i <= j that share a group with row j
+	m_Ap.resize(n + 1);
+	m_Ai.resize(0);
+	m_marker.resize(n);
+	for (int i = 0; i < n; ++i)
+		m_marker[i] = -1;
+	for (int j = 0; j < n; ++j)
+	{
+		m_Ap[j] = m_Ai.size();
+		for (int s = 0; s < 2; ++s)
+		{
+			const int group = m_rowKeys[2 * j + s];
+			if (group < 0)
+				continue;
+			for (int k = m_keyRowStart[group]; k < m_keyRowStart[group + 1]; ++k)
+			{
+				const int i = m_keys[k].m_row;
+				if (i > j)
+					break;
+				if (m_marker[i] != j)
+				{
+					m_marker[i] = j;
+					m_Ai.push_back(i);
+				}
+			}
+		}
+		// a row without coupling still needs its diagonal
+		if (m_marker[j] != j)
+		{
+			m_marker[j] = j;
+			m_Ai.push_back(j);
+		}
+	}
+	m_Ap[n] = m_Ai.size();
+}
+
+void btMultiBodyLoopClosureSolver::analyzeSymbolic()
+{
+	// elimination tree and number of nonzeros in each column of L
+	const int n = m_rows.size();
+	m_parent.resize(n);
+	m_Lnz.resize(n);
+	m_flag.resize(n);
+	m_Lp.resize(n + 1);
+
+	for (int k = 0; k < n; ++k)
+	{
+		m_parent[k] = -1;
+		m_flag[k] = k;
+		m_Lnz[k] = 0;
+		for (int p = m_Ap[k]; p < m_Ap[k + 1]; ++p)
+		{
+			int i = m_Ai[p];
+			if (i < k)
+			{
+				// follow the path from i to the root of the etree, stop at a flagged node
+				for (; m_flag[i] != k; i = m_parent[i])
+				{
+					if (m_parent[i] == -1)
+						m_parent[i] = k;
+					m_Lnz[i]++;
+					m_flag[i] = k;
+				}
+			}
+		}
+	}
+
+	m_Lp[0] = 0;
+	for (int k = 0; k < n; ++k)
+		m_Lp[k + 1] = m_Lp[k] + m_Lnz[k];
+
+	m_Li.resize(m_Lp[n]);
+	m_Lx.resize(m_Lp[n]);
+
+	m_prevAp = m_Ap;
+	m_prevAi = m_Ai;
+	m_numSymbolicAnalyses++;
+}
+
+void btMultiBodyLoopClosureSolver::factorizeNumeric()
+{
+	// up-looking LDL^T: row k of L is computed by a sparse triangular solve along the etree
+	const int n = m_rows.size();
+	m_D.resize(n);
+	m_y.resize(n);
+	m_pattern.resize(n);
+
+	for (int k = 0; k < n; ++k)
+	{
+		m_y[k] = 0;
+		int top = n;
+		m_flag[k] = k;
+		m_Lnz[k] = 0;
+		btScalar diag = 0;
+		for (int p = m_Ap[k]; p < m_Ap[k + 1]; ++p)
+		{
+			int i = m_Ai[p];
+			m_y[i] += m_Ax[p];
+			if (i == k)
+				diag = m_Ax[p];
+			int len = 0;
+			for (; m_flag[i] != k; i = m_parent[i])
+			{
+				m_pattern[len++] = i;
+				m_flag[i] = k;
+			}
+			while (len > 0)
+				m_pattern[--top] = m_pattern[--len];
+		}
+
+		m_D[k] = m_y[k];
+		m_y[k] = 0;
+		for (; top < n; ++top)
+		{
+			const int i = m_pattern[top];
+			const btScalar yi = m_y[i];
+			m_y[i] = 0;
+			const int p2 = m_Lp[i] + m_Lnz[i];
+			int p;
+			for (p = m_Lp[i]; p < p2; ++p)
+				m_y[m_Li[p]] -= m_Lx[p] * yi;
+			const btScalar l_ki = yi / m_D[i];
+			m_D[k] -= l_ki * yi;
+			m_Li[p] = k;
+			m_Lx[p] = l_ki;
+			m_Lnz[i]++;
+		}
+
+		if (m_D[k] <= gLoopClosurePivotTolerance * diag)
+		{
+			// decouple the redundant row: it receives no correction from the direct solve
+			m_D[k] = BT_LARGE_FLOAT;
+		}
+	}
+}
+
+void btMultiBodyLoopClosureSolver::setup(const btMultiBodyConstraintArray& rows, const btAlignedObjectArray<btSolverBody>& solverBodyPool, const btMultiBodyJacobianData& data)
+{
+	BT_PROFILE("btMultiBodyLoopClosureSolver::setup");
+
+	m_rows.resize(0);
+	for (int i = 0; i < rows.size(); ++i)
+	{
+		if (isLoopClosureRow(rows[i]))
+			m_rows.push_back(i);
+	}
+	const int n = m_rows.size();
+	if (n == 0)
+		return;
+
+	buildSparsityPattern(rows, solverBodyPool);
+
+	m_Ax.resize(m_Ai.size());
+	for (int j = 0; j < n; ++j)
+	{
+		const btMultiBodySolverConstraint& c = rows[m_rows[j]];
+		for (int p = m_Ap[j]; p < m_Ap[j + 1]; ++p)
+		{
+			const int i = m_Ai[p];
+			m_Ax[p] = computeRowCoupling(solverBodyPool, data, rows[m_rows[i]], c);
+			if (i == j)
+			{
+				// the iterative solver converges to (J M^-1 J^T + m_cfm / m_jacDiagABInv) x = m_rhs / m_jacDiagABInv
+				m_Ax[p] += c.m_cfm / c.m_jacDiagABInv;
+			}
+		}
+	}
+
+	bool reuseSymbolic = m_prevAp.size() == m_Ap.size() && m_prevAi.size() == m_Ai.size();
+	for (int i = 0; reuseSymbolic && i < m_Ap.size(); ++i)
+		reuseSymbolic = m_prevAp[i] == m_Ap[i];
+	for (int i = 0; reuseSymbolic && i < m_Ai.size(); ++i)
+		reuseSymbolic = m_prevAi[i] == m_Ai[i];
+
+	if (!reuseSymbolic)
+	{
+		analyzeSymbolic();
+	}
+	factorizeNumeric();
+}
+
+void btMultiBodyLoopClosureSolver::solve(btScalar* x) const
+{
+	const int n = m_rows.size();
+	// L y = b
+	for (int j = 0; j < n; ++j)
+	{
+		const btScalar xj = x[j];
+		for (int p = m_Lp[j]; p < m_Lp[j + 1]; ++p)
+			x[m_Li[p]] -= m_Lx[p] * xj;
+	}
+	// D z = y
+	for (int j = 0; j < n; ++j)
+		x[j] /= m_D[j];
+	// L^T x = z
+	for (int j = n - 1; j >= 0; --j)
+	{
+		btScalar xj = x[j];
+		for (int p = m_Lp[j]; p < m_Lp[j + 1]; ++p)
+			xj -= m_Lx[p] * x[m_Li[p]];
+		x[j] = xj;
+	}
+}
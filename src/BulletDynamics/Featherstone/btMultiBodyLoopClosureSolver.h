@@ -0,0 +1,102 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2013 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_MULTIBODY_LOOP_CLOSURE_SOLVER_H
+#define BT_MULTIBODY_LOOP_CLOSURE_SOLVER_H
+
+#include "LinearMath/btAlignedObjectArray.h"
+#include "btMultiBodyConstraint.h"
+
+struct btLoopClosureCouplingKey
+{
+	const void* m_body;
+	int m_branch;
+	int m_row;
+};
+
+///btMultiBodyLoopClosureSolver is a direct solver for the bilateral multibody constraint rows
+///(btMultiBodyPoint2Point, btMultiBodyFixedConstraint, btMultiBodySliderConstraint, btMultiBodyGearConstraint).
+///It assembles the constraint space matrix J M^-1 J^T + CFM of those rows in sparse form and factorises it as L D L^T.
+///Two rows only couple when they act on the same rigid body, or on the same sub-tree of a fixed base multibody,
+///so closed loops of different mechanisms stay decoupled. The symbolic analysis (elimination tree and
+///column counts of L) is reused as long as the sparsity pattern doesn't change between steps.
+///See SOLVER_USE_DIRECT_LOOP_CLOSURES in btContactSolverInfo.h
+class btMultiBodyLoopClosureSolver
+{
+	//selected rows, indices into the non-contact constraint rows of the btMultiBodyConstraintSolver
+	btAlignedObjectArray<int> m_rows;
+
+	//upper triangle of the matrix, in compressed column form
+	btAlignedObjectArray<int> m_Ap;
+	btAlignedObjectArray<int> m_Ai;
+	btAlignedObjectArray<btScalar> m_Ax;
+
+	//sparsity pattern of the previous factorization, to detect if the symbolic analysis can be reused
+	btAlignedObjectArray<int> m_prevAp;
+	btAlignedObjectArray<int> m_prevAi;
+
+	//symbolic analysis
+	btAlignedObjectArray<int> m_parent;
+	btAlignedObjectArray<int> m_Lp;
+
+	//numeric factorization, L is unit lower triangular in compressed column form
+	btAlignedObjectArray<int> m_Li;
+	btAlignedObjectArray<btScalar> m_Lx;
+	btAlignedObjectArray<btScalar> m_D;
+
+	//workspace
+	btAlignedObjectArray<int> m_Lnz;
+	btAlignedObjectArray<int> m_flag;
+	btAlignedObjectArray<int> m_pattern;
+	btAlignedObjectArray<btScalar> m_y;
+	btAlignedObjectArray<btLoopClosureCouplingKey> m_keys;
+	btAlignedObjectArray<int> m_rowKeys;
+	btAlignedObjectArray<int> m_keyRowStart;
+	btAlignedObjectArray<int> m_marker;
+
+	int m_numSymbolicAnalyses;
+
+	void buildSparsityPattern(const btMultiBodyConstraintArray& rows, const btAlignedObjectArray<btSolverBody>& solverBodyPool);
+	void analyzeSymbolic();
+	void factorizeNumeric();
+
+public:
+	btMultiBodyLoopClosureSolver();
+
+	///select the bilateral rows, assemble J M^-1 J^T + CFM and factorise it. Needs the jacobians and
+	///the unit impulse responses of the rows, so call it after all constraint rows are set up.
+	void setup(const btMultiBodyConstraintArray& rows, const btAlignedObjectArray<btSolverBody>& solverBodyPool, const btMultiBodyJacobianData& data);
+
+	///solve (J M^-1 J^T + CFM) x = b in place, b and x are ordered like getRowIndex
+	void solve(btScalar* x) const;
+
+	int getNumRows() const
+	{
+		return m_rows.size();
+	}
+
+	int getRowIndex(int i) const
+	{
+		return m_rows[i];
+	}
+
+	///number of times the symbolic analysis was computed, rather than reused from the previous step
+	int getNumSymbolicAnalyses() const
+	{
+		return m_numSymbolicAnalyses;
+	}
+};
+
+#endif  //BT_MULTIBODY_LOOP_CLOSURE_SOLVER_H
@@ -0,0 +1,323 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2013 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btMultiBodyWorldSnapshot.h"
+#include "btMultiBody.h"
+#include "btMultiBodyConstraint.h"
+#include "btMultiBodyDynamicsWorld.h"
+#include "BulletCollision/BroadphaseCollision/btDispatcher.h"
+#include "BulletCollision/NarrowPhaseCollision/btPersistentManifold.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+
+static bool btManifoldSnapshotLess(const btManifoldSnapshot& a, const btManifoldSnapshot& b)
+{
+	if (a.m_body0 != b.m_body0)
+		return a.m_body0 < b.m_body0;
+	if (a.m_body1 != b.m_body1)
+		return a.m_body1 < b.m_body1;
+	return a.m_manifoldIndex < b.m_manifoldIndex;
+}
+
+struct btManifoldSnapshotSortPredicate
+{
+	bool operator()(const btManifoldSnapshot& a, const btManifoldSnapshot& b) const
+	{
+		return btManifoldSnapshotLess(a, b);
+	}
+};
+
+btMultiBodyWorldSnapshot::btMultiBodyWorldSnapshot()
+{
+}
+
+void btMultiBodyWorldSnapshot::save(btMultiBodyDynamicsWorld* world)
+{
+	//multibodies
+	int stateSize = 0;
+	m_multiBodies.resize(world->getNumMultibodies());
+	for (int i = 0; i < world->getNumMultibodies(); i++)
+	{
+		btMultiBody* mb = world->getMultiBody(i);
+		btMultiBodySnapshot& snapshot = m_multiBodies[i];
+		snapshot.m_multiBody = mb;
+		snapshot.m_numLinks = mb->getNumLinks();
+		snapshot.m_numDofs = mb->getNumDofs();
+		snapshot.m_numPosVars = mb->getNumPosVars();
+		snapshot.m_stateOffset = stateSize;
+		snapshot.m_sleepTimer = mb->getSleepTimer();
+		snapshot.m_awake = mb->isAwake();
+		stateSize += 3 + 4 + 6 + snapshot.m_numDofs + snapshot.m_numPosVars + 2 * snapshot.m_numLinks;
+	}
+
+	m_multiBodyState.resize(stateSize);
+	for (int i = 0; i < m_multiBodies.size(); i++)
+	{
+		const btMultiBody* mb = m_multiBodies[i].m_multiBody;
+		btScalar* state = &m_multiBodyState[m_multiBodies[i].m_stateOffset];
+
+		const btVector3& basePos = mb->getBasePos();
+		const btQuaternion& baseRot = mb->getWorldToBaseRot();
+		for (int j = 0; j < 3; j++)
+			*state++ = basePos[j];
+		for (int j = 0; j < 4; j++)
+			*state++ = baseRot[j];
+
+		const btScalar* vel = mb->getVelocityVector();
+		for (int j = 0; j < 6 + mb->getNumDofs(); j++)
+			*state++ = vel[j];
+
+		for (int link = 0; link < mb->getNumLinks(); link++)
+		{
+			const btScalar* q = mb->getJointPosMultiDof(link);
+			for (int j = 0; j < mb->getLink(link).m_posVarCount; j++)
+				*state++ = q[j];
+			*state++ = mb->getLink(link).m_isSleeping ? btScalar(1) : btScalar(0);
+			*state++ = mb->getLink(link).m_sleepTimer;
+		}
+
+		if (m_scratchWorldToLocal.size() < mb->getNumLinks() + 1)
+		{
+			m_scratchWorldToLocal.resize(mb->getNumLinks() + 1);
+			m_scratchLocalOrigin.resize(mb->getNumLinks() + 1);
+		}
+	}
+
+	//collision objects and rigid bodies
+	const btCollisionObjectArray& objects = world->getCollisionObjectArray();
+	m_collisionObjects.resize(objects.size());
+	int numRigidBodies = 0;
+	for (int i = 0; i < objects.size(); i++)
+	{
+		btCollisionObject* obj = objects[i];
+		btCollisionObjectSnapshot& snapshot = m_collisionObjects[i];
+		snapshot.m_object = obj;
+		snapshot.m_worldTransform = obj->getWorldTransform();
+		snapshot.m_interpolationWorldTransform = obj->getInterpolationWorldTransform();
+		snapshot.m_interpolationLinearVelocity = obj->getInterpolationLinearVelocity();
+		snapshot.m_interpolationAngularVelocity = obj->getInterpolationAngularVelocity();
+		snapshot.m_deactivationTime = obj->getDeactivationTime();
+		snapshot.m_activationState = obj->getActivationState();
+		if (btRigidBody::upcast(obj))
+			numRigidBodies++;
+	}
+
+	m_rigidBodies.resize(numRigidBodies);
+	numRigidBodies = 0;
+	for (int i = 0; i < objects.size(); i++)
+	{
+		btRigidBody* body = btRigidBody::upcast(objects[i]);
+		if (body)
+		{
+			btRigidBodySnapshot& snapshot = m_rigidBodies[numRigidBodies++];
+			snapshot.m_body = body;
+			snapshot.m_linearVelocity = body->getLinearVelocity();
+			snapshot.m_angularVelocity = body->getAngularVelocity();
+		}
+	}
+
+	//multibody constraint impulses
+	int numRows = 0;
+	m_constraints.resize(world->getNumMultiBodyConstraints());
+	for (int i = 0; i < world->getNumMultiBodyConstraints(); i++)
+	{
+		m_constraints[i] = world->getMultiBodyConstraint(i);
+		numRows += m_constraints[i]->getNumRows();
+	}
+	m_constraintImpulses.resize(numRows);
+	numRows = 0;
+	for (int i = 0; i < m_constraints.size(); i++)
+	{
+		for (int row = 0; row < m_constraints[i]->getNumRows(); row++)
+			m_constraintImpulses[numRows++] = m_constraints[i]->getAppliedImpulse(row);
+	}
+
+	//contact manifolds
+	btDispatcher* dispatcher = world->getDispatcher();
+	const int numManifolds = dispatcher->getNumManifolds();
+	int numPoints = 0;
+	m_manifolds.resize(numManifolds);
+	for (int i = 0; i < numManifolds; i++)
+	{
+		const btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+		btManifoldSnapshot& snapshot = m_manifolds[i];
+		snapshot.m_body0 = manifold->getBody0();
+		snapshot.m_body1 = manifold->getBody1();
+		snapshot.m_manifoldIndex = i;
+		snapshot.m_firstPoint = numPoints;
+		snapshot.m_numPoints = manifold->getNumContacts();
+		numPoints += snapshot.m_numPoints;
+	}
+	m_contactPoints.resize(numPoints);
+	for (int i = 0; i < numManifolds; i++)
+	{
+		const btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+		for (int j = 0; j < m_manifolds[i].m_numPoints; j++)
+			m_contactPoints[m_manifolds[i].m_firstPoint + j] = manifold->getContactPoint(j);
+	}
+	m_manifolds.quickSort(btManifoldSnapshotSortPredicate());
+}
+
+bool btMultiBodyWorldSnapshot::matchesWorld(btMultiBodyDynamicsWorld* world) const
+{
+	if (m_multiBodies.size() != world->getNumMultibodies() ||
+		m_collisionObjects.size() != world->getNumCollisionObjects() ||
+		m_constraints.size() != world->getNumMultiBodyConstraints())
+		return false;
+
+	for (int i = 0; i < m_multiBodies.size(); i++)
+	{
+		const btMultiBodySnapshot& snapshot = m_multiBodies[i];
+		const btMultiBody* mb = world->getMultiBody(i);
+		if (snapshot.m_multiBody != mb ||
+			snapshot.m_numLinks != mb->getNumLinks() ||
+			snapshot.m_numDofs != mb->getNumDofs() ||
+			snapshot.m_numPosVars != mb->getNumPosVars())
+			return false;
+	}
+
+	const btCollisionObjectArray& objects = world->getCollisionObjectArray();
+	for (int i = 0; i < m_collisionObjects.size(); i++)
+	{
+		if (m_collisionObjects[i].m_object != objects[i])
+			return false;
+	}
+
+	int numRows = 0;
+	for (int i = 0; i < m_constraints.size(); i++)
+	{
+		if (m_constraints[i] != world->getMultiBodyConstraint(i))
+			return false;
+		numRows += m_constraints[i]->getNumRows();
+	}
+	return numRows == m_constraintImpulses.size();
+}
+
+int btMultiBodyWorldSnapshot::findManifold(const btCollisionObject* body0, const btCollisionObject* body1, int manifoldIndex) const
+{
+	btManifoldSnapshot key;
+	key.m_body0 = body0;
+	key.m_body1 = body1;
+	key.m_manifoldIndex = manifoldIndex;
+	int lo = 0;
+	int hi = m_manifolds.size();
+	while (lo < hi)
+	{
+		const int mid = (lo + hi) / 2;
+		if (btManifoldSnapshotLess(m_manifolds[mid], key))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo < m_manifolds.size() && m_manifolds[lo].m_body0 == body0 && m_manifolds[lo].m_body1 == body1 &&
+		m_manifolds[lo].m_manifoldIndex == manifoldIndex)
+		return lo;
+	return -1;
+}
+
+bool btMultiBodyWorldSnapshot::restore(btMultiBodyDynamicsWorld* world)
+{
+	if (!matchesWorld(world))
+		return false;
+
+	//multibodies
+	for (int i = 0; i < m_multiBodies.size(); i++)
+	{
+		const btMultiBodySnapshot& snapshot = m_multiBodies[i];
+		btMultiBody* mb = snapshot.m_multiBody;
+		const btScalar* state = &m_multiBodyState[snapshot.m_stateOffset];
+
+		mb->setBasePos(btVector3(state[0], state[1], state[2]));
+		mb->setWorldToBaseRot(btQuaternion(state[3], state[4], state[5], state[6]));
+		state += 7;
+
+		mb->setBaseOmega(btVector3(state[0], state[1], state[2]));
+		mb->setBaseVel(btVector3(state[3], state[4], state[5]));
+		for (int link = 0; link < mb->getNumLinks(); link++)
+			mb->setJointVelMultiDof(link, state + 6 + mb->getLink(link).m_dofOffset);
+		state += 6 + snapshot.m_numDofs;
+
+		if (snapshot.m_awake)
+			mb->wakeUp();
+		else
+			mb->goToSleep();
+		mb->setSleepTimer(snapshot.m_sleepTimer);
+
+		for (int link = 0; link < mb->getNumLinks(); link++)
+		{
+			btMultibodyLink& l = mb->getLink(link);
+			mb->setJointPosMultiDof(link, state);
+			for (int j = 0; j < l.m_posVarCount; j++)
+				l.m_jointPos_interpolate[j] = state[j];
+			state += l.m_posVarCount;
+			l.m_isSleeping = state[0] != btScalar(0);
+			l.m_sleepTimer = state[1];
+			state += 2;
+		}
+
+		mb->forwardKinematics(m_scratchWorldToLocal, m_scratchLocalOrigin);
+		mb->updateCollisionObjectWorldTransforms(m_scratchWorldToLocal, m_scratchLocalOrigin);
+	}
+
+	//collision objects, this also restores the interpolation transforms of the multibody link colliders
+	for (int i = 0; i < m_collisionObjects.size(); i++)
+	{
+		const btCollisionObjectSnapshot& snapshot = m_collisionObjects[i];
+		btCollisionObject* obj = snapshot.m_object;
+		obj->setWorldTransform(snapshot.m_worldTransform);
+		obj->setInterpolationWorldTransform(snapshot.m_interpolationWorldTransform);
+		obj->setInterpolationLinearVelocity(snapshot.m_interpolationLinearVelocity);
+		obj->setInterpolationAngularVelocity(snapshot.m_interpolationAngularVelocity);
+		obj->forceActivationState(snapshot.m_activationState);
+		obj->setDeactivationTime(snapshot.m_deactivationTime);
+	}
+
+	for (int i = 0; i < m_rigidBodies.size(); i++)
+	{
+		const btRigidBodySnapshot& snapshot = m_rigidBodies[i];
+		snapshot.m_body->setLinearVelocity(snapshot.m_linearVelocity);
+		snapshot.m_body->setAngularVelocity(snapshot.m_angularVelocity);
+	}
+
+	for (int i = 0; i < m_collisionObjects.size(); i++)
+	{
+		world->updateSingleAabb(m_collisionObjects[i].m_object);
+	}
+
+	//multibody constraint impulses
+	int numRows = 0;
+	for (int i = 0; i < m_constraints.size(); i++)
+	{
+		for (int row = 0; row < m_constraints[i]->getNumRows(); row++)
+			m_constraints[i]->internalSetAppliedImpulse(row, m_constraintImpulses[numRows++]);
+	}
+
+	//contact manifolds, matched by body pair and manifold index
+	btDispatcher* dispatcher = world->getDispatcher();
+	for (int i = 0; i < dispatcher->getNumManifolds(); i++)
+	{
+		btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+		const int index = findManifold(manifold->getBody0(), manifold->getBody1(), i);
+		if (index < 0)
+		{
+			manifold->setNumContacts(0);
+			continue;
+		}
+		const btManifoldSnapshot& snapshot = m_manifolds[index];
+		manifold->setNumContacts(snapshot.m_numPoints);
+		for (int j = 0; j < snapshot.m_numPoints; j++)
+			manifold->getContactPoint(j) = m_contactPoints[snapshot.m_firstPoint + j];
+	}
+	return true;
+}
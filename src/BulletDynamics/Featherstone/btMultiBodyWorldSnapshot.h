@@ -0,0 +1,130 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2013 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_MULTIBODY_WORLD_SNAPSHOT_H
+#define BT_MULTIBODY_WORLD_SNAPSHOT_H
+
+#include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btTransform.h"
+#include "BulletCollision/NarrowPhaseCollision/btManifoldPoint.h"
+
+class btMultiBody;
+class btMultiBodyConstraint;
+class btMultiBodyDynamicsWorld;
+class btCollisionObject;
+class btRigidBody;
+
+struct btCollisionObjectSnapshot
+{
+	btCollisionObject* m_object;
+	btTransform m_worldTransform;
+	btTransform m_interpolationWorldTransform;
+	btVector3 m_interpolationLinearVelocity;
+	btVector3 m_interpolationAngularVelocity;
+	btScalar m_deactivationTime;
+	int m_activationState;
+
+	btCollisionObjectSnapshot()
+		: m_object(0),
+		  m_worldTransform(btTransform::getIdentity()),
+		  m_interpolationWorldTransform(btTransform::getIdentity()),
+		  m_interpolationLinearVelocity(0, 0, 0),
+		  m_interpolationAngularVelocity(0, 0, 0),
+		  m_deactivationTime(0),
+		  m_activationState(0)
+	{
+	}
+};
+
+struct btRigidBodySnapshot
+{
+	btRigidBody* m_body;
+	btVector3 m_linearVelocity;
+	btVector3 m_angularVelocity;
+
+	btRigidBodySnapshot()
+		: m_body(0),
+		  m_linearVelocity(0, 0, 0),
+		  m_angularVelocity(0, 0, 0)
+	{
+	}
+};
+
+struct btMultiBodySnapshot
+{
+	btMultiBody* m_multiBody;
+	int m_numLinks;
+	int m_numDofs;
+	int m_numPosVars;
+	//offset into the flat btScalar state of the snapshot
+	int m_stateOffset;
+	btScalar m_sleepTimer;
+	bool m_awake;
+};
+
+struct btManifoldSnapshot
+{
+	const btCollisionObject* m_body0;
+	const btCollisionObject* m_body1;
+	//index of the manifold in the dispatcher, a body pair can have several manifolds (compounds, meshes)
+	int m_manifoldIndex;
+	int m_firstPoint;
+	int m_numPoints;
+};
+
+///btMultiBodyWorldSnapshot stores the reduced coordinate state of a btMultiBodyDynamicsWorld in flat arrays:
+///base pose and velocities, joint positions and velocities, sleeping state, rigid body state,
+///multibody constraint impulses and the contact points of the persistent manifolds (for warm starting).
+///Restoring a snapshot into the same world and stepping reproduces the trajectory that followed the save.
+///The arrays only grow when the world grows, so repeated save/restore of the same world doesn't allocate.
+///This is a light-weight alternative to serializing the world with btDefaultSerializer and restoring it
+///with btMultiBodyWorldImporter, when the snapshot doesn't need to leave the process.
+class btMultiBodyWorldSnapshot
+{
+	btAlignedObjectArray<btMultiBodySnapshot> m_multiBodies;
+	//per multibody: base position, world to base rotation, the velocity vector (6 + dofs),
+	//joint positions (posVars) and the per-link sleeping state (2 per link)
+	btAlignedObjectArray<btScalar> m_multiBodyState;
+
+	btAlignedObjectArray<btCollisionObjectSnapshot> m_collisionObjects;
+	btAlignedObjectArray<btRigidBodySnapshot> m_rigidBodies;
+
+	btAlignedObjectArray<btMultiBodyConstraint*> m_constraints;
+	btAlignedObjectArray<btScalar> m_constraintImpulses;
+
+	//manifolds are sorted by body pair and manifold index, so they can be matched with a binary search on restore
+	btAlignedObjectArray<btManifoldSnapshot> m_manifolds;
+	btAlignedObjectArray<btManifoldPoint> m_contactPoints;
+
+	//scratch arrays for forwardKinematics on restore
+	btAlignedObjectArray<btQuaternion> m_scratchWorldToLocal;
+	btAlignedObjectArray<btVector3> m_scratchLocalOrigin;
+
+	bool matchesWorld(btMultiBodyDynamicsWorld* world) const;
+	int findManifold(const btCollisionObject* body0, const btCollisionObject* body1, int manifoldIndex) const;
+
+public:
+	btMultiBodyWorldSnapshot();
+
+	void save(btMultiBodyDynamicsWorld* world);
+
+	///restore the saved state into the world. Returns false and leaves the world untouched if bodies or
+	///multibody constraints were added or removed since the save. Manifolds are matched by body pair and
+	///dispatcher index, the ones that didn't exist at the time of the save are cleared, their contacts
+	///get regenerated without warm starting.
+	bool restore(btMultiBodyDynamicsWorld* world);
+};
+
+#endif  //BT_MULTIBODY_WORLD_SNAPSHOT_H
@@ -26,8 +26,8 @@
 
 btRigidBody& btActionInterface::getFixedBody()
 {
+	//the constructor gives it zero mass, it is only read afterwards so that vehicles updated in parallel can share it
 	static btRigidBody s_fixed(0, 0, 0);
-	s_fixed.setMassProps(btScalar(0.), btVector3(btScalar(0.), btScalar(0.), btScalar(0.)));
 	return s_fixed;
 }
 
@@ -157,20 +157,22 @@ void btRaycastVehicle::updateWheelTransformsWS(btWheelInfo& wheel, bool interpol
 	wheel.m_raycastInfo.m_wheelAxleWS = chassisTrans.getBasis() * wheel.m_wheelAxleCS;
 }
 
-btScalar btRaycastVehicle::rayCast(btWheelInfo& wheel)
+void btRaycastVehicle::getWheelRay(btWheelInfo& wheel, btVector3& source, btVector3& target)
 {
 	updateWheelTransformsWS(wheel, false);
 
-	btScalar depth = -1;
-
 	btScalar raylen = wheel.getSuspensionRestLength() + wheel.m_wheelsRadius;
 
 	btVector3 rayvector = wheel.m_raycastInfo.m_wheelDirectionWS * (raylen);
-	const btVector3& source = wheel.m_raycastInfo.m_hardPointWS;
+	source = wheel.m_raycastInfo.m_hardPointWS;
 	wheel.m_raycastInfo.m_contactPointWS = source + rayvector;
-	const btVector3& target = wheel.m_raycastInfo.m_contactPointWS;
+	target = wheel.m_raycastInfo.m_contactPointWS;
+}
 
-	btScalar param = btScalar(0.);
+btScalar btRaycastVehicle::rayCast(btWheelInfo& wheel)
+{
+	btVector3 source, target;
+	getWheelRay(wheel, source, target);
 
 	btVehicleRaycaster::btVehicleRaycasterResult rayResults;
 
@@ -178,6 +180,17 @@ btScalar btRaycastVehicle::rayCast(btWheelInfo& wheel)
 
 	void* object = m_vehicleRaycaster->castRay(source, target, rayResults);
 
+	return processWheelRayResult(wheel, object, rayResults);
+}
+
+btScalar btRaycastVehicle::processWheelRayResult(btWheelInfo& wheel, void* object, const btVehicleRaycaster::btVehicleRaycasterResult& rayResults)
+{
+	btScalar depth = -1;
+
+	btScalar raylen = wheel.getSuspensionRestLength() + wheel.m_wheelsRadius;
+
+	btScalar param = btScalar(0.);
+
 	wheel.m_raycastInfo.m_groundObject = 0;
 
 	if (object)
@@ -254,6 +267,24 @@ const btTransform& btRaycastVehicle::getChassisWorldTransform() const
 }
 
 void btRaycastVehicle::updateVehicle(btScalar step)
+{
+	prepareVehicleUpdate();
+
+	//
+	// simulate suspension
+	//
+
+	for (int i = 0; i < m_wheelInfo.size(); i++)
+	{
+		//btScalar depth;
+		//depth =
+		rayCast(m_wheelInfo[i]);
+	}
+
+	updateVehicleForces(step);
+}
+
+void btRaycastVehicle::prepareVehicleUpdate()
 {
 	{
 		for (int i = 0; i < getNumWheels(); i++)
@@ -275,20 +306,13 @@ void btRaycastVehicle::updateVehicle(btScalar step)
 	{
 		m_currentVehicleSpeedKmHour *= btScalar(-1.);
 	}
+}
 
-	//
-	// simulate suspension
-	//
+void btRaycastVehicle::updateVehicleForces(btScalar step)
+{
+	updateSuspension(step);
 
 	int i = 0;
-	for (i = 0; i < m_wheelInfo.size(); i++)
-	{
-		//btScalar depth;
-		//depth =
-		rayCast(m_wheelInfo[i]);
-	}
-
-	updateSuspension(step);
 
 	for (i = 0; i < m_wheelInfo.size(); i++)
 	{
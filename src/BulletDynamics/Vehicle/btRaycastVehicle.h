@@ -88,8 +88,19 @@ public:
 
 	btScalar rayCast(btWheelInfo& wheel);
 
+	///the suspension ray of a wheel, rayCast is getWheelRay, castRay and processWheelRayResult
+	void getWheelRay(btWheelInfo& wheel, btVector3& source, btVector3& target);
+
+	btScalar processWheelRayResult(btWheelInfo& wheel, void* object, const btVehicleRaycaster::btVehicleRaycasterResult& rayResults);
+
 	virtual void updateVehicle(btScalar step);
 
+	///updateVehicle is prepareVehicleUpdate, a rayCast of each wheel and updateVehicleForces. They only touch this
+	///vehicle's chassis, so btRaycastVehicleFleet runs them for many vehicles in parallel
+	void prepareVehicleUpdate();
+
+	void updateVehicleForces(btScalar step);
+
 	void resetSuspension();
 
 	btScalar getSteeringValue(int wheel) const;
@@ -135,6 +146,11 @@ public:
 		return m_chassisBody;
 	}
 
+	btVehicleRaycaster* getVehicleRaycaster()
+	{
+		return m_vehicleRaycaster;
+	}
+
 	const btRigidBody* getRigidBody() const
 	{
 		return m_chassisBody;
@@ -0,0 +1,192 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2006 Erwin Coumans  https://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btRaycastVehicleFleet.h"
+#include "LinearMath/btThreads.h"
+#include "LinearMath/btQuickprof.h"
+
+struct btGatherWheelRaysLoop : public btIParallelForBody
+{
+	btRaycastVehicleFleet* m_fleet;
+
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+	{
+		m_fleet->gatherWheelRays(iBegin, iEnd);
+	}
+};
+
+struct btCastWheelRaysLoop : public btIParallelForBody
+{
+	btRaycastVehicleFleet* m_fleet;
+
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+	{
+		m_fleet->castWheelRays(iBegin, iEnd);
+	}
+};
+
+struct btUpdateVehiclesLoop : public btIParallelForBody
+{
+	btRaycastVehicleFleet* m_fleet;
+	btScalar m_step;
+
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+	{
+		m_fleet->updateVehicles(iBegin, iEnd, m_step);
+	}
+};
+
+static bool btUseParallelFleetUpdate(int count, int grainSize)
+{
+#if BT_THREADSAFE
+	btITaskScheduler* scheduler = btGetTaskScheduler();
+	return count > grainSize && scheduler && scheduler->getNumThreads() > 1 && !btThreadsAreRunning();
+#else
+	(void)count;
+	(void)grainSize;
+	return false;
+#endif
+}
+
+btRaycastVehicleFleet::btRaycastVehicleFleet()
+	: m_grainSize(16)
+{
+}
+
+btRaycastVehicleFleet::~btRaycastVehicleFleet()
+{
+}
+
+void btRaycastVehicleFleet::addVehicle(btRaycastVehicle* vehicle)
+{
+	btAssert(m_vehicles.findLinearSearch(vehicle) == m_vehicles.size());
+	m_vehicles.push_back(vehicle);
+}
+
+void btRaycastVehicleFleet::removeVehicle(btRaycastVehicle* vehicle)
+{
+	m_vehicles.remove(vehicle);
+}
+
+void btRaycastVehicleFleet::gatherWheelRays(int vehicleBegin, int vehicleEnd)
+{
+	for (int v = vehicleBegin; v < vehicleEnd; v++)
+	{
+		btRaycastVehicle* vehicle = m_vehicles[v];
+		vehicle->prepareVehicleUpdate();
+		for (int w = 0; w < vehicle->getNumWheels(); w++)
+		{
+			const int ray = m_firstRay[v] + w;
+			vehicle->getWheelRay(vehicle->m_wheelInfo[w], m_rayFrom[ray], m_rayTo[ray]);
+			m_rayCaster[ray] = vehicle->getVehicleRaycaster();
+		}
+	}
+}
+
+void btRaycastVehicleFleet::castWheelRays(int rayBegin, int rayEnd)
+{
+	for (int i = rayBegin; i < rayEnd; i++)
+	{
+		m_rayObject[i] = m_rayCaster[i]->castRay(m_rayFrom[i], m_rayTo[i], m_rayResult[i]);
+	}
+}
+
+void btRaycastVehicleFleet::updateVehicles(int vehicleBegin, int vehicleEnd, btScalar step)
+{
+	for (int v = vehicleBegin; v < vehicleEnd; v++)
+	{
+		btRaycastVehicle* vehicle = m_vehicles[v];
+		for (int w = 0; w < vehicle->getNumWheels(); w++)
+		{
+			const int ray = m_firstRay[v] + w;
+			vehicle->processWheelRayResult(vehicle->m_wheelInfo[w], m_rayObject[ray], m_rayResult[ray]);
+		}
+		vehicle->updateVehicleForces(step);
+	}
+}
+
+void btRaycastVehicleFleet::updateAction(btCollisionWorld* collisionWorld, btScalar step)
+{
+	(void)collisionWorld;
+	BT_PROFILE("btRaycastVehicleFleet::updateAction");
+
+	const int numVehicles = m_vehicles.size();
+	if (!numVehicles)
+		return;
+
+	m_firstRay.resize(numVehicles);
+	int numRays = 0;
+	for (int v = 0; v < numVehicles; v++)
+	{
+		m_firstRay[v] = numRays;
+		numRays += m_vehicles[v]->getNumWheels();
+	}
+	m_rayFrom.resize(numRays);
+	m_rayTo.resize(numRays);
+	m_rayCaster.resize(numRays);
+	m_rayObject.resize(numRays);
+	m_rayResult.resize(numRays);
+
+	{
+		BT_PROFILE("gatherWheelRays");
+		btGatherWheelRaysLoop gatherLoop;
+		gatherLoop.m_fleet = this;
+		if (btUseParallelFleetUpdate(numVehicles, m_grainSize))
+		{
+			btParallelFor(0, numVehicles, m_grainSize, gatherLoop);
+		}
+		else
+		{
+			gatherLoop.forLoop(0, numVehicles);
+		}
+	}
+
+	{
+		BT_PROFILE("castWheelRays");
+		btCastWheelRaysLoop castLoop;
+		castLoop.m_fleet = this;
+		if (btUseParallelFleetUpdate(numRays, m_grainSize))
+		{
+			btParallelFor(0, numRays, m_grainSize, castLoop);
+		}
+		else
+		{
+			castLoop.forLoop(0, numRays);
+		}
+	}
+
+	{
+		BT_PROFILE("updateVehicles");
+		btUpdateVehiclesLoop updateLoop;
+		updateLoop.m_fleet = this;
+		updateLoop.m_step = step;
+		if (btUseParallelFleetUpdate(numVehicles, m_grainSize))
+		{
+			btParallelFor(0, numVehicles, m_grainSize, updateLoop);
+		}
+		else
+		{
+			updateLoop.forLoop(0, numVehicles);
+		}
+	}
+}
+
+void btRaycastVehicleFleet::debugDraw(btIDebugDraw* debugDrawer)
+{
+	for (int v = 0; v < m_vehicles.size(); v++)
+	{
+		m_vehicles[v]->debugDraw(debugDrawer);
+	}
+}
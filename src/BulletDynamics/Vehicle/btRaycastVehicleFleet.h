@@ -0,0 +1,84 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2006 Erwin Coumans  https://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_RAYCAST_VEHICLE_FLEET_H
+#define BT_RAYCAST_VEHICLE_FLEET_H
+
+#include "btRaycastVehicle.h"
+#include "LinearMath/btAlignedObjectArray.h"
+#include "BulletDynamics/Dynamics/btActionInterface.h"
+
+///btRaycastVehicleFleet updates many btRaycastVehicle as a single action, add it to the world instead of the vehicles.
+///Each step gathers the suspension rays of all wheels of all vehicles into one batch, casts the batch with btParallelFor and
+///then updates the suspension and friction of the vehicles in parallel. The vehicles only touch their own chassis, and the
+///results are the same as updating them one by one. Overrides of btRaycastVehicle::updateVehicle are not called.
+class btRaycastVehicleFleet : public btActionInterface
+{
+	btAlignedObjectArray<btRaycastVehicle*> m_vehicles;
+
+	///the wheel rays of all vehicles, the rays of vehicle v start at m_firstRay[v]
+	btAlignedObjectArray<int> m_firstRay;
+	btAlignedObjectArray<btVector3> m_rayFrom;
+	btAlignedObjectArray<btVector3> m_rayTo;
+	btAlignedObjectArray<btVehicleRaycaster*> m_rayCaster;
+	btAlignedObjectArray<void*> m_rayObject;
+	btAlignedObjectArray<btVehicleRaycaster::btVehicleRaycasterResult> m_rayResult;
+
+	int m_grainSize;
+
+public:
+	btRaycastVehicleFleet();
+
+	virtual ~btRaycastVehicleFleet();
+
+	void addVehicle(btRaycastVehicle* vehicle);
+
+	void removeVehicle(btRaycastVehicle* vehicle);
+
+	int getNumVehicles() const
+	{
+		return m_vehicles.size();
+	}
+
+	btRaycastVehicle* getVehicle(int index)
+	{
+		return m_vehicles[index];
+	}
+
+	///number of vehicles (or wheel rays) per task
+	void setGrainSize(int grainSize)
+	{
+		m_grainSize = grainSize;
+	}
+
+	int getGrainSize() const
+	{
+		return m_grainSize;
+	}
+
+	void gatherWheelRays(int vehicleBegin, int vehicleEnd);  // can be called in parallel
+
+	void castWheelRays(int rayBegin, int rayEnd);  // can be called in parallel
+
+	void updateVehicles(int vehicleBegin, int vehicleEnd, btScalar step);  // can be called in parallel
+
+	///btActionInterface interface
+	virtual void updateAction(btCollisionWorld* collisionWorld, btScalar step);
+
+	///btActionInterface interface
+	virtual void debugDraw(btIDebugDraw* debugDrawer);
+};
+
+#endif  //BT_RAYCAST_VEHICLE_FLEET_H
@@ -111,6 +111,44 @@ int MultiBodyTree::calculateInverseDynamics(const vecx &q, const vecx &u, const
 	return 0;
 }
 
+int MultiBodyTree::calculateInverseDynamicsDerivatives(const vecx &q, const vecx &u,
+													   const vecx &dot_u, vecx *joint_forces,
+													   matxx *d_joint_forces_dq,
+													   matxx *d_joint_forces_du)
+{
+	if (false == m_is_finalized)
+	{
+		bt_id_error_message("system has not been initialized\n");
+		return -1;
+	}
+	if (-1 == m_impl->calculateInverseDynamicsDerivatives(q, u, dot_u, joint_forces,
+														  d_joint_forces_dq, d_joint_forces_du))
+	{
+		bt_id_error_message("error in inverse dynamics derivatives calculation\n");
+		return -1;
+	}
+	return 0;
+}
+
+int MultiBodyTree::calculateForwardDynamicsDerivatives(const vecx &q, const vecx &u,
+													   const vecx &joint_forces, vecx *dot_u,
+													   matxx *d_dot_u_dq, matxx *d_dot_u_du,
+													   matxx *d_dot_u_d_joint_forces)
+{
+	if (false == m_is_finalized)
+	{
+		bt_id_error_message("system has not been initialized\n");
+		return -1;
+	}
+	if (-1 == m_impl->calculateForwardDynamicsDerivatives(q, u, joint_forces, dot_u, d_dot_u_dq,
+														  d_dot_u_du, d_dot_u_d_joint_forces))
+	{
+		bt_id_error_message("error in forward dynamics derivatives calculation\n");
+		return -1;
+	}
+	return 0;
+}
+
 int MultiBodyTree::calculateMassMatrix(const vecx &q, const bool update_kinematics,
 									   const bool initialize_matrix,
 									   const bool set_lower_triangular_matrix, matxx *mass_matrix)
@@ -136,6 +136,40 @@ public:
 	/// @return 0 on success, -1 on error
 	int calculateInverseDynamics(const vecx& q, const vecx& u, const vecx& dot_u,
 								 vecx* joint_forces);
+	/// Calculate partial derivatives of the joint forces computed by calculateInverseDynamics
+	/// w.r.t. the generalized coordinates and velocities.
+	/// The derivatives are computed analytically by differentiating the recursive
+	/// Newton-Euler algorithm, at a cost of O(dim(u) * numBodies()).
+	/// The partial derivative w.r.t. dot_u is the mass matrix (see calculateMassMatrix).
+	/// This also updates kinematic terms computed in calculateKinematics.
+	/// @param q generalized coordinates
+	/// @param u generalized velocities
+	/// @param dot_u time derivative of u
+	/// @param joint_forces this is where the resulting joint forces will be
+	///		stored. dim(joint_forces) = dim(u)
+	/// @param d_joint_forces_dq d(joint_forces)/dq, dim(u) x dim(q)
+	/// @param d_joint_forces_du d(joint_forces)/du, dim(u) x dim(u)
+	/// @return 0 on success, -1 on error
+	int calculateInverseDynamicsDerivatives(const vecx& q, const vecx& u, const vecx& dot_u,
+											vecx* joint_forces, matxx* d_joint_forces_dq,
+											matxx* d_joint_forces_du);
+	/// Calculate generalized accelerations for given joint forces (forward dynamics) and their
+	/// partial derivatives w.r.t. generalized coordinates, velocities and joint forces.
+	/// The derivatives w.r.t. q and u are obtained from calculateInverseDynamicsDerivatives,
+	/// evaluated at the solution dot_u; the derivative w.r.t. joint_forces is the inverse
+	/// of the mass matrix.
+	/// This also updates kinematic terms computed in calculateKinematics.
+	/// @param q generalized coordinates
+	/// @param u generalized velocities
+	/// @param joint_forces joint forces, dim(joint_forces) = dim(u)
+	/// @param dot_u this is where the resulting time derivative of u will be stored
+	/// @param d_dot_u_dq d(dot_u)/dq, dim(u) x dim(q)
+	/// @param d_dot_u_du d(dot_u)/du, dim(u) x dim(u)
+	/// @param d_dot_u_d_joint_forces d(dot_u)/d(joint_forces), dim(u) x dim(u)
+	/// @return 0 on success, -1 on error (including a singular mass matrix)
+	int calculateForwardDynamicsDerivatives(const vecx& q, const vecx& u, const vecx& joint_forces,
+											vecx* dot_u, matxx* d_dot_u_dq, matxx* d_dot_u_du,
+											matxx* d_dot_u_d_joint_forces);
 	/// Calculate joint space mass matrix
 	/// @param q generalized coordinates
 	/// @param initialize_matrix if true, initialize mass matrix with zero.
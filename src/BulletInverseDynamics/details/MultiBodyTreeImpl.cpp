@@ -8,6 +8,9 @@ MultiBodyTree::MultiBodyImpl::MultiBodyImpl(int num_bodies_, int num_dofs_)
 	  ,
 	  m_m3x(3, m_num_dofs)
 #endif
+	  ,
+	  m_vecx_scratch(num_dofs_),
+	  m_matxx_scratch(num_dofs_, num_dofs_)
 {
 #if (defined BT_ID_HAVE_MAT3X) && (defined BT_ID_WITH_JACOBIANS)
 	resize(m_m3x, m_num_dofs);
@@ -999,6 +1002,447 @@ int MultiBodyTree::MultiBodyImpl::calculateMassMatrix(const vecx &q, const bool
 	return 0;
 }
 
+static inline vec3 unitVector(const int axis)
+{
+	vec3 e;
+	setZero(e);
+	e(axis) = 1.0;
+	return e;
+}
+
+static inline void setZeroRelativeKinematicsDerivative(RigidBody &body)
+{
+	setZero(body.m_d_body_T_parent);
+	setZero(body.m_d_parent_pos_parent_body);
+	setZero(body.m_d_body_ang_vel_rel);
+	setZero(body.m_d_parent_vel_rel);
+	setZero(body.m_d_body_ang_acc_rel);
+	setZero(body.m_d_parent_acc_rel);
+}
+
+void MultiBodyTree::MultiBodyImpl::calculateRelativeKinematicsDerivative(RigidBody &body, const vecx &q,
+																		  const vecx &u,
+																		  const vecx &dot_u,
+																		  const int dof,
+																		  const DerivativeType type)
+{
+	setZeroRelativeKinematicsDerivative(body);
+	// All rotations are of the form body_T_parent = A * R(axis, angle) * B, so
+	// d(body_T_parent)/d(angle) = -tilde(A * axis) * body_T_parent = tilde(A * axis)^T * body_T_parent.
+	switch (body.m_joint_type)
+	{
+		case FIXED:
+			break;
+		case REVOLUTE:
+			if (WRT_POSITION == type)
+			{
+				body.m_d_body_T_parent = tildeOperator(body.m_Jac_JR).transpose() * body.m_body_T_parent;
+			}
+			else
+			{
+				body.m_d_body_ang_vel_rel = body.m_Jac_JR;
+			}
+			break;
+		case PRISMATIC:
+			if (WRT_POSITION == type)
+			{
+				body.m_d_parent_pos_parent_body = body.m_parent_Jac_JT;
+			}
+			else
+			{
+				body.m_d_parent_vel_rel = body.m_parent_Jac_JT;
+			}
+			break;
+		case FLOATING:
+		{
+			const int &idx = body.m_q_index;
+			if (WRT_POSITION == type)
+			{
+				if (dof < 3)
+				{
+					// body_T_parent = Z(q2) * Y(q1) * X(q0)
+					vec3 axis = unitVector(dof);
+					if (dof < 2)
+					{
+						if (dof < 1)
+						{
+							axis = transformY(q(idx + 1)) * axis;
+						}
+						axis = transformZ(q(idx + 2)) * axis;
+					}
+					body.m_d_body_T_parent = tildeOperator(axis).transpose() * body.m_body_T_parent;
+
+					vec3 pos, vel, acc;
+					for (int i = 0; i < 3; i++)
+					{
+						pos(i) = q(idx + 3 + i);
+						vel(i) = u(idx + 3 + i);
+						acc(i) = dot_u(idx + 3 + i);
+					}
+					const mat33 d_parent_T_body = body.m_d_body_T_parent.transpose();
+					body.m_d_parent_pos_parent_body = body.m_d_body_T_parent * pos;
+					body.m_d_parent_vel_rel = d_parent_T_body * vel;
+					body.m_d_parent_acc_rel = d_parent_T_body * acc;
+				}
+				else
+				{
+					body.m_d_parent_pos_parent_body = body.m_body_T_parent * unitVector(dof - 3);
+				}
+			}
+			else
+			{
+				if (dof < 3)
+				{
+					body.m_d_body_ang_vel_rel = unitVector(dof);
+				}
+				else
+				{
+					body.m_d_parent_vel_rel = body.m_body_T_parent.transpose() * unitVector(dof - 3);
+				}
+			}
+			break;
+		}
+		case SPHERICAL:
+		{
+			//todo: review (see calculateKinematics)
+			const int &idx = body.m_q_index;
+			if (WRT_POSITION == type)
+			{
+				// body_T_parent = X(q0) * Y(q1) * Z(q2) * body_T_parent_ref
+				vec3 axis = unitVector(dof);
+				if (dof > 0)
+				{
+					if (dof > 1)
+					{
+						axis = transformY(q(idx + 1)) * axis;
+					}
+					axis = transformX(q(idx)) * axis;
+				}
+				body.m_d_body_T_parent = tildeOperator(axis).transpose() * body.m_body_T_parent;
+			}
+			else
+			{
+				body.m_d_body_ang_vel_rel = unitVector(dof);
+			}
+			break;
+		}
+	}
+}
+
+void MultiBodyTree::MultiBodyImpl::calculateJointForcesDerivativeColumn(const int body_index,
+																		 const int col,
+																		 matxx *d_joint_forces)
+{
+	// 1. derivatives of absolute kinematics and body equations of motion.
+	// Parents always have smaller indices than their children,
+	// so bodies before body_index are not affected.
+	for (int i = 0; i < body_index; i++)
+	{
+		RigidBody &body = m_body_list[i];
+		setZero(body.m_d_body_ang_vel);
+		setZero(body.m_d_body_vel);
+		setZero(body.m_d_body_ang_acc);
+		setZero(body.m_d_body_acc);
+		setZero(body.m_d_force_at_joint);
+		setZero(body.m_d_moment_at_joint);
+	}
+
+	for (int i = body_index; i < static_cast<int>(m_body_list.size()); i++)
+	{
+		RigidBody &body = m_body_list[i];
+		if (0 == i)
+		{
+			body.m_d_body_ang_vel = body.m_d_body_ang_vel_rel;
+			body.m_d_body_vel = body.m_d_parent_vel_rel;
+			body.m_d_body_ang_acc = body.m_d_body_ang_acc_rel;
+			body.m_d_body_acc = body.m_d_body_T_parent * (body.m_parent_acc_rel - m_world_gravity) +
+								body.m_body_T_parent * body.m_d_parent_acc_rel;
+		}
+		else
+		{
+			const RigidBody &parent = m_body_list[m_parent_index[i]];
+			const mat33 &T = body.m_body_T_parent;
+			const mat33 &dT = body.m_d_body_T_parent;
+			const vec3 &r = body.m_parent_pos_parent_body;
+			const vec3 &dr = body.m_d_parent_pos_parent_body;
+
+			const vec3 parent_ang_vel = T * parent.m_body_ang_vel;
+			const vec3 d_parent_ang_vel = dT * parent.m_body_ang_vel + T * parent.m_d_body_ang_vel;
+			body.m_d_body_ang_vel = d_parent_ang_vel + body.m_d_body_ang_vel_rel;
+
+			const vec3 ang_vel_x_r = parent.m_body_ang_vel.cross(r);
+			const vec3 d_ang_vel_x_r = parent.m_d_body_ang_vel.cross(r) + parent.m_body_ang_vel.cross(dr);
+			body.m_d_body_vel =
+				dT * (parent.m_body_vel + ang_vel_x_r + body.m_parent_vel_rel) +
+				T * (parent.m_d_body_vel + d_ang_vel_x_r + body.m_d_parent_vel_rel);
+
+			body.m_d_body_ang_acc =
+				dT * parent.m_body_ang_acc + T * parent.m_d_body_ang_acc -
+				body.m_d_body_ang_vel_rel.cross(parent_ang_vel) -
+				body.m_body_ang_vel_rel.cross(d_parent_ang_vel) + body.m_d_body_ang_acc_rel;
+
+			body.m_d_body_acc =
+				dT * (parent.m_body_acc + parent.m_body_ang_acc.cross(r) +
+					  parent.m_body_ang_vel.cross(ang_vel_x_r) +
+					  2.0 * parent.m_body_ang_vel.cross(body.m_parent_vel_rel) + body.m_parent_acc_rel) +
+				T * (parent.m_d_body_acc + parent.m_d_body_ang_acc.cross(r) +
+					 parent.m_body_ang_acc.cross(dr) + parent.m_d_body_ang_vel.cross(ang_vel_x_r) +
+					 parent.m_body_ang_vel.cross(d_ang_vel_x_r) +
+					 2.0 * parent.m_d_body_ang_vel.cross(body.m_parent_vel_rel) +
+					 2.0 * parent.m_body_ang_vel.cross(body.m_d_parent_vel_rel) + body.m_d_parent_acc_rel);
+		}
+		// derivative of the body equations of motion (user forces are constant)
+		const vec3 I_ang_vel = body.m_body_I_body * body.m_body_ang_vel;
+		const vec3 d_I_ang_vel = body.m_body_I_body * body.m_d_body_ang_vel;
+		body.m_d_moment_at_joint =
+			body.m_body_I_body * body.m_d_body_ang_acc + body.m_body_mass_com.cross(body.m_d_body_acc) +
+			body.m_d_body_ang_vel.cross(I_ang_vel) + body.m_body_ang_vel.cross(d_I_ang_vel);
+		body.m_d_force_at_joint =
+			body.m_d_body_ang_acc.cross(body.m_body_mass_com) + body.m_mass * body.m_d_body_acc +
+			body.m_d_body_ang_vel.cross(body.m_body_ang_vel.cross(body.m_body_mass_com)) +
+			body.m_body_ang_vel.cross(body.m_d_body_ang_vel.cross(body.m_body_mass_com));
+	}
+
+	// 2. derivatives of forces and moments at the joints
+	for (int i = m_body_list.size() - 1; i >= 0; i--)
+	{
+		RigidBody &body = m_body_list[i];
+		for (idArrayIdx c = 0; c < m_child_indices[i].size(); c++)
+		{
+			const RigidBody &child = m_body_list[m_child_indices[i][c]];
+			const mat33 this_T_child = child.m_body_T_parent.transpose();
+			const mat33 d_this_T_child = child.m_d_body_T_parent.transpose();
+			const vec3 child_force = this_T_child * child.m_force_at_joint;
+			const vec3 d_child_force =
+				d_this_T_child * child.m_force_at_joint + this_T_child * child.m_d_force_at_joint;
+			body.m_d_force_at_joint += d_child_force;
+			body.m_d_moment_at_joint += d_this_T_child * child.m_moment_at_joint +
+										this_T_child * child.m_d_moment_at_joint +
+										child.m_d_parent_pos_parent_body.cross(child_force) +
+										child.m_parent_pos_parent_body.cross(d_child_force);
+		}
+	}
+
+	// 3. derivatives of the joint forces (see calculateInverseDynamics)
+	for (idArrayIdx i = 0; i < m_body_list.size(); i++)
+	{
+		const RigidBody &body = m_body_list[i];
+		switch (body.m_joint_type)
+		{
+			case FIXED:
+				break;
+			case REVOLUTE:
+				setMatxxElem(body.m_q_index, col, body.m_Jac_JR.dot(body.m_d_moment_at_joint),
+							 d_joint_forces);
+				break;
+			case PRISMATIC:
+				setMatxxElem(body.m_q_index, col, body.m_Jac_JT.dot(body.m_d_force_at_joint),
+							 d_joint_forces);
+				break;
+			case FLOATING:
+				for (int k = 0; k < 3; k++)
+				{
+					setMatxxElem(body.m_q_index + k, col, body.m_d_moment_at_joint(k), d_joint_forces);
+					setMatxxElem(body.m_q_index + 3 + k, col, body.m_d_force_at_joint(k), d_joint_forces);
+				}
+				break;
+			case SPHERICAL:
+				for (int k = 0; k < 3; k++)
+				{
+					setMatxxElem(body.m_q_index + k, col, body.m_d_moment_at_joint(k), d_joint_forces);
+				}
+				break;
+		}
+	}
+}
+
+int MultiBodyTree::MultiBodyImpl::calculateInverseDynamicsDerivatives(
+	const vecx &q, const vecx &u, const vecx &dot_u, vecx *joint_forces, matxx *d_joint_forces_dq,
+	matxx *d_joint_forces_du)
+{
+	// The derivatives are computed by differentiating the recursive Newton-Euler algorithm
+	// in calculateInverseDynamics in forward mode, one generalized coordinate / velocity
+	// at a time. Every directional derivative requires one forward and one backward
+	// sweep over the tree, so the cost is O(num_dofs * num_bodies), rather than
+	// 2*num_dofs+1 full inverse dynamics evaluations for finite differences.
+	if (d_joint_forces_dq->rows() != m_num_dofs || d_joint_forces_dq->cols() != m_num_dofs ||
+		d_joint_forces_du->rows() != m_num_dofs || d_joint_forces_du->cols() != m_num_dofs)
+	{
+		bt_id_error_message(
+			"Dimension error. System has %d DOFs,\n"
+			"but dim(d_joint_forces_dq)= %d x %d, dim(d_joint_forces_du)= %d x %d\n",
+			m_num_dofs, static_cast<int>(d_joint_forces_dq->rows()),
+			static_cast<int>(d_joint_forces_dq->cols()), static_cast<int>(d_joint_forces_du->rows()),
+			static_cast<int>(d_joint_forces_du->cols()));
+		return -1;
+	}
+	if (-1 == calculateInverseDynamics(q, u, dot_u, joint_forces))
+	{
+		bt_id_error_message("error in inverse dynamics calculation\n");
+		return -1;
+	}
+
+	for (idArrayIdx i = 0; i < m_body_list.size(); i++)
+	{
+		setZeroRelativeKinematicsDerivative(m_body_list[i]);
+	}
+
+	for (idArrayIdx i = 0; i < m_body_list.size(); i++)
+	{
+		RigidBody &body = m_body_list[i];
+		const int num_body_dofs = bodyNumDoFs(body.m_joint_type);
+		for (int dof = 0; dof < num_body_dofs; dof++)
+		{
+			calculateRelativeKinematicsDerivative(body, q, u, dot_u, dof, WRT_POSITION);
+			calculateJointForcesDerivativeColumn(i, body.m_q_index + dof, d_joint_forces_dq);
+			calculateRelativeKinematicsDerivative(body, q, u, dot_u, dof, WRT_VELOCITY);
+			calculateJointForcesDerivativeColumn(i, body.m_q_index + dof, d_joint_forces_du);
+		}
+		setZeroRelativeKinematicsDerivative(body);
+	}
+	return 0;
+}
+
+// In-place Cholesky decomposition of a symmetric positive definite matrix.
+// The lower triangular factor L, with m = L*L^T, replaces the lower triangle of m.
+// Returns -1 if the matrix is not positive definite.
+static int choleskyDecomposition(matxx *m)
+{
+	const int n = m->rows();
+	for (int j = 0; j < n; j++)
+	{
+		idScalar diag = (*m)(j, j);
+		for (int k = 0; k < j; k++)
+		{
+			diag -= (*m)(j, k) * (*m)(j, k);
+		}
+		if (diag <= 0)
+		{
+			return -1;
+		}
+		diag = BT_ID_SQRT(diag);
+		setMatxxElem(j, j, diag, m);
+		for (int i = j + 1; i < n; i++)
+		{
+			idScalar sum = (*m)(i, j);
+			for (int k = 0; k < j; k++)
+			{
+				sum -= (*m)(i, k) * (*m)(j, k);
+			}
+			setMatxxElem(i, j, sum / diag, m);
+		}
+	}
+	return 0;
+}
+
+// Solve L*L^T*x = b in place, where L is the result of choleskyDecomposition
+static void choleskySolve(const matxx &L, vecx *x)
+{
+	const int n = L.rows();
+	for (int i = 0; i < n; i++)
+	{
+		idScalar sum = (*x)(i);
+		for (int k = 0; k < i; k++)
+		{
+			sum -= L(i, k) * (*x)(k);
+		}
+		(*x)(i) = sum / L(i, i);
+	}
+	for (int i = n - 1; i >= 0; i--)
+	{
+		idScalar sum = (*x)(i);
+		for (int k = i + 1; k < n; k++)
+		{
+			sum -= L(k, i) * (*x)(k);
+		}
+		(*x)(i) = sum / L(i, i);
+	}
+}
+
+int MultiBodyTree::MultiBodyImpl::calculateForwardDynamicsDerivatives(
+	const vecx &q, const vecx &u, const vecx &joint_forces, vecx *dot_u, matxx *d_dot_u_dq,
+	matxx *d_dot_u_du, matxx *d_dot_u_d_joint_forces)
+{
+	// With the mass matrix M(q) and joint_forces= M(q)*dot_u + c(q,u) from inverse dynamics,
+	// d(dot_u)/dx = -M^-1 * d(joint_forces)/dx for x = q, u (at constant dot_u), and
+	// d(dot_u)/d(joint_forces) = M^-1.
+	if (joint_forces.size() != m_num_dofs || dot_u->size() != m_num_dofs ||
+		d_dot_u_d_joint_forces->rows() != m_num_dofs || d_dot_u_d_joint_forces->cols() != m_num_dofs)
+	{
+		bt_id_error_message(
+			"Dimension error. System has %d DOFs,\n"
+			"but dim(joint_forces)= %d, dim(dot_u)= %d, dim(d_dot_u_d_joint_forces)= %d x %d\n",
+			m_num_dofs, static_cast<int>(joint_forces.size()), static_cast<int>(dot_u->size()),
+			static_cast<int>(d_dot_u_d_joint_forces->rows()),
+			static_cast<int>(d_dot_u_d_joint_forces->cols()));
+		return -1;
+	}
+
+	// 1. forward dynamics: dot_u = M^-1 * (joint_forces - c(q,u))
+	setZero(m_vecx_scratch);
+	if (-1 == calculateInverseDynamics(q, u, m_vecx_scratch, dot_u))
+	{
+		bt_id_error_message("error in inverse dynamics calculation\n");
+		return -1;
+	}
+	for (int i = 0; i < m_num_dofs; i++)
+	{
+		(*dot_u)(i) = joint_forces(i) - (*dot_u)(i);
+	}
+	if (-1 == calculateMassMatrix(q, true, true, true, &m_matxx_scratch))
+	{
+		bt_id_error_message("error in mass matrix calculation\n");
+		return -1;
+	}
+	if (-1 == choleskyDecomposition(&m_matxx_scratch))
+	{
+		bt_id_error_message("mass matrix is not positive definite\n");
+		return -1;
+	}
+	choleskySolve(m_matxx_scratch, dot_u);
+
+	// 2. derivatives of inverse dynamics at the forward dynamics solution
+	if (-1 == calculateInverseDynamicsDerivatives(q, u, *dot_u, &m_vecx_scratch, d_dot_u_dq,
+												  d_dot_u_du))
+	{
+		bt_id_error_message("error in inverse dynamics derivatives calculation\n");
+		return -1;
+	}
+
+	// 3. multiply with -M^-1 and compute M^-1, column by column
+	for (int col = 0; col < m_num_dofs; col++)
+	{
+		for (int row = 0; row < m_num_dofs; row++)
+		{
+			m_vecx_scratch(row) = -(*d_dot_u_dq)(row, col);
+		}
+		choleskySolve(m_matxx_scratch, &m_vecx_scratch);
+		for (int row = 0; row < m_num_dofs; row++)
+		{
+			setMatxxElem(row, col, m_vecx_scratch(row), d_dot_u_dq);
+		}
+
+		for (int row = 0; row < m_num_dofs; row++)
+		{
+			m_vecx_scratch(row) = -(*d_dot_u_du)(row, col);
+		}
+		choleskySolve(m_matxx_scratch, &m_vecx_scratch);
+		for (int row = 0; row < m_num_dofs; row++)
+		{
+			setMatxxElem(row, col, m_vecx_scratch(row), d_dot_u_du);
+		}
+
+		setZero(m_vecx_scratch);
+		m_vecx_scratch(col) = 1.0;
+		choleskySolve(m_matxx_scratch, &m_vecx_scratch);
+		for (int row = 0; row < m_num_dofs; row++)
+		{
+			setMatxxElem(row, col, m_vecx_scratch(row), d_dot_u_d_joint_forces);
+		}
+	}
+	return 0;
+}
+
 // utility macro
 #define CHECK_IF_BODY_INDEX_IS_VALID(index)                                                  \
 	do                                                                                       \
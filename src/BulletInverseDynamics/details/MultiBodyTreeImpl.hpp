@@ -112,6 +112,34 @@ struct RigidBody
 	/// moment of inertia of subtree rooted in this body, w.r.t. body origin, in body-fixed frame
 	mat33 m_body_subtree_I_body;
 
+	// 7 Scratch data for derivative computation.
+	// These are the partial derivatives of the kinematic and dynamic terms above
+	// w.r.t. a single element of q or u (see calculateInverseDynamicsDerivatives)
+	/// derivative of m_body_T_parent
+	mat33 m_d_body_T_parent;
+	/// derivative of m_parent_pos_parent_body
+	vec3 m_d_parent_pos_parent_body;
+	/// derivative of m_body_ang_vel_rel
+	vec3 m_d_body_ang_vel_rel;
+	/// derivative of m_parent_vel_rel
+	vec3 m_d_parent_vel_rel;
+	/// derivative of m_body_ang_acc_rel
+	vec3 m_d_body_ang_acc_rel;
+	/// derivative of m_parent_acc_rel
+	vec3 m_d_parent_acc_rel;
+	/// derivative of m_body_ang_vel
+	vec3 m_d_body_ang_vel;
+	/// derivative of m_body_vel
+	vec3 m_d_body_vel;
+	/// derivative of m_body_ang_acc
+	vec3 m_d_body_ang_acc;
+	/// derivative of m_body_acc
+	vec3 m_d_body_acc;
+	/// derivative of m_force_at_joint
+	vec3 m_d_force_at_joint;
+	/// derivative of m_moment_at_joint
+	vec3 m_d_moment_at_joint;
+
 #if (defined BT_ID_HAVE_MAT3X) && (defined BT_ID_WITH_JACOBIANS)
 	/// translational jacobian in body-fixed frame d(m_body_vel)/du
 	mat3x m_body_Jac_T;
@@ -141,6 +169,13 @@ public:
 		POSITION_VELOCITY_ACCELERATION
 	};
 
+	/// selects the argument of partial derivatives
+	enum DerivativeType
+	{
+		WRT_POSITION,
+		WRT_VELOCITY
+	};
+
 	/// constructor
 	/// @param num_bodies the number of bodies in the system
 	/// @param num_dofs number of degrees of freedom in the system
@@ -153,6 +188,14 @@ public:
 	int calculateMassMatrix(const vecx& q, const bool update_kinematics,
 							const bool initialize_matrix, const bool set_lower_triangular_matrix,
 							matxx* mass_matrix);
+	/// \copydoc MultiBodyTree::calculateInverseDynamicsDerivatives
+	int calculateInverseDynamicsDerivatives(const vecx& q, const vecx& u, const vecx& dot_u,
+											vecx* joint_forces, matxx* d_joint_forces_dq,
+											matxx* d_joint_forces_du);
+	/// \copydoc MultiBodyTree::calculateForwardDynamicsDerivatives
+	int calculateForwardDynamicsDerivatives(const vecx& q, const vecx& u, const vecx& joint_forces,
+											vecx* dot_u, matxx* d_dot_u_dq, matxx* d_dot_u_du,
+											matxx* d_dot_u_d_joint_forces);
 	/// calculate kinematics (vector quantities)
 	/// Depending on type, update positions only, positions & velocities, or positions, velocities
 	/// and accelerations.
@@ -247,6 +290,15 @@ public:
 private:
 	// debug function. print tree structure to stdout
 	void printTree(int index, int indentation);
+	// set derivative of relative kinematics of body w.r.t. its local degree of freedom dof.
+	// Requires up-to-date kinematics for (q, u, dot_u).
+	void calculateRelativeKinematicsDerivative(RigidBody& body, const vecx& q, const vecx& u,
+											   const vecx& dot_u, const int dof,
+											   const DerivativeType type);
+	// propagate derivatives of relative kinematics set for body_index through the tree,
+	// and store the resulting derivative of the joint forces in column col of d_joint_forces
+	void calculateJointForcesDerivativeColumn(const int body_index, const int col,
+											  matxx* d_joint_forces);
 	// get string representation of JointType (for debugging)
 	const char* jointTypeToString(const JointType& type) const;
 	// get number of degrees of freedom from joint type
@@ -283,6 +335,9 @@ private:
 #if (defined BT_ID_HAVE_MAT3X) && (defined BT_ID_WITH_JACOBIANS)
 	mat3x m_m3x;
 #endif
+	// scratch data for forward dynamics derivatives
+	vecx m_vecx_scratch;
+	matxx m_matxx_scratch;
 };
 }  // namespace btInverseDynamics
 #endif
@@ -4,6 +4,7 @@
 #include "BulletCollision/BroadphaseCollision/btBroadphaseProxy.cpp"
 #include "BulletCollision/BroadphaseCollision/btDbvtBroadphase.cpp"
 #include "BulletCollision/BroadphaseCollision/btQuantizedBvh.cpp"
+#include "BulletCollision/BroadphaseCollision/btQuantizedWideBvh.cpp"
 #include "BulletCollision/BroadphaseCollision/btCollisionAlgorithm.cpp"
 #include "BulletCollision/BroadphaseCollision/btDispatcher.cpp"
 #include "BulletCollision/BroadphaseCollision/btSimpleBroadphase.cpp"
@@ -21,6 +22,8 @@
 #include "BulletCollision/CollisionDispatch/btSimulationIslandManager.cpp"
 #include "BulletCollision/CollisionDispatch/btBoxBoxDetector.cpp"
 #include "BulletCollision/CollisionDispatch/btConvexConvexAlgorithm.cpp"
+#include "BulletCollision/CollisionDispatch/btConvexConvexMprAlgorithm.cpp"
+#include "BulletCollision/CollisionDispatch/btConvexConvexSpecializedAlgorithm.cpp"
 #include "BulletCollision/CollisionDispatch/btSphereBoxCollisionAlgorithm.cpp"
 #include "BulletCollision/CollisionDispatch/btCollisionDispatcher.cpp"
 #include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.cpp"
@@ -34,6 +37,7 @@
 #include "BulletCollision/CollisionDispatch/btUnionFind.cpp"
 #include "BulletCollision/CollisionDispatch/btCollisionWorldImporter.cpp"
 #include "BulletCollision/CollisionDispatch/btGhostObject.cpp"
+#include "BulletCollision/CollisionDispatch/btHeightfieldPrimitiveCollisionAlgorithm.cpp"
 #include "BulletCollision/NarrowPhaseCollision/btContinuousConvexCollision.cpp"
 #include "BulletCollision/NarrowPhaseCollision/btGjkEpaPenetrationDepthSolver.cpp"
 #include "BulletCollision/NarrowPhaseCollision/btPolyhedralContactClipping.cpp"
@@ -63,6 +67,7 @@
 #include "BulletCollision/CollisionShapes/btTetrahedronShape.cpp"
 #include "BulletCollision/CollisionShapes/btCompoundShape.cpp"
 #include "BulletCollision/CollisionShapes/btHeightfieldTerrainShape.cpp"
+#include "BulletCollision/CollisionShapes/btTiledHeightfieldTerrainShape.cpp"
 #include "BulletCollision/CollisionShapes/btTriangleBuffer.cpp"
 #include "BulletCollision/CollisionShapes/btConcaveShape.cpp"
 #include "BulletCollision/CollisionShapes/btMinkowskiSumShape.cpp"
@@ -34,10 +34,14 @@
 #include "BulletDynamics/Featherstone/btMultiBodyConstraintSolver.cpp"
 #include "BulletDynamics/Featherstone/btMultiBodyMLCPConstraintSolver.cpp"
 #include "BulletDynamics/Featherstone/btMultiBodyJointLimitConstraint.cpp"
+#include "BulletDynamics/Featherstone/btMultiBodyLoopClosureSolver.cpp"
+#include "BulletDynamics/Featherstone/btMultiBodyWorldSnapshot.cpp"
 #include "BulletDynamics/Featherstone/btMultiBodySliderConstraint.cpp"
 #include "BulletDynamics/Featherstone/btMultiBodySphericalJointMotor.cpp"
 #include "BulletDynamics/Featherstone/btMultiBodySphericalJointLimit.cpp"
 #include "BulletDynamics/Vehicle/btRaycastVehicle.cpp"
+#include "BulletDynamics/Vehicle/btRaycastVehicleFleet.cpp"
 #include "BulletDynamics/Vehicle/btWheelInfo.cpp"
+#include "BulletDynamics/Character/btCharacterControllerCrowd.cpp"
 #include "BulletDynamics/Character/btKinematicCharacterController.cpp"
 
@@ -39,6 +39,13 @@
 #include "Test_3x3getRot.h"
 
 #include "Test_btDbvt.h"
+#include "Test_btQuantizedBvh.h"
+#include "Test_btConvexConvexMpr.h"
+#include "Test_btConvexHullSupport.h"
+#include "Test_btPolyhedralContactClipping.h"
+#include "Test_btSeparatingAxisCache.h"
+#include "Test_btHeightfieldRaycast.h"
+#include "Test_btCharacterCrowd.h"
 #include "Test_quat_aos_neon.h"
 
 #include "LinearMath/btScalar.h"
@@ -89,10 +96,27 @@ TestDesc gTestList[] =
 		ENTRY("3x3getRot", Test_3x3getRot),
 
 		ENTRY("btDbvt", Test_btDbvt),
+		ENTRY("btQuantizedBvh", Test_btQuantizedBvh),
+		ENTRY("btConvexConvexMpr", Test_btConvexConvexMpr),
+		ENTRY("btConvexHullSupport", Test_btConvexHullSupport),
+		ENTRY("btPolyhedralContactClipping", Test_btPolyhedralContactClipping),
+		ENTRY("btSeparatingAxisCache", Test_btSeparatingAxisCache),
+		ENTRY("btHeightfieldRaycast", Test_btHeightfieldRaycast),
+		ENTRY("btCharacterCrowd", Test_btCharacterCrowd),
 		ENTRY("quat_aos_neon", Test_quat_aos_neon),
 
 		{NULL, NULL}};
 #else
-TestDesc gTestList[] = {{NULL, NULL}};
+TestDesc gTestList[] =
+	{
+		ENTRY("btQuantizedBvh", Test_btQuantizedBvh),
+		ENTRY("btConvexConvexMpr", Test_btConvexConvexMpr),
+		ENTRY("btConvexHullSupport", Test_btConvexHullSupport),
+		ENTRY("btPolyhedralContactClipping", Test_btPolyhedralContactClipping),
+		ENTRY("btSeparatingAxisCache", Test_btSeparatingAxisCache),
+		ENTRY("btHeightfieldRaycast", Test_btHeightfieldRaycast),
+		ENTRY("btCharacterCrowd", Test_btCharacterCrowd),
+
+		{NULL, NULL}};
 
 #endif
@@ -0,0 +1,186 @@
+//
+//  Test_btCharacterCrowd.cpp
+//  BulletTest
+//
+//  Hundreds of kinematic characters walking around a floor with obstacles, updated as separate actions
+//  and as a btCharacterControllerCrowd with the sequential and the default task scheduler
+//
+
+#include "Test_btCharacterCrowd.h"
+#include "vector.h"
+#include "Utils.h"
+#include "main.h"
+#include <math.h>
+#include <string.h>
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/CollisionDispatch/btGhostObject.h>
+#include <BulletDynamics/Character/btKinematicCharacterController.h>
+#include <BulletDynamics/Character/btCharacterControllerCrowd.h>
+#include <LinearMath/btThreads.h>
+
+#define NUM_CHARACTERS 500
+#define NUM_OBSTACLES 100
+#define NUM_STEPS 100
+
+enum CharacterUpdate
+{
+	UPDATE_ACTIONS,
+	UPDATE_CROWD,
+};
+
+static uint64_t TimeCharacters(CharacterUpdate update, const btVector3* starts, const btVector3* goals, const btVector3* obstacles,
+							   btAlignedObjectArray<btVector3>& positions)
+{
+	btDefaultCollisionConfiguration config;
+	btCollisionDispatcher dispatcher(&config);
+	btDbvtBroadphase broadphase;
+	btGhostPairCallback ghostPairCallback;
+	broadphase.getOverlappingPairCache()->setInternalGhostPairCallback(&ghostPairCallback);
+	btSequentialImpulseConstraintSolver solver;
+	btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &config);
+
+	btBoxShape groundShape(btVector3(100, 1, 100));
+	btRigidBody ground(0, 0, &groundShape);
+	ground.getWorldTransform().setOrigin(btVector3(0, -1, 0));
+	world.addRigidBody(&ground);
+
+	btBoxShape obstacleShape(btVector3(1, 0.25, 1));
+	btAlignedObjectArray<btRigidBody*> obstacleBodies;
+	for (int i = 0; i < NUM_OBSTACLES; i++)
+	{
+		btRigidBody* body = new btRigidBody(0, 0, &obstacleShape);
+		body->getWorldTransform().setOrigin(obstacles[i]);
+		world.addRigidBody(body);
+		obstacleBodies.push_back(body);
+	}
+
+	btCapsuleShape characterShape(0.3, 1);
+	btCharacterControllerCrowd crowd;
+	btAlignedObjectArray<btPairCachingGhostObject*> ghostObjects;
+	btAlignedObjectArray<btKinematicCharacterController*> controllers;
+	for (int i = 0; i < NUM_CHARACTERS; i++)
+	{
+		btPairCachingGhostObject* ghostObject = new btPairCachingGhostObject();
+		ghostObject->getWorldTransform().setIdentity();
+		ghostObject->getWorldTransform().setOrigin(starts[i]);
+		ghostObject->setCollisionShape(&characterShape);
+		ghostObject->setCollisionFlags(btCollisionObject::CF_CHARACTER_OBJECT);
+		world.addCollisionObject(ghostObject, btBroadphaseProxy::CharacterFilter, btBroadphaseProxy::AllFilter);
+		ghostObjects.push_back(ghostObject);
+
+		btKinematicCharacterController* controller = new btKinematicCharacterController(ghostObject, &characterShape, btScalar(0.35), btVector3(0, 1, 0));
+		controllers.push_back(controller);
+		if (update == UPDATE_CROWD)
+		{
+			crowd.addController(controller);
+		}
+		else
+		{
+			world.addAction(controller);
+		}
+	}
+	if (update == UPDATE_CROWD)
+	{
+		world.addAction(&crowd);
+	}
+
+	uint64_t time = 0;
+	for (int s = 0; s < NUM_STEPS; s++)
+	{
+		for (int i = 0; i < NUM_CHARACTERS; i++)
+		{
+			btVector3 walkDirection = goals[i] - ghostObjects[i]->getWorldTransform().getOrigin();
+			walkDirection.setY(0);
+			if (walkDirection.length2() > btScalar(0.01))
+			{
+				walkDirection.normalize();
+			}
+			controllers[i]->setWalkDirection(walkDirection * btScalar(0.05));
+		}
+		const uint64_t startTime = ReadTicks();
+		world.stepSimulation(btScalar(1. / 60.), 0);
+		time += ReadTicks() - startTime;
+	}
+
+	if (update == UPDATE_CROWD)
+	{
+		world.removeAction(&crowd);
+	}
+	for (int i = 0; i < NUM_CHARACTERS; i++)
+	{
+		positions.push_back(ghostObjects[i]->getWorldTransform().getOrigin());
+		if (update != UPDATE_CROWD)
+		{
+			world.removeAction(controllers[i]);
+		}
+		delete controllers[i];
+		world.removeCollisionObject(ghostObjects[i]);
+		delete ghostObjects[i];
+	}
+	for (int i = 0; i < NUM_OBSTACLES; i++)
+	{
+		world.removeRigidBody(obstacleBodies[i]);
+		delete obstacleBodies[i];
+	}
+	world.removeRigidBody(&ground);
+	return time;
+}
+
+int Test_btCharacterCrowd(void)
+{
+	//characters crossing the floor to random goals, over low obstacles they can step on
+	btVector3* starts = new btVector3[NUM_CHARACTERS];
+	btVector3* goals = new btVector3[NUM_CHARACTERS];
+	for (int i = 0; i < NUM_CHARACTERS; i++)
+	{
+		starts[i].setValue(-40 + 80 * RANDF_01, 1, -40 + 80 * RANDF_01);
+		goals[i].setValue(-40 + 80 * RANDF_01, 1, -40 + 80 * RANDF_01);
+	}
+	btVector3* obstacles = new btVector3[NUM_OBSTACLES];
+	for (int i = 0; i < NUM_OBSTACLES; i++)
+	{
+		obstacles[i].setValue(-40 + 80 * RANDF_01, 0.25, -40 + 80 * RANDF_01);
+	}
+
+	btITaskScheduler* previousScheduler = btGetTaskScheduler();
+
+	btAlignedObjectArray<btVector3> actionPositions;
+	const uint64_t actionTime = TimeCharacters(UPDATE_ACTIONS, starts, goals, obstacles, actionPositions);
+
+	btSetTaskScheduler(btGetSequentialTaskScheduler());
+	btAlignedObjectArray<btVector3> sequentialPositions;
+	const uint64_t sequentialTime = TimeCharacters(UPDATE_CROWD, starts, goals, obstacles, sequentialPositions);
+
+	btITaskScheduler* scheduler = btCreateDefaultTaskScheduler();
+	int numThreads = 1;
+	if (scheduler)
+	{
+		btSetTaskScheduler(scheduler);
+		numThreads = scheduler->getNumThreads();
+	}
+	btAlignedObjectArray<btVector3> parallelPositions;
+	const uint64_t parallelTime = TimeCharacters(UPDATE_CROWD, starts, goals, obstacles, parallelPositions);
+
+	btSetTaskScheduler(previousScheduler);
+	delete scheduler;
+	delete[] obstacles;
+	delete[] goals;
+	delete[] starts;
+
+	vlog("btCharacterControllerCrowd Timing (%d characters, %d steps), seconds:\n", NUM_CHARACTERS, NUM_STEPS);
+	vlog("actions\t%10.4f\n", TicksToSeconds(actionTime));
+	vlog("crowd  \t%10.4f\n", TicksToSeconds(sequentialTime));
+	vlog("crowd  \t%10.4f\t(%d threads)\n", TicksToSeconds(parallelTime), numThreads);
+
+	//the crowd does not depend on the number of threads
+	for (int i = 0; i < NUM_CHARACTERS; i++)
+	{
+		if (sequentialPositions[i] != parallelPositions[i])
+		{
+			vlog("btCharacterControllerCrowd mismatch for character %d\n", i);
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,20 @@
+//
+//  Test_btCharacterCrowd.h
+//  BulletTest
+//
+
+#ifndef BulletTest_Test_btCharacterCrowd_h
+#define BulletTest_Test_btCharacterCrowd_h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	int Test_btCharacterCrowd(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
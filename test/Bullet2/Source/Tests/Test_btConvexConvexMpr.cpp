@@ -0,0 +1,159 @@
+//
+//  Test_btConvexConvexMpr.cpp
+//  BulletTest
+//
+//  Narrowphase times of btConvexConvexAlgorithm (GJK pair detector + EPA), of
+//  btConvexConvexMprAlgorithm with MPR and EPA3 penetration, and of the per shape pair
+//  btConvexConvexSpecializedAlgorithm, over the primitive shape pairs
+//
+
+#include "Test_btConvexConvexMpr.h"
+#include "vector.h"
+#include "Utils.h"
+#include "main.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcher.h>
+#include <BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h>
+#include <BulletCollision/CollisionDispatch/btConvexConvexAlgorithm.h>
+#include <BulletCollision/CollisionDispatch/btConvexConvexMprAlgorithm.h>
+#include <BulletCollision/CollisionDispatch/btConvexConvexSpecializedAlgorithm.h>
+#include <BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
+#include <BulletCollision/CollisionDispatch/btManifoldResult.h>
+#include <BulletCollision/CollisionShapes/btBoxShape.h>
+#include <BulletCollision/CollisionShapes/btCapsuleShape.h>
+#include <BulletCollision/CollisionShapes/btConeShape.h>
+#include <BulletCollision/CollisionShapes/btConvexHullShape.h>
+#include <BulletCollision/CollisionShapes/btCylinderShape.h>
+#include <BulletCollision/CollisionShapes/btSphereShape.h>
+#include <BulletCollision/NarrowPhaseCollision/btGjkEpaPenetrationDepthSolver.h>
+
+#define NUM_SHAPES 6
+#define NUM_METHODS 4
+#define NUM_TRANSFORMS 2000
+
+struct NarrowphaseTimes
+{
+	uint64_t m_time;
+	int m_numPenetrations;
+};
+
+//processCollision of each random pose. The manifold is cleared after each call, so every pose starts from scratch
+//but the algorithm keeps its cached separating axis, like a pair that moves between two frames.
+//Without createFunc, the algorithm registered in the dispatcher is used
+static void TimeNarrowphase(btCollisionAlgorithmCreateFunc* createFunc, btCollisionDispatcher* dispatcher,
+							const btConvexShape* shapeA, const btConvexShape* shapeB, const btTransform* transforms, NarrowphaseTimes& times)
+{
+	btCollisionObject objA;
+	btCollisionObject objB;
+	objA.setCollisionShape((btCollisionShape*)shapeA);
+	objB.setCollisionShape((btCollisionShape*)shapeB);
+	btTransform identity = btTransform::getIdentity();
+	btCollisionObjectWrapper wrapA(0, shapeA, &objA, transforms[0], -1, -1);
+	btCollisionObjectWrapper wrapB(0, shapeB, &objB, identity, -1, -1);
+
+	btCollisionAlgorithmConstructionInfo ci(dispatcher, 0);
+	btCollisionAlgorithm* algorithm = createFunc ? createFunc->CreateCollisionAlgorithm(ci, &wrapA, &wrapB) : dispatcher->findAlgorithm(&wrapA, &wrapB, 0, BT_CONTACT_POINT_ALGORITHMS);
+	btDispatcherInfo dispatchInfo;
+
+	times.m_numPenetrations = 0;
+	uint64_t startTime = ReadTicks();
+	for (int i = 0; i < NUM_TRANSFORMS; i++)
+	{
+		objA.setWorldTransform(transforms[i]);
+		btCollisionObjectWrapper poseA(0, shapeA, &objA, transforms[i], -1, -1);
+		btManifoldResult result(&poseA, &wrapB);
+		algorithm->processCollision(&poseA, &wrapB, dispatchInfo, &result);
+
+		btPersistentManifold* manifold = result.getPersistentManifold();
+		for (int j = 0; j < manifold->getNumContacts(); j++)
+		{
+			if (manifold->getContactPoint(j).getDistance() < 0)
+			{
+				times.m_numPenetrations++;
+				break;
+			}
+		}
+		manifold->clearManifold();
+	}
+	times.m_time = ReadTicks() - startTime;
+
+	algorithm->~btCollisionAlgorithm();
+	dispatcher->freeCollisionAlgorithm(algorithm);
+}
+
+int Test_btConvexConvexMpr(void)
+{
+	btSphereShape sphere(0.5);
+	btBoxShape box(btVector3(0.5, 0.4, 0.3));
+	btCapsuleShape capsule(0.3, 0.6);
+	btCylinderShape cylinder(btVector3(0.4, 0.5, 0.4));
+	btConeShape cone(0.5, 1.0);
+	btConvexHullShape hull;
+	for (int i = 0; i < 64; i++)
+	{
+		btVector3 point(RANDF_m1p1, RANDF_m1p1, RANDF_m1p1);
+		hull.addPoint(point.normalized() * btScalar(0.5), false);
+	}
+	hull.recalcLocalAabb();
+
+	const btConvexShape* shapes[NUM_SHAPES] = {&sphere, &box, &capsule, &cylinder, &cone, &hull};
+	const char* shapeNames[NUM_SHAPES] = {"sphere", "box", "capsule", "cylinder", "cone", "hull"};
+
+	//random orientations, at distances between touching deeply and slightly apart
+	btTransform* transforms = new btTransform[NUM_TRANSFORMS];
+	for (int i = 0; i < NUM_TRANSFORMS; i++)
+	{
+		btVector3 axis(RANDF_m1p1, RANDF_m1p1, RANDF_m1p1);
+		btVector3 direction(RANDF_m1p1, RANDF_m1p1, RANDF_m1p1);
+		btQuaternion orientation(axis.normalized(), RANDF_01 * SIMD_2_PI);
+		transforms[i] = btTransform(orientation, direction.normalized() * (btScalar(0.5) + RANDF_01));
+	}
+
+	btDefaultCollisionConfiguration configuration;
+	btCollisionDispatcher dispatcher(&configuration);
+	btGjkEpaPenetrationDepthSolver pdSolver;
+	btConvexConvexAlgorithm::CreateFunc gjkPairDetector(&pdSolver);
+	btConvexConvexMprAlgorithm::CreateFunc mpr(btConvexConvexMprAlgorithm::MPR_PENETRATION);
+	btConvexConvexMprAlgorithm::CreateFunc epa3(btConvexConvexMprAlgorithm::EPA_PENETRATION);
+	btCollisionAlgorithmCreateFunc* createFuncs[NUM_METHODS] = {&gjkPairDetector, &mpr, &epa3, 0};
+	btCollisionDispatcher specializedDispatcher(&configuration);
+	btConvexConvexSpecializedAlgorithmBase::registerAlgorithms(&specializedDispatcher);
+	btCollisionDispatcher* dispatchers[NUM_METHODS] = {&dispatcher, &dispatcher, &dispatcher, &specializedDispatcher};
+
+	int result = 0;
+	uint64_t totalTimes[NUM_METHODS] = {0, 0, 0, 0};
+	vlog("convex-convex narrowphase Timing (%d poses per pair), seconds:\n", NUM_TRANSFORMS);
+	vlog("                 \t  GJK pair\t       MPR\t      EPA3\t     typed\n");
+	for (int i = 0; i < NUM_SHAPES; i++)
+	{
+		for (int j = i; j < NUM_SHAPES; j++)
+		{
+			NarrowphaseTimes times[NUM_METHODS];
+			for (int k = 0; k < NUM_METHODS; k++)
+			{
+				TimeNarrowphase(createFuncs[k], dispatchers[k], shapes[i], shapes[j], transforms, times[k]);
+				totalTimes[k] += times[k].m_time;
+			}
+			vlog("%8s-%-8s\t%10.4f\t%10.4f\t%10.4f\t%10.4f\n", shapeNames[i], shapeNames[j], TicksToSeconds(times[0].m_time),
+				 TicksToSeconds(times[1].m_time), TicksToSeconds(times[2].m_time), TicksToSeconds(times[3].m_time));
+
+			//the methods agree on which poses penetrate, up to the poses that are just touching
+			for (int k = 1; k < NUM_METHODS; k++)
+			{
+				if (abs(times[k].m_numPenetrations - times[0].m_numPenetrations) > NUM_TRANSFORMS / 50)
+				{
+					vlog("%s-%s penetration mismatch: %d/%d\n", shapeNames[i], shapeNames[j], times[0].m_numPenetrations, times[k].m_numPenetrations);
+					result = 1;
+				}
+			}
+		}
+	}
+	vlog("total            \t%10.4f\t%10.4f\t%10.4f\t%10.4f\n", TicksToSeconds(totalTimes[0]), TicksToSeconds(totalTimes[1]),
+		 TicksToSeconds(totalTimes[2]), TicksToSeconds(totalTimes[3]));
+
+	delete[] transforms;
+	return result;
+}
@@ -0,0 +1,20 @@
+//
+//  Test_btConvexConvexMpr.h
+//  BulletTest
+//
+
+#ifndef BulletTest_Test_btConvexConvexMpr_h
+#define BulletTest_Test_btConvexConvexMpr_h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	int Test_btConvexConvexMpr(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,89 @@
+//
+//  Test_btConvexHullSupport.cpp
+//  BulletTest
+//
+//  Support mapping times of btConvexHullShape, linear maxDot scan against hill climbing
+//  over the vertex adjacency, cold and warm started, for growing hull sizes
+//
+
+#include "Test_btConvexHullSupport.h"
+#include "vector.h"
+#include "Utils.h"
+#include "main.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <BulletCollision/CollisionShapes/btConvexHullShape.h>
+
+#define NUM_HULL_SIZES 4
+#define NUM_DIRECTIONS 20000
+
+int Test_btConvexHullSupport(void)
+{
+	const int hullSizes[NUM_HULL_SIZES] = {32, 128, 512, 2048};
+
+	//a slowly rotating direction, like the separating axis of a pair between frames
+	btVector3* directions = new btVector3[NUM_DIRECTIONS];
+	btVector3 direction(1, 0, 0);
+	btQuaternion rotation(btVector3(RANDF_m1p1, RANDF_m1p1, RANDF_m1p1).normalized(), btScalar(0.05));
+	for (int i = 0; i < NUM_DIRECTIONS; i++)
+	{
+		directions[i] = direction;
+		direction = quatRotate(rotation, direction);
+	}
+
+	int result = 0;
+	vlog("btConvexHullShape support mapping Timing (%d directions), seconds:\n", NUM_DIRECTIONS);
+	vlog("points\t      scan\t      cold\t      warm\n");
+	for (int s = 0; s < NUM_HULL_SIZES; s++)
+	{
+		btConvexHullShape hull;
+		for (int i = 0; i < hullSizes[s]; i++)
+		{
+			btVector3 point(RANDF_m1p1, RANDF_m1p1, RANDF_m1p1);
+			hull.addPoint(point.normalized(), false);
+		}
+		hull.recalcLocalAabb();
+		hull.setLocalScaling(btVector3(1, 2, 0.5));
+
+		btScalar scanSum = 0;
+		uint64_t startTime = ReadTicks();
+		for (int i = 0; i < NUM_DIRECTIONS; i++)
+		{
+			scanSum += directions[i].dot(hull.localGetSupportingVertexWithoutMargin(directions[i]));
+		}
+		uint64_t scanTime = ReadTicks() - startTime;
+
+		hull.initializeSupportAdjacency();
+		btScalar coldSum = 0;
+		startTime = ReadTicks();
+		for (int i = 0; i < NUM_DIRECTIONS; i++)
+		{
+			int supportVertex = -1;
+			coldSum += directions[i].dot(hull.localGetSupportVertexHillClimbing(directions[i], supportVertex));
+		}
+		uint64_t coldTime = ReadTicks() - startTime;
+
+		btScalar warmSum = 0;
+		int supportVertex = -1;
+		startTime = ReadTicks();
+		for (int i = 0; i < NUM_DIRECTIONS; i++)
+		{
+			warmSum += directions[i].dot(hull.localGetSupportVertexHillClimbing(directions[i], supportVertex));
+		}
+		uint64_t warmTime = ReadTicks() - startTime;
+
+		vlog("%6d\t%10.4f\t%10.4f\t%10.4f\n", hullSizes[s], TicksToSeconds(scanTime), TicksToSeconds(coldTime), TicksToSeconds(warmTime));
+
+		//the same support vertices, up to ties
+		if (fabs(scanSum - coldSum) > 1e-3 || fabs(scanSum - warmSum) > 1e-3)
+		{
+			vlog("%d points: support mismatch %f/%f/%f\n", hullSizes[s], scanSum, coldSum, warmSum);
+			result = 1;
+		}
+	}
+
+	delete[] directions;
+	return result;
+}
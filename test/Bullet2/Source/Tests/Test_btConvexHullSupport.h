@@ -0,0 +1,20 @@
+//
+//  Test_btConvexHullSupport.h
+//  BulletTest
+//
+
+#ifndef BulletTest_Test_btConvexHullSupport_h
+#define BulletTest_Test_btConvexHullSupport_h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	int Test_btConvexHullSupport(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
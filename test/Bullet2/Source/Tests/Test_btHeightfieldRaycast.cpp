@@ -0,0 +1,207 @@
+//
+//  Test_btHeightfieldRaycast.cpp
+//  BulletTest
+//
+//  Lidar style ray batches and box queries over the landscape of the Benchmarks demo, as a btHeightfieldTerrainShape,
+//  without accelerator and with min/max pyramids of different chunk sizes
+//
+
+#include "Test_btHeightfieldRaycast.h"
+#include "vector.h"
+#include "Utils.h"
+#include "main.h"
+#include <math.h>
+#include <string.h>
+
+#include <BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
+#include <BulletCollision/NarrowPhaseCollision/btRaycastCallback.h>
+#include "../../../../examples/Benchmarks/landscapeData.h"
+
+#define LANDSCAPE_SAMPLES 129
+#define LANDSCAPE_SIZE 500
+#define UPSAMPLING 8
+#define NUM_SCANNERS 8
+#define NUM_CHANNELS 16
+#define NUM_AZIMUTHS 180
+#define RAY_LENGTH 150
+#define NUM_BOX_QUERIES 10000
+
+static const int gLandscapeVtxCount[8] = {
+	Landscape01VtxCount, Landscape02VtxCount, Landscape03VtxCount, Landscape04VtxCount,
+	Landscape05VtxCount, Landscape06VtxCount, Landscape07VtxCount, Landscape08VtxCount};
+
+static const btScalar* gLandscapeVtx[8] = {
+	Landscape01Vtx, Landscape02Vtx, Landscape03Vtx, Landscape04Vtx,
+	Landscape05Vtx, Landscape06Vtx, Landscape07Vtx, Landscape08Vtx};
+
+class ClosestHitCallback : public btTriangleRaycastCallback
+{
+public:
+	ClosestHitCallback(const btVector3& from, const btVector3& to) : btTriangleRaycastCallback(from, to) {}
+
+	virtual btScalar reportHit(const btVector3& hitNormalLocal, btScalar hitFraction, int partId, int triangleIndex)
+	{
+		return hitFraction;
+	}
+};
+
+class CountTrianglesCallback : public btTriangleCallback
+{
+public:
+	int m_numTriangles;
+
+	CountTrianglesCallback() : m_numTriangles(0) {}
+
+	virtual void processTriangle(btVector3* triangle, int partId, int triangleIndex)
+	{
+		m_numTriangles++;
+	}
+};
+
+struct HeightfieldQueryTimes
+{
+	uint64_t m_rayTime;
+	uint64_t m_boxTime;
+	int m_numHits;
+	double m_sumHitFractions;
+	int m_numBoxTriangles;
+};
+
+static void TimeHeightfieldQueries(btHeightfieldTerrainShape* shape, const btVector3* rayFrom, const btVector3* rayTo, int numRays,
+								   const btVector3* boxCenters, HeightfieldQueryTimes& times)
+{
+	times.m_numHits = 0;
+	times.m_sumHitFractions = 0;
+	uint64_t startTime = ReadTicks();
+	for (int i = 0; i < numRays; i++)
+	{
+		ClosestHitCallback callback(rayFrom[i], rayTo[i]);
+		shape->performRaycast(&callback, rayFrom[i], rayTo[i]);
+		if (callback.m_hitFraction < 1)
+		{
+			times.m_numHits++;
+			times.m_sumHitFractions += callback.m_hitFraction;
+		}
+	}
+	times.m_rayTime = ReadTicks() - startTime;
+
+	//boxes a few meters wide, like the bounds of the objects resting on the terrain
+	CountTrianglesCallback boxCallback;
+	startTime = ReadTicks();
+	for (int i = 0; i < NUM_BOX_QUERIES; i++)
+	{
+		const btVector3 halfExtent(2, 2, 2);
+		shape->processAllTriangles(&boxCallback, boxCenters[i] - halfExtent, boxCenters[i] + halfExtent);
+	}
+	times.m_boxTime = ReadTicks() - startTime;
+	times.m_numBoxTriangles = boxCallback.m_numTriangles;
+}
+
+int Test_btHeightfieldRaycast(void)
+{
+	//the landscape patches cover a LANDSCAPE_SAMPLES x LANDSCAPE_SAMPLES grid
+	float* samples = new float[LANDSCAPE_SAMPLES * LANDSCAPE_SAMPLES];
+	const btScalar spacing = btScalar(LANDSCAPE_SIZE) / (LANDSCAPE_SAMPLES - 1);
+	for (int i = 0; i < 8; i++)
+	{
+		for (int v = 0; v < gLandscapeVtxCount[i]; v++)
+		{
+			const btScalar* vertex = &gLandscapeVtx[i][3 * v];
+			const int x = int(floorf((vertex[0] + LANDSCAPE_SIZE / 2) / spacing + 0.5f));
+			const int z = int(floorf((vertex[2] + LANDSCAPE_SIZE / 2) / spacing + 0.5f));
+			samples[z * LANDSCAPE_SAMPLES + x] = vertex[1];
+		}
+	}
+
+	//a finer terrain, bilinear between the landscape samples
+	const int numSamples = (LANDSCAPE_SAMPLES - 1) * UPSAMPLING + 1;
+	float* heights = new float[numSamples * numSamples];
+	float minHeight = samples[0];
+	float maxHeight = samples[0];
+	for (int z = 0; z < numSamples; z++)
+	{
+		for (int x = 0; x < numSamples; x++)
+		{
+			const int x0 = btMin(x / UPSAMPLING, LANDSCAPE_SAMPLES - 2);
+			const int z0 = btMin(z / UPSAMPLING, LANDSCAPE_SAMPLES - 2);
+			const float u = float(x - x0 * UPSAMPLING) / UPSAMPLING;
+			const float w = float(z - z0 * UPSAMPLING) / UPSAMPLING;
+			const float* s = &samples[z0 * LANDSCAPE_SAMPLES + x0];
+			const float height = (1 - w) * ((1 - u) * s[0] + u * s[1]) + w * ((1 - u) * s[LANDSCAPE_SAMPLES] + u * s[LANDSCAPE_SAMPLES + 1]);
+			heights[z * numSamples + x] = height;
+			minHeight = btMin(minHeight, height);
+			maxHeight = btMax(maxHeight, height);
+		}
+	}
+
+	btHeightfieldTerrainShape shape(numSamples, numSamples, heights, minHeight, maxHeight, 1, false);
+	const btScalar cellSize = btScalar(LANDSCAPE_SIZE) / (numSamples - 1);
+	shape.setLocalScaling(btVector3(cellSize, 1, cellSize));
+	const btScalar heightOffset = (minHeight + maxHeight) / 2;
+
+	//spinning lidars mounted 2 meters above the ground, with channels from 15 degrees down to 3 degrees up
+	const int numRays = NUM_SCANNERS * NUM_CHANNELS * NUM_AZIMUTHS;
+	btVector3* rayFrom = new btVector3[numRays];
+	btVector3* rayTo = new btVector3[numRays];
+	int ray = 0;
+	for (int i = 0; i < NUM_SCANNERS; i++)
+	{
+		const int x = int(RANDF_01 * (numSamples - 1));
+		const int z = int(RANDF_01 * (numSamples - 1));
+		const btVector3 scanner(x * cellSize - LANDSCAPE_SIZE / 2, heights[z * numSamples + x] - heightOffset + 2, z * cellSize - LANDSCAPE_SIZE / 2);
+		for (int c = 0; c < NUM_CHANNELS; c++)
+		{
+			const btScalar elevation = btRadians(-15 + 18 * btScalar(c) / (NUM_CHANNELS - 1));
+			for (int a = 0; a < NUM_AZIMUTHS; a++)
+			{
+				const btScalar azimuth = SIMD_2_PI * a / NUM_AZIMUTHS;
+				const btVector3 direction(btCos(elevation) * btCos(azimuth), btSin(elevation), btCos(elevation) * btSin(azimuth));
+				rayFrom[ray] = scanner;
+				rayTo[ray] = scanner + direction * RAY_LENGTH;
+				ray++;
+			}
+		}
+	}
+
+	btVector3* boxCenters = new btVector3[NUM_BOX_QUERIES];
+	for (int i = 0; i < NUM_BOX_QUERIES; i++)
+	{
+		const int x = int(RANDF_01 * (numSamples - 1));
+		const int z = int(RANDF_01 * (numSamples - 1));
+		boxCenters[i].setValue(x * cellSize - LANDSCAPE_SIZE / 2, heights[z * numSamples + x] - heightOffset + 1, z * cellSize - LANDSCAPE_SIZE / 2);
+	}
+
+	const int chunkSizes[4] = {0, 16, 4, 1};
+	HeightfieldQueryTimes times[4];
+	for (int i = 0; i < 4; i++)
+	{
+		shape.buildAccelerator(chunkSizes[i]);
+		TimeHeightfieldQueries(&shape, rayFrom, rayTo, numRays, boxCenters, times[i]);
+	}
+
+	vlog("btHeightfieldTerrainShape Timing (%d x %d samples, %d rays, %d boxes), seconds:\n", numSamples, numSamples, numRays, NUM_BOX_QUERIES);
+	vlog("     \t      grid\t  chunks16\t   chunks4\t   chunks1\n");
+	vlog("rays \t%10.4f\t%10.4f\t%10.4f\t%10.4f\n", TicksToSeconds(times[0].m_rayTime), TicksToSeconds(times[1].m_rayTime),
+		 TicksToSeconds(times[2].m_rayTime), TicksToSeconds(times[3].m_rayTime));
+	vlog("boxes\t%10.4f\t%10.4f\t%10.4f\t%10.4f\n", TicksToSeconds(times[0].m_boxTime), TicksToSeconds(times[1].m_boxTime),
+		 TicksToSeconds(times[2].m_boxTime), TicksToSeconds(times[3].m_boxTime));
+
+	delete[] boxCenters;
+	delete[] rayTo;
+	delete[] rayFrom;
+	delete[] heights;
+	delete[] samples;
+
+	//the accelerator only skips what the queries can't touch, so they find the same hits and triangles
+	for (int i = 1; i < 4; i++)
+	{
+		if (times[0].m_numHits != times[i].m_numHits || fabs(times[0].m_sumHitFractions - times[i].m_sumHitFractions) > 1e-3 ||
+			times[0].m_numBoxTriangles != times[i].m_numBoxTriangles)
+		{
+			vlog("btHeightfieldTerrainShape query mismatch: %d/%d hits, %d/%d triangles\n", times[0].m_numHits, times[i].m_numHits,
+				 times[0].m_numBoxTriangles, times[i].m_numBoxTriangles);
+			return 1;
+		}
+	}
+	return 0;
+}
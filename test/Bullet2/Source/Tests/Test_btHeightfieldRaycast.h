@@ -0,0 +1,20 @@
+//
+//  Test_btHeightfieldRaycast.h
+//  BulletTest
+//
+
+#ifndef BulletTest_Test_btHeightfieldRaycast_h
+#define BulletTest_Test_btHeightfieldRaycast_h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	int Test_btHeightfieldRaycast(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
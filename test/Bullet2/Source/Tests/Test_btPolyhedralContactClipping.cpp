@@ -0,0 +1,112 @@
+//
+//  Test_btPolyhedralContactClipping.cpp
+//  BulletTest
+//
+//  Hull-hull contact generation times of btPolyhedralContactClipping, separating axis test
+//  over all unique edge directions against the Gauss map edge pairs, for growing hull sizes
+//
+
+#include "Test_btPolyhedralContactClipping.h"
+#include "vector.h"
+#include "Utils.h"
+#include "main.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <BulletCollision/CollisionShapes/btConvexHullShape.h>
+#include <BulletCollision/CollisionShapes/btConvexPolyhedron.h>
+#include <BulletCollision/NarrowPhaseCollision/btPolyhedralContactClipping.h>
+
+#define NUM_HULL_SIZES 4
+#define NUM_TRANSFORMS 250
+
+struct ContactCountResult : public btDiscreteCollisionDetectorInterface::Result
+{
+	int m_numContacts;
+
+	ContactCountResult() : m_numContacts(0) {}
+
+	virtual void setShapeIdentifiersA(int partId0, int index0) {}
+	virtual void setShapeIdentifiersB(int partId1, int index1) {}
+	virtual void addContactPoint(const btVector3& normalOnBInWorld, const btVector3& pointInWorld, btScalar depth)
+	{
+		m_numContacts++;
+	}
+};
+
+static uint64_t TimeContacts(const btConvexPolyhedron& hullA, const btConvexPolyhedron& hullB, const btTransform* transforms, int& numContacts)
+{
+	btVertexArray worldVertsB1;
+	btVertexArray worldVertsB2;
+	ContactCountResult result;
+	btTransform transB = btTransform::getIdentity();
+
+	uint64_t startTime = ReadTicks();
+	for (int i = 0; i < NUM_TRANSFORMS; i++)
+	{
+		btVector3 sep;
+		if (btPolyhedralContactClipping::findSeparatingAxis(hullA, hullB, transforms[i], transB, sep, result))
+		{
+			btPolyhedralContactClipping::clipHullAgainstHull(sep, hullA, hullB, transforms[i], transB, -1, 0, worldVertsB1, worldVertsB2, result);
+		}
+	}
+	numContacts = result.m_numContacts;
+	return ReadTicks() - startTime;
+}
+
+int Test_btPolyhedralContactClipping(void)
+{
+	const int hullSizes[NUM_HULL_SIZES] = {8, 16, 32, 64};
+
+	btTransform* transforms = new btTransform[NUM_TRANSFORMS];
+	for (int i = 0; i < NUM_TRANSFORMS; i++)
+	{
+		btVector3 axis(RANDF_m1p1, RANDF_m1p1, RANDF_m1p1);
+		btVector3 direction(RANDF_m1p1, RANDF_m1p1, RANDF_m1p1);
+		btQuaternion orientation(axis.normalized(), RANDF_01 * SIMD_2_PI);
+		transforms[i] = btTransform(orientation, direction.normalized() * RANDF_01);
+	}
+
+	int result = 0;
+	vlog("hull-hull contact clipping Timing (%d poses), seconds:\n", NUM_TRANSFORMS);
+	vlog("points\t  edges\t unique edges\t Gauss map\n");
+	for (int s = 0; s < NUM_HULL_SIZES; s++)
+	{
+		btConvexHullShape shapeA;
+		btConvexHullShape shapeB;
+		for (int i = 0; i < hullSizes[s]; i++)
+		{
+			btVector3 pointA(RANDF_m1p1, RANDF_m1p1, RANDF_m1p1);
+			btVector3 pointB(RANDF_m1p1, RANDF_m1p1, RANDF_m1p1);
+			shapeA.addPoint(pointA.normalized() * btScalar(0.5), false);
+			shapeB.addPoint(pointB.normalized() * btScalar(0.5), false);
+		}
+		shapeA.recalcLocalAabb();
+		shapeB.recalcLocalAabb();
+		shapeA.initializePolyhedralFeatures();
+		shapeB.initializePolyhedralFeatures();
+		const btConvexPolyhedron& hullA = *shapeA.getConvexPolyhedron();
+		const btConvexPolyhedron& hullB = *shapeB.getConvexPolyhedron();
+
+		btConvexPolyhedron uniqueEdgesA = hullA;
+		btConvexPolyhedron uniqueEdgesB = hullB;
+		uniqueEdgesA.m_edges.clear();
+		uniqueEdgesB.m_edges.clear();
+
+		int numUniqueEdgeContacts, numGaussMapContacts;
+		uint64_t uniqueEdgeTime = TimeContacts(uniqueEdgesA, uniqueEdgesB, transforms, numUniqueEdgeContacts);
+		uint64_t gaussMapTime = TimeContacts(hullA, hullB, transforms, numGaussMapContacts);
+		vlog("%6d\t%7d\t%13.4f\t%10.4f\n", hullSizes[s], hullA.m_edges.size(), TicksToSeconds(uniqueEdgeTime), TicksToSeconds(gaussMapTime));
+
+		//up to ties between axes of the same depth
+		if (abs(numUniqueEdgeContacts - numGaussMapContacts) > numUniqueEdgeContacts / 20)
+		{
+			vlog("%d points: contact mismatch %d/%d\n", hullSizes[s], numUniqueEdgeContacts, numGaussMapContacts);
+			result = 1;
+		}
+	}
+
+	delete[] transforms;
+	return result;
+}
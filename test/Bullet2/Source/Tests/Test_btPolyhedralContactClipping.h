@@ -0,0 +1,20 @@
+//
+//  Test_btPolyhedralContactClipping.h
+//  BulletTest
+//
+
+#ifndef BulletTest_Test_btPolyhedralContactClipping_h
+#define BulletTest_Test_btPolyhedralContactClipping_h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	int Test_btPolyhedralContactClipping(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
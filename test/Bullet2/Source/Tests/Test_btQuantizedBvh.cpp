@@ -0,0 +1,176 @@
+//
+//  Test_btQuantizedBvh.cpp
+//  BulletTest
+//
+//  Build and query times of the mean split and the binned SAH builders of btOptimizedBvh,
+//  and of the 4-ary and 8-ary btQuantizedWideBvh collapsed from the binned SAH tree
+//
+
+#include "Test_btQuantizedBvh.h"
+#include "vector.h"
+#include "Utils.h"
+#include "main.h"
+#include <math.h>
+#include <string.h>
+
+#include <BulletCollision/BroadphaseCollision/btQuantizedWideBvh.h>
+#include <BulletCollision/CollisionShapes/btOptimizedBvh.h>
+#include <BulletCollision/CollisionShapes/btTriangleIndexVertexArray.h>
+
+#define GRID_SIZE 512
+#define NUM_BUILDS 3
+#define NUM_QUERIES 10000
+
+class CountOverlapCallback : public btNodeOverlapCallback
+{
+public:
+	int m_numOverlaps;
+
+	CountOverlapCallback() : m_numOverlaps(0) {}
+
+	virtual void processNode(int subPart, int triangleIndex)
+	{
+		m_numOverlaps++;
+	}
+};
+
+struct QuantizedBvhTimes
+{
+	uint64_t m_buildTime;
+	uint64_t m_aabbQueryTime;
+	uint64_t m_rayQueryTime;
+	int m_numAabbOverlaps;
+	int m_numRayOverlaps;
+};
+
+static void TimeQuantizedBvh(btStridingMeshInterface* mesh, const btVector3& aabbMin, const btVector3& aabbMax,
+							 const btVector3* queries, btQuantizedBvh::btBuildMode buildMode, int wideBvhWidth, QuantizedBvhTimes& times)
+{
+	btOptimizedBvh* bvh = 0;
+	btQuantizedWideBvh* wideBvh = btQuantizedWideBvh::create(wideBvhWidth);
+	uint64_t bestTime = -1LL;
+	uint64_t totalTime = 0;
+	for (int i = 0; i < NUM_BUILDS; i++)
+	{
+		delete bvh;
+		bvh = new btOptimizedBvh();
+		uint64_t startTime = ReadTicks();
+		bvh->build(mesh, true, aabbMin, aabbMax, buildMode);
+		if (wideBvh)
+			wideBvh->build(bvh);
+		uint64_t currentTime = ReadTicks() - startTime;
+		totalTime += currentTime;
+		if (currentTime < bestTime)
+			bestTime = currentTime;
+	}
+	times.m_buildTime = gReportAverageTimes ? totalTime / NUM_BUILDS : bestTime;
+
+	//boxes of a few triangles wide, like the bounds of a dynamic object resting on the terrain
+	CountOverlapCallback aabbCallback;
+	uint64_t startTime = ReadTicks();
+	for (int i = 0; i < NUM_QUERIES; i++)
+	{
+		const btVector3 halfExtent(2, 2, 2);
+		if (wideBvh)
+			wideBvh->reportAabbOverlappingNodex(&aabbCallback, queries[i] - halfExtent, queries[i] + halfExtent);
+		else
+			bvh->reportAabbOverlappingNodex(&aabbCallback, queries[i] - halfExtent, queries[i] + halfExtent);
+	}
+	times.m_aabbQueryTime = ReadTicks() - startTime;
+	times.m_numAabbOverlaps = aabbCallback.m_numOverlaps;
+
+	//vertical rays, like raycast vehicle wheels
+	CountOverlapCallback rayCallback;
+	startTime = ReadTicks();
+	for (int i = 0; i < NUM_QUERIES; i++)
+	{
+		const btVector3 from = queries[i] + btVector3(0, 0, 50);
+		const btVector3 to = queries[i] - btVector3(0, 0, 50);
+		if (wideBvh)
+			wideBvh->reportRayOverlappingNodex(&rayCallback, from, to);
+		else
+			bvh->reportRayOverlappingNodex(&rayCallback, from, to);
+	}
+	times.m_rayQueryTime = ReadTicks() - startTime;
+	times.m_numRayOverlaps = rayCallback.m_numOverlaps;
+
+	delete wideBvh;
+	delete bvh;
+}
+
+int Test_btQuantizedBvh(void)
+{
+	//a GRID_SIZE x GRID_SIZE terrain with hills, two triangles per cell
+	const int numVertices = (GRID_SIZE + 1) * (GRID_SIZE + 1);
+	const int numTriangles = 2 * GRID_SIZE * GRID_SIZE;
+	btVector3* vertices = new btVector3[numVertices];
+	int* indices = new int[3 * numTriangles];
+
+	for (int y = 0; y <= GRID_SIZE; y++)
+	{
+		for (int x = 0; x <= GRID_SIZE; x++)
+		{
+			const btScalar height = 10 * sinf(x * 0.05f) * cosf(y * 0.07f) + RANDF_01;
+			vertices[y * (GRID_SIZE + 1) + x].setValue(btScalar(x), btScalar(y), height);
+		}
+	}
+	int index = 0;
+	for (int y = 0; y < GRID_SIZE; y++)
+	{
+		for (int x = 0; x < GRID_SIZE; x++)
+		{
+			const int v = y * (GRID_SIZE + 1) + x;
+			indices[index++] = v;
+			indices[index++] = v + 1;
+			indices[index++] = v + GRID_SIZE + 1;
+			indices[index++] = v + 1;
+			indices[index++] = v + GRID_SIZE + 2;
+			indices[index++] = v + GRID_SIZE + 1;
+		}
+	}
+
+	btTriangleIndexVertexArray mesh(numTriangles, indices, 3 * sizeof(int), numVertices, (btScalar*)&vertices[0].x(), sizeof(btVector3));
+	btVector3 aabbMin, aabbMax;
+	mesh.calculateAabbBruteForce(aabbMin, aabbMax);
+
+	btVector3* queries = new btVector3[NUM_QUERIES];
+	for (int i = 0; i < NUM_QUERIES; i++)
+	{
+		queries[i].setValue(RANDF_01 * GRID_SIZE, RANDF_01 * GRID_SIZE, 0);
+	}
+
+	QuantizedBvhTimes meanSplit;
+	QuantizedBvhTimes binnedSah;
+	QuantizedBvhTimes wide4;
+	QuantizedBvhTimes wide8;
+	TimeQuantizedBvh(&mesh, aabbMin, aabbMax, queries, btQuantizedBvh::BUILD_MEAN_SPLIT, 0, meanSplit);
+	TimeQuantizedBvh(&mesh, aabbMin, aabbMax, queries, btQuantizedBvh::BUILD_BINNED_SAH, 0, binnedSah);
+	TimeQuantizedBvh(&mesh, aabbMin, aabbMax, queries, btQuantizedBvh::BUILD_BINNED_SAH, 4, wide4);
+	TimeQuantizedBvh(&mesh, aabbMin, aabbMax, queries, btQuantizedBvh::BUILD_BINNED_SAH, 8, wide8);
+
+	vlog("btQuantizedBvh Timing (%d triangles, %d queries), seconds:\n", numTriangles, NUM_QUERIES);
+	vlog("     \tmean split\tbinned SAH\t  SAH BVH4\t  SAH BVH8\n");
+	vlog("build\t%10.4f\t%10.4f\t%10.4f\t%10.4f\n", TicksToSeconds(meanSplit.m_buildTime), TicksToSeconds(binnedSah.m_buildTime),
+		 TicksToSeconds(wide4.m_buildTime), TicksToSeconds(wide8.m_buildTime));
+	vlog("aabb \t%10.4f\t%10.4f\t%10.4f\t%10.4f\n", TicksToSeconds(meanSplit.m_aabbQueryTime), TicksToSeconds(binnedSah.m_aabbQueryTime),
+		 TicksToSeconds(wide4.m_aabbQueryTime), TicksToSeconds(wide8.m_aabbQueryTime));
+	vlog("ray  \t%10.4f\t%10.4f\t%10.4f\t%10.4f\n", TicksToSeconds(meanSplit.m_rayQueryTime), TicksToSeconds(binnedSah.m_rayQueryTime),
+		 TicksToSeconds(wide4.m_rayQueryTime), TicksToSeconds(wide8.m_rayQueryTime));
+
+	delete[] queries;
+	delete[] indices;
+	delete[] vertices;
+
+	//all trees contain the same triangles, so the queries report the same overlaps
+	const QuantizedBvhTimes* others[3] = {&binnedSah, &wide4, &wide8};
+	for (int i = 0; i < 3; i++)
+	{
+		if (meanSplit.m_numAabbOverlaps != others[i]->m_numAabbOverlaps || meanSplit.m_numRayOverlaps != others[i]->m_numRayOverlaps)
+		{
+			vlog("btQuantizedBvh overlap mismatch: %d/%d aabb, %d/%d ray\n", meanSplit.m_numAabbOverlaps, others[i]->m_numAabbOverlaps,
+				 meanSplit.m_numRayOverlaps, others[i]->m_numRayOverlaps);
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,20 @@
+//
+//  Test_btQuantizedBvh.h
+//  BulletTest
+//
+
+#ifndef BulletTest_Test_btQuantizedBvh_h
+#define BulletTest_Test_btQuantizedBvh_h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	int Test_btQuantizedBvh(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
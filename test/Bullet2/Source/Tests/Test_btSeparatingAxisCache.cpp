@@ -0,0 +1,128 @@
+//
+//  Test_btSeparatingAxisCache.cpp
+//  BulletTest
+//
+//  Simulation times of stacks of convex hulls at rest, with the separating axis test of
+//  btPolyhedralContactClipping, with and without the per pair feature cache
+//
+
+#include "Test_btSeparatingAxisCache.h"
+#include "vector.h"
+#include "Utils.h"
+#include "main.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <btBulletDynamicsCommon.h>
+
+#define NUM_STACKS 4
+#define STACK_HEIGHT 6
+#define NUM_SETTLE_STEPS 240
+#define NUM_TIMED_STEPS 240
+
+struct HullStackWorld
+{
+	btDefaultCollisionConfiguration m_configuration;
+	btCollisionDispatcher m_dispatcher;
+	btDbvtBroadphase m_broadphase;
+	btSequentialImpulseConstraintSolver m_solver;
+	btDiscreteDynamicsWorld m_world;
+	btConvexHullShape m_groundShape;
+	btConvexHullShape m_hullShape;
+	btAlignedObjectArray<btRigidBody*> m_bodies;
+
+	HullStackWorld(bool useFeatureCache)
+		: m_dispatcher(&m_configuration),
+		  m_world(&m_dispatcher, &m_broadphase, &m_solver, &m_configuration)
+	{
+		m_world.setGravity(btVector3(0, 0, -10));
+		m_world.getDispatchInfo().m_enableSatConvex = true;
+		m_world.getDispatchInfo().m_useConvexFeatureCache = useFeatureCache;
+
+		for (int i = 0; i < 8; i++)
+		{
+			m_groundShape.addPoint(btVector3(i & 1 ? 20 : -20, i & 2 ? 20 : -20, i & 4 ? 0 : -1), false);
+		}
+		m_groundShape.recalcLocalAabb();
+		m_groundShape.initializePolyhedralFeatures();
+		m_bodies.push_back(new btRigidBody(0, 0, &m_groundShape));
+
+		//a cube with bevelled corners
+		for (int i = 0; i < 24; i++)
+		{
+			btVector3 point(i & 1 ? 0.5 : -0.5, i & 2 ? 0.5 : -0.5, i & 4 ? 0.5 : -0.5);
+			point[(i >> 3) % 3] *= btScalar(0.8);
+			m_hullShape.addPoint(point, false);
+		}
+		m_hullShape.recalcLocalAabb();
+		m_hullShape.initializePolyhedralFeatures();
+		btVector3 inertia;
+		m_hullShape.calculateLocalInertia(1, inertia);
+
+		for (int s = 0; s < NUM_STACKS; s++)
+		{
+			for (int h = 0; h < STACK_HEIGHT; h++)
+			{
+				btTransform trans(btQuaternion(btVector3(0, 0, 1), 0.1 * h), btVector3(2 * s, 0, 0.52 + 1.02 * h));
+				btRigidBody* body = new btRigidBody(1, 0, &m_hullShape, inertia);
+				body->setWorldTransform(trans);
+				body->setActivationState(DISABLE_DEACTIVATION);
+				m_bodies.push_back(body);
+			}
+		}
+		for (int i = 0; i < m_bodies.size(); i++)
+		{
+			m_world.addRigidBody(m_bodies[i]);
+		}
+	}
+
+	~HullStackWorld()
+	{
+		for (int i = 0; i < m_bodies.size(); i++)
+		{
+			m_world.removeRigidBody(m_bodies[i]);
+			delete m_bodies[i];
+		}
+	}
+
+	uint64_t step(int numSteps)
+	{
+		uint64_t startTime = ReadTicks();
+		for (int i = 0; i < numSteps; i++)
+		{
+			m_world.stepSimulation(btScalar(1. / 60.), 0);
+		}
+		return ReadTicks() - startTime;
+	}
+};
+
+int Test_btSeparatingAxisCache(void)
+{
+	HullStackWorld uncached(false);
+	HullStackWorld cached(true);
+	uncached.step(NUM_SETTLE_STEPS);
+	cached.step(NUM_SETTLE_STEPS);
+
+	uint64_t uncachedTime = uncached.step(NUM_TIMED_STEPS);
+	uint64_t cachedTime = cached.step(NUM_TIMED_STEPS);
+
+	vlog("%d stacks of %d convex hulls at rest, %d steps, seconds:\n", NUM_STACKS, STACK_HEIGHT, NUM_TIMED_STEPS);
+	vlog("full SAT\tfeature cache\n");
+	vlog("%8.4f\t%13.4f\n", TicksToSeconds(uncachedTime), TicksToSeconds(cachedTime));
+
+	//both keep the stacks standing
+	int result = 0;
+	for (int i = 1; i < cached.m_bodies.size(); i++)
+	{
+		btScalar height = 0.5 + ((i - 1) % STACK_HEIGHT);
+		btScalar cachedHeight = cached.m_bodies[i]->getWorldTransform().getOrigin().z();
+		btScalar uncachedHeight = uncached.m_bodies[i]->getWorldTransform().getOrigin().z();
+		if (fabs(cachedHeight - height) > 0.1 || fabs(uncachedHeight - height) > 0.1)
+		{
+			vlog("body %d height %f/%f, expected %f\n", i, uncachedHeight, cachedHeight, height);
+			result = 1;
+		}
+	}
+	return result;
+}
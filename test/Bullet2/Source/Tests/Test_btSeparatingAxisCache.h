@@ -0,0 +1,20 @@
+//
+//  Test_btSeparatingAxisCache.h
+//  BulletTest
+//
+
+#ifndef BulletTest_Test_btSeparatingAxisCache_h
+#define BulletTest_Test_btSeparatingAxisCache_h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	int Test_btSeparatingAxisCache(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef CLOSEST_CONTACT_CALLBACK_H
+#define CLOSEST_CONTACT_CALLBACK_H
+
+#include <btBulletDynamicsCommon.h>
+
+///keeps the deepest contact point reported by btCollisionWorld::contactPairTest within 0.1 of the surfaces
+struct ClosestContactCallback : public btCollisionWorld::ContactResultCallback
+{
+	int m_numContacts;
+	btScalar m_distance;
+	btVector3 m_normalOnB;
+	btVector3 m_pointOnB;
+
+	ClosestContactCallback() : m_numContacts(0), m_distance(BT_LARGE_FLOAT), m_normalOnB(0, 0, 0), m_pointOnB(0, 0, 0)
+	{
+		m_closestDistanceThreshold = 0.1;
+	}
+
+	virtual btScalar addSingleResult(btManifoldPoint& cp, const btCollisionObjectWrapper* colObj0Wrap, int partId0, int index0, const btCollisionObjectWrapper* colObj1Wrap, int partId1, int index1)
+	{
+		m_numContacts++;
+		if (cp.getDistance() < m_distance)
+		{
+			m_distance = cp.getDistance();
+			m_normalOnB = cp.m_normalWorldOnB;
+			m_pointOnB = cp.getPositionWorldOnB();
+		}
+		return 0;
+	}
+};
+
+#endif  //CLOSEST_CONTACT_CALLBACK_H
@@ -0,0 +1,199 @@
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/CollisionDispatch/btGhostObject.h>
+#include <BulletDynamics/Character/btKinematicCharacterController.h>
+#include <BulletDynamics/Character/btCharacterControllerCrowd.h>
+#include <BulletCollision/CollisionShapes/btConvexHullShape.h>
+#include <gtest/gtest.h>
+
+#define NUM_CHARACTERS 64
+
+///a grid of characters walking over a floor with a few steps on it, updated one by one or as a crowd. The characters share
+///a capsule, or each has its own hull, which grows by the added margin of the controller in its sweeps
+static void SimulateCharacters(bool useCrowd, btScalar spacing, bool converge, btAlignedObjectArray<btTransform>& ghostTransforms, bool hullShapes = false)
+{
+	btDefaultCollisionConfiguration config;
+	btCollisionDispatcher dispatcher(&config);
+	btDbvtBroadphase broadphase;
+	btGhostPairCallback ghostPairCallback;
+	broadphase.getOverlappingPairCache()->setInternalGhostPairCallback(&ghostPairCallback);
+	btSequentialImpulseConstraintSolver solver;
+	btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &config);
+
+	btBoxShape groundShape(btVector3(500, 1, 500));
+	btRigidBody ground(0, 0, &groundShape);
+	ground.getWorldTransform().setOrigin(btVector3(0, -1, 0));
+	world.addRigidBody(&ground);
+
+	btBoxShape stepShape(btVector3(500, 0.2, 1));
+	btRigidBody step(0, 0, &stepShape);
+	step.getWorldTransform().setOrigin(btVector3(0, 0.2, 3));
+	world.addRigidBody(&step);
+
+	btCapsuleShape characterShape(0.3, 1);
+	btAlignedObjectArray<btConvexHullShape*> hulls;
+	btCharacterControllerCrowd crowd;
+
+	btAlignedObjectArray<btPairCachingGhostObject*> ghostObjects;
+	btAlignedObjectArray<btKinematicCharacterController*> controllers;
+	for (int i = 0; i < NUM_CHARACTERS; i++)
+	{
+		btPairCachingGhostObject* ghostObject = new btPairCachingGhostObject();
+		ghostObject->getWorldTransform().setIdentity();
+		ghostObject->getWorldTransform().setOrigin(btVector3(spacing * (i % 8) - 4 * spacing, 1, spacing * (i / 8) - 4 * spacing));
+		btConvexShape* shape = &characterShape;
+		if (hullShapes)
+		{
+			btConvexHullShape* hull = new btConvexHullShape();
+			for (int j = 0; j < 8; j++)
+			{
+				hull->addPoint(btVector3(j & 1 ? 0.3 : -0.3, j & 2 ? 0.8 : -0.8, j & 4 ? 0.3 : -0.3), false);
+			}
+			hull->recalcLocalAabb();
+			hulls.push_back(hull);
+			shape = hull;
+		}
+		ghostObject->setCollisionShape(shape);
+		ghostObject->setCollisionFlags(btCollisionObject::CF_CHARACTER_OBJECT);
+		world.addCollisionObject(ghostObject, btBroadphaseProxy::CharacterFilter, btBroadphaseProxy::AllFilter);
+		ghostObjects.push_back(ghostObject);
+
+		btKinematicCharacterController* controller = new btKinematicCharacterController(ghostObject, shape, btScalar(0.35), btVector3(0, 1, 0));
+		controller->setAngularVelocity(btVector3(0, btScalar(0.1) * (i % 5), 0));
+		controllers.push_back(controller);
+		if (useCrowd)
+		{
+			crowd.addController(controller);
+		}
+		else
+		{
+			world.addAction(controller);
+		}
+	}
+	if (useCrowd)
+	{
+		world.addAction(&crowd);
+	}
+
+	for (int s = 0; s < 120; s++)
+	{
+		for (int i = 0; i < NUM_CHARACTERS; i++)
+		{
+			// walk over the step, towards the center line of the grid or in separate lanes
+			const btVector3& origin = ghostObjects[i]->getWorldTransform().getOrigin();
+			btVector3 walkDirection(converge ? -origin.x() : btScalar(0.1) * (i % 3 - 1), 0, 4);
+			controllers[i]->setWalkDirection(walkDirection.normalized() * btScalar(0.05));
+			if (s == 60 + (i % 3))
+			{
+				controllers[i]->jump();
+			}
+		}
+		world.stepSimulation(btScalar(1. / 60.), 0);
+	}
+
+	if (useCrowd)
+	{
+		world.removeAction(&crowd);
+	}
+	for (int i = 0; i < NUM_CHARACTERS; i++)
+	{
+		ghostTransforms.push_back(ghostObjects[i]->getWorldTransform());
+		if (!useCrowd)
+		{
+			world.removeAction(controllers[i]);
+		}
+		delete controllers[i];
+		world.removeCollisionObject(ghostObjects[i]);
+		delete ghostObjects[i];
+	}
+	for (int i = 0; i < hulls.size(); i++)
+	{
+		// the sweeps leave the margin as it was
+		EXPECT_EQ(CONVEX_DISTANCE_MARGIN, hulls[i]->getMargin()) << i;
+		delete hulls[i];
+	}
+	world.removeRigidBody(&step);
+	world.removeRigidBody(&ground);
+}
+
+static void SimulateCrowdThreaded(btScalar spacing, bool converge, btAlignedObjectArray<btTransform>& ghostTransforms, bool hullShapes = false)
+{
+	btITaskScheduler* previousScheduler = btGetTaskScheduler();
+	btITaskScheduler* scheduler = btCreateDefaultTaskScheduler();
+	if (scheduler)
+	{
+		scheduler->setNumThreads(btMin(4, scheduler->getMaxNumThreads()));
+		btSetTaskScheduler(scheduler);
+	}
+	SimulateCharacters(true, spacing, converge, ghostTransforms, hullShapes);
+	btSetTaskScheduler(previousScheduler);
+	delete scheduler;
+}
+
+GTEST_TEST(BulletDynamics, CharacterControllerCrowd_MatchesSeparateControllers)
+{
+	// far enough apart that the characters never meet, so the order of the updates does not matter
+	btAlignedObjectArray<btTransform> controllerTransforms;
+	SimulateCharacters(false, 10, false, controllerTransforms);
+	btAlignedObjectArray<btTransform> crowdTransforms;
+	SimulateCrowdThreaded(10, false, crowdTransforms);
+
+	ASSERT_EQ(NUM_CHARACTERS, controllerTransforms.size());
+	ASSERT_EQ(NUM_CHARACTERS, crowdTransforms.size());
+	for (int i = 0; i < NUM_CHARACTERS; i++)
+	{
+		EXPECT_TRUE(controllerTransforms[i].getOrigin() == crowdTransforms[i].getOrigin()) << i;
+		EXPECT_TRUE(controllerTransforms[i].getBasis() == crowdTransforms[i].getBasis()) << i;
+
+		// still on the floor or the step
+		EXPECT_GT(crowdTransforms[i].getOrigin().y(), 0) << i;
+		EXPECT_LT(crowdTransforms[i].getOrigin().y(), 1.5) << i;
+	}
+}
+
+GTEST_TEST(BulletDynamics, CharacterControllerCrowd_HullsMatchSeparateControllers)
+{
+	// the sweeps of the threads change the margins of their own hulls only
+	btAlignedObjectArray<btTransform> controllerTransforms;
+	SimulateCharacters(false, 10, false, controllerTransforms, true);
+	btAlignedObjectArray<btTransform> crowdTransforms;
+	SimulateCrowdThreaded(10, false, crowdTransforms, true);
+
+	ASSERT_EQ(NUM_CHARACTERS, controllerTransforms.size());
+	ASSERT_EQ(NUM_CHARACTERS, crowdTransforms.size());
+	for (int i = 0; i < NUM_CHARACTERS; i++)
+	{
+		EXPECT_TRUE(controllerTransforms[i].getOrigin() == crowdTransforms[i].getOrigin()) << i;
+		EXPECT_TRUE(controllerTransforms[i].getBasis() == crowdTransforms[i].getBasis()) << i;
+		EXPECT_GT(crowdTransforms[i].getOrigin().y(), 0) << i;
+		EXPECT_LT(crowdTransforms[i].getOrigin().y(), 1.5) << i;
+	}
+}
+
+GTEST_TEST(BulletDynamics, CharacterControllerCrowd_Deterministic)
+{
+	// close enough to push into each other
+	btITaskScheduler* previousScheduler = btGetTaskScheduler();
+	btSetTaskScheduler(btGetSequentialTaskScheduler());
+	btAlignedObjectArray<btTransform> sequentialTransforms;
+	SimulateCharacters(true, 1, true, sequentialTransforms);
+	btSetTaskScheduler(previousScheduler);
+
+	btAlignedObjectArray<btTransform> parallelTransforms;
+	SimulateCrowdThreaded(1, true, parallelTransforms);
+
+	ASSERT_EQ(NUM_CHARACTERS, sequentialTransforms.size());
+	ASSERT_EQ(NUM_CHARACTERS, parallelTransforms.size());
+	for (int i = 0; i < NUM_CHARACTERS; i++)
+	{
+		EXPECT_TRUE(sequentialTransforms[i].getOrigin() == parallelTransforms[i].getOrigin()) << i;
+		EXPECT_TRUE(sequentialTransforms[i].getBasis() == parallelTransforms[i].getBasis()) << i;
+		EXPECT_GT(parallelTransforms[i].getOrigin().y(), 0) << i;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
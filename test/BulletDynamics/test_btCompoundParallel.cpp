@@ -0,0 +1,190 @@
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/CollisionDispatch/btCompoundCollisionAlgorithm.h>
+#include <gtest/gtest.h>
+
+#define SLAB_SIZE 16
+
+///a fractured slab of SLAB_SIZE * SLAB_SIZE cubes
+static void AddSlabChildren(btCompoundShape& slab, btCollisionShape* cube)
+{
+	for (int i = 0; i < SLAB_SIZE; i++)
+	{
+		for (int j = 0; j < SLAB_SIZE; j++)
+		{
+			btTransform childTrans;
+			childTrans.setIdentity();
+			childTrans.setOrigin(btVector3(btScalar(0.5) * (i - SLAB_SIZE / 2), 0, btScalar(0.5) * (j - SLAB_SIZE / 2)));
+			slab.addChildShape(childTrans, cube);
+		}
+	}
+}
+
+static btITaskScheduler* SetThreadedScheduler()
+{
+	btITaskScheduler* scheduler = btCreateDefaultTaskScheduler();
+	if (scheduler)
+	{
+		scheduler->setNumThreads(btMin(4, scheduler->getMaxNumThreads()));
+		btSetTaskScheduler(scheduler);
+	}
+	return scheduler;
+}
+
+///compares x, y and z, the w of the tree volumes is not set
+static bool SameBound(const btVector3& a, const btVector3& b)
+{
+	return a.x() == b.x() && a.y() == b.y() && a.z() == b.z();
+}
+
+///checks that each internal node of the tree is the union of its children
+static void ExpectRefitNode(const btDbvtNode* node)
+{
+	if (node->isinternal())
+	{
+		ExpectRefitNode(node->childs[0]);
+		ExpectRefitNode(node->childs[1]);
+		btDbvtVolume merged;
+		Merge(node->childs[0]->volume, node->childs[1]->volume, merged);
+		EXPECT_TRUE(SameBound(merged.Mins(), node->volume.Mins()));
+		EXPECT_TRUE(SameBound(merged.Maxs(), node->volume.Maxs()));
+	}
+}
+
+GTEST_TEST(BulletCollision, CompoundParallel_UpdateChildTransforms)
+{
+	btBoxShape cube(btVector3(btScalar(0.25), btScalar(0.25), btScalar(0.25)));
+	btCompoundShape single;
+	btCompoundShape batch;
+	AddSlabChildren(single, &cube);
+	AddSlabChildren(batch, &cube);
+
+	// the pieces drift apart and tumble, in reverse order to check the index mapping
+	btAlignedObjectArray<int> childIndices;
+	btAlignedObjectArray<btTransform> childTransforms;
+	for (int i = batch.getNumChildShapes() - 1; i >= 0; i--)
+	{
+		btTransform childTrans = batch.getChildTransform(i);
+		childTrans.setRotation(btQuaternion(btVector3(1, 1, 0).normalized(), btScalar(0.01) * i));
+		childTrans.getOrigin() *= btScalar(1.5);
+		childTrans.getOrigin().setY(btSin(btScalar(0.1) * i));
+		childIndices.push_back(i);
+		childTransforms.push_back(childTrans);
+		single.updateChildTransform(i, childTrans);
+	}
+
+	btITaskScheduler* previousScheduler = btGetTaskScheduler();
+	btITaskScheduler* scheduler = SetThreadedScheduler();
+	batch.updateChildTransforms(&childIndices[0], &childTransforms[0], childIndices.size());
+	btSetTaskScheduler(previousScheduler);
+	delete scheduler;
+
+	btTransform identity;
+	identity.setIdentity();
+	btVector3 singleMin, singleMax, batchMin, batchMax;
+	single.getAabb(identity, singleMin, singleMax);
+	batch.getAabb(identity, batchMin, batchMax);
+	EXPECT_TRUE(singleMin == batchMin);
+	EXPECT_TRUE(singleMax == batchMax);
+
+	for (int i = 0; i < batch.getNumChildShapes(); i++)
+	{
+		EXPECT_TRUE(single.getChildTransform(i) == batch.getChildTransform(i)) << i;
+		const btDbvtVolume& singleLeaf = single.getChildList()[i].m_node->volume;
+		const btDbvtVolume& batchLeaf = batch.getChildList()[i].m_node->volume;
+		EXPECT_TRUE(SameBound(singleLeaf.Mins(), batchLeaf.Mins())) << i;
+		EXPECT_TRUE(SameBound(singleLeaf.Maxs(), batchLeaf.Maxs())) << i;
+	}
+
+	// the refit tree is tight around the new leaves
+	ExpectRefitNode(batch.getDynamicAabbTree()->m_root);
+}
+
+///two fractured slabs dropped on the ground and on each other
+static void SimulateSlabs(btAlignedObjectArray<btTransform>& slabTransforms, btAlignedObjectArray<int>& numContacts)
+{
+	btDefaultCollisionConfiguration config;
+	btCollisionDispatcher dispatcher(&config);
+	btDbvtBroadphase broadphase;
+	btSequentialImpulseConstraintSolver solver;
+	btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &config);
+
+	btBoxShape groundShape(btVector3(50, 1, 50));
+	btRigidBody ground(0, 0, &groundShape);
+	ground.getWorldTransform().setOrigin(btVector3(0, -1, 0));
+	world.addRigidBody(&ground);
+
+	btBoxShape cube(btVector3(btScalar(0.25), btScalar(0.25), btScalar(0.25)));
+	btCompoundShape slabShape;
+	AddSlabChildren(slabShape, &cube);
+	btVector3 slabInertia;
+	slabShape.calculateLocalInertia(10, slabInertia);
+
+	btAlignedObjectArray<btRigidBody*> slabs;
+	for (int i = 0; i < 2; i++)
+	{
+		btRigidBody::btRigidBodyConstructionInfo info(10, 0, &slabShape, slabInertia);
+		info.m_startWorldTransform.setRotation(btQuaternion(btVector3(0, 1, 0), btScalar(0.3) * i));
+		info.m_startWorldTransform.setOrigin(btVector3(btScalar(0.2) * i, btScalar(0.26) + btScalar(0.6) * i, 0));
+		btRigidBody* slab = new btRigidBody(info);
+		world.addRigidBody(slab);
+		slabs.push_back(slab);
+	}
+
+	for (int step = 0; step < 60; step++)
+	{
+		world.stepSimulation(btScalar(1. / 60.), 0);
+	}
+
+	for (int i = 0; i < dispatcher.getNumManifolds(); i++)
+	{
+		numContacts.push_back(dispatcher.getManifoldByIndexInternal(i)->getNumContacts());
+	}
+	for (int i = 0; i < slabs.size(); i++)
+	{
+		slabTransforms.push_back(slabs[i]->getWorldTransform());
+		world.removeRigidBody(slabs[i]);
+		delete slabs[i];
+	}
+	world.removeRigidBody(&ground);
+}
+
+GTEST_TEST(BulletDynamics, CompoundParallel_MatchesSequential)
+{
+	btITaskScheduler* previousScheduler = btGetTaskScheduler();
+	btSetTaskScheduler(btGetSequentialTaskScheduler());
+	btAlignedObjectArray<btTransform> sequentialTransforms;
+	btAlignedObjectArray<int> sequentialContacts;
+	SimulateSlabs(sequentialTransforms, sequentialContacts);
+
+	btITaskScheduler* scheduler = SetThreadedScheduler();
+	btAlignedObjectArray<btTransform> threadedTransforms;
+	btAlignedObjectArray<int> threadedContacts;
+	SimulateSlabs(threadedTransforms, threadedContacts);
+	btSetTaskScheduler(previousScheduler);
+	delete scheduler;
+
+	// enough touching pieces for the threaded children
+	EXPECT_GT(sequentialContacts.size(), btCompoundCollisionAlgorithm::s_minimumChildrenForParallel);
+	ASSERT_EQ(sequentialContacts.size(), threadedContacts.size());
+	for (int i = 0; i < sequentialContacts.size(); i++)
+	{
+		EXPECT_EQ(sequentialContacts[i], threadedContacts[i]) << i;
+	}
+
+	ASSERT_EQ(2, threadedTransforms.size());
+	for (int i = 0; i < threadedTransforms.size(); i++)
+	{
+		EXPECT_TRUE(sequentialTransforms[i].getOrigin() == threadedTransforms[i].getOrigin()) << i;
+		EXPECT_TRUE(sequentialTransforms[i].getBasis() == threadedTransforms[i].getBasis()) << i;
+
+		// resting flat, the upper slab on the lower one
+		EXPECT_NEAR(btScalar(0.25) + btScalar(0.5) * i, threadedTransforms[i].getOrigin().y(), 0.05) << i;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,327 @@
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/CollisionDispatch/btConvexConcaveCollisionAlgorithm.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletCollision/CollisionShapes/btTriangleShape.h>
+#include <LinearMath/btThreads.h>
+#include <gtest/gtest.h>
+
+#define GRID_SIZE 64
+#define GRID_SPACING 0.125
+
+static int gNumTriangleContactsAdded = 0;
+
+static bool CountTriangleContacts(btManifoldPoint& cp, const btCollisionObjectWrapper* colObj0Wrap, int partId0, int index0, const btCollisionObjectWrapper* colObj1Wrap, int partId1, int index1)
+{
+	if (colObj1Wrap->getCollisionShape()->getShapeType() == TRIANGLE_SHAPE_PROXYTYPE && index1 >= 0)
+	{
+		gNumTriangleContactsAdded++;
+	}
+	return false;
+}
+
+struct DenseMesh
+{
+	btAlignedObjectArray<btVector3> m_vertices;
+	btAlignedObjectArray<int> m_indices;
+	btTriangleIndexVertexArray* m_meshInterface;
+	btBvhTriangleMeshShape* m_shape;
+
+	DenseMesh()
+	{
+		for (int i = 0; i <= GRID_SIZE; i++)
+		{
+			for (int j = 0; j <= GRID_SIZE; j++)
+			{
+				btScalar x = (i - GRID_SIZE / 2) * GRID_SPACING;
+				btScalar y = (j - GRID_SIZE / 2) * GRID_SPACING;
+				m_vertices.push_back(btVector3(x, y, 0.02 * btSin(3 * x) * btCos(2 * y)));
+			}
+		}
+		for (int i = 0; i < GRID_SIZE; i++)
+		{
+			for (int j = 0; j < GRID_SIZE; j++)
+			{
+				int v = i * (GRID_SIZE + 1) + j;
+				m_indices.push_back(v);
+				m_indices.push_back(v + GRID_SIZE + 1);
+				m_indices.push_back(v + 1);
+				m_indices.push_back(v + 1);
+				m_indices.push_back(v + GRID_SIZE + 1);
+				m_indices.push_back(v + GRID_SIZE + 2);
+			}
+		}
+		m_meshInterface = new btTriangleIndexVertexArray(m_indices.size() / 3, &m_indices[0], 3 * sizeof(int), m_vertices.size(), &m_vertices[0][0], sizeof(btVector3));
+		m_shape = new btBvhTriangleMeshShape(m_meshInterface, true);
+	}
+
+	~DenseMesh()
+	{
+		delete m_shape;
+		delete m_meshInterface;
+	}
+};
+
+static void CollideWithMesh(btCollisionDispatcher* dispatcher, btCollisionObject* convexObj, btCollisionObject* meshObj, btAlignedObjectArray<btManifoldPoint>& contacts, bool reduceContacts = false)
+{
+	btCollisionObjectWrapper convexWrap(0, convexObj->getCollisionShape(), convexObj, convexObj->getWorldTransform(), -1, -1);
+	btCollisionObjectWrapper meshWrap(0, meshObj->getCollisionShape(), meshObj, meshObj->getWorldTransform(), -1, -1);
+	btCollisionAlgorithm* algorithm = dispatcher->findAlgorithm(&convexWrap, &meshWrap, 0, BT_CONTACT_POINT_ALGORITHMS);
+	btDispatcherInfo dispatchInfo;
+	dispatchInfo.m_reduceMeshContacts = reduceContacts;
+	btManifoldResult result(&convexWrap, &meshWrap);
+	algorithm->processCollision(&convexWrap, &meshWrap, dispatchInfo, &result);
+
+	const btPersistentManifold* manifold = result.getPersistentManifold();
+	contacts.resize(0);
+	for (int i = 0; i < manifold->getNumContacts(); i++)
+	{
+		contacts.push_back(manifold->getContactPoint(i));
+	}
+	algorithm->~btCollisionAlgorithm();
+	dispatcher->freeCollisionAlgorithm(algorithm);
+}
+
+// a large box resting on a dense mesh overlaps hundreds of triangles. Processing them in parallel gives the same manifold
+// as processing them in sequence, and the contact added callback still sees each triangle
+GTEST_TEST(BulletCollision, ConvexConcaveParallelTriangles)
+{
+	DenseMesh mesh;
+	btCollisionObject meshObj;
+	meshObj.setCollisionShape(mesh.m_shape);
+	meshObj.setCollisionFlags(meshObj.getCollisionFlags() | btCollisionObject::CF_CUSTOM_MATERIAL_CALLBACK);
+
+	btBoxShape boxShape(btVector3(2, 2, 0.5));
+	btCollisionObject boxObj;
+	boxObj.setCollisionShape(&boxShape);
+	boxObj.setWorldTransform(btTransform(btQuaternion(btVector3(0, 0, 1), 0.3), btVector3(0.1, 0.2, 0.5)));
+
+	btDefaultCollisionConfiguration configuration;
+	btCollisionDispatcher dispatcher(&configuration);
+	gContactAddedCallback = CountTriangleContacts;
+
+	btITaskScheduler* previousScheduler = btGetTaskScheduler();
+	btSetTaskScheduler(btGetSequentialTaskScheduler());
+	btAlignedObjectArray<btManifoldPoint> sequentialContacts;
+	gNumTriangleContactsAdded = 0;
+	CollideWithMesh(&dispatcher, &boxObj, &meshObj, sequentialContacts);
+	int numSequentialContactsAdded = gNumTriangleContactsAdded;
+
+	btITaskScheduler* scheduler = btCreateDefaultTaskScheduler();
+	if (scheduler)
+	{
+		scheduler->setNumThreads(btMin(4, scheduler->getMaxNumThreads()));
+		btSetTaskScheduler(scheduler);
+	}
+	btAlignedObjectArray<btManifoldPoint> parallelContacts;
+	gNumTriangleContactsAdded = 0;
+	CollideWithMesh(&dispatcher, &boxObj, &meshObj, parallelContacts);
+	int numParallelContactsAdded = gNumTriangleContactsAdded;
+
+	btSetTaskScheduler(previousScheduler);
+	delete scheduler;
+	gContactAddedCallback = 0;
+
+	EXPECT_GT(numSequentialContactsAdded, btConvexConcaveCollisionAlgorithm::s_minimumTrianglesForParallel);
+	EXPECT_EQ(numSequentialContactsAdded, numParallelContactsAdded);
+	ASSERT_EQ(4, sequentialContacts.size());
+	ASSERT_EQ(sequentialContacts.size(), parallelContacts.size());
+	for (int i = 0; i < sequentialContacts.size(); i++)
+	{
+		const btManifoldPoint& expected = sequentialContacts[i];
+		const btManifoldPoint& actual = parallelContacts[i];
+		EXPECT_EQ(expected.m_index1, actual.m_index1);
+		EXPECT_NEAR(expected.getDistance(), actual.getDistance(), 1e-6);
+		EXPECT_NEAR(0, (expected.m_positionWorldOnB - actual.m_positionWorldOnB).length(), 1e-6);
+	}
+}
+
+// with contact reduction, only the reduced contacts reach the manifold. They keep the deepest point and span the face of the box
+GTEST_TEST(BulletCollision, ConvexConcaveContactReduction)
+{
+	DenseMesh mesh;
+	btCollisionObject meshObj;
+	meshObj.setCollisionShape(mesh.m_shape);
+	meshObj.setCollisionFlags(meshObj.getCollisionFlags() | btCollisionObject::CF_CUSTOM_MATERIAL_CALLBACK);
+
+	btBoxShape boxShape(btVector3(2, 2, 0.5));
+	btCollisionObject boxObj;
+	boxObj.setCollisionShape(&boxShape);
+	boxObj.setWorldTransform(btTransform(btQuaternion(btVector3(0, 0, 1), 0.3), btVector3(0.1, 0.2, 0.5)));
+
+	btDefaultCollisionConfiguration configuration;
+	btCollisionDispatcher dispatcher(&configuration);
+	gContactAddedCallback = CountTriangleContacts;
+
+	btAlignedObjectArray<btManifoldPoint> contacts;
+	gNumTriangleContactsAdded = 0;
+	CollideWithMesh(&dispatcher, &boxObj, &meshObj, contacts);
+	btScalar minDistance = SIMD_INFINITY;
+	for (int i = 0; i < contacts.size(); i++)
+	{
+		minDistance = btMin(minDistance, contacts[i].getDistance());
+	}
+	EXPECT_GT(gNumTriangleContactsAdded, MANIFOLD_CACHE_SIZE);
+
+	btAlignedObjectArray<btManifoldPoint> reducedContacts;
+	gNumTriangleContactsAdded = 0;
+	CollideWithMesh(&dispatcher, &boxObj, &meshObj, reducedContacts, true);
+	gContactAddedCallback = 0;
+
+	EXPECT_EQ(MANIFOLD_CACHE_SIZE, gNumTriangleContactsAdded);
+	ASSERT_EQ(MANIFOLD_CACHE_SIZE, reducedContacts.size());
+	btScalar reducedMinDistance = SIMD_INFINITY;
+	for (int i = 0; i < reducedContacts.size(); i++)
+	{
+		reducedMinDistance = btMin(reducedMinDistance, reducedContacts[i].getDistance());
+		for (int j = 0; j < i; j++)
+		{
+			EXPECT_GT((reducedContacts[i].m_positionWorldOnB - reducedContacts[j].m_positionWorldOnB).length(), 2);
+		}
+	}
+	EXPECT_NEAR(minDistance, reducedMinDistance, 1e-6);
+}
+
+// a box sliding slowly over the mesh replaces fewer manifold points with reduction, although the contacts move to other triangles
+GTEST_TEST(BulletCollision, ConvexConcaveContactReductionPersistence)
+{
+	DenseMesh mesh;
+	btCollisionObject meshObj;
+	meshObj.setCollisionShape(mesh.m_shape);
+
+	btBoxShape boxShape(btVector3(1, 1, 0.5));
+	btCollisionObject boxObj;
+	boxObj.setCollisionShape(&boxShape);
+	btTransform boxTrans(btQuaternion(btVector3(0, 0, 1), 0.3), btVector3(0.1, 0.2, 0.5));
+	boxObj.setWorldTransform(boxTrans);
+
+	btDefaultCollisionConfiguration configuration;
+	btCollisionDispatcher dispatcher(&configuration);
+	btCollisionObjectWrapper boxWrap(0, &boxShape, &boxObj, boxObj.getWorldTransform(), -1, -1);
+	btCollisionObjectWrapper meshWrap(0, mesh.m_shape, &meshObj, meshObj.getWorldTransform(), -1, -1);
+
+	int numNewPoints[2];
+	for (int reduce = 0; reduce < 2; reduce++)
+	{
+		btCollisionAlgorithm* algorithm = dispatcher.findAlgorithm(&boxWrap, &meshWrap, 0, BT_CONTACT_POINT_ALGORITHMS);
+		btDispatcherInfo dispatchInfo;
+		dispatchInfo.m_reduceMeshContacts = reduce != 0;
+		numNewPoints[reduce] = 0;
+		for (int frame = 0; frame < 60; frame++)
+		{
+			boxTrans.setOrigin(btVector3(0.1 + 0.004 * frame, 0.2, 0.5));
+			boxObj.setWorldTransform(boxTrans);
+			btManifoldResult result(&boxWrap, &meshWrap);
+			algorithm->processCollision(&boxWrap, &meshWrap, dispatchInfo, &result);
+			const btPersistentManifold* manifold = result.getPersistentManifold();
+			EXPECT_GE(manifold->getNumContacts(), MANIFOLD_CACHE_SIZE - 1);
+			for (int i = 0; frame > 0 && i < manifold->getNumContacts(); i++)
+			{
+				numNewPoints[reduce] += manifold->getContactPoint(i).getLifeTime() == 1;
+			}
+		}
+		algorithm->~btCollisionAlgorithm();
+		dispatcher.freeCollisionAlgorithm(algorithm);
+	}
+	EXPECT_LT(numNewPoints[1], numNewPoints[0]);
+}
+
+#define NUM_GRID_BOXES 64
+
+///a grid of boxes resting on the dense mesh. Returns the contacts of each box with the mesh, in the order of the boxes
+static void CollideBoxGridWithMesh(btCollisionDispatcher* dispatcher, btCollisionConfiguration* configuration, bool reduceContacts, btAlignedObjectArray<btAlignedObjectArray<btManifoldPoint> >& contacts)
+{
+	DenseMesh mesh;
+	btCollisionObject meshObj;
+	meshObj.setCollisionShape(mesh.m_shape);
+	btBoxShape boxShape(btVector3(0.45, 0.45, 0.5));
+	btCollisionObject boxObjs[NUM_GRID_BOXES];
+
+	btDbvtBroadphase broadphase;
+	btCollisionWorld world(dispatcher, &broadphase, configuration);
+	world.getDispatchInfo().m_reduceMeshContacts = reduceContacts;
+	world.addCollisionObject(&meshObj);
+	for (int i = 0; i < NUM_GRID_BOXES; i++)
+	{
+		boxObjs[i].setCollisionShape(&boxShape);
+		boxObjs[i].setWorldTransform(btTransform(btQuaternion(btVector3(0, 0, 1), 0.1 * i), btVector3((i % 8) - 3.5, (i / 8) - 3.5, 0.5)));
+		world.addCollisionObject(&boxObjs[i]);
+	}
+	world.performDiscreteCollisionDetection();
+
+	contacts.resize(0);
+	contacts.resize(NUM_GRID_BOXES);
+	for (int i = 0; i < dispatcher->getNumManifolds(); i++)
+	{
+		const btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+		if (manifold->getBody0() != &meshObj && manifold->getBody1() != &meshObj)
+			continue;
+		const btCollisionObject* boxObj = manifold->getBody0() == &meshObj ? manifold->getBody1() : manifold->getBody0();
+		btAlignedObjectArray<btManifoldPoint>& boxContacts = contacts[int(boxObj - boxObjs)];
+		for (int j = 0; j < manifold->getNumContacts(); j++)
+		{
+			boxContacts.push_back(manifold->getContactPoint(j));
+		}
+	}
+
+	for (int i = 0; i < NUM_GRID_BOXES; i++)
+	{
+		world.removeCollisionObject(&boxObjs[i]);
+	}
+	world.removeCollisionObject(&meshObj);
+}
+
+// btCollisionDispatcherMt collides the pairs on worker threads. The buffered triangles of a pair, processed on the worker
+// or in a nested parallel loop, give the same manifolds as the sequential dispatcher
+GTEST_TEST(BulletCollision, ConvexConcaveDispatcherMt)
+{
+	btDefaultCollisionConfiguration configuration;
+	btITaskScheduler* previousScheduler = btGetTaskScheduler();
+	btSetTaskScheduler(btGetSequentialTaskScheduler());
+	btAlignedObjectArray<btAlignedObjectArray<btManifoldPoint> > sequentialContacts[2];
+	for (int reduce = 0; reduce < 2; reduce++)
+	{
+		btCollisionDispatcher dispatcher(&configuration);
+		CollideBoxGridWithMesh(&dispatcher, &configuration, reduce != 0, sequentialContacts[reduce]);
+	}
+
+	btITaskScheduler* scheduler = btCreateDefaultTaskScheduler();
+	if (scheduler)
+	{
+		scheduler->setNumThreads(btMin(4, scheduler->getMaxNumThreads()));
+		btSetTaskScheduler(scheduler);
+	}
+	const bool allowNestedParallelForLoops = btConvexConcaveCollisionAlgorithm::s_allowNestedParallelForLoops;
+	for (int nested = 0; nested < 2; nested++)
+	{
+		btConvexConcaveCollisionAlgorithm::s_allowNestedParallelForLoops = nested != 0;
+		for (int reduce = 0; reduce < 2; reduce++)
+		{
+			btCollisionDispatcherMt dispatcher(&configuration, 1);
+			btAlignedObjectArray<btAlignedObjectArray<btManifoldPoint> > contacts;
+			CollideBoxGridWithMesh(&dispatcher, &configuration, reduce != 0, contacts);
+
+			for (int i = 0; i < NUM_GRID_BOXES; i++)
+			{
+				const btAlignedObjectArray<btManifoldPoint>& expected = sequentialContacts[reduce][i];
+				const btAlignedObjectArray<btManifoldPoint>& actual = contacts[i];
+				EXPECT_EQ(MANIFOLD_CACHE_SIZE, expected.size()) << "box " << i;
+				ASSERT_EQ(expected.size(), actual.size()) << "box " << i << " nested " << nested << " reduce " << reduce;
+				for (int j = 0; j < expected.size(); j++)
+				{
+					EXPECT_EQ(expected[j].m_index1, actual[j].m_index1) << "box " << i;
+					EXPECT_NEAR(expected[j].getDistance(), actual[j].getDistance(), 1e-6) << "box " << i;
+					EXPECT_NEAR(0, (expected[j].m_positionWorldOnB - actual[j].m_positionWorldOnB).length(), 1e-6) << "box " << i;
+				}
+			}
+		}
+	}
+	btConvexConcaveCollisionAlgorithm::s_allowNestedParallelForLoops = allowNestedParallelForLoops;
+	btSetTaskScheduler(previousScheduler);
+	delete scheduler;
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,172 @@
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/CollisionShapes/btConvexHullShape.h>
+#include <gtest/gtest.h>
+#include "ClosestContactCallback.h"
+
+// shapes with a half extent of 0.5 along z, including the margin of the hulls.
+// The hull is a cube whose points are offset from its origin
+struct PairShapes
+{
+	btSphereShape m_sphere;
+	btBoxShape m_box;
+	btCapsuleShapeZ m_capsule;
+	btCylinderShapeZ m_cylinder;
+	btConvexHullShape m_hull;
+	btConvexShape* m_shapes[5];
+	btVector3 m_offsets[5];
+
+	PairShapes()
+		: m_sphere(0.5),
+		  m_box(btVector3(0.5, 0.5, 0.5)),
+		  m_capsule(0.3, 0.4),
+		  m_cylinder(btVector3(0.5, 0.5, 0.5))
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			m_hull.addPoint(btVector3(i & 1 ? 1.46 : 0.54, i & 2 ? 0.46 : -0.46, i & 4 ? 0.46 : -0.46), false);
+		}
+		m_hull.recalcLocalAabb();
+		btConvexShape* shapes[5] = {&m_sphere, &m_box, &m_capsule, &m_cylinder, &m_hull};
+		for (int i = 0; i < 5; i++)
+		{
+			m_shapes[i] = shapes[i];
+			m_offsets[i] = btVector3(i == 4 ? -1 : 0, 0, 0);
+		}
+	}
+};
+
+///each pair is stacked along z, then the whole configuration is moved by pose
+static void TestPairMatrix(int convexConvexAlgorithm, const btTransform& pose = btTransform::getIdentity())
+{
+	btDefaultCollisionConstructionInfo constructionInfo;
+	constructionInfo.m_convexConvexAlgorithm = convexConvexAlgorithm;
+	btDefaultCollisionConfiguration configuration(constructionInfo);
+	btCollisionDispatcher dispatcher(&configuration);
+	btDbvtBroadphase broadphase;
+	btCollisionWorld world(&dispatcher, &broadphase, &configuration);
+	PairShapes shapes;
+
+	// separated within the closest distance threshold, slightly penetrating, and deeper than the margins
+	const btScalar gaps[3] = {0.05, -0.02, -0.2};
+	const btVector3 up = pose.getBasis().getColumn(2);
+	for (int i = 0; i < 5; i++)
+	{
+		for (int j = 0; j < 5; j++)
+		{
+			for (int k = 0; k < 3; k++)
+			{
+				btCollisionObject objA, objB;
+				objA.setCollisionShape(shapes.m_shapes[i]);
+				objB.setCollisionShape(shapes.m_shapes[j]);
+				objA.setWorldTransform(pose * btTransform(btQuaternion::getIdentity(), shapes.m_offsets[i] + btVector3(0, 0, 1 + gaps[k])));
+				objB.setWorldTransform(pose * btTransform(btQuaternion::getIdentity(), shapes.m_offsets[j]));
+
+				ClosestContactCallback callback;
+				world.contactPairTest(&objA, &objB, callback);
+				ASSERT_GT(callback.m_numContacts, 0) << "pair " << i << "," << j << " gap " << gaps[k];
+				EXPECT_NEAR(gaps[k], callback.m_distance, 0.01) << "pair " << i << "," << j;
+				EXPECT_GT(callback.m_normalOnB.dot(up), 0.99) << "pair " << i << "," << j << " gap " << gaps[k];
+
+				// the point on B lies between the bottom of A and the top of B, all footprints are centered on the z axis
+				btVector3 pointInB = pose.invXform(callback.m_pointOnB);
+				EXPECT_GT(pointInB.z(), btMin(btScalar(0.5), btScalar(0.5) + gaps[k]) - btScalar(0.02)) << "pair " << i << "," << j << " gap " << gaps[k];
+				EXPECT_LT(pointInB.z(), btMax(btScalar(0.5), btScalar(0.5) + gaps[k]) + btScalar(0.02)) << "pair " << i << "," << j << " gap " << gaps[k];
+				EXPECT_LT(btFabs(pointInB.x()), 0.52) << "pair " << i << "," << j << " gap " << gaps[k];
+				EXPECT_LT(btFabs(pointInB.y()), 0.52) << "pair " << i << "," << j << " gap " << gaps[k];
+			}
+		}
+	}
+}
+
+static btScalar SimulateHullStack(int convexConvexAlgorithm, btScalar& maxSpeed)
+{
+	btDefaultCollisionConstructionInfo constructionInfo;
+	constructionInfo.m_convexConvexAlgorithm = convexConvexAlgorithm;
+	btDefaultCollisionConfiguration configuration(constructionInfo);
+	btCollisionDispatcher dispatcher(&configuration);
+	btDbvtBroadphase broadphase;
+	btSequentialImpulseConstraintSolver solver;
+	btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &configuration);
+	world.setGravity(btVector3(0, 0, -10));
+
+	btBoxShape groundShape(btVector3(10, 10, 1));
+	btRigidBody ground(0, 0, &groundShape);
+	ground.setWorldTransform(btTransform(btQuaternion::getIdentity(), btVector3(0, 0, -1)));
+	world.addRigidBody(&ground);
+
+	btConvexHullShape hull;
+	for (int i = 0; i < 8; i++)
+	{
+		hull.addPoint(btVector3(i & 1 ? 0.46 : -0.46, i & 2 ? 0.46 : -0.46, i & 4 ? 0.46 : -0.46), false);
+	}
+	hull.recalcLocalAabb();
+	btVector3 inertia;
+	hull.calculateLocalInertia(1, inertia);
+
+	btRigidBody* boxes[2];
+	for (int i = 0; i < 2; i++)
+	{
+		boxes[i] = new btRigidBody(1, 0, &hull, inertia);
+		boxes[i]->setWorldTransform(btTransform(btQuaternion::getIdentity(), btVector3(0, 0, 0.55 + 1.05 * i)));
+		world.addRigidBody(boxes[i]);
+	}
+
+	for (int i = 0; i < 240; i++)
+	{
+		world.stepSimulation(1. / 60., 0);
+	}
+
+	maxSpeed = 0;
+	for (int i = 0; i < 2; i++)
+	{
+		maxSpeed = btMax(maxSpeed, boxes[i]->getLinearVelocity().length());
+	}
+	btScalar height = boxes[1]->getWorldTransform().getOrigin().z();
+	for (int i = 0; i < 2; i++)
+	{
+		world.removeRigidBody(boxes[i]);
+		delete boxes[i];
+	}
+	world.removeRigidBody(&ground);
+	return height;
+}
+
+GTEST_TEST(BulletCollision, ConvexConvexMprPairs)
+{
+	TestPairMatrix(BT_CONVEX_CONVEX_GJK_PAIR_DETECTOR);
+	TestPairMatrix(BT_CONVEX_CONVEX_GJK_MPR);
+	TestPairMatrix(BT_CONVEX_CONVEX_GJK_EPA3);
+}
+
+// the normals and points are in world space when the shapes are rotated
+GTEST_TEST(BulletCollision, ConvexConvexMprRotatedPairs)
+{
+	const btTransform poses[2] = {
+		btTransform(btQuaternion(btVector3(1, 2, 3).normalized(), 0.7), btVector3(0.3, -0.2, 0.5)),
+		btTransform(btQuaternion(btVector3(1, 0, 0), SIMD_HALF_PI), btVector3(0, 2, 0))};
+	for (int i = 0; i < 2; i++)
+	{
+		TestPairMatrix(BT_CONVEX_CONVEX_GJK_PAIR_DETECTOR, poses[i]);
+		TestPairMatrix(BT_CONVEX_CONVEX_GJK_MPR, poses[i]);
+		TestPairMatrix(BT_CONVEX_CONVEX_GJK_EPA3, poses[i]);
+	}
+}
+
+GTEST_TEST(BulletCollision, ConvexConvexMprStack)
+{
+	const int algorithms[2] = {BT_CONVEX_CONVEX_GJK_MPR, BT_CONVEX_CONVEX_GJK_EPA3};
+	for (int i = 0; i < 2; i++)
+	{
+		// two unit cubes come to rest on the ground
+		btScalar maxSpeed;
+		btScalar height = SimulateHullStack(algorithms[i], maxSpeed);
+		EXPECT_NEAR(1.5, height, 0.05) << "algorithm " << algorithms[i];
+		EXPECT_LT(maxSpeed, 0.05) << "algorithm " << algorithms[i];
+	}
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,122 @@
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/CollisionDispatch/btConvexConvexSpecializedAlgorithm.h>
+#include <gtest/gtest.h>
+#include "ClosestContactCallback.h"
+
+struct SpecializedWorld
+{
+	btDefaultCollisionConfiguration m_configuration;
+	btCollisionDispatcher m_dispatcher;
+	btDbvtBroadphase m_broadphase;
+	btCollisionWorld m_world;
+
+	SpecializedWorld(bool specialized)
+		: m_dispatcher(&m_configuration),
+		  m_world(&m_dispatcher, &m_broadphase, &m_configuration)
+	{
+		if (specialized)
+		{
+			btConvexConvexSpecializedAlgorithmBase::registerAlgorithms(&m_dispatcher);
+		}
+	}
+};
+
+// the closest points of the specialized algorithms match btConvexConvexAlgorithm, for separated and penetrating poses
+GTEST_TEST(BulletCollision, ConvexConvexSpecializedPairs)
+{
+	btSphereShape sphere(0.5);
+	btBoxShape box(btVector3(0.5, 0.4, 0.3));
+	btCapsuleShapeX capsule(0.3, 0.6);
+	btCylinderShapeZ cylinder(btVector3(0.4, 0.4, 0.5));
+	btConvexHullShape hull;
+	for (int i = 0; i < 8; i++)
+	{
+		hull.addPoint(btVector3(i & 1 ? 0.8 : 0.2, i & 2 ? 0.4 : -0.4, i & 4 ? 0.3 : -0.3), false);
+	}
+	hull.recalcLocalAabb();
+	btCollisionShape* shapes[5] = {&sphere, &box, &capsule, &cylinder, &hull};
+
+	SpecializedWorld reference(false);
+	SpecializedWorld specialized(true);
+
+	const btScalar distances[4] = {1.2, 0.9, 0.7, 0.4};
+	for (int i = 0; i < 5; i++)
+	{
+		for (int j = 0; j < 5; j++)
+		{
+			for (int k = 0; k < 4; k++)
+			{
+				btCollisionObject objA, objB;
+				objA.setCollisionShape(shapes[i]);
+				objB.setCollisionShape(shapes[j]);
+				btQuaternion orientation(btVector3(1, 1, 0).normalized(), 0.3 * k);
+				objA.setWorldTransform(btTransform(orientation, btVector3(0.2, 0.1, 1).normalized() * distances[k]));
+				objB.setWorldTransform(btTransform::getIdentity());
+
+				ClosestContactCallback expected;
+				reference.m_world.contactPairTest(&objA, &objB, expected);
+				ClosestContactCallback actual;
+				specialized.m_world.contactPairTest(&objA, &objB, actual);
+
+				// btConvexConvexAlgorithm also reports closest points beyond the distance threshold
+				if (expected.m_numContacts && expected.m_distance < expected.m_closestDistanceThreshold)
+				{
+					ASSERT_GT(actual.m_numContacts, 0) << "pair " << i << "," << j << " pose " << k;
+					EXPECT_NEAR(expected.m_distance, actual.m_distance, 0.01) << "pair " << i << "," << j << " pose " << k;
+					EXPECT_GT(expected.m_normalOnB.dot(actual.m_normalOnB), 0.98) << "pair " << i << "," << j << " pose " << k;
+				}
+			}
+		}
+	}
+}
+
+// a box resting on a convex hull gets its four contact points from polyhedral clipping, in a single step.
+// Like btConvexConvexAlgorithm, the contacts between polyhedra ignore the margin of the hull
+GTEST_TEST(BulletCollision, ConvexConvexSpecializedClipping)
+{
+	btDefaultCollisionConfiguration configuration;
+	btCollisionDispatcher dispatcher(&configuration);
+	btConvexConvexSpecializedAlgorithmBase::registerAlgorithms(&dispatcher);
+	btDbvtBroadphase broadphase;
+	btSequentialImpulseConstraintSolver solver;
+	btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &configuration);
+	world.setGravity(btVector3(0, 0, -10));
+
+	btConvexHullShape groundShape;
+	for (int i = 0; i < 8; i++)
+	{
+		groundShape.addPoint(btVector3(i & 1 ? 5 : -5, i & 2 ? 5 : -5, i & 4 ? 0 : -1), false);
+	}
+	groundShape.recalcLocalAabb();
+	groundShape.initializePolyhedralFeatures();
+	btRigidBody ground(0, 0, &groundShape);
+	world.addRigidBody(&ground);
+
+	btBoxShape boxShape(btVector3(0.5, 0.5, 0.5));
+	boxShape.initializePolyhedralFeatures();
+	btVector3 inertia;
+	boxShape.calculateLocalInertia(1, inertia);
+	btRigidBody box(1, 0, &boxShape, inertia);
+	box.setWorldTransform(btTransform(btQuaternion::getIdentity(), btVector3(0, 0, 0.49)));
+	world.addRigidBody(&box);
+
+	world.stepSimulation(1. / 60., 0);
+	ASSERT_EQ(1, dispatcher.getNumManifolds());
+	EXPECT_EQ(4, dispatcher.getManifoldByIndexInternal(0)->getNumContacts());
+
+	for (int i = 0; i < 120; i++)
+	{
+		world.stepSimulation(1. / 60., 0);
+	}
+	EXPECT_NEAR(0.5, box.getWorldTransform().getOrigin().z(), 0.02);
+	EXPECT_GT(box.getWorldTransform().getBasis()[2][2], 0.999);
+
+	world.removeRigidBody(&box);
+	world.removeRigidBody(&ground);
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,241 @@
+#include <btBulletDynamicsCommon.h>
+#include <gtest/gtest.h>
+
+///two bevelled cubes, slightly rotated, settle on a hull ground with the separating axis test
+static void SimulateHullStack(btDispatcherInfo* dispatchInfo, btAlignedObjectArray<btVector4>& contacts)
+{
+	btDefaultCollisionConfiguration configuration;
+	btCollisionDispatcher dispatcher(&configuration);
+	btDbvtBroadphase broadphase;
+	btSequentialImpulseConstraintSolver solver;
+	btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &configuration);
+	world.setGravity(btVector3(0, 0, -10));
+	if (dispatchInfo)
+	{
+		world.getDispatchInfo() = *dispatchInfo;
+	}
+	world.getDispatchInfo().m_enableSatConvex = true;
+
+	btConvexHullShape groundShape;
+	for (int i = 0; i < 8; i++)
+	{
+		groundShape.addPoint(btVector3(i & 1 ? 5 : -5, i & 2 ? 5 : -5, i & 4 ? 0 : -1), false);
+	}
+	groundShape.recalcLocalAabb();
+	groundShape.initializePolyhedralFeatures();
+	btRigidBody ground(0, 0, &groundShape);
+	world.addRigidBody(&ground);
+
+	btConvexHullShape hull;
+	for (int i = 0; i < 24; i++)
+	{
+		btVector3 point(i & 1 ? 0.5 : -0.5, i & 2 ? 0.5 : -0.5, i & 4 ? 0.5 : -0.5);
+		point[(i >> 3) % 3] *= btScalar(0.8);
+		hull.addPoint(point, false);
+	}
+	hull.recalcLocalAabb();
+	hull.initializePolyhedralFeatures();
+	btVector3 inertia;
+	hull.calculateLocalInertia(1, inertia);
+
+	btRigidBody* boxes[2];
+	for (int i = 0; i < 2; i++)
+	{
+		boxes[i] = new btRigidBody(1, 0, &hull, inertia);
+		boxes[i]->setWorldTransform(btTransform(btQuaternion(btVector3(1, 2, 3).normalized(), 0.05 + 0.1 * i), btVector3(0.1 * i, 0, 0.55 + 1.05 * i)));
+		world.addRigidBody(boxes[i]);
+	}
+
+	for (int i = 0; i < 30; i++)
+	{
+		world.stepSimulation(1. / 60., 0);
+	}
+
+	for (int i = 0; i < dispatcher.getNumManifolds(); i++)
+	{
+		const btPersistentManifold* manifold = dispatcher.getManifoldByIndexInternal(i);
+		for (int j = 0; j < manifold->getNumContacts(); j++)
+		{
+			const btManifoldPoint& pt = manifold->getContactPoint(j);
+			contacts.push_back(btVector4(pt.getPositionWorldOnB().x(), pt.getPositionWorldOnB().y(), pt.getPositionWorldOnB().z(), pt.getDistance()));
+		}
+	}
+	for (int i = 0; i < 2; i++)
+	{
+		world.removeRigidBody(boxes[i]);
+		delete boxes[i];
+	}
+	world.removeRigidBody(&ground);
+}
+
+// the option is off by default, and explicitly disabling it doesn't change the contacts
+GTEST_TEST(BulletCollision, ConvexFeatureCacheOffByDefault)
+{
+	EXPECT_FALSE(btDispatcherInfo().m_useConvexFeatureCache);
+
+	btAlignedObjectArray<btVector4> contacts;
+	SimulateHullStack(0, contacts);
+	ASSERT_GT(contacts.size(), 0);
+
+	btDispatcherInfo dispatchInfo;
+	dispatchInfo.m_useConvexFeatureCache = false;
+	btAlignedObjectArray<btVector4> disabledContacts;
+	SimulateHullStack(&dispatchInfo, disabledContacts);
+	ASSERT_EQ(contacts.size(), disabledContacts.size());
+	for (int i = 0; i < contacts.size(); i++)
+	{
+		EXPECT_TRUE(contacts[i] == disabledContacts[i]) << "contact " << i;
+	}
+}
+
+// a collision world that replays the poses of a simulation, to compare the contacts of two dispatch settings
+struct HullStackReplay
+{
+	btDefaultCollisionConfiguration m_configuration;
+	btCollisionDispatcher m_dispatcher;
+	btDbvtBroadphase m_broadphase;
+	btCollisionWorld m_world;
+	btCollisionObject m_objects[3];
+
+	HullStackReplay(btCollisionObject* const* sources, bool useConvexFeatureCache)
+		: m_dispatcher(&m_configuration),
+		  m_world(&m_dispatcher, &m_broadphase, &m_configuration)
+	{
+		m_world.getDispatchInfo().m_enableSatConvex = true;
+		m_world.getDispatchInfo().m_useConvexFeatureCache = useConvexFeatureCache;
+		for (int i = 0; i < 3; i++)
+		{
+			m_objects[i].setCollisionShape(sources[i]->getCollisionShape());
+			m_objects[i].setWorldTransform(sources[i]->getWorldTransform());
+			m_world.addCollisionObject(&m_objects[i]);
+		}
+	}
+
+	~HullStackReplay()
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			m_world.removeCollisionObject(&m_objects[i]);
+		}
+	}
+
+	void update(btCollisionObject* const* sources)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			m_objects[i].setWorldTransform(sources[i]->getWorldTransform());
+		}
+		m_world.performDiscreteCollisionDetection();
+	}
+
+	const btPersistentManifold* findManifold(int index0, int index1)
+	{
+		for (int i = 0; i < m_dispatcher.getNumManifolds(); i++)
+		{
+			const btPersistentManifold* manifold = m_dispatcher.getManifoldByIndexInternal(i);
+			if ((manifold->getBody0() == &m_objects[index0] && manifold->getBody1() == &m_objects[index1]) ||
+				(manifold->getBody0() == &m_objects[index1] && manifold->getBody1() == &m_objects[index0]))
+			{
+				return manifold;
+			}
+		}
+		return 0;
+	}
+};
+
+// reusing the separating features of the previous frame gives the contacts of the full separating axis test
+GTEST_TEST(BulletCollision, ConvexFeatureCacheMatchesUncached)
+{
+	btDefaultCollisionConfiguration configuration;
+	btCollisionDispatcher dispatcher(&configuration);
+	btDbvtBroadphase broadphase;
+	btSequentialImpulseConstraintSolver solver;
+	btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &configuration);
+	world.setGravity(btVector3(0, 0, -10));
+	world.getDispatchInfo().m_enableSatConvex = true;
+
+	btBoxShape groundShape(btVector3(5, 5, 0.5));
+	groundShape.initializePolyhedralFeatures();
+	btRigidBody ground(0, 0, &groundShape);
+	ground.setWorldTransform(btTransform(btQuaternion::getIdentity(), btVector3(0, 0, -0.5)));
+	world.addRigidBody(&ground);
+
+	btConvexHullShape hull;
+	for (int i = 0; i < 24; i++)
+	{
+		btVector3 point(i & 1 ? 0.5 : -0.5, i & 2 ? 0.5 : -0.5, i & 4 ? 0.5 : -0.5);
+		point[(i >> 3) % 3] *= btScalar(0.8);
+		hull.addPoint(point, false);
+	}
+	hull.recalcLocalAabb();
+	hull.initializePolyhedralFeatures();
+	btVector3 inertia;
+	hull.calculateLocalInertia(1, inertia);
+
+	btRigidBody* boxes[2];
+	for (int i = 0; i < 2; i++)
+	{
+		boxes[i] = new btRigidBody(1, 0, &hull, inertia);
+		boxes[i]->setWorldTransform(btTransform(btQuaternion(btVector3(1, 2, 3).normalized(), 0.05 + 0.1 * i), btVector3(0.1 * i, 0, 0.55 + 1.05 * i)));
+		boxes[i]->setAngularVelocity(btVector3(0.5, -0.3, 1.0 + i));
+		world.addRigidBody(boxes[i]);
+	}
+
+	btCollisionObject* sources[3] = {&ground, boxes[0], boxes[1]};
+	HullStackReplay uncached(sources, false);
+	HullStackReplay cached(sources, true);
+
+	// the pairs of the stack: the lower cube on the ground and the upper cube on the lower one
+	const int pairs[2][2] = {{0, 1}, {1, 2}};
+	int numCompared = 0;
+	for (int step = 0; step < 60; step++)
+	{
+		world.stepSimulation(1. / 60., 0);
+		uncached.update(sources);
+		cached.update(sources);
+		for (int p = 0; p < 2; p++)
+		{
+			const btPersistentManifold* expected = uncached.findManifold(pairs[p][0], pairs[p][1]);
+			const btPersistentManifold* actual = cached.findManifold(pairs[p][0], pairs[p][1]);
+			ASSERT_EQ(expected == 0, actual == 0) << "step " << step << " pair " << p;
+			if (expected == 0)
+			{
+				continue;
+			}
+			// on nearly parallel faces the cache may keep the face of the previous frame, so the manifolds
+			// can hold different corners, but the normal and the deepest penetration agree
+			ASSERT_EQ(expected->getNumContacts() == 0, actual->getNumContacts() == 0) << "step " << step << " pair " << p;
+			if (expected->getNumContacts() == 0)
+			{
+				continue;
+			}
+			btScalar expectedDistance = BT_LARGE_FLOAT;
+			btScalar actualDistance = BT_LARGE_FLOAT;
+			for (int j = 0; j < expected->getNumContacts(); j++)
+			{
+				expectedDistance = btMin(expectedDistance, expected->getContactPoint(j).getDistance());
+			}
+			for (int j = 0; j < actual->getNumContacts(); j++)
+			{
+				actualDistance = btMin(actualDistance, actual->getContactPoint(j).getDistance());
+				EXPECT_GT(expected->getContactPoint(0).m_normalWorldOnB.dot(actual->getContactPoint(j).m_normalWorldOnB), 0.999) << "step " << step << " pair " << p;
+			}
+			EXPECT_NEAR(expectedDistance, actualDistance, 1e-4) << "step " << step << " pair " << p;
+			numCompared++;
+		}
+	}
+	EXPECT_GT(numCompared, 0);
+
+	for (int i = 0; i < 2; i++)
+	{
+		world.removeRigidBody(boxes[i]);
+		delete boxes[i];
+	}
+	world.removeRigidBody(&ground);
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,187 @@
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/CollisionDispatch/btConvexConvexSpecializedAlgorithm.h>
+#include <gtest/gtest.h>
+
+static btScalar randomScalar()
+{
+	return btScalar(rand()) / btScalar(RAND_MAX) * btScalar(2.) - btScalar(1.);
+}
+
+static btVector3 randomDirection()
+{
+	for (;;)
+	{
+		btVector3 dir(randomScalar(), randomScalar(), randomScalar());
+		if (dir.length2() > btScalar(0.01))
+		{
+			return dir.normalized();
+		}
+	}
+}
+
+//points on a sphere, and as many inside that are not on the hull
+static void addSpherePoints(btConvexHullShape& hull, int numPoints)
+{
+	for (int i = 0; i < numPoints; i++)
+	{
+		hull.addPoint(randomDirection(), false);
+		hull.addPoint(randomDirection() * btScalar(0.5), false);
+	}
+	hull.recalcLocalAabb();
+}
+
+// the hill climbing support vertex maximizes the dot product like the linear scan, also with non-uniform scaling
+GTEST_TEST(BulletCollision, ConvexHullShapeHillClimbingSupport)
+{
+	srand(7);
+	btConvexHullShape hull;
+	addSpherePoints(hull, 500);
+	btConvexHullShape reference;
+	for (int i = 0; i < hull.getNumPoints(); i++)
+	{
+		reference.addPoint(hull.getUnscaledPoints()[i], false);
+	}
+	reference.recalcLocalAabb();
+
+	ASSERT_TRUE(hull.initializeSupportAdjacency());
+	ASSERT_TRUE(hull.hasSupportAdjacency());
+
+	const btVector3 scalings[2] = {btVector3(1, 1, 1), btVector3(2, 0.5, 1)};
+	for (int s = 0; s < 2; s++)
+	{
+		hull.setLocalScaling(scalings[s]);
+		reference.setLocalScaling(scalings[s]);
+
+		int supportVertex = -1;
+		for (int i = 0; i < 1000; i++)
+		{
+			btVector3 dir = randomDirection();
+			btScalar expected = dir.dot(reference.localGetSupportingVertexWithoutMargin(dir));
+			EXPECT_NEAR(expected, dir.dot(hull.localGetSupportingVertexWithoutMargin(dir)), 1e-5);
+			EXPECT_NEAR(expected, dir.dot(hull.localGetSupportVertexWithoutMarginNonVirtual(dir)), 1e-5);
+			//warm started from the support vertex of the previous direction
+			EXPECT_NEAR(expected, dir.dot(hull.localGetSupportVertexHillClimbing(dir, supportVertex)), 1e-5);
+		}
+
+		btVector3 directions[64];
+		btVector3 expectedVertices[64];
+		btVector3 vertices[64];
+		for (int i = 0; i < 64; i++)
+		{
+			directions[i] = randomDirection();
+		}
+		reference.batchedUnitVectorGetSupportingVertexWithoutMargin(directions, expectedVertices, 64);
+		hull.batchedUnitVectorGetSupportingVertexWithoutMargin(directions, vertices, 64);
+		for (int i = 0; i < 64; i++)
+		{
+			EXPECT_NEAR(expectedVertices[i][3], vertices[i][3], 1e-5);
+			EXPECT_NEAR(directions[i].dot(expectedVertices[i]), directions[i].dot(vertices[i]), 1e-5);
+		}
+
+		btVector3 aabbMin, aabbMax, expectedMin, expectedMax;
+		hull.getAabb(btTransform::getIdentity(), aabbMin, aabbMax);
+		reference.getAabb(btTransform::getIdentity(), expectedMin, expectedMax);
+		EXPECT_NEAR(0, (aabbMin - expectedMin).length(), 1e-5);
+		EXPECT_NEAR(0, (aabbMax - expectedMax).length(), 1e-5);
+	}
+
+	//new points invalidate the graph
+	hull.addPoint(btVector3(3, 0, 0));
+	EXPECT_FALSE(hull.hasSupportAdjacency());
+	EXPECT_NEAR(6, hull.localGetSupportingVertexWithoutMargin(btVector3(1, 0, 0)).x(), 1e-5);
+}
+
+// a flat hull still has a connected graph, along its boundary
+GTEST_TEST(BulletCollision, ConvexHullShapeHillClimbingPlanar)
+{
+	srand(11);
+	btConvexHullShape hull;
+	for (int i = 0; i < 100; i++)
+	{
+		btScalar angle = SIMD_2_PI * btScalar(i) / btScalar(100);
+		hull.addPoint(btVector3(btCos(angle), btSin(angle), 0), false);
+	}
+	hull.recalcLocalAabb();
+	ASSERT_TRUE(hull.initializeSupportAdjacency());
+
+	for (int i = 0; i < 200; i++)
+	{
+		btVector3 dir = randomDirection();
+		btScalar expected = btSqrt(dir.x() * dir.x() + dir.y() * dir.y());
+		EXPECT_NEAR(expected, dir.dot(hull.localGetSupportingVertexWithoutMargin(dir)), 0.01);
+	}
+}
+
+// the per manifold warm start of the specialized algorithms gives the same contacts as the linear scan
+GTEST_TEST(BulletCollision, ConvexHullShapeHillClimbingContacts)
+{
+	srand(13);
+	btConvexHullShape hull;
+	addSpherePoints(hull, 300);
+	btConvexHullShape climbingHull;
+	for (int i = 0; i < hull.getNumPoints(); i++)
+	{
+		climbingHull.addPoint(hull.getUnscaledPoints()[i], false);
+	}
+	climbingHull.recalcLocalAabb();
+	ASSERT_TRUE(climbingHull.initializeSupportAdjacency());
+
+	btBoxShape box(btVector3(0.5, 0.4, 0.3));
+	btDefaultCollisionConfiguration configuration;
+	btCollisionDispatcher dispatcher(&configuration);
+	btConvexConvexSpecializedAlgorithmBase::registerAlgorithms(&dispatcher);
+	btDbvtBroadphase broadphase;
+	btCollisionWorld world(&dispatcher, &broadphase, &configuration);
+
+	btCollisionObject boxObject;
+	boxObject.setCollisionShape(&box);
+	btCollisionObject hullObject;
+	hullObject.setCollisionShape(&hull);
+	btCollisionObject climbingHullObject;
+	climbingHullObject.setCollisionShape(&climbingHull);
+
+	//a persistent algorithm per pair, so the support vertices of the previous pose are reused
+	btCollisionObjectWrapper boxWrap(0, &box, &boxObject, boxObject.getWorldTransform(), -1, -1);
+	btCollisionObjectWrapper hullWrap(0, &hull, &hullObject, hullObject.getWorldTransform(), -1, -1);
+	btCollisionObjectWrapper climbingHullWrap(0, &climbingHull, &climbingHullObject, climbingHullObject.getWorldTransform(), -1, -1);
+	btCollisionAlgorithm* algorithm = dispatcher.findAlgorithm(&boxWrap, &hullWrap, 0, BT_CONTACT_POINT_ALGORITHMS);
+	btCollisionAlgorithm* climbingAlgorithm = dispatcher.findAlgorithm(&boxWrap, &climbingHullWrap, 0, BT_CONTACT_POINT_ALGORITHMS);
+	btDispatcherInfo dispatchInfo;
+
+	int numContacts = 0;
+	for (int i = 0; i < 100; i++)
+	{
+		btQuaternion orientation(btVector3(1, 1, 0).normalized(), btScalar(0.05) * i);
+		btTransform pose(orientation, btVector3(btCos(btScalar(0.1) * i), btSin(btScalar(0.1) * i), btScalar(0.3)) * btScalar(1.3));
+		boxObject.setWorldTransform(pose);
+
+		btCollisionObjectWrapper poseWrap(0, &box, &boxObject, pose, -1, -1);
+		btManifoldResult result(&poseWrap, &hullWrap);
+		algorithm->processCollision(&poseWrap, &hullWrap, dispatchInfo, &result);
+		btManifoldResult climbingResult(&poseWrap, &climbingHullWrap);
+		climbingAlgorithm->processCollision(&poseWrap, &climbingHullWrap, dispatchInfo, &climbingResult);
+
+		btPersistentManifold* manifold = result.getPersistentManifold();
+		btPersistentManifold* climbingManifold = climbingResult.getPersistentManifold();
+		ASSERT_EQ(manifold->getNumContacts(), climbingManifold->getNumContacts()) << "pose " << i;
+		numContacts += manifold->getNumContacts();
+		for (int j = 0; j < manifold->getNumContacts(); j++)
+		{
+			EXPECT_NEAR(manifold->getContactPoint(j).getDistance(), climbingManifold->getContactPoint(j).getDistance(), 1e-4) << "pose " << i;
+		}
+		manifold->clearManifold();
+		climbingManifold->clearManifold();
+	}
+	EXPECT_GT(numContacts, 50);
+
+	algorithm->~btCollisionAlgorithm();
+	dispatcher.freeCollisionAlgorithm(algorithm);
+	climbingAlgorithm->~btCollisionAlgorithm();
+	dispatcher.freeCollisionAlgorithm(climbingAlgorithm);
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,102 @@
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <gtest/gtest.h>
+
+extern int gNumClampedCcdMotions;
+
+#define WALL_X 3
+#define NUM_BODIES 200
+
+///fast spheres shot at a static wall through a field of slow dynamic targets, with predictive contacts and motion clamping
+static void SimulateCcd(btAlignedObjectArray<btTransform>& transforms, int& numClampedCcdMotions)
+{
+	btDefaultCollisionConfiguration config;
+	btCollisionDispatcherMt dispatcher(&config);
+	btDbvtBroadphase broadphase;
+	btConstraintSolverPoolMt solverPool(4);
+	btDiscreteDynamicsWorldMt world(&dispatcher, &broadphase, &solverPool, 0, &config);
+	world.setGravity(btVector3(0, 0, 0));
+
+	btBoxShape wallShape(btVector3(0.05, 10, 10));
+	btRigidBody wall(0, 0, &wallShape);
+	wall.getWorldTransform().setOrigin(btVector3(WALL_X, 0, 0));
+	world.addRigidBody(&wall);
+
+	btSphereShape sphereShape(0.1);
+	btVector3 inertia;
+	sphereShape.calculateLocalInertia(1, inertia);
+	btAlignedObjectArray<btRigidBody*> bodies;
+	for (int i = 0; i < NUM_BODIES; i++)
+	{
+		btRigidBody::btRigidBodyConstructionInfo info(1, 0, &sphereShape, inertia);
+		const bool fast = (i & 1) == 0;
+		info.m_startWorldTransform.setOrigin(btVector3(fast ? 0 : 1.5, -5 + 0.5 * (i / 2 % 20), -5 + 2 * (i / 40)));
+		btRigidBody* body = new btRigidBody(info);
+		if (fast)
+		{
+			body->setLinearVelocity(btVector3(300, 0.5, 0));
+		}
+		body->setCcdMotionThreshold(0.05);
+		body->setCcdSweptSphereRadius(0.1);
+		world.addRigidBody(body);
+		bodies.push_back(body);
+	}
+
+	const int numClampedCcdMotionsBefore = gNumClampedCcdMotions;
+	for (int i = 0; i < 10; i++)
+	{
+		world.stepSimulation(btScalar(1. / 60.), 0, btScalar(1. / 60.));
+	}
+	numClampedCcdMotions = gNumClampedCcdMotions - numClampedCcdMotionsBefore;
+
+	for (int i = 0; i < bodies.size(); i++)
+	{
+		transforms.push_back(bodies[i]->getWorldTransform());
+		world.removeRigidBody(bodies[i]);
+		delete bodies[i];
+	}
+	world.removeRigidBody(&wall);
+}
+
+GTEST_TEST(BulletDynamics, DiscreteDynamicsWorldMt_DeterministicCcd)
+{
+	btITaskScheduler* previousScheduler = btGetTaskScheduler();
+
+	btSetTaskScheduler(btGetSequentialTaskScheduler());
+	btAlignedObjectArray<btTransform> sequentialTransforms;
+	int numSequentialClampedMotions = 0;
+	SimulateCcd(sequentialTransforms, numSequentialClampedMotions);
+
+	btITaskScheduler* scheduler = btCreateDefaultTaskScheduler();
+	if (scheduler)
+	{
+		scheduler->setNumThreads(btMin(4, scheduler->getMaxNumThreads()));
+		btSetTaskScheduler(scheduler);
+	}
+	btAlignedObjectArray<btTransform> parallelTransforms;
+	int numParallelClampedMotions = 0;
+	SimulateCcd(parallelTransforms, numParallelClampedMotions);
+
+	btSetTaskScheduler(previousScheduler);
+	delete scheduler;
+
+	EXPECT_GT(numSequentialClampedMotions, 0);
+	EXPECT_EQ(numSequentialClampedMotions, numParallelClampedMotions);
+	ASSERT_EQ(NUM_BODIES, sequentialTransforms.size());
+	ASSERT_EQ(NUM_BODIES, parallelTransforms.size());
+	for (int i = 0; i < NUM_BODIES; i++)
+	{
+		EXPECT_TRUE(sequentialTransforms[i].getOrigin() == parallelTransforms[i].getOrigin()) << i;
+		EXPECT_TRUE(sequentialTransforms[i].getBasis() == parallelTransforms[i].getBasis()) << i;
+		// nothing tunnels through the wall
+		EXPECT_LT(sequentialTransforms[i].getOrigin().x(), WALL_X) << i;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
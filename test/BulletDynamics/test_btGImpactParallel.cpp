@@ -0,0 +1,257 @@
+
+#include <btBulletCollisionCommon.h>
+#include <BulletCollision/Gimpact/btGImpactShape.h>
+#include <BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
+#include <gtest/gtest.h>
+
+#define GRID_SIZE 40
+
+///a wavy grid of 2 * GRID_SIZE * GRID_SIZE triangles, the waves move with the phase
+struct WavyMesh
+{
+	btAlignedObjectArray<btScalar> m_vertices;
+	btAlignedObjectArray<int> m_indices;
+	btTriangleIndexVertexArray m_meshInterface;
+	btGImpactMeshShape* m_shape;
+
+	WavyMesh(btScalar phase)
+	{
+		m_vertices.resize((GRID_SIZE + 1) * (GRID_SIZE + 1) * 3);
+		setPhase(phase);
+		for (int i = 0; i < GRID_SIZE; i++)
+		{
+			for (int j = 0; j < GRID_SIZE; j++)
+			{
+				const int v = i * (GRID_SIZE + 1) + j;
+				m_indices.push_back(v);
+				m_indices.push_back(v + 1);
+				m_indices.push_back(v + GRID_SIZE + 1);
+				m_indices.push_back(v + 1);
+				m_indices.push_back(v + GRID_SIZE + 2);
+				m_indices.push_back(v + GRID_SIZE + 1);
+			}
+		}
+		btIndexedMesh mesh;
+		mesh.m_numTriangles = m_indices.size() / 3;
+		mesh.m_triangleIndexBase = (const unsigned char*)&m_indices[0];
+		mesh.m_triangleIndexStride = 3 * sizeof(int);
+		mesh.m_numVertices = m_vertices.size() / 3;
+		mesh.m_vertexBase = (const unsigned char*)&m_vertices[0];
+		mesh.m_vertexStride = 3 * sizeof(btScalar);
+		m_meshInterface.addIndexedMesh(mesh);
+		m_shape = new btGImpactMeshShape(&m_meshInterface);
+		m_shape->updateBound();
+	}
+
+	~WavyMesh()
+	{
+		delete m_shape;
+	}
+
+	void setPhase(btScalar phase)
+	{
+		for (int i = 0; i <= GRID_SIZE; i++)
+		{
+			for (int j = 0; j <= GRID_SIZE; j++)
+			{
+				btScalar* vertex = &m_vertices[(i * (GRID_SIZE + 1) + j) * 3];
+				vertex[0] = btScalar(i) - GRID_SIZE / 2;
+				vertex[1] = btScalar(0.5) * btSin(btScalar(0.7) * i + phase) * btCos(btScalar(0.5) * j);
+				vertex[2] = btScalar(j) - GRID_SIZE / 2;
+			}
+		}
+	}
+};
+
+template <class BOX_SET>
+static void StoreNodes(const BOX_SET& boxSet, btAlignedObjectArray<btVector3>& bounds, btAlignedObjectArray<int>& data)
+{
+	for (int i = 0; i < boxSet.getNodeCount(); i++)
+	{
+		btAABB bound;
+		boxSet.getNodeBound(i, bound);
+		bounds.push_back(bound.m_min);
+		bounds.push_back(bound.m_max);
+		data.push_back(boxSet.isLeafNode(i) ? boxSet.getNodeData(i) : -boxSet.getEscapeNodeIndex(i));
+	}
+}
+
+struct TreeResults
+{
+	btAlignedObjectArray<btVector3> m_bounds;
+	btAlignedObjectArray<int> m_data;
+	btAlignedObjectArray<int> m_pairs;
+};
+
+///builds, refits and collides the trees of two meshes
+template <class BOX_SET>
+static void CollideTrees(TreeResults& results)
+{
+	WavyMesh mesh0(0);
+	WavyMesh mesh1(1);
+	btGImpactMeshShapePart* part0 = mesh0.m_shape->getMeshPart(0);
+	btGImpactMeshShapePart* part1 = mesh1.m_shape->getMeshPart(0);
+	BOX_SET boxSet0(part0->getTrimeshPrimitiveManager());
+	BOX_SET boxSet1(part1->getTrimeshPrimitiveManager());
+
+	part0->lockChildShapes();
+	part1->lockChildShapes();
+	boxSet0.buildSet();
+	boxSet1.buildSet();
+	StoreNodes(boxSet0, results.m_bounds, results.m_data);
+
+	mesh0.setPhase(btScalar(0.3));
+	boxSet0.update();
+	StoreNodes(boxSet0, results.m_bounds, results.m_data);
+
+	btTransform trans0;
+	trans0.setIdentity();
+	btTransform trans1(btQuaternion(btVector3(0, 1, 0), btScalar(0.2)), btVector3(btScalar(0.5), btScalar(0.1), 0));
+	btPairSet pairs;
+	BOX_SET::find_collision(&boxSet0, trans0, &boxSet1, trans1, pairs);
+	for (int i = 0; i < pairs.size(); i++)
+	{
+		results.m_pairs.push_back(pairs[i].m_index1);
+		results.m_pairs.push_back(pairs[i].m_index2);
+	}
+	part0->unlockChildShapes();
+	part1->unlockChildShapes();
+}
+
+struct ContactResults
+{
+	btAlignedObjectArray<btVector3> m_points;
+	btAlignedObjectArray<btScalar> m_distances;
+	btAlignedObjectArray<int> m_triangles;
+};
+
+struct ContactRecorder : public btManifoldResult
+{
+	ContactResults& m_results;
+
+	ContactRecorder(const btCollisionObjectWrapper* obj0Wrap, const btCollisionObjectWrapper* obj1Wrap, ContactResults& results)
+		: btManifoldResult(obj0Wrap, obj1Wrap),
+		  m_results(results)
+	{
+	}
+
+	virtual void addContactPoint(const btVector3& normalOnBInWorld, const btVector3& pointInWorld, btScalar depth)
+	{
+		m_results.m_points.push_back(pointInWorld);
+		m_results.m_points.push_back(normalOnBInWorld);
+		m_results.m_distances.push_back(depth);
+		m_results.m_triangles.push_back(m_index0);
+		m_results.m_triangles.push_back(m_index1);
+	}
+};
+
+///all contacts of two overlapping meshes, in the order btGImpactCollisionAlgorithm adds them
+static void CollideMeshes(ContactResults& results)
+{
+	btDefaultCollisionConfiguration config;
+	btCollisionDispatcher dispatcher(&config);
+	btGImpactCollisionAlgorithm::registerAlgorithm(&dispatcher);
+
+	WavyMesh mesh0(0);
+	WavyMesh mesh1(1);
+	btCollisionObject object0;
+	object0.setCollisionShape(mesh0.m_shape);
+	btCollisionObject object1;
+	object1.setCollisionShape(mesh1.m_shape);
+	object1.setWorldTransform(btTransform(btQuaternion(btVector3(0, 1, 0), btScalar(0.2)), btVector3(btScalar(0.5), btScalar(0.1), 0)));
+
+	btCollisionObjectWrapper wrap0(0, object0.getCollisionShape(), &object0, object0.getWorldTransform(), -1, -1);
+	btCollisionObjectWrapper wrap1(0, object1.getCollisionShape(), &object1, object1.getWorldTransform(), -1, -1);
+	btCollisionAlgorithm* algorithm = dispatcher.findAlgorithm(&wrap0, &wrap1, 0, BT_CONTACT_POINT_ALGORITHMS);
+	ASSERT_TRUE(algorithm != 0);
+	ContactRecorder recorder(&wrap0, &wrap1, results);
+	btDispatcherInfo dispatchInfo;
+	algorithm->processCollision(&wrap0, &wrap1, dispatchInfo, &recorder);
+	algorithm->~btCollisionAlgorithm();
+	dispatcher.freeCollisionAlgorithm(algorithm);
+}
+
+static btITaskScheduler* SetThreadedScheduler()
+{
+	btITaskScheduler* scheduler = btCreateDefaultTaskScheduler();
+	if (scheduler)
+	{
+		scheduler->setNumThreads(btMin(4, scheduler->getMaxNumThreads()));
+		btSetTaskScheduler(scheduler);
+	}
+	return scheduler;
+}
+
+template <class BOX_SET>
+static void TestTrees()
+{
+	btITaskScheduler* previousScheduler = btGetTaskScheduler();
+	btSetTaskScheduler(btGetSequentialTaskScheduler());
+	TreeResults sequential;
+	CollideTrees<BOX_SET>(sequential);
+
+	btITaskScheduler* scheduler = SetThreadedScheduler();
+	TreeResults threaded;
+	CollideTrees<BOX_SET>(threaded);
+	btSetTaskScheduler(previousScheduler);
+	delete scheduler;
+
+	ASSERT_EQ(2 * (2 * 2 * GRID_SIZE * GRID_SIZE - 1), sequential.m_data.size());
+	ASSERT_EQ(sequential.m_data.size(), threaded.m_data.size());
+	for (int i = 0; i < sequential.m_data.size(); i++)
+	{
+		EXPECT_EQ(sequential.m_data[i], threaded.m_data[i]) << i;
+		EXPECT_TRUE(sequential.m_bounds[2 * i] == threaded.m_bounds[2 * i]) << i;
+		EXPECT_TRUE(sequential.m_bounds[2 * i + 1] == threaded.m_bounds[2 * i + 1]) << i;
+	}
+
+	// enough pairs for the threaded collision of the trees
+	EXPECT_GT(sequential.m_pairs.size(), 2 * GIM_BVH_PARALLEL_MIN_PRIMITIVES);
+	ASSERT_EQ(sequential.m_pairs.size(), threaded.m_pairs.size());
+	for (int i = 0; i < sequential.m_pairs.size(); i++)
+	{
+		EXPECT_EQ(sequential.m_pairs[i], threaded.m_pairs[i]) << i;
+	}
+}
+
+GTEST_TEST(BulletCollision, GImpactParallel_Bvh)
+{
+	TestTrees<btGImpactBvh>();
+}
+
+GTEST_TEST(BulletCollision, GImpactParallel_QuantizedBvh)
+{
+	TestTrees<btGImpactQuantizedBvh>();
+}
+
+GTEST_TEST(BulletCollision, GImpactParallel_MeshContacts)
+{
+	btITaskScheduler* previousScheduler = btGetTaskScheduler();
+	btSetTaskScheduler(btGetSequentialTaskScheduler());
+	ContactResults sequential;
+	CollideMeshes(sequential);
+
+	btITaskScheduler* scheduler = SetThreadedScheduler();
+	ContactResults threaded;
+	CollideMeshes(threaded);
+	btSetTaskScheduler(previousScheduler);
+	delete scheduler;
+
+	// enough triangle pairs for the threaded contacts
+	EXPECT_GT(sequential.m_distances.size(), GIM_BVH_PARALLEL_MIN_PRIMITIVES);
+	ASSERT_EQ(sequential.m_distances.size(), threaded.m_distances.size());
+	for (int i = 0; i < sequential.m_distances.size(); i++)
+	{
+		EXPECT_EQ(sequential.m_distances[i], threaded.m_distances[i]) << i;
+		EXPECT_TRUE(sequential.m_points[2 * i] == threaded.m_points[2 * i]) << i;
+		EXPECT_TRUE(sequential.m_points[2 * i + 1] == threaded.m_points[2 * i + 1]) << i;
+		EXPECT_EQ(sequential.m_triangles[2 * i], threaded.m_triangles[2 * i]) << i;
+		EXPECT_EQ(sequential.m_triangles[2 * i + 1], threaded.m_triangles[2 * i + 1]) << i;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,132 @@
+
+#include <btBulletCollisionCommon.h>
+#include <BulletCollision/CollisionDispatch/btGhostObject.h>
+#include <gtest/gtest.h>
+
+struct GhostOverlapWorld
+{
+	btDefaultCollisionConfiguration m_config;
+	btCollisionDispatcher m_dispatcher;
+	btDbvtBroadphase m_broadphase;
+	btGhostOverlapEventCallback m_eventCallback;
+	btCollisionWorld m_world;
+
+	btSphereShape m_triggerShape;
+	btGhostObject m_trigger;
+	btBoxShape m_boxShape;
+	btCollisionObject m_box;
+
+	GhostOverlapWorld(bool narrowphaseConfirmation)
+		: m_dispatcher(&m_config),
+		  m_world(&m_dispatcher, &m_broadphase, &m_config),
+		  m_triggerShape(1),
+		  m_boxShape(btVector3(0.5, 0.5, 0.5))
+	{
+		m_eventCallback.setNarrowphaseConfirmation(narrowphaseConfirmation);
+		m_broadphase.getOverlappingPairCache()->setInternalGhostPairCallback(&m_eventCallback);
+
+		m_trigger.setCollisionShape(&m_triggerShape);
+		m_trigger.setCollisionFlags(btCollisionObject::CF_NO_CONTACT_RESPONSE);
+		m_world.addCollisionObject(&m_trigger);
+
+		m_box.setCollisionShape(&m_boxShape);
+		moveBox(btVector3(10, 0, 0));
+		m_world.addCollisionObject(&m_box);
+	}
+
+	~GhostOverlapWorld()
+	{
+		if (m_box.getBroadphaseHandle())
+			m_world.removeCollisionObject(&m_box);
+		m_world.removeCollisionObject(&m_trigger);
+	}
+
+	void moveBox(const btVector3& origin)
+	{
+		m_box.getWorldTransform().setIdentity();
+		m_box.getWorldTransform().setOrigin(origin);
+	}
+
+	void update()
+	{
+		m_eventCallback.clearEvents();
+		m_world.performDiscreteCollisionDetection();
+		m_eventCallback.processOverlapEvents(&m_world);
+	}
+
+	void expectEvent(int eventType)
+	{
+		ASSERT_EQ(1, m_eventCallback.getNumEvents());
+		EXPECT_EQ(&m_trigger, m_eventCallback.getEvent(0).m_ghostObject);
+		EXPECT_EQ(&m_box, m_eventCallback.getEvent(0).m_otherObject);
+		EXPECT_EQ(eventType, m_eventCallback.getEvent(0).m_eventType);
+	}
+};
+
+GTEST_TEST(BulletCollision, GhostOverlapEvents_Broadphase)
+{
+	GhostOverlapWorld world(false);
+	world.update();
+	EXPECT_EQ(0, world.m_eventCallback.getNumEvents());
+
+	world.moveBox(btVector3(1.2, 0, 0));
+	world.update();
+	world.expectEvent(BT_GHOST_OVERLAP_BEGIN);
+	EXPECT_EQ(1, world.m_trigger.getNumOverlappingObjects());
+
+	// still overlapping, nothing changed
+	world.moveBox(btVector3(0.5, 0, 0));
+	world.update();
+	EXPECT_EQ(0, world.m_eventCallback.getNumEvents());
+
+	world.moveBox(btVector3(10, 0, 0));
+	world.update();
+	world.expectEvent(BT_GHOST_OVERLAP_END);
+	EXPECT_EQ(0, world.m_trigger.getNumOverlappingObjects());
+
+	// removing an overlapping object ends the overlap
+	world.moveBox(btVector3(0, 0, 0));
+	world.update();
+	world.expectEvent(BT_GHOST_OVERLAP_BEGIN);
+	world.m_eventCallback.clearEvents();
+	world.m_world.removeCollisionObject(&world.m_box);
+	world.expectEvent(BT_GHOST_OVERLAP_END);
+}
+
+GTEST_TEST(BulletCollision, GhostOverlapEvents_NarrowphaseConfirmation)
+{
+	GhostOverlapWorld world(true);
+	world.update();
+	EXPECT_EQ(0, world.m_eventCallback.getNumEvents());
+
+	// the AABBs overlap at the corner, the sphere and the box don't touch
+	world.moveBox(btVector3(1.4, 1.4, 0));
+	world.update();
+	EXPECT_EQ(0, world.m_eventCallback.getNumEvents());
+	EXPECT_EQ(1, world.m_trigger.getNumOverlappingObjects());
+
+	world.moveBox(btVector3(1.2, 0, 0));
+	world.update();
+	world.expectEvent(BT_GHOST_OVERLAP_BEGIN);
+
+	world.moveBox(btVector3(0.5, 0, 0));
+	world.update();
+	EXPECT_EQ(0, world.m_eventCallback.getNumEvents());
+
+	world.moveBox(btVector3(10, 0, 0));
+	world.update();
+	world.expectEvent(BT_GHOST_OVERLAP_END);
+
+	// an AABB overlap that never touches has no end event either
+	world.moveBox(btVector3(1.4, 1.4, 0));
+	world.update();
+	world.moveBox(btVector3(10, 0, 0));
+	world.update();
+	EXPECT_EQ(0, world.m_eventCallback.getNumEvents());
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
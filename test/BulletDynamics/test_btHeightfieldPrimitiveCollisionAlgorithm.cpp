@@ -0,0 +1,332 @@
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/CollisionDispatch/btHeightfieldPrimitiveCollisionAlgorithm.h>
+#include <BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
+#include <BulletCollision/CollisionShapes/btTiledHeightfieldTerrainShape.h>
+#include <gtest/gtest.h>
+
+#define TERRAIN_SIZE 65
+#define TERRAIN_SPACING 0.5
+
+struct Terrain
+{
+	btAlignedObjectArray<float> m_heights;
+	btHeightfieldTerrainShape* m_shape;
+	btHeightfieldArrayTileSource* m_source;
+	btCollisionObject m_object;
+
+	Terrain(bool tiled = false)
+		: m_source(0)
+	{
+		for (int j = 0; j < TERRAIN_SIZE; j++)
+		{
+			for (int i = 0; i < TERRAIN_SIZE; i++)
+			{
+				m_heights.push_back(float(0.4 * btSin(0.15 * i) * btCos(0.1 * j)));
+			}
+		}
+		if (tiled)
+		{
+			m_source = new btHeightfieldArrayTileSource(&m_heights[0], TERRAIN_SIZE, TERRAIN_SIZE);
+			m_shape = new btTiledHeightfieldTerrainShape(TERRAIN_SIZE, TERRAIN_SIZE, 16, m_source, 4, btScalar(-0.5), btScalar(0.5), 2, false);
+		}
+		else
+		{
+			m_shape = new btHeightfieldTerrainShape(TERRAIN_SIZE, TERRAIN_SIZE, &m_heights[0], btScalar(-0.5), btScalar(0.5), 2, false);
+		}
+		m_shape->setLocalScaling(btVector3(TERRAIN_SPACING, TERRAIN_SPACING, 1));
+		m_object.setCollisionShape(m_shape);
+	}
+
+	~Terrain()
+	{
+		delete m_shape;
+		delete m_source;
+	}
+
+	btScalar heightAt(btScalar x, btScalar y)
+	{
+		btTransform from(btQuaternion::getIdentity(), btVector3(x, y, 10));
+		btTransform to(btQuaternion::getIdentity(), btVector3(x, y, -10));
+		btCollisionWorld::ClosestRayResultCallback callback(from.getOrigin(), to.getOrigin());
+		btCollisionWorld::rayTestSingle(from, to, &m_object, m_shape, m_object.getWorldTransform(), callback);
+		EXPECT_TRUE(callback.hasHit());
+		return callback.m_hitPointWorld.z();
+	}
+};
+
+static btCollisionAlgorithm* FindAlgorithm(btCollisionDispatcher* dispatcher, btCollisionObject* obj0, btCollisionObject* obj1)
+{
+	btCollisionObjectWrapper wrap0(0, obj0->getCollisionShape(), obj0, obj0->getWorldTransform(), -1, -1);
+	btCollisionObjectWrapper wrap1(0, obj1->getCollisionShape(), obj1, obj1->getWorldTransform(), -1, -1);
+	return dispatcher->findAlgorithm(&wrap0, &wrap1, 0, BT_CONTACT_POINT_ALGORITHMS);
+}
+
+static void FreeAlgorithm(btCollisionDispatcher* dispatcher, btCollisionAlgorithm* algorithm)
+{
+	algorithm->~btCollisionAlgorithm();
+	dispatcher->freeCollisionAlgorithm(algorithm);
+}
+
+///the deepest contact and the number of contacts, with the normal pointing from the terrain to the primitive
+static btScalar Collide(btCollisionDispatcher* dispatcher, btCollisionObject* obj0, btCollisionObject* obj1, btVector3& normal, int& numContacts)
+{
+	btCollisionObjectWrapper wrap0(0, obj0->getCollisionShape(), obj0, obj0->getWorldTransform(), -1, -1);
+	btCollisionObjectWrapper wrap1(0, obj1->getCollisionShape(), obj1, obj1->getWorldTransform(), -1, -1);
+	btCollisionAlgorithm* algorithm = dispatcher->findAlgorithm(&wrap0, &wrap1, 0, BT_CONTACT_POINT_ALGORITHMS);
+	btManifoldResult result(&wrap0, &wrap1);
+	btDispatcherInfo dispatchInfo;
+	algorithm->processCollision(&wrap0, &wrap1, dispatchInfo, &result);
+
+	const btPersistentManifold* manifold = result.getPersistentManifold();
+	const bool terrainIsBody0 = manifold->getBody0()->getCollisionShape()->getShapeType() == TERRAIN_SHAPE_PROXYTYPE;
+	btScalar deepest = BT_LARGE_FLOAT;
+	numContacts = manifold->getNumContacts();
+	for (int i = 0; i < numContacts; i++)
+	{
+		const btManifoldPoint& pt = manifold->getContactPoint(i);
+		if (pt.getDistance() < deepest)
+		{
+			deepest = pt.getDistance();
+			normal = terrainIsBody0 ? -pt.m_normalWorldOnB : pt.m_normalWorldOnB;
+		}
+	}
+	FreeAlgorithm(dispatcher, algorithm);
+	return deepest;
+}
+
+GTEST_TEST(BulletCollision, HeightfieldPrimitive_Dispatch)
+{
+	Terrain terrain;
+	btSphereShape sphere(0.5);
+	btCapsuleShapeZ capsule(0.3, 1.0);
+	btBoxShape box(btVector3(0.4, 0.3, 0.2));
+	btCylinderShapeZ cylinder(btVector3(0.4, 0.4, 0.5));
+	btCollisionShape* shapes[] = {&sphere, &capsule, &box, &cylinder};
+
+	btDefaultCollisionConstructionInfo constructionInfo;
+	constructionInfo.m_useHeightfieldPrimitiveAlgorithm = true;
+	btDefaultCollisionConfiguration config(constructionInfo);
+	btCollisionDispatcher dispatcher(&config);
+	btDefaultCollisionConfiguration configWithout;
+	btCollisionDispatcher dispatcherWithout(&configWithout);
+
+	for (int i = 0; i < 4; i++)
+	{
+		btCollisionObject obj;
+		obj.setCollisionShape(shapes[i]);
+		const bool expected = shapes[i] != &cylinder;
+
+		btCollisionAlgorithm* algorithm = FindAlgorithm(&dispatcher, &obj, &terrain.m_object);
+		EXPECT_EQ(expected, dynamic_cast<btHeightfieldPrimitiveCollisionAlgorithm*>(algorithm) != 0);
+		FreeAlgorithm(&dispatcher, algorithm);
+
+		algorithm = FindAlgorithm(&dispatcher, &terrain.m_object, &obj);
+		EXPECT_EQ(expected, dynamic_cast<btHeightfieldPrimitiveCollisionAlgorithm*>(algorithm) != 0);
+		FreeAlgorithm(&dispatcher, algorithm);
+
+		algorithm = FindAlgorithm(&dispatcherWithout, &obj, &terrain.m_object);
+		EXPECT_TRUE(dynamic_cast<btHeightfieldPrimitiveCollisionAlgorithm*>(algorithm) == 0);
+		FreeAlgorithm(&dispatcherWithout, algorithm);
+	}
+}
+
+GTEST_TEST(BulletCollision, HeightfieldPrimitive_MatchesConvexConcave)
+{
+	Terrain terrain;
+	btSphereShape sphere(0.5);
+	btCapsuleShapeZ capsule(0.3, 1.0);
+	btBoxShape box(btVector3(0.4, 0.3, 0.2));
+	btCollisionShape* shapes[] = {&sphere, &capsule, &box};
+
+	btDefaultCollisionConstructionInfo constructionInfo;
+	constructionInfo.m_useHeightfieldPrimitiveAlgorithm = true;
+	btDefaultCollisionConfiguration config(constructionInfo);
+	btCollisionDispatcher dispatcher(&config);
+	btDefaultCollisionConfiguration configWithout;
+	btCollisionDispatcher dispatcherWithout(&configWithout);
+
+	int numCompared = 0;
+	for (int s = 0; s < 3; s++)
+	{
+		btCollisionObject obj;
+		obj.setCollisionShape(shapes[s]);
+		for (int i = 0; i < 40; i++)
+		{
+			const btScalar x = -12 + 0.61 * i;
+			const btScalar y = 9 - 0.47 * i;
+			const btScalar surface = terrain.heightAt(x, y);
+			btVector3 aabbMin, aabbMax;
+			shapes[s]->getAabb(btTransform::getIdentity(), aabbMin, aabbMax);
+
+			// lying on the terrain, slightly penetrating, slightly tilted
+			btTransform trans(btQuaternion(btVector3(1, 1, 0).normalized(), 0.05 * (i % 5)), btVector3(x, y, surface + aabbMax.z() - 0.05));
+			obj.setWorldTransform(trans);
+
+			btVector3 normal, normalWithout;
+			int numContacts, numContactsWithout;
+			const btScalar distance = Collide(&dispatcher, &obj, &terrain.m_object, normal, numContacts);
+			const btScalar distanceWithout = Collide(&dispatcherWithout, &obj, &terrain.m_object, normalWithout, numContactsWithout);
+			if (numContactsWithout == 0)
+			{
+				continue;
+			}
+			numCompared++;
+			ASSERT_GT(numContacts, 0);
+			EXPECT_LE(numContacts, MANIFOLD_CACHE_SIZE);
+			// the corners of tilted boxes are pushed out along the triangle normal, GJK can find a shorter way over an edge
+			EXPECT_LT(distance, distanceWithout + 0.005) << shapes[s]->getName() << " at " << i;
+			EXPECT_GT(distance, distanceWithout - 0.03) << shapes[s]->getName() << " at " << i;
+			EXPECT_GT(normal.dot(normalWithout), 0.95) << shapes[s]->getName() << " at " << i;
+
+			// swapped order gives the same contacts
+			btVector3 swappedNormal;
+			int numSwappedContacts;
+			EXPECT_NEAR(distance, Collide(&dispatcher, &terrain.m_object, &obj, swappedNormal, numSwappedContacts), SIMD_EPSILON);
+			EXPECT_EQ(numContacts, numSwappedContacts);
+			EXPECT_GT(swappedNormal.dot(normal), 0.999);
+		}
+	}
+	EXPECT_GT(numCompared, 100);
+}
+
+///a 5x5 heightfield with a ridge along y, one unit between the samples
+struct Ridge
+{
+	float m_heights[25];
+	btHeightfieldTerrainShape* m_shape;
+	btCollisionObject m_object;
+
+	Ridge()
+	{
+		for (int j = 0; j < 5; j++)
+		{
+			for (int i = 0; i < 5; i++)
+			{
+				m_heights[j * 5 + i] = float(1 - 0.5 * btFabs(btScalar(i - 2)));
+			}
+		}
+		// the crest is at the origin
+		m_shape = new btHeightfieldTerrainShape(5, 5, m_heights, btScalar(-1), btScalar(1), 2, false);
+		m_object.setCollisionShape(m_shape);
+		m_object.getWorldTransform().setOrigin(btVector3(0, 0, -1));
+	}
+
+	~Ridge()
+	{
+		delete m_shape;
+	}
+};
+
+// a box lying across the crest touches it with its bottom face, the vertices of the crest are outside the box
+GTEST_TEST(BulletCollision, HeightfieldPrimitive_BoxOnRidge)
+{
+	Ridge ridge;
+	btBoxShape box(btVector3(0.5, 0.5, 0.5));
+
+	btDefaultCollisionConstructionInfo constructionInfo;
+	constructionInfo.m_useHeightfieldPrimitiveAlgorithm = true;
+	btDefaultCollisionConfiguration config(constructionInfo);
+	btCollisionDispatcher dispatcher(&config);
+	btDefaultCollisionConfiguration configWithout;
+	btCollisionDispatcher dispatcherWithout(&configWithout);
+
+	const btScalar penetrations[] = {0.02, 0.1, 0.3};
+	int numCompared = 0;
+	for (int p = 0; p < 3; p++)
+	{
+		for (int i = 0; i < 12; i++)
+		{
+			btCollisionObject obj;
+			obj.setCollisionShape(&box);
+			// along the crest, turned about it and tilted towards a slope
+			const btQuaternion turn(btVector3(0, 0, 1), i < 4 ? 0 : 0.15 * (i % 4));
+			const btQuaternion tilt(btVector3(0, 1, 0), i < 8 ? 0 : 0.1);
+			obj.setWorldTransform(btTransform(tilt * turn, btVector3(0.05 * (i % 3), -1.5 + 0.25 * i, 0.5 - penetrations[p])));
+
+			btVector3 normal, normalWithout;
+			int numContacts, numContactsWithout;
+			const btScalar distance = Collide(&dispatcher, &obj, &ridge.m_object, normal, numContacts);
+			const btScalar distanceWithout = Collide(&dispatcherWithout, &obj, &ridge.m_object, normalWithout, numContactsWithout);
+			ASSERT_GT(numContactsWithout, 0);
+			numCompared++;
+			ASSERT_GT(numContacts, 0) << "penetration " << penetrations[p] << " at " << i;
+			EXPECT_NEAR(distanceWithout, distance, 0.005) << "penetration " << penetrations[p] << " at " << i;
+			EXPECT_GT(normal.dot(normalWithout), 0.95) << "penetration " << penetrations[p] << " at " << i;
+		}
+	}
+	EXPECT_EQ(36, numCompared);
+}
+
+static void SettleOnTerrain(bool tiled)
+{
+	Terrain terrain(tiled);
+	btDefaultCollisionConstructionInfo constructionInfo;
+	constructionInfo.m_useHeightfieldPrimitiveAlgorithm = true;
+	btDefaultCollisionConfiguration config(constructionInfo);
+	btCollisionDispatcher dispatcher(&config);
+	btDbvtBroadphase broadphase;
+	btSequentialImpulseConstraintSolver solver;
+	btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &config);
+	world.setGravity(btVector3(0, 0, -10));
+
+	btRigidBody ground(0, 0, terrain.m_shape);
+	world.addRigidBody(&ground);
+
+	btSphereShape sphere(0.5);
+	btCapsuleShapeZ capsule(0.3, 1.0);
+	btBoxShape box(btVector3(0.4, 0.3, 0.2));
+	btCollisionShape* shapes[] = {&sphere, &capsule, &box};
+	const btScalar lowest[] = {0.5, 0.8, 0.2};
+	btAlignedObjectArray<btRigidBody*> bodies;
+	for (int i = 0; i < 12; i++)
+	{
+		btCollisionShape* shape = shapes[i % 3];
+		btVector3 inertia;
+		shape->calculateLocalInertia(1, inertia);
+		btRigidBody::btRigidBodyConstructionInfo info(1, 0, shape, inertia);
+		info.m_startWorldTransform.setOrigin(btVector3(-10 + 1.7 * i, 4 - 0.6 * i, 2));
+		info.m_friction = 1;
+		info.m_rollingFriction = 0.1;
+		info.m_spinningFriction = 0.1;
+		info.m_linearDamping = 0.1;
+		info.m_angularDamping = 0.1;
+		btRigidBody* body = new btRigidBody(info);
+		world.addRigidBody(body);
+		bodies.push_back(body);
+	}
+
+	for (int i = 0; i < 600; i++)
+	{
+		world.stepSimulation(btScalar(1. / 60.), 0);
+	}
+
+	for (int i = 0; i < bodies.size(); i++)
+	{
+		btRigidBody* body = bodies[i];
+		world.removeRigidBody(body);
+		const btVector3 pos = body->getWorldTransform().getOrigin();
+		// resting on the terrain, not fallen through it
+		EXPECT_LT(body->getLinearVelocity().length(), 0.1) << i;
+		EXPECT_GT(pos.z() + 0.05, terrain.heightAt(pos.x(), pos.y())) << i;
+		EXPECT_LT(pos.z(), terrain.heightAt(pos.x(), pos.y()) + lowest[i % 3] + 0.2) << i;
+		delete body;
+	}
+	world.removeRigidBody(&ground);
+}
+
+GTEST_TEST(BulletCollision, HeightfieldPrimitive_Settle)
+{
+	SettleOnTerrain(false);
+}
+
+GTEST_TEST(BulletCollision, HeightfieldPrimitive_SettleTiled)
+{
+	SettleOnTerrain(true);
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,99 @@
+
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletDynamics/Featherstone/btMultiBody.h>
+#include <BulletDynamics/Featherstone/btMultiBodyConstraintSolver.h>
+#include <BulletDynamics/Featherstone/btMultiBodyDynamicsWorld.h>
+#include <gtest/gtest.h>
+
+static const btScalar kTimeStep = btScalar(1. / 240.);
+
+// fixed base with two branches: links 0 and 1 form a hanging chain at rest,
+// link 2 is a pendulum that keeps swinging
+static btMultiBody* createTwoBranchBody(btScalar swingVelocity)
+{
+	btMultiBody* mb = new btMultiBody(3, 1, btVector3(1, 1, 1), true, false);
+	const btVector3 inertia(0.1, 0.1, 0.1);
+	const btVector3 axis(1, 0, 0);
+	const btVector3 pivotToCom(0, 0, -0.5);
+	mb->setupRevolute(0, 1, inertia, -1, btQuaternion::getIdentity(), axis, btVector3(0, 0, 0), pivotToCom, true);
+	mb->setupRevolute(1, 1, inertia, 0, btQuaternion::getIdentity(), axis, pivotToCom, pivotToCom, true);
+	mb->setupRevolute(2, 1, inertia, -1, btQuaternion::getIdentity(), axis, btVector3(1, 0, 0), pivotToCom, true);
+	mb->finalizeMultiDof();
+	mb->setCanSleep(false);
+	mb->setLinearDamping(0);
+	mb->setAngularDamping(0);
+	mb->setJointVel(2, swingVelocity);
+	return mb;
+}
+
+GTEST_TEST(BulletDynamics, MultiBodyLinkSleeping)
+{
+	btDefaultCollisionConfiguration collisionConfiguration;
+	btCollisionDispatcher dispatcher(&collisionConfiguration);
+	btDbvtBroadphase broadphase;
+	btMultiBodyConstraintSolver solver;
+	btMultiBodyDynamicsWorld world(&dispatcher, &broadphase, &solver, &collisionConfiguration);
+	world.setGravity(btVector3(0, 0, -10));
+
+	btMultiBody* sleeping = createTwoBranchBody(2);
+	sleeping->setCanSleepLinks(true);
+	sleeping->setSleepTimeout(0.1);
+	world.addMultiBody(sleeping);
+
+	btMultiBody* reference = createTwoBranchBody(2);
+	world.addMultiBody(reference);
+
+	for (int i = 0; i < 60; i++)
+	{
+		world.stepSimulation(kTimeStep, 0);
+	}
+
+	// the resting chain is locked, the swinging pendulum is not
+	EXPECT_TRUE(sleeping->isLinkSleeping(0));
+	EXPECT_TRUE(sleeping->isLinkSleeping(1));
+	EXPECT_FALSE(sleeping->isLinkSleeping(2));
+	EXPECT_FALSE(reference->isLinkSleeping(0));
+
+	const btScalar lockedPos = sleeping->getJointPos(1);
+	for (int i = 0; i < 60; i++)
+	{
+		world.stepSimulation(kTimeStep, 0);
+	}
+	EXPECT_EQ(lockedPos, sleeping->getJointPos(1));
+	EXPECT_EQ(btScalar(0), sleeping->getJointVel(0));
+	EXPECT_EQ(btScalar(0), sleeping->getJointVel(1));
+
+	// locking one branch doesn't change the motion of the other one
+	EXPECT_NEAR(reference->getJointPos(2), sleeping->getJointPos(2), 1e-5);
+	EXPECT_NEAR(reference->getJointVel(2), sleeping->getJointVel(2), 1e-5);
+
+	// waking up the tip also unlocks its ancestors
+	sleeping->wakeUpLink(1);
+	world.stepSimulation(kTimeStep, 0);
+	EXPECT_FALSE(sleeping->isLinkSleeping(0));
+	EXPECT_FALSE(sleeping->isLinkSleeping(1));
+
+	// a joint velocity set by the user unlocks the joint and moves it
+	for (int i = 0; i < 60; i++)
+	{
+		world.stepSimulation(kTimeStep, 0);
+	}
+	EXPECT_TRUE(sleeping->isLinkSleeping(1));
+	sleeping->setJointVel(1, 1);
+	world.stepSimulation(kTimeStep, 0);
+	EXPECT_FALSE(sleeping->isLinkSleeping(1));
+	world.stepSimulation(kTimeStep, 0);
+	EXPECT_NE(lockedPos, sleeping->getJointPos(1));
+
+	world.removeMultiBody(sleeping);
+	world.removeMultiBody(reference);
+	delete sleeping;
+	delete reference;
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
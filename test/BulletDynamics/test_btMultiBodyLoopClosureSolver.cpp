@@ -0,0 +1,118 @@
+
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletDynamics/Featherstone/btMultiBody.h>
+#include <BulletDynamics/Featherstone/btMultiBodyConstraintSolver.h>
+#include <BulletDynamics/Featherstone/btMultiBodyDynamicsWorld.h>
+#include <BulletDynamics/Featherstone/btMultiBodyLinkCollider.h>
+#include <BulletDynamics/Featherstone/btMultiBodyPoint2Point.h>
+#include <gtest/gtest.h>
+
+static const btScalar kTimeStep = btScalar(1. / 240.);
+
+// planar four-bar linkage: two bars hanging from a fixed base, with a coupler on the first bar
+// that is closed to the tip of the second bar with a point to point constraint
+struct FourBar
+{
+	btDefaultCollisionConfiguration m_collisionConfiguration;
+	btCollisionDispatcher m_dispatcher;
+	btDbvtBroadphase m_broadphase;
+	btMultiBodyConstraintSolver m_solver;
+	btMultiBodyDynamicsWorld m_world;
+	btSphereShape m_shape;
+	btMultiBody* m_body;
+	btMultiBodyLinkCollider* m_colliders[3];
+	btMultiBodyPoint2Point* m_loopClosure;
+	btVector3 m_pivotInCoupler;
+	btVector3 m_pivotInBar;
+
+	FourBar(bool useDirectSolver, int numIterations)
+		: m_dispatcher(&m_collisionConfiguration),
+		  m_world(&m_dispatcher, &m_broadphase, &m_solver, &m_collisionConfiguration),
+		  m_shape(0.05),
+		  m_pivotInCoupler(0, 0.5, 0),
+		  m_pivotInBar(0, 0, -0.5)
+	{
+		m_world.setGravity(btVector3(0, -10, -10));
+		m_world.getSolverInfo().m_numIterations = numIterations;
+		if (useDirectSolver)
+			m_world.getSolverInfo().m_solverMode |= SOLVER_USE_DIRECT_LOOP_CLOSURES;
+
+		m_body = new btMultiBody(3, 1, btVector3(1, 1, 1), true, false);
+		const btVector3 inertia(0.1, 0.1, 0.1);
+		const btVector3 axis(1, 0, 0);
+		m_body->setupRevolute(0, 1, inertia, -1, btQuaternion::getIdentity(), axis, btVector3(0, 0, 0), btVector3(0, 0, -0.5), true);
+		m_body->setupRevolute(1, 1, inertia, 0, btQuaternion::getIdentity(), axis, btVector3(0, 0, -0.5), m_pivotInCoupler, true);
+		m_body->setupRevolute(2, 1, inertia, -1, btQuaternion::getIdentity(), axis, btVector3(0, 1, 0), m_pivotInBar, true);
+		m_body->finalizeMultiDof();
+		m_body->setCanSleep(false);
+		m_world.addMultiBody(m_body);
+
+		// the link colliders don't collide, they only put the constraint and the links in one island
+		for (int i = 0; i < 3; i++)
+		{
+			m_colliders[i] = new btMultiBodyLinkCollider(m_body, i);
+			m_colliders[i]->setCollisionShape(&m_shape);
+			m_body->getLink(i).m_collider = m_colliders[i];
+			m_world.addCollisionObject(m_colliders[i], 0, 0);
+		}
+
+		m_loopClosure = new btMultiBodyPoint2Point(m_body, 1, m_body, 2, m_pivotInCoupler, m_pivotInBar);
+		m_world.addMultiBodyConstraint(m_loopClosure);
+	}
+
+	~FourBar()
+	{
+		m_world.removeMultiBodyConstraint(m_loopClosure);
+		for (int i = 0; i < 3; i++)
+		{
+			m_world.removeCollisionObject(m_colliders[i]);
+			delete m_colliders[i];
+		}
+		m_world.removeMultiBody(m_body);
+		delete m_loopClosure;
+		delete m_body;
+	}
+
+	// largest distance between the closed pivots during the simulation
+	btScalar simulate(int numSteps)
+	{
+		btScalar maxError = 0;
+		for (int i = 0; i < numSteps; i++)
+		{
+			m_world.stepSimulation(kTimeStep, 0);
+			const btVector3 pivotA = m_body->localPosToWorld(1, m_pivotInCoupler);
+			const btVector3 pivotB = m_body->localPosToWorld(2, m_pivotInBar);
+			maxError = btMax(maxError, (pivotA - pivotB).length());
+		}
+		return maxError;
+	}
+};
+
+GTEST_TEST(BulletDynamics, MultiBodyLoopClosureSolver)
+{
+	const int kNumSteps = 240;
+	const int kNumIterations = 1;
+
+	FourBar iterative(false, kNumIterations);
+	const btScalar iterativeError = iterative.simulate(kNumSteps);
+
+	FourBar direct(true, kNumIterations);
+	const btScalar directError = direct.simulate(kNumSteps);
+
+	// the linkage swings, a single pass of the direct solver keeps the loop closed
+	EXPECT_GT(btFabs(direct.m_body->getJointPos(0)), 0.1);
+	EXPECT_LT(directError, 1e-5);
+	EXPECT_LT(directError, 0.1 * iterativeError);
+
+	// the out of plane row of the point to point constraint has a zero jacobian and is not selected.
+	// The sparsity pattern doesn't change, so the symbolic analysis is done once
+	EXPECT_EQ(2, direct.m_solver.getLoopClosureSolver().getNumRows());
+	EXPECT_EQ(1, direct.m_solver.getLoopClosureSolver().getNumSymbolicAnalyses());
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
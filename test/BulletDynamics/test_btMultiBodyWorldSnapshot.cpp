@@ -0,0 +1,214 @@
+
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletDynamics/Featherstone/btMultiBody.h>
+#include <BulletDynamics/Featherstone/btMultiBodyConstraintSolver.h>
+#include <BulletDynamics/Featherstone/btMultiBodyDynamicsWorld.h>
+#include <BulletDynamics/Featherstone/btMultiBodyJointMotor.h>
+#include <BulletDynamics/Featherstone/btMultiBodyLinkCollider.h>
+#include <BulletDynamics/Featherstone/btMultiBodyWorldSnapshot.h>
+#include <gtest/gtest.h>
+
+static const btScalar kTimeStep = btScalar(1. / 240.);
+
+// a floating two link chain with a motor and a box, both dropped on a static ground box
+struct SnapshotScene
+{
+	btDefaultCollisionConfiguration m_collisionConfiguration;
+	btCollisionDispatcher m_dispatcher;
+	btDbvtBroadphase m_broadphase;
+	btMultiBodyConstraintSolver m_solver;
+	btMultiBodyDynamicsWorld m_world;
+	btBoxShape m_groundShape;
+	btBoxShape m_boxShape;
+	btRigidBody* m_ground;
+	btRigidBody* m_box;
+	btMultiBody* m_body;
+	btMultiBodyLinkCollider* m_colliders[3];
+	btMultiBodyJointMotor* m_motor;
+
+	SnapshotScene()
+		: m_dispatcher(&m_collisionConfiguration),
+		  m_world(&m_dispatcher, &m_broadphase, &m_solver, &m_collisionConfiguration),
+		  m_groundShape(btVector3(10, 10, 1)),
+		  m_boxShape(btVector3(0.1, 0.1, 0.1))
+	{
+		m_world.setGravity(btVector3(0, 0, -10));
+
+		btTransform groundTransform(btQuaternion::getIdentity(), btVector3(0, 0, -1));
+		m_ground = new btRigidBody(0, 0, &m_groundShape);
+		m_ground->setWorldTransform(groundTransform);
+		m_world.addRigidBody(m_ground);
+
+		btVector3 boxInertia;
+		m_boxShape.calculateLocalInertia(1, boxInertia);
+		m_box = new btRigidBody(1, 0, &m_boxShape, boxInertia);
+		m_box->setWorldTransform(btTransform(btQuaternion(btVector3(1, 1, 0), 0.3), btVector3(1, 0, 0.3)));
+		m_world.addRigidBody(m_box);
+
+		m_body = new btMultiBody(2, 1, btVector3(0.01, 0.01, 0.01), false, false);
+		const btVector3 inertia(0.01, 0.01, 0.01);
+		m_body->setupRevolute(0, 1, inertia, -1, btQuaternion::getIdentity(), btVector3(1, 0, 0), btVector3(0, 0.1, 0), btVector3(0, 0.1, 0), true);
+		m_body->setupRevolute(1, 1, inertia, 0, btQuaternion::getIdentity(), btVector3(0, 1, 0), btVector3(0, 0.1, 0), btVector3(0, 0.1, 0), true);
+		m_body->finalizeMultiDof();
+		m_body->setBasePos(btVector3(0, 0, 0.4));
+		m_body->setJointVel(0, 2);
+		m_world.addMultiBody(m_body);
+
+		btAlignedObjectArray<btQuaternion> worldToLocal;
+		btAlignedObjectArray<btVector3> localOrigin;
+		worldToLocal.resize(3);
+		localOrigin.resize(3);
+		m_body->forwardKinematics(worldToLocal, localOrigin);
+		for (int i = 0; i < 3; i++)
+		{
+			m_colliders[i] = new btMultiBodyLinkCollider(m_body, i - 1);
+			m_colliders[i]->setCollisionShape(&m_boxShape);
+			if (i == 0)
+				m_body->setBaseCollider(m_colliders[i]);
+			else
+				m_body->getLink(i - 1).m_collider = m_colliders[i];
+			m_world.addCollisionObject(m_colliders[i], btBroadphaseProxy::DefaultFilter, btBroadphaseProxy::StaticFilter);
+		}
+		m_body->updateCollisionObjectWorldTransforms(worldToLocal, localOrigin);
+
+		m_motor = new btMultiBodyJointMotor(m_body, 1, 1, 10);
+		m_world.addMultiBodyConstraint(m_motor);
+	}
+
+	~SnapshotScene()
+	{
+		m_world.removeMultiBodyConstraint(m_motor);
+		for (int i = 0; i < 3; i++)
+		{
+			m_world.removeCollisionObject(m_colliders[i]);
+			delete m_colliders[i];
+		}
+		m_world.removeMultiBody(m_body);
+		m_world.removeRigidBody(m_box);
+		m_world.removeRigidBody(m_ground);
+		delete m_motor;
+		delete m_body;
+		delete m_box;
+		delete m_ground;
+	}
+
+	void simulate(int numSteps, btAlignedObjectArray<btScalar>& trajectory)
+	{
+		trajectory.clear();
+		for (int i = 0; i < numSteps; i++)
+		{
+			m_world.stepSimulation(kTimeStep, 0);
+			for (int j = 0; j < 3; j++)
+				trajectory.push_back(m_body->getBasePos()[j]);
+			trajectory.push_back(m_body->getJointPos(0));
+			trajectory.push_back(m_body->getJointPos(1));
+			trajectory.push_back(m_body->getJointVel(1));
+			for (int j = 0; j < 3; j++)
+				trajectory.push_back(m_box->getWorldTransform().getOrigin()[j]);
+		}
+	}
+};
+
+GTEST_TEST(BulletDynamics, MultiBodyWorldSnapshot)
+{
+	SnapshotScene scene;
+	btAlignedObjectArray<btScalar> trajectory;
+	scene.simulate(120, trajectory);
+
+	// both bodies are resting on the ground, so the manifolds carry warm starting impulses
+	ASSERT_GT(scene.m_dispatcher.getNumManifolds(), 0);
+
+	btMultiBodyWorldSnapshot snapshot;
+	snapshot.save(&scene.m_world);
+
+	btAlignedObjectArray<btScalar> expected;
+	scene.simulate(120, expected);
+
+	// restoring and stepping again reproduces the same trajectory, bit for bit
+	for (int pass = 0; pass < 2; pass++)
+	{
+		ASSERT_TRUE(snapshot.restore(&scene.m_world));
+		btAlignedObjectArray<btScalar> replayed;
+		scene.simulate(120, replayed);
+		ASSERT_EQ(expected.size(), replayed.size());
+		for (int i = 0; i < expected.size(); i++)
+		{
+			ASSERT_EQ(expected[i], replayed[i]) << "pass " << pass << " index " << i;
+		}
+	}
+
+	// a snapshot doesn't apply to a world with a different structure
+	btRigidBody* extra = new btRigidBody(0, 0, &scene.m_boxShape);
+	scene.m_world.addRigidBody(extra);
+	const btVector3 basePos = scene.m_body->getBasePos();
+	EXPECT_FALSE(snapshot.restore(&scene.m_world));
+	EXPECT_EQ(basePos, scene.m_body->getBasePos());
+	scene.m_world.removeRigidBody(extra);
+	delete extra;
+}
+
+GTEST_TEST(BulletDynamics, MultiBodyWorldSnapshotSeveralManifoldsPerPair)
+{
+	SnapshotScene scene;
+
+	// a compound with two boxes far apart gets one manifold per child against the ground
+	btCompoundShape compoundShape;
+	compoundShape.addChildShape(btTransform(btQuaternion::getIdentity(), btVector3(-2, 0, 0)), &scene.m_boxShape);
+	compoundShape.addChildShape(btTransform(btQuaternion(btVector3(0, 0, 1), 0.5), btVector3(2, 0, 0)), &scene.m_boxShape);
+	btVector3 compoundInertia;
+	compoundShape.calculateLocalInertia(1, compoundInertia);
+	btRigidBody* compound = new btRigidBody(1, 0, &compoundShape, compoundInertia);
+	compound->setWorldTransform(btTransform(btQuaternion::getIdentity(), btVector3(0, 3, 0.15)));
+	scene.m_world.addRigidBody(compound);
+
+	btAlignedObjectArray<btScalar> trajectory;
+	scene.simulate(120, trajectory);
+
+	btDispatcher* dispatcher = &scene.m_dispatcher;
+	int numCompoundManifolds = 0;
+	for (int i = 0; i < dispatcher->getNumManifolds(); i++)
+	{
+		const btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+		if ((manifold->getBody0() == compound || manifold->getBody1() == compound) && manifold->getNumContacts() > 0)
+			numCompoundManifolds++;
+	}
+	ASSERT_EQ(2, numCompoundManifolds);
+
+	btMultiBodyWorldSnapshot snapshot;
+	snapshot.save(&scene.m_world);
+	btAlignedObjectArray<int> savedNumContacts;
+	btAlignedObjectArray<btVector3> savedPoints;
+	for (int i = 0; i < dispatcher->getNumManifolds(); i++)
+	{
+		const btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+		savedNumContacts.push_back(manifold->getNumContacts());
+		for (int j = 0; j < manifold->getNumContacts(); j++)
+			savedPoints.push_back(manifold->getContactPoint(j).m_positionWorldOnB);
+	}
+
+	scene.simulate(10, trajectory);
+	ASSERT_TRUE(snapshot.restore(&scene.m_world));
+
+	// every manifold gets its own contacts back, not the ones of the first manifold of its pair
+	ASSERT_EQ(savedNumContacts.size(), dispatcher->getNumManifolds());
+	int point = 0;
+	for (int i = 0; i < dispatcher->getNumManifolds(); i++)
+	{
+		const btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+		ASSERT_EQ(savedNumContacts[i], manifold->getNumContacts()) << "manifold " << i;
+		for (int j = 0; j < manifold->getNumContacts(); j++)
+		{
+			EXPECT_EQ(savedPoints[point++], manifold->getContactPoint(j).m_positionWorldOnB) << "manifold " << i;
+		}
+	}
+
+	scene.m_world.removeRigidBody(compound);
+	delete compound;
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
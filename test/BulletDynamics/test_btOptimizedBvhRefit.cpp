@@ -0,0 +1,341 @@
+#include <btBulletDynamicsCommon.h>
+#include <gtest/gtest.h>
+
+#define GRID_SIZE 48
+
+struct GridMesh
+{
+	btAlignedObjectArray<btVector3> m_vertices;
+	btAlignedObjectArray<btVector3> m_deformedVertices;
+	btAlignedObjectArray<int> m_indices;
+	btTriangleIndexVertexArray* m_meshInterface;
+
+	GridMesh()
+	{
+		for (int i = 0; i <= GRID_SIZE; i++)
+		{
+			for (int j = 0; j <= GRID_SIZE; j++)
+			{
+				m_vertices.push_back(btVector3(i - GRID_SIZE / 2, j - GRID_SIZE / 2, 0));
+			}
+		}
+		for (int i = 0; i < GRID_SIZE; i++)
+		{
+			for (int j = 0; j < GRID_SIZE; j++)
+			{
+				int v = i * (GRID_SIZE + 1) + j;
+				m_indices.push_back(v);
+				m_indices.push_back(v + GRID_SIZE + 1);
+				m_indices.push_back(v + 1);
+				m_indices.push_back(v + 1);
+				m_indices.push_back(v + GRID_SIZE + 1);
+				m_indices.push_back(v + GRID_SIZE + 2);
+			}
+		}
+		m_deformedVertices = m_vertices;
+		m_meshInterface = new btTriangleIndexVertexArray(m_indices.size() / 3, &m_indices[0], 3 * sizeof(int), m_vertices.size(), &m_vertices[0][0], sizeof(btVector3));
+	}
+
+	~GridMesh()
+	{
+		delete m_meshInterface;
+	}
+
+	btVector3 getTriangleAabbMin(int triangleIndex, const btAlignedObjectArray<btVector3>& vertices) const
+	{
+		btVector3 aabbMin = vertices[m_indices[3 * triangleIndex]];
+		aabbMin.setMin(vertices[m_indices[3 * triangleIndex + 1]]);
+		aabbMin.setMin(vertices[m_indices[3 * triangleIndex + 2]]);
+		return aabbMin;
+	}
+
+	btVector3 getTriangleAabbMax(int triangleIndex, const btAlignedObjectArray<btVector3>& vertices) const
+	{
+		btVector3 aabbMax = vertices[m_indices[3 * triangleIndex]];
+		aabbMax.setMax(vertices[m_indices[3 * triangleIndex + 1]]);
+		aabbMax.setMax(vertices[m_indices[3 * triangleIndex + 2]]);
+		return aabbMax;
+	}
+};
+
+struct ReportedTrianglesCallback : public btTriangleCallback
+{
+	btAlignedObjectArray<bool> m_reported;
+
+	ReportedTrianglesCallback(int numTriangles)
+	{
+		m_reported.resize(numTriangles, false);
+	}
+
+	virtual void processTriangle(btVector3* triangle, int partId, int triangleIndex)
+	{
+		m_reported[triangleIndex] = true;
+	}
+};
+
+// every triangle whose bounds overlap the query box is reported by the bvh
+static void ExpectQueriesMatchMesh(const GridMesh& mesh, const btAlignedObjectArray<btVector3>& vertices, btBvhTriangleMeshShape* shape)
+{
+	for (int q = 0; q < 16; q++)
+	{
+		btVector3 center(((q * 7) % 16) * 3 - 24, ((q * 5) % 16) * 3 - 24, ((q * 3) % 8) - 4);
+		btVector3 halfExtents(2, 1.5, 1);
+		ReportedTrianglesCallback callback(mesh.m_indices.size() / 3);
+		shape->processAllTriangles(&callback, center - halfExtents, center + halfExtents);
+		for (int i = 0; i < mesh.m_indices.size() / 3; i++)
+		{
+			if (TestAabbAgainstAabb2(mesh.getTriangleAabbMin(i, vertices), mesh.getTriangleAabbMax(i, vertices), center - halfExtents, center + halfExtents))
+			{
+				EXPECT_TRUE(callback.m_reported[i]) << "query " << q << " triangle " << i;
+			}
+		}
+	}
+}
+
+// refitting the subtrees separately and then the nodes above them gives the same tree as the sequential refit
+GTEST_TEST(BulletCollision, OptimizedBvhRefitSubtrees)
+{
+	GridMesh mesh;
+	btVector3 bvhAabbMin(-30, -30, -10);
+	btVector3 bvhAabbMax(30, 30, 10);
+	btBvhTriangleMeshShape sequentialShape(mesh.m_meshInterface, true, bvhAabbMin, bvhAabbMax);
+	btBvhTriangleMeshShape subtreeShape(mesh.m_meshInterface, true, bvhAabbMin, bvhAabbMax);
+	btOptimizedBvh* sequentialBvh = sequentialShape.getOptimizedBvh();
+	btOptimizedBvh* subtreeBvh = subtreeShape.getOptimizedBvh();
+	ASSERT_GT(subtreeBvh->getSubtreeInfoArray().size(), 8);
+
+	for (int i = 0; i < mesh.m_vertices.size(); i++)
+	{
+		btVector3& v = mesh.m_vertices[i];
+		v.setZ(3 * btSin(0.3 * v.x()) * btCos(0.2 * v.y()));
+	}
+
+	sequentialBvh->refit(mesh.m_meshInterface, bvhAabbMin, bvhAabbMax);
+
+	subtreeBvh->setQuantizationValues(bvhAabbMin, bvhAabbMax);
+	btAlignedObjectArray<int> subtreeIndices;
+	for (int i = 0; i < subtreeBvh->getSubtreeInfoArray().size(); i++)
+	{
+		subtreeIndices.push_back(i);
+	}
+	subtreeBvh->refitSubtrees(mesh.m_meshInterface, subtreeIndices);
+	subtreeBvh->refitTopNodes(0);
+
+	const QuantizedNodeArray& expectedNodes = sequentialBvh->getQuantizedNodeArray();
+	const QuantizedNodeArray& actualNodes = subtreeBvh->getQuantizedNodeArray();
+	ASSERT_EQ(expectedNodes.size(), actualNodes.size());
+	for (int i = 0; i < expectedNodes.size(); i++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			ASSERT_EQ(expectedNodes[i].m_quantizedAabbMin[k], actualNodes[i].m_quantizedAabbMin[k]) << "node " << i;
+			ASSERT_EQ(expectedNodes[i].m_quantizedAabbMax[k], actualNodes[i].m_quantizedAabbMax[k]) << "node " << i;
+		}
+	}
+	for (int i = 0; i < subtreeIndices.size(); i++)
+	{
+		const btBvhSubtreeInfo& expected = sequentialBvh->getSubtreeInfoArray()[i];
+		const btBvhSubtreeInfo& actual = subtreeBvh->getSubtreeInfoArray()[i];
+		for (int k = 0; k < 3; k++)
+		{
+			EXPECT_EQ(expected.m_quantizedAabbMin[k], actual.m_quantizedAabbMin[k]);
+			EXPECT_EQ(expected.m_quantizedAabbMax[k], actual.m_quantizedAabbMax[k]);
+		}
+	}
+
+	ExpectQueriesMatchMesh(mesh, mesh.m_vertices, &subtreeShape);
+}
+
+// a new vertex buffer that scrambles the mesh degrades the refit subtrees. Rebuilding them lowers their cost,
+// and queries still report every overlapping triangle
+GTEST_TEST(BulletCollision, OptimizedBvhRebuildDegradedSubtrees)
+{
+	GridMesh mesh;
+	btVector3 bvhAabbMin(-30, -30, -10);
+	btVector3 bvhAabbMax(30, 30, 10);
+	btBvhTriangleMeshShape shape(mesh.m_meshInterface, true, bvhAabbMin, bvhAabbMax);
+	btOptimizedBvh* bvh = shape.getOptimizedBvh();
+	EXPECT_EQ(0, shape.rebuildDegradedSubtrees());
+
+	// mirror the vertices of each row, so neighbouring triangles of the tree end up far apart
+	btAlignedObjectArray<btVector3>& deformed = mesh.m_deformedVertices;
+	for (int i = 0; i < deformed.size(); i++)
+	{
+		btVector3& v = deformed[i];
+		if ((i / (GRID_SIZE + 1)) & 1)
+		{
+			v.setY(-v.y());
+		}
+		v.setZ(btSin(v.x()));
+	}
+	mesh.m_meshInterface->setVertexBase((const unsigned char*)&deformed[0][0]);
+	shape.refitTree(bvhAabbMin, bvhAabbMax);
+	ExpectQueriesMatchMesh(mesh, deformed, &shape);
+
+	btAlignedObjectArray<btScalar> refitCosts;
+	for (int i = 0; i < bvh->getSubtreeInfoArray().size(); i++)
+	{
+		refitCosts.push_back(bvh->calcSubtreeCost(i));
+	}
+
+	int numRebuilt = 0;
+	int numCalls = 0;
+	while (int rebuilt = shape.rebuildDegradedSubtrees(1.5, 4))
+	{
+		EXPECT_LE(rebuilt, 4);
+		numRebuilt += rebuilt;
+		numCalls++;
+	}
+	EXPECT_GT(numRebuilt, 0);
+	EXPECT_GT(numCalls, 1);
+
+	for (int i = 0; i < bvh->getSubtreeInfoArray().size(); i++)
+	{
+		EXPECT_LE(bvh->calcSubtreeCost(i), refitCosts[i] + SIMD_EPSILON) << "subtree " << i;
+	}
+	ExpectQueriesMatchMesh(mesh, deformed, &shape);
+}
+
+struct ReportedNodesCallback : public btNodeOverlapCallback
+{
+	btAlignedObjectArray<int> m_numReports;
+
+	ReportedNodesCallback(int numTriangles)
+	{
+		m_numReports.resize(numTriangles, 0);
+	}
+
+	virtual void processNode(int subPart, int triangleIndex)
+	{
+		m_numReports[triangleIndex]++;
+	}
+};
+
+// the refit wide tree reports the same triangles as the refit binary tree
+static void ExpectWideQueriesMatchBinary(const GridMesh& mesh, btBvhTriangleMeshShape& shape)
+{
+	for (int q = 0; q < 16; q++)
+	{
+		btVector3 center(((q * 7) % 16) * 3 - 24, ((q * 5) % 16) * 3 - 24, ((q * 3) % 8) - 4);
+		btVector3 halfExtents(2, 1.5, 1);
+		ReportedNodesCallback binary(mesh.m_indices.size() / 3);
+		ReportedNodesCallback wide(mesh.m_indices.size() / 3);
+		shape.getOptimizedBvh()->reportAabbOverlappingNodex(&binary, center - halfExtents, center + halfExtents);
+		shape.getWideBvh()->reportAabbOverlappingNodex(&wide, center - halfExtents, center + halfExtents);
+		for (int i = 0; i < mesh.m_indices.size() / 3; i++)
+		{
+			EXPECT_EQ(binary.m_numReports[i], wide.m_numReports[i]) << "query " << q << " triangle " << i;
+		}
+	}
+}
+
+static btITaskScheduler* SetThreadedScheduler()
+{
+	btITaskScheduler* scheduler = btCreateDefaultTaskScheduler();
+	if (scheduler)
+	{
+		scheduler->setNumThreads(btMin(4, scheduler->getMaxNumThreads()));
+		btSetTaskScheduler(scheduler);
+	}
+	return scheduler;
+}
+
+// partial and full refits update the wide nodes in place
+GTEST_TEST(BulletCollision, OptimizedBvhWideRefit)
+{
+	GridMesh mesh;
+	btVector3 bvhAabbMin(-30, -30, -10);
+	btVector3 bvhAabbMax(30, 30, 10);
+	btBvhTriangleMeshShape shape(mesh.m_meshInterface, true, bvhAabbMin, bvhAabbMax);
+	btBvhTriangleMeshShape wide8Shape(mesh.m_meshInterface, true, bvhAabbMin, bvhAabbMax);
+	ASSERT_TRUE(shape.buildWideBvh(4));
+	ASSERT_TRUE(wide8Shape.buildWideBvh(8));
+	const int numNodes = shape.getWideBvh()->getNumNodes();
+
+	// a bump in one corner of the grid
+	for (int i = 0; i < mesh.m_vertices.size(); i++)
+	{
+		btVector3& v = mesh.m_vertices[i];
+		if (v.x() < -12 && v.y() < -12)
+		{
+			v.setZ(4 * btSin(0.5 * v.x()) * btCos(0.5 * v.y()));
+		}
+	}
+	const btVector3 partialAabbMin(-25, -25, -5);
+	const btVector3 partialAabbMax(-12, -12, 5);
+	shape.partialRefitTree(partialAabbMin, partialAabbMax);
+	wide8Shape.partialRefitTree(partialAabbMin, partialAabbMax);
+	ASSERT_TRUE(shape.getWideBvh() != 0);
+	EXPECT_EQ(numNodes, shape.getWideBvh()->getNumNodes());
+	ExpectWideQueriesMatchBinary(mesh, shape);
+	ExpectWideQueriesMatchBinary(mesh, wide8Shape);
+	ExpectQueriesMatchMesh(mesh, mesh.m_vertices, &shape);
+
+	// the whole grid moves, with the wide nodes refit in parallel
+	for (int i = 0; i < mesh.m_vertices.size(); i++)
+	{
+		btVector3& v = mesh.m_vertices[i];
+		v.setZ(3 * btSin(0.3 * v.x()) * btCos(0.2 * v.y()));
+	}
+	btITaskScheduler* previousScheduler = btGetTaskScheduler();
+	btITaskScheduler* scheduler = SetThreadedScheduler();
+	shape.refitTree(bvhAabbMin, bvhAabbMax);
+	wide8Shape.refitTree(bvhAabbMin, bvhAabbMax);
+	btSetTaskScheduler(previousScheduler);
+	delete scheduler;
+	ASSERT_TRUE(shape.getWideBvh() != 0);
+	EXPECT_EQ(numNodes, shape.getWideBvh()->getNumNodes());
+	ExpectWideQueriesMatchBinary(mesh, shape);
+	ExpectWideQueriesMatchBinary(mesh, wide8Shape);
+	ExpectQueriesMatchMesh(mesh, mesh.m_vertices, &shape);
+}
+
+static bool SameNodes(const QuantizedNodeArray& a, const QuantizedNodeArray& b)
+{
+	if (a.size() != b.size())
+		return false;
+	for (int i = 0; i < a.size(); i++)
+	{
+		if (a[i].m_escapeIndexOrTriangleIndex != b[i].m_escapeIndexOrTriangleIndex)
+			return false;
+		for (int k = 0; k < 3; k++)
+		{
+			if (a[i].m_quantizedAabbMin[k] != b[i].m_quantizedAabbMin[k] || a[i].m_quantizedAabbMax[k] != b[i].m_quantizedAabbMax[k])
+				return false;
+		}
+	}
+	return true;
+}
+
+// the bvh rebuilt for a new scaling uses the build mode that was selected before
+GTEST_TEST(BulletCollision, OptimizedBvhScalingKeepsBuildMode)
+{
+	GridMesh mesh;
+	for (int i = 0; i < mesh.m_vertices.size(); i++)
+	{
+		btVector3& v = mesh.m_vertices[i];
+		v.setZ(3 * btSin(0.3 * v.x()) * btCos(0.2 * v.y()));
+	}
+	const btVector3 scaling(2, 1, 0.5);
+
+	btBvhTriangleMeshShape shape(mesh.m_meshInterface, true, false);
+	shape.buildOptimizedBvh(btQuantizedBvh::BUILD_BINNED_SAH);
+	shape.setLocalScaling(scaling);
+	EXPECT_EQ(btQuantizedBvh::BUILD_BINNED_SAH, shape.getBuildMode());
+
+	btBvhTriangleMeshShape binnedShape(mesh.m_meshInterface, true, false);
+	btBvhTriangleMeshShape meanSplitShape(mesh.m_meshInterface, true, false);
+	binnedShape.setLocalScaling(scaling);
+	meanSplitShape.setLocalScaling(scaling);
+	binnedShape.buildOptimizedBvh(btQuantizedBvh::BUILD_BINNED_SAH);
+	meanSplitShape.buildOptimizedBvh(btQuantizedBvh::BUILD_MEAN_SPLIT);
+
+	EXPECT_TRUE(SameNodes(binnedShape.getOptimizedBvh()->getQuantizedNodeArray(), shape.getOptimizedBvh()->getQuantizedNodeArray()));
+	EXPECT_FALSE(SameNodes(meanSplitShape.getOptimizedBvh()->getQuantizedNodeArray(), shape.getOptimizedBvh()->getQuantizedNodeArray()));
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
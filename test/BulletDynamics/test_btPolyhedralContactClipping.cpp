@@ -0,0 +1,183 @@
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/CollisionShapes/btConvexPolyhedron.h>
+#include <BulletCollision/NarrowPhaseCollision/btPolyhedralContactClipping.h>
+#include <gtest/gtest.h>
+
+struct CountingResult : public btDiscreteCollisionDetectorInterface::Result
+{
+	int m_numContacts;
+	btScalar m_minDepth;
+
+	CountingResult() : m_numContacts(0), m_minDepth(BT_LARGE_FLOAT) {}
+
+	virtual void setShapeIdentifiersA(int partId0, int index0) {}
+	virtual void setShapeIdentifiersB(int partId1, int index1) {}
+	virtual void addContactPoint(const btVector3& normalOnBInWorld, const btVector3& pointInWorld, btScalar depth)
+	{
+		m_numContacts++;
+		m_minDepth = btMin(m_minDepth, depth);
+	}
+};
+
+static btScalar randomScalar()
+{
+	return btScalar(rand()) / btScalar(RAND_MAX) * btScalar(2.) - btScalar(1.);
+}
+
+static btVector3 randomDirection()
+{
+	for (;;)
+	{
+		btVector3 dir(randomScalar(), randomScalar(), randomScalar());
+		if (dir.length2() > btScalar(0.01))
+		{
+			return dir.normalized();
+		}
+	}
+}
+
+static btScalar overlap(const btConvexPolyhedron& hullA, const btConvexPolyhedron& hullB, const btTransform& transA, const btTransform& transB, const btVector3& axis)
+{
+	btScalar minA, maxA, minB, maxB;
+	btVector3 witness0, witness1;
+	hullA.project(transA, axis, minA, maxA, witness0, witness1);
+	hullB.project(transB, axis, minB, maxB, witness0, witness1);
+	return btMin(maxA - minB, maxB - minA);
+}
+
+// the Gauss map edge pairs find the same separation and penetration depth as testing all unique edge directions
+GTEST_TEST(BulletCollision, PolyhedralContactClippingGaussMap)
+{
+	srand(17);
+	for (int h = 0; h < 10; h++)
+	{
+		btConvexHullShape shapeA;
+		btConvexHullShape shapeB;
+		for (int i = 0; i < 10 + 5 * h; i++)
+		{
+			shapeA.addPoint(randomDirection() * btScalar(0.5), false);
+			shapeB.addPoint(randomDirection() * btScalar(0.4) * btVector3(1, 2, 1), false);
+		}
+		shapeA.recalcLocalAabb();
+		shapeB.recalcLocalAabb();
+		ASSERT_TRUE(shapeA.initializePolyhedralFeatures());
+		ASSERT_TRUE(shapeB.initializePolyhedralFeatures());
+		const btConvexPolyhedron& hullA = *shapeA.getConvexPolyhedron();
+		const btConvexPolyhedron& hullB = *shapeB.getConvexPolyhedron();
+		ASSERT_GT(hullA.m_edges.size(), 0);
+		ASSERT_GT(hullB.m_edges.size(), 0);
+
+		//without the edge adjacency, findSeparatingAxis tests all pairs of unique edge directions
+		btConvexPolyhedron referenceA = hullA;
+		btConvexPolyhedron referenceB = hullB;
+		referenceA.m_edges.clear();
+		referenceB.m_edges.clear();
+
+		for (int k = 0; k < 50; k++)
+		{
+			btTransform transA(btQuaternion(randomDirection(), randomScalar() * SIMD_PI), randomDirection() * btScalar(0.3) * (k % 5));
+			btTransform transB(btQuaternion(randomDirection(), randomScalar() * SIMD_PI), btVector3(0, 0, 0));
+
+			btVector3 sep, expectedSep;
+			CountingResult result, expectedResult;
+			bool overlapping = btPolyhedralContactClipping::findSeparatingAxis(hullA, hullB, transA, transB, sep, result);
+			bool expectedOverlapping = btPolyhedralContactClipping::findSeparatingAxis(referenceA, referenceB, transA, transB, expectedSep, expectedResult);
+			ASSERT_EQ(expectedOverlapping, overlapping) << "hull " << h << " pose " << k;
+			if (overlapping)
+			{
+				EXPECT_NEAR(overlap(hullA, hullB, transA, transB, expectedSep), overlap(hullA, hullB, transA, transB, sep), 1e-4) << "hull " << h << " pose " << k;
+				EXPECT_EQ(expectedResult.m_numContacts, result.m_numContacts) << "hull " << h << " pose " << k;
+			}
+		}
+	}
+}
+
+// a box resting on a rotated box gets the eight corners of the overlap of their faces
+GTEST_TEST(BulletCollision, PolyhedralContactClippingBoxes)
+{
+	btBoxShape boxShape(btVector3(0.5, 0.5, 0.5));
+	ASSERT_TRUE(boxShape.initializePolyhedralFeatures());
+	const btConvexPolyhedron& hull = *boxShape.getConvexPolyhedron();
+	EXPECT_EQ(12, hull.m_edges.size());
+
+	btTransform transA(btQuaternion(btVector3(0, 0, 1), SIMD_PI / 4), btVector3(0, 0, 0.99));
+	btTransform transB = btTransform::getIdentity();
+	btVector3 sep;
+	CountingResult sepResult;
+	ASSERT_TRUE(btPolyhedralContactClipping::findSeparatingAxis(hull, hull, transA, transB, sep, sepResult));
+	EXPECT_GT(sep.z(), 0.999);
+
+	btVertexArray worldVertsB1, worldVertsB2;
+	CountingResult result;
+	btPolyhedralContactClipping::clipHullAgainstHull(sep, hull, hull, transA, transB, -1, 0.1, worldVertsB1, worldVertsB2, result);
+	EXPECT_EQ(8, result.m_numContacts);
+	EXPECT_NEAR(-0.01, result.m_minDepth, 1e-4);
+}
+
+// the cached feature gives an early out for separated hulls, and is reused without the full search while the hulls move little
+GTEST_TEST(BulletCollision, PolyhedralContactClippingFeatureCache)
+{
+	srand(19);
+	btConvexHullShape shapeA;
+	btConvexHullShape shapeB;
+	for (int i = 0; i < 40; i++)
+	{
+		shapeA.addPoint(randomDirection() * btScalar(0.5), false);
+		shapeB.addPoint(randomDirection() * btScalar(0.5), false);
+	}
+	shapeA.recalcLocalAabb();
+	shapeB.recalcLocalAabb();
+	ASSERT_TRUE(shapeA.initializePolyhedralFeatures());
+	ASSERT_TRUE(shapeB.initializePolyhedralFeatures());
+	const btConvexPolyhedron& hullA = *shapeA.getConvexPolyhedron();
+	const btConvexPolyhedron& hullB = *shapeB.getConvexPolyhedron();
+
+	const btTransform transB = btTransform::getIdentity();
+	const btQuaternion orientation(btVector3(1, 2, 3).normalized(), 0.4);
+	for (int k = 0; k < 2; k++)
+	{
+		btScalar distance = k ? btScalar(0.8) : btScalar(1.2);
+		btSeparatingAxisCache cache;
+		btVector3 firstOrigin;
+		for (int i = 0; i < 20; i++)
+		{
+			//a slow drift, that stays within the tolerances of the cache
+			btTransform transA(orientation, btVector3(0.1, 0.2, 1).normalized() * distance + btVector3(0.0002, 0, 0) * i);
+
+			btVector3 sep, expectedSep;
+			CountingResult result, expectedResult;
+			bool overlapping = btPolyhedralContactClipping::findSeparatingAxis(hullA, hullB, transA, transB, sep, result, &cache);
+			bool expectedOverlapping = btPolyhedralContactClipping::findSeparatingAxis(hullA, hullB, transA, transB, expectedSep, expectedResult);
+			ASSERT_EQ(expectedOverlapping, overlapping) << "distance " << distance << " step " << i;
+			ASSERT_NE(btSeparatingAxisCache::NO_FEATURE, cache.m_featureType);
+			EXPECT_EQ(!overlapping, cache.m_separating);
+			if (i == 0)
+			{
+				firstOrigin = cache.m_relativeOrigin;
+			}
+			if (overlapping)
+			{
+				EXPECT_NEAR(overlap(hullA, hullB, transA, transB, expectedSep), overlap(hullA, hullB, transA, transB, sep), 1e-3);
+				//the full search only ran in the first step
+				EXPECT_EQ(firstOrigin, cache.m_relativeOrigin);
+			}
+		}
+
+		//a large motion runs the full search again
+		if (k)
+		{
+			btVector3 cachedOrigin = cache.m_relativeOrigin;
+			btTransform transA(orientation, btVector3(0.1, 0.2, 1).normalized() * btScalar(0.7));
+			btVector3 sep;
+			CountingResult result;
+			EXPECT_TRUE(btPolyhedralContactClipping::findSeparatingAxis(hullA, hullB, transA, transB, sep, result, &cache));
+			EXPECT_GT((cache.m_relativeOrigin - cachedOrigin).length(), 0.05);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
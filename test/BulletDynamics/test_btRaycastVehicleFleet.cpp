@@ -0,0 +1,137 @@
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletDynamics/Vehicle/btRaycastVehicleFleet.h>
+#include <gtest/gtest.h>
+
+#define NUM_VEHICLES 64
+
+///a flat road with a row of cars driving, braking and steering on it, updated one by one or as a fleet
+static void SimulateVehicles(bool useFleet, btAlignedObjectArray<btTransform>& chassisTransforms)
+{
+	btDefaultCollisionConfiguration config;
+	btCollisionDispatcher dispatcher(&config);
+	btDbvtBroadphase broadphase;
+	btSequentialImpulseConstraintSolver solver;
+	btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &config);
+
+	btBoxShape groundShape(btVector3(500, 1, 500));
+	btRigidBody ground(0, 0, &groundShape);
+	ground.getWorldTransform().setOrigin(btVector3(0, -1, 0));
+	world.addRigidBody(&ground);
+
+	btBoxShape chassisShape(btVector3(1, 0.5, 2));
+	btVector3 chassisInertia;
+	chassisShape.calculateLocalInertia(800, chassisInertia);
+	btDefaultVehicleRaycaster raycaster(&world);
+	btRaycastVehicle::btVehicleTuning tuning;
+	btRaycastVehicleFleet fleet;
+
+	btAlignedObjectArray<btRigidBody*> chassisBodies;
+	btAlignedObjectArray<btRaycastVehicle*> vehicles;
+	for (int i = 0; i < NUM_VEHICLES; i++)
+	{
+		btRigidBody::btRigidBodyConstructionInfo info(800, 0, &chassisShape, chassisInertia);
+		info.m_startWorldTransform.setOrigin(btVector3(-200 + 6 * i, 1.5, 0));
+		btRigidBody* chassis = new btRigidBody(info);
+		chassis->setActivationState(DISABLE_DEACTIVATION);
+		world.addRigidBody(chassis);
+		chassisBodies.push_back(chassis);
+
+		btRaycastVehicle* vehicle = new btRaycastVehicle(tuning, chassis, &raycaster);
+		vehicle->setCoordinateSystem(0, 1, 2);
+		for (int w = 0; w < 4; w++)
+		{
+			btVector3 connectionPoint((w & 1) ? 0.8 : -0.8, 0.2, (w & 2) ? -1.6 : 1.6);
+			vehicle->addWheel(connectionPoint, btVector3(0, -1, 0), btVector3(-1, 0, 0), 0.6, 0.5, tuning, (w & 2) == 0);
+		}
+		for (int w = 0; w < 4; w++)
+		{
+			btWheelInfo& wheel = vehicle->getWheelInfo(w);
+			wheel.m_suspensionStiffness = 20;
+			wheel.m_wheelsDampingRelaxation = 2.3;
+			wheel.m_wheelsDampingCompression = 4.4;
+			wheel.m_frictionSlip = 1000;
+			wheel.m_rollInfluence = 0.1;
+		}
+		vehicles.push_back(vehicle);
+		if (useFleet)
+		{
+			fleet.addVehicle(vehicle);
+		}
+		else
+		{
+			world.addAction(vehicle);
+		}
+	}
+	if (useFleet)
+	{
+		world.addAction(&fleet);
+	}
+
+	for (int step = 0; step < 120; step++)
+	{
+		for (int i = 0; i < NUM_VEHICLES; i++)
+		{
+			vehicles[i]->applyEngineForce(step < 60 ? 1000 + 10 * i : 0, 2);
+			vehicles[i]->applyEngineForce(step < 60 ? 1000 + 10 * i : 0, 3);
+			vehicles[i]->setBrake(step < 60 ? 0 : 50, 2);
+			vehicles[i]->setBrake(step < 60 ? 0 : 50, 3);
+			vehicles[i]->setSteeringValue(btScalar(0.01) * (i % 7), 0);
+			vehicles[i]->setSteeringValue(btScalar(0.01) * (i % 7), 1);
+		}
+		world.stepSimulation(btScalar(1. / 60.), 0);
+	}
+
+	if (useFleet)
+	{
+		world.removeAction(&fleet);
+	}
+	for (int i = 0; i < NUM_VEHICLES; i++)
+	{
+		chassisTransforms.push_back(chassisBodies[i]->getWorldTransform());
+		if (!useFleet)
+		{
+			world.removeAction(vehicles[i]);
+		}
+		delete vehicles[i];
+		world.removeRigidBody(chassisBodies[i]);
+		delete chassisBodies[i];
+	}
+	world.removeRigidBody(&ground);
+}
+
+GTEST_TEST(BulletDynamics, RaycastVehicleFleet_MatchesVehicles)
+{
+	btAlignedObjectArray<btTransform> vehicleTransforms;
+	SimulateVehicles(false, vehicleTransforms);
+
+	btITaskScheduler* previousScheduler = btGetTaskScheduler();
+	btITaskScheduler* scheduler = btCreateDefaultTaskScheduler();
+	if (scheduler)
+	{
+		scheduler->setNumThreads(btMin(4, scheduler->getMaxNumThreads()));
+		btSetTaskScheduler(scheduler);
+	}
+	btAlignedObjectArray<btTransform> fleetTransforms;
+	SimulateVehicles(true, fleetTransforms);
+	btSetTaskScheduler(previousScheduler);
+	delete scheduler;
+
+	ASSERT_EQ(NUM_VEHICLES, vehicleTransforms.size());
+	ASSERT_EQ(NUM_VEHICLES, fleetTransforms.size());
+	for (int i = 0; i < NUM_VEHICLES; i++)
+	{
+		EXPECT_TRUE(vehicleTransforms[i].getOrigin() == fleetTransforms[i].getOrigin()) << i;
+		EXPECT_TRUE(vehicleTransforms[i].getBasis() == fleetTransforms[i].getBasis()) << i;
+
+		// on its wheels and driven along the road
+		EXPECT_NEAR(fleetTransforms[i].getOrigin().y(), 1, 0.5) << i;
+		EXPECT_GT(btFabs(fleetTransforms[i].getOrigin().z()), 0.5) << i;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,185 @@
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <gtest/gtest.h>
+
+extern int gNumClampedCcdMotions;
+
+#define WALL_X 3
+#define BULLET_SPEED 300
+#define TANGENTIAL_SPEED 3
+
+struct SpeculativeWorld
+{
+	btDefaultCollisionConfiguration m_config;
+	btCollisionDispatcher* m_dispatcher;
+	btDbvtBroadphase m_broadphase;
+	btSequentialImpulseConstraintSolver m_solver;
+	btConstraintSolverPoolMt* m_solverPool;
+	btDiscreteDynamicsWorld* m_world;
+
+	btBoxShape m_wallShape;
+	btSphereShape m_sphereShape;
+	btBoxShape m_boxShape;
+	btRigidBody* m_wall;
+	btAlignedObjectArray<btRigidBody*> m_bodies;
+
+	SpeculativeWorld(bool multiThreaded)
+		: m_solverPool(0),
+		  m_wallShape(btVector3(0.05, 10, 10)),
+		  m_sphereShape(0.1),
+		  m_boxShape(btVector3(0.1, 0.1, 0.1))
+	{
+		if (multiThreaded)
+		{
+			m_dispatcher = new btCollisionDispatcherMt(&m_config);
+			m_solverPool = new btConstraintSolverPoolMt(1);
+			m_world = new btDiscreteDynamicsWorldMt(m_dispatcher, &m_broadphase, m_solverPool, 0, &m_config);
+		}
+		else
+		{
+			m_dispatcher = new btCollisionDispatcher(&m_config);
+			m_world = new btDiscreteDynamicsWorld(m_dispatcher, &m_broadphase, &m_solver, &m_config);
+		}
+		m_world->setGravity(btVector3(0, 0, 0));
+
+		m_wall = new btRigidBody(0, 0, &m_wallShape);
+		m_wall->getWorldTransform().setOrigin(btVector3(WALL_X, 0, 0));
+		m_world->addRigidBody(m_wall);
+	}
+
+	~SpeculativeWorld()
+	{
+		for (int i = 0; i < m_bodies.size(); i++)
+		{
+			m_world->removeRigidBody(m_bodies[i]);
+			delete m_bodies[i];
+		}
+		m_world->removeRigidBody(m_wall);
+		delete m_wall;
+		delete m_world;
+		delete m_solverPool;
+		delete m_dispatcher;
+	}
+
+	///shoots a small body at the wall, fast enough to cross it in one step
+	btRigidBody* shoot(btCollisionShape* shape, const btVector3& from, bool ccd)
+	{
+		btVector3 inertia;
+		shape->calculateLocalInertia(1, inertia);
+		btRigidBody::btRigidBodyConstructionInfo info(1, 0, shape, inertia);
+		info.m_startWorldTransform.setOrigin(from);
+		btRigidBody* body = new btRigidBody(info);
+		body->setLinearVelocity(btVector3(BULLET_SPEED, 0, 0));
+		if (ccd)
+		{
+			body->setCcdMotionThreshold(0.05);
+			body->setCcdSweptSphereRadius(0.1);
+		}
+		m_world->addRigidBody(body);
+		m_bodies.push_back(body);
+		return body;
+	}
+
+	void step(int numSteps)
+	{
+		for (int i = 0; i < numSteps; i++)
+		{
+			m_world->stepSimulation(btScalar(1. / 60.), 0);
+		}
+	}
+};
+
+GTEST_TEST(BulletDynamics, SpeculativeContacts_StopFastBodies)
+{
+	SpeculativeWorld world(false);
+	world.m_world->getDispatchInfo().m_useSpeculativeContacts = true;
+	btRigidBody* sphere = world.shoot(&world.m_sphereShape, btVector3(0, 0, 0), true);
+	btRigidBody* box = world.shoot(&world.m_boxShape, btVector3(0, 2, 0), true);
+	btRigidBody* noCcd = world.shoot(&world.m_sphereShape, btVector3(0, -2, 0), false);
+
+	// frictionless, so the wall only takes the normal velocity
+	sphere->setLinearVelocity(btVector3(BULLET_SPEED, TANGENTIAL_SPEED, 0));
+	sphere->setFriction(0);
+
+	const int numClampedCcdMotions = gNumClampedCcdMotions;
+	world.step(10);
+
+	// no sweeps
+	EXPECT_EQ(numClampedCcdMotions, gNumClampedCcdMotions);
+
+	// stopped at the wall, without losing the tangential motion
+	EXPECT_LT(sphere->getWorldTransform().getOrigin().x(), WALL_X);
+	EXPECT_GT(sphere->getWorldTransform().getOrigin().x(), WALL_X - 0.2);
+	EXPECT_NEAR(TANGENTIAL_SPEED * 10 / 60., sphere->getWorldTransform().getOrigin().y(), 0.01);
+	EXPECT_NEAR(TANGENTIAL_SPEED, sphere->getLinearVelocity().y(), 0.01);
+	EXPECT_LT(box->getWorldTransform().getOrigin().x(), WALL_X);
+
+	// tunnels without ccd
+	EXPECT_GT(noCcd->getWorldTransform().getOrigin().x(), WALL_X);
+}
+
+GTEST_TEST(BulletDynamics, SpeculativeContacts_ThresholdFollowsMotion)
+{
+	SpeculativeWorld world(false);
+	world.m_world->getDispatchInfo().m_useSpeculativeContacts = true;
+	btRigidBody* sphere = world.shoot(&world.m_sphereShape, btVector3(0, 0, 0), true);
+	world.step(1);
+
+	btCollisionDispatcher* dispatcher = world.m_dispatcher;
+	ASSERT_EQ(1, dispatcher->getNumManifolds());
+	btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(0);
+	EXPECT_GT(manifold->getSpeculativeDistance(), btScalar(BULLET_SPEED / 60.) * 0.5);
+	EXPECT_GT(manifold->getContactBreakingThreshold(), manifold->getSpeculativeDistance());
+
+	// back to the default threshold once the body is slow
+	sphere->setLinearVelocity(btVector3(0, 0, 0));
+	world.step(1);
+	ASSERT_EQ(1, dispatcher->getNumManifolds());
+	EXPECT_NEAR(0, dispatcher->getManifoldByIndexInternal(0)->getSpeculativeDistance(), SIMD_EPSILON);
+
+	// and when speculative contacts are switched off
+	sphere->setLinearVelocity(btVector3(BULLET_SPEED, 0, 0));
+	world.step(1);
+	ASSERT_EQ(1, dispatcher->getNumManifolds());
+	EXPECT_GT(dispatcher->getManifoldByIndexInternal(0)->getSpeculativeDistance(), btScalar(BULLET_SPEED / 60.) * 0.5);
+	world.m_world->getDispatchInfo().m_useSpeculativeContacts = false;
+	world.step(1);
+	ASSERT_EQ(1, dispatcher->getNumManifolds());
+	EXPECT_EQ(0, dispatcher->getManifoldByIndexInternal(0)->getSpeculativeDistance());
+}
+
+GTEST_TEST(BulletDynamics, SpeculativeContacts_MultiThreadedWorld)
+{
+	btITaskScheduler* previousScheduler = btGetTaskScheduler();
+	btITaskScheduler* scheduler = btCreateDefaultTaskScheduler();
+	btSetTaskScheduler(scheduler ? scheduler : btGetSequentialTaskScheduler());
+	if (scheduler)
+	{
+		scheduler->setNumThreads(btMin(4, scheduler->getMaxNumThreads()));
+	}
+	{
+		SpeculativeWorld world(true);
+		world.m_world->getDispatchInfo().m_useSpeculativeContacts = true;
+		for (int i = 0; i < 100; i++)
+		{
+			world.shoot(i & 1 ? (btCollisionShape*)&world.m_boxShape : &world.m_sphereShape, btVector3(0, -5 + 0.3 * (i % 33), -5 + 3 * (i / 33)), true);
+		}
+		const int numClampedCcdMotions = gNumClampedCcdMotions;
+		world.step(10);
+		EXPECT_EQ(numClampedCcdMotions, gNumClampedCcdMotions);
+		for (int i = 0; i < world.m_bodies.size(); i++)
+		{
+			EXPECT_LT(world.m_bodies[i]->getWorldTransform().getOrigin().x(), WALL_X) << i;
+		}
+	}
+	btSetTaskScheduler(previousScheduler);
+	delete scheduler;
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
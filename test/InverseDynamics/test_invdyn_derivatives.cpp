@@ -0,0 +1,248 @@
+// Test of analytical derivatives of inverse and forward dynamics:
+// check if they match central finite differences
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include "Bullet3Common/b3Random.h"
+
+#include "CoilCreator.hpp"
+#include "DillCreator.hpp"
+#include "RandomTreeCreator.hpp"
+#include "BulletInverseDynamics/MultiBodyTree.hpp"
+#include "MultiBodyTreeDebugGraph.hpp"
+
+using namespace btInverseDynamics;
+
+#ifdef BT_ID_USE_DOUBLE_PRECISION
+const idScalar kDelta = 1e-6;
+const double kMaxError = 1e-6;
+const double kMaxForwardError = 1e-6;
+#else
+const idScalar kDelta = 1e-2;
+const double kMaxError = 1e-2;
+// forward dynamics finite differences amplify round-off by the mass matrix condition number
+const double kMaxForwardError = 5e-2;
+#endif
+
+// minimal smart pointer to make this work for c++2003
+template <typename T>
+class ptr
+{
+	ptr();
+	ptr(const ptr&);
+
+public:
+	ptr(T* p) : m_p(p){};
+	~ptr() { delete m_p; }
+	T& operator*() { return *m_p; }
+	T* operator->() { return m_p; }
+	T* get() { return m_p; }
+	const T* get() const { return m_p; }
+
+private:
+	T* m_p;
+};
+
+// evaluate either inverse dynamics (dot_u -> joint forces) or forward dynamics
+// (joint forces -> dot_u) for the given state
+static int evaluateDynamics(MultiBodyTree* tree, const bool forward, const vecx& q, const vecx& u,
+							const vecx& input, vecx* output)
+{
+	if (!forward)
+	{
+		return tree->calculateInverseDynamics(q, u, input, output);
+	}
+	const int ndofs = tree->numDoFs();
+	matxx d_dq(ndofs, ndofs);
+	matxx d_du(ndofs, ndofs);
+	matxx d_dtau(ndofs, ndofs);
+	return tree->calculateForwardDynamicsDerivatives(q, u, input, output, &d_dq, &d_du, &d_dtau);
+}
+
+// maximum difference between analytical derivative and finite differences,
+// relative to the largest element of the analytical derivative
+static idScalar derivativeError(MultiBodyTree* tree, const bool forward, const vecx& q,
+							  const vecx& u, const vecx& input, const int wrt,
+							  const matxx& derivative)
+{
+	const int ndofs = tree->numDoFs();
+	vecx qp(ndofs), qm(ndofs), up(ndofs), um(ndofs), ip(ndofs), im(ndofs);
+	vecx outp(ndofs), outm(ndofs);
+	idScalar max_abs = 1.0;
+	for (int row = 0; row < ndofs; row++)
+	{
+		for (int col = 0; col < ndofs; col++)
+		{
+			max_abs = BT_ID_MAX(max_abs, BT_ID_FABS(derivative(row, col)));
+		}
+	}
+	idScalar max_error = 0;
+	for (int col = 0; col < ndofs; col++)
+	{
+		qp = q;
+		qm = q;
+		up = u;
+		um = u;
+		ip = input;
+		im = input;
+		switch (wrt)
+		{
+			case 0:
+				qp(col) += kDelta;
+				qm(col) -= kDelta;
+				break;
+			case 1:
+				up(col) += kDelta;
+				um(col) -= kDelta;
+				break;
+			default:
+				ip(col) += kDelta;
+				im(col) -= kDelta;
+				break;
+		}
+		EXPECT_EQ(0, evaluateDynamics(tree, forward, qp, up, ip, &outp));
+		EXPECT_EQ(0, evaluateDynamics(tree, forward, qm, um, im, &outm));
+		for (int row = 0; row < ndofs; row++)
+		{
+			const idScalar fd = (outp(row) - outm(row)) / (2.0 * kDelta);
+			const idScalar error = BT_ID_FABS(fd - derivative(row, col)) / max_abs;
+			max_error = BT_ID_MAX(max_error, error);
+		}
+	}
+	return max_error;
+}
+
+void calculateInverseDynamicsDerivativesError(const MultiBodyTreeCreator& creator,
+											  const int nloops, idScalar* max_error)
+{
+	ptr<MultiBodyTree> tree(CreateMultiBodyTree(creator));
+	ASSERT_TRUE(0x0 != tree.get());
+
+	*max_error = 0;
+	const int ndofs = tree->numDoFs();
+	if (ndofs <= 0)
+	{
+		return;
+	}
+
+	vecx q(ndofs), u(ndofs), dot_u(ndofs);
+	vecx joint_forces(ndofs), joint_forces_ref(ndofs);
+	matxx d_dq(ndofs, ndofs);
+	matxx d_du(ndofs, ndofs);
+
+	for (int loop = 0; loop < nloops; loop++)
+	{
+		for (int i = 0; i < ndofs; i++)
+		{
+			q(i) = b3RandRange(-B3_PI, B3_PI);
+			u(i) = b3RandRange(-B3_PI, B3_PI);
+			dot_u(i) = b3RandRange(-B3_PI, B3_PI);
+		}
+		EXPECT_EQ(0, tree->calculateInverseDynamicsDerivatives(q, u, dot_u, &joint_forces, &d_dq,
+																 &d_du));
+		EXPECT_EQ(0, tree->calculateInverseDynamics(q, u, dot_u, &joint_forces_ref));
+		EXPECT_GT(kMaxError, maxAbs(joint_forces - joint_forces_ref));
+
+		*max_error = BT_ID_MAX(*max_error,
+							   derivativeError(tree.get(), false, q, u, dot_u, 0, d_dq));
+		*max_error = BT_ID_MAX(*max_error,
+							   derivativeError(tree.get(), false, q, u, dot_u, 1, d_du));
+	}
+}
+
+void calculateForwardDynamicsDerivativesError(const MultiBodyTreeCreator& creator,
+											  const int nloops, idScalar* max_error)
+{
+	ptr<MultiBodyTree> tree(CreateMultiBodyTree(creator));
+	ASSERT_TRUE(0x0 != tree.get());
+
+	*max_error = 0;
+	const int ndofs = tree->numDoFs();
+	if (ndofs <= 0)
+	{
+		return;
+	}
+
+	vecx q(ndofs), u(ndofs), dot_u(ndofs), joint_forces(ndofs), joint_forces_ref(ndofs);
+	matxx d_dq(ndofs, ndofs);
+	matxx d_du(ndofs, ndofs);
+	matxx d_dtau(ndofs, ndofs);
+
+	for (int loop = 0; loop < nloops; loop++)
+	{
+		for (int i = 0; i < ndofs; i++)
+		{
+			q(i) = b3RandRange(-B3_PI, B3_PI);
+			u(i) = b3RandRange(-B3_PI, B3_PI);
+			joint_forces(i) = b3RandRange(-B3_PI, B3_PI);
+		}
+		EXPECT_EQ(0, tree->calculateForwardDynamicsDerivatives(q, u, joint_forces, &dot_u, &d_dq,
+																 &d_du, &d_dtau));
+		// inverse dynamics of the result must reproduce the joint forces
+		EXPECT_EQ(0, tree->calculateInverseDynamics(q, u, dot_u, &joint_forces_ref));
+		*max_error = BT_ID_MAX(*max_error, maxAbs(joint_forces - joint_forces_ref));
+
+		*max_error = BT_ID_MAX(*max_error,
+							   derivativeError(tree.get(), true, q, u, joint_forces, 0, d_dq));
+		*max_error = BT_ID_MAX(*max_error,
+							   derivativeError(tree.get(), true, q, u, joint_forces, 1, d_du));
+		*max_error = BT_ID_MAX(*max_error,
+							   derivativeError(tree.get(), true, q, u, joint_forces, 2, d_dtau));
+	}
+}
+
+TEST(InvDynDerivatives, InverseDynamics)
+{
+	const int kNumLevels = 4;
+	const int kNumLoops = 5;
+	for (int level = 0; level < kNumLevels; level++)
+	{
+		const int nbodies = BT_ID_POW(2, level);
+		CoilCreator coil(nbodies);
+		idScalar error;
+		calculateInverseDynamicsDerivativesError(coil, kNumLoops, &error);
+		EXPECT_GT(kMaxError, error);
+		DillCreator dill(level);
+		calculateInverseDynamicsDerivativesError(dill, kNumLoops, &error);
+		EXPECT_GT(kMaxError, error);
+	}
+
+	const int kRandomLoops = 20;
+	const int kMaxRandomBodies = 16;
+	for (int loop = 0; loop < kRandomLoops; loop++)
+	{
+		RandomTreeCreator random(kMaxRandomBodies);
+		idScalar error;
+		calculateInverseDynamicsDerivativesError(random, kNumLoops, &error);
+		EXPECT_GT(kMaxError, error);
+	}
+}
+
+TEST(InvDynDerivatives, ForwardDynamics)
+{
+	const int kNumLevels = 4;
+	const int kNumLoops = 5;
+	for (int level = 0; level < kNumLevels; level++)
+	{
+		const int nbodies = BT_ID_POW(2, level);
+		CoilCreator coil(nbodies);
+		idScalar error;
+		calculateForwardDynamicsDerivativesError(coil, kNumLoops, &error);
+		EXPECT_GT(kMaxForwardError, error);
+		DillCreator dill(level);
+		calculateForwardDynamicsDerivativesError(dill, kNumLoops, &error);
+		EXPECT_GT(kMaxForwardError, error);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	b3Srand(1234);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
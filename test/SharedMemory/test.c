@@ -119,6 +119,64 @@ void testSharedMemory(b3PhysicsClientHandle sm)
 
 				ASSERT_EQ(b3GetStatusType(statusHandle), CMD_CLIENT_COMMAND_COMPLETED);
 			}
+			{
+				/* each solution of a batched inverse kinematics moves the end effector to its target */
+				b3SharedMemoryStatusHandle statusHandle;
+				b3SharedMemoryCommandHandle commandHandle;
+				double targetOffsets[3][3] = {{0.2, 0.1, -0.3}, {0.1, -0.2, -0.4}, {-0.2, 0.2, -0.2}};
+				double targetPositions[3][3];
+				double jointPositions[3 * 7];
+				int endEffectorLinkIndex = 6;
+				int ikBodyUniqueId, ikDofCount, numSolutions, target, i;
+				struct b3LinkState linkState;
+
+				/* the targets are reachable offsets from the end effector in the current pose */
+				commandHandle = b3RequestActualStateCommandInit(sm, bodyUniqueId);
+				b3RequestActualStateCommandComputeForwardKinematics(commandHandle, 1);
+				statusHandle = b3SubmitClientCommandAndWaitStatus(sm, commandHandle);
+				ASSERT_EQ(b3GetStatusType(statusHandle), CMD_ACTUAL_STATE_UPDATE_COMPLETED);
+				b3GetLinkState(sm, statusHandle, endEffectorLinkIndex, &linkState);
+				for (target = 0; target < 3; target++)
+				{
+					for (i = 0; i < 3; i++)
+					{
+						targetPositions[target][i] = linkState.m_worldLinkFramePosition[i] + targetOffsets[target][i];
+					}
+				}
+
+				commandHandle = b3CalculateInverseKinematicsBatchCommandInit(sm, bodyUniqueId, endEffectorLinkIndex, 3, &targetPositions[0][0]);
+				b3CalculateInverseKinematicsSetMaxNumIterations(commandHandle, 100);
+				b3CalculateInverseKinematicsSetResidualThreshold(commandHandle, 1e-5);
+				statusHandle = b3SubmitClientCommandAndWaitStatus(sm, commandHandle);
+				ASSERT_EQ(b3GetStatusType(statusHandle), CMD_CALCULATE_INVERSE_KINEMATICS_BATCH_COMPLETED);
+				ASSERT_EQ(b3GetStatusInverseKinematicsBatchJointPositions(sm, statusHandle, &ikBodyUniqueId, &ikDofCount, &numSolutions, 0), 1);
+				ASSERT_EQ(ikBodyUniqueId, bodyUniqueId);
+				ASSERT_EQ(ikDofCount, 7);
+				ASSERT_EQ(numSolutions, 3);
+				b3GetStatusInverseKinematicsBatchJointPositions(sm, statusHandle, 0, 0, 0, jointPositions);
+
+				for (target = 0; target < 3; target++)
+				{
+					double dx, dy, dz;
+					commandHandle = b3CreatePoseCommandInit(sm, bodyUniqueId);
+					for (i = 0; i < 7; i++)
+					{
+						b3CreatePoseCommandSetJointPosition(sm, commandHandle, i, jointPositions[target * 7 + i]);
+					}
+					statusHandle = b3SubmitClientCommandAndWaitStatus(sm, commandHandle);
+					ASSERT_EQ(b3GetStatusType(statusHandle), CMD_CLIENT_COMMAND_COMPLETED);
+
+					commandHandle = b3RequestActualStateCommandInit(sm, bodyUniqueId);
+					b3RequestActualStateCommandComputeForwardKinematics(commandHandle, 1);
+					statusHandle = b3SubmitClientCommandAndWaitStatus(sm, commandHandle);
+					ASSERT_EQ(b3GetStatusType(statusHandle), CMD_ACTUAL_STATE_UPDATE_COMPLETED);
+					b3GetLinkState(sm, statusHandle, endEffectorLinkIndex, &linkState);
+					dx = linkState.m_worldLinkFramePosition[0] - targetPositions[target][0];
+					dy = linkState.m_worldLinkFramePosition[1] - targetPositions[target][1];
+					dz = linkState.m_worldLinkFramePosition[2] - targetPositions[target][2];
+					ASSERT_EQ(dx * dx + dy * dy + dz * dz < 1e-4, 1);
+				}
+			}
 		}
 
 		{
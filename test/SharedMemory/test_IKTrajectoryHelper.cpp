@@ -0,0 +1,236 @@
+#include <gtest/gtest.h>
+#include "SharedMemory/IKTrajectoryHelper.h"
+#include "LinearMath/btThreads.h"
+#include "LinearMath/btMinMax.h"
+#include "LinearMath/btScalar.h"
+#include "LinearMath/btAlignedObjectArray.h"
+
+///a well conditioned linearized IK problem with numEndEffectors position targets and numQ joints
+struct IKProblem
+{
+	int m_numEndEffectors;
+	int m_numQ;
+	btAlignedObjectArray<double> m_targetPositions;
+	btAlignedObjectArray<double> m_currentPositions;
+	btAlignedObjectArray<double> m_jacobian;
+	btAlignedObjectArray<double> m_qCurrent;
+
+	IKProblem(int numEndEffectors, int numQ, int seed)
+		: m_numEndEffectors(numEndEffectors),
+		  m_numQ(numQ)
+	{
+		const int numRows = numEndEffectors * 3;
+		for (int i = 0; i < numRows; i++)
+		{
+			m_currentPositions.push_back(btSin(seed + i * 0.7));
+			m_targetPositions.push_back(m_currentPositions[i] + 0.1 * btCos(seed * 1.3 + i));
+			for (int j = 0; j < numQ; j++)
+			{
+				m_jacobian.push_back((i == j ? 1 : 0) + 0.3 * btSin(seed * 0.5 + i * 1.7 + j * 2.3));
+			}
+		}
+		for (int j = 0; j < numQ; j++)
+		{
+			m_qCurrent.push_back(0.2 * btSin(seed + j));
+		}
+	}
+
+	void solve(IKTrajectoryHelper& helper, btAlignedObjectArray<double>& qNew) const
+	{
+		const double dampIk[6] = {1, 1, 1, 1, 1, 1};
+		qNew.resize(m_numQ);
+		helper.computeIK2(&m_targetPositions[0], &m_currentPositions[0], m_numEndEffectors,
+						  &m_qCurrent[0], m_numQ, &qNew[0], IK2_VEL_DLS, &m_jacobian[0], dampIk);
+	}
+
+	///distance between the target and the linearized end effector positions after the step
+	double residual(const btAlignedObjectArray<double>& qNew) const
+	{
+		double sum = 0;
+		for (int i = 0; i < m_numEndEffectors * 3; i++)
+		{
+			double moved = m_currentPositions[i];
+			for (int j = 0; j < m_numQ; j++)
+			{
+				moved += m_jacobian[i * m_numQ + j] * (qNew[j] - m_qCurrent[j]);
+			}
+			sum += (m_targetPositions[i] - moved) * (m_targetPositions[i] - moved);
+		}
+		return btSqrt(sum);
+	}
+};
+
+static void SetDamping(IKTrajectoryHelper& helper, int numQ)
+{
+	btAlignedObjectArray<double> damping;
+	damping.resize(numQ, 0.001);
+	helper.setDampingCoeff(numQ, &damping[0]);
+}
+
+static btITaskScheduler* SetThreadedScheduler()
+{
+	btITaskScheduler* scheduler = btCreateDefaultTaskScheduler();
+	if (scheduler)
+	{
+		scheduler->setNumThreads(btMin(4, scheduler->getMaxNumThreads()));
+		btSetTaskScheduler(scheduler);
+	}
+	return scheduler;
+}
+
+// solving problems of another size in between does not change the result
+TEST(IKTrajectoryHelper, WorkspaceReuse)
+{
+	IKProblem small(1, 4, 1);
+	IKProblem large(2, 7, 2);
+	IKTrajectoryHelper helper;
+
+	btAlignedObjectArray<double> smallFirst, smallSecond, largeReused, largeFresh;
+	SetDamping(helper, small.m_numQ);
+	small.solve(helper, smallFirst);
+	SetDamping(helper, large.m_numQ);
+	large.solve(helper, largeReused);
+	SetDamping(helper, small.m_numQ);
+	small.solve(helper, smallSecond);
+
+	IKTrajectoryHelper freshHelper;
+	SetDamping(freshHelper, large.m_numQ);
+	large.solve(freshHelper, largeFresh);
+
+	for (int j = 0; j < small.m_numQ; j++)
+	{
+		EXPECT_EQ(smallFirst[j], smallSecond[j]) << j;
+	}
+	for (int j = 0; j < large.m_numQ; j++)
+	{
+		EXPECT_EQ(largeFresh[j], largeReused[j]) << j;
+	}
+	EXPECT_LT(small.residual(smallFirst), 0.01);
+	EXPECT_LT(large.residual(largeReused), 0.01);
+}
+
+// a joint that would leave its range stays at the limit and the other joints reach the target
+TEST(IKTrajectoryHelper, JointLimits)
+{
+	IKProblem problem(1, 4, 3);
+	IKTrajectoryHelper helper;
+	SetDamping(helper, problem.m_numQ);
+
+	btAlignedObjectArray<double> unlimited;
+	problem.solve(helper, unlimited);
+
+	// halve the range of the joint that moves the most, the others are not limited
+	int limitedJoint = 0;
+	for (int j = 1; j < problem.m_numQ; j++)
+	{
+		if (btFabs(unlimited[j] - problem.m_qCurrent[j]) > btFabs(unlimited[limitedJoint] - problem.m_qCurrent[limitedJoint]))
+		{
+			limitedJoint = j;
+		}
+	}
+	const double limit = problem.m_qCurrent[limitedJoint] + 0.5 * (unlimited[limitedJoint] - problem.m_qCurrent[limitedJoint]);
+	btAlignedObjectArray<double> lower, upper;
+	lower.resize(problem.m_numQ, 1);
+	upper.resize(problem.m_numQ, -1);
+	lower[limitedJoint] = btMin(limit, problem.m_qCurrent[limitedJoint]);
+	upper[limitedJoint] = btMax(limit, problem.m_qCurrent[limitedJoint]);
+	helper.setJointLimits(problem.m_numQ, &lower[0], &upper[0]);
+
+	btAlignedObjectArray<double> limited;
+	problem.solve(helper, limited);
+	EXPECT_GE(limited[limitedJoint], lower[limitedJoint]);
+	EXPECT_LE(limited[limitedJoint], upper[limitedJoint]);
+	EXPECT_NEAR(limit, limited[limitedJoint], 1e-12);
+
+	// better than clamping the unlimited solution
+	btAlignedObjectArray<double> clamped = unlimited;
+	clamped[limitedJoint] = limit;
+	EXPECT_LT(problem.residual(limited), 0.01);
+	EXPECT_LT(problem.residual(limited), problem.residual(clamped));
+
+	// without limits the solution is the unlimited one again
+	helper.clearJointLimits();
+	btAlignedObjectArray<double> cleared;
+	problem.solve(helper, cleared);
+	for (int j = 0; j < problem.m_numQ; j++)
+	{
+		EXPECT_EQ(unlimited[j], cleared[j]) << j;
+	}
+}
+
+// each batched problem is solved exactly like a single computeIK2 call
+TEST(IKTrajectoryHelper, BatchMatchesSingle)
+{
+	const int numProblems = 32;
+	const int numEndEffectors = 2;
+	const int numQ = 7;
+	const int numRows = numEndEffectors * 3;
+	IKTrajectoryHelper helper;
+	SetDamping(helper, numQ);
+	btAlignedObjectArray<double> lower, upper;
+	lower.resize(numQ, 1);
+	upper.resize(numQ, -1);
+	lower[2] = -0.1;
+	upper[2] = 0.1;
+	helper.setJointLimits(numQ, &lower[0], &upper[0]);
+
+	btAlignedObjectArray<double> targets, currents, jacobians, qCurrent, qSingle;
+	for (int i = 0; i < numProblems; i++)
+	{
+		IKProblem problem(numEndEffectors, numQ, 10 + i);
+		for (int k = 0; k < numRows; k++)
+		{
+			targets.push_back(problem.m_targetPositions[k]);
+			currents.push_back(problem.m_currentPositions[k]);
+		}
+		for (int k = 0; k < numRows * numQ; k++)
+		{
+			jacobians.push_back(problem.m_jacobian[k]);
+		}
+		btAlignedObjectArray<double> qNew;
+		problem.solve(helper, qNew);
+		for (int j = 0; j < numQ; j++)
+		{
+			qCurrent.push_back(problem.m_qCurrent[j]);
+			qSingle.push_back(qNew[j]);
+		}
+	}
+
+	btITaskScheduler* previousScheduler = btGetTaskScheduler();
+	btITaskScheduler* scheduler = SetThreadedScheduler();
+	const double dampIk[6] = {1, 1, 1, 1, 1, 1};
+	btAlignedObjectArray<double> qBatch;
+	qBatch.resize(numProblems * numQ, 0);
+	EXPECT_TRUE(helper.computeIK2Batch(numProblems, &targets[0], &currents[0], numEndEffectors,
+									   &qCurrent[0], numQ, &qBatch[0], IK2_VEL_DLS, &jacobians[0], dampIk));
+	// a smaller batch reuses the workspaces of the first problems
+	btAlignedObjectArray<double> qSmallBatch;
+	qSmallBatch.resize(2 * numQ, 0);
+	EXPECT_TRUE(helper.computeIK2Batch(2, &targets[numRows], &currents[numRows], numEndEffectors,
+									   &qCurrent[numQ], numQ, &qSmallBatch[0], IK2_VEL_DLS, &jacobians[numRows * numQ], dampIk));
+	btSetTaskScheduler(previousScheduler);
+	delete scheduler;
+
+	for (int i = 0; i < numProblems * numQ; i++)
+	{
+		EXPECT_EQ(qSingle[i], qBatch[i]) << i;
+	}
+	for (int i = 0; i < 2 * numQ; i++)
+	{
+		EXPECT_EQ(qSingle[numQ + i], qSmallBatch[i]) << i;
+	}
+	int numAtLimit = 0;
+	for (int i = 0; i < numProblems; i++)
+	{
+		EXPECT_GE(qBatch[i * numQ + 2], lower[2]) << i;
+		EXPECT_LE(qBatch[i * numQ + 2], upper[2]) << i;
+		numAtLimit += (qBatch[i * numQ + 2] == lower[2] || qBatch[i * numQ + 2] == upper[2]) ? 1 : 0;
+	}
+	EXPECT_GT(numAtLimit, 0);
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
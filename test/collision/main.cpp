@@ -20,12 +20,16 @@ subject to the following restrictions:
 ///Todo: the test needs proper coverage and using a convex hull point cloud
 ///Also the GJK, EPA and MPR should be improved, both quality and performance
 
+#include <algorithm>
 #include <vector>
 
 #include <gtest/gtest.h>
 
 #include "SphereSphereCollision.h"
+#include "BulletCollision/BroadphaseCollision/btQuantizedBvh.h"
+#include "BulletCollision/BroadphaseCollision/btQuantizedWideBvh.h"
 #include "BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h"
+#include "BulletCollision/CollisionShapes/btTiledHeightfieldTerrainShape.h"
 #include "BulletCollision/CollisionShapes/btSphereShape.h"
 #include "BulletCollision/CollisionShapes/btMultiSphereShape.h"
 
@@ -294,6 +298,485 @@ TEST(BulletCollisionTest, Heightfield_ProcessAllTriangles_FiltersByUpAxis)
 	EXPECT_EQ(triangles.size(), 0);
 }
 
+struct HeightfieldTriangle
+{
+	int m_partId;
+	int m_triangleIndex;
+	btVector3 m_vertices[3];
+
+	bool operator<(const HeightfieldTriangle& other) const
+	{
+		return m_triangleIndex < other.m_triangleIndex || (m_triangleIndex == other.m_triangleIndex && m_partId < other.m_partId);
+	}
+	bool operator==(const HeightfieldTriangle& other) const
+	{
+		return m_partId == other.m_partId && m_triangleIndex == other.m_triangleIndex && m_vertices[0] == other.m_vertices[0] &&
+			   m_vertices[1] == other.m_vertices[1] && m_vertices[2] == other.m_vertices[2];
+	}
+};
+
+class HeightfieldTriangleCollector : public btTriangleCallback
+{
+public:
+	std::vector<HeightfieldTriangle> m_triangles;
+
+	virtual void processTriangle(btVector3* triangle, int partId, int triangleIndex)
+	{
+		HeightfieldTriangle tri;
+		tri.m_partId = partId;
+		tri.m_triangleIndex = triangleIndex;
+		tri.m_vertices[0] = triangle[0];
+		tri.m_vertices[1] = triangle[1];
+		tri.m_vertices[2] = triangle[2];
+		m_triangles.push_back(tri);
+	}
+};
+
+std::vector<HeightfieldTriangle> CollectTriangles(const btConcaveShape& shape, const btVector3& aabbMin, const btVector3& aabbMax)
+{
+	HeightfieldTriangleCollector collector;
+	shape.processAllTriangles(&collector, aabbMin, aabbMax);
+	std::sort(collector.m_triangles.begin(), collector.m_triangles.end());
+	return collector.m_triangles;
+}
+
+// the closest ray hit, or 1 without hit
+class ClosestRayHitCallback : public btTriangleCallback
+{
+public:
+	btVector3 m_from;
+	btVector3 m_to;
+	btScalar m_hitFraction;
+
+	ClosestRayHitCallback(const btVector3& from, const btVector3& to) : m_from(from), m_to(to), m_hitFraction(1) {}
+
+	virtual void processTriangle(btVector3* triangle, int partId, int triangleIndex)
+	{
+		const btVector3 dir = m_to - m_from;
+		const btVector3 edge1 = triangle[1] - triangle[0];
+		const btVector3 edge2 = triangle[2] - triangle[0];
+		const btVector3 p = dir.cross(edge2);
+		const btScalar det = edge1.dot(p);
+		if (btFabs(det) < SIMD_EPSILON)
+			return;
+		const btVector3 s = m_from - triangle[0];
+		const btScalar u = s.dot(p) / det;
+		const btVector3 q = s.cross(edge1);
+		const btScalar v = dir.dot(q) / det;
+		const btScalar t = edge2.dot(q) / det;
+		if (u >= 0 && v >= 0 && u + v <= 1 && t >= 0 && t < m_hitFraction)
+			m_hitFraction = t;
+	}
+};
+
+struct TerrainRandom
+{
+	unsigned int m_seed;
+
+	TerrainRandom() : m_seed(1) {}
+
+	btScalar random()
+	{
+		m_seed = m_seed * 1664525u + 1013904223u;
+		return btScalar(m_seed >> 8) / btScalar(1 << 24);
+	}
+};
+
+struct TerrainHeights
+{
+	int m_width;
+	int m_length;
+	std::vector<float> m_heights;
+
+	TerrainHeights(int width, int length) : m_width(width), m_length(length), m_heights(width * length)
+	{
+		for (int y = 0; y < length; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				m_heights[y * width + x] = 4 * btSin(0.11 * x) * btCos(0.07 * y) + btSin(0.9 * x + 0.4 * y);
+			}
+		}
+	}
+};
+
+TEST(BulletCollisionTest, Heightfield_Accelerator_ProcessAllTriangles)
+{
+	TerrainHeights terrain(150, 131);
+	TerrainRandom random;
+
+	for (int upAxis = 0; upAxis < 3; upAxis++)
+	{
+		btHeightfieldTerrainShape heightfield(terrain.m_width, terrain.m_length, &terrain.m_heights[0], btScalar(-6), btScalar(6), upAxis, false);
+		btHeightfieldTerrainShape accelerated(terrain.m_width, terrain.m_length, &terrain.m_heights[0], btScalar(-6), btScalar(6), upAxis, false);
+		heightfield.setLocalScaling(btVector3(0.5, 2, 1.5));
+		accelerated.setLocalScaling(btVector3(0.5, 2, 1.5));
+
+		const int chunkSizes[3] = {1, 4, 16};
+		for (int c = 0; c < 3; c++)
+		{
+			accelerated.buildAccelerator(chunkSizes[c]);
+			EXPECT_GT(accelerated.getAcceleratorNumLevels(), 1);
+			for (int i = 0; i < 50; i++)
+			{
+				btVector3 center((random.random() - 0.5) * 160, (random.random() - 0.5) * 160, (random.random() - 0.5) * 160);
+				btVector3 halfExtent(random.random() * 30, random.random() * 30, random.random() * 30);
+				halfExtent[upAxis] = random.random() * 4;
+				center[upAxis] = (random.random() - 0.5) * 12;
+				EXPECT_TRUE(CollectTriangles(heightfield, center - halfExtent, center + halfExtent) == CollectTriangles(accelerated, center - halfExtent, center + halfExtent))
+					<< "up axis " << upAxis << " chunk size " << chunkSizes[c] << " query " << i;
+			}
+		}
+	}
+}
+
+TEST(BulletCollisionTest, Heightfield_Accelerator_Raycast)
+{
+	TerrainHeights terrain(200, 180);
+	TerrainRandom random;
+
+	for (int upAxis = 0; upAxis < 3; upAxis++)
+	{
+		btHeightfieldTerrainShape heightfield(terrain.m_width, terrain.m_length, &terrain.m_heights[0], btScalar(-6), btScalar(6), upAxis, false);
+		const std::vector<HeightfieldTriangle> triangles = CollectTriangles(heightfield, btVector3(-200, -200, -200), btVector3(200, 200, 200));
+
+		const int chunkSizes[3] = {0, 1, 16};
+		for (int c = 0; c < 3; c++)
+		{
+			heightfield.buildAccelerator(chunkSizes[c]);
+			int numHits = 0;
+			for (int i = 0; i < 100; i++)
+			{
+				// grazing rays across the terrain, steep rays and vertical rays, some of them starting outside the terrain
+				btVector3 from, to;
+				from[(upAxis + 1) % 3] = (random.random() - 0.5) * 240;
+				from[(upAxis + 2) % 3] = (random.random() - 0.5) * 240;
+				from[upAxis] = 6 + random.random() * 4;
+				to[(upAxis + 1) % 3] = (random.random() - 0.5) * 199;
+				to[(upAxis + 2) % 3] = (random.random() - 0.5) * 199;
+				to[upAxis] = -6 - random.random() * 4;
+				if (i % 3 == 0)
+				{
+					from[upAxis] = random.random() * 4;
+					to[upAxis] = from[upAxis] - 2;
+				}
+				else if (i % 3 == 1)
+				{
+					from[(upAxis + 1) % 3] = to[(upAxis + 1) % 3];
+					from[(upAxis + 2) % 3] = to[(upAxis + 2) % 3];
+				}
+
+				ClosestRayHitCallback expected(from, to);
+				for (size_t t = 0; t < triangles.size(); t++)
+				{
+					btVector3 vertices[3] = {triangles[t].m_vertices[0], triangles[t].m_vertices[1], triangles[t].m_vertices[2]};
+					expected.processTriangle(vertices, triangles[t].m_partId, triangles[t].m_triangleIndex);
+				}
+				ClosestRayHitCallback actual(from, to);
+				heightfield.performRaycast(&actual, from, to);
+				EXPECT_NEAR(expected.m_hitFraction, actual.m_hitFraction, 1e-5) << "up axis " << upAxis << " chunk size " << chunkSizes[c] << " ray " << i;
+				numHits += expected.m_hitFraction < 1;
+			}
+			EXPECT_GT(numHits, 30);
+		}
+	}
+}
+
+TEST(BulletCollisionTest, Heightfield_UpdateAccelerator)
+{
+	TerrainHeights terrain(100, 100);
+	btHeightfieldTerrainShape heightfield(terrain.m_width, terrain.m_length, &terrain.m_heights[0], btScalar(-10), btScalar(10), 1, false);
+	heightfield.buildAccelerator(8);
+
+	// a spike on a chunk corner, then a ray and a box that only reach it above the old terrain
+	for (int z = 15; z <= 17; z++)
+	{
+		for (int x = 31; x <= 33; x++)
+		{
+			terrain.m_heights[z * 100 + x] = 9;
+		}
+	}
+	heightfield.updateAccelerator(31, 15, 33, 17);
+
+	btHeightfieldTerrainShape rebuilt(terrain.m_width, terrain.m_length, &terrain.m_heights[0], btScalar(-10), btScalar(10), 1, false);
+	const btVector3 aabbMin(-20, 7, -35);
+	const btVector3 aabbMax(-16, 8, -32);
+	EXPECT_FALSE(CollectTriangles(rebuilt, aabbMin, aabbMax).empty());
+	EXPECT_TRUE(CollectTriangles(rebuilt, aabbMin, aabbMax) == CollectTriangles(heightfield, aabbMin, aabbMax));
+
+	const btVector3 from(-49, 8.5, -32.5);
+	const btVector3 to(49, 8.5, -32.5);
+	ClosestRayHitCallback hit(from, to);
+	heightfield.performRaycast(&hit, from, to);
+	EXPECT_LT(hit.m_hitFraction, 1);
+}
+
+TEST(BulletCollisionTest, TiledHeightfield_ProcessAllTriangles_MatchesHeightfield)
+{
+	// the grid isn't a multiple of the tile size, and the cache holds fewer tiles than a query covers
+	const TerrainHeights terrain(150, 131);
+	btHeightfieldArrayTileSource source(&terrain.m_heights[0], terrain.m_width, terrain.m_length);
+	TerrainRandom random;
+
+	for (int upAxis = 0; upAxis < 3; upAxis++)
+	{
+		btHeightfieldTerrainShape heightfield(terrain.m_width, terrain.m_length, &terrain.m_heights[0], btScalar(-6), btScalar(6), upAxis, false);
+		btTiledHeightfieldTerrainShape tiled(terrain.m_width, terrain.m_length, 16, &source, 4, btScalar(-6), btScalar(6), upAxis, false);
+		heightfield.setLocalScaling(btVector3(0.5, 2, 1.5));
+		tiled.setLocalScaling(btVector3(0.5, 2, 1.5));
+		EXPECT_EQ(10, tiled.getNumTilesX());
+		EXPECT_EQ(9, tiled.getNumTilesY());
+
+		for (int i = 0; i < 100; i++)
+		{
+			const btVector3 center((random.random() - 0.5) * 160, (random.random() - 0.5) * 160, (random.random() - 0.5) * 160);
+			btVector3 halfExtent(random.random() * 30, random.random() * 30, random.random() * 30);
+			halfExtent[upAxis] = random.random() * 4;
+			btVector3 aabbCenter = center;
+			aabbCenter[upAxis] = (random.random() - 0.5) * 12;
+			const std::vector<HeightfieldTriangle> expected = CollectTriangles(heightfield, aabbCenter - halfExtent, aabbCenter + halfExtent);
+			EXPECT_TRUE(expected == CollectTriangles(tiled, aabbCenter - halfExtent, aabbCenter + halfExtent)) << "query " << i;
+		}
+
+		// evicted tiles are loaded again, the cache stays bounded
+		EXPECT_GT(tiled.getNumTileLoads(), tiled.getNumTilesX() * tiled.getNumTilesY());
+		EXPECT_LE(tiled.getNumCachedTiles(), 4);
+	}
+}
+
+TEST(BulletCollisionTest, TiledHeightfield_Raycast_MatchesHeightfield)
+{
+	const TerrainHeights terrain(200, 180);
+	btHeightfieldArrayTileSource source(&terrain.m_heights[0], terrain.m_width, terrain.m_length);
+	btHeightfieldTerrainShape heightfield(terrain.m_width, terrain.m_length, &terrain.m_heights[0], btScalar(-6), btScalar(6), 1, false);
+	btTiledHeightfieldTerrainShape tiled(terrain.m_width, terrain.m_length, 32, &source, 8, btScalar(-6), btScalar(6), 1, false);
+	TerrainRandom random;
+
+	int numHits = 0;
+	for (int i = 0; i < 300; i++)
+	{
+		// grazing rays across the terrain, steep rays and vertical rays
+		btVector3 from((random.random() - 0.5) * 199, 6 + random.random() * 4, (random.random() - 0.5) * 179);
+		btVector3 to((random.random() - 0.5) * 199, -6 - random.random() * 4, (random.random() - 0.5) * 179);
+		if (i % 3 == 0)
+		{
+			from.setY(random.random() * 4);
+			to.setY(from.y() - 2);
+		}
+		else if (i % 3 == 1)
+		{
+			to.setX(from.x());
+			to.setZ(from.z());
+		}
+		ClosestRayHitCallback expected(from, to);
+		heightfield.performRaycast(&expected, from, to);
+		ClosestRayHitCallback actual(from, to);
+		tiled.performRaycast(&actual, from, to);
+		EXPECT_NEAR(expected.m_hitFraction, actual.m_hitFraction, 1e-5) << "ray " << i;
+		numHits += expected.m_hitFraction < 1;
+	}
+	EXPECT_GT(numHits, 100);
+	EXPECT_LE(tiled.getNumCachedTiles(), 8);
+}
+
+TEST(BulletCollisionTest, TiledHeightfield_SetHeights)
+{
+	TerrainHeights terrain(100, 100);
+	TerrainHeights expected(100, 100);
+	btHeightfieldArrayTileSource source(&terrain.m_heights[0], terrain.m_width, terrain.m_length);
+	btTiledHeightfieldTerrainShape tiled(terrain.m_width, terrain.m_length, 16, &source, 2, -10, 10, 2, false);
+
+	// a crater across the corner of four tiles
+	std::vector<float> crater(9 * 7);
+	for (int y = 0; y < 7; y++)
+	{
+		for (int x = 0; x < 9; x++)
+		{
+			crater[y * 9 + x] = -8 + 0.1 * (x + y);
+			expected.m_heights[(28 + y) * 100 + 12 + x] = crater[y * 9 + x];
+		}
+	}
+	tiled.setHeights(12, 28, 9, 7, &crater[0]);
+
+	btHeightfieldTerrainShape heightfield(expected.m_width, expected.m_length, &expected.m_heights[0], btScalar(-10), btScalar(10), 2, false);
+	const btVector3 aabbMin(-40, -25, -10);
+	const btVector3 aabbMax(-25, -10, -5);
+	EXPECT_EQ(CollectTriangles(heightfield, aabbMin, aabbMax).size(), CollectTriangles(tiled, aabbMin, aabbMax).size());
+	EXPECT_TRUE(CollectTriangles(heightfield, aabbMin, aabbMax) == CollectTriangles(tiled, aabbMin, aabbMax));
+
+	// the source is writable, so the edited tiles are stored when they are evicted
+	CollectTriangles(tiled, btVector3(-50, -50, -10), btVector3(50, 50, 10));
+	EXPECT_LE(tiled.getNumCachedTiles(), 2);
+	tiled.clearCache();
+	EXPECT_TRUE(terrain.m_heights == expected.m_heights);
+
+	// without storage, the edited tiles stay in the cache
+	const TerrainHeights original(100, 100);
+	btHeightfieldArrayTileSource readOnlySource(&original.m_heights[0], original.m_width, original.m_length);
+	btTiledHeightfieldTerrainShape readOnly(original.m_width, original.m_length, 16, &readOnlySource, 2, -10, 10, 2, false);
+	readOnly.setHeights(12, 28, 9, 7, &crater[0]);
+	CollectTriangles(readOnly, btVector3(-50, -50, -10), btVector3(50, 50, 10));
+	EXPECT_EQ(4, readOnly.flushTiles());
+	EXPECT_TRUE(CollectTriangles(heightfield, aabbMin, aabbMax) == CollectTriangles(readOnly, aabbMin, aabbMax));
+}
+
+class BvhOverlapCollector : public btNodeOverlapCallback
+{
+public:
+	std::vector<int>* m_triangles;
+
+	BvhOverlapCollector(std::vector<int>* triangles) : m_triangles(triangles) {}
+
+	virtual void processNode(int subPart, int triangleIndex)
+	{
+		m_triangles->push_back(triangleIndex);
+	}
+};
+
+struct BvhTestBoxes
+{
+	std::vector<btVector3> m_aabbMin;
+	std::vector<btVector3> m_aabbMax;
+	unsigned int m_seed;
+
+	btScalar random()
+	{
+		m_seed = m_seed * 1664525u + 1013904223u;
+		return btScalar(m_seed >> 8) / btScalar(1 << 24);
+	}
+
+	// small boxes scattered over a plane, like the triangles of a terrain, and a dense cluster
+	BvhTestBoxes(int numBoxes) : m_seed(1)
+	{
+		for (int i = 0; i < numBoxes; i++)
+		{
+			btVector3 center(random() * 100, random() * 100, random() * 2);
+			if (i % 4 == 0)
+			{
+				center.setValue(random() * 5, random() * 5, random() * 5);
+			}
+			const btVector3 halfExtent(random() * 0.5 + 0.01, random() * 0.5 + 0.01, random() * 0.5 + 0.01);
+			m_aabbMin.push_back(center - halfExtent);
+			m_aabbMax.push_back(center + halfExtent);
+		}
+	}
+
+	void build(btQuantizedBvh& bvh, btQuantizedBvh::btBuildMode buildMode)
+	{
+		bvh.setQuantizationValues(btVector3(-1, -1, -1), btVector3(101, 101, 6));
+		QuantizedNodeArray& leafNodes = bvh.getLeafNodeArray();
+		leafNodes.resize(int(m_aabbMin.size()));
+		for (int i = 0; i < leafNodes.size(); i++)
+		{
+			bvh.quantize(leafNodes[i].m_quantizedAabbMin, m_aabbMin[i], 0);
+			bvh.quantize(leafNodes[i].m_quantizedAabbMax, m_aabbMax[i], 1);
+			leafNodes[i].m_escapeIndexOrTriangleIndex = i;
+		}
+		bvh.buildInternal(buildMode);
+	}
+};
+
+template <typename Bvh>
+std::vector<int> QueryBvh(const Bvh& bvh, const btVector3& aabbMin, const btVector3& aabbMax)
+{
+	std::vector<int> triangles;
+	BvhOverlapCollector collector(&triangles);
+	bvh.reportAabbOverlappingNodex(&collector, aabbMin, aabbMax);
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+template <typename Bvh>
+std::vector<int> BoxCastBvh(const Bvh& bvh, const btVector3& from, const btVector3& to, const btVector3& halfExtent)
+{
+	std::vector<int> triangles;
+	BvhOverlapCollector collector(&triangles);
+	bvh.reportBoxCastOverlappingNodex(&collector, from, to, -halfExtent, halfExtent);
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+TEST(BulletCollisionTest, QuantizedBvhBinnedSahBuild)
+{
+	const int kNumBoxes = 5000;
+	BvhTestBoxes boxes(kNumBoxes);
+
+	btQuantizedBvh meanSplit;
+	boxes.build(meanSplit, btQuantizedBvh::BUILD_MEAN_SPLIT);
+	btQuantizedBvh binnedSah;
+	boxes.build(binnedSah, btQuantizedBvh::BUILD_BINNED_SAH);
+
+	// same stackless layout: 2n-1 nodes with the escape index of the root covering all of them
+	QuantizedNodeArray& nodes = binnedSah.getQuantizedNodeArray();
+	EXPECT_EQ(2 * kNumBoxes - 1, nodes[0].getEscapeIndex());
+
+	// every internal node contains its children
+	for (int i = 0; i < 2 * kNumBoxes - 1; i++)
+	{
+		if (nodes[i].isLeafNode())
+			continue;
+		const btQuantizedBvhNode& left = nodes[i + 1];
+		const btQuantizedBvhNode& right = nodes[i + 1 + (left.isLeafNode() ? 1 : left.getEscapeIndex())];
+		for (int j = 0; j < 3; j++)
+		{
+			EXPECT_LE(nodes[i].m_quantizedAabbMin[j], btMin(left.m_quantizedAabbMin[j], right.m_quantizedAabbMin[j]));
+			EXPECT_GE(nodes[i].m_quantizedAabbMax[j], btMax(left.m_quantizedAabbMax[j], right.m_quantizedAabbMax[j]));
+		}
+	}
+	EXPECT_GT(binnedSah.getSubtreeInfoArray().size(), 1);
+
+	btQuantizedBvh cacheFriendly;
+	boxes.build(cacheFriendly, btQuantizedBvh::BUILD_BINNED_SAH);
+	cacheFriendly.setTraversalMode(btQuantizedBvh::TRAVERSAL_STACKLESS_CACHE_FRIENDLY);
+
+	// both builders report the same overlapping leaves
+	for (int i = 0; i < 200; i++)
+	{
+		const btVector3 center(boxes.random() * 100, boxes.random() * 100, boxes.random() * 5);
+		const btVector3 halfExtent(boxes.random() * 3, boxes.random() * 3, boxes.random() * 3);
+		const std::vector<int> expected = QueryBvh(meanSplit, center - halfExtent, center + halfExtent);
+		EXPECT_EQ(expected, QueryBvh(binnedSah, center - halfExtent, center + halfExtent));
+		EXPECT_EQ(expected, QueryBvh(cacheFriendly, center - halfExtent, center + halfExtent));
+	}
+}
+
+TEST(BulletCollisionTest, QuantizedWideBvh)
+{
+	const int kNumBoxes = 5000;
+	BvhTestBoxes boxes(kNumBoxes);
+
+	btQuantizedBvh binary;
+	boxes.build(binary, btQuantizedBvh::BUILD_MEAN_SPLIT);
+
+	for (int width = 4; width <= 8; width += 4)
+	{
+		btQuantizedWideBvh* wide = btQuantizedWideBvh::create(width);
+		ASSERT_TRUE(wide != 0);
+		ASSERT_TRUE(wide->build(&binary));
+		EXPECT_EQ(width, wide->getWidth());
+		// collapsing removes the internal nodes in between: at most (n - 1) / (width - 1) nodes are left for full nodes
+		EXPECT_LT(wide->getNumNodes(), kNumBoxes);
+		EXPECT_GE(wide->getNumNodes(), (kNumBoxes - 1) / (width - 1));
+
+		// the wide tree reports the same leaves as the binary tree it was built from
+		for (int i = 0; i < 200; i++)
+		{
+			const btVector3 center(boxes.random() * 100, boxes.random() * 100, boxes.random() * 5);
+			const btVector3 halfExtent(boxes.random() * 3, boxes.random() * 3, boxes.random() * 3);
+			EXPECT_EQ(QueryBvh(binary, center - halfExtent, center + halfExtent), QueryBvh(*wide, center - halfExtent, center + halfExtent));
+
+			const btVector3 from(boxes.random() * 100, boxes.random() * 100, 5);
+			const btVector3 to(boxes.random() * 100, boxes.random() * 100, -1);
+			EXPECT_EQ(BoxCastBvh(binary, from, to, btVector3(0, 0, 0)), BoxCastBvh(*wide, from, to, btVector3(0, 0, 0)));
+			EXPECT_EQ(BoxCastBvh(binary, from, to, halfExtent * 0.1), BoxCastBvh(*wide, from, to, halfExtent * 0.1));
+		}
+
+		// a query covering the whole tree reaches every leaf
+		EXPECT_EQ(kNumBoxes, int(QueryBvh(*wide, btVector3(-10, -10, -10), btVector3(110, 110, 10)).size()));
+		delete wide;
+	}
+}
+
 }  // namespace
 
 int main(int argc, char** argv)
@@ -26,6 +26,8 @@
 	files {
 		"**.cpp",
 		"**.h",
+		"../../src/BulletCollision/BroadphaseCollision/btQuantizedBvh.cpp",
+		"../../src/BulletCollision/BroadphaseCollision/btQuantizedWideBvh.cpp",
 		"../../src/BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.cpp",
 		"../../src/BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h",
 
@@ -34,6 +36,7 @@
 		"../../src/BulletCollision/CollisionShapes/btMultiSphereShape.cpp",
 		"../../src/BulletCollision/CollisionShapes/btPolyhedralConvexShape.cpp",
 		"../../src/BulletCollision/CollisionShapes/btConvexShape.cpp",
+		"../../src/BulletCollision/CollisionShapes/btConvexHullShape.cpp",
 		"../../src/BulletCollision/CollisionShapes/btConvexInternalShape.cpp",
 		"../../src/BulletCollision/CollisionShapes/btCollisionShape.cpp",
 		"../../src/BulletCollision/CollisionShapes/btConvexPolyhedron.cpp",